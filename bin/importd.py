@@ -21,22 +21,30 @@ class MyDaemon(Daemon):
         This is the daemonised process block
         """
         while True:
-            files = sp.getFileList(config['DEFAULT']['sdbdir'])
-            mostRecent = sp.returnMostRecent(files)
-            print(mostRecent)
-            if not sp.fileExists(mostRecent):
-                # make sure any writes have finished to filesystem
-                time.sleep(30)
-                sdb = sp.sdbFile(mostRecent)
-                sdb.primeScratch()
-                sdb.callStd()
-                sdb.sdbParse()
-                sdb.importFlx()
-                sdb.cleanUp()
-                del sdb
-            else:
-                # wait 2 mins before checking again
-                time.sleep(120)
+            # the catalog lists only the hours new since it was last
+            # updated, holding back those still being written. They are
+            # added to those pending, which stay until their import is
+            # found in influx, so a failed import is tried again.
+            pending = sp.readPending()
+            for newFile in sp.updateCatalog():
+                if newFile not in pending:
+                    pending.append(newFile)
+
+            failed = []
+            for newFile in pending:
+                print(newFile)
+                if not sp.fileExists(newFile):
+                    sdb = sp.sdbFile(newFile)
+                    sdb.createOutputDir()
+                    sdb.callStd()
+                    imported = sdb.importFlx()
+                    sdb.cleanUp()
+                    del sdb
+                    if not imported:
+                        failed.append(newFile)
+            sp.writePending(failed)
+            # wait 2 mins before checking again
+            time.sleep(120)
 
 
 if __name__ == "__main__":
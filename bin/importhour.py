@@ -7,8 +7,7 @@ files = sys.argv[1:]
 
 for file in files:
     sdb = sp.sdbFile(file)
-    sdb.primeScratch()
+    sdb.createOutputDir()
     sdb.callStd()
-    sdb.sdbParse()
     sdb.importFlx()
     sdb.cleanUp()
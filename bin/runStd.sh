@@ -10,13 +10,14 @@ MONTH=$2
 DAY=$3
 HOUR=$4
 HOUR1=$5
+FILE=$6   # The hour's sdb file, read where it is in the archive
 
-dir=/sdb_puller/sdbscratch/$YEAR$MONTH$DAY$HOUR
+dir=/sdb_puller/sdboutput/$YEAR$MONTH$DAY$HOUR
 
 
 
-# Call Std for each .cfg file in the directory and convert to a
-# CSV format, so that python can modify for influx ingestion
+# Localise each .cfg file in the directory, call Std once for all of them
+# writing InfluxDB line protocol, ready for "influx -import"
 cd  $dir
 rm *.cfg
 rm *.dat
@@ -30,8 +31,14 @@ lf=$(basename $f) # strip path from filename for local file.
 confNo=$(echo $f | sed -e s/[^0-9]//g) # take out the conf number
 echo $lf $confNo
 cat $f | sed "s/M_DATE/$YEAR\/$MONTH\/$DAY/g" | sed "s/M_HOUR/$HOUR/g" | sed "s/M_PLUS_HOUR/$HOUR1/g" | sed "s/M_OUTPUT/$confNo/g" > $lf
+done
 
-/ttl/sw/util/Std -conf $lf -path ./
-cat $confNo.dat | sed 's/\t/,/g' | cut -d "," -f 3- | sed '1d'> /sdb_puller/sdboutput/$YEAR$MONTH$DAY$HOUR/$confNo.csv
+# A single pass over the hour file serves every configuration file
+/ttl/sw/util/Std -configs ./ -files "$FILE" -influx sdbfull
 
+for f in $FILES
+do
+confNo=$(echo $f | sed -e s/[^0-9]//g) # take out the conf number
+mv $confNo.dat $confNo.flx
+rm $(basename $f)
 done
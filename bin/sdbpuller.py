@@ -1,5 +1,4 @@
 import configparser
-import csv
 import datetime
 import glob
 import os
@@ -82,6 +81,58 @@ def returnMostRecent(paths):
     return max(paths, key=os.path.getctime)
 
 
+def updateCatalog():
+    """
+    Bring the archive catalog up to date, returning the sdb files of the
+    hours added or grown since it was last updated, oldest first.
+    Only these need importing, the rest of the archive is not walked.
+    With no catalog yet it is seeded from the whole archive and nothing is
+    returned, the hours already there being taken as imported, so a first
+    start does not import the archive again.
+    """
+    seeding = not os.path.exists(config['DEFAULT']['catalog'])
+    newFile = config['DEFAULT']['logdir'] + "catalog.new"
+    command = "cd /sdb_puller/ && vagrant ssh -c '/ttl/sw/util/sdbcatalog -archive " + config['DEFAULT']['sdbdir'] + " -catalog " + config['DEFAULT']['catalog']
+    if not seeding:
+        command += " -new"
+    command += " > " + newFile + " 2>> " + config['DEFAULT']['logdir'] + "catalog.log'"
+    print(command)
+    os.system(command)
+
+    files = []
+    if seeding:
+        return files
+    with open(newFile) as f:
+        for line in f:
+            # the listing is interleaved with the log of the update
+            if line.startswith(config['DEFAULT']['sdbdir']):
+                files.append(line.strip())
+    return files
+
+
+def readPending():
+    """
+    Return the sdb files still waiting to be imported, oldest first.
+    An hour stays pending until testImport finds its data in influx.
+    """
+    files = []
+    if os.path.exists(config['DEFAULT']['pending']):
+        with open(config['DEFAULT']['pending']) as f:
+            for line in f:
+                if line.strip():
+                    files.append(line.strip())
+    return files
+
+
+def writePending(files):
+    """
+    Keep the sdb files still waiting to be imported for the next pass
+    """
+    with open(config['DEFAULT']['pending'], 'w') as f:
+        for file in files:
+            f.write(file + "\n")
+
+
 class sdbFile:
     """
     Class for an hour of sdbobservation
@@ -105,7 +156,8 @@ class sdbFile:
 
     def callStd(self):
         # Call Vagrant machine to call runStd outputting stdout and stderr to logfile
-        command = "cd /sdb_puller/ && vagrant ssh -c '/sdb_puller/bin/runStd.sh " + self.year + " " + self.month + " " + self.day + " " + self.hour + " " + self.hour1 + " > " + config['DEFAULT']['logdir'] + self.date + "Std.log 2>&1'"
+        # Std reads the hour's file straight from the archive, no copy is made
+        command = "cd /sdb_puller/ && vagrant ssh -c '/sdb_puller/bin/runStd.sh " + self.year + " " + self.month + " " + self.day + " " + self.hour + " " + self.hour1 + " " + self.path + " > " + config['DEFAULT']['logdir'] + self.date + "Std.log 2>&1'"
         print(command)
         os.system(command)
 
@@ -115,17 +167,14 @@ class sdbFile:
         command = "rm -rf " + config['DEFAULT']['outputdir'] + "/" + self.date
         print(command)
         os.system(command)
-        command = "rm -rf " + config['DEFAULT']['scratchdir'] + "/" + self.date
-        print(command)
-        os.system(command)
 
 
     def createErrorLog(self):
         """
-        tar up the scratch and output dirs into the logdir
+        tar up the output dir into the logdir
         will allow further analysis of what went wrong!
         """
-        command = "tar -cvf " + config['DEFAULT']['logdir'] + self.date + "_error.tar " + config['DEFAULT']['outputdir'] + " " + config['DEFAULT']['scratchdir']
+        command = "tar -cvf " + config['DEFAULT']['logdir'] + self.date + "_error.tar " + config['DEFAULT']['outputdir']
 
 
     def importFlx(self):
@@ -142,101 +191,22 @@ class sdbFile:
         if self.testImport():
             command = "echo " + self.filename + " >> " + config['DEFAULT']['logfile']
             os.system(command)
+            return True
         else:
             self.createErrorLog()
+            return False
 
 
 
-    def primeScratch(self):
+    def createOutputDir(self):
         """
-        Create scratchdir
         Create outputdir
-        Prime the scratchdir with the sdb file
+        The sdb file is read where it is, so needs no scratchdir
         """
-        command = "mkdir " + config['DEFAULT']['scratchdir'] + "/" + self.date
-        print(command)
-        os.system(command)
-
         command = "mkdir " + config['DEFAULT']['outputdir'] + "/" + self.date
         print(command)
         os.system(command)
 
-        command = "cp " + self.path + " " + config['DEFAULT']['scratchdir'] + "/" + self.date
-        print(command)
-        os.system(command)
-
-
-
-    def sdbParse(self):
-        """
-        Parse the CSV output file of Std, once run through the VM (see bin/runStd.sh)
-        Some CSV files will be empty (no datums values during that hour) and are
-        removed before conversion to FLX files.
-        """
-
-        dir = config['DEFAULT']['outputdir'] + "/" + self.date
-        os.chdir(dir)
-
-        # Remove empty csv files
-        command = "find . -size 0 -delete"
-        os.system(command)
-
-        files = glob.glob("*.csv")
-        files.sort()
-        for file in files:
-            fileNo = re.findall('\d+', file)
-            outFile = fileNo[0] + ".flx"
-            print(outFile)
-            datFile = "/sdb_puller/conf/datums/datums" + fileNo[0] + ".lst"
-            print (datFile)
-
-
-            with open(file) as csvfile:
-                inputfile = csv.reader(csvfile, delimiter=',')
-                global data
-                data = []
-                for row in inputfile:
-                    data.append(row)
-
-            # Set time in s to nanoseconds for ingestion into INFLUX_DB
-            for i in range (len(data)):
-                # Convert from seconds to nanoseconds
-                data[i][0] = int(float(data[i][0]) * 1000000000)
-
-
-            with open(datFile) as csvfile:
-                inputfile = csv.reader(csvfile, delimiter=',')
-                global datums
-                datums = []
-                for row in inputfile:
-                    datums.append(row)
-
-
-            lines = [] # setup ingestion lines
-            for i in range(len(data)):
-                s = "{} ".format("sdbfull")
-                for j in range(1, len(datums)+1):
-                    if data[i][j]:
-                        s += datums[j-1][1] + "." + datums[j-1][2] + "={},".format(data[i][j])
-
-                if s[-1] == ',' :
-                    s = s[:-1]
-                s+= " {}".format(data[i][0])
-                #print(s)
-                lines.append(s)
-
-
-            file = open(outFile, 'w+')
-
-            file.write("# DDL\n")
-            file.write("CREATE DATABASE sdbfull\n")
-            file.write("\n")
-            file.write("# DML\n")
-            file.write("# CONTEXT-DATABASE: sdbfull\n")
-            file.write("\n")
-            for item in lines:
-                file.write("%s\n" % item)
-
 
 
     def testImport(self):
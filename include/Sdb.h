@@ -341,6 +341,7 @@ typedef enum eSdbStatus_e
    E_SDB_WRITE_ERR_LIMIT,    /* Max no. write-to-file failures exceeded */
    E_SDB_HBEAT_FAIL,         /* No heartbeats or error processing response */
    E_SDB_NOT_AUTH,           /* Not authorised to preform this command */
+   E_SDB_BLOCK_CORRUPT,      /* Block of a storage file fails its checks */
 
    E_SDB_EOERR_LIST,         /* End error list marker (DON'T USE FOR STATUS) */
    E_SDB_STATUS_MAX_VALUE = INT_MAX    /* Req'd to force size to 4 bytes */
@@ -434,6 +435,7 @@ typedef struct
 #define E_SDB_CLEANUP      "cleanup"
 #define E_SDB_MYSQLHOST    "host"
 #define E_SDB_MYSQLPORT    "port"
+#define E_SDB_FORMAT       "format"
 
 
 /* SDB type encodings (NOT IMPLEMENTED) */
@@ -636,6 +638,41 @@ typedef struct eSdbRawFmt_s eSdbRawFmt_t;
 
 #define E_SDB_CODE_MASKSIZE  24        /* No. bits to mask for storage code */
 #define E_SDB_HEADER_STRING "SDBR"     /* Magic key at start of storage files */
+#define E_SDB_HEADER_STRING_V2 "SDB2"  /* Magic key of block-structured files */
+#define E_SDB_HEADER_SIZE    8         /* Bytes in header of storage files */
+
+
+/*
+** Block-structured (version 2) storage files. These have the same 8 byte
+** header as the original files, but keyed E_SDB_HEADER_STRING_V2, and the
+** records follow in blocks of E_SDB_BLOCK_SIZE bytes. Each block is
+** headed by the number and range of TimeOffset of its records, a bloom
+** filter of their codes and a checksum, so that readers may pass over
+** blocks without reading their records, and check those they do read.
+** A block is written once full, or part full when its file is closed,
+** unused records being zero. Both versions may be found in one archive.
+*/
+
+#define E_SDB_BLOCK_SIZE     16384     /* Bytes in a block, with its header */
+#define E_SDB_BLOCK_MAGIC    "SDBK"    /* Magic key at start of each block */
+#define E_SDB_BLOCK_BLOOM    128       /* Words in the bloom filter of codes */
+#define E_SDB_BLOCK_RECORDS  1320      /* Records in a full block */
+
+typedef struct {             /* -- Header of a block of records -- */
+   char        Magic[ 4 ];   /* E_SDB_BLOCK_MAGIC, not nul terminated */
+   Uint32_t    Checksum;     /* Fletcher-32 of the rest of the block */
+   Uint32_t    Sequence;     /* Number of the block in its file, from 0 */
+   Uint32_t    NumRecords;   /* Number of records used */
+   Uint32_t    FirstOffset;  /* Least TimeOffset of the records */
+   Uint32_t    LastOffset;   /* Greatest TimeOffset of the records */
+   Uint32_t    Spare[ 2 ];   /* Zero */
+   Uint32_t    Bloom[ E_SDB_BLOCK_BLOOM ]; /* Bloom filter of the codes */
+} eSdbBlockHdr_t;
+
+typedef struct {             /* -- Block of a version 2 storage file -- */
+   eSdbBlockHdr_t Hdr;       /* Header */
+   eSdbRawFmt_t Records[ E_SDB_BLOCK_RECORDS ]; /* Records, in order rx'd */
+} eSdbDataBlock_t;
 
 
 
@@ -684,6 +721,12 @@ typedef struct {             /* -- Multiple (block) data request -- */
 extern Status_t eSdbStoreIdEncode(eSdbSngReq_t *ReqPtr, eSdbCode_t *CodePtr);
 extern Status_t eSdbStoreIdDecode(eSdbCode_t *CodePtr, eSdbSngReq_t *ReqPtr);
 
+extern void     eSdbBlockStart(eSdbDataBlock_t *BlockPtr, Uint32_t Sequence);
+extern Bool_t   eSdbBlockAdd(eSdbDataBlock_t *BlockPtr, eSdbRawFmt_t *RecordPtr);
+extern void     eSdbBlockSeal(eSdbDataBlock_t *BlockPtr);
+extern Status_t eSdbBlockCheck(eSdbDataBlock_t *BlockPtr);
+extern Bool_t   eSdbBlockMayHold(eSdbBlockHdr_t *HdrPtr, eSdbCode_t Code);
+
 
 
 #endif
@@ -83,10 +83,16 @@
 #define E_STD_FILE_HDR_SIZE     4    /* Expected size of a storage file header */
 #define E_STD_MAX_SEARCH_DATA   100  /* Maximum number of datum id's to search for */
 #define E_STD_SDB_CHUNK_SIZE    400  /* Size of the array to store sdb data in*/
+#define E_STD_SAMPLE_BATCH      4096 /* Samples passed at once by eStdReaderForEach */
 #define E_STD_SECONDS_PER_HOUR  3600 /* Seconds per hour */
 #define E_STD_MAX_STRING_LEN    128  /* Maximum string length for TLA's and UNITS */
 #define E_STD_BUFSIZE           16   /* Size of temporary storage buffer */
 #define E_STD_STRING_LEN        128  /* Maximum size of a string */
+#define E_STD_ROLLUP_LEVELS     4    /* Levels of a rollup archive, 10s to 1h */
+#define E_STD_BIN_HEADER_SIZE   16   /* Bytes of the header of a binary output */
+#define E_STD_BIN_COLUMN_SIZE   408  /* Bytes describing each of its columns */
+#define E_STD_BIN_RECORD_SIZE   16   /* Bytes of each of its records */
+#define E_STD_BIN_SUMMARY_LEN   16   /* Length of the summary of a column */
 #ifdef E_WFL_OS_QNX4
 #define E_STD_DFLT_SDB_PATH     "/opt/ttl/data/" /* Default path for sdb files*/
 #else
@@ -109,6 +115,8 @@ enum eStdStatus_e
    E_STD_SRCID_ERR,         /* Error setting the source ID */
    E_STD_DATID_ERR,         /* Error setting the datum ID */
    E_STD_ARRAY_SIZE,        /* Error with array size */
+   E_STD_THREAD_ERR,        /* Error starting or synchronising threads */
+   E_STD_READ_DATA_ERR,     /* Error reading or decompressing Sdb data */
    E_STD_STATUS_EOL,
    E_STD_STATUS_MAX, 
    E_STD_MATCHFOUND,        /* Timestamp matches an existing data item. */
@@ -128,6 +136,91 @@ typedef struct eStdTime_s
    Uint32_t    MilliSecond;
 } eStdTime_t;
 
+/* A retrieval of Sdb data, see eStdReaderOpen */
+typedef struct eStdReader_s eStdReader_t;
+
+/* The storage codes found in each hour of an archive, see eStdCatalogOpen */
+typedef struct eStdCatalog_s eStdCatalog_t;
+
+/* A columnar archive of Sdb data, see eStdColumnsOpen */
+typedef struct eStdColumns_s eStdColumns_t;
+
+/* A day of a rollup archive of Sdb data, see eStdRollupOpen */
+typedef struct eStdRollup_s eStdRollup_t;
+
+/* A day of a rollup archive being built, see eStdRollupStart */
+typedef struct eStdRollupFeed_s eStdRollupFeed_t;
+
+/*
+** A binary output written by Std, see eStdBinaryOpen. All numbers are
+** little-endian. The header holds "SDBB", the version, the number of
+** columns and E_STD_BIN_RECORD_SIZE, as 32-bit numbers. Each column is
+** described by its source and datum ids, as 32-bit numbers, then the
+** source name, datum name and units of E_STD_MAX_STRING_LEN characters
+** each, and the summary of E_STD_BIN_SUMMARY_LEN, all nul padded. Then
+** come the records, each a 64-bit time in nanoseconds since 1970, the
+** 32-bit index of the column and the 32-bit value, in time order.
+*/
+typedef struct eStdBinary_s eStdBinary_t;
+
+/* Sdb files named to be read, see eStdFilesOpen */
+typedef struct eStdFiles_s eStdFiles_t;
+
+/* The Sdb file being written, followed as it grows, see eStdTailOpen */
+typedef struct eStdTail_s eStdTail_t;
+
+/* What an archive catalog holds of a single storage code */
+typedef struct eStdCatalogCode_s
+{
+   eSdbCode_t  Code;         /* Storage code */
+   Int32_t     FirstHour;    /* Start of the first hour holding it */
+   Int32_t     LastHour;     /* Start of the last hour holding it */
+   Uint32_t    NumHours;     /* Number of hours holding it */
+   double      NumRecords;   /* Number of its records in those hours */
+} eStdCatalogCode_t;
+
+/* A column of a binary output */
+typedef struct eStdBinaryColumn_s
+{
+   Uint32_t    SourceId;
+   Uint32_t    DatumId;
+   char        SourceName[ E_STD_MAX_STRING_LEN ];
+   char        DatumName[ E_STD_MAX_STRING_LEN ];
+   char        DatumUnits[ E_STD_MAX_STRING_LEN ];
+   char        Summary[ E_STD_BIN_SUMMARY_LEN ];  /* Of each stride, or "" */
+} eStdBinaryColumn_t;
+
+/* A record of a binary output */
+typedef struct eStdBinaryRecord_s
+{
+   eTtlTime_t  TimeStamp;
+   Uint32_t    Column;       /* Index of the column */
+   Int32_t     Value;
+} eStdBinaryRecord_t;
+
+/* A record of Sdb data decoded by a reader, see eStdReaderBatch */
+typedef struct eStdSample_s
+{
+   eSdbCode_t  Code;         /* Storage code */
+   eTtlTime_t  TimeStamp;    /* Time the datum was submitted */
+   Int32_t     Value;
+} eStdSample_t;
+
+/* Given each batch of samples by eStdReaderForEach */
+typedef Status_t (*eStdSampleFn_t)( eStdSample_t *SamplesPtr,
+                                    size_t NumSamples,
+                                    void *ContextPtr );
+
+/* The records of a storage code in one interval of a rollup archive */
+typedef struct eStdRollupPoint_s
+{
+   Int32_t     Time;         /* Start of the interval */
+   Uint32_t    Count;        /* Number of records */
+   Int32_t     Min;          /* Least value */
+   Int32_t     Max;          /* Greatest value */
+   double      Sum;          /* Sum of the values, giving the mean */
+} eStdRollupPoint_t;
+
 /* Function prototypes */
 Status_t eStdRetrieveData( eTtlTime_t StartTime, 
                            eTtlTime_t StopTime,
@@ -141,5 +234,154 @@ Status_t eStdSearchData( Int32_t CilId,
                          eTtlTime_t *TimeStampPtr,
                          Int32_t *Value,
                          Bool_t *GotData );
+Status_t eStdRecordTime( eSdbRawFmt_t *SdbLinePtr,
+                         eTtlTime_t *TimeStampPtr );
+Status_t eStdReaderOpen( eTtlTime_t StartTime,
+                         eTtlTime_t StopTime,
+                         char *PathPtr,
+                         eStdReader_t **ReaderPtr );
+Status_t eStdReaderChunk( eStdReader_t *ReaderPtr,
+                          size_t NumRecords );
+Status_t eStdReaderCodes( eStdReader_t *ReaderPtr,
+                          eSdbCode_t *CodesPtr,
+                          size_t NumCodes );
+Status_t eStdReaderNext( eStdReader_t *ReaderPtr,
+                         eSdbRawFmt_t **SdbDataPtr,
+                         size_t *NumRecordsPtr,
+                         Bool_t *FinishedPtr );
+Status_t eStdReaderTime( eStdReader_t *ReaderPtr,
+                         eSdbRawFmt_t *SdbLinePtr,
+                         eTtlTime_t *TimeStampPtr );
+Status_t eStdReaderHour( eStdReader_t *ReaderPtr,
+                         eTtlTime_t *HourPtr );
+Status_t eStdReaderBatch( eStdReader_t *ReaderPtr,
+                          eStdSample_t *SamplesPtr,
+                          size_t MaxSamples,
+                          size_t *NumSamplesPtr,
+                          Bool_t *FinishedPtr );
+Status_t eStdReaderForEach( eStdReader_t *ReaderPtr,
+                            eStdSampleFn_t SampleFn,
+                            void *ContextPtr );
+Status_t eStdReaderCatalog( eStdReader_t *ReaderPtr,
+                            eStdCatalog_t *CatalogPtr );
+Status_t eStdReaderColumns( eStdReader_t *ReaderPtr,
+                            eStdColumns_t *ColumnsPtr );
+Status_t eStdReaderFiles( eStdReader_t *ReaderPtr,
+                          eStdFiles_t *FilesPtr );
+Status_t eStdReaderClose( eStdReader_t *ReaderPtr );
+Status_t eStdGzIndexBuild( char *GzFilePtr,
+                           size_t SpanSize,
+                           Uint32_t *NumPointsPtr );
+Status_t eStdSdbIndexBuild( char *SdbFilePtr,
+                            Uint32_t BlockSize,
+                            Uint32_t *NumCodesPtr );
+Status_t eStdCatalogOpen( char *CatalogFilePtr,
+                          eStdCatalog_t **CatalogPtr );
+Status_t eStdCatalogUpdate( char *CatalogFilePtr,
+                            char *ArchivePtr,
+                            Int32_t NumThreads,
+                            eStdCatalog_t **CatalogPtr,
+                            Uint32_t *NumNewPtr );
+Status_t eStdCatalogCode( eStdCatalog_t *CatalogPtr,
+                          Uint32_t Index,
+                          eStdCatalogCode_t *CodePtr );
+Status_t eStdCatalogHour( eStdCatalog_t *CatalogPtr,
+                          Uint32_t Index,
+                          Int32_t *HourPtr,
+                          char *FilePtr,
+                          Bool_t *UpdatedPtr );
+Status_t eStdCatalogNext( eStdCatalog_t *CatalogPtr,
+                          eSdbCode_t *CodesPtr,
+                          size_t NumCodes,
+                          Int32_t *HourPtr,
+                          char *FilePtr );
+Status_t eStdCatalogClose( eStdCatalog_t *CatalogPtr );
+Status_t eStdColumnsBuild( char *ColumnDirPtr,
+                           char *ArchivePtr,
+                           eTtlTime_t Day,
+                           Uint32_t *NumCodesPtr,
+                           Uint32_t *NumRecordsPtr );
+Status_t eStdColumnsOpen( char *ColumnDirPtr,
+                          eStdColumns_t **ColumnsPtr );
+Status_t eStdColumnsClose( eStdColumns_t *ColumnsPtr );
+Status_t eStdRollupBuild( char *RollupDirPtr,
+                          char *ArchivePtr,
+                          eTtlTime_t Day,
+                          Uint32_t *NumCodesPtr,
+                          Uint32_t *NumRecordsPtr );
+Status_t eStdRollupDay( eTtlTime_t Time,
+                        eTtlTime_t *StartPtr,
+                        eTtlTime_t *EndPtr );
+Status_t eStdRollupStart( char *RollupDirPtr,
+                          eTtlTime_t Day,
+                          eStdRollupFeed_t **FeedPtr );
+Status_t eStdRollupAdd( eStdRollupFeed_t *FeedPtr,
+                        eSdbCode_t Code,
+                        eTtlTime_t TimeStamp,
+                        Int32_t Value );
+Status_t eStdRollupFinish( eStdRollupFeed_t *FeedPtr,
+                           Bool_t Write,
+                           Uint32_t *NumCodesPtr,
+                           Uint32_t *NumRecordsPtr );
+Status_t eStdRollupRebuild( char *RollupDirPtr,
+                            eTtlTime_t Day,
+                            Uint32_t *NumCodesPtr );
+Status_t eStdRollupOpen( char *RollupDirPtr,
+                         eTtlTime_t Day,
+                         eStdRollup_t **RollupPtr );
+Status_t eStdRollupCode( eStdRollup_t *RollupPtr,
+                         Uint32_t Index,
+                         eSdbCode_t *CodePtr,
+                         Uint32_t *NumRecordsPtr );
+Status_t eStdRollupSeries( eStdRollup_t *RollupPtr,
+                           eSdbCode_t Code,
+                           Uint32_t Level,
+                           eStdRollupPoint_t **PointsPtr,
+                           Uint32_t *NumPointsPtr,
+                           Uint32_t *ResolutionPtr );
+Status_t eStdRollupClose( eStdRollup_t *RollupPtr );
+Status_t eStdBinaryOpen( char *FilePtr,
+                         eStdBinary_t **BinaryPtr,
+                         Uint32_t *NumColumnsPtr );
+Status_t eStdBinaryColumn( eStdBinary_t *BinaryPtr,
+                           Uint32_t Index,
+                           eStdBinaryColumn_t *ColumnPtr );
+Status_t eStdBinaryRead( eStdBinary_t *BinaryPtr,
+                         eStdBinaryRecord_t *RecordsPtr,
+                         size_t MaxRecords,
+                         size_t *NumReadPtr );
+Status_t eStdBinaryClose( eStdBinary_t *BinaryPtr );
+Status_t eStdBgzfTranscode( char *SdbFilePtr,
+                            Bool_t Replace,
+                            Uint32_t *NumRecordsPtr );
+Status_t eStdBgzfArchive( char *ArchivePtr,
+                          char *CheckpointPtr,
+                          Int32_t NumThreads,
+                          Bool_t Replace,
+                          Uint32_t *NumDonePtr,
+                          Uint32_t *NumFailedPtr );
+Status_t eStdBundleBuild( char *ArchivePtr,
+                          eTtlTime_t Period,
+                          Bool_t Month,
+                          Bool_t Replace,
+                          Uint32_t *NumHoursPtr );
+Status_t eStdFilesOpen( char *ListPtr,
+                        eStdFiles_t **FilesPtr );
+Status_t eStdFilesNext( eStdFiles_t *FilesPtr,
+                        Int32_t *HourPtr,
+                        char *FilePtr );
+Status_t eStdFilesClose( eStdFiles_t *FilesPtr );
+Status_t eStdTailOpen( eTtlTime_t StartTime,
+                       char *PathPtr,
+                       eStdTail_t **TailPtr );
+Status_t eStdTailNext( eStdTail_t *TailPtr,
+                       eSdbRawFmt_t **SdbDataPtr,
+                       size_t *NumRecordsPtr );
+Status_t eStdTailTime( eStdTail_t *TailPtr,
+                       eSdbRawFmt_t *SdbLinePtr,
+                       eTtlTime_t *TimeStampPtr );
+Status_t eStdTailWait( eStdTail_t *TailPtr,
+                       Int32_t Seconds );
+Status_t eStdTailClose( eStdTail_t *TailPtr );
 
 #endif
@@ -1008,6 +1008,7 @@ void mLogProcess
    char *LogStringPtr;                 /* Location pointer */
    char *PostPrefixPtr;                /* Location pointer */
    time_t CurrentTime;                 /* Storage for system time */
+   char TimeString[I_LOG_TIMESIZE];    /* System time as a string */
    size_t Size;                        /* Size of remaining string */
 
 
@@ -1029,11 +1030,13 @@ void mLogProcess
    LogStringPtr = LogString;
 
    /* Do the syslog format first (note the addition of the facility) */
+   /* ctime_r, as messages may be reported from several threads at once */
    time(&CurrentTime);   
+   ctime_r(&CurrentTime, TimeString);
    sprintf(
       LogStringPtr, "<%d>%.15s ",
       (Priority | E_LOG_FACILITY),
-      ctime(&CurrentTime)+4
+      TimeString+4
    );
    while(*LogStringPtr != '\0') LogStringPtr++;
 
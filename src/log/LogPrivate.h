@@ -73,6 +73,7 @@
 #define I_LOG_SHOWTEXT            /* NOT YET IMPLEMENTED */
 #define I_LOG_LANGUAGE            /* NOT YET IMPLEMENTED */
 #define I_LOG_MAXSIZE      256    /* Maximum size of a log message */
+#define I_LOG_TIMESIZE     26     /* Size of a string from ctime_r() */
 #define I_LOG_MAXPREFIXLEN 32     /* Max. string-length of an executable name */
 #define I_LOG_MAXINSTLEN   32     /* Max. string-length of an instance name */
 #define I_LOG_NOSTATUS     0      /* Status to report, when there is no status */
@@ -246,8 +246,8 @@ testclient:	Sdb.mak testclient.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB
 testcount:	Sdb.mak testcount.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB)/Cfu.lib
 	$(LN) -o testcount testcount.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB)/Cfu.lib $(LN_OPT)
 
-testdump:	Sdb.mak testdump.o SdbCode.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB)/Cfu.lib $(TTL_LIB)/Clu.lib $(TTL_LIB)/Log.lib $(TTL_LIB)/Hti.lib
-	$(LN) -o testdump testdump.o SdbCode.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB)/Cfu.lib $(TTL_LIB)/Clu.lib $(TTL_LIB)/Log.lib $(TTL_LIB)/Hti.lib $(LN_OPT)
+testdump:	Sdb.mak testdump.o SdbCode.o SdbBlock.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB)/Cfu.lib $(TTL_LIB)/Clu.lib $(TTL_LIB)/Log.lib $(TTL_LIB)/Hti.lib
+	$(LN) -o testdump testdump.o SdbCode.o SdbBlock.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB)/Cfu.lib $(TTL_LIB)/Clu.lib $(TTL_LIB)/Log.lib $(TTL_LIB)/Hti.lib $(LN_OPT)
 
 testfilereq:	Sdb.mak testfilereq.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB)/Cfu.lib
 	$(LN) -o testfilereq testfilereq.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB)/Cfu.lib $(LN_OPT)
@@ -270,8 +270,8 @@ teststore:	Sdb.mak teststore.o $(TTL_LIB)/Cil.lib $(TTL_LIB)/Tim.lib $(TTL_LIB)/
 
 # Library build rules
 
-Sdb.lib:	Sdb.mak SdbCode.o
-	$(LB) $(LB_OPT) $@ $(LB_DIV) SdbCode.o
+Sdb.lib:	Sdb.mak SdbCode.o SdbBlock.o
+	$(LB) $(LB_OPT) $@ $(LB_DIV) SdbCode.o SdbBlock.o
 
 
 # Source code rules (in alphabetical order).
@@ -282,6 +282,9 @@ Sdb.o:	Sdb.mak $(INCS) Sdb.c
 SdbAutoSubmit.o:	Sdb.mak $(INCS) SdbAutoSubmit.c
 	$(CC) $(CC_OPT) SdbAutoSubmit.c
 
+SdbBlock.o:	Sdb.mak $(INCS) SdbBlock.c
+	$(CC) $(CC_OPT) SdbBlock.c
+
 SdbCleanup.o:	Sdb.mak $(INCS) SdbCleanup.c
 	$(CC) $(CC_OPT) SdbCleanup.c
 
@@ -0,0 +1,411 @@
+/*
+** Module Name:
+**    SdbBlock.c
+**
+** Purpose:
+**    A module containing functions for blocks of block-structured
+**    (version 2) storage files.
+**
+** Description:
+**    The SDB writes the records of a version 2 storage file in blocks of
+**    E_SDB_BLOCK_SIZE bytes, see Sdb.h. These functions fill a block,
+**    summarising its records in its header, and seal it ready for
+**    writing. Readers use them to check a block read back, and whether
+**    it may hold records of a code without reading its records.
+**
+**    The codes of a block are held in a bloom filter of 4096 bits, each
+**    code setting three bits found by multiplicative hashing. A clear
+**    bit proves the code absent from the block. The checksum is a
+**    Fletcher-32 of the block after the checksum itself.
+**
+**    The contents of this file are public, for use by external programs
+**    reading the storage files.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+** Version:
+**    $Id$
+**
+** History:
+**    $Log$
+**
+**
+*/
+
+
+/* Include files */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "TtlSystem.h"
+#include "Log.h"
+#include "Sdb.h"
+#include "SdbPrivate.h"
+
+
+/* Local definitions */
+
+#define M_SDB_BLOOM_SHIFT    20        /* Leaves the 12 bits of a bit number */
+#define M_SDB_BLOOM_HASH1    0x9E3779B1 /* Multipliers for the three bits */
+#define M_SDB_BLOOM_HASH2    0x85EBCA77
+#define M_SDB_BLOOM_HASH3    0xC2B2AE3D
+#define M_SDB_SUM_MODULUS    65535     /* Modulus of the Fletcher sums */
+#define M_SDB_SUM_RUN        179       /* Words summed before reducing */
+
+
+/* Function prototypes */
+
+static void mSdbBloomSet(Uint32_t *BloomPtr, Uint32_t Bit);
+static Bool_t mSdbBloomTest(Uint32_t *BloomPtr, Uint32_t Bit);
+static Uint32_t mSdbBlockSum(eSdbDataBlock_t *BlockPtr);
+
+
+/* Functions */
+
+void eSdbBlockStart(
+   eSdbDataBlock_t *BlockPtr,
+   Uint32_t Sequence
+)
+{
+/*
+** Function Name:
+**    eSdbBlockStart
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Empty a block ready for filling.
+**
+** Description:
+**    The records and bloom filter are cleared, and the block given the
+**    number of the block in its file.
+**
+** Arguments:
+**    eSdbDataBlock_t *BlockPtr (out)
+**       The block.
+**    Uint32_t Sequence      (in)
+**       Number of the block in its file, from 0.
+**
+*/
+
+   memset(BlockPtr, 0, sizeof(eSdbDataBlock_t));
+   memcpy(BlockPtr->Hdr.Magic, E_SDB_BLOCK_MAGIC, sizeof(BlockPtr->Hdr.Magic));
+   BlockPtr->Hdr.Sequence = Sequence;
+
+}  /* End of eSdbBlockStart() */
+
+
+
+
+Bool_t eSdbBlockAdd(
+   eSdbDataBlock_t *BlockPtr,
+   eSdbRawFmt_t *RecordPtr
+)
+{
+/*
+** Function Name:
+**    eSdbBlockAdd
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Add a record to a block.
+**
+** Description:
+**    The record is appended to those of the block, and the range of
+**    TimeOffset and the bloom filter of the block updated. The block
+**    must not already be full.
+**
+** Arguments:
+**    eSdbDataBlock_t *BlockPtr (in/out)
+**       The block, started by eSdbBlockStart.
+**    eSdbRawFmt_t *RecordPtr (in)
+**       The record.
+**
+** Returns:
+**    TRUE if the block is now full, and should be sealed and written.
+**
+*/
+
+   /* Local variables */
+   eSdbBlockHdr_t *HdrPtr;   /* Header of the block */
+   eSdbCode_t Code;          /* Code of the record */
+
+
+   HdrPtr = &(BlockPtr->Hdr);
+
+   if((HdrPtr->NumRecords == 0) || (RecordPtr->TimeOffset < HdrPtr->FirstOffset))
+   {
+      HdrPtr->FirstOffset = RecordPtr->TimeOffset;
+   }
+   if((HdrPtr->NumRecords == 0) || (RecordPtr->TimeOffset > HdrPtr->LastOffset))
+   {
+      HdrPtr->LastOffset = RecordPtr->TimeOffset;
+   }
+
+   Code = RecordPtr->Code;
+   mSdbBloomSet(HdrPtr->Bloom, (Uint32_t)(Code * M_SDB_BLOOM_HASH1) >> M_SDB_BLOOM_SHIFT);
+   mSdbBloomSet(HdrPtr->Bloom, (Uint32_t)(Code * M_SDB_BLOOM_HASH2) >> M_SDB_BLOOM_SHIFT);
+   mSdbBloomSet(HdrPtr->Bloom, (Uint32_t)(Code * M_SDB_BLOOM_HASH3) >> M_SDB_BLOOM_SHIFT);
+
+   BlockPtr->Records[HdrPtr->NumRecords++] = *RecordPtr;
+
+   return (HdrPtr->NumRecords >= E_SDB_BLOCK_RECORDS) ? TRUE : FALSE;
+
+}  /* End of eSdbBlockAdd() */
+
+
+
+
+void eSdbBlockSeal(
+   eSdbDataBlock_t *BlockPtr
+)
+{
+/*
+** Function Name:
+**    eSdbBlockSeal
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Make a block ready for writing to file.
+**
+** Description:
+**    Sets the checksum of the block. It must be sealed again should
+**    further records be added.
+**
+** Arguments:
+**    eSdbDataBlock_t *BlockPtr (in/out)
+**       The block.
+**
+*/
+
+   BlockPtr->Hdr.Checksum = mSdbBlockSum(BlockPtr);
+
+}  /* End of eSdbBlockSeal() */
+
+
+
+
+Status_t eSdbBlockCheck(
+   eSdbDataBlock_t *BlockPtr
+)
+{
+/*
+** Function Name:
+**    eSdbBlockCheck
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Check a block read from a storage file.
+**
+** Description:
+**    The magic key, number of records and checksum of the block are
+**    checked, so that a block which has been corrupted, or is not a
+**    block at all, is not used.
+**
+** Arguments:
+**    eSdbDataBlock_t *BlockPtr (in)
+**       The block.
+**
+** Returns:
+**    SYS_NOMINAL if the block is sound, otherwise E_SDB_BLOCK_CORRUPT.
+**
+*/
+
+   if((memcmp(BlockPtr->Hdr.Magic, E_SDB_BLOCK_MAGIC, sizeof(BlockPtr->Hdr.Magic)) != 0) ||
+      (BlockPtr->Hdr.NumRecords > E_SDB_BLOCK_RECORDS) ||
+      (BlockPtr->Hdr.Checksum != mSdbBlockSum(BlockPtr)))
+   {
+      return E_SDB_BLOCK_CORRUPT;
+   }
+
+   return SYS_NOMINAL;
+
+}  /* End of eSdbBlockCheck() */
+
+
+
+
+Bool_t eSdbBlockMayHold(
+   eSdbBlockHdr_t *HdrPtr,
+   eSdbCode_t Code
+)
+{
+/*
+** Function Name:
+**    eSdbBlockMayHold
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Find whether a block may hold records of a code.
+**
+** Description:
+**    Tests the bloom filter of the block's header. Only the header need
+**    have been read.
+**
+** Arguments:
+**    eSdbBlockHdr_t *HdrPtr (in)
+**       Header of the block.
+**    eSdbCode_t Code        (in)
+**       The code.
+**
+** Returns:
+**    FALSE if the block holds no records of the code. TRUE if it may,
+**    although it need not.
+**
+*/
+
+   if((mSdbBloomTest(HdrPtr->Bloom, (Uint32_t)(Code * M_SDB_BLOOM_HASH1) >> M_SDB_BLOOM_SHIFT) == FALSE) ||
+      (mSdbBloomTest(HdrPtr->Bloom, (Uint32_t)(Code * M_SDB_BLOOM_HASH2) >> M_SDB_BLOOM_SHIFT) == FALSE) ||
+      (mSdbBloomTest(HdrPtr->Bloom, (Uint32_t)(Code * M_SDB_BLOOM_HASH3) >> M_SDB_BLOOM_SHIFT) == FALSE))
+   {
+      return FALSE;
+   }
+
+   return TRUE;
+
+}  /* End of eSdbBlockMayHold() */
+
+
+
+
+static void mSdbBloomSet(
+   Uint32_t *BloomPtr,
+   Uint32_t Bit
+)
+{
+/*
+** Function Name:
+**    mSdbBloomSet
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Set a bit of a bloom filter.
+**
+** Arguments:
+**    Uint32_t *BloomPtr     (in/out)
+**       Words of the filter.
+**    Uint32_t Bit           (in)
+**       Number of the bit.
+**
+*/
+
+   BloomPtr[Bit / 32] |= (Uint32_t) 1 << (Bit % 32);
+
+}  /* End of mSdbBloomSet() */
+
+
+
+
+static Bool_t mSdbBloomTest(
+   Uint32_t *BloomPtr,
+   Uint32_t Bit
+)
+{
+/*
+** Function Name:
+**    mSdbBloomTest
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Test a bit of a bloom filter.
+**
+** Arguments:
+**    Uint32_t *BloomPtr     (in)
+**       Words of the filter.
+**    Uint32_t Bit           (in)
+**       Number of the bit.
+**
+** Returns:
+**    TRUE if the bit is set.
+**
+*/
+
+   return (BloomPtr[Bit / 32] & ((Uint32_t) 1 << (Bit % 32))) ? TRUE : FALSE;
+
+}  /* End of mSdbBloomTest() */
+
+
+
+
+static Uint32_t mSdbBlockSum(
+   eSdbDataBlock_t *BlockPtr
+)
+{
+/*
+** Function Name:
+**    mSdbBlockSum
+**
+** Type:
+**    Uint32_t
+**
+** Purpose:
+**    Find the checksum of a block.
+**
+** Description:
+**    A Fletcher-32 of the block from the word following the checksum,
+**    taken over its 16 bit halfwords, low half first. The sums are
+**    reduced once every M_SDB_SUM_RUN words, before they can overflow.
+**
+** Arguments:
+**    eSdbDataBlock_t *BlockPtr (in)
+**       The block.
+**
+** Returns:
+**    The checksum.
+**
+*/
+
+   /* Local variables */
+   Uint32_t *WordPtr;        /* Word being summed */
+   Uint32_t NumWords;        /* Words left to sum */
+   Uint32_t Run;             /* Words left before reducing the sums */
+   Uint32_t Sum1;            /* Sum of the halfwords */
+   Uint32_t Sum2;            /* Sum of the sums */
+
+
+   WordPtr  = &(BlockPtr->Hdr.Sequence);
+   NumWords = (E_SDB_BLOCK_SIZE - (Uint32_t)((char *) WordPtr - (char *) BlockPtr))
+              / sizeof(Uint32_t);
+   Sum1 = M_SDB_SUM_MODULUS;
+   Sum2 = M_SDB_SUM_MODULUS;
+
+   while(NumWords > 0)
+   {
+      Run = (NumWords < M_SDB_SUM_RUN) ? NumWords : M_SDB_SUM_RUN;
+      NumWords -= Run;
+      while(Run-- > 0)
+      {
+         Sum1 += *WordPtr & 0xffff;
+         Sum2 += Sum1;
+         Sum1 += *WordPtr++ >> 16;
+         Sum2 += Sum1;
+      }
+      Sum1 = (Sum1 & 0xffff) + (Sum1 >> 16);
+      Sum2 = (Sum2 & 0xffff) + (Sum2 >> 16);
+   }
+
+   Sum1 = (Sum1 & 0xffff) + (Sum1 >> 16);
+   Sum2 = (Sum2 & 0xffff) + (Sum2 >> 16);
+
+   return (Sum2 << 16) | Sum1;
+
+}  /* End of mSdbBlockSum() */
+
+
+
+/* EOF */
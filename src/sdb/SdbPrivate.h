@@ -337,10 +337,10 @@
 #define I_SDB_PROGRAM_TLA    "SDB"
 #define I_SDB_PROGRAM_ABOUT  "Status Database"
 #define I_SDB_PROGRAM_TITLE  I_SDB_PROGRAM_TLA " - " I_SDB_PROGRAM_ABOUT
-#define I_SDB_RELEASE_DATE   "1 October 2007"
-#define I_SDB_YEAR           "2000-07"
+#define I_SDB_RELEASE_DATE   "17 October 2026"
+#define I_SDB_YEAR           "2000-26"
 #define I_SDB_MAJOR_VERSION  1
-#define I_SDB_MINOR_VERSION  12
+#define I_SDB_MINOR_VERSION  13
 
 
 
@@ -372,7 +372,8 @@
 #define I_SDB_CUSTOM_CLEANUP      3
 #define I_SDB_CUSTOM_MYSQLHOST    4
 #define I_SDB_CUSTOM_MYSQLPORT    5
-#define I_SDB_NUM_CUSTOM_ARGS     6
+#define I_SDB_CUSTOM_FORMAT       6
+#define I_SDB_NUM_CUSTOM_ARGS     7
 
 /*
 ** Global custom argument specification (note the string concatenation
@@ -407,6 +408,10 @@
          E_SDB_MYSQLPORT " <port>", 3,
          "MySQL database port", FALSE, NULL
       },
+      {
+         E_SDB_FORMAT " <1|2>", 3,
+         "Format of new storage files, 2 for blocks", FALSE, NULL
+      },
       {
          E_CLU_EOL, 0, E_CLU_EOL, FALSE, NULL
       }
@@ -533,6 +538,9 @@ struct iSdbDbFile_s
    FILE *FilePtr;            /* File pointer to the file (if open) */
    eTtlTime_t StartTime;     /* Time of the start of the file */
    eTtlTime_t LastAccessed;  /* Time when the file was last accessed */
+   Int32_t Format;           /* Format of the file (if open) */
+   Uint32_t NumBlocks;       /* Blocks written to the file (format 2) */
+   eSdbDataBlock_t *BlockPtr;/* Block being filled (format 2), or NULL */
 };
 typedef struct iSdbDbFile_s iSdbDbFile_t;
 
@@ -544,6 +552,9 @@ typedef struct iSdbDbFile_s iSdbDbFile_t;
                                        /* This should be less than the */
                                        /* hbeat-loss timeout */
 #define I_SDB_DFLT_CLEANUP   28        /* Default days before file cleanup */
+#define I_SDB_FORMAT_RECORDS 1         /* Storage files of records */
+#define I_SDB_FORMAT_BLOCKS  2         /* Storage files of blocks of records */
+#define I_SDB_DFLT_FORMAT    I_SDB_FORMAT_RECORDS
 
 E_SDB_EXTERN iSdbDbFile_t  iSdbDbFileList[ I_SDB_MAX_DB_FILES ] ;
 
@@ -565,6 +576,8 @@ E_SDB_EXTERN char                   /* Path for data files */
    iSdbDatafilePath[ I_SDB_MAX_FILENAME ];
 E_SDB_EXTERN int                    /* Days to determine SDB file cleanup */
    iSdbCleanupDays   E_SDB_INIT( I_SDB_DFLT_CLEANUP );
+E_SDB_EXTERN Int32_t                /* Format of new SDB storage files */
+   iSdbFileFormat    E_SDB_INIT( I_SDB_DFLT_FORMAT );
 E_SDB_EXTERN char                   /* MySql hostname */
    iSdbMySqlHost[ I_SDB_MAX_SQLHOST ];
 E_SDB_EXTERN char                   /* MySql port */
@@ -721,6 +734,7 @@ extern Status_t iSdbStoreUnits(iSdbDefn_t *DefnPtr);
 
 extern Status_t iSdbStorePrevData(iSdbDefn_t *DefnPtr);
 extern Status_t iSdbStoreData(Bool_t Force, iSdbDefn_t *DefnPtr);
+extern Status_t iSdbCloseDbFile(Int32_t Index);
 
 extern Status_t iSdbFileRetr(Int32_t DelivererId, eCilMsg_t *MsgPtr, 
                              Bool_t LastData);
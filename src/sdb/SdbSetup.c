@@ -255,6 +255,22 @@ Status_t iSdbSetup
                                 0, 0 );
    }
 
+   /* Check for the specification of the format of new storage files */
+   if ( eCluCustomArgExists( I_SDB_CUSTOM_FORMAT ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get the supplied parameter and check that it is a known format */
+      iSdbFileFormat = strtol( eCluGetCustomParam( I_SDB_CUSTOM_FORMAT ),
+                               0, 0 );
+      if ( ( iSdbFileFormat != I_SDB_FORMAT_RECORDS ) &&
+           ( iSdbFileFormat != I_SDB_FORMAT_BLOCKS ) )
+      {
+         eLogWarning( 0, "Unknown SDB file format %d, using format %d",
+                      iSdbFileFormat, I_SDB_DFLT_FORMAT );
+         iSdbFileFormat = I_SDB_DFLT_FORMAT;
+      }
+      eLogNotice( 0, "SDB files created in format %d", iSdbFileFormat );
+   }
+
    /* Default to not sending to an SQL database. */
    iSdbSendToSql = FALSE;
 
@@ -322,6 +338,9 @@ Status_t iSdbSetup
       iSdbDbFileList[Index].StartTime.t_nsec = 0;
       iSdbDbFileList[Index].LastAccessed.t_sec = 0;
       iSdbDbFileList[Index].LastAccessed.t_nsec = 0;
+      iSdbDbFileList[Index].Format = I_SDB_DFLT_FORMAT;
+      iSdbDbFileList[Index].NumBlocks = 0;
+      iSdbDbFileList[Index].BlockPtr = NULL;
    }
 
    /*
@@ -272,10 +272,9 @@ void iSdbGoSafe(void)
          if(iSdbDbFileList[Index].FilePtr != NULL)
          {
             /* Close the file (this will also flush unwritten data) */
-            fclose(iSdbDbFileList[Index].FilePtr);
+            iSdbCloseDbFile(Index);
 
             /* Reset all the file parameters, to start again if activated */
-            iSdbDbFileList[Index].FilePtr = NULL;
             iSdbDbFileList[Index].StartTime.t_sec = 0;
             iSdbDbFileList[Index].StartTime.t_nsec = 0;
             iSdbDbFileList[Index].LastAccessed.t_sec = 0;
@@ -412,7 +411,7 @@ Status_t iSdbShutdown
       {
          if(iSdbDbFileList[Index].FilePtr != NULL)
          {
-            fclose(iSdbDbFileList[Index].FilePtr);
+            iSdbCloseDbFile(Index);
          }
       }
    }
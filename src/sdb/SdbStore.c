@@ -156,6 +156,9 @@ Status_t mSdbReadyDbFile(eTtlTime_t *FileStartTimePtr, Int32_t *DbFileIndexPtr,
 Status_t mSdbGetHour(eTtlTime_t *TimePtr, eTtlTime_t *HourPtr);
 Status_t mSdbDurToUsec(eTtlTime_t *DurationPtr, Uint32_t *UsecPtr);
 Status_t mSdbWriteHeader(int Index);
+Status_t mSdbFileFormat(char *FileName, Int32_t Index);
+Status_t mSdbWriteRecord(Int32_t Index, eSdbRawFmt_t *RecordPtr);
+Status_t mSdbWriteBlock(Int32_t Index);
 
 
 /* Functions */
@@ -209,7 +212,6 @@ Status_t iSdbStorePrevData(
    eTtlTime_t TimeDiff;      /* Diff' between FileStartTime and Datum time */
    Int32_t Index;            /* Index into the iSdbDbFileList array */
    eSdbRawFmt_t FileData;    /* Buffer for data to be written to file */
-   size_t NumRecords;        /* Number of records (written to file) */
    eSdbSngReq_t Req;         /* Datum specification (for code generation) */
    eSdbDatum_t MySqlDatum;   /* Datum to send to MySql host */
 
@@ -296,14 +298,9 @@ Status_t iSdbStorePrevData(
 
 
    /* Actually write the data to the file */
-   NumRecords = fwrite(
-                   &FileData, sizeof(FileData), 1,
-                   iSdbDbFileList[Index].FilePtr
-                );
-   if(NumRecords != 1)
+   Status = mSdbWriteRecord(Index, &FileData);
+   if(Status != SYS_NOMINAL)
    {
-      Status = E_SDB_FWRITE_FAIL;
-      eLogErr(Status, "Error writing data to file");
       return Status;
    }
 
@@ -404,7 +401,6 @@ Status_t iSdbStoreData(
    eTtlTime_t TimeDiff;      /* Diff' between FileStartTime and Datum time */
    Int32_t Index;            /* Index into the iSdbDbFileList array */
    eSdbRawFmt_t FileData;    /* Buffer for data to be written to file */
-   size_t NumRecords;        /* Number of records (written to file) */
    eSdbSngReq_t Req;         /* Datum specification (for code generation) */
    eSdbDatum_t MySqlDatum;   /* Datum to send to MySql host */
 
@@ -509,14 +505,9 @@ printf("Code = 0x%4.4hx,  Time = 0x%x = %d,  Value = 0x%x = %d\n",
 */
 
    /* Actually write the data to the file */
-   NumRecords = fwrite(
-                   &FileData, sizeof(FileData), 1,
-                   iSdbDbFileList[Index].FilePtr
-                );
-   if(NumRecords != 1)
+   Status = mSdbWriteRecord(Index, &FileData);
+   if(Status != SYS_NOMINAL)
    {
-      Status = E_SDB_FWRITE_FAIL;
-      eLogErr(Status, "Error writing data to file");
       return Status;
    }
 
@@ -703,8 +694,7 @@ Status_t mSdbReadyDbFile(
       }
 
       /* Close the file with the oldest access time */
-      fclose(iSdbDbFileList[OldestIndex].FilePtr);
-      iSdbDbFileList[OldestIndex].FilePtr = NULL;
+      iSdbCloseDbFile(OldestIndex);
 
       /* Note the index number of the file that was closed */
       Index = OldestIndex;
@@ -727,6 +717,13 @@ Status_t mSdbReadyDbFile(
       FileName, Index, eCilNameString(DefnPtr->SourceId), DefnPtr->DatumId
    );
 
+   /* Find the format of the file, so that it is appended to in kind */
+   Status = mSdbFileFormat(FileName, Index);
+   if(Status != SYS_NOMINAL)
+   {
+      return Status;
+   }
+
    /* Open the file (note that we are appending to it) */
    iSdbDbFileList[Index].FilePtr = fopen(FileName, "ab");
    if(iSdbDbFileList[Index].FilePtr == NULL)
@@ -932,6 +929,8 @@ Status_t mSdbWriteHeader(
 **       +---+---+---+---+---+---+---+---+
 **       |                               |
 **
+**    Block-structured files are keyed "SDB2" instead.
+**
 **
 ** Arguments:
 **    int Index              (in)
@@ -952,6 +951,12 @@ Status_t mSdbWriteHeader(
       E_SDB_HEADER_STRING;   /*    Initial value for HeaderStrPtr */
 
 
+   /* Block-structured files have a header string of their own */
+   if(iSdbDbFileList[Index].Format == I_SDB_FORMAT_BLOCKS)
+   {
+      HeaderStrPtr = E_SDB_HEADER_STRING_V2;
+   }
+
 
    /* Write a header string */
    NumRecords = fwrite(
@@ -983,6 +988,286 @@ Status_t mSdbWriteHeader(
 }  /* End of mSdbWriteHeader() */
 
 
+
+Status_t mSdbFileFormat(
+   char *FileName,
+   Int32_t Index
+)
+{
+/*
+** Function Name:
+**    mSdbFileFormat
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Determine the format of a storage file about to be opened.
+**
+** Description:
+**    A new (or empty) file is given the format chosen on the command
+**    line. A file that already exists keeps the format it was created
+**    in, found from its header string, so that data are never appended
+**    to it in the other format. For a block-structured file the blocks
+**    already written are counted, and any part-written block left at
+**    its end (by a crash) is cut off, so that appended blocks remain
+**    aligned. The format, and block count, are put into the global
+**    array iSdbDbFileList, and a block to fill is allocated.
+**
+** Arguments:
+**    char *FileName         (in)
+**       Name of the storage file.
+**    Int32_t Index          (in)
+**       Array index for the global array iSdbDbFileList.
+**
+*/
+
+   /* Local variables */
+   Status_t Status;          /* Function return value */
+   struct stat FileStat;     /* Details of the file, if it exists */
+   FILE *FilePtr;            /* The file, opened to read its header */
+   char Key[ E_SDB_HEADER_SIZE ]; /* Header string of the file */
+   long Whole;               /* Size of the whole blocks of the file */
+   iSdbDbFile_t *DbFilePtr;  /* Entry for the file in the global array */
+
+
+   DbFilePtr = &iSdbDbFileList[Index];
+   DbFilePtr->Format = iSdbFileFormat;
+   DbFilePtr->NumBlocks = 0;
+
+   /* An existing file keeps its own format */
+   if((stat(FileName, &FileStat) == 0) && (FileStat.st_size > 0))
+   {
+      DbFilePtr->Format = I_SDB_FORMAT_RECORDS;
+      FilePtr = fopen(FileName, "rb");
+      if(FilePtr == NULL)
+      {
+         eLogErr(E_SDB_FOPEN_FAIL, "Unable to open file \"%s\"", FileName);
+         return E_SDB_FOPEN_FAIL;
+      }
+      if((fread(Key, 1, strlen(E_SDB_HEADER_STRING_V2), FilePtr)
+          == strlen(E_SDB_HEADER_STRING_V2)) &&
+         (memcmp(Key, E_SDB_HEADER_STRING_V2, strlen(E_SDB_HEADER_STRING_V2))
+          == 0))
+      {
+         DbFilePtr->Format = I_SDB_FORMAT_BLOCKS;
+      }
+      fclose(FilePtr);
+
+      if(DbFilePtr->Format == I_SDB_FORMAT_BLOCKS)
+      {
+         DbFilePtr->NumBlocks = (FileStat.st_size > E_SDB_HEADER_SIZE)
+            ? (Uint32_t) ((FileStat.st_size - E_SDB_HEADER_SIZE)
+                          / E_SDB_BLOCK_SIZE)
+            : 0;
+         Whole = E_SDB_HEADER_SIZE + (long) DbFilePtr->NumBlocks
+                                     * E_SDB_BLOCK_SIZE;
+         if(FileStat.st_size > Whole)
+         {
+            eLogWarning(E_SDB_BLOCK_CORRUPT,
+               "Removing part-written block at end of \"%s\"", FileName);
+            if(truncate(FileName, Whole) != 0)
+            {
+               eLogErr(E_SDB_FOPEN_FAIL,
+                  "Unable to truncate file \"%s\", errno %d",
+                  FileName, errno);
+               return E_SDB_FOPEN_FAIL;
+            }
+         }
+      }
+   }
+
+   /* A block-structured file needs a block to fill */
+   if(DbFilePtr->Format == I_SDB_FORMAT_BLOCKS)
+   {
+      if(DbFilePtr->BlockPtr == NULL)
+      {
+         DbFilePtr->BlockPtr = TTL_MALLOC(sizeof(eSdbDataBlock_t));
+         if(DbFilePtr->BlockPtr == NULL)
+         {
+            Status = E_SDB_GEN_ERR;
+            eLogCrit(Status, "Insufficient memory for storage file block");
+            return Status;
+         }
+      }
+      eSdbBlockStart(DbFilePtr->BlockPtr, DbFilePtr->NumBlocks);
+   }
+
+   return SYS_NOMINAL;
+
+}  /* End of mSdbFileFormat() */
+
+
+
+Status_t mSdbWriteRecord(
+   Int32_t Index,
+   eSdbRawFmt_t *RecordPtr
+)
+{
+/*
+** Function Name:
+**    mSdbWriteRecord
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Writes a record to an SDB storage file.
+**
+** Description:
+**    In the original format the record is written straight to the
+**    file. In the block-structured format it is added to the block
+**    being filled, which is written once it is full.
+**
+** Arguments:
+**    Int32_t Index          (in)
+**       Array index for the global array iSdbDbFileList.
+**    eSdbRawFmt_t *RecordPtr (in)
+**       The record.
+**
+*/
+
+   /* Local variables */
+   Status_t Status;          /* Function return value */
+   size_t NumRecords;        /* Number of records (written to file) */
+
+
+   if(iSdbDbFileList[Index].Format == I_SDB_FORMAT_BLOCKS)
+   {
+      if(eSdbBlockAdd(iSdbDbFileList[Index].BlockPtr, RecordPtr) == TRUE)
+      {
+         return mSdbWriteBlock(Index);
+      }
+      return SYS_NOMINAL;
+   }
+
+   NumRecords = fwrite(
+                   RecordPtr, sizeof(eSdbRawFmt_t), 1,
+                   iSdbDbFileList[Index].FilePtr
+                );
+   if(NumRecords != 1)
+   {
+      Status = E_SDB_FWRITE_FAIL;
+      eLogErr(Status, "Error writing data to file");
+      return Status;
+   }
+
+   return SYS_NOMINAL;
+
+}  /* End of mSdbWriteRecord() */
+
+
+
+Status_t mSdbWriteBlock(
+   Int32_t Index
+)
+{
+/*
+** Function Name:
+**    mSdbWriteBlock
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Writes the block being filled to a block-structured storage file.
+**
+** Description:
+**    The block is sealed and written whole, and the next block of the
+**    file started. A block with no records is not written.
+**
+** Arguments:
+**    Int32_t Index          (in)
+**       Array index for the global array iSdbDbFileList.
+**
+*/
+
+   /* Local variables */
+   Status_t Status;          /* Function return value */
+   size_t NumRecords;        /* Number of blocks (written to file) */
+   iSdbDbFile_t *DbFilePtr;  /* Entry for the file in the global array */
+
+
+   DbFilePtr = &iSdbDbFileList[Index];
+   if(DbFilePtr->BlockPtr->Hdr.NumRecords == 0)
+   {
+      return SYS_NOMINAL;
+   }
+
+   eSdbBlockSeal(DbFilePtr->BlockPtr);
+   NumRecords = fwrite(
+                   DbFilePtr->BlockPtr, E_SDB_BLOCK_SIZE, 1,
+                   DbFilePtr->FilePtr
+                );
+   DbFilePtr->NumBlocks++;
+   eSdbBlockStart(DbFilePtr->BlockPtr, DbFilePtr->NumBlocks);
+   if(NumRecords != 1)
+   {
+      Status = E_SDB_FWRITE_FAIL;
+      eLogErr(Status, "Error writing block to file");
+      return Status;
+   }
+
+   return SYS_NOMINAL;
+
+}  /* End of mSdbWriteBlock() */
+
+
+
+Status_t iSdbCloseDbFile(
+   Int32_t Index
+)
+{
+/*
+** Function Name:
+**    iSdbCloseDbFile
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Closes an SDB storage file.
+**
+** Description:
+**    Any part-filled block of a block-structured file is written
+**    before the file is closed, and its memory released. The file
+**    pointer in the global array iSdbDbFileList is set to NULL.
+**
+** Arguments:
+**    Int32_t Index          (in)
+**       Array index for the global array iSdbDbFileList.
+**
+*/
+
+   /* Local variables */
+   Status_t Status;          /* Function return value */
+   iSdbDbFile_t *DbFilePtr;  /* Entry for the file in the global array */
+
+
+   DbFilePtr = &iSdbDbFileList[Index];
+   Status = SYS_NOMINAL;
+
+   if(DbFilePtr->BlockPtr != NULL)
+   {
+      if(DbFilePtr->FilePtr != NULL)
+      {
+         Status = mSdbWriteBlock(Index);
+      }
+      TTL_FREE(DbFilePtr->BlockPtr);
+      DbFilePtr->BlockPtr = NULL;
+   }
+
+   if(DbFilePtr->FilePtr != NULL)
+   {
+      fclose(DbFilePtr->FilePtr);
+      DbFilePtr->FilePtr = NULL;
+   }
+
+   return Status;
+
+}  /* End of iSdbCloseDbFile() */
+
+
 int mSdbRawSend
 (
    void  *DataPtr,
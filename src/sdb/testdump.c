@@ -154,6 +154,8 @@ char CilName[ E_CIL_EOL ] [ E_CIL_IDLEN ];   /* Storage for CIL names */
 
 char *   mXxxGetIdName       ( char * IndexFilename, Int32_t Process, 
                                Int32_t Value, char * Buffer );
+size_t   mXxxReadBlocked     ( FILE * FilePtr, eSdbDataBlock_t * BlockPtr,
+                               Uint32_t * NextPtr, eSdbRawFmt_t * StorePtr );
 
 
 int main(
@@ -197,6 +199,9 @@ int main(
    unsigned Datum;           /* Temp variable for datum to display */
    FILE *FilePtr;            /* Pointer to an SDB storage file */
    eSdbRawFmt_t Store;       /* Structure for storage format */
+   static eSdbDataBlock_t Block; /* Block of a block-structured file */
+   Uint32_t NextRecord = 0;  /* Next record of Block to display */
+   Bool_t Blocked;           /* The file is block-structured */
    char Buf[M_XXX_BUFSIZE];  /* Dummy buffer */
    size_t NumBytes = 0;      /* Number of bytes read from a fread() */
    size_t TotBytes = 0;      /* Total number of bytes read from file */
@@ -375,6 +380,9 @@ int main(
       exit( EXIT_FAILURE );
    }
    TotBytes += NumBytes;
+   Blocked = ( memcmp( Buf, E_SDB_HEADER_STRING_V2, M_XXX_FILE_HDR_SIZE ) == 0 )
+             ? TRUE : FALSE;
+   Block.Hdr.NumRecords = 0;
 
 
    /* Get the file "time-stamp", from which all other times are offset. */
@@ -392,7 +400,14 @@ int main(
    NumRecords = 1;
    while(NumRecords != 0)
    {
-      NumRecords = fread(&Store, sizeof(Store), 1, FilePtr);
+      if(Blocked == TRUE)
+      {
+         NumRecords = mXxxReadBlocked(FilePtr, &Block, &NextRecord, &Store);
+      }
+      else
+      {
+         NumRecords = fread(&Store, sizeof(Store), 1, FilePtr);
+      }
       if(NumRecords == 1)
       {
          TotRecords++;
@@ -571,4 +586,59 @@ char *   mXxxGetIdName       ( char * IndexFilename, Int32_t Process,
 }
 
 
+/*******************************************************************************
+** Function Name:
+**    mXxxReadBlocked
+**
+** Purpose:
+**    Function to read the next record of a block-structured SDB file.
+**
+** Description:
+**    Records are taken in turn from the block last read. Once it is used 
+**    up, the next block is read from the file and checked. A block that 
+**    fails its checks is reported and skipped.
+**
+** Return Type:
+**    size_t 
+**       Returns 1 if a record was read, or 0 at the end of the file.
+**
+** Arguments:
+**    FILE * FilePtr                   (in)
+**       The file, positioned at a block.
+**    eSdbDataBlock_t * BlockPtr       (in/out)
+**       The block last read, with no records to begin with.
+**    Uint32_t * NextPtr               (in/out)
+**       Index in the block of the next record.
+**    eSdbRawFmt_t * StorePtr          (out)
+**       The record read.
+**
+*******************************************************************************/
+
+size_t   mXxxReadBlocked     ( FILE * FilePtr, eSdbDataBlock_t * BlockPtr,
+                               Uint32_t * NextPtr, eSdbRawFmt_t * StorePtr )
+{
+   /* read blocks until one with a record left is found */
+   while ( *NextPtr >= BlockPtr->Hdr.NumRecords )
+   {
+      if ( fread( BlockPtr, E_SDB_BLOCK_SIZE, 1, FilePtr ) != 1 )
+      {
+         return 0;
+      }
+      *NextPtr = 0;
+
+      /* skip a block that has been corrupted */
+      if ( eSdbBlockCheck( BlockPtr ) != SYS_NOMINAL )
+      {
+         printf( "Warning: block %ld corrupt, skipped\n",
+                 ( ftell( FilePtr ) - E_SDB_HEADER_SIZE ) / E_SDB_BLOCK_SIZE - 1 );
+         BlockPtr->Hdr.NumRecords = 0;
+      }
+   }
+
+   *StorePtr = BlockPtr->Records[ ( *NextPtr )++ ];
+   return 1;
+
+}
+
+
 /* EOF */
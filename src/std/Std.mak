@@ -55,7 +55,14 @@ include ../TtlLabels.mak
 # List of object files.
 OBJS =	StdMain.o \
 		StdInit.o \
-		StdOutput.o 
+		StdOutput.o \
+		StdLookup.o \
+		StdStore.o \
+		StdFormat.o \
+		StdThread.o \
+		StdFollow.o \
+		StdSearch.o \
+		StdServe.o 
 
 
 ZLIB_OBJ = gzio.o \
@@ -82,6 +89,9 @@ LIBS = 	Std.lib \
 		$(TTL_LIB)/Cfu.lib \
 		$(TTL_LIB)/Hti.lib
 
+# Worker threads
+THREAD_LIB = -lpthread
+
 # List of include files.
 INCS =	Std.h \
 		StdPrivate.h \
@@ -102,11 +112,20 @@ ZLIB_INCS = deflate.h \
 
 # Build rules (general).
 
-all:	Std.lib zlib.lib Std 
+all:	Std.lib zlib.lib Std sdbgzindex sdbindex sdbcatalog sdbcolumns sdbrollup sdbbgz sdbbundle sdbdump
 
 clean:
 	$(RM) $(OBJS) $(ZLIB_OBJ)
 	$(RM) Std
+	$(RM) sdbgzindex sdbgzindex.o StdGzIndex.o
+	$(RM) sdbindex sdbindex.o StdSdbIndex.o
+	$(RM) sdbcatalog sdbcatalog.o StdCatalog.o
+	$(RM) sdbcolumns sdbcolumns.o StdColumns.o
+	$(RM) sdbrollup sdbrollup.o StdRollup.o
+	$(RM) sdbbgz sdbbgz.o StdBgzf.o
+	$(RM) sdbbundle sdbbundle.o StdBundle.o
+	$(RM) sdbdump sdbdump.o StdBinary.o
+	$(RM) StdFiles.o StdTail.o
 	$(RM) Std.lib
 	$(RM) zlib.lib
 
@@ -114,14 +133,38 @@ clean:
 # Executable rules.
 
 Std:	Std.mak $(OBJS) $(LIBS)
-	$(LN) -o Std $(OBJS) $(LIBS) $(LN_OPT)
+	$(LN) -o Std $(OBJS) $(LIBS) $(LN_OPT) $(THREAD_LIB)
+
+sdbgzindex:	Std.mak sdbgzindex.o $(LIBS)
+	$(LN) -o sdbgzindex sdbgzindex.o $(LIBS) $(LN_OPT) $(THREAD_LIB)
+
+sdbindex:	Std.mak sdbindex.o $(LIBS)
+	$(LN) -o sdbindex sdbindex.o $(LIBS) $(LN_OPT) $(THREAD_LIB)
+
+sdbcatalog:	Std.mak sdbcatalog.o $(LIBS)
+	$(LN) -o sdbcatalog sdbcatalog.o $(LIBS) $(LN_OPT) $(THREAD_LIB)
+
+sdbcolumns:	Std.mak sdbcolumns.o $(LIBS)
+	$(LN) -o sdbcolumns sdbcolumns.o $(LIBS) $(LN_OPT) $(THREAD_LIB)
+
+sdbrollup:	Std.mak sdbrollup.o $(LIBS)
+	$(LN) -o sdbrollup sdbrollup.o $(LIBS) $(LN_OPT) $(THREAD_LIB)
+
+sdbbgz:	Std.mak sdbbgz.o $(LIBS)
+	$(LN) -o sdbbgz sdbbgz.o $(LIBS) $(LN_OPT) $(THREAD_LIB)
+
+sdbbundle:	Std.mak sdbbundle.o $(LIBS)
+	$(LN) -o sdbbundle sdbbundle.o $(LIBS) $(LN_OPT) $(THREAD_LIB)
+
+sdbdump:	Std.mak sdbdump.o $(LIBS)
+	$(LN) -o sdbdump sdbdump.o $(LIBS) $(LN_OPT) $(THREAD_LIB)
 
 
 
 # Library build rules
 
-Std.lib:	Std.mak StdLib.o 
-	$(LB) $(LB_OPT) $@ $(LB_DIV) StdLib.o
+Std.lib:	Std.mak StdLib.o StdGzIndex.o StdSdbIndex.o StdCatalog.o StdColumns.o StdRollup.o StdBinary.o StdBgzf.o StdBundle.o StdFiles.o StdTail.o
+	$(LB) $(LB_OPT) $@ $(LB_DIV) StdLib.o StdGzIndex.o StdSdbIndex.o StdCatalog.o StdColumns.o StdRollup.o StdBinary.o StdBgzf.o StdBundle.o StdFiles.o StdTail.o
 
 zlib.lib:	$(ZLIB_OBJ) $(ZLIB_INCS)
 	$(LB) $(LB_OPT) $@ $(LB_DIV) $(ZLIB_OBJ)
@@ -138,9 +181,84 @@ StdInit.o:  Std.mak $(INCS) StdInit.c
 StdOutput.o:  Std.mak $(INCS) StdOutput.c
 	$(CC) $(CC_OPT) StdOutput.c
 
+StdLookup.o:  Std.mak $(INCS) StdLookup.c
+	$(CC) $(CC_OPT) StdLookup.c
+
+StdStore.o:  Std.mak $(INCS) StdStore.c
+	$(CC) $(CC_OPT) StdStore.c
+
+StdFormat.o:  Std.mak $(INCS) StdFormat.c
+	$(CC) $(CC_OPT) StdFormat.c
+
+StdThread.o:  Std.mak $(INCS) StdThread.c
+	$(CC) $(CC_OPT) StdThread.c
+
+StdFollow.o:  Std.mak $(INCS) StdFollow.c
+	$(CC) $(CC_OPT) StdFollow.c
+
+StdSearch.o:  Std.mak $(INCS) StdSearch.c
+	$(CC) $(CC_OPT) StdSearch.c
+
+StdServe.o:  Std.mak $(INCS) StdServe.c
+	$(CC) $(CC_OPT) StdServe.c
+
 StdLib.o:  Std.mak $(INCS) StdLib.c
 	$(CC) $(CC_OPT) StdLib.c
 
+StdGzIndex.o:  Std.mak $(INCS) StdGzIndex.c
+	$(CC) $(CC_OPT) StdGzIndex.c
+
+StdSdbIndex.o:  Std.mak $(INCS) StdSdbIndex.c
+	$(CC) $(CC_OPT) StdSdbIndex.c
+
+StdCatalog.o:  Std.mak $(INCS) StdCatalog.c
+	$(CC) $(CC_OPT) StdCatalog.c
+
+StdColumns.o:  Std.mak $(INCS) StdColumns.c
+	$(CC) $(CC_OPT) StdColumns.c
+
+StdRollup.o:  Std.mak $(INCS) StdRollup.c
+	$(CC) $(CC_OPT) StdRollup.c
+
+StdBinary.o:  Std.mak $(INCS) StdBinary.c
+	$(CC) $(CC_OPT) StdBinary.c
+
+StdBgzf.o:  Std.mak $(INCS) StdBgzf.c
+	$(CC) $(CC_OPT) StdBgzf.c
+
+StdBundle.o:  Std.mak $(INCS) StdBundle.c
+	$(CC) $(CC_OPT) StdBundle.c
+
+StdFiles.o:  Std.mak $(INCS) StdFiles.c
+	$(CC) $(CC_OPT) StdFiles.c
+
+StdTail.o:  Std.mak $(INCS) StdTail.c
+	$(CC) $(CC_OPT) StdTail.c
+
+sdbgzindex.o:  Std.mak $(INCS) sdbgzindex.c
+	$(CC) $(CC_OPT) sdbgzindex.c
+
+sdbindex.o:  Std.mak $(INCS) sdbindex.c
+	$(CC) $(CC_OPT) sdbindex.c
+
+sdbcatalog.o:  Std.mak $(INCS) sdbcatalog.c
+	$(CC) $(CC_OPT) sdbcatalog.c
+
+sdbcolumns.o:  Std.mak $(INCS) sdbcolumns.c
+	$(CC) $(CC_OPT) sdbcolumns.c
+
+sdbrollup.o:  Std.mak $(INCS) sdbrollup.c
+	$(CC) $(CC_OPT) sdbrollup.c
+
+sdbbgz.o:  Std.mak $(INCS) sdbbgz.c
+	$(CC) $(CC_OPT) sdbbgz.c
+
+sdbbundle.o:  Std.mak $(INCS) sdbbundle.c
+	$(CC) $(CC_OPT) sdbbundle.c
+
+sdbdump.o:  Std.mak $(INCS) sdbdump.c
+	$(CC) $(CC_OPT) sdbdump.c
+
 gzio.o:    Std.mak $(ZLIB_INCS) gzio.c
 	$(CC)  $(CC_OPT_NON_ANSI) gzio.c
 
@@ -181,6 +299,14 @@ inffast.o:    Std.mak $(ZLIB_INCS) inffast.c
 
 publish :
 	  $(CP) Std        $(TTL_UTIL)
+	  $(CP) sdbgzindex $(TTL_UTIL)
+	  $(CP) sdbindex   $(TTL_UTIL)
+	  $(CP) sdbcatalog $(TTL_UTIL)
+	  $(CP) sdbcolumns $(TTL_UTIL)
+	  $(CP) sdbrollup  $(TTL_UTIL)
+	  $(CP) sdbbgz     $(TTL_UTIL)
+	  $(CP) sdbbundle  $(TTL_UTIL)
+	  $(CP) sdbdump    $(TTL_UTIL)
 	  $(CP) Std.lib    $(TTL_LIB)
 	  $(CP) zlib.lib   $(TTL_LIB)
 	  $(CP) zlib.h     $(TTL_INCLUDE)
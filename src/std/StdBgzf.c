@@ -0,0 +1,1536 @@
+/*****************************************************************************
+** Module Name:
+**     StdBgzf.c
+**
+** Purpose:
+**     Block-compressed Sdb files, which unlike gzipped ones can be
+**     inflated from any block.
+**
+** Description:
+**     "yymmddhh.sdb.bgz" holds the data of "yymmddhh.sdb" as a series of
+**     gzip members, in the manner of BGZF. Each member is a block
+**     compressed on its own, no more than I_STD_BGZF_MAX_BLOCK bytes
+**     either way, with its compressed size in a "BC" field of its gzip
+**     header. The first block holds the file's header and time stamp,
+**     each of the others up to I_STD_BGZF_RECORDS whole records, and the
+**     file ends with an empty block, so that one cut short is noticed.
+**     The file remains a valid gzip file, which zlib reads as a whole.
+**
+**     A reader walks the headers and trailers of the blocks to find the
+**     records each holds, then inflates only the blocks holding records
+**     it needs, checking each against its CRC.
+**
+**     An archive is converted by a pool of threads, each converting a
+**     whole hour at a time. Each file written is read back and compared
+**     with the original, record for record, before it is put in place,
+**     and is then noted in a checkpoint file, so that a conversion which
+**     is interrupted can be resumed.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <zlib.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_BGZF_HDR     18     /* Bytes of a block's gzip header */
+#define M_STD_BGZF_TRAILER 8      /* CRC and size following a block's data */
+#define M_STD_GZ_FEXTRA    0x04   /* Gzip header flag of an extra field */
+#define M_STD_MAX_DEPTH    8      /* Deepest directory searched */
+#define M_STD_NAME_LEN     8      /* Digits of "yymmddhh" */
+#define M_STD_MORE_NAMES   1024   /* Names allowed for at a time */
+
+/* Where a block lies in the file, and the records it holds */
+typedef struct mStdBgzfBlock_s
+{
+   Uint32_t       Offset;        /* Offset of the block in the file */
+   Uint32_t       Size;          /* Bytes of the block */
+   Uint32_t       DataStart;     /* Offset of its deflate data in the block */
+   Uint32_t       DataSize;      /* Bytes once inflated */
+   Uint32_t       FirstRecord;   /* Record of the file starting it */
+} mStdBgzfBlock_t;
+
+/* A block-compressed Sdb file opened for random access */
+struct iStdBgzf_s
+{
+   unsigned char   *MapPtr;      /* The file, mapped */
+   size_t           MapSize;     /* Size of the file */
+   mStdBgzfBlock_t *Blocks;      /* Blocks of records */
+   Uint32_t         NumBlocks;   /* Number of them */
+   Uint32_t         NumRecords;  /* Records of the file */
+   char             Header[ I_STD_RECORDS_START ]; /* Header and time stamp */
+   z_stream         Strm;        /* Raw inflation */
+   Bool_t           StrmReady;   /* Inflation has been set up */
+   unsigned char   *DataPtr;     /* Block last inflated */
+};
+
+/* Sdb files of an archive being converted */
+typedef struct mStdBgzfScan_s
+{
+   char           **Files;       /* Sdb files to be converted */
+   Uint32_t         NumFiles;    /* Number of them */
+   Uint32_t         MaxFiles;    /* Files there is room for */
+   Uint32_t         NextFile;    /* Next file to be taken by a thread */
+   char           **Done;        /* Files converted before, sorted */
+   Uint32_t         NumDone;     /* Number of them */
+   Uint32_t         MaxDone;     /* Files there is room for */
+   FILE            *Checkpoint;  /* Where files converted are noted, or NULL */
+   Bool_t           Replace;     /* Remove each original once converted */
+   Int32_t          Settled;     /* Files changed since may be being written */
+   Uint32_t         NumConverted;/* Files converted */
+   Uint32_t         NumFailed;   /* Files which could not be converted */
+   pthread_mutex_t  Lock;        /* Guards the next file and the counts */
+} mStdBgzfScan_t;
+
+/* Start of every block's gzip header, less the compressed size */
+static const unsigned char mStdBgzfHeader[ M_STD_BGZF_HDR - 2 ] =
+   { 0x1f, 0x8b, 0x08, M_STD_GZ_FEXTRA, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0 };
+
+/* Local function prototypes */
+static Status_t mStdBgzfWrite ( FILE *, z_stream *, unsigned char *, Uint32_t, unsigned char * );
+static Status_t mStdBgzfVerify ( char *SdbFilePtr, char *BgzfFilePtr, Uint32_t NumRecords );
+static Status_t mStdBgzfBlockAt ( iStdBgzf_t *BgzfPtr, Uint32_t Offset, mStdBgzfBlock_t *BlockPtr );
+static Status_t mStdBgzfInflate ( iStdBgzf_t *BgzfPtr, mStdBgzfBlock_t *BlockPtr );
+static void     mStdBgzfName ( char *SdbFilePtr, char *BgzfFilePtr );
+static Status_t mStdBgzfWalk ( mStdBgzfScan_t *ScanPtr, char *DirPtr, Int32_t Depth );
+static Bool_t   mStdBgzfIsSdb ( char *NamePtr );
+static Status_t mStdBgzfLoadDone ( mStdBgzfScan_t *ScanPtr, char *CheckpointPtr );
+static Status_t mStdBgzfAddName ( char ***NamesPtr, Uint32_t *NumPtr, Uint32_t *MaxPtr, char *NamePtr );
+static void     mStdBgzfFreeNames ( char **Names, Uint32_t NumNames );
+static void    *mStdBgzfWorker ( void *ArgPtr );
+static Uint32_t mStdGet32 ( unsigned char *BytePtr );
+static void     mStdPut32 ( unsigned char *BytePtr, Uint32_t Value );
+static int      mStdCompareNames ( const void *FirstPtr, const void *SecondPtr );
+
+
+/*****************************************************************************
+** Function Name:
+**    eStdBgzfTranscode
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Convert an Sdb file to a block-compressed one.
+**
+** Description:
+**    Writes "yymmddhh.sdb.bgz" from "yymmddhh.sdb" or "yymmddhh.sdb.gz",
+**    by way of a temporary file which is read back and compared with
+**    the original before it replaces any earlier conversion. A partial
+**    record at the end of the original is left out, as a search would
+**    ignore it. Block-structured files are not converted, as they are
+**    already read a block at a time.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR,
+**       E_STD_READ_HEAD_ERR if the file is not a plain Sdb file,
+**       E_STD_READ_DATA_ERR if it could not be read or the conversion
+**       did not match it, E_STD_FILE_WRITE_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char     *SdbFilePtr      (in)
+**       Name of the Sdb file, plain or gzipped.
+**    Bool_t    Replace         (in)
+**       Set to remove the original once converted.
+**    Uint32_t *NumRecordsPtr   (out)
+**       Number of records converted.
+**
+*****************************************************************************/
+Status_t eStdBgzfTranscode( char *SdbFilePtr,
+                            Bool_t Replace,
+                            Uint32_t *NumRecordsPtr )
+{
+   Status_t       Status;                    /* Return value of function calls */
+   char           BgzfFile[ FILENAME_MAX ];  /* Name of the conversion */
+   char           TempFile[ FILENAME_MAX + 4 ];  /* Name while being written */
+   gzFile         InFile;                    /* The original, read through zlib */
+   FILE          *OutFile;                   /* The conversion */
+   z_stream       Strm;                      /* Raw deflation */
+   unsigned char *DataPtr;                   /* Data of a block */
+   unsigned char *OutPtr;                    /* A block compressed */
+   int            NumBytes;                  /* Bytes of whole records read */
+
+   *NumRecordsPtr = 0;
+
+   if ( strlen( SdbFilePtr ) + sizeof( I_STD_EXT_BGZF ) + 4 > FILENAME_MAX )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+   mStdBgzfName( SdbFilePtr, BgzfFile );
+   sprintf( TempFile, "%s.tmp", BgzfFile );
+
+   if ( ( InFile = gzopen( SdbFilePtr, "rb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to open file %s", SdbFilePtr);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   memset( &Strm, 0, sizeof( Strm ) );
+   DataPtr = (unsigned char *) TTL_MALLOC( I_STD_BGZF_MAX_BLOCK );
+   OutPtr  = (unsigned char *) TTL_MALLOC( I_STD_BGZF_MAX_BLOCK );
+   if ( ( DataPtr == NULL ) || ( OutPtr == NULL ) ||
+        ( deflateInit2( &Strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS,
+                        8, Z_DEFAULT_STRATEGY ) != Z_OK ) )
+   {
+      TTL_FREE( DataPtr );
+      TTL_FREE( OutPtr );
+      gzclose( InFile );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if ( ( OutFile = fopen( TempFile, "wb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to write %s", TempFile);
+      deflateEnd( &Strm );
+      TTL_FREE( DataPtr );
+      TTL_FREE( OutPtr );
+      gzclose( InFile );
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   /* The header and time stamp make the first block */
+   if ( ( gzread( InFile, DataPtr, I_STD_RECORDS_START ) != (int) I_STD_RECORDS_START ) ||
+        ( memcmp( DataPtr, E_SDB_HEADER_STRING, E_STD_FILE_HDR_SIZE ) != 0 ) )
+   {
+      Status = E_STD_READ_HEAD_ERR;
+   }
+   else
+   {
+      Status = mStdBgzfWrite( OutFile, &Strm, DataPtr, I_STD_RECORDS_START, OutPtr );
+   }
+
+   while ( Status == SYS_NOMINAL )
+   {
+      NumBytes = gzread( InFile, DataPtr, I_STD_BGZF_RECORDS * sizeof( eSdbRawFmt_t ) );
+      if ( NumBytes < 0 )
+      {
+         Status = E_STD_READ_DATA_ERR;
+         break;
+      }
+      NumBytes -= NumBytes % sizeof( eSdbRawFmt_t );
+      if ( NumBytes == 0 )
+      {
+         break;
+      }
+      Status = mStdBgzfWrite( OutFile, &Strm, DataPtr, (Uint32_t) NumBytes, OutPtr );
+      *NumRecordsPtr += (Uint32_t) NumBytes / sizeof( eSdbRawFmt_t );
+   }
+
+   /* An empty block marks the end */
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdBgzfWrite( OutFile, &Strm, DataPtr, 0, OutPtr );
+   }
+
+   deflateEnd( &Strm );
+   gzclose( InFile );
+   TTL_FREE( DataPtr );
+   TTL_FREE( OutPtr );
+   if ( ( fclose( OutFile ) != 0 ) && ( Status == SYS_NOMINAL ) )
+   {
+      Status = E_STD_FILE_WRITE_ERR;
+   }
+
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdBgzfVerify( SdbFilePtr, TempFile, *NumRecordsPtr );
+      if ( Status != SYS_NOMINAL )
+      {
+         eLogErr(Status,"Conversion of %s does not match it", SdbFilePtr);
+      }
+   }
+
+   if ( ( Status == SYS_NOMINAL ) && ( rename( TempFile, BgzfFile ) != 0 ) )
+   {
+      Status = E_STD_FILE_WRITE_ERR;
+   }
+
+   if ( Status != SYS_NOMINAL )
+   {
+      remove( TempFile );
+      return Status;
+   }
+
+   eLogNotice(0,"Converted %s, %u records", SdbFilePtr, *NumRecordsPtr);
+
+   if ( ( Replace == TRUE ) && ( remove( SdbFilePtr ) != 0 ) )
+   {
+      eLogWarning(E_STD_FILE_WRITE_ERR,"Unable to remove %s", SdbFilePtr);
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdBgzfArchive
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Convert the Sdb files of an archive to block-compressed ones.
+**
+** Description:
+**    The archive is searched, to the depth a catalog searches it, for
+**    plain and gzipped Sdb files, taking the plain one of an hour which
+**    has both. Files changed in the last I_STD_CAT_SETTLE seconds, which
+**    may still be being written, are left, as are those the checkpoint
+**    notes were converted before. The rest are converted by a pool of
+**    threads, see eStdBgzfTranscode, carrying on past any which fail,
+**    and each noted in the checkpoint as soon as it is done.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL if the archive could be searched, whether or
+**       not every file was converted, E_STD_FILE_OPEN_ERR if it or the
+**       checkpoint could not be opened, E_STD_THREAD_ERR or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char     *ArchivePtr      (in)
+**       Directory holding the archive.
+**    char     *CheckpointPtr   (in)
+**       File noting the files converted, or NULL for none.
+**    Int32_t   NumThreads      (in)
+**       Number of files converted at once.
+**    Bool_t    Replace         (in)
+**       Set to remove each original once converted.
+**    Uint32_t *NumDonePtr      (out)
+**       Number of files converted.
+**    Uint32_t *NumFailedPtr    (out)
+**       Number of files which could not be converted.
+**
+*****************************************************************************/
+Status_t eStdBgzfArchive( char *ArchivePtr,
+                          char *CheckpointPtr,
+                          Int32_t NumThreads,
+                          Bool_t Replace,
+                          Uint32_t *NumDonePtr,
+                          Uint32_t *NumFailedPtr )
+{
+   Status_t        Status;                         /* Return value of function calls */
+   mStdBgzfScan_t  Scan;                           /* Files of the archive */
+   pthread_t       Threads[ I_STD_MAX_THREADS ];   /* Worker threads */
+   size_t          Len;                            /* Length of a name */
+   Uint32_t        NumKept;                        /* Files to be converted */
+   Uint32_t        i;                              /* File found */
+   Int32_t         j;                              /* Thread */
+
+   *NumDonePtr   = 0;
+   *NumFailedPtr = 0;
+
+   memset( &Scan, 0, sizeof( Scan ) );
+   Scan.Replace = Replace;
+   Scan.Settled = (Int32_t) time( NULL ) - I_STD_CAT_SETTLE;
+
+   Status = SYS_NOMINAL;
+   if ( CheckpointPtr != NULL )
+   {
+      Status = mStdBgzfLoadDone( &Scan, CheckpointPtr );
+      if ( ( Status == SYS_NOMINAL ) &&
+           ( ( Scan.Checkpoint = fopen( CheckpointPtr, "a" ) ) == NULL ) )
+      {
+         eLogErr(E_STD_FILE_OPEN_ERR,"Unable to write checkpoint %s", CheckpointPtr);
+         Status = E_STD_FILE_OPEN_ERR;
+      }
+   }
+
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdBgzfWalk( &Scan, ArchivePtr, 0 );
+   }
+
+   if ( Status != SYS_NOMINAL )
+   {
+      if ( Scan.Checkpoint != NULL )
+      {
+         fclose( Scan.Checkpoint );
+      }
+      mStdBgzfFreeNames( Scan.Files, Scan.NumFiles );
+      mStdBgzfFreeNames( Scan.Done, Scan.NumDone );
+      return Status;
+   }
+
+   /* Keep the plain file of an hour with both, which sorts just before */
+   qsort( Scan.Files, Scan.NumFiles, sizeof( char * ), mStdCompareNames );
+   NumKept = 0;
+   for ( i = 0; i < Scan.NumFiles; i++ )
+   {
+      Len = NumKept == 0 ? 0 : strlen( Scan.Files[ NumKept - 1 ] );
+      if ( ( NumKept > 0 ) &&
+           ( strncmp( Scan.Files[ NumKept - 1 ], Scan.Files[ i ], Len ) == 0 ) &&
+           ( strcmp( Scan.Files[ i ] + Len, I_STD_EXT_GZIP ) == 0 ) )
+      {
+         TTL_FREE( Scan.Files[ i ] );
+         continue;
+      }
+      Scan.Files[ NumKept++ ] = Scan.Files[ i ];
+   }
+   Scan.NumFiles = NumKept;
+
+   /* Then only those not yet converted */
+   NumKept = 0;
+   for ( i = 0; i < Scan.NumFiles; i++ )
+   {
+      if ( ( Scan.NumDone > 0 ) &&
+           ( bsearch( &(Scan.Files[ i ]), Scan.Done, Scan.NumDone, sizeof( char * ),
+                      mStdCompareNames ) != NULL ) )
+      {
+         TTL_FREE( Scan.Files[ i ] );
+         continue;
+      }
+      Scan.Files[ NumKept++ ] = Scan.Files[ i ];
+   }
+   Scan.NumFiles = NumKept;
+   mStdBgzfFreeNames( Scan.Done, Scan.NumDone );
+   Scan.Done    = NULL;
+   Scan.NumDone = 0;
+
+   eLogNotice(0,"Converting %u files of %s", Scan.NumFiles, ArchivePtr);
+
+   if ( NumThreads < 1 )
+   {
+      NumThreads = 1;
+   }
+   else if ( NumThreads > I_STD_MAX_THREADS )
+   {
+      NumThreads = I_STD_MAX_THREADS;
+   }
+   if ( (Uint32_t) NumThreads > Scan.NumFiles )
+   {
+      NumThreads = (Int32_t) Scan.NumFiles;
+   }
+
+   pthread_mutex_init( &Scan.Lock, NULL );
+
+   for ( j = 0; j < NumThreads; j++ )
+   {
+      if ( pthread_create( &Threads[ j ], NULL, mStdBgzfWorker, &Scan ) != 0 )
+      {
+         /* Those already started convert every file */
+         if ( j == 0 )
+         {
+            Status = E_STD_THREAD_ERR;
+         }
+         NumThreads = j;
+         break;
+      }
+   }
+   for ( j = 0; j < NumThreads; j++ )
+   {
+      pthread_join( Threads[ j ], NULL );
+   }
+
+   pthread_mutex_destroy( &Scan.Lock );
+
+   if ( Scan.Checkpoint != NULL )
+   {
+      fclose( Scan.Checkpoint );
+   }
+   mStdBgzfFreeNames( Scan.Files, Scan.NumFiles );
+
+   *NumDonePtr   = Scan.NumConverted;
+   *NumFailedPtr = Scan.NumFailed;
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBgzfOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Open a block-compressed Sdb file for random access.
+**
+** Description:
+**    The file is mapped and its blocks found, checking that each is a
+**    gzip member marked with its size, holding whole records, and that
+**    the file ends with an empty block. The first block is inflated, and
+**    must hold the header of a plain Sdb file. The file may lie within a
+**    larger one, such as a bundle, at an offset the mapping allows.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_READ_DATA_ERR if the file
+**       is not a complete block-compressed Sdb file, or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    FILE        *InFile    (in)
+**       The file, which must stay open until it is closed here.
+**    Uint32_t     Start     (in)
+**       Offset of the block-compressed file within it, a multiple of
+**       the page size.
+**    Uint32_t     Size      (in)
+**       Bytes of the block-compressed file, 0 for the rest of it.
+**    iStdBgzf_t **BgzfPtr   (out)
+**       The file opened, for iStdBgzfRead, or NULL after an error.
+**
+*****************************************************************************/
+Status_t iStdBgzfOpen( FILE *InFile, Uint32_t Start, Uint32_t Size, iStdBgzf_t **BgzfPtr )
+{
+   Status_t         Status;     /* Return value of function calls */
+   iStdBgzf_t      *NewPtr;     /* The file opened */
+   struct stat      Stat;       /* Size of the file */
+   void            *MapPtr;     /* Start of the mapping */
+   mStdBgzfBlock_t  Block;      /* Block found */
+   mStdBgzfBlock_t *MorePtr;    /* Blocks extended */
+   Uint32_t         MaxBlocks;  /* Blocks there is room for */
+   Uint32_t         Offset;     /* Offset of the next block */
+   Bool_t           Ended;      /* The empty block has been found */
+
+   *BgzfPtr = NULL;
+
+   if ( ( fstat( fileno( InFile ), &Stat ) != 0 ) ||
+        ( (double) Stat.st_size >= 4294967296.0 ) ||
+        ( (double) Start + Size > (double) Stat.st_size ) )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+   if ( Size == 0 )
+   {
+      Size = (Uint32_t) Stat.st_size - Start;
+   }
+   if ( Size < M_STD_BGZF_HDR + M_STD_BGZF_TRAILER )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   NewPtr = (iStdBgzf_t *) TTL_CALLOC( 1, sizeof( iStdBgzf_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   NewPtr->DataPtr = (unsigned char *) TTL_MALLOC( I_STD_BGZF_MAX_BLOCK );
+   if ( ( NewPtr->DataPtr == NULL ) ||
+        ( inflateInit2( &(NewPtr->Strm), -MAX_WBITS ) != Z_OK ) )
+   {
+      iStdBgzfClose( NewPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   NewPtr->StrmReady = TRUE;
+
+   MapPtr = mmap( NULL, (size_t) Size, PROT_READ, MAP_PRIVATE,
+                  fileno( InFile ), (off_t) Start );
+   if ( MapPtr == MAP_FAILED )
+   {
+      iStdBgzfClose( NewPtr );
+      return E_STD_READ_DATA_ERR;
+   }
+   NewPtr->MapPtr  = (unsigned char *) MapPtr;
+   NewPtr->MapSize = (size_t) Size;
+
+   /* The first block holds the header and time stamp */
+   Status = mStdBgzfBlockAt( NewPtr, 0, &Block );
+   if ( ( Status == SYS_NOMINAL ) && ( Block.DataSize != I_STD_RECORDS_START ) )
+   {
+      Status = E_STD_READ_DATA_ERR;
+   }
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdBgzfInflate( NewPtr, &Block );
+   }
+   if ( ( Status == SYS_NOMINAL ) &&
+        ( memcmp( NewPtr->DataPtr, E_SDB_HEADER_STRING, E_STD_FILE_HDR_SIZE ) != 0 ) )
+   {
+      Status = E_STD_READ_DATA_ERR;
+   }
+   if ( Status == SYS_NOMINAL )
+   {
+      memcpy( NewPtr->Header, NewPtr->DataPtr, I_STD_RECORDS_START );
+   }
+
+   MaxBlocks = 0;
+   Ended     = FALSE;
+   Offset    = Block.Size;
+   while ( ( Status == SYS_NOMINAL ) && ( Offset < NewPtr->MapSize ) )
+   {
+      Status = mStdBgzfBlockAt( NewPtr, Offset, &Block );
+      if ( Status != SYS_NOMINAL )
+      {
+         break;
+      }
+      Offset += Block.Size;
+
+      if ( Block.DataSize == 0 )
+      {
+         Ended = Offset == NewPtr->MapSize ? TRUE : FALSE;
+         continue;
+      }
+      if ( Block.DataSize % sizeof( eSdbRawFmt_t ) != 0 )
+      {
+         Status = E_STD_READ_DATA_ERR;
+         break;
+      }
+
+      if ( NewPtr->NumBlocks == MaxBlocks )
+      {
+         MaxBlocks = MaxBlocks == 0 ? 256 : MaxBlocks * 2;
+         MorePtr   = (mStdBgzfBlock_t *) TTL_REALLOC( NewPtr->Blocks,
+                                                      sizeof( mStdBgzfBlock_t ) * MaxBlocks );
+         if ( MorePtr == NULL )
+         {
+            Status = E_STD_MEM_ALLOC_ERR;
+            break;
+         }
+         NewPtr->Blocks = MorePtr;
+      }
+
+      Block.FirstRecord = NewPtr->NumRecords;
+      NewPtr->Blocks[ NewPtr->NumBlocks++ ] = Block;
+      NewPtr->NumRecords += Block.DataSize / sizeof( eSdbRawFmt_t );
+   }
+
+   if ( ( Status == SYS_NOMINAL ) && ( Ended == FALSE ) )
+   {
+      Status = E_STD_READ_DATA_ERR;
+   }
+
+   if ( Status != SYS_NOMINAL )
+   {
+      iStdBgzfClose( NewPtr );
+      return Status;
+   }
+
+   *BgzfPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBgzfInfo
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Describe a block-compressed Sdb file opened.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdBgzf_t *BgzfPtr         (in)
+**       The file.
+**    char       *HeaderPtr       (out)
+**       Its header and time stamp, I_STD_RECORDS_START bytes, unless NULL.
+**    Uint32_t   *NumBlocksPtr    (out)
+**       Number of blocks of records, unless NULL.
+**    Uint32_t   *NumRecordsPtr   (out)
+**       Number of records, unless NULL.
+**
+*****************************************************************************/
+void iStdBgzfInfo( iStdBgzf_t *BgzfPtr,
+                   char *HeaderPtr,
+                   Uint32_t *NumBlocksPtr,
+                   Uint32_t *NumRecordsPtr )
+{
+   if ( HeaderPtr != NULL )
+   {
+      memcpy( HeaderPtr, BgzfPtr->Header, I_STD_RECORDS_START );
+   }
+   if ( NumBlocksPtr != NULL )
+   {
+      *NumBlocksPtr = BgzfPtr->NumBlocks;
+   }
+   if ( NumRecordsPtr != NULL )
+   {
+      *NumRecordsPtr = BgzfPtr->NumRecords;
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBgzfRead
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find, and optionally inflate, the records of a block.
+**
+** Description:
+**    Without somewhere to return the records, only which records of the
+**    file the block holds is found, so a block not needed can be passed
+**    over without inflating it.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_EOF if there is no such
+**       block, or E_STD_READ_DATA_ERR if it fails its CRC.
+**
+** Arguments:
+**    iStdBgzf_t    *BgzfPtr        (in/out)
+**       The file.
+**    Uint32_t       Block          (in)
+**       Block of records, from 0.
+**    Uint32_t      *FirstPtr       (out)
+**       Record of the file starting the block.
+**    eSdbRawFmt_t **DataPtr        (out)
+**       Its records, valid until the next block is inflated, unless
+**       NULL. They may be changed.
+**    size_t        *NumRecordsPtr  (out)
+**       Number of its records.
+**
+*****************************************************************************/
+Status_t iStdBgzfRead( iStdBgzf_t *BgzfPtr,
+                       Uint32_t Block,
+                       Uint32_t *FirstPtr,
+                       eSdbRawFmt_t **DataPtr,
+                       size_t *NumRecordsPtr )
+{
+   Status_t         Status;     /* Return value of function calls */
+   mStdBgzfBlock_t *BlockPtr;   /* The block */
+
+   *NumRecordsPtr = 0;
+
+   if ( Block >= BgzfPtr->NumBlocks )
+   {
+      return E_STD_EOF;
+   }
+
+   BlockPtr  = BgzfPtr->Blocks + Block;
+   *FirstPtr = BlockPtr->FirstRecord;
+
+   if ( DataPtr != NULL )
+   {
+      Status = mStdBgzfInflate( BgzfPtr, BlockPtr );
+      if ( Status != SYS_NOMINAL )
+      {
+         return Status;
+      }
+      *DataPtr = (eSdbRawFmt_t *) BgzfPtr->DataPtr;
+   }
+
+   *NumRecordsPtr = BlockPtr->DataSize / sizeof( eSdbRawFmt_t );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBgzfClose
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Release a block-compressed Sdb file opened.
+**
+** Description:
+**    The file itself is left open.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdBgzf_t *BgzfPtr   (in)
+**       The file, or NULL.
+**
+*****************************************************************************/
+void iStdBgzfClose( iStdBgzf_t *BgzfPtr )
+{
+   if ( BgzfPtr == NULL )
+   {
+      return;
+   }
+
+   if ( BgzfPtr->MapPtr != NULL )
+   {
+      munmap( BgzfPtr->MapPtr, BgzfPtr->MapSize );
+   }
+   if ( BgzfPtr->StrmReady == TRUE )
+   {
+      inflateEnd( &(BgzfPtr->Strm) );
+   }
+   TTL_FREE( BgzfPtr->Blocks );
+   TTL_FREE( BgzfPtr->DataPtr );
+   TTL_FREE( BgzfPtr );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfWrite
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Compress and write a block of a block-compressed file.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_FILE_WRITE_ERR.
+**
+** Arguments:
+**    FILE          *OutFile   (in)
+**       File being written.
+**    z_stream      *StrmPtr   (in/out)
+**       Raw deflation, reset for each block.
+**    unsigned char *DataPtr   (in)
+**       Data of the block.
+**    Uint32_t       Size      (in)
+**       Bytes of data, at most I_STD_BGZF_RECORDS records.
+**    unsigned char *OutPtr    (out)
+**       Room for I_STD_BGZF_MAX_BLOCK bytes of the block compressed.
+**
+*****************************************************************************/
+static Status_t mStdBgzfWrite( FILE *OutFile,
+                               z_stream *StrmPtr,
+                               unsigned char *DataPtr,
+                               Uint32_t Size,
+                               unsigned char *OutPtr )
+{
+   Uint32_t BlockSize;   /* Bytes of the block compressed */
+
+   deflateReset( StrmPtr );
+   StrmPtr->next_in   = DataPtr;
+   StrmPtr->avail_in  = Size;
+   StrmPtr->next_out  = OutPtr + M_STD_BGZF_HDR;
+   StrmPtr->avail_out = I_STD_BGZF_MAX_BLOCK - M_STD_BGZF_HDR - M_STD_BGZF_TRAILER;
+
+   /* Records which will not compress still fit, as stored blocks */
+   if ( deflate( StrmPtr, Z_FINISH ) != Z_STREAM_END )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   BlockSize = M_STD_BGZF_HDR + (Uint32_t) StrmPtr->total_out + M_STD_BGZF_TRAILER;
+
+   memcpy( OutPtr, mStdBgzfHeader, sizeof( mStdBgzfHeader ) );
+   OutPtr[ M_STD_BGZF_HDR - 2 ] = (unsigned char) ( ( BlockSize - 1 ) & 0xff );
+   OutPtr[ M_STD_BGZF_HDR - 1 ] = (unsigned char) ( ( BlockSize - 1 ) >> 8 );
+   mStdPut32( OutPtr + BlockSize - M_STD_BGZF_TRAILER, (Uint32_t) crc32( 0L, DataPtr, Size ) );
+   mStdPut32( OutPtr + BlockSize - M_STD_BGZF_TRAILER + 4, Size );
+
+   if ( fwrite( OutPtr, 1, BlockSize, OutFile ) != BlockSize )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfVerify
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Check a block-compressed file holds the records of its original.
+**
+** Description:
+**    Every block is inflated, as a search would, and compared with the
+**    original read through zlib.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL if they match, E_STD_READ_DATA_ERR if not,
+**       E_STD_FILE_OPEN_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char     *SdbFilePtr    (in)
+**       Name of the original, plain or gzipped.
+**    char     *BgzfFilePtr   (in)
+**       Name of the block-compressed file.
+**    Uint32_t  NumRecords    (in)
+**       Number of records written to it.
+**
+*****************************************************************************/
+static Status_t mStdBgzfVerify( char *SdbFilePtr, char *BgzfFilePtr, Uint32_t NumRecords )
+{
+   Status_t       Status;                          /* Return value of function calls */
+   FILE          *InFile;                          /* The block-compressed file */
+   iStdBgzf_t    *BgzfPtr;                         /* It opened */
+   gzFile         OrigFile;                        /* The original */
+   unsigned char *OrigPtr;                         /* Records of the original */
+   eSdbRawFmt_t  *DataPtr;                         /* Records of a block */
+   char           Header[ I_STD_RECORDS_START ];   /* Header of the file */
+   Uint32_t       NumBlocks;                       /* Blocks of the file */
+   Uint32_t       Total;                           /* Records of the file */
+   Uint32_t       First;                           /* First record of a block */
+   size_t         Count;                           /* Records of a block */
+   Uint32_t       i;                               /* Block */
+
+   if ( ( InFile = fopen( BgzfFilePtr, "rb" ) ) == NULL )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+   Status = iStdBgzfOpen( InFile, 0, 0, &BgzfPtr );
+   if ( Status != SYS_NOMINAL )
+   {
+      fclose( InFile );
+      return Status;
+   }
+   if ( ( OrigFile = gzopen( SdbFilePtr, "rb" ) ) == NULL )
+   {
+      iStdBgzfClose( BgzfPtr );
+      fclose( InFile );
+      return E_STD_FILE_OPEN_ERR;
+   }
+   OrigPtr = (unsigned char *) TTL_MALLOC( I_STD_BGZF_MAX_BLOCK );
+
+   iStdBgzfInfo( BgzfPtr, Header, &NumBlocks, &Total );
+
+   Status = E_STD_READ_DATA_ERR;
+   if ( OrigPtr == NULL )
+   {
+      Status = E_STD_MEM_ALLOC_ERR;
+   }
+   else if ( ( Total == NumRecords ) &&
+             ( gzread( OrigFile, OrigPtr, I_STD_RECORDS_START ) == (int) I_STD_RECORDS_START ) &&
+             ( memcmp( OrigPtr, Header, I_STD_RECORDS_START ) == 0 ) )
+   {
+      Status = SYS_NOMINAL;
+   }
+
+   for ( i = 0; ( i < NumBlocks ) && ( Status == SYS_NOMINAL ); i++ )
+   {
+      Status = iStdBgzfRead( BgzfPtr, i, &First, &DataPtr, &Count );
+      if ( ( Status == SYS_NOMINAL ) &&
+           ( ( gzread( OrigFile, OrigPtr, Count * sizeof( eSdbRawFmt_t ) ) !=
+               (int) ( Count * sizeof( eSdbRawFmt_t ) ) ) ||
+             ( memcmp( OrigPtr, DataPtr, Count * sizeof( eSdbRawFmt_t ) ) != 0 ) ) )
+      {
+         Status = E_STD_READ_DATA_ERR;
+      }
+   }
+
+   TTL_FREE( OrigPtr );
+   gzclose( OrigFile );
+   iStdBgzfClose( BgzfPtr );
+   fclose( InFile );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfBlockAt
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the block starting at an offset of a block-compressed file.
+**
+** Description:
+**    The block must be a gzip member with only an extra field, holding
+**    a "BC" subfield of the block's size, which lies within the file.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_READ_DATA_ERR.
+**
+** Arguments:
+**    iStdBgzf_t      *BgzfPtr    (in)
+**       The file, mapped.
+**    Uint32_t         Offset     (in)
+**       Offset of the block.
+**    mStdBgzfBlock_t *BlockPtr   (out)
+**       The block found.
+**
+*****************************************************************************/
+static Status_t mStdBgzfBlockAt( iStdBgzf_t *BgzfPtr,
+                                 Uint32_t Offset,
+                                 mStdBgzfBlock_t *BlockPtr )
+{
+   unsigned char *BytePtr;     /* Start of the block */
+   size_t         Left;        /* Bytes of the file from the block */
+   Uint32_t       ExtraLen;    /* Bytes of the extra field */
+   Uint32_t       FieldLen;    /* Bytes of a subfield's data */
+   Uint32_t       Size;        /* Bytes of the block, 0 until found */
+   Uint32_t       i;           /* Offset of a subfield */
+
+   BytePtr = BgzfPtr->MapPtr + Offset;
+   Left    = BgzfPtr->MapSize - Offset;
+
+   if ( ( Left < M_STD_BGZF_HDR + M_STD_BGZF_TRAILER ) ||
+        ( memcmp( BytePtr, mStdBgzfHeader, 4 ) != 0 ) )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   ExtraLen = (Uint32_t) BytePtr[ 10 ] | ( (Uint32_t) BytePtr[ 11 ] << 8 );
+   if ( 12 + ExtraLen + M_STD_BGZF_TRAILER > Left )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   Size = 0;
+   for ( i = 12; i + 4 <= 12 + ExtraLen; i += 4 + FieldLen )
+   {
+      FieldLen = (Uint32_t) BytePtr[ i + 2 ] | ( (Uint32_t) BytePtr[ i + 3 ] << 8 );
+      if ( ( BytePtr[ i ] == 'B' ) && ( BytePtr[ i + 1 ] == 'C' ) && ( FieldLen == 2 ) &&
+           ( i + 6 <= 12 + ExtraLen ) )
+      {
+         Size = ( (Uint32_t) BytePtr[ i + 4 ] | ( (Uint32_t) BytePtr[ i + 5 ] << 8 ) ) + 1;
+      }
+   }
+
+   if ( ( Size < 12 + ExtraLen + M_STD_BGZF_TRAILER ) || ( Size > Left ) )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   BlockPtr->Offset      = Offset;
+   BlockPtr->Size        = Size;
+   BlockPtr->DataStart   = 12 + ExtraLen;
+   BlockPtr->DataSize    = mStdGet32( BytePtr + Size - 4 );
+   BlockPtr->FirstRecord = 0;
+
+   if ( BlockPtr->DataSize > I_STD_BGZF_MAX_BLOCK )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfInflate
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Inflate a block of a block-compressed file.
+**
+** Description:
+**    The data is checked against the size and CRC in the block's trailer.
+**    The trailer follows the deflate data, as the vendored zlib needs a
+**    byte beyond raw deflate data to finish it.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_READ_DATA_ERR.
+**
+** Arguments:
+**    iStdBgzf_t      *BgzfPtr    (in/out)
+**       The file, left holding the block's data.
+**    mStdBgzfBlock_t *BlockPtr   (in)
+**       The block.
+**
+*****************************************************************************/
+static Status_t mStdBgzfInflate( iStdBgzf_t *BgzfPtr, mStdBgzfBlock_t *BlockPtr )
+{
+   unsigned char *BytePtr;   /* Start of the block */
+
+   BytePtr = BgzfPtr->MapPtr + BlockPtr->Offset;
+
+   inflateReset( &(BgzfPtr->Strm) );
+   BgzfPtr->Strm.next_in   = BytePtr + BlockPtr->DataStart;
+   BgzfPtr->Strm.avail_in  = BlockPtr->Size - BlockPtr->DataStart;
+   BgzfPtr->Strm.next_out  = BgzfPtr->DataPtr;
+   BgzfPtr->Strm.avail_out = I_STD_BGZF_MAX_BLOCK;
+
+   if ( ( inflate( &(BgzfPtr->Strm), Z_FINISH ) != Z_STREAM_END ) ||
+        ( BgzfPtr->Strm.total_out != BlockPtr->DataSize ) ||
+        ( (Uint32_t) crc32( 0L, BgzfPtr->DataPtr, BlockPtr->DataSize ) !=
+          mStdGet32( BytePtr + BlockPtr->Size - M_STD_BGZF_TRAILER ) ) )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Form the name of the block-compressed file of an Sdb file.
+**
+** Description:
+**    Any .gz is replaced by I_STD_EXT_BGZF, otherwise it is appended.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    char *SdbFilePtr    (in)
+**       Name of the Sdb file, plain or gzipped.
+**    char *BgzfFilePtr   (out)
+**       Name of the block-compressed file.
+**
+*****************************************************************************/
+static void mStdBgzfName( char *SdbFilePtr, char *BgzfFilePtr )
+{
+   size_t Len;   /* Length of the name, less any .gz */
+
+   Len = strlen( SdbFilePtr );
+   if ( ( Len >= strlen( I_STD_EXT_GZIP ) ) &&
+        ( strcmp( SdbFilePtr + Len - strlen( I_STD_EXT_GZIP ), I_STD_EXT_GZIP ) == 0 ) )
+   {
+      Len -= strlen( I_STD_EXT_GZIP );
+   }
+
+   memcpy( BgzfFilePtr, SdbFilePtr, Len );
+   strcpy( BgzfFilePtr + Len, I_STD_EXT_BGZF );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfWalk
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the Sdb files in a directory of an archive and those below it.
+**
+** Description:
+**    Hidden files and directories are passed over, as are files which
+**    cannot be examined or have changed since the archive settled.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if the top
+**       directory cannot be read, or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdBgzfScan_t *ScanPtr   (in/out)
+**       Files found so far.
+**    char           *DirPtr    (in)
+**       Path of the directory.
+**    Int32_t         Depth     (in)
+**       Directories above it within the archive.
+**
+*****************************************************************************/
+static Status_t mStdBgzfWalk( mStdBgzfScan_t *ScanPtr, char *DirPtr, Int32_t Depth )
+{
+   Status_t       Status;                   /* Return value of function calls */
+   DIR           *Dir;                      /* The directory */
+   struct dirent *EntryPtr;                 /* Entry of the directory */
+   struct stat    Stat;                     /* What the entry is */
+   char           Path[ FILENAME_MAX ];     /* Path of the entry */
+
+   if ( ( Dir = opendir( DirPtr ) ) == NULL )
+   {
+      if ( Depth == 0 )
+      {
+         eLogErr(E_STD_FILE_OPEN_ERR,"Unable to search archive %s", DirPtr);
+         return E_STD_FILE_OPEN_ERR;
+      }
+      eLogWarning(E_STD_FILE_OPEN_ERR,"Unable to search directory %s", DirPtr);
+      return SYS_NOMINAL;
+   }
+
+   Status = SYS_NOMINAL;
+   while ( ( Status == SYS_NOMINAL ) && ( ( EntryPtr = readdir( Dir ) ) != NULL ) )
+   {
+      if ( ( EntryPtr->d_name[ 0 ] == '.' ) ||
+           ( strlen( DirPtr ) + strlen( EntryPtr->d_name ) + sizeof( I_STD_EXT_BGZF ) + 6
+             > sizeof( Path ) ) )
+      {
+         continue;
+      }
+      sprintf( Path, "%s%s%s", DirPtr,
+               DirPtr[ strlen( DirPtr ) - 1 ] == '/' ? "" : "/", EntryPtr->d_name );
+
+      if ( stat( Path, &Stat ) != 0 )
+      {
+         continue;
+      }
+
+      if ( S_ISDIR( Stat.st_mode ) )
+      {
+         if ( Depth < M_STD_MAX_DEPTH )
+         {
+            Status = mStdBgzfWalk( ScanPtr, Path, Depth + 1 );
+         }
+         continue;
+      }
+
+      if ( S_ISREG( Stat.st_mode ) &&
+           ( mStdBgzfIsSdb( EntryPtr->d_name ) == TRUE ) &&
+           ( (Int32_t) Stat.st_mtime <= ScanPtr->Settled ) )
+      {
+         Status = mStdBgzfAddName( &(ScanPtr->Files), &(ScanPtr->NumFiles),
+                                   &(ScanPtr->MaxFiles), Path );
+      }
+   }
+
+   closedir( Dir );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfIsSdb
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Decide whether a file is a plain or gzipped Sdb file.
+**
+** Description:
+**    The name must be "yymmddhh.sdb" or "yymmddhh.sdb.gz".
+**
+** Return type:
+**    Bool_t
+**       TRUE if it is.
+**
+** Arguments:
+**    char *NamePtr   (in)
+**       Name of the file, less any directory.
+**
+*****************************************************************************/
+static Bool_t mStdBgzfIsSdb( char *NamePtr )
+{
+   Int32_t i;   /* Character of the name */
+
+   for ( i = 0; i < M_STD_NAME_LEN; i++ )
+   {
+      if ( ( NamePtr[ i ] < '0' ) || ( NamePtr[ i ] > '9' ) )
+      {
+         return FALSE;
+      }
+   }
+
+   return ( strcmp( NamePtr + M_STD_NAME_LEN, "." I_STD_EXT_SDB ) == 0 ) ||
+          ( strcmp( NamePtr + M_STD_NAME_LEN, "." I_STD_EXT_SDB I_STD_EXT_GZIP ) == 0 )
+          ? TRUE : FALSE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfLoadDone
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the files a checkpoint notes were converted.
+**
+** Description:
+**    The checkpoint holds the name of a file converted on each line. It
+**    need not exist yet.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdBgzfScan_t *ScanPtr         (in/out)
+**       Left holding the files converted, sorted.
+**    char           *CheckpointPtr   (in)
+**       Name of the checkpoint.
+**
+*****************************************************************************/
+static Status_t mStdBgzfLoadDone( mStdBgzfScan_t *ScanPtr, char *CheckpointPtr )
+{
+   Status_t  Status;                  /* Return value of function calls */
+   FILE     *InFile;                  /* The checkpoint */
+   char      Line[ FILENAME_MAX ];    /* Line of the checkpoint */
+   size_t    Len;                     /* Length of the line */
+
+   if ( ( InFile = fopen( CheckpointPtr, "r" ) ) == NULL )
+   {
+      return SYS_NOMINAL;
+   }
+
+   Status = SYS_NOMINAL;
+   while ( ( Status == SYS_NOMINAL ) && ( fgets( Line, sizeof( Line ), InFile ) != NULL ) )
+   {
+      Len = strlen( Line );
+      while ( ( Len > 0 ) && ( ( Line[ Len - 1 ] == '\n' ) || ( Line[ Len - 1 ] == '\r' ) ) )
+      {
+         Line[ --Len ] = '\0';
+      }
+      if ( Len > 0 )
+      {
+         Status = mStdBgzfAddName( &(ScanPtr->Done), &(ScanPtr->NumDone),
+                                   &(ScanPtr->MaxDone), Line );
+      }
+   }
+
+   fclose( InFile );
+
+   qsort( ScanPtr->Done, ScanPtr->NumDone, sizeof( char * ), mStdCompareNames );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfAddName
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Add a copy of a name to a list.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char     ***NamesPtr   (in/out)
+**       The list.
+**    Uint32_t   *NumPtr     (in/out)
+**       Names in the list.
+**    Uint32_t   *MaxPtr     (in/out)
+**       Names there is room for.
+**    char       *NamePtr    (in)
+**       Name added.
+**
+*****************************************************************************/
+static Status_t mStdBgzfAddName( char ***NamesPtr,
+                                 Uint32_t *NumPtr,
+                                 Uint32_t *MaxPtr,
+                                 char *NamePtr )
+{
+   char **MorePtr;   /* List extended */
+
+   if ( *NumPtr == *MaxPtr )
+   {
+      MorePtr = (char **) TTL_REALLOC( *NamesPtr, sizeof( char * ) *
+                                       ( *MaxPtr + M_STD_MORE_NAMES ) );
+      if ( MorePtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      *NamesPtr = MorePtr;
+      *MaxPtr  += M_STD_MORE_NAMES;
+   }
+
+   (*NamesPtr)[ *NumPtr ] = (char *) TTL_MALLOC( strlen( NamePtr ) + 1 );
+   if ( (*NamesPtr)[ *NumPtr ] == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   strcpy( (*NamesPtr)[ *NumPtr ], NamePtr );
+   (*NumPtr)++;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfFreeNames
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Release a list of names.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    char     **Names      (in)
+**       The list, or NULL.
+**    Uint32_t   NumNames   (in)
+**       Names in the list.
+**
+*****************************************************************************/
+static void mStdBgzfFreeNames( char **Names, Uint32_t NumNames )
+{
+   Uint32_t i;   /* Name */
+
+   for ( i = 0; i < NumNames; i++ )
+   {
+      TTL_FREE( Names[ i ] );
+   }
+   TTL_FREE( Names );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfWorker
+**
+** Type:
+**    void *
+**
+** Purpose:
+**    Body of each thread converting files of an archive.
+**
+** Description:
+**    Repeatedly takes the next file still to be converted and converts
+**    it, noting it in the checkpoint if successful.
+**
+** Return type:
+**    void *
+**       Always NULL.
+**
+** Arguments:
+**    void *ArgPtr              (in/out)
+**       The mStdBgzfScan_t of files to be converted.
+**
+*****************************************************************************/
+static void *mStdBgzfWorker( void *ArgPtr )
+{
+   mStdBgzfScan_t *ScanPtr;      /* Files to be converted */
+   char           *FilePtr;      /* File being converted */
+   Status_t        Status;       /* Result of converting it */
+   Uint32_t        NumRecords;   /* Records converted */
+
+   ScanPtr = (mStdBgzfScan_t *) ArgPtr;
+
+   for ( ; ; )
+   {
+      pthread_mutex_lock( &(ScanPtr->Lock) );
+      FilePtr = NULL;
+      if ( ScanPtr->NextFile < ScanPtr->NumFiles )
+      {
+         FilePtr = ScanPtr->Files[ ScanPtr->NextFile++ ];
+      }
+      pthread_mutex_unlock( &(ScanPtr->Lock) );
+
+      if ( FilePtr == NULL )
+      {
+         break;
+      }
+
+      Status = eStdBgzfTranscode( FilePtr, ScanPtr->Replace, &NumRecords );
+
+      pthread_mutex_lock( &(ScanPtr->Lock) );
+      if ( Status == SYS_NOMINAL )
+      {
+         ScanPtr->NumConverted++;
+         if ( ScanPtr->Checkpoint != NULL )
+         {
+            fprintf( ScanPtr->Checkpoint, "%s\n", FilePtr );
+            fflush( ScanPtr->Checkpoint );
+         }
+      }
+      else
+      {
+         ScanPtr->NumFailed++;
+      }
+      pthread_mutex_unlock( &(ScanPtr->Lock) );
+   }
+
+   return NULL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdGet32
+**
+** Type:
+**    Uint32_t
+**
+** Purpose:
+**    Read a 32 bit number stored least significant byte first.
+**
+** Description:
+**
+** Return type:
+**    Uint32_t
+**       The number.
+**
+** Arguments:
+**    unsigned char *BytePtr   (in)
+**       Where it is stored.
+**
+*****************************************************************************/
+static Uint32_t mStdGet32( unsigned char *BytePtr )
+{
+   return (Uint32_t) BytePtr[ 0 ] | ( (Uint32_t) BytePtr[ 1 ] << 8 ) |
+          ( (Uint32_t) BytePtr[ 2 ] << 16 ) | ( (Uint32_t) BytePtr[ 3 ] << 24 );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdPut32
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Store a 32 bit number least significant byte first.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    unsigned char *BytePtr   (out)
+**       Where to store it.
+**    Uint32_t       Value     (in)
+**       The number.
+**
+*****************************************************************************/
+static void mStdPut32( unsigned char *BytePtr, Uint32_t Value )
+{
+   BytePtr[ 0 ] = (unsigned char) ( Value & 0xff );
+   BytePtr[ 1 ] = (unsigned char) ( ( Value >> 8 ) & 0xff );
+   BytePtr[ 2 ] = (unsigned char) ( ( Value >> 16 ) & 0xff );
+   BytePtr[ 3 ] = (unsigned char) ( Value >> 24 );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCompareNames
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order names for sorting and searching.
+**
+** Description:
+**
+** Return type:
+**    int
+**       Less than, equal to or greater than zero, as for strcmp.
+**
+** Arguments:
+**    const void *FirstPtr    (in)
+**    const void *SecondPtr   (in)
+**       Names compared.
+**
+*****************************************************************************/
+static int mStdCompareNames( const void *FirstPtr, const void *SecondPtr )
+{
+   return strcmp( *(char * const *) FirstPtr, *(char * const *) SecondPtr );
+}
+
+/* EOF */
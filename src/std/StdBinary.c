@@ -0,0 +1,656 @@
+/*****************************************************************************
+** Module Name:
+**     StdBinary.c
+**
+** Purpose:
+**     Binary output of Std, for programs taking its results by machine.
+**
+** Description:
+**     With the binary switch Std writes a header describing each column,
+**     followed by a fixed-size record per sample, in time order, giving
+**     its time in nanoseconds, the index of its column and its value.
+**     The layout is described with eStdBinary_t in Std.h. Numbers are
+**     always written little-endian, a byte at a time, so that a file is
+**     the same whatever the machine writing it, and a program on a
+**     little-endian machine may map the file and use the records in place.
+**
+**     The records are encoded here, for StdOutput.c, and the file read
+**     back by eStdBinaryOpen and eStdBinaryRead. The 64-bit times are
+**     worked out in 32-bit halves, as no 64-bit type is available to
+**     ANSI C.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_BIN_NSEC_HIGH  15258    /* Nanoseconds per second, upper 16 bits */
+#define M_STD_BIN_NSEC_LOW   51712    /* and lower 16 bits */
+
+/* Everything held of a binary output being read */
+struct eStdBinary_s
+{
+   FILE               *InFile;       /* The output */
+   Uint32_t            NumColumns;   /* Columns of the output */
+   eStdBinaryColumn_t *Columns;      /* Description of each */
+   unsigned char      *BufferPtr;    /* Records as read */
+   size_t              MaxRecords;   /* Records there is room for */
+};
+
+/* Local function prototypes */
+static void     mStdBinaryPut32 ( unsigned char *BufferPtr, Uint32_t Value );
+static void     mStdBinaryPutText ( unsigned char *BufferPtr, char *TextPtr, size_t Size );
+static Uint32_t mStdBinaryGet32 ( unsigned char *BufferPtr );
+static void     mStdBinaryPutTime ( unsigned char *BufferPtr, eTtlTime_t *TimePtr );
+static void     mStdBinaryGetTime ( unsigned char *BufferPtr, eTtlTime_t *TimePtr );
+
+/*****************************************************************************
+** Function Name:
+**    iStdBinaryHeader
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Encode the header of a binary output.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    unsigned char *BufferPtr    (out)
+**       E_STD_BIN_HEADER_SIZE bytes encoded.
+**    Uint32_t       NumColumns   (in)
+**       Columns described after the header.
+**
+*****************************************************************************/
+void iStdBinaryHeader ( unsigned char *BufferPtr, Uint32_t NumColumns )
+{
+   memcpy( BufferPtr, I_STD_BIN_MAGIC, 4 );
+   mStdBinaryPut32( BufferPtr + 4,  I_STD_BIN_VERSION );
+   mStdBinaryPut32( BufferPtr + 8,  NumColumns );
+   mStdBinaryPut32( BufferPtr + 12, E_STD_BIN_RECORD_SIZE );
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBinaryColumn
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Encode the description of a column of a binary output.
+**
+** Description:
+**    Names are nul padded to their full length, and truncated if need be
+**    to leave at least one nul.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    unsigned char      *BufferPtr    (out)
+**       E_STD_BIN_COLUMN_SIZE bytes encoded.
+**    eStdBinaryColumn_t *ColumnPtr    (in)
+**       The column.
+**
+*****************************************************************************/
+void iStdBinaryColumn ( unsigned char *BufferPtr, eStdBinaryColumn_t *ColumnPtr )
+{
+   memset( BufferPtr, 0, E_STD_BIN_COLUMN_SIZE );
+
+   mStdBinaryPut32( BufferPtr,     ColumnPtr->SourceId );
+   mStdBinaryPut32( BufferPtr + 4, ColumnPtr->DatumId );
+   BufferPtr += 8;
+
+   mStdBinaryPutText( BufferPtr, ColumnPtr->SourceName, E_STD_MAX_STRING_LEN );
+   BufferPtr += E_STD_MAX_STRING_LEN;
+   mStdBinaryPutText( BufferPtr, ColumnPtr->DatumName, E_STD_MAX_STRING_LEN );
+   BufferPtr += E_STD_MAX_STRING_LEN;
+   mStdBinaryPutText( BufferPtr, ColumnPtr->DatumUnits, E_STD_MAX_STRING_LEN );
+   BufferPtr += E_STD_MAX_STRING_LEN;
+   mStdBinaryPutText( BufferPtr, ColumnPtr->Summary, E_STD_BIN_SUMMARY_LEN );
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBinaryRecord
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Encode a record of a binary output.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    unsigned char *BufferPtr    (out)
+**       E_STD_BIN_RECORD_SIZE bytes encoded.
+**    eTtlTime_t    *TimePtr      (in)
+**       Time stamp of the sample.
+**    Uint32_t       Column       (in)
+**       Index of its column.
+**    Int32_t        Value        (in)
+**       Its value.
+**
+*****************************************************************************/
+void iStdBinaryRecord ( unsigned char *BufferPtr, eTtlTime_t *TimePtr,
+                        Uint32_t Column, Int32_t Value )
+{
+   mStdBinaryPutTime( BufferPtr, TimePtr );
+   mStdBinaryPut32( BufferPtr + 8,  Column );
+   mStdBinaryPut32( BufferPtr + 12, (Uint32_t) Value );
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdBinaryOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Start reading a binary output written by Std.
+**
+** Description:
+**    The header and the descriptions of the columns are read, and the
+**    file left open for its records to be read by eStdBinaryRead, until
+**    closed with eStdBinaryClose.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if the file
+**       could not be opened, E_STD_READ_HEAD_ERR if it is not a binary
+**       output, or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char          *FilePtr        (in)
+**       Name of the file.
+**    eStdBinary_t **BinaryPtr      (out)
+**       The output being read.
+**    Uint32_t      *NumColumnsPtr  (out)
+**       Number of its columns.
+**
+*****************************************************************************/
+Status_t eStdBinaryOpen( char *FilePtr,
+                         eStdBinary_t **BinaryPtr,
+                         Uint32_t *NumColumnsPtr )
+{
+   eStdBinary_t       *NewPtr;      /* Output being opened */
+   eStdBinaryColumn_t *ColumnPtr;   /* Column being read */
+   unsigned char       Header[ E_STD_BIN_HEADER_SIZE ];
+   unsigned char       Entry[ E_STD_BIN_COLUMN_SIZE ];
+   unsigned char      *EntryPtr;    /* Field of the column */
+   Uint32_t            i;           /* Column */
+
+   *BinaryPtr     = NULL;
+   *NumColumnsPtr = 0;
+
+   NewPtr = (eStdBinary_t *) TTL_CALLOC( 1, sizeof( eStdBinary_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if ( ( NewPtr->InFile = fopen( FilePtr, "rb" ) ) == NULL )
+   {
+      TTL_FREE( NewPtr );
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to open file %s", FilePtr);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   if ( ( fread( Header, sizeof( Header ), 1, NewPtr->InFile ) != 1 ) ||
+        ( memcmp( Header, I_STD_BIN_MAGIC, 4 ) != 0 ) ||
+        ( mStdBinaryGet32( Header + 4 ) != I_STD_BIN_VERSION ) ||
+        ( mStdBinaryGet32( Header + 12 ) != E_STD_BIN_RECORD_SIZE ) )
+   {
+      eStdBinaryClose( NewPtr );
+      eLogErr(E_STD_READ_HEAD_ERR,"File %s is not a binary output", FilePtr);
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   NewPtr->NumColumns = mStdBinaryGet32( Header + 8 );
+   NewPtr->Columns    = (eStdBinaryColumn_t *) TTL_CALLOC( NewPtr->NumColumns + 1,
+                                                  sizeof( eStdBinaryColumn_t ) );
+   if ( NewPtr->Columns == NULL )
+   {
+      eStdBinaryClose( NewPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   for ( i = 0; i < NewPtr->NumColumns; i++ )
+   {
+      if ( fread( Entry, sizeof( Entry ), 1, NewPtr->InFile ) != 1 )
+      {
+         eStdBinaryClose( NewPtr );
+         eLogErr(E_STD_READ_HEAD_ERR,"Unable to read columns of %s", FilePtr);
+         return E_STD_READ_HEAD_ERR;
+      }
+
+      /* The names were written with a nul at least at the end */
+      ColumnPtr = NewPtr->Columns + i;
+      ColumnPtr->SourceId = mStdBinaryGet32( Entry );
+      ColumnPtr->DatumId  = mStdBinaryGet32( Entry + 4 );
+      EntryPtr = Entry + 8;
+      memcpy( ColumnPtr->SourceName, EntryPtr, E_STD_MAX_STRING_LEN - 1 );
+      EntryPtr += E_STD_MAX_STRING_LEN;
+      memcpy( ColumnPtr->DatumName, EntryPtr, E_STD_MAX_STRING_LEN - 1 );
+      EntryPtr += E_STD_MAX_STRING_LEN;
+      memcpy( ColumnPtr->DatumUnits, EntryPtr, E_STD_MAX_STRING_LEN - 1 );
+      EntryPtr += E_STD_MAX_STRING_LEN;
+      memcpy( ColumnPtr->Summary, EntryPtr, E_STD_BIN_SUMMARY_LEN - 1 );
+   }
+
+   *BinaryPtr     = NewPtr;
+   *NumColumnsPtr = NewPtr->NumColumns;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdBinaryColumn
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the description of a column of a binary output.
+**
+** Description:
+**    The columns are numbered from 0, as in the records.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_EOF if there is no such
+**       column.
+**
+** Arguments:
+**    eStdBinary_t       *BinaryPtr    (in)
+**       The output being read.
+**    Uint32_t            Index        (in)
+**       Number of the column.
+**    eStdBinaryColumn_t *ColumnPtr    (out)
+**       Its description.
+**
+*****************************************************************************/
+Status_t eStdBinaryColumn( eStdBinary_t *BinaryPtr,
+                           Uint32_t Index,
+                           eStdBinaryColumn_t *ColumnPtr )
+{
+   if ( Index >= BinaryPtr->NumColumns )
+   {
+      return E_STD_EOF;
+   }
+
+   *ColumnPtr = BinaryPtr->Columns[ Index ];
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdBinaryRead
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the next records of a binary output.
+**
+** Description:
+**    Up to MaxRecords records are read and decoded, in the order they
+**    were written. None are read once the end of the output is reached.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_READ_DATA_ERR if the file
+**       could not be read or ends part way through a record, or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdBinary_t       *BinaryPtr    (in/out)
+**       The output being read.
+**    eStdBinaryRecord_t *RecordsPtr   (out)
+**       Records read.
+**    size_t              MaxRecords   (in)
+**       Records there is room for.
+**    size_t             *NumReadPtr   (out)
+**       Records read.
+**
+*****************************************************************************/
+Status_t eStdBinaryRead( eStdBinary_t *BinaryPtr,
+                         eStdBinaryRecord_t *RecordsPtr,
+                         size_t MaxRecords,
+                         size_t *NumReadPtr )
+{
+   unsigned char *NewBufferPtr;  /* Buffer once more room is made */
+   unsigned char *RecordPtr;     /* Record being decoded */
+   size_t         NumBytes;      /* Bytes read */
+   size_t         i;             /* Record */
+
+   *NumReadPtr = 0;
+
+   if ( MaxRecords > BinaryPtr->MaxRecords )
+   {
+      NewBufferPtr = (unsigned char *) TTL_REALLOC( BinaryPtr->BufferPtr,
+                                          MaxRecords * E_STD_BIN_RECORD_SIZE );
+      if ( NewBufferPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      BinaryPtr->BufferPtr  = NewBufferPtr;
+      BinaryPtr->MaxRecords = MaxRecords;
+   }
+
+   NumBytes = fread( BinaryPtr->BufferPtr, 1, MaxRecords * E_STD_BIN_RECORD_SIZE,
+                     BinaryPtr->InFile );
+   if ( ( ferror( BinaryPtr->InFile ) ) || ( NumBytes % E_STD_BIN_RECORD_SIZE != 0 ) )
+   {
+      eLogErr(E_STD_READ_DATA_ERR,"Unable to read records of binary output");
+      return E_STD_READ_DATA_ERR;
+   }
+
+   RecordPtr = BinaryPtr->BufferPtr;
+   for ( i = 0; i < NumBytes / E_STD_BIN_RECORD_SIZE; i++ )
+   {
+      mStdBinaryGetTime( RecordPtr, &(RecordsPtr[i].TimeStamp) );
+      RecordsPtr[i].Column = mStdBinaryGet32( RecordPtr + 8 );
+      RecordsPtr[i].Value  = (Int32_t) mStdBinaryGet32( RecordPtr + 12 );
+      RecordPtr += E_STD_BIN_RECORD_SIZE;
+   }
+
+   *NumReadPtr = NumBytes / E_STD_BIN_RECORD_SIZE;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdBinaryClose
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Finish reading a binary output.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdBinary_t *BinaryPtr     (in)
+**       The output being read, which may be NULL.
+**
+*****************************************************************************/
+Status_t eStdBinaryClose( eStdBinary_t *BinaryPtr )
+{
+   if ( BinaryPtr == NULL )
+   {
+      return SYS_NOMINAL;
+   }
+
+   if ( BinaryPtr->InFile != NULL )
+   {
+      fclose( BinaryPtr->InFile );
+   }
+   TTL_FREE( BinaryPtr->Columns );
+   TTL_FREE( BinaryPtr->BufferPtr );
+   TTL_FREE( BinaryPtr );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBinaryPutText
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Encode a string in a field of fixed size.
+**
+** Description:
+**    At most Size - 1 characters are kept, and the rest of the field is
+**    filled with nuls, so it is always terminated.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    unsigned char *BufferPtr    (out)
+**       Field encoded.
+**    char          *TextPtr      (in)
+**       String encoded.
+**    size_t         Size         (in)
+**       Bytes of the field.
+**
+*****************************************************************************/
+static void mStdBinaryPutText ( unsigned char *BufferPtr, char *TextPtr, size_t Size )
+{
+   size_t Length;   /* Characters kept */
+
+   Length = strlen( TextPtr );
+   if ( Length > Size - 1 )
+   {
+      Length = Size - 1;
+   }
+
+   memcpy( BufferPtr, TextPtr, Length );
+   memset( BufferPtr + Length, 0, Size - Length );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBinaryPut32
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Encode a 32-bit number little-endian.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    unsigned char *BufferPtr    (out)
+**       Four bytes encoded.
+**    Uint32_t       Value        (in)
+**       Number encoded.
+**
+*****************************************************************************/
+static void mStdBinaryPut32 ( unsigned char *BufferPtr, Uint32_t Value )
+{
+   BufferPtr[0] = (unsigned char) ( Value & 0xff );
+   BufferPtr[1] = (unsigned char) ( ( Value >> 8 ) & 0xff );
+   BufferPtr[2] = (unsigned char) ( ( Value >> 16 ) & 0xff );
+   BufferPtr[3] = (unsigned char) ( ( Value >> 24 ) & 0xff );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBinaryGet32
+**
+** Type:
+**    Uint32_t
+**
+** Purpose:
+**    Decode a little-endian 32-bit number.
+**
+** Description:
+**
+** Return type:
+**    Uint32_t
+**       The number.
+**
+** Arguments:
+**    unsigned char *BufferPtr    (in)
+**       Four bytes decoded.
+**
+*****************************************************************************/
+static Uint32_t mStdBinaryGet32 ( unsigned char *BufferPtr )
+{
+   return (Uint32_t) BufferPtr[0] |
+          ( (Uint32_t) BufferPtr[1] << 8 ) |
+          ( (Uint32_t) BufferPtr[2] << 16 ) |
+          ( (Uint32_t) BufferPtr[3] << 24 );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBinaryPutTime
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Encode a time stamp as 64-bit nanoseconds, little-endian.
+**
+** Description:
+**    The seconds are multiplied by 10^9 in 16-bit pieces, giving the
+**    upper and lower 32 bits of the product, which is negated for times
+**    before 1970 and then has the nanoseconds added.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    unsigned char *BufferPtr    (out)
+**       Eight bytes encoded.
+**    eTtlTime_t    *TimePtr      (in)
+**       Time stamp encoded.
+**
+*****************************************************************************/
+static void mStdBinaryPutTime ( unsigned char *BufferPtr, eTtlTime_t *TimePtr )
+{
+   Uint32_t Seconds;   /* Magnitude of the seconds */
+   Uint32_t Low;       /* Lower 32 bits of the nanoseconds */
+   Uint32_t High;      /* Upper 32 bits */
+   Uint32_t Middle;    /* Middle 32 bits of the product, as it is formed */
+   Uint32_t Product;   /* Product of one pair of 16-bit pieces */
+
+   Seconds = ( TimePtr->t_sec < 0 ) ? (Uint32_t) -TimePtr->t_sec
+                                    : (Uint32_t) TimePtr->t_sec;
+
+   Product = ( Seconds & 0xffff ) * M_STD_BIN_NSEC_LOW;
+   Low     = Product & 0xffff;
+   Middle  = Product >> 16;
+   Product = ( Seconds & 0xffff ) * M_STD_BIN_NSEC_HIGH;
+   Middle += Product & 0xffff;
+   High    = Product >> 16;
+   Product = ( Seconds >> 16 ) * M_STD_BIN_NSEC_LOW;
+   Middle += Product & 0xffff;
+   High   += Product >> 16;
+   High   += ( Seconds >> 16 ) * M_STD_BIN_NSEC_HIGH + ( Middle >> 16 );
+   Low    |= Middle << 16;
+
+   if ( TimePtr->t_sec < 0 )
+   {
+      Low  = ~Low + 1;
+      High = ~High + ( Low == 0 ? 1 : 0 );
+   }
+
+   Low += (Uint32_t) TimePtr->t_nsec;
+   if ( Low < (Uint32_t) TimePtr->t_nsec )
+   {
+      High++;
+   }
+
+   mStdBinaryPut32( BufferPtr,     Low );
+   mStdBinaryPut32( BufferPtr + 4, High );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBinaryGetTime
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Decode a time stamp from 64-bit nanoseconds, little-endian.
+**
+** Description:
+**    The magnitude of the nanoseconds is divided by 10^9 a bit at a
+**    time, the remainder always fitting 32 bits.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    unsigned char *BufferPtr    (in)
+**       Eight bytes decoded.
+**    eTtlTime_t    *TimePtr      (out)
+**       Time stamp decoded.
+**
+*****************************************************************************/
+static void mStdBinaryGetTime ( unsigned char *BufferPtr, eTtlTime_t *TimePtr )
+{
+   Uint32_t Low;        /* Lower 32 bits of the nanoseconds */
+   Uint32_t High;       /* Upper 32 bits */
+   Uint32_t Seconds;    /* Quotient */
+   Uint32_t Nanosecs;   /* Remainder */
+   Bool_t   Negative;   /* Time before 1970 */
+   int      Bit;        /* Bit being divided */
+
+   Low  = mStdBinaryGet32( BufferPtr );
+   High = mStdBinaryGet32( BufferPtr + 4 );
+
+   Negative = ( High & 0x80000000 ) ? TRUE : FALSE;
+   if ( Negative == TRUE )
+   {
+      Low  = ~Low + 1;
+      High = ~High + ( Low == 0 ? 1 : 0 );
+   }
+
+   Seconds  = 0;
+   Nanosecs = 0;
+   for ( Bit = 63; Bit >= 0; Bit-- )
+   {
+      Nanosecs = ( Nanosecs << 1 ) |
+                 ( ( ( Bit >= 32 ? High >> ( Bit - 32 ) : Low >> Bit ) ) & 1 );
+      Seconds <<= 1;
+      if ( Nanosecs >= E_TTL_NANOSECS_PER_SEC )
+      {
+         Nanosecs -= E_TTL_NANOSECS_PER_SEC;
+         Seconds  |= 1;
+      }
+   }
+
+   if ( ( Negative == TRUE ) && ( Nanosecs > 0 ) )
+   {
+      TimePtr->t_sec  = - (Int32_t) Seconds - 1;
+      TimePtr->t_nsec = E_TTL_NANOSECS_PER_SEC - Nanosecs;
+   }
+   else
+   {
+      TimePtr->t_sec  = ( Negative == TRUE ) ? - (Int32_t) Seconds : (Int32_t) Seconds;
+      TimePtr->t_nsec = Nanosecs;
+   }
+}
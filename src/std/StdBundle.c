@@ -0,0 +1,1427 @@
+/*****************************************************************************
+** Module Name:
+**     StdBundle.c
+**
+** Purpose:
+**     Bundles of the hourly Sdb files of a day or a month, so that a long
+**     search opens one file per day or month rather than one per hour.
+**
+** Description:
+**     A search opens the file of each hour in turn, trying the plain,
+**     block-compressed and gzipped names, and over NFS every name tried
+**     costs round trips, even for an hour with no file. A bundle,
+**     "yymmdd.sdbpack" for a day or "yymm.sdbpack" for a month, holds the
+**     files of its hours one after another, each starting at a multiple
+**     of I_STD_BUNDLE_ALIGN so it can be mapped in place, following a
+**     table of where the file of each hour lies. Plain and
+**     block-compressed files are held as they are. A gzipped file is
+**     held block-compressed, as it could not otherwise be read from
+**     within the bundle.
+**
+**     A bundle stands in for the files of all its hours: an hour the
+**     table shows has no file is not looked for. A reader looks for the
+**     bundle of the day of an hour, then that of its month, and only then
+**     for the hour's own file. Bundles are opened once and shared by
+**     every reader, and that a day has no bundle is remembered for
+**     I_STD_CAT_SETTLE seconds, so a search of an archive without bundles
+**     looks for two names a day.
+**
+**     A day or month is bundled from its hours' files, and a month also
+**     from the bundles of its days, once it ended I_STD_CAT_SETTLE seconds
+**     ago, see eStdBundleBuild. Each file is compared with the original
+**     before the bundle is put in place.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <time.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_BUNDLE_KEEP  16       /* Bundles kept open when not in use */
+#define M_STD_BUNDLE_COPY  65536    /* Bytes copied at once */
+#define M_STD_FROM_NONE    0        /* The hour has no file */
+#define M_STD_FROM_PLAIN   1        /* From the hour's plain file */
+#define M_STD_FROM_BGZF    2        /* From its block-compressed file */
+#define M_STD_FROM_GZIP    3        /* From its gzipped file, once converted */
+#define M_STD_FROM_DAY     4        /* From the bundle of its day */
+
+/* A bundle, or a name found to have none, shared by every reader */
+struct iStdBundle_s
+{
+   char                Name[ FILENAME_MAX ]; /* Path of the bundle */
+   FILE               *File;     /* The bundle, or NULL if there is none */
+   iStdBundleHeader_t  Header;   /* Its header */
+   iStdBundleSlot_t   *Slots;    /* Where the file of each hour lies */
+   Uint32_t            NumUsers; /* Readers using it */
+   Int32_t             Checked;  /* When it was looked for */
+   Uint32_t            LastUse;  /* When last used, for those kept */
+};
+
+/* Where the file of an hour being bundled comes from */
+typedef struct mStdBundleSource_s
+{
+   Uint32_t            From;     /* M_STD_FROM_NONE and so on */
+   iStdBundleSlot_t    Slot;     /* Where it lies in its file */
+} mStdBundleSource_t;
+
+/* Module scope variables, the bundles looked for by every reader */
+static iStdBundle_t    **mStdBundles    = NULL;
+static Uint32_t          mStdNumBundles = 0;
+static Uint32_t          mStdMaxBundles = 0;
+static Uint32_t          mStdBundleUses = 0;
+static pthread_mutex_t   mStdBundleLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Local function prototypes */
+static iStdBundle_t *mStdBundleFind ( char *NamePtr, Int32_t Now );
+static void     mStdBundleLoad ( iStdBundle_t *BundlePtr );
+static void     mStdBundleFree ( iStdBundle_t *BundlePtr );
+static Int32_t  mStdBundleSlotOf ( iStdBundleHeader_t *HeaderPtr, Uint32_t Date, Uint32_t Hour );
+static void     mStdBundleName ( char *PathPtr, iStdBundleHeader_t *HeaderPtr, Uint32_t Date, char *NamePtr );
+static void     mStdBundleHourName ( char *, iStdBundleHeader_t *, Uint32_t, char *, char * );
+static Status_t mStdBundleSource ( char *, iStdBundleHeader_t *, Uint32_t, iStdBundle_t *, mStdBundleSource_t * );
+static void     mStdBundleSourceName ( char *, iStdBundleHeader_t *, Uint32_t, mStdBundleSource_t *, char * );
+static Status_t mStdBundleWrite ( char *, char *, iStdBundleHeader_t *, mStdBundleSource_t *, iStdBundleSlot_t * );
+static Status_t mStdBundleVerify ( char *, char *, iStdBundleHeader_t *, mStdBundleSource_t *, iStdBundleSlot_t * );
+static Status_t mStdBundleCopy ( FILE *, FILE *, Uint32_t, Uint32_t, unsigned char * );
+static Status_t mStdBundleCompare ( FILE *, Uint32_t, FILE *, Uint32_t, Uint32_t, unsigned char *, unsigned char * );
+
+
+/*****************************************************************************
+** Function Name:
+**    eStdBundleBuild
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Bundle the Sdb files of a day or a month.
+**
+** Description:
+**    Finds the file of each hour as a search would, and for a month
+**    takes the bundle of any of its days in place of their hours' files.
+**    A gzipped file is converted to a block-compressed one beside it,
+**    see eStdBgzfTranscode, which is removed again once bundled. The
+**    bundle is written to a temporary file, and each hour's file read
+**    back and compared with the original, before it is put in place. A
+**    bundle already made is left as it is, as the files it was made from
+**    may since have been removed. Nothing is bundled until the day or
+**    month ended I_STD_CAT_SETTLE seconds ago, as its last file may be
+**    written until then. Block-structured files are only bundled plain.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_TIME_OUT_RANGE if the day or
+**       month has not ended, E_STD_READ_HEAD_ERR if a file could not be
+**       bundled, E_STD_READ_DATA_ERR if the bundle did not match the
+**       files, E_STD_FILE_WRITE_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char       *ArchivePtr    (in)
+**       Directory holding the Sdb files, as given to eStdReaderOpen,
+**       where the bundle is written.
+**    eTtlTime_t  Period        (in)
+**       Any time of the day or month.
+**    Bool_t      Month         (in)
+**       Set to bundle the month rather than the day.
+**    Bool_t      Replace       (in)
+**       Set to remove the files bundled once the bundle is in place.
+**    Uint32_t   *NumHoursPtr   (out)
+**       Number of hours bundled.
+**
+*****************************************************************************/
+Status_t eStdBundleBuild( char *ArchivePtr,
+                          eTtlTime_t Period,
+                          Bool_t Month,
+                          Bool_t Replace,
+                          Uint32_t *NumHoursPtr )
+{
+   Status_t            Status;                    /* Return value of function calls */
+   iStdBundleHeader_t  Header;                    /* Header of the bundle */
+   mStdBundleSource_t *SourcesPtr;                /* Where each hour comes from */
+   iStdBundleSlot_t   *SlotsPtr;                  /* Where each hour is put */
+   iStdBundle_t       *DayPtr;                    /* Bundle of a day of the month */
+   char                Bundle[ FILENAME_MAX ];    /* Name of the bundle */
+   char                TempFile[ FILENAME_MAX + 4 ];  /* Name while being written */
+   char                File[ FILENAME_MAX ];      /* Name of an hour's file */
+   struct tm           Tm;                        /* Period broken down */
+   struct stat         Stat;                      /* The bundle, if made */
+   time_t              Seconds;                   /* Time in seconds */
+   time_t              End;                       /* End of the period */
+   Uint32_t            Date;                      /* Day of the hour */
+   Uint32_t            Removed;                   /* Day whose bundle was removed */
+   Uint32_t            Found;                     /* Hours with a file */
+   Uint32_t            i;                         /* Hour of the bundle */
+
+   *NumHoursPtr = 0;
+
+   if ( strlen( ArchivePtr ) + 32 > FILENAME_MAX )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   Seconds = (time_t) Period.t_sec;
+   if ( localtime_r( &Seconds, &Tm ) == NULL )
+   {
+      return E_STD_GEN_ERROR;
+   }
+
+   memset( &Header, 0, sizeof( Header ) );
+   memcpy( Header.Magic, I_STD_BUNDLE_MAGIC, 4 );
+   Header.Version  = I_STD_BUNDLE_VERSION;
+   Header.Year     = (Uint32_t) ( Tm.tm_year % 100 );
+   Header.Month    = (Uint32_t) ( Tm.tm_mon + 1 );
+   Header.Date     = ( Month == TRUE ) ? 0 : (Uint32_t) Tm.tm_mday;
+   Header.NumHours = ( Month == TRUE ) ? I_STD_BUNDLE_MAX_HOURS : I_STD_BUNDLE_HOURS;
+
+   /* The period ends at the start of the next day or month */
+   Tm.tm_sec   = 0;
+   Tm.tm_min   = 0;
+   Tm.tm_hour  = 0;
+   Tm.tm_isdst = -1;
+   if ( Month == TRUE )
+   {
+      Tm.tm_mday = 1;
+      Tm.tm_mon++;
+   }
+   else
+   {
+      Tm.tm_mday++;
+   }
+   End = mktime( &Tm );
+
+   mStdBundleName( ArchivePtr, &Header, Header.Date, Bundle );
+   if ( ( End == (time_t) -1 ) || ( time( NULL ) < End + I_STD_CAT_SETTLE ) )
+   {
+      eLogErr(E_STD_TIME_OUT_RANGE,"Period of %s has not yet ended", Bundle);
+      return E_STD_TIME_OUT_RANGE;
+   }
+   if ( stat( Bundle, &Stat ) == 0 )
+   {
+      eLogNotice(0,"%s already made", Bundle);
+      return SYS_NOMINAL;
+   }
+
+   SourcesPtr = (mStdBundleSource_t *) TTL_CALLOC( Header.NumHours, sizeof( mStdBundleSource_t ) );
+   SlotsPtr   = (iStdBundleSlot_t *) TTL_CALLOC( Header.NumHours, sizeof( iStdBundleSlot_t ) );
+   DayPtr     = (iStdBundle_t *) TTL_CALLOC( 1, sizeof( iStdBundle_t ) );
+   if ( ( SourcesPtr == NULL ) || ( SlotsPtr == NULL ) || ( DayPtr == NULL ) )
+   {
+      TTL_FREE( SourcesPtr );
+      TTL_FREE( SlotsPtr );
+      TTL_FREE( DayPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   /* Find the file of each hour, loading the bundle of each day in turn */
+   Status = SYS_NOMINAL;
+   for ( i = 0; ( i < Header.NumHours ) && ( Status == SYS_NOMINAL ); i++ )
+   {
+      if ( ( Month == TRUE ) && ( i % I_STD_BUNDLE_HOURS == 0 ) )
+      {
+         mStdBundleFree( DayPtr );
+         memset( DayPtr, 0, sizeof( iStdBundle_t ) );
+         mStdBundleName( ArchivePtr, &Header, i / I_STD_BUNDLE_HOURS + 1, DayPtr->Name );
+         mStdBundleLoad( DayPtr );
+      }
+      Status = mStdBundleSource( ArchivePtr, &Header, i,
+                                 ( Month == TRUE ) ? DayPtr : NULL, SourcesPtr + i );
+   }
+   mStdBundleFree( DayPtr );
+   TTL_FREE( DayPtr );
+
+   /* A period with no files is left unbundled, in case any arrive late */
+   Found = 0;
+   for ( i = 0; i < Header.NumHours; i++ )
+   {
+      Found += ( SourcesPtr[ i ].From != M_STD_FROM_NONE ) ? 1 : 0;
+   }
+   if ( ( Status == SYS_NOMINAL ) && ( Found == 0 ) )
+   {
+      eLogNotice(0,"No files to bundle in %s", Bundle);
+      TTL_FREE( SourcesPtr );
+      TTL_FREE( SlotsPtr );
+      return SYS_NOMINAL;
+   }
+
+   sprintf( TempFile, "%s.tmp", Bundle );
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdBundleWrite( ArchivePtr, TempFile, &Header, SourcesPtr, SlotsPtr );
+   }
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdBundleVerify( ArchivePtr, TempFile, &Header, SourcesPtr, SlotsPtr );
+      if ( Status != SYS_NOMINAL )
+      {
+         eLogErr(Status,"%s does not match the files bundled", TempFile);
+      }
+   }
+   if ( ( Status == SYS_NOMINAL ) && ( rename( TempFile, Bundle ) != 0 ) )
+   {
+      Status = E_STD_FILE_WRITE_ERR;
+   }
+   if ( Status != SYS_NOMINAL )
+   {
+      remove( TempFile );
+   }
+
+   /* Remove the conversions of gzipped files, and the originals if asked */
+   Removed = 0;
+   for ( i = 0; i < Header.NumHours; i++ )
+   {
+      if ( SourcesPtr[ i ].From == M_STD_FROM_NONE )
+      {
+         continue;
+      }
+      if ( SourcesPtr[ i ].From == M_STD_FROM_GZIP )
+      {
+         mStdBundleHourName( ArchivePtr, &Header, i, I_STD_EXT_BGZF, File );
+         remove( File );
+      }
+      if ( Status == SYS_NOMINAL )
+      {
+         (*NumHoursPtr)++;
+
+         /* The bundle of a day is removed once, with its first hour */
+         Date = i / I_STD_BUNDLE_HOURS + 1;
+         if ( ( Replace == TRUE ) &&
+              ( ( SourcesPtr[ i ].From != M_STD_FROM_DAY ) || ( Date != Removed ) ) )
+         {
+            Removed = ( SourcesPtr[ i ].From == M_STD_FROM_DAY ) ? Date : Removed;
+            mStdBundleSourceName( ArchivePtr, &Header, i, SourcesPtr + i, File );
+            if ( remove( File ) != 0 )
+            {
+               eLogWarning(E_STD_FILE_WRITE_ERR,"Unable to remove %s", File);
+            }
+         }
+      }
+   }
+
+   TTL_FREE( SourcesPtr );
+   TTL_FREE( SlotsPtr );
+
+   if ( Status == SYS_NOMINAL )
+   {
+      eLogNotice(0,"Bundled %u hours in %s", *NumHoursPtr, Bundle);
+   }
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBundleOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the bundle holding an hour, if any.
+**
+** Description:
+**    The bundle of the hour's day is used if there is one, else that of
+**    its month. Bundles are looked for once and kept open for every
+**    reader, as is that there is no bundle, for I_STD_CAT_SETTLE
+**    seconds. A bundle which is not valid is warned of and treated as
+**    if there were none.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_FILE_OPEN_ERR if there is
+**       no bundle holding the hour.
+**
+** Arguments:
+**    char          *PathPtr     (in)
+**       Directory holding the Sdb files.
+**    eStdTime_t    *TimePtr     (in)
+**       The hour.
+**    iStdBundle_t **BundlePtr   (out)
+**       The bundle, until released with iStdBundleClose, or NULL.
+**
+*****************************************************************************/
+Status_t iStdBundleOpen( char *PathPtr, eStdTime_t *TimePtr, iStdBundle_t **BundlePtr )
+{
+   iStdBundleHeader_t  Period;                 /* Year and month of the hour */
+   iStdBundle_t       *FoundPtr;               /* Bundle looked for */
+   char                Name[ FILENAME_MAX ];   /* Its name */
+   Int32_t             Now;                    /* Time it is looked for */
+   int                 i;                      /* Day, then month */
+
+   *BundlePtr = NULL;
+
+   if ( strlen( PathPtr ) + 32 > FILENAME_MAX )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   Period.Year  = TimePtr->Year;
+   Period.Month = TimePtr->Month;
+   Now          = (Int32_t) time( NULL );
+
+   pthread_mutex_lock( &mStdBundleLock );
+
+   for ( i = 0; i < 2; i++ )
+   {
+      mStdBundleName( PathPtr, &Period, ( i == 0 ) ? TimePtr->Date : 0, Name );
+      FoundPtr = mStdBundleFind( Name, Now );
+      if ( ( FoundPtr != NULL ) && ( FoundPtr->File != NULL ) )
+      {
+         FoundPtr->NumUsers++;
+         *BundlePtr = FoundPtr;
+         break;
+      }
+   }
+
+   pthread_mutex_unlock( &mStdBundleLock );
+
+   return ( *BundlePtr != NULL ) ? SYS_NOMINAL : E_STD_FILE_OPEN_ERR;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBundleCovers
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Find whether a bundle stands in for the files of an hour.
+**
+** Description:
+**
+** Return type:
+**    Bool_t
+**       TRUE if the hour is of the bundle's day or month.
+**
+** Arguments:
+**    iStdBundle_t *BundlePtr   (in)
+**       The bundle.
+**    eStdTime_t   *TimePtr     (in)
+**       The hour.
+**
+*****************************************************************************/
+Bool_t iStdBundleCovers( iStdBundle_t *BundlePtr, eStdTime_t *TimePtr )
+{
+   return ( BundlePtr->Header.Year == TimePtr->Year ) &&
+          ( BundlePtr->Header.Month == TimePtr->Month ) &&
+          ( ( BundlePtr->Header.Date == 0 ) ||
+            ( BundlePtr->Header.Date == TimePtr->Date ) ) ? TRUE : FALSE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBundleHour
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Open the Sdb file of an hour held in a bundle.
+**
+** Description:
+**    The stream returned shares the bundle's open file, so no name is
+**    looked up, and may be closed as if it were the hour's own file. The
+**    hour's file lies within it where the slot shows.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_EOF if the bundle holds no
+**       file of the hour, or E_STD_FILE_OPEN_ERR.
+**
+** Arguments:
+**    iStdBundle_t     *BundlePtr   (in)
+**       Bundle covering the hour.
+**    eStdTime_t       *TimePtr     (in)
+**       The hour.
+**    FILE            **InFilePtr   (out)
+**       Stream of the bundle, unless NULL.
+**    iStdBundleSlot_t *SlotPtr     (out)
+**       Where the hour's file lies in it.
+**    char             *NamePtr     (out)
+**       Name of the hour's file, for messages, FILENAME_MAX characters,
+**       unless NULL.
+**
+*****************************************************************************/
+Status_t iStdBundleHour( iStdBundle_t *BundlePtr,
+                         eStdTime_t *TimePtr,
+                         FILE **InFilePtr,
+                         iStdBundleSlot_t *SlotPtr,
+                         char *NamePtr )
+{
+   Int32_t Slot;   /* Slot of the hour */
+   int     Fd;     /* Descriptor of the stream */
+
+   Slot = mStdBundleSlotOf( &(BundlePtr->Header), TimePtr->Date, TimePtr->Hour );
+   if ( ( Slot < 0 ) || ( BundlePtr->Slots[ Slot ].Offset == 0 ) )
+   {
+      return E_STD_EOF;
+   }
+
+   *SlotPtr = BundlePtr->Slots[ Slot ];
+
+   if ( NamePtr != NULL )
+   {
+      sprintf( NamePtr, "%.*s:%.2u%.2u%.2u%.2u", FILENAME_MAX - 16, BundlePtr->Name,
+               TimePtr->Year, TimePtr->Month, TimePtr->Date, TimePtr->Hour );
+   }
+
+   if ( InFilePtr != NULL )
+   {
+      if ( ( Fd = dup( fileno( BundlePtr->File ) ) ) < 0 )
+      {
+         return E_STD_FILE_OPEN_ERR;
+      }
+      if ( ( *InFilePtr = fdopen( Fd, "rb" ) ) == NULL )
+      {
+         close( Fd );
+         return E_STD_FILE_OPEN_ERR;
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBundleAdvise
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Start reading the file of an hour held in a bundle.
+**
+** Description:
+**    Advises the kernel that the hour's file will be needed soon. Nothing
+**    is done if the bundle holds no file of the hour.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdBundle_t *BundlePtr   (in)
+**       Bundle covering the hour.
+**    eStdTime_t   *TimePtr     (in)
+**       The hour.
+**
+*****************************************************************************/
+void iStdBundleAdvise( iStdBundle_t *BundlePtr, eStdTime_t *TimePtr )
+{
+   iStdBundleSlot_t Slot;   /* Where the hour's file lies */
+
+   if ( iStdBundleHour( BundlePtr, TimePtr, NULL, &Slot, NULL ) == SYS_NOMINAL )
+   {
+      posix_fadvise( fileno( BundlePtr->File ), (off_t) Slot.Offset, (off_t) Slot.Size,
+                     POSIX_FADV_WILLNEED );
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdBundleClose
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Release a bundle found by iStdBundleOpen.
+**
+** Description:
+**    The bundle is kept open for the next reader to need it, until
+**    M_STD_BUNDLE_KEEP others have been used since.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdBundle_t *BundlePtr   (in)
+**       The bundle, or NULL.
+**
+*****************************************************************************/
+void iStdBundleClose( iStdBundle_t *BundlePtr )
+{
+   if ( BundlePtr == NULL )
+   {
+      return;
+   }
+
+   pthread_mutex_lock( &mStdBundleLock );
+   BundlePtr->NumUsers--;
+   pthread_mutex_unlock( &mStdBundleLock );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleFind
+**
+** Type:
+**    iStdBundle_t *
+**
+** Purpose:
+**    Find a bundle by name, looking for it if not already known.
+**
+** Description:
+**    A name found to have no bundle is looked for again once
+**    I_STD_CAT_SETTLE seconds have passed. Once M_STD_BUNDLE_KEEP bundles
+**    are known, the one least recently used and not in use is forgotten
+**    to make room. Must be called holding mStdBundleLock.
+**
+** Return type:
+**    iStdBundle_t *
+**       The bundle, with a NULL file if there is none, or NULL if there
+**       is no memory to look for it.
+**
+** Arguments:
+**    char    *NamePtr   (in)
+**       Path of the bundle.
+**    Int32_t  Now       (in)
+**       Time it is looked for.
+**
+*****************************************************************************/
+static iStdBundle_t *mStdBundleFind( char *NamePtr, Int32_t Now )
+{
+   iStdBundle_t  *FoundPtr;   /* The bundle */
+   iStdBundle_t **MorePtr;    /* Bundles extended */
+   Uint32_t       Oldest;     /* Bundle least recently used */
+   Uint32_t       i;          /* Bundle known */
+
+   FoundPtr = NULL;
+   for ( i = 0; i < mStdNumBundles; i++ )
+   {
+      if ( strcmp( mStdBundles[ i ]->Name, NamePtr ) == 0 )
+      {
+         FoundPtr = mStdBundles[ i ];
+         break;
+      }
+   }
+
+   if ( ( FoundPtr != NULL ) && ( FoundPtr->File == NULL ) &&
+        ( Now - FoundPtr->Checked >= I_STD_CAT_SETTLE ) )
+   {
+      mStdBundleLoad( FoundPtr );
+      FoundPtr->Checked = Now;
+   }
+
+   if ( FoundPtr == NULL )
+   {
+      /* Forget the bundle least recently used, if not in use */
+      Oldest = mStdNumBundles;
+      for ( i = 0; ( mStdNumBundles >= M_STD_BUNDLE_KEEP ) && ( i < mStdNumBundles ); i++ )
+      {
+         if ( ( mStdBundles[ i ]->NumUsers == 0 ) &&
+              ( ( Oldest == mStdNumBundles ) ||
+                ( mStdBundles[ i ]->LastUse < mStdBundles[ Oldest ]->LastUse ) ) )
+         {
+            Oldest = i;
+         }
+      }
+      if ( Oldest < mStdNumBundles )
+      {
+         mStdBundleFree( mStdBundles[ Oldest ] );
+         TTL_FREE( mStdBundles[ Oldest ] );
+         mStdBundles[ Oldest ] = mStdBundles[ --mStdNumBundles ];
+      }
+
+      if ( mStdNumBundles == mStdMaxBundles )
+      {
+         MorePtr = (iStdBundle_t **) TTL_REALLOC( mStdBundles, sizeof( iStdBundle_t * ) *
+                                                  ( mStdMaxBundles + M_STD_BUNDLE_KEEP ) );
+         if ( MorePtr == NULL )
+         {
+            return NULL;
+         }
+         mStdBundles     = MorePtr;
+         mStdMaxBundles += M_STD_BUNDLE_KEEP;
+      }
+
+      FoundPtr = (iStdBundle_t *) TTL_CALLOC( 1, sizeof( iStdBundle_t ) );
+      if ( FoundPtr == NULL )
+      {
+         return NULL;
+      }
+      strcpy( FoundPtr->Name, NamePtr );
+      mStdBundleLoad( FoundPtr );
+      FoundPtr->Checked = Now;
+      mStdBundles[ mStdNumBundles++ ] = FoundPtr;
+   }
+
+   FoundPtr->LastUse = ++mStdBundleUses;
+
+   return FoundPtr;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleLoad
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Open a bundle and read its table of hours.
+**
+** Description:
+**    The bundle must be of the current version, and each hour's file must
+**    lie within it at a multiple of I_STD_BUNDLE_ALIGN. A bundle which is
+**    not is warned of and left closed.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdBundle_t *BundlePtr   (in/out)
+**       Bundle named, left with a NULL file if there is none.
+**
+*****************************************************************************/
+static void mStdBundleLoad( iStdBundle_t *BundlePtr )
+{
+   struct stat Stat;   /* Size of the bundle */
+   Uint32_t    i;      /* Hour of the bundle */
+   Bool_t      Valid;  /* The bundle is as expected */
+
+   if ( ( BundlePtr->File = fopen( BundlePtr->Name, "rb" ) ) == NULL )
+   {
+      return;
+   }
+
+   Valid = ( fstat( fileno( BundlePtr->File ), &Stat ) == 0 ) &&
+           ( fread( &(BundlePtr->Header), sizeof( iStdBundleHeader_t ), 1, BundlePtr->File ) == 1 ) &&
+           ( memcmp( BundlePtr->Header.Magic, I_STD_BUNDLE_MAGIC, 4 ) == 0 ) &&
+           ( BundlePtr->Header.Version == I_STD_BUNDLE_VERSION ) &&
+           ( BundlePtr->Header.NumHours ==
+             ( BundlePtr->Header.Date == 0 ? I_STD_BUNDLE_MAX_HOURS : I_STD_BUNDLE_HOURS ) );
+
+   if ( Valid == TRUE )
+   {
+      BundlePtr->Slots = (iStdBundleSlot_t *) TTL_MALLOC( sizeof( iStdBundleSlot_t ) *
+                                                         BundlePtr->Header.NumHours );
+      Valid = ( BundlePtr->Slots != NULL ) &&
+              ( fread( BundlePtr->Slots, sizeof( iStdBundleSlot_t ), BundlePtr->Header.NumHours,
+                       BundlePtr->File ) == BundlePtr->Header.NumHours );
+   }
+
+   for ( i = 0; ( Valid == TRUE ) && ( i < BundlePtr->Header.NumHours ); i++ )
+   {
+      if ( ( BundlePtr->Slots[ i ].Offset != 0 ) &&
+           ( ( BundlePtr->Slots[ i ].Offset % I_STD_BUNDLE_ALIGN != 0 ) ||
+             ( (double) BundlePtr->Slots[ i ].Offset + BundlePtr->Slots[ i ].Size >
+               (double) Stat.st_size ) ||
+             ( ( BundlePtr->Slots[ i ].Kind != I_STD_BUNDLE_PLAIN ) &&
+               ( BundlePtr->Slots[ i ].Kind != I_STD_BUNDLE_BGZF ) ) ) )
+      {
+         Valid = FALSE;
+      }
+   }
+
+   if ( Valid == FALSE )
+   {
+      eLogWarning(E_STD_READ_DATA_ERR,"Ignoring invalid bundle %s", BundlePtr->Name);
+      mStdBundleFree( BundlePtr );
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleFree
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Close a bundle.
+**
+** Description:
+**    The bundle's name is kept.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdBundle_t *BundlePtr   (in/out)
+**       The bundle.
+**
+*****************************************************************************/
+static void mStdBundleFree( iStdBundle_t *BundlePtr )
+{
+   if ( BundlePtr->File != NULL )
+   {
+      fclose( BundlePtr->File );
+      BundlePtr->File = NULL;
+   }
+   TTL_FREE( BundlePtr->Slots );
+   BundlePtr->Slots = NULL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleSlotOf
+**
+** Type:
+**    Int32_t
+**
+** Purpose:
+**    Find the slot of a bundle for an hour.
+**
+** Description:
+**    The hours of a month's bundle are those of each date in turn.
+**
+** Return type:
+**    Int32_t
+**       The slot, or -1 if the hour is not of the bundle.
+**
+** Arguments:
+**    iStdBundleHeader_t *HeaderPtr   (in)
+**       Header of the bundle.
+**    Uint32_t            Date        (in)
+**       Day of the month of the hour.
+**    Uint32_t            Hour        (in)
+**       Hour of the day.
+**
+*****************************************************************************/
+static Int32_t mStdBundleSlotOf( iStdBundleHeader_t *HeaderPtr, Uint32_t Date, Uint32_t Hour )
+{
+   Uint32_t Slot;   /* The slot */
+
+   if ( ( Date < 1 ) || ( Date > E_STD_DAYS_IN_MONTH ) || ( Hour >= I_STD_BUNDLE_HOURS ) )
+   {
+      return -1;
+   }
+
+   Slot = ( HeaderPtr->Date == 0 ) ? ( Date - 1 ) * I_STD_BUNDLE_HOURS + Hour : Hour;
+
+   return ( Slot < HeaderPtr->NumHours ) ? (Int32_t) Slot : -1;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Generate the name of the bundle of a day or month.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    char               *PathPtr     (in)
+**       Directory holding the Sdb files.
+**    iStdBundleHeader_t *HeaderPtr   (in)
+**       Year and month of the bundle.
+**    Uint32_t            Date        (in)
+**       Day of the month, or 0 for the month's bundle.
+**    char               *NamePtr     (out)
+**       Path of the bundle, FILENAME_MAX characters.
+**
+*****************************************************************************/
+static void mStdBundleName( char *PathPtr, iStdBundleHeader_t *HeaderPtr,
+                            Uint32_t Date, char *NamePtr )
+{
+   if ( Date == 0 )
+   {
+      sprintf( NamePtr, "%s%.2u%.2u.%s", PathPtr,
+               HeaderPtr->Year, HeaderPtr->Month, I_STD_EXT_BUNDLE );
+   }
+   else
+   {
+      sprintf( NamePtr, "%s%.2u%.2u%.2u.%s", PathPtr,
+               HeaderPtr->Year, HeaderPtr->Month, Date, I_STD_EXT_BUNDLE );
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleHourName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Generate the name of the Sdb file of an hour of a bundle.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    char               *PathPtr     (in)
+**       Directory holding the Sdb files.
+**    iStdBundleHeader_t *HeaderPtr   (in)
+**       Header of the bundle.
+**    Uint32_t            Slot        (in)
+**       Slot of the hour.
+**    char               *ExtPtr      (in)
+**       Extension following ".sdb", such as I_STD_EXT_GZIP, or "".
+**    char               *NamePtr     (out)
+**       Path of the file, FILENAME_MAX characters.
+**
+*****************************************************************************/
+static void mStdBundleHourName( char *PathPtr, iStdBundleHeader_t *HeaderPtr,
+                                Uint32_t Slot, char *ExtPtr, char *NamePtr )
+{
+   Uint32_t Date;   /* Day of the month of the hour */
+
+   Date = ( HeaderPtr->Date != 0 ) ? HeaderPtr->Date : Slot / I_STD_BUNDLE_HOURS + 1;
+
+   sprintf( NamePtr, "%s%.2u%.2u%.2u%.2u.%s%s", PathPtr, HeaderPtr->Year, HeaderPtr->Month,
+            Date, Slot % I_STD_BUNDLE_HOURS, I_STD_EXT_SDB, ExtPtr );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleSource
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the Sdb file of an hour being bundled.
+**
+** Description:
+**    The bundle of the hour's day is used if there is one, otherwise the
+**    hour's plain file, block-compressed file or, converted to a
+**    block-compressed one, its gzipped file, in the order a search
+**    would use them.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL, whether or not the hour has a file, or
+**       E_STD_READ_HEAD_ERR if its file could not be bundled.
+**
+** Arguments:
+**    char               *PathPtr     (in)
+**       Directory holding the Sdb files.
+**    iStdBundleHeader_t *HeaderPtr   (in)
+**       Header of the bundle being made.
+**    Uint32_t            Slot        (in)
+**       Slot of the hour.
+**    iStdBundle_t       *DayPtr      (in)
+**       Bundle of the hour's day, with a NULL file if there is none, or
+**       NULL when bundling a day.
+**    mStdBundleSource_t *SourcePtr   (out)
+**       Where the hour's file comes from.
+**
+*****************************************************************************/
+static Status_t mStdBundleSource( char *PathPtr,
+                                  iStdBundleHeader_t *HeaderPtr,
+                                  Uint32_t Slot,
+                                  iStdBundle_t *DayPtr,
+                                  mStdBundleSource_t *SourcePtr )
+{
+   Status_t     Status;                 /* Return value of function calls */
+   char         File[ FILENAME_MAX ];   /* Name of the hour's file */
+   char         Magic[ E_STD_FILE_HDR_SIZE ]; /* Start of a plain file */
+   FILE        *InFile;                 /* The hour's file */
+   iStdBgzf_t  *BgzfPtr;                /* It opened, if block-compressed */
+   struct stat  Stat;                   /* Its size */
+   Uint32_t     NumRecords;             /* Records converted */
+
+   memset( SourcePtr, 0, sizeof( mStdBundleSource_t ) );
+
+   if ( ( DayPtr != NULL ) && ( DayPtr->File != NULL ) )
+   {
+      if ( DayPtr->Slots[ Slot % I_STD_BUNDLE_HOURS ].Offset != 0 )
+      {
+         SourcePtr->From = M_STD_FROM_DAY;
+         SourcePtr->Slot = DayPtr->Slots[ Slot % I_STD_BUNDLE_HOURS ];
+      }
+      return SYS_NOMINAL;
+   }
+
+   mStdBundleHourName( PathPtr, HeaderPtr, Slot, "", File );
+   if ( ( InFile = fopen( File, "rb" ) ) != NULL )
+   {
+      Status = E_STD_READ_HEAD_ERR;
+      if ( ( fstat( fileno( InFile ), &Stat ) == 0 ) &&
+           ( (double) Stat.st_size < 4294967296.0 - I_STD_BUNDLE_ALIGN ) &&
+           ( fread( Magic, sizeof( Magic ), 1, InFile ) == 1 ) &&
+           ( ( memcmp( Magic, E_SDB_HEADER_STRING, E_STD_FILE_HDR_SIZE ) == 0 ) ||
+             ( memcmp( Magic, E_SDB_HEADER_STRING_V2, E_STD_FILE_HDR_SIZE ) == 0 ) ) )
+      {
+         SourcePtr->From      = M_STD_FROM_PLAIN;
+         SourcePtr->Slot.Kind = I_STD_BUNDLE_PLAIN;
+         SourcePtr->Slot.Size = (Uint32_t) Stat.st_size;
+         Status = SYS_NOMINAL;
+      }
+      fclose( InFile );
+      if ( Status != SYS_NOMINAL )
+      {
+         eLogErr(Status,"Unable to bundle %s", File);
+      }
+      return Status;
+   }
+
+   /* A gzipped file is read through its conversion */
+   SourcePtr->From = M_STD_FROM_BGZF;
+   mStdBundleHourName( PathPtr, HeaderPtr, Slot, I_STD_EXT_BGZF, File );
+   if ( ( InFile = fopen( File, "rb" ) ) == NULL )
+   {
+      mStdBundleHourName( PathPtr, HeaderPtr, Slot, I_STD_EXT_GZIP, File );
+      if ( ( InFile = fopen( File, "rb" ) ) == NULL )
+      {
+         SourcePtr->From = M_STD_FROM_NONE;
+         return SYS_NOMINAL;
+      }
+      fclose( InFile );
+
+      Status = eStdBgzfTranscode( File, FALSE, &NumRecords );
+      if ( Status != SYS_NOMINAL )
+      {
+         eLogErr(E_STD_READ_HEAD_ERR,"Unable to bundle %s", File);
+         SourcePtr->From = M_STD_FROM_NONE;
+         return E_STD_READ_HEAD_ERR;
+      }
+      SourcePtr->From = M_STD_FROM_GZIP;
+      mStdBundleHourName( PathPtr, HeaderPtr, Slot, I_STD_EXT_BGZF, File );
+      if ( ( InFile = fopen( File, "rb" ) ) == NULL )
+      {
+         return E_STD_READ_HEAD_ERR;
+      }
+   }
+
+   Status = E_STD_READ_HEAD_ERR;
+   if ( ( fstat( fileno( InFile ), &Stat ) == 0 ) &&
+        ( (double) Stat.st_size < 4294967296.0 - I_STD_BUNDLE_ALIGN ) &&
+        ( iStdBgzfOpen( InFile, 0, 0, &BgzfPtr ) == SYS_NOMINAL ) )
+   {
+      iStdBgzfClose( BgzfPtr );
+      SourcePtr->Slot.Kind = I_STD_BUNDLE_BGZF;
+      SourcePtr->Slot.Size = (Uint32_t) Stat.st_size;
+      Status = SYS_NOMINAL;
+   }
+   fclose( InFile );
+   if ( Status != SYS_NOMINAL )
+   {
+      eLogErr(Status,"Unable to bundle %s", File);
+   }
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleSourceName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Generate the name of the file an hour being bundled comes from.
+**
+** Description:
+**    That of a gzipped file is the original, not its conversion.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    char               *PathPtr     (in)
+**       Directory holding the Sdb files.
+**    iStdBundleHeader_t *HeaderPtr   (in)
+**       Header of the bundle being made.
+**    Uint32_t            Slot        (in)
+**       Slot of the hour.
+**    mStdBundleSource_t *SourcePtr   (in)
+**       Where the hour's file comes from, which must be somewhere.
+**    char               *NamePtr     (out)
+**       Path of the file, FILENAME_MAX characters.
+**
+*****************************************************************************/
+static void mStdBundleSourceName( char *PathPtr, iStdBundleHeader_t *HeaderPtr,
+                                  Uint32_t Slot, mStdBundleSource_t *SourcePtr,
+                                  char *NamePtr )
+{
+   switch ( SourcePtr->From )
+   {
+      case M_STD_FROM_DAY:
+         mStdBundleName( PathPtr, HeaderPtr, Slot / I_STD_BUNDLE_HOURS + 1, NamePtr );
+         break;
+      case M_STD_FROM_GZIP:
+         mStdBundleHourName( PathPtr, HeaderPtr, Slot, I_STD_EXT_GZIP, NamePtr );
+         break;
+      case M_STD_FROM_BGZF:
+         mStdBundleHourName( PathPtr, HeaderPtr, Slot, I_STD_EXT_BGZF, NamePtr );
+         break;
+      default:
+         mStdBundleHourName( PathPtr, HeaderPtr, Slot, "", NamePtr );
+         break;
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleWrite
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write a bundle.
+**
+** Description:
+**    The header and table are written first and again once the files
+**    are in place. Each file follows the last, padded to start at a
+**    multiple of I_STD_BUNDLE_ALIGN.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_WRITE_ERR if the
+**       bundle could not be written or would exceed 4 GB,
+**       E_STD_READ_DATA_ERR if a file could not be read, or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char               *PathPtr      (in)
+**       Directory holding the Sdb files.
+**    char               *FilePtr      (in)
+**       File to write the bundle to.
+**    iStdBundleHeader_t *HeaderPtr    (in)
+**       Header of the bundle.
+**    mStdBundleSource_t *SourcesPtr   (in)
+**       Where the file of each hour comes from.
+**    iStdBundleSlot_t   *SlotsPtr     (out)
+**       Where the file of each hour is put.
+**
+*****************************************************************************/
+static Status_t mStdBundleWrite( char *PathPtr,
+                                 char *FilePtr,
+                                 iStdBundleHeader_t *HeaderPtr,
+                                 mStdBundleSource_t *SourcesPtr,
+                                 iStdBundleSlot_t *SlotsPtr )
+{
+   Status_t       Status;                  /* Return value of function calls */
+   FILE          *OutFile;                 /* The bundle */
+   FILE          *InFile;                  /* File of an hour */
+   char           File[ FILENAME_MAX ];    /* Its name */
+   unsigned char *BufferPtr;               /* Data being copied */
+   double         Offset;                  /* Where the next file starts */
+   Uint32_t       Written;                 /* Bytes written so far */
+   Uint32_t       Pad;                     /* Bytes of padding */
+   Uint32_t       i;                       /* Hour of the bundle */
+
+   if ( ( OutFile = fopen( FilePtr, "wb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to write %s", FilePtr);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   BufferPtr = (unsigned char *) TTL_CALLOC( 1, M_STD_BUNDLE_COPY );
+   if ( BufferPtr == NULL )
+   {
+      fclose( OutFile );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   Written = sizeof( iStdBundleHeader_t ) + sizeof( iStdBundleSlot_t ) * HeaderPtr->NumHours;
+   Status  = ( ( fwrite( HeaderPtr, sizeof( iStdBundleHeader_t ), 1, OutFile ) == 1 ) &&
+               ( fwrite( SlotsPtr, sizeof( iStdBundleSlot_t ), HeaderPtr->NumHours, OutFile )
+                 == HeaderPtr->NumHours ) ) ? SYS_NOMINAL : E_STD_FILE_WRITE_ERR;
+
+   for ( i = 0; ( i < HeaderPtr->NumHours ) && ( Status == SYS_NOMINAL ); i++ )
+   {
+      if ( SourcesPtr[ i ].From == M_STD_FROM_NONE )
+      {
+         continue;
+      }
+
+      Offset = (double) Written + ( I_STD_BUNDLE_ALIGN - Written % I_STD_BUNDLE_ALIGN )
+                                  % I_STD_BUNDLE_ALIGN;
+      if ( Offset + SourcesPtr[ i ].Slot.Size >= 4294967296.0 )
+      {
+         eLogErr(E_STD_FILE_WRITE_ERR,"%s would exceed 4 GB, bundle by day", FilePtr);
+         Status = E_STD_FILE_WRITE_ERR;
+         break;
+      }
+
+      /* Pad to the start of the file, then copy it */
+      memset( BufferPtr, 0, M_STD_BUNDLE_COPY );
+      Pad = (Uint32_t) Offset - Written;
+      if ( ( Pad > 0 ) && ( fwrite( BufferPtr, 1, Pad, OutFile ) != Pad ) )
+      {
+         Status = E_STD_FILE_WRITE_ERR;
+         break;
+      }
+      Written = (Uint32_t) Offset;
+
+      SlotsPtr[ i ]        = SourcesPtr[ i ].Slot;
+      SlotsPtr[ i ].Offset = Written;
+
+      mStdBundleSourceName( PathPtr, HeaderPtr, i, SourcesPtr + i, File );
+      if ( SourcesPtr[ i ].From == M_STD_FROM_GZIP )
+      {
+         mStdBundleHourName( PathPtr, HeaderPtr, i, I_STD_EXT_BGZF, File );
+      }
+      if ( ( InFile = fopen( File, "rb" ) ) == NULL )
+      {
+         eLogErr(E_STD_READ_DATA_ERR,"Unable to open file %s", File);
+         Status = E_STD_READ_DATA_ERR;
+         break;
+      }
+      Status = mStdBundleCopy( OutFile, InFile, SourcesPtr[ i ].Slot.Offset,
+                               SourcesPtr[ i ].Slot.Size, BufferPtr );
+      fclose( InFile );
+      Written += SourcesPtr[ i ].Slot.Size;
+   }
+
+   if ( ( Status == SYS_NOMINAL ) &&
+        ( ( fseek( OutFile, 0L, SEEK_SET ) != 0 ) ||
+          ( fwrite( HeaderPtr, sizeof( iStdBundleHeader_t ), 1, OutFile ) != 1 ) ||
+          ( fwrite( SlotsPtr, sizeof( iStdBundleSlot_t ), HeaderPtr->NumHours, OutFile )
+            != HeaderPtr->NumHours ) ) )
+   {
+      Status = E_STD_FILE_WRITE_ERR;
+   }
+
+   TTL_FREE( BufferPtr );
+   if ( ( fclose( OutFile ) != 0 ) && ( Status == SYS_NOMINAL ) )
+   {
+      Status = E_STD_FILE_WRITE_ERR;
+   }
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleVerify
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Check a bundle against the files it was made from.
+**
+** Description:
+**    The bundle is opened as a search would open it, and the file of
+**    each hour read back from it and compared with the original, byte
+**    for byte.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL if they match, E_STD_READ_DATA_ERR if not,
+**       or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char               *PathPtr      (in)
+**       Directory holding the Sdb files.
+**    char               *FilePtr      (in)
+**       The bundle.
+**    iStdBundleHeader_t *HeaderPtr    (in)
+**       Header written.
+**    mStdBundleSource_t *SourcesPtr   (in)
+**       Where the file of each hour came from.
+**    iStdBundleSlot_t   *SlotsPtr     (in)
+**       Where the file of each hour was put.
+**
+*****************************************************************************/
+static Status_t mStdBundleVerify( char *PathPtr,
+                                  char *FilePtr,
+                                  iStdBundleHeader_t *HeaderPtr,
+                                  mStdBundleSource_t *SourcesPtr,
+                                  iStdBundleSlot_t *SlotsPtr )
+{
+   Status_t       Status;                  /* Return value of function calls */
+   iStdBundle_t  *BundlePtr;               /* The bundle */
+   FILE          *InFile;                  /* File of an hour */
+   char           File[ FILENAME_MAX ];    /* Its name */
+   unsigned char *BufferPtr;               /* Data of the bundle */
+   unsigned char *OrigPtr;                 /* Data of the file */
+   Uint32_t       i;                       /* Hour of the bundle */
+
+   BundlePtr = (iStdBundle_t *) TTL_CALLOC( 1, sizeof( iStdBundle_t ) );
+   BufferPtr = (unsigned char *) TTL_MALLOC( M_STD_BUNDLE_COPY );
+   OrigPtr   = (unsigned char *) TTL_MALLOC( M_STD_BUNDLE_COPY );
+   if ( ( BundlePtr == NULL ) || ( BufferPtr == NULL ) || ( OrigPtr == NULL ) )
+   {
+      TTL_FREE( BundlePtr );
+      TTL_FREE( BufferPtr );
+      TTL_FREE( OrigPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   strcpy( BundlePtr->Name, FilePtr );
+   mStdBundleLoad( BundlePtr );
+
+   Status = ( ( BundlePtr->File != NULL ) &&
+              ( memcmp( &(BundlePtr->Header), HeaderPtr, sizeof( iStdBundleHeader_t ) ) == 0 ) &&
+              ( memcmp( BundlePtr->Slots, SlotsPtr,
+                        sizeof( iStdBundleSlot_t ) * HeaderPtr->NumHours ) == 0 ) )
+            ? SYS_NOMINAL : E_STD_READ_DATA_ERR;
+
+   for ( i = 0; ( i < HeaderPtr->NumHours ) && ( Status == SYS_NOMINAL ); i++ )
+   {
+      if ( SourcesPtr[ i ].From == M_STD_FROM_NONE )
+      {
+         continue;
+      }
+
+      mStdBundleSourceName( PathPtr, HeaderPtr, i, SourcesPtr + i, File );
+      if ( SourcesPtr[ i ].From == M_STD_FROM_GZIP )
+      {
+         mStdBundleHourName( PathPtr, HeaderPtr, i, I_STD_EXT_BGZF, File );
+      }
+      if ( ( InFile = fopen( File, "rb" ) ) == NULL )
+      {
+         Status = E_STD_READ_DATA_ERR;
+         break;
+      }
+
+      Status = mStdBundleCompare( InFile, SourcesPtr[ i ].Slot.Offset, BundlePtr->File,
+                                  SlotsPtr[ i ].Offset, SlotsPtr[ i ].Size, OrigPtr, BufferPtr );
+      fclose( InFile );
+   }
+
+   mStdBundleFree( BundlePtr );
+   TTL_FREE( BundlePtr );
+   TTL_FREE( BufferPtr );
+   TTL_FREE( OrigPtr );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleCopy
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Copy part of a file to the end of another.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_READ_DATA_ERR if the part
+**       could not be read, or E_STD_FILE_WRITE_ERR.
+**
+** Arguments:
+**    FILE          *OutFile     (in)
+**       File written to.
+**    FILE          *InFile      (in)
+**       File holding the part.
+**    Uint32_t       Offset      (in)
+**       Offset of the part.
+**    Uint32_t       Size        (in)
+**       Bytes of the part.
+**    unsigned char *BufferPtr   (in)
+**       M_STD_BUNDLE_COPY bytes to copy through.
+**
+*****************************************************************************/
+static Status_t mStdBundleCopy( FILE *OutFile,
+                                FILE *InFile,
+                                Uint32_t Offset,
+                                Uint32_t Size,
+                                unsigned char *BufferPtr )
+{
+   size_t Count;   /* Bytes copied at once */
+
+   if ( fseek( InFile, (long) Offset, SEEK_SET ) != 0 )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   while ( Size > 0 )
+   {
+      Count = ( Size < M_STD_BUNDLE_COPY ) ? Size : M_STD_BUNDLE_COPY;
+      if ( fread( BufferPtr, 1, Count, InFile ) != Count )
+      {
+         return E_STD_READ_DATA_ERR;
+      }
+      if ( fwrite( BufferPtr, 1, Count, OutFile ) != Count )
+      {
+         return E_STD_FILE_WRITE_ERR;
+      }
+      Size -= (Uint32_t) Count;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBundleCompare
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Compare parts of two files, byte for byte.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL if they match, or E_STD_READ_DATA_ERR if not
+**       or if either could not be read.
+**
+** Arguments:
+**    FILE          *FileA       (in)
+**       First file.
+**    Uint32_t       OffsetA     (in)
+**       Offset of its part.
+**    FILE          *FileB       (in)
+**       Second file.
+**    Uint32_t       OffsetB     (in)
+**       Offset of its part.
+**    Uint32_t       Size        (in)
+**       Bytes of each part.
+**    unsigned char *BufferAPtr  (in)
+**       M_STD_BUNDLE_COPY bytes to read the first into.
+**    unsigned char *BufferBPtr  (in)
+**       M_STD_BUNDLE_COPY bytes to read the second into.
+**
+*****************************************************************************/
+static Status_t mStdBundleCompare( FILE *FileA,
+                                   Uint32_t OffsetA,
+                                   FILE *FileB,
+                                   Uint32_t OffsetB,
+                                   Uint32_t Size,
+                                   unsigned char *BufferAPtr,
+                                   unsigned char *BufferBPtr )
+{
+   size_t Count;   /* Bytes compared at once */
+
+   if ( ( fseek( FileA, (long) OffsetA, SEEK_SET ) != 0 ) ||
+        ( fseek( FileB, (long) OffsetB, SEEK_SET ) != 0 ) )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   while ( Size > 0 )
+   {
+      Count = ( Size < M_STD_BUNDLE_COPY ) ? Size : M_STD_BUNDLE_COPY;
+      if ( ( fread( BufferAPtr, 1, Count, FileA ) != Count ) ||
+           ( fread( BufferBPtr, 1, Count, FileB ) != Count ) ||
+           ( memcmp( BufferAPtr, BufferBPtr, Count ) != 0 ) )
+      {
+         return E_STD_READ_DATA_ERR;
+      }
+      Size -= (Uint32_t) Count;
+   }
+
+   return SYS_NOMINAL;
+}
@@ -0,0 +1,2486 @@
+/*****************************************************************************
+** Module Name:
+**     StdCatalog.c
+**
+** Purpose:
+**     Catalog of the storage codes found in each hour of an Sdb archive, so
+**     that a search need not open the files of hours holding none of the
+**     source/datum pairs it wants.
+**
+** Description:
+**     The catalog lists every hour of the archive with an Sdb file, plain,
+**     gzipped or block-compressed, anywhere below the archive's directory,
+**     with the file's name and the number of its records. For each storage
+**     code found it keeps the number of its records, the first and last
+**     hours holding it, and the set of hours holding it. The hours are numbered from
+**     the epoch and split into spans of I_STD_CAT_SPAN hours. Within each
+**     span the hours holding a code are kept as a sorted list or, once
+**     there are too many for a list to be smaller, as a bitmap.
+**
+**     The archive is searched for files, and those not yet catalogued are
+**     read, by several threads at once. Updating the catalog later only
+**     reads the hours added since, and the records added to any file
+**     which has grown. Sdb files are only ever added to, so the codes of
+**     an hour already catalogued remain. An hour is only relied on once
+**     it ended I_STD_CAT_SETTLE seconds before the archive was searched,
+**     as its file may still be being written until then; later hours are
+**     searched as if there were no catalog. So are hours whose file was
+**     still changing, or could not be read, when last catalogued. Hours
+**     held only in a bundle, see StdBundle.c, are not catalogued, so
+**     an archive should be catalogued before its files are bundled.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <zlib.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_HASH_MULT  0x9E3779B1U  /* Multiplier for Fibonacci hashing */
+#define M_STD_CAT_CHUNK  4096         /* Records read at once */
+#define M_STD_MIN_SLOTS  256          /* Codes of an hour allowed for initially */
+#define M_STD_MAX_NAME   256          /* Longest name of a file in the archive */
+#define M_STD_MAX_DEPTH  8            /* Deepest directory searched */
+#define M_STD_BITMAP_WORDS ( I_STD_CAT_SPAN / 32 ) /* Words of a set's bitmap */
+#define M_STD_NAME_LEN   8            /* Digits of "yymmddhh" */
+
+/* A storage code of the catalog, with its sets of hours */
+typedef struct mStdCatCode_s
+{
+   iStdCatCode_t  Entry;       /* Entry written to the catalog */
+   iStdCatSet_t  *Sets;        /* Sets of hours, in order of key */
+   Uint32_t       MaxSets;     /* Sets there is room for */
+} mStdCatCode_t;
+
+/* An hour of the catalog */
+typedef struct mStdCatHour_s
+{
+   iStdCatHour_t  Entry;       /* Entry written to the catalog */
+   Bool_t         Updated;     /* Added to or grown by the last update */
+} mStdCatHour_t;
+
+/* Everything held of a catalog */
+struct eStdCatalog_s
+{
+   iStdCatHeader_t Header;     /* Counts kept up to date with those below */
+   mStdCatHour_t  *Hours;      /* Hours catalogued, in order */
+   Uint32_t        MaxHours;   /* Hours there is room for */
+   char           *Names;      /* Archive, then names of the hours' files */
+   Uint32_t        MaxNames;   /* Bytes of names there is room for */
+   mStdCatCode_t  *Codes;      /* Storage codes found, in order */
+   Uint32_t        MaxCodes;   /* Codes there is room for */
+   Int32_t        *Partial;    /* Hours only partly catalogued, in order */
+   Uint32_t        NumPartial; /* Number of those hours */
+   pthread_mutex_t Lock;       /* Guards the codes while hours are added */
+};
+
+/* An Sdb file found in the archive */
+typedef struct mStdCatFile_s
+{
+   Int32_t        Hour;        /* Hours since the epoch */
+   Bool_t         Gzipped;     /* Named .sdb.gz or .sdb.bgz */
+   char           Name[ M_STD_MAX_NAME ]; /* Name within the archive */
+   Uint32_t       FileSize;    /* Size of the file */
+   Int32_t        FileTime;    /* Modification time of the file */
+   Uint32_t       From;        /* Bytes of records already catalogued */
+   Uint32_t       DataSize;    /* Bytes of records to catalogue up to */
+   Status_t       Status;      /* Outcome of reading it */
+} mStdCatFile_t;
+
+/* Files found in the archive, and those being read */
+typedef struct mStdCatScan_s
+{
+   eStdCatalog_t  *CatalogPtr; /* Catalog being updated */
+   mStdCatFile_t  *Files;      /* Files found */
+   Uint32_t        NumFiles;   /* Number of files found */
+   Uint32_t        MaxFiles;   /* Files there is room for */
+   Uint32_t        NextFile;   /* Next file to be given to a worker */
+   pthread_mutex_t Lock;       /* Guards NextFile */
+} mStdCatScan_t;
+
+/* Records of each code found in an hour, hashed on the storage code */
+typedef struct mStdCatCount_s
+{
+   Uint32_t        Size;       /* Number of slots, a power of two */
+   Uint32_t        Shift;      /* Bits discarded from hash to index a slot */
+   Uint32_t        NumUsed;    /* Number of slots in use */
+   eSdbCode_t     *Codes;      /* Storage code held in each slot */
+   Uint32_t       *Counts;     /* Records of it, zero if the slot is unused */
+} mStdCatCount_t;
+
+/* Local function prototypes */
+static Status_t mStdCatNew ( eStdCatalog_t **CatalogPtr );
+static Status_t mStdCatLoad ( eStdCatalog_t *CatalogPtr, char *CatalogFilePtr );
+static Status_t mStdCatSave ( eStdCatalog_t *CatalogPtr, char *CatalogFilePtr );
+static Status_t mStdCatFindPartial ( eStdCatalog_t *CatalogPtr );
+static Status_t mStdCatAddName ( eStdCatalog_t *CatalogPtr, char *NamePtr, Uint32_t *OffsetPtr );
+static Status_t mStdCatWalk ( mStdCatScan_t *ScanPtr, char *DirPtr, char *RelPtr, Int32_t Depth );
+static Status_t mStdCatPlan ( mStdCatScan_t *ScanPtr, Int32_t Updated );
+static Uint32_t mStdCatDataSize ( char *FilePtr, Bool_t Gzipped, Uint32_t FileSize );
+static void    *mStdCatWorker ( void *ArgPtr );
+static Status_t mStdCatScanFile ( eStdCatalog_t *, mStdCatFile_t *, mStdCatCount_t * );
+static Status_t mStdCatCountRecords ( mStdCatCount_t *, eSdbRawFmt_t *, Uint32_t );
+static Status_t mStdCatMerge ( eStdCatalog_t *, mStdCatFile_t *, mStdCatCount_t *, Uint32_t );
+static Status_t mStdCatCountGrow ( mStdCatCount_t *CountPtr );
+static mStdCatHour_t *mStdCatHourFind ( eStdCatalog_t *, Uint32_t NumHours, Int32_t Hour );
+static mStdCatCode_t *mStdCatCodeFind ( eStdCatalog_t *CatalogPtr, eSdbCode_t Code );
+static Status_t mStdCatCodeAdd ( eStdCatalog_t *, eSdbCode_t, mStdCatCode_t ** );
+static Status_t mStdCatSetAdd ( mStdCatCode_t *CodePtr, Int32_t Hour, Bool_t *AddedPtr );
+static Bool_t   mStdCatSetNext ( mStdCatCode_t *CodePtr, Int32_t Hour, Int32_t *NextPtr );
+static void     mStdCatPath ( eStdCatalog_t *CatalogPtr, char *NamePtr, char *FilePtr );
+static int      mStdCompareFiles ( const void *FirstPtr, const void *SecondPtr );
+static int      mStdCompareHours ( const void *FirstPtr, const void *SecondPtr );
+
+/*****************************************************************************
+** Function Name:
+**    eStdCatalogOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read an archive catalog.
+**
+** Description:
+**    The whole catalog is read into memory. It may then be shared by any
+**    number of readers and threads, see eStdReaderCatalog, until closed
+**    with eStdCatalogClose.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if there is no
+**       catalog, E_STD_READ_HEAD_ERR if it is not valid or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char           *CatalogFilePtr   (in)
+**       Name of the catalog.
+**    eStdCatalog_t **CatalogPtr       (out)
+**       The catalog.
+**
+*****************************************************************************/
+Status_t eStdCatalogOpen( char *CatalogFilePtr,
+                          eStdCatalog_t **CatalogPtr )
+{
+   Status_t Status;   /* Return value of function calls */
+
+   Status = mStdCatNew( CatalogPtr );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   Status = mStdCatLoad( *CatalogPtr, CatalogFilePtr );
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdCatFindPartial( *CatalogPtr );
+   }
+   if ( Status != SYS_NOMINAL )
+   {
+      eStdCatalogClose( *CatalogPtr );
+      *CatalogPtr = NULL;
+   }
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdCatalogUpdate
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Bring the catalog of an archive up to date.
+**
+** Description:
+**    Searches every directory below the archive for Sdb files named
+**    "yymmddhh.sdb" or "yymmddhh.sdb.gz", preferring the plain file of an
+**    hour if there are both. Files of hours not yet catalogued are read,
+**    as are the records added to any catalogued file which has grown,
+**    by NumThreads threads at once. Files unchanged in size and time
+**    are not opened, and a file since gzipped is only opened to check
+**    its size. The catalog is started afresh if there is none. It is
+**    written to a temporary file which replaces any existing catalog
+**    once complete, so a search never sees a partly written catalog. A
+**    file which cannot be read is reported and left to the next update.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if the archive
+**       cannot be searched, E_STD_READ_HEAD_ERR if the catalog is not
+**       valid or is of another archive, E_STD_READ_DATA_ERR if a file
+**       could not be read, E_STD_THREAD_ERR, E_STD_FILE_WRITE_ERR or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char           *CatalogFilePtr   (in)
+**       Name of the catalog.
+**    char           *ArchivePtr       (in)
+**       Directory holding the archive.
+**    Int32_t         NumThreads       (in)
+**       Number of files read at once.
+**    eStdCatalog_t **CatalogPtr       (out)
+**       The catalog updated, which eStdCatalogHour shows the hours added
+**       to or grown by the update of, or NULL after an error.
+**    Uint32_t       *NumNewPtr        (out)
+**       Number of hours added to or grown.
+**
+*****************************************************************************/
+Status_t eStdCatalogUpdate( char *CatalogFilePtr,
+                            char *ArchivePtr,
+                            Int32_t NumThreads,
+                            eStdCatalog_t **CatalogPtr,
+                            Uint32_t *NumNewPtr )
+{
+   Status_t       Status;                         /* Return value of function calls */
+   eStdCatalog_t *NewPtr;                         /* Catalog being updated */
+   mStdCatScan_t  Scan;                           /* Files of the archive */
+   pthread_t      Threads[ I_STD_MAX_THREADS ];   /* Worker threads */
+   char           Archive[ FILENAME_MAX ];        /* Archive less any trailing / */
+   size_t         Len;                            /* Length of the archive's name */
+   Int32_t        Updated;                        /* When the archive was searched */
+   Uint32_t       Offset;                         /* Offset of the archive's name */
+   Uint32_t       i;                              /* File or hour */
+   Int32_t        j;                              /* Thread */
+
+   *CatalogPtr = NULL;
+   *NumNewPtr  = 0;
+
+   Len = strlen( ArchivePtr );
+   while ( ( Len > 1 ) && ( ArchivePtr[ Len - 1 ] == '/' ) )
+   {
+      Len--;
+   }
+   if ( ( Len == 0 ) || ( Len >= FILENAME_MAX - M_STD_MAX_NAME - 8 ) )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to search archive %s", ArchivePtr);
+      return E_STD_FILE_OPEN_ERR;
+   }
+   memcpy( Archive, ArchivePtr, Len );
+   Archive[ Len ] = '\0';
+
+   Status = eStdCatalogOpen( CatalogFilePtr, &NewPtr );
+   if ( Status == E_STD_FILE_OPEN_ERR )
+   {
+      eLogNotice(0,"Starting catalog %s of %s", CatalogFilePtr, Archive);
+      Status = mStdCatNew( &NewPtr );
+      if ( Status == SYS_NOMINAL )
+      {
+         Status = mStdCatAddName( NewPtr, Archive, &Offset );
+      }
+      if ( Status != SYS_NOMINAL )
+      {
+         eStdCatalogClose( NewPtr );
+         return Status;
+      }
+   }
+   else if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+   else if ( strcmp( NewPtr->Names, Archive ) != 0 )
+   {
+      eLogErr(E_STD_READ_HEAD_ERR,"Catalog %s is of archive %s, not %s",
+              CatalogFilePtr, NewPtr->Names, Archive);
+      eStdCatalogClose( NewPtr );
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   /* Files written after this are left to the next update */
+   Updated = (Int32_t) time( NULL );
+
+   memset( &Scan, 0, sizeof( Scan ) );
+   Scan.CatalogPtr = NewPtr;
+   Status = mStdCatWalk( &Scan, Archive, "", 0 );
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdCatPlan( &Scan, Updated );
+   }
+   if ( Status != SYS_NOMINAL )
+   {
+      TTL_FREE( Scan.Files );
+      eStdCatalogClose( NewPtr );
+      return Status;
+   }
+
+   eLogNotice(0,"Reading %u new or grown hours of %s", Scan.NumFiles, Archive);
+
+   if ( NumThreads < 1 )
+   {
+      NumThreads = 1;
+   }
+   else if ( NumThreads > I_STD_MAX_THREADS )
+   {
+      NumThreads = I_STD_MAX_THREADS;
+   }
+   if ( (Uint32_t) NumThreads > Scan.NumFiles )
+   {
+      NumThreads = (Int32_t) Scan.NumFiles;
+   }
+
+   pthread_mutex_init( &Scan.Lock, NULL );
+
+   for ( j = 0; j < NumThreads; j++ )
+   {
+      if ( pthread_create( &Threads[ j ], NULL, mStdCatWorker, &Scan ) != 0 )
+      {
+         /* Those already started read every file */
+         if ( j == 0 )
+         {
+            Status = E_STD_THREAD_ERR;
+         }
+         NumThreads = j;
+         break;
+      }
+   }
+   for ( j = 0; j < NumThreads; j++ )
+   {
+      pthread_join( Threads[ j ], NULL );
+   }
+
+   pthread_mutex_destroy( &Scan.Lock );
+
+   /* Carry on past files which could not be read, reporting the first */
+   for ( i = 0; ( i < Scan.NumFiles ) && ( Status == SYS_NOMINAL ); i++ )
+   {
+      Status = Scan.Files[ i ].Status;
+   }
+   TTL_FREE( Scan.Files );
+
+   NewPtr->Header.Updated = Updated;
+   for ( i = 0; i < NewPtr->Header.NumHours; i++ )
+   {
+      if ( NewPtr->Hours[ i ].Updated == TRUE )
+      {
+         (*NumNewPtr)++;
+      }
+   }
+
+   if ( Status != E_STD_THREAD_ERR )
+   {
+      if ( ( mStdCatFindPartial( NewPtr ) != SYS_NOMINAL ) ||
+           ( mStdCatSave( NewPtr, CatalogFilePtr ) != SYS_NOMINAL ) )
+      {
+         eStdCatalogClose( NewPtr );
+         return E_STD_FILE_WRITE_ERR;
+      }
+   }
+
+   *CatalogPtr = NewPtr;
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdCatalogCode
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Retrieve what an archive catalog holds of a storage code.
+**
+** Description:
+**    The codes are in order, so every code of a source lies together.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_EOF if there are no more
+**       codes.
+**
+** Arguments:
+**    eStdCatalog_t     *CatalogPtr   (in)
+**       The catalog.
+**    Uint32_t           Index        (in)
+**       Index of the code, from zero.
+**    eStdCatalogCode_t *CodePtr      (out)
+**       What is held of the code.
+**
+*****************************************************************************/
+Status_t eStdCatalogCode( eStdCatalog_t *CatalogPtr,
+                          Uint32_t Index,
+                          eStdCatalogCode_t *CodePtr )
+{
+   iStdCatCode_t *EntryPtr;   /* The code */
+
+   if ( Index >= CatalogPtr->Header.NumCodes )
+   {
+      return E_STD_EOF;
+   }
+
+   EntryPtr = &(CatalogPtr->Codes[ Index ].Entry);
+   CodePtr->Code       = EntryPtr->Code;
+   CodePtr->FirstHour  = EntryPtr->FirstHour * E_STD_SECONDS_PER_HOUR;
+   CodePtr->LastHour   = EntryPtr->LastHour * E_STD_SECONDS_PER_HOUR;
+   CodePtr->NumHours   = EntryPtr->NumHours;
+   CodePtr->NumRecords = EntryPtr->NumRecords;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdCatalogHour
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Retrieve an hour of an archive catalog.
+**
+** Description:
+**    The hours are in order.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_EOF if there are no more
+**       hours.
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr   (in)
+**       The catalog.
+**    Uint32_t       Index        (in)
+**       Index of the hour, from zero.
+**    Int32_t       *HourPtr      (out)
+**       Start of the hour.
+**    char          *FilePtr      (out)
+**       Path of its Sdb file, FILENAME_MAX characters.
+**    Bool_t        *UpdatedPtr   (out)
+**       Set if the hour was added to or grown by eStdCatalogUpdate.
+**
+*****************************************************************************/
+Status_t eStdCatalogHour( eStdCatalog_t *CatalogPtr,
+                          Uint32_t Index,
+                          Int32_t *HourPtr,
+                          char *FilePtr,
+                          Bool_t *UpdatedPtr )
+{
+   mStdCatHour_t *HourEntryPtr;   /* The hour */
+
+   if ( Index >= CatalogPtr->Header.NumHours )
+   {
+      return E_STD_EOF;
+   }
+
+   HourEntryPtr = CatalogPtr->Hours + Index;
+   *HourPtr     = HourEntryPtr->Entry.Hour * E_STD_SECONDS_PER_HOUR;
+   *UpdatedPtr  = HourEntryPtr->Updated;
+   mStdCatPath( CatalogPtr, CatalogPtr->Names + HourEntryPtr->Entry.Name, FilePtr );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdCatalogNext
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the next hour of an archive which may hold records wanted.
+**
+** Description:
+**    Moves on from the start of an hour to the first hour, it or later,
+**    which the catalog shows holds records of any of the storage codes,
+**    or of any code if none are given, and gives the name of its file.
+**    Hours past those the catalog can be relied on for are not known to
+**    hold nothing, so the search stops at the first of those.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL if an hour was found, or E_STD_EOF if the hour
+**       is now past those catalogued.
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr   (in)
+**       The catalog.
+**    eSdbCode_t    *CodesPtr     (in)
+**       Storage codes wanted.
+**    size_t         NumCodes     (in)
+**       Number of codes wanted, zero for any.
+**    Int32_t       *HourPtr      (in/out)
+**       Start of the hour to search from, then of the hour found.
+**    char          *FilePtr      (out)
+**       Path of the hour's Sdb file, FILENAME_MAX characters, if found.
+**
+*****************************************************************************/
+Status_t eStdCatalogNext( eStdCatalog_t *CatalogPtr,
+                          eSdbCode_t *CodesPtr,
+                          size_t NumCodes,
+                          Int32_t *HourPtr,
+                          char *FilePtr )
+{
+   mStdCatCode_t *CodePtr;        /* A code wanted */
+   mStdCatHour_t *HourEntryPtr;   /* The hour found */
+   Int32_t        Hour;           /* Hour searched from */
+   Int32_t        End;            /* First hour not relied on */
+   Int32_t        Next;           /* First hour found */
+   Int32_t        Found;          /* First hour holding a code */
+   Uint32_t       Low;            /* Bounds of a binary search */
+   Uint32_t       High;
+   Uint32_t       Mid;
+   size_t         i;              /* Code wanted */
+
+   Hour = *HourPtr / E_STD_SECONDS_PER_HOUR;
+   End  = ( CatalogPtr->Header.Updated - I_STD_CAT_SETTLE ) / E_STD_SECONDS_PER_HOUR;
+   if ( Hour >= End )
+   {
+      return E_STD_EOF;
+   }
+
+   Next = End;
+   if ( NumCodes == 0 )
+   {
+      /* The first hour catalogued at or after the hour */
+      Low  = 0;
+      High = CatalogPtr->Header.NumHours;
+      while ( Low < High )
+      {
+         Mid = ( Low + High ) / 2;
+         if ( CatalogPtr->Hours[ Mid ].Entry.Hour < Hour )
+         {
+            Low = Mid + 1;
+         }
+         else
+         {
+            High = Mid;
+         }
+      }
+      if ( ( Low < CatalogPtr->Header.NumHours ) &&
+           ( CatalogPtr->Hours[ Low ].Entry.Hour < End ) )
+      {
+         Next = CatalogPtr->Hours[ Low ].Entry.Hour;
+      }
+   }
+
+   for ( i = 0; i < NumCodes; i++ )
+   {
+      CodePtr = mStdCatCodeFind( CatalogPtr, CodesPtr[ i ] );
+      if ( ( CodePtr != NULL ) &&
+           ( mStdCatSetNext( CodePtr, Hour, &Found ) == TRUE ) &&
+           ( Found < Next ) )
+      {
+         Next = Found;
+      }
+   }
+
+   /* An hour only partly catalogued may hold any code */
+   Low  = 0;
+   High = CatalogPtr->NumPartial;
+   while ( Low < High )
+   {
+      Mid = ( Low + High ) / 2;
+      if ( CatalogPtr->Partial[ Mid ] < Hour )
+      {
+         Low = Mid + 1;
+      }
+      else
+      {
+         High = Mid;
+      }
+   }
+   if ( ( Low < CatalogPtr->NumPartial ) && ( CatalogPtr->Partial[ Low ] < Next ) )
+   {
+      Next = CatalogPtr->Partial[ Low ];
+   }
+
+   *HourPtr = Next * E_STD_SECONDS_PER_HOUR;
+
+   HourEntryPtr = mStdCatHourFind( CatalogPtr, CatalogPtr->Header.NumHours, Next );
+   if ( ( Next >= End ) || ( HourEntryPtr == NULL ) )
+   {
+      return E_STD_EOF;
+   }
+
+   mStdCatPath( CatalogPtr, CatalogPtr->Names + HourEntryPtr->Entry.Name, FilePtr );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdCatalogClose
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Free an archive catalog.
+**
+** Description:
+**    No reader may still be using the catalog.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr   (in)
+**       The catalog, which may be NULL.
+**
+*****************************************************************************/
+Status_t eStdCatalogClose( eStdCatalog_t *CatalogPtr )
+{
+   Uint32_t i;   /* Code */
+   Uint32_t j;   /* Set of the code */
+
+   if ( CatalogPtr == NULL )
+   {
+      return SYS_NOMINAL;
+   }
+
+   for ( i = 0; i < CatalogPtr->Header.NumCodes; i++ )
+   {
+      for ( j = 0; j < CatalogPtr->Codes[ i ].Entry.NumSets; j++ )
+      {
+         TTL_FREE( CatalogPtr->Codes[ i ].Sets[ j ].List );
+         TTL_FREE( CatalogPtr->Codes[ i ].Sets[ j ].Bitmap );
+      }
+      TTL_FREE( CatalogPtr->Codes[ i ].Sets );
+   }
+
+   pthread_mutex_destroy( &(CatalogPtr->Lock) );
+   TTL_FREE( CatalogPtr->Partial );
+   TTL_FREE( CatalogPtr->Codes );
+   TTL_FREE( CatalogPtr->Hours );
+   TTL_FREE( CatalogPtr->Names );
+   TTL_FREE( CatalogPtr );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatNew
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Create an empty catalog.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_THREAD_ERR or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdCatalog_t **CatalogPtr   (out)
+**       The catalog.
+**
+*****************************************************************************/
+static Status_t mStdCatNew( eStdCatalog_t **CatalogPtr )
+{
+   eStdCatalog_t *NewPtr;   /* Catalog being created */
+
+   *CatalogPtr = NULL;
+
+   NewPtr = (eStdCatalog_t *) TTL_CALLOC( 1, sizeof( eStdCatalog_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if ( pthread_mutex_init( &(NewPtr->Lock), NULL ) != 0 )
+   {
+      TTL_FREE( NewPtr );
+      return E_STD_THREAD_ERR;
+   }
+
+   memcpy( NewPtr->Header.Magic, I_STD_CAT_MAGIC, 4 );
+   NewPtr->Header.Version = I_STD_CAT_VERSION;
+
+   *CatalogPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatLoad
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read a catalog into an empty one.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if there is no
+**       catalog, E_STD_READ_HEAD_ERR if it is not valid or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr       (in/out)
+**       The empty catalog.
+**    char          *CatalogFilePtr   (in)
+**       Name of the catalog.
+**
+*****************************************************************************/
+static Status_t mStdCatLoad( eStdCatalog_t *CatalogPtr, char *CatalogFilePtr )
+{
+   iStdCatHeader_t Header;      /* Header of the catalog */
+   mStdCatCode_t  *CodePtr;     /* Code being read */
+   iStdCatSet_t   *SetPtr;      /* Set being read */
+   FILE           *InFile;      /* The catalog */
+   Uint32_t        NumWords;    /* Uint16_t words of a list, padded */
+   Uint32_t        i;           /* Hour or code */
+   Uint32_t        j;           /* Set of a code */
+   Bool_t          Ok;          /* All read */
+
+   if ( ( InFile = fopen( CatalogFilePtr, "rb" ) ) == NULL )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   if ( ( fread( &Header, sizeof( Header ), 1, InFile ) != 1 ) ||
+        ( memcmp( Header.Magic, I_STD_CAT_MAGIC, 4 ) != 0 ) ||
+        ( Header.Version != I_STD_CAT_VERSION ) ||
+        ( Header.NamesSize == 0 ) )
+   {
+      fclose( InFile );
+      eLogErr(E_STD_READ_HEAD_ERR,"File %s is not a catalog", CatalogFilePtr);
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   CatalogPtr->Names = (char *) TTL_MALLOC( Header.NamesSize + 1 );
+   CatalogPtr->Hours = (mStdCatHour_t *) TTL_CALLOC( Header.NumHours + 1, sizeof( mStdCatHour_t ) );
+   CatalogPtr->Codes = (mStdCatCode_t *) TTL_CALLOC( Header.NumCodes + 1, sizeof( mStdCatCode_t ) );
+   if ( ( CatalogPtr->Names == NULL ) || ( CatalogPtr->Hours == NULL ) ||
+        ( CatalogPtr->Codes == NULL ) )
+   {
+      fclose( InFile );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   CatalogPtr->MaxNames = Header.NamesSize + 1;
+   CatalogPtr->MaxHours = Header.NumHours + 1;
+   CatalogPtr->MaxCodes = Header.NumCodes + 1;
+
+   Ok = fread( CatalogPtr->Names, 1, Header.NamesSize, InFile ) == Header.NamesSize;
+   CatalogPtr->Names[ Header.NamesSize ] = '\0';
+   CatalogPtr->Header.NamesSize = Header.NamesSize;
+
+   for ( i = 0; ( i < Header.NumHours ) && Ok; i++ )
+   {
+      Ok = ( fread( &(CatalogPtr->Hours[ i ].Entry), sizeof( iStdCatHour_t ), 1,
+                    InFile ) == 1 ) &&
+           ( CatalogPtr->Hours[ i ].Entry.Name < Header.NamesSize );
+      CatalogPtr->Header.NumHours = i + 1;
+   }
+
+   /* Codes are counted as read, so only those complete are freed */
+   for ( i = 0; ( i < Header.NumCodes ) && Ok; i++ )
+   {
+      CodePtr = CatalogPtr->Codes + i;
+      Ok = fread( &(CodePtr->Entry), sizeof( iStdCatCode_t ), 1, InFile ) == 1;
+      if ( Ok )
+      {
+         CodePtr->Sets    = (iStdCatSet_t *) TTL_CALLOC( CodePtr->Entry.NumSets + 1,
+                                                         sizeof( iStdCatSet_t ) );
+         CodePtr->MaxSets = CodePtr->Entry.NumSets + 1;
+         Ok = CodePtr->Sets != NULL;
+      }
+      if ( !Ok )
+      {
+         CodePtr->Entry.NumSets = 0;
+         break;
+      }
+      CatalogPtr->Header.NumCodes = i + 1;
+
+      for ( j = 0; ( j < CodePtr->Entry.NumSets ) && Ok; j++ )
+      {
+         SetPtr = CodePtr->Sets + j;
+         Ok = ( fread( &(SetPtr->Key), sizeof( Uint16_t ), 1, InFile ) == 1 ) &&
+              ( fread( &(SetPtr->IsBitmap), sizeof( Uint16_t ), 1, InFile ) == 1 ) &&
+              ( fread( &(SetPtr->NumHours), sizeof( Uint32_t ), 1, InFile ) == 1 ) &&
+              ( SetPtr->NumHours <= I_STD_CAT_SPAN );
+         if ( !Ok )
+         {
+            break;
+         }
+
+         if ( SetPtr->IsBitmap )
+         {
+            SetPtr->Bitmap = (Uint32_t *) TTL_MALLOC( sizeof( Uint32_t ) * M_STD_BITMAP_WORDS );
+            Ok = ( SetPtr->Bitmap != NULL ) &&
+                 ( fread( SetPtr->Bitmap, sizeof( Uint32_t ), M_STD_BITMAP_WORDS,
+                          InFile ) == M_STD_BITMAP_WORDS );
+         }
+         else
+         {
+            NumWords = ( SetPtr->NumHours + 1 ) & ~1U;
+            SetPtr->List    = (Uint16_t *) TTL_MALLOC( sizeof( Uint16_t ) * NumWords + 1 );
+            SetPtr->MaxList = NumWords;
+            Ok = ( SetPtr->List != NULL ) &&
+                 ( fread( SetPtr->List, sizeof( Uint16_t ), NumWords, InFile ) == NumWords );
+         }
+      }
+   }
+
+   fclose( InFile );
+
+   if ( !Ok )
+   {
+      eLogErr(E_STD_READ_HEAD_ERR,"Catalog %s is not complete", CatalogFilePtr);
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   CatalogPtr->Header.Updated = Header.Updated;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatSave
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write a catalog.
+**
+** Description:
+**    The names of the files of the hours are written afresh, dropping
+**    any no longer in use. The catalog is written to a temporary file
+**    which replaces any existing one once complete.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_FILE_WRITE_ERR.
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr       (in)
+**       The catalog.
+**    char          *CatalogFilePtr   (in)
+**       Name of the catalog.
+**
+*****************************************************************************/
+static Status_t mStdCatSave( eStdCatalog_t *CatalogPtr, char *CatalogFilePtr )
+{
+   iStdCatHeader_t Header;                        /* Header of the catalog */
+   iStdCatHour_t   Entry;                         /* Hour being written */
+   iStdCatSet_t   *SetPtr;                        /* Set being written */
+   char            TempFile[ FILENAME_MAX + 8 ];  /* Name while being written */
+   FILE           *OutFile;                       /* Catalog being written */
+   char           *NamePtr;                       /* Name being written */
+   Uint32_t        Offset;                        /* Offset of the name */
+   Uint32_t        NumWords;                      /* Uint16_t words of a list, padded */
+   Uint16_t        Zero;                          /* Padding of a list */
+   Uint32_t        i;                             /* Hour or code */
+   Uint32_t        j;                             /* Set of a code */
+   Bool_t          Ok;                            /* All written */
+
+   if ( strlen( CatalogFilePtr ) >= FILENAME_MAX )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+   sprintf( TempFile, "%s.tmp", CatalogFilePtr );
+
+   Header = CatalogPtr->Header;
+   Header.NamesSize = strlen( CatalogPtr->Names ) + 1;
+   for ( i = 0; i < Header.NumHours; i++ )
+   {
+      Header.NamesSize += strlen( CatalogPtr->Names + CatalogPtr->Hours[ i ].Entry.Name ) + 1;
+   }
+
+   if ( ( OutFile = fopen( TempFile, "wb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to open file %s", TempFile);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   Ok = ( fwrite( &Header, sizeof( Header ), 1, OutFile ) == 1 ) &&
+        ( fputs( CatalogPtr->Names, OutFile ) != EOF ) &&
+        ( fputc( '\0', OutFile ) != EOF );
+   for ( i = 0; ( i < Header.NumHours ) && Ok; i++ )
+   {
+      NamePtr = CatalogPtr->Names + CatalogPtr->Hours[ i ].Entry.Name;
+      Ok = ( fputs( NamePtr, OutFile ) != EOF ) && ( fputc( '\0', OutFile ) != EOF );
+   }
+
+   Offset = strlen( CatalogPtr->Names ) + 1;
+   for ( i = 0; ( i < Header.NumHours ) && Ok; i++ )
+   {
+      Entry      = CatalogPtr->Hours[ i ].Entry;
+      Entry.Name = Offset;
+      Offset    += strlen( CatalogPtr->Names + CatalogPtr->Hours[ i ].Entry.Name ) + 1;
+      Ok = fwrite( &Entry, sizeof( Entry ), 1, OutFile ) == 1;
+   }
+
+   Zero = 0;
+   for ( i = 0; ( i < Header.NumCodes ) && Ok; i++ )
+   {
+      Ok = fwrite( &(CatalogPtr->Codes[ i ].Entry), sizeof( iStdCatCode_t ), 1,
+                   OutFile ) == 1;
+      for ( j = 0; ( j < CatalogPtr->Codes[ i ].Entry.NumSets ) && Ok; j++ )
+      {
+         SetPtr = CatalogPtr->Codes[ i ].Sets + j;
+         Ok = ( fwrite( &(SetPtr->Key), sizeof( Uint16_t ), 1, OutFile ) == 1 ) &&
+              ( fwrite( &(SetPtr->IsBitmap), sizeof( Uint16_t ), 1, OutFile ) == 1 ) &&
+              ( fwrite( &(SetPtr->NumHours), sizeof( Uint32_t ), 1, OutFile ) == 1 );
+         if ( SetPtr->IsBitmap )
+         {
+            Ok = Ok && ( fwrite( SetPtr->Bitmap, sizeof( Uint32_t ), M_STD_BITMAP_WORDS,
+                                 OutFile ) == M_STD_BITMAP_WORDS );
+         }
+         else
+         {
+            /* Lists are padded to keep what follows aligned */
+            NumWords = ( SetPtr->NumHours + 1 ) & ~1U;
+            Ok = Ok && ( fwrite( SetPtr->List, sizeof( Uint16_t ), SetPtr->NumHours,
+                                 OutFile ) == SetPtr->NumHours );
+            if ( NumWords > SetPtr->NumHours )
+            {
+               Ok = Ok && ( fwrite( &Zero, sizeof( Uint16_t ), 1, OutFile ) == 1 );
+            }
+         }
+      }
+   }
+
+   if ( ( fclose( OutFile ) != 0 ) || !Ok ||
+        ( rename( TempFile, CatalogFilePtr ) != 0 ) )
+   {
+      remove( TempFile );
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to write catalog %s", CatalogFilePtr);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatFindPartial
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    List the hours of a catalog only partly catalogued.
+**
+** Description:
+**    They are listed in order, so that a search can find the next of
+**    them quickly.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr   (in/out)
+**       The catalog.
+**
+*****************************************************************************/
+static Status_t mStdCatFindPartial( eStdCatalog_t *CatalogPtr )
+{
+   Uint32_t i;   /* Hour */
+
+   TTL_FREE( CatalogPtr->Partial );
+   CatalogPtr->NumPartial = 0;
+
+   CatalogPtr->Partial = (Int32_t *) TTL_MALLOC( sizeof( Int32_t ) *
+                                                 CatalogPtr->Header.NumHours + 1 );
+   if ( CatalogPtr->Partial == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   for ( i = 0; i < CatalogPtr->Header.NumHours; i++ )
+   {
+      if ( CatalogPtr->Hours[ i ].Entry.Partial )
+      {
+         CatalogPtr->Partial[ CatalogPtr->NumPartial++ ] = CatalogPtr->Hours[ i ].Entry.Hour;
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatAddName
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Add a name to the names of a catalog.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr   (in/out)
+**       The catalog.
+**    char          *NamePtr      (in)
+**       Name to add.
+**    Uint32_t      *OffsetPtr    (out)
+**       Offset of the name in the names.
+**
+*****************************************************************************/
+static Status_t mStdCatAddName( eStdCatalog_t *CatalogPtr,
+                                char *NamePtr,
+                                Uint32_t *OffsetPtr )
+{
+   char     *NewPtr;   /* Names extended */
+   Uint32_t  Len;      /* Bytes of the name */
+   Uint32_t  MaxNames; /* Size of the names extended */
+
+   Len = strlen( NamePtr ) + 1;
+   if ( CatalogPtr->Header.NamesSize + Len > CatalogPtr->MaxNames )
+   {
+      MaxNames = CatalogPtr->MaxNames == 0 ? 4096 : CatalogPtr->MaxNames;
+      while ( CatalogPtr->Header.NamesSize + Len > MaxNames )
+      {
+         MaxNames *= 2;
+      }
+
+      NewPtr = (char *) TTL_REALLOC( CatalogPtr->Names, MaxNames );
+      if ( NewPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      CatalogPtr->Names    = NewPtr;
+      CatalogPtr->MaxNames = MaxNames;
+   }
+
+   *OffsetPtr = CatalogPtr->Header.NamesSize;
+   memcpy( CatalogPtr->Names + *OffsetPtr, NamePtr, Len );
+   CatalogPtr->Header.NamesSize += Len;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatWalk
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the Sdb files in a directory of an archive and those below it.
+**
+** Description:
+**    Hidden files and directories are passed over, as are files which
+**    cannot be examined.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if the top
+**       directory cannot be read, or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdCatScan_t *ScanPtr   (in/out)
+**       Files found so far.
+**    char          *DirPtr    (in)
+**       Path of the directory.
+**    char          *RelPtr    (in)
+**       Path of the directory within the archive, empty for the top.
+**    Int32_t        Depth     (in)
+**       Directories above it within the archive.
+**
+*****************************************************************************/
+static Status_t mStdCatWalk( mStdCatScan_t *ScanPtr,
+                             char *DirPtr,
+                             char *RelPtr,
+                             Int32_t Depth )
+{
+   Status_t       Status;                   /* Return value of function calls */
+   DIR           *Dir;                      /* The directory */
+   struct dirent *EntryPtr;                 /* Entry of the directory */
+   struct stat    Stat;                     /* What the entry is */
+   mStdCatFile_t *NewPtr;                   /* Files extended */
+   mStdCatFile_t *FilePtr;                  /* File found */
+   char           Path[ FILENAME_MAX + M_STD_MAX_NAME ]; /* Path of the entry */
+   char           Rel[ M_STD_MAX_NAME ];    /* Path of the entry in the archive */
+   Uint32_t       MaxFiles;                 /* Size of the files extended */
+   Int32_t        Hour;                     /* Hour of a file */
+   Bool_t         Gzipped;                  /* A file is gzipped */
+
+   if ( ( Dir = opendir( DirPtr ) ) == NULL )
+   {
+      if ( Depth == 0 )
+      {
+         eLogErr(E_STD_FILE_OPEN_ERR,"Unable to search archive %s", DirPtr);
+         return E_STD_FILE_OPEN_ERR;
+      }
+      eLogWarning(E_STD_FILE_OPEN_ERR,"Unable to search directory %s", DirPtr);
+      return SYS_NOMINAL;
+   }
+
+   Status = SYS_NOMINAL;
+   while ( ( Status == SYS_NOMINAL ) && ( ( EntryPtr = readdir( Dir ) ) != NULL ) )
+   {
+      if ( ( EntryPtr->d_name[ 0 ] == '.' ) ||
+           ( strlen( DirPtr ) + strlen( EntryPtr->d_name ) + 2 > FILENAME_MAX ) ||
+           ( strlen( RelPtr ) + strlen( EntryPtr->d_name ) + 2 > sizeof( Rel ) ) )
+      {
+         continue;
+      }
+      sprintf( Path, "%s/%s", DirPtr, EntryPtr->d_name );
+      sprintf( Rel, "%s%s%s", RelPtr, RelPtr[ 0 ] == '\0' ? "" : "/", EntryPtr->d_name );
+
+      if ( stat( Path, &Stat ) != 0 )
+      {
+         continue;
+      }
+
+      if ( S_ISDIR( Stat.st_mode ) )
+      {
+         if ( Depth < M_STD_MAX_DEPTH )
+         {
+            Status = mStdCatWalk( ScanPtr, Path, Rel, Depth + 1 );
+         }
+         continue;
+      }
+
+      if ( !S_ISREG( Stat.st_mode ) ||
+           ( iStdCatHourOfName( EntryPtr->d_name, &Hour, &Gzipped ) == FALSE ) )
+      {
+         continue;
+      }
+
+      if ( ScanPtr->NumFiles == ScanPtr->MaxFiles )
+      {
+         MaxFiles = ScanPtr->MaxFiles == 0 ? 1024 : ScanPtr->MaxFiles * 2;
+         NewPtr   = (mStdCatFile_t *) TTL_REALLOC( ScanPtr->Files,
+                                                   sizeof( mStdCatFile_t ) * MaxFiles );
+         if ( NewPtr == NULL )
+         {
+            Status = E_STD_MEM_ALLOC_ERR;
+            break;
+         }
+         ScanPtr->Files    = NewPtr;
+         ScanPtr->MaxFiles = MaxFiles;
+      }
+
+      FilePtr = ScanPtr->Files + ScanPtr->NumFiles++;
+      memset( FilePtr, 0, sizeof( *FilePtr ) );
+      strcpy( FilePtr->Name, Rel );
+      FilePtr->Hour     = Hour;
+      FilePtr->Gzipped  = Gzipped;
+      FilePtr->FileSize = (Uint32_t) Stat.st_size;
+      FilePtr->FileTime = (Int32_t) Stat.st_mtime;
+   }
+
+   closedir( Dir );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdCatHourOfName
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Find the hour of an Sdb file from its name.
+**
+** Description:
+**    The name must be "yymmddhh.sdb", "yymmddhh.sdb.gz" or
+**    "yymmddhh.sdb.bgz". Years from 70 are taken to be of the twentieth
+**    century. Also used to find the hours of files named to Std.
+**
+** Return type:
+**    Bool_t
+**       FALSE if the name is not that of an Sdb file.
+**
+** Arguments:
+**    char    *NamePtr      (in)
+**       Name of the file, less any directory.
+**    Int32_t *HourPtr      (out)
+**       Hours since the epoch.
+**    Bool_t  *GzippedPtr   (out)
+**       Set if the file is gzipped or block-compressed.
+**
+*****************************************************************************/
+Bool_t iStdCatHourOfName( char *NamePtr, Int32_t *HourPtr, Bool_t *GzippedPtr )
+{
+   static const Int32_t DaysBefore[ E_STD_MONTHS_IN_YEAR ] =
+      { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+   Int32_t Digits[ M_STD_NAME_LEN / 2 ];   /* Year, month, date and hour */
+   Int32_t Year;                           /* Year in full */
+   Int32_t Days;                           /* Days since the epoch */
+   Int32_t i;                              /* Character of the name */
+
+   for ( i = 0; i < M_STD_NAME_LEN; i++ )
+   {
+      if ( ( NamePtr[ i ] < '0' ) || ( NamePtr[ i ] > '9' ) )
+      {
+         return FALSE;
+      }
+   }
+
+   if ( strcmp( NamePtr + M_STD_NAME_LEN, "." I_STD_EXT_SDB ) == 0 )
+   {
+      *GzippedPtr = FALSE;
+   }
+   else if ( ( strcmp( NamePtr + M_STD_NAME_LEN, "." I_STD_EXT_SDB I_STD_EXT_GZIP ) == 0 ) ||
+             ( strcmp( NamePtr + M_STD_NAME_LEN, "." I_STD_EXT_SDB I_STD_EXT_BGZF ) == 0 ) )
+   {
+      *GzippedPtr = TRUE;
+   }
+   else
+   {
+      return FALSE;
+   }
+
+   for ( i = 0; i < M_STD_NAME_LEN / 2; i++ )
+   {
+      Digits[ i ] = ( NamePtr[ 2 * i ] - '0' ) * 10 + NamePtr[ 2 * i + 1 ] - '0';
+   }
+   if ( ( Digits[ 1 ] < 1 ) || ( Digits[ 1 ] > E_STD_MONTHS_IN_YEAR ) ||
+        ( Digits[ 2 ] < 1 ) || ( Digits[ 2 ] > E_STD_DAYS_IN_MONTH ) ||
+        ( Digits[ 3 ] > E_STD_HOURS_IN_DAY ) )
+   {
+      return FALSE;
+   }
+
+   Year = Digits[ 0 ] + ( Digits[ 0 ] < 70 ? 2000 : 1900 );
+   Days = 365 * ( Year - 1970 ) + ( Year - 1969 ) / 4 - ( Year - 1901 ) / 100
+          + ( Year - 1601 ) / 400 + DaysBefore[ Digits[ 1 ] - 1 ] + Digits[ 2 ] - 1;
+   if ( ( Digits[ 1 ] > 2 ) &&
+        ( ( Year % 4 == 0 ) && ( ( Year % 100 != 0 ) || ( Year % 400 == 0 ) ) ) )
+   {
+      Days++;
+   }
+
+   *HourPtr = Days * 24 + Digits[ 3 ];
+
+   return TRUE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatPlan
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Decide which of the files found need to be read.
+**
+** Description:
+**    Keeps one file of each hour, the plain one if there are both, and of
+**    those only the files of hours not yet catalogued and the files which
+**    have grown. An entry is added to the catalog for each new hour. The
+**    rest are dropped, after noting any change of name. A file changed
+**    in the last I_STD_CAT_SETTLE seconds is left to the next update,
+**    its hour marked as only partly catalogued, as is each hour until
+**    its file has been read.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdCatScan_t *ScanPtr   (in/out)
+**       Files found, left holding those to be read.
+**    Int32_t        Updated   (in)
+**       When the archive was searched.
+**
+*****************************************************************************/
+static Status_t mStdCatPlan( mStdCatScan_t *ScanPtr, Int32_t Updated )
+{
+   Status_t       Status;                 /* Return value of function calls */
+   eStdCatalog_t *CatalogPtr;             /* Catalog being updated */
+   mStdCatFile_t *FilePtr;                /* File found */
+   mStdCatHour_t *HourEntryPtr;           /* Its hour, if catalogued */
+   mStdCatHour_t *NewPtr;                 /* Hours extended */
+   char           Path[ FILENAME_MAX ];   /* Path of the file */
+   Uint32_t       NumOld;                 /* Hours catalogued before */
+   Uint32_t       NumKept;                /* Files to be read */
+   Uint32_t       Offset;                 /* Offset of a name */
+   Uint32_t       i;                      /* File found */
+   Bool_t         Settling;               /* The file has just changed */
+
+   CatalogPtr = ScanPtr->CatalogPtr;
+   NumOld     = CatalogPtr->Header.NumHours;
+   NumKept    = 0;
+
+   qsort( ScanPtr->Files, ScanPtr->NumFiles, sizeof( mStdCatFile_t ), mStdCompareFiles );
+
+   for ( i = 0; i < ScanPtr->NumFiles; i++ )
+   {
+      FilePtr = ScanPtr->Files + i;
+      if ( ( i > 0 ) && ( FilePtr->Hour == ScanPtr->Files[ i - 1 ].Hour ) )
+      {
+         continue;
+      }
+
+      HourEntryPtr = mStdCatHourFind( CatalogPtr, NumOld, FilePtr->Hour );
+      if ( ( HourEntryPtr != NULL ) &&
+           ( HourEntryPtr->Entry.FileSize == FilePtr->FileSize ) &&
+           ( HourEntryPtr->Entry.FileTime == FilePtr->FileTime ) &&
+           ( strcmp( CatalogPtr->Names + HourEntryPtr->Entry.Name, FilePtr->Name ) == 0 ) )
+      {
+         continue;
+      }
+
+      /* Leave a file still being written until it settles */
+      Settling = FilePtr->FileTime > Updated - I_STD_CAT_SETTLE;
+
+      mStdCatPath( CatalogPtr, FilePtr->Name, Path );
+      FilePtr->DataSize = Settling ? 0 : mStdCatDataSize( Path, FilePtr->Gzipped,
+                                                          FilePtr->FileSize );
+
+      if ( HourEntryPtr != NULL )
+      {
+         if ( Settling == TRUE )
+         {
+            HourEntryPtr->Entry.Partial = TRUE;
+            continue;
+         }
+
+         if ( FilePtr->DataSize != HourEntryPtr->Entry.DataSize )
+         {
+            if ( FilePtr->DataSize < HourEntryPtr->Entry.DataSize )
+            {
+               eLogWarning(E_STD_READ_DATA_ERR,"%s has fewer records than catalogued,"
+                           " rebuild the catalog to forget those lost", Path);
+            }
+            else
+            {
+               /* Until read, the records added may be of any code */
+               HourEntryPtr->Entry.Partial = TRUE;
+               FilePtr->From = HourEntryPtr->Entry.DataSize;
+               ScanPtr->Files[ NumKept++ ] = *FilePtr;
+            }
+         }
+
+         /* A file gzipped or moved need not be read again */
+         if ( strcmp( CatalogPtr->Names + HourEntryPtr->Entry.Name, FilePtr->Name ) != 0 )
+         {
+            Status = mStdCatAddName( CatalogPtr, FilePtr->Name, &Offset );
+            if ( Status != SYS_NOMINAL )
+            {
+               return Status;
+            }
+            HourEntryPtr->Entry.Name = Offset;
+         }
+         if ( FilePtr->DataSize <= HourEntryPtr->Entry.DataSize )
+         {
+            HourEntryPtr->Entry.FileSize = FilePtr->FileSize;
+            HourEntryPtr->Entry.FileTime = FilePtr->FileTime;
+            HourEntryPtr->Entry.Partial  = FALSE;
+         }
+         continue;
+      }
+
+      if ( CatalogPtr->Header.NumHours == CatalogPtr->MaxHours )
+      {
+         NewPtr = (mStdCatHour_t *) TTL_REALLOC( CatalogPtr->Hours, sizeof( mStdCatHour_t ) *
+                                                 ( CatalogPtr->MaxHours * 2 + 1024 ) );
+         if ( NewPtr == NULL )
+         {
+            return E_STD_MEM_ALLOC_ERR;
+         }
+         CatalogPtr->Hours    = NewPtr;
+         CatalogPtr->MaxHours = CatalogPtr->MaxHours * 2 + 1024;
+      }
+
+      Status = mStdCatAddName( CatalogPtr, FilePtr->Name, &Offset );
+      if ( Status != SYS_NOMINAL )
+      {
+         return Status;
+      }
+
+      HourEntryPtr = CatalogPtr->Hours + CatalogPtr->Header.NumHours++;
+      memset( HourEntryPtr, 0, sizeof( *HourEntryPtr ) );
+      HourEntryPtr->Entry.Hour    = FilePtr->Hour;
+      HourEntryPtr->Entry.Name    = Offset;
+      HourEntryPtr->Entry.Partial = TRUE;
+
+      if ( Settling == FALSE )
+      {
+         ScanPtr->Files[ NumKept++ ] = *FilePtr;
+      }
+   }
+
+   ScanPtr->NumFiles = NumKept;
+
+   qsort( CatalogPtr->Hours, CatalogPtr->Header.NumHours, sizeof( mStdCatHour_t ),
+          mStdCompareHours );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatDataSize
+**
+** Type:
+**    Uint32_t
+**
+** Purpose:
+**    Find the bytes of whole records in an Sdb file.
+**
+** Description:
+**    The size of a gzipped file's data is taken from the end of the file,
+**    so it need not be decompressed, and that of a block-compressed file
+**    from its blocks. For a block-structured file it is the bytes of
+**    whole blocks.
+**
+** Return type:
+**    Uint32_t
+**       Bytes of whole records or blocks, zero if they cannot be found.
+**
+** Arguments:
+**    char     *FilePtr    (in)
+**       Path of the file.
+**    Bool_t    Gzipped    (in)
+**       Set if the file is gzipped or block-compressed.
+**    Uint32_t  FileSize   (in)
+**       Size of the file.
+**
+*****************************************************************************/
+static Uint32_t mStdCatDataSize( char *FilePtr, Bool_t Gzipped, Uint32_t FileSize )
+{
+   FILE          *InFile;     /* The file */
+   gzFile         GzInFile;   /* The file, read through zlib */
+   unsigned char  Trailer[ 4 ];  /* Size of the data, least significant first */
+   char           Magic[ E_STD_FILE_HDR_SIZE ]; /* Header of the file */
+   Bool_t         Blocked;    /* The file is block-structured */
+   Uint32_t       Size;       /* Size of the file's data */
+   Uint32_t       NumRecords; /* Records of a block-compressed file */
+   iStdBgzf_t    *BgzfPtr;    /* The file, if block-compressed */
+   size_t         Len;        /* Length of its path */
+
+   Size = FileSize;
+   Len  = strlen( FilePtr );
+   if ( ( Gzipped == TRUE ) && ( Len > strlen( I_STD_EXT_BGZF ) ) &&
+        ( strcmp( FilePtr + Len - strlen( I_STD_EXT_BGZF ), I_STD_EXT_BGZF ) == 0 ) )
+   {
+      /* Its last member is empty, so holds no size of the data */
+      Size = 0;
+      if ( ( InFile = fopen( FilePtr, "rb" ) ) != NULL )
+      {
+         if ( iStdBgzfOpen( InFile, 0, 0, &BgzfPtr ) == SYS_NOMINAL )
+         {
+            iStdBgzfInfo( BgzfPtr, NULL, NULL, &NumRecords );
+            Size = I_STD_RECORDS_START + NumRecords * sizeof( eSdbRawFmt_t );
+            iStdBgzfClose( BgzfPtr );
+         }
+         fclose( InFile );
+      }
+   }
+   else if ( Gzipped == TRUE )
+   {
+      Size = 0;
+      if ( ( InFile = fopen( FilePtr, "rb" ) ) != NULL )
+      {
+         if ( ( fseek( InFile, -4L, SEEK_END ) == 0 ) &&
+              ( fread( Trailer, 1, 4, InFile ) == 4 ) )
+         {
+            Size = (Uint32_t) Trailer[ 0 ] | ( (Uint32_t) Trailer[ 1 ] << 8 ) |
+                   ( (Uint32_t) Trailer[ 2 ] << 16 ) | ( (Uint32_t) Trailer[ 3 ] << 24 );
+         }
+         fclose( InFile );
+      }
+   }
+
+   if ( Size < I_STD_RECORDS_START )
+   {
+      return 0;
+   }
+
+   Size -= I_STD_RECORDS_START;
+
+   /* zlib reads plain files as they are */
+   Blocked = FALSE;
+   if ( ( GzInFile = gzopen( FilePtr, "rb" ) ) != NULL )
+   {
+      if ( ( gzread( GzInFile, Magic, sizeof( Magic ) ) == (int) sizeof( Magic ) ) &&
+           ( memcmp( Magic, E_SDB_HEADER_STRING_V2, E_STD_FILE_HDR_SIZE ) == 0 ) )
+      {
+         Blocked = TRUE;
+      }
+      gzclose( GzInFile );
+   }
+
+   if ( Blocked == TRUE )
+   {
+      return Size - Size % E_SDB_BLOCK_SIZE;
+   }
+
+   return Size - Size % sizeof( eSdbRawFmt_t );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatWorker
+**
+** Type:
+**    void *
+**
+** Purpose:
+**    Body of each thread reading files for the catalog.
+**
+** Description:
+**    Repeatedly takes the next file still to be read, reads it and adds
+**    what was found to the catalog.
+**
+** Return type:
+**    void *
+**       Always NULL.
+**
+** Arguments:
+**    void *ArgPtr              (in/out)
+**       The mStdCatScan_t of files to be read.
+**
+*****************************************************************************/
+static void *mStdCatWorker( void *ArgPtr )
+{
+   mStdCatScan_t  *ScanPtr;   /* Files to be read */
+   mStdCatFile_t  *FilePtr;   /* File being read */
+   mStdCatCount_t  Count;     /* Codes found in it */
+   Uint32_t        i;         /* Slot of the codes */
+
+   ScanPtr = (mStdCatScan_t *) ArgPtr;
+   memset( &Count, 0, sizeof( Count ) );
+
+   for ( ; ; )
+   {
+      pthread_mutex_lock( &(ScanPtr->Lock) );
+      FilePtr = NULL;
+      if ( ScanPtr->NextFile < ScanPtr->NumFiles )
+      {
+         FilePtr = ScanPtr->Files + ScanPtr->NextFile++;
+      }
+      pthread_mutex_unlock( &(ScanPtr->Lock) );
+
+      if ( FilePtr == NULL )
+      {
+         break;
+      }
+
+      FilePtr->Status = mStdCatScanFile( ScanPtr->CatalogPtr, FilePtr, &Count );
+
+      for ( i = 0; i < Count.Size; i++ )
+      {
+         Count.Counts[ i ] = 0;
+      }
+      Count.NumUsed = 0;
+   }
+
+   TTL_FREE( Count.Codes );
+   TTL_FREE( Count.Counts );
+
+   return NULL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatScanFile
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the records of a file not yet catalogued, and add them.
+**
+** Description:
+**    The records of each code are counted, then the hour and its codes
+**    added to the catalog. Blocks of a block-structured file which fail
+**    their checks are passed over with a warning.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR,
+**       E_STD_READ_HEAD_ERR, E_STD_READ_DATA_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdCatalog_t  *CatalogPtr   (in/out)
+**       Catalog being updated.
+**    mStdCatFile_t  *FilePtr      (in)
+**       File to be read.
+**    mStdCatCount_t *CountPtr     (in/out)
+**       Empty table to count the codes in.
+**
+*****************************************************************************/
+static Status_t mStdCatScanFile( eStdCatalog_t  *CatalogPtr,
+                                 mStdCatFile_t  *FilePtr,
+                                 mStdCatCount_t *CountPtr )
+{
+   Status_t       Status;                /* Return value of function calls */
+   eSdbRawFmt_t   Chunk[ M_STD_CAT_CHUNK ]; /* Records read at once */
+   eSdbDataBlock_t Block;                /* Block of a block-structured file */
+   gzFile         InFile;                /* The Sdb file, read through zlib */
+   char           Path[ FILENAME_MAX ];  /* Path of the file */
+   char           Magic[ I_STD_RECORDS_START ]; /* Header of the file */
+   Bool_t         Blocked;               /* The file is block-structured */
+   Uint32_t       Left;                  /* Bytes of records still to read */
+   Uint32_t       NumRecords;            /* Records read */
+   int            NumBytes;              /* Bytes read */
+
+   mStdCatPath( CatalogPtr, FilePtr->Name, Path );
+
+   /* zlib reads plain files as they are */
+   if ( ( InFile = gzopen( Path, "rb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to open file %s", Path);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   NumBytes = gzread( InFile, Magic, sizeof( Magic ) );
+   Blocked  = ( NumBytes == (int) sizeof( Magic ) ) &&
+              ( memcmp( Magic, E_SDB_HEADER_STRING_V2, E_STD_FILE_HDR_SIZE ) == 0 )
+              ? TRUE : FALSE;
+   if ( ( NumBytes != (int) sizeof( Magic ) ) ||
+        ( ( memcmp( Magic, E_SDB_HEADER_STRING, E_STD_FILE_HDR_SIZE ) != 0 ) &&
+          ( Blocked == FALSE ) ) ||
+        ( gzseek( InFile, (z_off_t) ( I_STD_RECORDS_START + FilePtr->From ),
+                  SEEK_SET ) < 0 ) )
+   {
+      gzclose( InFile );
+      eLogErr(E_STD_READ_HEAD_ERR,"File %s is not an Sdb file", Path);
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   Status     = CountPtr->Size == 0 ? mStdCatCountGrow( CountPtr ) : SYS_NOMINAL;
+   Left       = FilePtr->DataSize - FilePtr->From;
+   NumRecords = 0;
+   while ( ( Status == SYS_NOMINAL ) && ( Left > 0 ) && ( Blocked == FALSE ) )
+   {
+      NumBytes = gzread( InFile, Chunk, Left < sizeof( Chunk ) ? Left : sizeof( Chunk ) );
+      if ( NumBytes <= 0 )
+      {
+         Status = E_STD_READ_DATA_ERR;
+         eLogErr(Status,"Unable to read file %s", Path);
+         break;
+      }
+      Left -= (Uint32_t) NumBytes;
+
+      Status = mStdCatCountRecords( CountPtr, Chunk,
+                                    (Uint32_t) NumBytes / sizeof( eSdbRawFmt_t ) );
+      NumRecords += (Uint32_t) NumBytes / sizeof( eSdbRawFmt_t );
+   }
+
+   while ( ( Status == SYS_NOMINAL ) && ( Left > 0 ) && ( Blocked == TRUE ) )
+   {
+      if ( gzread( InFile, &Block, E_SDB_BLOCK_SIZE ) != E_SDB_BLOCK_SIZE )
+      {
+         Status = E_STD_READ_DATA_ERR;
+         eLogErr(Status,"Unable to read file %s", Path);
+         break;
+      }
+      Left -= E_SDB_BLOCK_SIZE;
+
+      if ( eSdbBlockCheck( &Block ) != SYS_NOMINAL )
+      {
+         eLogWarning(E_STD_READ_DATA_ERR, "Block %u of %s is corrupt, skipped",
+                     ( FilePtr->DataSize - Left ) / E_SDB_BLOCK_SIZE - 1, Path);
+         continue;
+      }
+
+      Status = mStdCatCountRecords( CountPtr, Block.Records, Block.Hdr.NumRecords );
+      NumRecords += Block.Hdr.NumRecords;
+   }
+
+   gzclose( InFile );
+
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   pthread_mutex_lock( &(CatalogPtr->Lock) );
+   Status = mStdCatMerge( CatalogPtr, FilePtr, CountPtr, NumRecords );
+   pthread_mutex_unlock( &(CatalogPtr->Lock) );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatCountRecords
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Count the records of each code in a run of records.
+**
+** Description:
+**    The table of counts is grown to keep it no more than half full.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdCatCount_t *CountPtr     (in/out)
+**       Table to count the codes in.
+**    eSdbRawFmt_t   *RecordsPtr   (in)
+**       The records.
+**    Uint32_t        NumRecords   (in)
+**       Number of records.
+**
+*****************************************************************************/
+static Status_t mStdCatCountRecords( mStdCatCount_t *CountPtr,
+                                     eSdbRawFmt_t   *RecordsPtr,
+                                     Uint32_t        NumRecords )
+{
+   Status_t       Status;         /* Return value of function calls */
+   Uint32_t       Slot;           /* Slot of a code */
+   Uint32_t       i;              /* Record counted */
+
+   Status = SYS_NOMINAL;
+
+   for ( i = 0; ( i < NumRecords ) && ( Status == SYS_NOMINAL ); i++ )
+   {
+      Slot = (Uint32_t) ( RecordsPtr[ i ].Code * M_STD_HASH_MULT ) >> CountPtr->Shift;
+      while ( ( CountPtr->Counts[ Slot ] != 0 ) &&
+              ( CountPtr->Codes[ Slot ] != RecordsPtr[ i ].Code ) )
+      {
+         Slot = ( Slot + 1 ) & ( CountPtr->Size - 1 );
+      }
+      if ( CountPtr->Counts[ Slot ]++ == 0 )
+      {
+         CountPtr->Codes[ Slot ] = RecordsPtr[ i ].Code;
+         CountPtr->NumUsed++;
+
+         /* Keep the table no more than half full */
+         if ( 2 * CountPtr->NumUsed > CountPtr->Size )
+         {
+            Status = mStdCatCountGrow( CountPtr );
+         }
+      }
+   }
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatMerge
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Add the codes found in a file to the catalog.
+**
+** Description:
+**    The catalog's lock must be held. The hour's entry is only brought
+**    up to date once all its codes have been added, so that a file only
+**    partly added is read again by the next update.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdCatalog_t  *CatalogPtr   (in/out)
+**       Catalog being updated.
+**    mStdCatFile_t  *FilePtr      (in)
+**       File read.
+**    mStdCatCount_t *CountPtr     (in)
+**       Records of each code found in it.
+**    Uint32_t        NumRecords   (in)
+**       Records read from it.
+**
+*****************************************************************************/
+static Status_t mStdCatMerge( eStdCatalog_t  *CatalogPtr,
+                              mStdCatFile_t  *FilePtr,
+                              mStdCatCount_t *CountPtr,
+                              Uint32_t        NumRecords )
+{
+   Status_t       Status;         /* Return value of function calls */
+   mStdCatHour_t *HourEntryPtr;   /* The file's hour */
+   mStdCatCode_t *CodePtr;        /* A code found */
+   Uint32_t       NumAdded;       /* Codes new to the hour */
+   Bool_t         Added;          /* A code is new to the hour */
+   Uint32_t       i;              /* Slot of the codes */
+
+   HourEntryPtr = mStdCatHourFind( CatalogPtr, CatalogPtr->Header.NumHours, FilePtr->Hour );
+   NumAdded     = 0;
+
+   for ( i = 0; i < CountPtr->Size; i++ )
+   {
+      if ( CountPtr->Counts[ i ] == 0 )
+      {
+         continue;
+      }
+
+      Status = mStdCatCodeAdd( CatalogPtr, CountPtr->Codes[ i ], &CodePtr );
+      if ( Status == SYS_NOMINAL )
+      {
+         Status = mStdCatSetAdd( CodePtr, FilePtr->Hour, &Added );
+      }
+      if ( Status != SYS_NOMINAL )
+      {
+         return Status;
+      }
+
+      if ( Added == TRUE )
+      {
+         if ( ( CodePtr->Entry.NumHours == 0 ) || ( FilePtr->Hour < CodePtr->Entry.FirstHour ) )
+         {
+            CodePtr->Entry.FirstHour = FilePtr->Hour;
+         }
+         if ( ( CodePtr->Entry.NumHours == 0 ) || ( FilePtr->Hour > CodePtr->Entry.LastHour ) )
+         {
+            CodePtr->Entry.LastHour = FilePtr->Hour;
+         }
+         CodePtr->Entry.NumHours++;
+         NumAdded++;
+      }
+      CodePtr->Entry.NumRecords += CountPtr->Counts[ i ];
+   }
+
+   HourEntryPtr->Entry.FileSize    = FilePtr->FileSize;
+   HourEntryPtr->Entry.FileTime    = FilePtr->FileTime;
+   HourEntryPtr->Entry.DataSize    = FilePtr->DataSize;
+   HourEntryPtr->Entry.NumRecords += NumRecords;
+   HourEntryPtr->Entry.NumCodes   += NumAdded;
+   HourEntryPtr->Entry.Partial     = FALSE;
+   HourEntryPtr->Updated           = TRUE;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatCountGrow
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Double the slots of the table counting the codes of a file.
+**
+** Description:
+**    Allocates M_STD_MIN_SLOTS slots if the table is empty, otherwise
+**    moves the codes into a table of twice the size.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdCatCount_t *CountPtr   (in/out)
+**       Codes counted.
+**
+*****************************************************************************/
+static Status_t mStdCatCountGrow( mStdCatCount_t *CountPtr )
+{
+   mStdCatCount_t Old;    /* Table being replaced */
+   Uint32_t       Slot;   /* Slot of the new table */
+   Uint32_t       i;      /* Slot of the old table */
+
+   Old = *CountPtr;
+
+   if ( Old.Size == 0 )
+   {
+      CountPtr->Size  = M_STD_MIN_SLOTS;
+      CountPtr->Shift = 24;
+   }
+   else
+   {
+      CountPtr->Size  = Old.Size * 2;
+      CountPtr->Shift = Old.Shift - 1;
+   }
+
+   CountPtr->Codes  = (eSdbCode_t *) TTL_MALLOC( sizeof( eSdbCode_t ) * CountPtr->Size );
+   CountPtr->Counts = (Uint32_t *) TTL_CALLOC( CountPtr->Size, sizeof( Uint32_t ) );
+   if ( ( CountPtr->Codes == NULL ) || ( CountPtr->Counts == NULL ) )
+   {
+      TTL_FREE( CountPtr->Codes );
+      TTL_FREE( CountPtr->Counts );
+      *CountPtr = Old;
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   for ( i = 0; i < Old.Size; i++ )
+   {
+      if ( Old.Counts[ i ] != 0 )
+      {
+         Slot = (Uint32_t) ( Old.Codes[ i ] * M_STD_HASH_MULT ) >> CountPtr->Shift;
+         while ( CountPtr->Counts[ Slot ] != 0 )
+         {
+            Slot = ( Slot + 1 ) & ( CountPtr->Size - 1 );
+         }
+         CountPtr->Codes[ Slot ]  = Old.Codes[ i ];
+         CountPtr->Counts[ Slot ] = Old.Counts[ i ];
+      }
+   }
+
+   TTL_FREE( Old.Codes );
+   TTL_FREE( Old.Counts );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatHourFind
+**
+** Type:
+**    mStdCatHour_t *
+**
+** Purpose:
+**    Find an hour of the catalog.
+**
+** Description:
+**
+** Return type:
+**    mStdCatHour_t *
+**       The hour, or NULL if it isn't catalogued.
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr   (in)
+**       The catalog.
+**    Uint32_t       NumHours     (in)
+**       Hours at the start of the catalog's hours which are in order.
+**    Int32_t        Hour         (in)
+**       Hours since the epoch.
+**
+*****************************************************************************/
+static mStdCatHour_t *mStdCatHourFind( eStdCatalog_t *CatalogPtr,
+                                       Uint32_t NumHours,
+                                       Int32_t Hour )
+{
+   mStdCatHour_t Key;   /* Hour looked up */
+
+   Key.Entry.Hour = Hour;
+
+   return (mStdCatHour_t *) bsearch( &Key, CatalogPtr->Hours, NumHours,
+                                     sizeof( mStdCatHour_t ), mStdCompareHours );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatCodeFind
+**
+** Type:
+**    mStdCatCode_t *
+**
+** Purpose:
+**    Find a storage code of the catalog.
+**
+** Description:
+**
+** Return type:
+**    mStdCatCode_t *
+**       The code, or NULL if it isn't catalogued.
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr   (in)
+**       The catalog.
+**    eSdbCode_t     Code         (in)
+**       Storage code.
+**
+*****************************************************************************/
+static mStdCatCode_t *mStdCatCodeFind( eStdCatalog_t *CatalogPtr, eSdbCode_t Code )
+{
+   Uint32_t Low;    /* Bounds of the binary search */
+   Uint32_t High;
+   Uint32_t Mid;
+
+   Low  = 0;
+   High = CatalogPtr->Header.NumCodes;
+   while ( Low < High )
+   {
+      Mid = ( Low + High ) / 2;
+      if ( CatalogPtr->Codes[ Mid ].Entry.Code == Code )
+      {
+         return CatalogPtr->Codes + Mid;
+      }
+      if ( CatalogPtr->Codes[ Mid ].Entry.Code < Code )
+      {
+         Low = Mid + 1;
+      }
+      else
+      {
+         High = Mid;
+      }
+   }
+
+   return NULL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatCodeAdd
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find a storage code of the catalog, adding it if it isn't there.
+**
+** Description:
+**    The codes are kept in order. New codes are rare once the catalog
+**    has been started, so are inserted in place.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdCatalog_t  *CatalogPtr   (in/out)
+**       The catalog.
+**    eSdbCode_t      Code         (in)
+**       Storage code.
+**    mStdCatCode_t **CodePtr      (out)
+**       The code.
+**
+*****************************************************************************/
+static Status_t mStdCatCodeAdd( eStdCatalog_t  *CatalogPtr,
+                                eSdbCode_t      Code,
+                                mStdCatCode_t **CodePtr )
+{
+   mStdCatCode_t *NewPtr;   /* Codes extended */
+   Uint32_t       Low;      /* Bounds of the binary search */
+   Uint32_t       High;
+   Uint32_t       Mid;
+
+   *CodePtr = mStdCatCodeFind( CatalogPtr, Code );
+   if ( *CodePtr != NULL )
+   {
+      return SYS_NOMINAL;
+   }
+
+   if ( CatalogPtr->Header.NumCodes == CatalogPtr->MaxCodes )
+   {
+      NewPtr = (mStdCatCode_t *) TTL_REALLOC( CatalogPtr->Codes, sizeof( mStdCatCode_t ) *
+                                              ( CatalogPtr->MaxCodes * 2 + 256 ) );
+      if ( NewPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      CatalogPtr->Codes    = NewPtr;
+      CatalogPtr->MaxCodes = CatalogPtr->MaxCodes * 2 + 256;
+   }
+
+   Low  = 0;
+   High = CatalogPtr->Header.NumCodes;
+   while ( Low < High )
+   {
+      Mid = ( Low + High ) / 2;
+      if ( CatalogPtr->Codes[ Mid ].Entry.Code < Code )
+      {
+         Low = Mid + 1;
+      }
+      else
+      {
+         High = Mid;
+      }
+   }
+
+   memmove( CatalogPtr->Codes + Low + 1, CatalogPtr->Codes + Low,
+            sizeof( mStdCatCode_t ) * ( CatalogPtr->Header.NumCodes - Low ) );
+   CatalogPtr->Header.NumCodes++;
+
+   *CodePtr = CatalogPtr->Codes + Low;
+   memset( *CodePtr, 0, sizeof( mStdCatCode_t ) );
+   (*CodePtr)->Entry.Code = Code;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatSetAdd
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Add an hour to the hours holding a code.
+**
+** Description:
+**    A set is added for the span of hours if there is none yet. A list
+**    which grows past I_STD_CAT_MAX_LIST hours, when a bitmap becomes
+**    the smaller, is turned into a bitmap.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdCatCode_t *CodePtr    (in/out)
+**       The code.
+**    Int32_t        Hour       (in)
+**       Hours since the epoch.
+**    Bool_t        *AddedPtr   (out)
+**       Set if the hour wasn't already held.
+**
+*****************************************************************************/
+static Status_t mStdCatSetAdd( mStdCatCode_t *CodePtr, Int32_t Hour, Bool_t *AddedPtr )
+{
+   iStdCatSet_t *SetPtr;    /* Set of the hour's span */
+   iStdCatSet_t *NewPtr;    /* Sets extended */
+   Uint16_t     *ListPtr;   /* List extended */
+   Uint16_t      Key;       /* Span of the hour */
+   Uint16_t      Low16;     /* Hour within the span */
+   Uint32_t      Low;       /* Bounds of a binary search */
+   Uint32_t      High;
+   Uint32_t      Mid;
+   Uint32_t      i;         /* Set, or hour of a list */
+
+   *AddedPtr = FALSE;
+   Key   = (Uint16_t) ( (Uint32_t) Hour / I_STD_CAT_SPAN );
+   Low16 = (Uint16_t) ( (Uint32_t) Hour % I_STD_CAT_SPAN );
+
+   for ( i = 0; ( i < CodePtr->Entry.NumSets ) && ( CodePtr->Sets[ i ].Key < Key ); i++ )
+   {
+   }
+
+   if ( ( i == CodePtr->Entry.NumSets ) || ( CodePtr->Sets[ i ].Key != Key ) )
+   {
+      if ( CodePtr->Entry.NumSets == CodePtr->MaxSets )
+      {
+         NewPtr = (iStdCatSet_t *) TTL_REALLOC( CodePtr->Sets, sizeof( iStdCatSet_t ) *
+                                                ( CodePtr->MaxSets + 4 ) );
+         if ( NewPtr == NULL )
+         {
+            return E_STD_MEM_ALLOC_ERR;
+         }
+         CodePtr->Sets     = NewPtr;
+         CodePtr->MaxSets += 4;
+      }
+      memmove( CodePtr->Sets + i + 1, CodePtr->Sets + i,
+               sizeof( iStdCatSet_t ) * ( CodePtr->Entry.NumSets - i ) );
+      memset( CodePtr->Sets + i, 0, sizeof( iStdCatSet_t ) );
+      CodePtr->Sets[ i ].Key = Key;
+      CodePtr->Entry.NumSets++;
+   }
+   SetPtr = CodePtr->Sets + i;
+
+   if ( SetPtr->IsBitmap )
+   {
+      if ( ( SetPtr->Bitmap[ Low16 >> 5 ] & ( 1U << ( Low16 & 31 ) ) ) == 0 )
+      {
+         SetPtr->Bitmap[ Low16 >> 5 ] |= 1U << ( Low16 & 31 );
+         SetPtr->NumHours++;
+         *AddedPtr = TRUE;
+      }
+      return SYS_NOMINAL;
+   }
+
+   /* Hours mostly arrive in order, so look at the end of the list first */
+   Low  = 0;
+   High = SetPtr->NumHours;
+   if ( ( High > 0 ) && ( SetPtr->List[ High - 1 ] < Low16 ) )
+   {
+      Low = High;
+   }
+   while ( Low < High )
+   {
+      Mid = ( Low + High ) / 2;
+      if ( SetPtr->List[ Mid ] < Low16 )
+      {
+         Low = Mid + 1;
+      }
+      else
+      {
+         High = Mid;
+      }
+   }
+   if ( ( Low < SetPtr->NumHours ) && ( SetPtr->List[ Low ] == Low16 ) )
+   {
+      return SYS_NOMINAL;
+   }
+
+   if ( SetPtr->NumHours == I_STD_CAT_MAX_LIST )
+   {
+      SetPtr->Bitmap = (Uint32_t *) TTL_CALLOC( M_STD_BITMAP_WORDS, sizeof( Uint32_t ) );
+      if ( SetPtr->Bitmap == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      for ( i = 0; i < SetPtr->NumHours; i++ )
+      {
+         SetPtr->Bitmap[ SetPtr->List[ i ] >> 5 ] |= 1U << ( SetPtr->List[ i ] & 31 );
+      }
+      SetPtr->Bitmap[ Low16 >> 5 ] |= 1U << ( Low16 & 31 );
+      TTL_FREE( SetPtr->List );
+      SetPtr->List     = NULL;
+      SetPtr->MaxList  = 0;
+      SetPtr->IsBitmap = TRUE;
+      SetPtr->NumHours++;
+      *AddedPtr = TRUE;
+      return SYS_NOMINAL;
+   }
+
+   if ( SetPtr->NumHours == SetPtr->MaxList )
+   {
+      ListPtr = (Uint16_t *) TTL_REALLOC( SetPtr->List, sizeof( Uint16_t ) *
+                                          ( SetPtr->MaxList * 2 + 16 ) );
+      if ( ListPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      SetPtr->List     = ListPtr;
+      SetPtr->MaxList  = SetPtr->MaxList * 2 + 16;
+   }
+
+   memmove( SetPtr->List + Low + 1, SetPtr->List + Low,
+            sizeof( Uint16_t ) * ( SetPtr->NumHours - Low ) );
+   SetPtr->List[ Low ] = Low16;
+   SetPtr->NumHours++;
+   *AddedPtr = TRUE;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatSetNext
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Find the first hour holding a code, at or after an hour.
+**
+** Description:
+**
+** Return type:
+**    Bool_t
+**       FALSE if no hour at or after the hour holds the code.
+**
+** Arguments:
+**    mStdCatCode_t *CodePtr   (in)
+**       The code.
+**    Int32_t        Hour      (in)
+**       Hours since the epoch to search from.
+**    Int32_t       *NextPtr   (out)
+**       First hour found.
+**
+*****************************************************************************/
+static Bool_t mStdCatSetNext( mStdCatCode_t *CodePtr, Int32_t Hour, Int32_t *NextPtr )
+{
+   iStdCatSet_t *SetPtr;    /* Set being searched */
+   Uint32_t      Key;       /* Span of the hour */
+   Uint32_t      From;      /* First hour within the span searched */
+   Uint32_t      Low;       /* Bounds of a binary search */
+   Uint32_t      High;
+   Uint32_t      Mid;
+   Uint32_t      Word;      /* Bits of a bitmap from the hour searched */
+   Uint32_t      i;         /* Set */
+   Uint32_t      j;         /* Word of a bitmap */
+
+   if ( ( CodePtr->Entry.NumHours == 0 ) || ( Hour > CodePtr->Entry.LastHour ) )
+   {
+      return FALSE;
+   }
+
+   Key = (Uint32_t) Hour / I_STD_CAT_SPAN;
+   for ( i = 0; i < CodePtr->Entry.NumSets; i++ )
+   {
+      SetPtr = CodePtr->Sets + i;
+      if ( SetPtr->Key < Key )
+      {
+         continue;
+      }
+      From = SetPtr->Key == Key ? (Uint32_t) Hour % I_STD_CAT_SPAN : 0;
+
+      if ( SetPtr->IsBitmap )
+      {
+         Word = SetPtr->Bitmap[ From >> 5 ] & ( 0xffffffffU << ( From & 31 ) );
+         for ( j = From >> 5; ; )
+         {
+            if ( Word != 0 )
+            {
+               for ( From = 0; ( Word & 1U ) == 0; From++ )
+               {
+                  Word >>= 1;
+               }
+               *NextPtr = (Int32_t) ( SetPtr->Key * I_STD_CAT_SPAN + j * 32 + From );
+               return TRUE;
+            }
+            if ( ++j == M_STD_BITMAP_WORDS )
+            {
+               break;
+            }
+            Word = SetPtr->Bitmap[ j ];
+         }
+         continue;
+      }
+
+      Low  = 0;
+      High = SetPtr->NumHours;
+      while ( Low < High )
+      {
+         Mid = ( Low + High ) / 2;
+         if ( SetPtr->List[ Mid ] < From )
+         {
+            Low = Mid + 1;
+         }
+         else
+         {
+            High = Mid;
+         }
+      }
+      if ( Low < SetPtr->NumHours )
+      {
+         *NextPtr = (Int32_t) ( SetPtr->Key * I_STD_CAT_SPAN + SetPtr->List[ Low ] );
+         return TRUE;
+      }
+   }
+
+   return FALSE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCatPath
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Generate the path of a file in the archive.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdCatalog_t *CatalogPtr   (in)
+**       The catalog.
+**    char          *NamePtr      (in)
+**       Name of the file within the archive.
+**    char          *FilePtr      (out)
+**       Path of the file, FILENAME_MAX characters.
+**
+*****************************************************************************/
+static void mStdCatPath( eStdCatalog_t *CatalogPtr, char *NamePtr, char *FilePtr )
+{
+   size_t Len;   /* Length of the archive's name */
+
+   Len = strlen( CatalogPtr->Names );
+   if ( Len + strlen( NamePtr ) + 2 > FILENAME_MAX )
+   {
+      FilePtr[ 0 ] = '\0';
+      return;
+   }
+
+   sprintf( FilePtr, "%s%s%s", CatalogPtr->Names,
+            ( Len > 0 ) && ( CatalogPtr->Names[ Len - 1 ] == '/' ) ? "" : "/", NamePtr );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCompareFiles
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order the files found in an archive.
+**
+** Description:
+**    Used with qsort. Files are ordered by hour, plain before compressed,
+**    then by name so that the order does not depend on the directories.
+**    Within a directory a .sdb.bgz file so comes before its .sdb.gz.
+**
+** Return type:
+**    int
+**       Negative, zero or positive as the first file comes before, with
+**       or after the second.
+**
+** Arguments:
+**    const void *FirstPtr    (in)
+**    const void *SecondPtr   (in)
+**       Files compared.
+**
+*****************************************************************************/
+static int mStdCompareFiles( const void *FirstPtr, const void *SecondPtr )
+{
+   const mStdCatFile_t *First;    /* The first file */
+   const mStdCatFile_t *Second;   /* The second file */
+
+   First  = (const mStdCatFile_t *) FirstPtr;
+   Second = (const mStdCatFile_t *) SecondPtr;
+
+   if ( First->Hour != Second->Hour )
+   {
+      return First->Hour < Second->Hour ? -1 : 1;
+   }
+   if ( First->Gzipped != Second->Gzipped )
+   {
+      return First->Gzipped == FALSE ? -1 : 1;
+   }
+
+   return strcmp( First->Name, Second->Name );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCompareHours
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order the hours of a catalog.
+**
+** Description:
+**    Used with qsort and bsearch.
+**
+** Return type:
+**    int
+**       Negative, zero or positive as the first hour is before, the same
+**       as or after the second.
+**
+** Arguments:
+**    const void *FirstPtr    (in)
+**    const void *SecondPtr   (in)
+**       Hours compared.
+**
+*****************************************************************************/
+static int mStdCompareHours( const void *FirstPtr, const void *SecondPtr )
+{
+   Int32_t First;    /* Hour of the first entry */
+   Int32_t Second;   /* Hour of the second entry */
+
+   First  = ( (const mStdCatHour_t *) FirstPtr )->Entry.Hour;
+   Second = ( (const mStdCatHour_t *) SecondPtr )->Entry.Hour;
+
+   if ( First < Second )
+   {
+      return -1;
+   }
+
+   return First > Second ? 1 : 0;
+}
+
+/* EOF */
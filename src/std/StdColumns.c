@@ -0,0 +1,1598 @@
+/*****************************************************************************
+** Module Name:
+**     StdColumns.c
+**
+** Purpose:
+**     Columnar archive of Sdb data, so that a long search for a few
+**     source/datum pairs reads only the records of those pairs.
+**
+** Description:
+**     The hourly Sdb files interleave the records of every storage code, so
+**     a search for one code over a month must read every record of every
+**     hour. The columnar archive holds a file per day, "yymmdd.col", in
+**     which the records of each code are stored together, series after
+**     series, as a chunk per hour. A directory at the start of the file
+**     lists the chunks of each code, so a search reads the directory and
+**     then only the chunks of the codes it wants.
+**
+**     Within a chunk the records keep their order in the hour's Sdb file.
+**     Their TimeOffsets are held as the first, the first difference and
+**     then the differences between successive differences, which are
+**     mostly zero for data submitted at a steady rate. Their values are
+**     held as the first and then either the differences between
+**     successive values or their exclusive or, whichever is the smaller.
+**     Signed numbers are zigzag encoded, and every number is written as
+**     a varint of 7 bits per byte.
+**
+**     A day is converted from its Sdb files, of any format, once it ended
+**     I_STD_CAT_SETTLE seconds ago, see eStdColumnsBuild. A search then
+**     reads the day's file in place of its Sdb files, see
+**     eStdReaderColumns, and the Sdb files of days not converted as
+**     usual.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_COL_CHUNK    65536    /* Records read at once when converting */
+#define M_STD_COL_MIN      4096     /* Records of an hour allowed for initially */
+#define M_STD_VARINT_MAX   5        /* Longest varint of 32 bits */
+#define M_STD_NAME_LEN     10       /* Length of "yymmdd.col" */
+
+/* Zigzag encoding of a 32 bit difference, taken as signed */
+#define M_STD_ZIGZAG( Diff ) \
+   ( ( (Uint32_t) (Diff) << 1 ) ^ ( ( (Uint32_t) (Diff) & 0x80000000U ) ? 0xFFFFFFFFU : 0U ) )
+
+/* The difference encoded by M_STD_ZIGZAG */
+#define M_STD_UNZIGZAG( Code ) \
+   ( ( (Uint32_t) (Code) >> 1 ) ^ ( 0U - ( (Uint32_t) (Code) & 1U ) ) )
+
+/* A day of the archive, loaded when first searched */
+typedef struct mStdColDay_s
+{
+   Int32_t          Key;       /* yymmdd of the day */
+   Bool_t           Present;   /* The day has been converted */
+   iStdColHeader_t  Header;    /* Header of its file */
+   iStdColHour_t   *Hours;     /* Its hours */
+   iStdColCode_t   *Codes;     /* Its storage codes, in order */
+   iStdColChunk_t  *Chunks;    /* Its chunks, in the order of its codes */
+   long             DataStart; /* Offset of the chunks' data in its file */
+} mStdColDay_t;
+
+/* Everything held of a columnar archive */
+struct eStdColumns_s
+{
+   char             Dir[ FILENAME_MAX ]; /* Directory holding the days */
+   mStdColDay_t   **Days;      /* Days loaded so far */
+   Uint32_t         NumDays;   /* Number of days loaded */
+   Uint32_t         MaxDays;   /* Days there is room for */
+   pthread_mutex_t  Lock;      /* Guards the days while one is loaded */
+};
+
+/* A record of a day being converted */
+typedef struct mStdColRecord_s
+{
+   eSdbCode_t       Code;      /* Storage code */
+   Uint32_t         Sequence;  /* Position in its hour's Sdb file */
+   Uint32_t         TimeOffset;
+   Int32_t          Value;
+} mStdColRecord_t;
+
+/* A chunk of a day being converted, with its data in its hour's buffer */
+typedef struct mStdColPiece_s
+{
+   eSdbCode_t       Code;      /* Storage code */
+   Uint32_t         From;      /* Offset of its data in the hour's buffer */
+   iStdColChunk_t   Chunk;     /* Entry to be written */
+} mStdColPiece_t;
+
+/* Encoded data, growing as chunks are added */
+typedef struct mStdColBuffer_s
+{
+   unsigned char   *Data;
+   Uint32_t         Size;      /* Bytes in use */
+   Uint32_t         Max;       /* Bytes there is room for */
+} mStdColBuffer_t;
+
+/* Local function prototypes */
+static Int32_t  mStdColDayOf ( Int32_t Time, Int32_t *StartPtr );
+static void     mStdColFileName ( char *DirPtr, Int32_t Key, char *FilePtr );
+static Status_t mStdColReadHour ( char *, Int32_t, mStdColRecord_t **, Uint32_t *, Uint32_t *, iStdColHour_t * );
+static Status_t mStdColEncode ( mStdColRecord_t *, Uint32_t, mStdColBuffer_t *, Uint32_t * );
+static Status_t mStdColDecode ( unsigned char *, iStdColChunk_t *, eSdbCode_t, eSdbRawFmt_t * );
+static Status_t mStdColRoom ( mStdColBuffer_t *BufferPtr, Uint32_t Size );
+static void     mStdColPutVarint ( mStdColBuffer_t *BufferPtr, Uint32_t Value );
+static Bool_t   mStdColGetVarint ( unsigned char **DataPtr, unsigned char *EndPtr, Uint32_t *ValuePtr );
+static Uint32_t mStdColVarintSize ( Uint32_t Value );
+static Status_t mStdColWrite ( char *, iStdColHeader_t *, iStdColHour_t *, mStdColPiece_t *, mStdColBuffer_t * );
+static Status_t mStdColFindDay ( eStdColumns_t *ColumnsPtr, Int32_t Key, mStdColDay_t **DayPtr );
+static void     mStdColLoadDay ( eStdColumns_t *ColumnsPtr, mStdColDay_t *DayPtr );
+static void     mStdColFreeDay ( mStdColDay_t *DayPtr );
+static int      mStdCompareRecords ( const void *FirstPtr, const void *SecondPtr );
+static int      mStdComparePieces ( const void *FirstPtr, const void *SecondPtr );
+static int      mStdCompareCodes ( const void *FirstPtr, const void *SecondPtr );
+
+/*****************************************************************************
+** Function Name:
+**    eStdColumnsBuild
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Convert a day of Sdb files to the columnar archive.
+**
+** Description:
+**    Reads the Sdb file of each hour of the day in turn, plain, gzipped
+**    or block-structured, and encodes the records of each storage code
+**    found as a chunk. The chunks are then written to the day's file,
+**    those of each code together. Only one hour's records are held at
+**    once, besides the chunks. The file is written to a temporary file
+**    which replaces any existing file of the day once complete, so a
+**    search never sees a partly written day. A day is only converted
+**    once it ended I_STD_CAT_SETTLE seconds ago, as its last Sdb file
+**    may be written until then.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_TIME_OUT_RANGE if the day
+**       has not ended, E_STD_READ_DATA_ERR if an Sdb file could not be
+**       read, E_STD_FILE_WRITE_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char       *ColumnDirPtr   (in)
+**       Directory holding the columnar archive.
+**    char       *ArchivePtr     (in)
+**       Directory holding the Sdb files, as given to eStdReaderOpen.
+**    eTtlTime_t  Day            (in)
+**       Any time of the day.
+**    Uint32_t   *NumCodesPtr    (out)
+**       Number of storage codes found.
+**    Uint32_t   *NumRecordsPtr  (out)
+**       Number of records converted.
+**
+*****************************************************************************/
+Status_t eStdColumnsBuild( char *ColumnDirPtr,
+                           char *ArchivePtr,
+                           eTtlTime_t Day,
+                           Uint32_t *NumCodesPtr,
+                           Uint32_t *NumRecordsPtr )
+{
+   Status_t         Status;        /* Return value of function calls */
+   iStdColHeader_t  Header;        /* Header of the day's file */
+   iStdColHour_t    Hours[ I_STD_COL_MAX_HOURS ];  /* Hours of the day */
+   mStdColBuffer_t  Buffers[ I_STD_COL_MAX_HOURS ]; /* Chunks of each hour */
+   mStdColRecord_t *RecordsPtr;    /* Records of an hour */
+   Uint32_t         MaxRecords;    /* Records there is room for */
+   Uint32_t         NumRecords;    /* Records of the hour */
+   mStdColPiece_t  *PiecesPtr;     /* Chunks of the day */
+   mStdColPiece_t  *NewPiecesPtr;  /* Chunks once more room is made */
+   Uint32_t         MaxPieces;     /* Chunks there is room for */
+   Uint32_t         NumPieces;     /* Chunks of the day */
+   char             File[ FILENAME_MAX ]; /* Name of the day's file */
+   Int32_t          Key;           /* yymmdd of the day */
+   Int32_t          Start;         /* Start of the day */
+   Uint32_t         h;             /* Hour of the day */
+   Uint32_t         i;             /* Record of the hour */
+   Uint32_t         j;             /* Record following a code's records */
+
+   *NumCodesPtr   = 0;
+   *NumRecordsPtr = 0;
+
+   if ( strlen( ColumnDirPtr ) + M_STD_NAME_LEN + 2 > FILENAME_MAX )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   /* A day has one hour more, or less, when the clocks change */
+   Key = mStdColDayOf( Day.t_sec, &Start );
+   memset( &Header, 0, sizeof( Header ) );
+   memcpy( Header.Magic, I_STD_COL_MAGIC, 4 );
+   Header.Version = I_STD_COL_VERSION;
+   Header.Start   = Start;
+   while ( ( Header.NumHours < I_STD_COL_MAX_HOURS ) &&
+           ( mStdColDayOf( Start + (Int32_t) Header.NumHours * E_STD_SECONDS_PER_HOUR,
+                           NULL ) == Key ) )
+   {
+      Header.NumHours++;
+   }
+
+   mStdColFileName( ColumnDirPtr, Key, File );
+   if ( (Int32_t) time( NULL ) < Start + (Int32_t) Header.NumHours * E_STD_SECONDS_PER_HOUR
+                                 + I_STD_CAT_SETTLE )
+   {
+      eLogErr(E_STD_TIME_OUT_RANGE,"Day of %s has not yet ended", File);
+      return E_STD_TIME_OUT_RANGE;
+   }
+
+   memset( Hours, 0, sizeof( Hours ) );
+   memset( Buffers, 0, sizeof( Buffers ) );
+   RecordsPtr = NULL;
+   MaxRecords = 0;
+   PiecesPtr  = NULL;
+   MaxPieces  = 0;
+   NumPieces  = 0;
+   Status     = SYS_NOMINAL;
+
+   for ( h = 0; ( h < Header.NumHours ) && ( Status == SYS_NOMINAL ); h++ )
+   {
+      Hours[ h ].Hour = Start + (Int32_t) h * E_STD_SECONDS_PER_HOUR;
+      Status = mStdColReadHour( ArchivePtr, Hours[ h ].Hour, &RecordsPtr,
+                                &MaxRecords, &NumRecords, Hours + h );
+      if ( ( Status != SYS_NOMINAL ) || ( NumRecords == 0 ) )
+      {
+         continue;
+      }
+
+      /* Gather the records of each code, keeping their order */
+      qsort( RecordsPtr, NumRecords, sizeof( mStdColRecord_t ), mStdCompareRecords );
+
+      for ( i = 0; ( i < NumRecords ) && ( Status == SYS_NOMINAL ); i = j )
+      {
+         for ( j = i + 1; ( j < NumRecords ) && ( RecordsPtr[ j ].Code == RecordsPtr[ i ].Code ); j++ )
+         {
+         }
+
+         if ( NumPieces == MaxPieces )
+         {
+            MaxPieces    = MaxPieces == 0 ? M_STD_COL_MIN : MaxPieces * 2;
+            NewPiecesPtr = (mStdColPiece_t *) TTL_REALLOC( PiecesPtr,
+                                                           sizeof( mStdColPiece_t ) * MaxPieces );
+            if ( NewPiecesPtr == NULL )
+            {
+               Status = E_STD_MEM_ALLOC_ERR;
+               break;
+            }
+            PiecesPtr = NewPiecesPtr;
+         }
+
+         memset( PiecesPtr + NumPieces, 0, sizeof( mStdColPiece_t ) );
+         PiecesPtr[ NumPieces ].Code             = RecordsPtr[ i ].Code;
+         PiecesPtr[ NumPieces ].From             = Buffers[ h ].Size;
+         PiecesPtr[ NumPieces ].Chunk.Hour       = h;
+         PiecesPtr[ NumPieces ].Chunk.NumRecords = j - i;
+         Status = mStdColEncode( RecordsPtr + i, j - i, Buffers + h,
+                                 &(PiecesPtr[ NumPieces ].Chunk.Encoding) );
+         PiecesPtr[ NumPieces ].Chunk.Size = Buffers[ h ].Size - PiecesPtr[ NumPieces ].From;
+         NumPieces++;
+      }
+
+      Header.NumRecords += NumRecords;
+   }
+
+   TTL_FREE( RecordsPtr );
+
+   if ( Status == SYS_NOMINAL )
+   {
+      /* Each code's chunks follow one another, in order of hour */
+      if ( NumPieces > 0 )
+      {
+         qsort( PiecesPtr, NumPieces, sizeof( mStdColPiece_t ), mStdComparePieces );
+      }
+      Header.NumChunks = NumPieces;
+      for ( i = 0; i < NumPieces; i++ )
+      {
+         if ( ( i == 0 ) || ( PiecesPtr[ i ].Code != PiecesPtr[ i - 1 ].Code ) )
+         {
+            Header.NumCodes++;
+         }
+         PiecesPtr[ i ].Chunk.Offset = Header.DataSize;
+         Header.DataSize += PiecesPtr[ i ].Chunk.Size;
+      }
+
+      Status = mStdColWrite( File, &Header, Hours, PiecesPtr, Buffers );
+   }
+
+   if ( Status == SYS_NOMINAL )
+   {
+      *NumCodesPtr   = Header.NumCodes;
+      *NumRecordsPtr = Header.NumRecords;
+   }
+
+   for ( h = 0; h < I_STD_COL_MAX_HOURS; h++ )
+   {
+      TTL_FREE( Buffers[ h ].Data );
+   }
+   TTL_FREE( PiecesPtr );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdColumnsOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Start using a columnar archive.
+**
+** Description:
+**    Nothing is read until a day is searched, when its directory is read
+**    and kept until the archive is closed. The archive may be shared by
+**    any number of readers and threads, see eStdReaderColumns, until
+**    closed with eStdColumnsClose.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if there is no
+**       such directory, E_STD_THREAD_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char           *ColumnDirPtr   (in)
+**       Directory holding the columnar archive.
+**    eStdColumns_t **ColumnsPtr     (out)
+**       The archive.
+**
+*****************************************************************************/
+Status_t eStdColumnsOpen( char *ColumnDirPtr,
+                          eStdColumns_t **ColumnsPtr )
+{
+   eStdColumns_t *NewPtr;   /* Archive being opened */
+   struct stat    Stat;     /* The directory */
+
+   *ColumnsPtr = NULL;
+
+   if ( ( strlen( ColumnDirPtr ) + M_STD_NAME_LEN + 2 > FILENAME_MAX ) ||
+        ( stat( ColumnDirPtr, &Stat ) != 0 ) || !S_ISDIR( Stat.st_mode ) )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to open directory %s", ColumnDirPtr);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   NewPtr = (eStdColumns_t *) TTL_CALLOC( 1, sizeof( eStdColumns_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if ( pthread_mutex_init( &(NewPtr->Lock), NULL ) != 0 )
+   {
+      TTL_FREE( NewPtr );
+      return E_STD_THREAD_ERR;
+   }
+
+   strcpy( NewPtr->Dir, ColumnDirPtr );
+   *ColumnsPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdColumnsClose
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Finish with a columnar archive.
+**
+** Description:
+**    No reader may still be using the archive.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdColumns_t *ColumnsPtr   (in)
+**       The archive, which may be NULL.
+**
+*****************************************************************************/
+Status_t eStdColumnsClose( eStdColumns_t *ColumnsPtr )
+{
+   Uint32_t i;   /* Day */
+
+   if ( ColumnsPtr == NULL )
+   {
+      return SYS_NOMINAL;
+   }
+
+   for ( i = 0; i < ColumnsPtr->NumDays; i++ )
+   {
+      mStdColFreeDay( ColumnsPtr->Days[ i ] );
+   }
+
+   pthread_mutex_destroy( &(ColumnsPtr->Lock) );
+   TTL_FREE( ColumnsPtr->Days );
+   TTL_FREE( ColumnsPtr );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdColumnsHour
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the records of an hour wanted from a columnar archive.
+**
+** Description:
+**    If the day of the hour has been converted, the chunks of the hour
+**    of each code wanted are read from the day's file and decoded. Codes
+**    absent from the hour, and an hour with no Sdb file, give no records.
+**    The day's file is kept open by the reader for its next hour.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR or
+**       E_STD_READ_DATA_ERR if the day's file could not be read or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdColumns_t *ColumnsPtr   (in)
+**       The archive.
+**    Int32_t        Hour         (in)
+**       Start of the hour.
+**    eSdbCode_t    *CodesPtr     (in)
+**       Storage codes wanted.
+**    size_t         NumCodes     (in)
+**       Number of codes wanted.
+**    iStdColRead_t *ReadPtr      (in/out)
+**       The reader's records of the hour, and day's file.
+**    Bool_t        *CoveredPtr   (out)
+**       Set if the hour's day has been converted, when its records are
+**       those read, otherwise they are to be read from its Sdb file.
+**
+*****************************************************************************/
+Status_t iStdColumnsHour( eStdColumns_t *ColumnsPtr,
+                          Int32_t Hour,
+                          eSdbCode_t *CodesPtr,
+                          size_t NumCodes,
+                          iStdColRead_t *ReadPtr,
+                          Bool_t *CoveredPtr )
+{
+   Status_t         Status;       /* Return value of function calls */
+   mStdColDay_t    *DayPtr;       /* The hour's day */
+   iStdColCode_t   *EntryPtr;     /* Code wanted, if present */
+   iStdColCode_t    Key;          /* Code looked up */
+   iStdColChunk_t  *ChunkPtr;     /* The code's chunk of the hour */
+   eSdbRawFmt_t    *NewRecordsPtr; /* Records once more room is made */
+   unsigned char   *NewChunkPtr;  /* Chunk once more room is made */
+   char             File[ FILENAME_MAX ]; /* Name of the day's file */
+   Int32_t          DayKey;       /* yymmdd of the day */
+   Uint32_t         h;            /* Hour of the day */
+   Uint32_t         j;            /* Chunk of the code */
+   size_t           i;            /* Code wanted */
+
+   *CoveredPtr          = FALSE;
+   ReadPtr->NumRecords  = 0;
+   ReadPtr->NextRecord  = 0;
+
+   DayKey = mStdColDayOf( Hour, NULL );
+   Status = mStdColFindDay( ColumnsPtr, DayKey, &DayPtr );
+   if ( ( Status != SYS_NOMINAL ) || ( DayPtr->Present == FALSE ) )
+   {
+      return Status;
+   }
+
+   for ( h = 0; h < DayPtr->Header.NumHours; h++ )
+   {
+      if ( ( Hour >= DayPtr->Hours[ h ].Hour ) &&
+           ( Hour < DayPtr->Hours[ h ].Hour + E_STD_SECONDS_PER_HOUR ) )
+      {
+         break;
+      }
+   }
+   if ( h == DayPtr->Header.NumHours )
+   {
+      return SYS_NOMINAL;
+   }
+
+   *CoveredPtr       = TRUE;
+   ReadPtr->TimeHour = DayPtr->Hours[ h ].TimeHour;
+   if ( DayPtr->Hours[ h ].Present == 0 )
+   {
+      return SYS_NOMINAL;
+   }
+
+   mStdColFileName( ColumnsPtr->Dir, DayKey, File );
+   if ( ( ReadPtr->DayFile != NULL ) && ( ReadPtr->Day != DayKey ) )
+   {
+      fclose( ReadPtr->DayFile );
+      ReadPtr->DayFile = NULL;
+   }
+   if ( ReadPtr->DayFile == NULL )
+   {
+      if ( ( ReadPtr->DayFile = fopen( File, "rb" ) ) == NULL )
+      {
+         eLogErr(E_STD_FILE_OPEN_ERR,"Unable to open file %s", File);
+         return E_STD_FILE_OPEN_ERR;
+      }
+      ReadPtr->Day = DayKey;
+   }
+
+   for ( i = 0; i < NumCodes; i++ )
+   {
+      Key.Code = CodesPtr[ i ];
+      EntryPtr = (iStdColCode_t *) bsearch( &Key, DayPtr->Codes, DayPtr->Header.NumCodes,
+                                            sizeof( iStdColCode_t ), mStdCompareCodes );
+      if ( EntryPtr == NULL )
+      {
+         continue;
+      }
+
+      ChunkPtr = NULL;
+      for ( j = 0; j < EntryPtr->NumChunks; j++ )
+      {
+         if ( DayPtr->Chunks[ EntryPtr->FirstChunk + j ].Hour == h )
+         {
+            ChunkPtr = DayPtr->Chunks + EntryPtr->FirstChunk + j;
+            break;
+         }
+      }
+      if ( ChunkPtr == NULL )
+      {
+         continue;
+      }
+
+      /* Make room for the chunk and its records */
+      if ( ReadPtr->NumRecords + ChunkPtr->NumRecords > ReadPtr->MaxRecords )
+      {
+         NewRecordsPtr = (eSdbRawFmt_t *) TTL_REALLOC( ReadPtr->Records,
+                            sizeof( eSdbRawFmt_t ) * ( ReadPtr->NumRecords + ChunkPtr->NumRecords ) );
+         if ( NewRecordsPtr == NULL )
+         {
+            return E_STD_MEM_ALLOC_ERR;
+         }
+         ReadPtr->Records    = NewRecordsPtr;
+         ReadPtr->MaxRecords = ReadPtr->NumRecords + ChunkPtr->NumRecords;
+      }
+      if ( ChunkPtr->Size > ReadPtr->ChunkMax )
+      {
+         NewChunkPtr = (unsigned char *) TTL_REALLOC( ReadPtr->ChunkPtr, ChunkPtr->Size );
+         if ( NewChunkPtr == NULL )
+         {
+            return E_STD_MEM_ALLOC_ERR;
+         }
+         ReadPtr->ChunkPtr = NewChunkPtr;
+         ReadPtr->ChunkMax = ChunkPtr->Size;
+      }
+
+      if ( ( fseek( ReadPtr->DayFile, DayPtr->DataStart + (long) ChunkPtr->Offset,
+                    SEEK_SET ) != 0 ) ||
+           ( fread( ReadPtr->ChunkPtr, 1, ChunkPtr->Size, ReadPtr->DayFile )
+             != ChunkPtr->Size ) ||
+           ( mStdColDecode( ReadPtr->ChunkPtr, ChunkPtr, EntryPtr->Code,
+                            ReadPtr->Records + ReadPtr->NumRecords ) != SYS_NOMINAL ) )
+      {
+         eLogErr(E_STD_READ_DATA_ERR,"Unable to read file %s", File);
+         return E_STD_READ_DATA_ERR;
+      }
+      ReadPtr->NumRecords += ChunkPtr->NumRecords;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdColReadFree
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Finish with a reader's records from a columnar archive.
+**
+** Description:
+**    Closes the day's file and frees the records and chunk. The state
+**    may then be used again.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdColRead_t *ReadPtr   (in/out)
+**       The reader's records and day's file.
+**
+*****************************************************************************/
+void iStdColReadFree( iStdColRead_t *ReadPtr )
+{
+   if ( ReadPtr->DayFile != NULL )
+   {
+      fclose( ReadPtr->DayFile );
+   }
+   TTL_FREE( ReadPtr->Records );
+   TTL_FREE( ReadPtr->ChunkPtr );
+   memset( ReadPtr, 0, sizeof( *ReadPtr ) );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColDayOf
+**
+** Type:
+**    Int32_t
+**
+** Purpose:
+**    Find the day of a time.
+**
+** Description:
+**    Days are those of local time, as are the names of Sdb files.
+**
+** Return type:
+**    Int32_t
+**       The day, as the number yymmdd.
+**
+** Arguments:
+**    Int32_t  Time        (in)
+**       Seconds since the epoch.
+**    Int32_t *StartPtr    (out)
+**       Start of the day, or NULL if not wanted.
+**
+*****************************************************************************/
+static Int32_t mStdColDayOf( Int32_t Time, Int32_t *StartPtr )
+{
+   time_t    Seconds;   /* The time */
+   struct tm Tm;        /* Broken down time */
+
+   /* Reentrantly, as readers may be in any thread */
+   Seconds = (time_t) Time;
+   localtime_r( &Seconds, &Tm );
+
+   if ( StartPtr != NULL )
+   {
+      Tm.tm_hour  = 0;
+      Tm.tm_min   = 0;
+      Tm.tm_sec   = 0;
+      Tm.tm_isdst = -1;
+      *StartPtr   = (Int32_t) mktime( &Tm );
+   }
+
+   return ( Tm.tm_year % 100 ) * 10000 + ( Tm.tm_mon + 1 ) * 100 + Tm.tm_mday;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColFileName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Generate the name of the file of a day of a columnar archive.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    char    *DirPtr      (in)
+**       Directory holding the archive.
+**    Int32_t  Key         (in)
+**       The day, as yymmdd.
+**    char    *FilePtr     (out)
+**       Name of the day's file, FILENAME_MAX characters.
+**
+*****************************************************************************/
+static void mStdColFileName( char *DirPtr, Int32_t Key, char *FilePtr )
+{
+   size_t Len;   /* Length of the directory */
+
+   strcpy( FilePtr, DirPtr );
+   Len = strlen( FilePtr );
+   if ( ( Len > 0 ) && ( FilePtr[ Len - 1 ] != '/' ) )
+   {
+      FilePtr[ Len++ ] = '/';
+   }
+   sprintf( FilePtr + Len, "%.6ld.%s", (long) Key, I_STD_EXT_COLUMNS );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColReadHour
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read every record of an hour's Sdb file.
+**
+** Description:
+**    The file is read by a reader of its own, so any file a search would
+**    read may be converted. Each record is numbered with its position in
+**    the file. There are no records if the hour has no Sdb file.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_READ_DATA_ERR or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char             *ArchivePtr     (in)
+**       Directory holding the Sdb files.
+**    Int32_t           Hour           (in)
+**       Start of the hour.
+**    mStdColRecord_t **RecordsPtr     (in/out)
+**       Records read, reallocated as needed.
+**    Uint32_t         *MaxRecordsPtr  (in/out)
+**       Records there is room for.
+**    Uint32_t         *NumRecordsPtr  (out)
+**       Records read.
+**    iStdColHour_t    *HourPtr        (out)
+**       The hour's entry, given its time stamp and number of records.
+**
+*****************************************************************************/
+static Status_t mStdColReadHour( char *ArchivePtr,
+                                 Int32_t Hour,
+                                 mStdColRecord_t **RecordsPtr,
+                                 Uint32_t *MaxRecordsPtr,
+                                 Uint32_t *NumRecordsPtr,
+                                 iStdColHour_t *HourPtr )
+{
+   Status_t         Status;         /* Return value of function calls */
+   eStdReader_t    *ReaderPtr;      /* Reader of the hour's file */
+   eTtlTime_t       HourStart;      /* Start of the hour */
+   eTtlTime_t       HourEnd;        /* End of the hour */
+   eTtlTime_t       TimeHour;       /* Time stamp of the file */
+   eSdbRawFmt_t    *SdbDataPtr;     /* Records returned */
+   eSdbRawFmt_t     Zero;           /* Record at the time stamp */
+   mStdColRecord_t *NewRecordsPtr;  /* Records once more room is made */
+   size_t           NumRead;        /* Records returned at once */
+   size_t           i;              /* Record returned */
+   Bool_t           Finished;       /* Hour read */
+
+   *NumRecordsPtr = 0;
+
+   HourStart.t_sec  = Hour;
+   HourStart.t_nsec = 0;
+   HourEnd.t_sec    = Hour + E_STD_SECONDS_PER_HOUR - 1;
+   HourEnd.t_nsec   = 0;
+
+   Status = eStdReaderOpen( HourStart, HourEnd, ArchivePtr, &ReaderPtr );
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = eStdReaderChunk( ReaderPtr, M_STD_COL_CHUNK );
+   }
+
+   Finished = FALSE;
+   while ( ( Status == SYS_NOMINAL ) && ( Finished == FALSE ) )
+   {
+      Status = eStdReaderNext( ReaderPtr, &SdbDataPtr, &NumRead, &Finished );
+      if ( ( Status != SYS_NOMINAL ) || ( NumRead == 0 ) )
+      {
+         continue;
+      }
+
+      if ( *NumRecordsPtr + NumRead > *MaxRecordsPtr )
+      {
+         *MaxRecordsPtr = *MaxRecordsPtr == 0 ? M_STD_COL_MIN : *MaxRecordsPtr;
+         while ( *NumRecordsPtr + NumRead > *MaxRecordsPtr )
+         {
+            *MaxRecordsPtr *= 2;
+         }
+         NewRecordsPtr = (mStdColRecord_t *) TTL_REALLOC( *RecordsPtr,
+                            sizeof( mStdColRecord_t ) * *MaxRecordsPtr );
+         if ( NewRecordsPtr == NULL )
+         {
+            Status = E_STD_MEM_ALLOC_ERR;
+            break;
+         }
+         *RecordsPtr = NewRecordsPtr;
+      }
+
+      for ( i = 0; i < NumRead; i++ )
+      {
+         (*RecordsPtr)[ *NumRecordsPtr ].Code       = SdbDataPtr[ i ].Code;
+         (*RecordsPtr)[ *NumRecordsPtr ].Sequence   = *NumRecordsPtr;
+         (*RecordsPtr)[ *NumRecordsPtr ].TimeOffset = SdbDataPtr[ i ].TimeOffset;
+         (*RecordsPtr)[ *NumRecordsPtr ].Value      = SdbDataPtr[ i ].Value;
+         (*NumRecordsPtr)++;
+      }
+
+      /* The time stamp of the file, which the TimeOffsets follow */
+      memset( &Zero, 0, sizeof( Zero ) );
+      eStdReaderTime( ReaderPtr, &Zero, &TimeHour );
+      HourPtr->TimeHour = TimeHour.t_sec;
+   }
+
+   eStdReaderClose( ReaderPtr );
+
+   if ( Status != SYS_NOMINAL )
+   {
+      eLogErr(E_STD_READ_DATA_ERR,"Unable to convert hour of %s", ArchivePtr);
+      return E_STD_READ_DATA_ERR;
+   }
+
+   HourPtr->NumRecords = *NumRecordsPtr;
+   HourPtr->Present    = *NumRecordsPtr > 0 ? 1 : 0;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColEncode
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Encode the records of a code in an hour as a chunk.
+**
+** Description:
+**    The TimeOffsets are written, followed by the values, see the
+**    description of this module. The values are encoded by difference
+**    or by exclusive or, whichever takes fewer bytes.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdColRecord_t *RecordsPtr    (in)
+**       The records, in order.
+**    Uint32_t         NumRecords    (in)
+**       Number of records, at least one.
+**    mStdColBuffer_t *BufferPtr     (in/out)
+**       Buffer the chunk is added to.
+**    Uint32_t        *EncodingPtr   (out)
+**       I_STD_COL_DELTA or I_STD_COL_XOR, as used for the values.
+**
+*****************************************************************************/
+static Status_t mStdColEncode( mStdColRecord_t *RecordsPtr,
+                               Uint32_t NumRecords,
+                               mStdColBuffer_t *BufferPtr,
+                               Uint32_t *EncodingPtr )
+{
+   Status_t Status;      /* Return value of function calls */
+   Uint32_t DeltaSize;   /* Bytes of values encoded by difference */
+   Uint32_t XorSize;     /* Bytes of values encoded by exclusive or */
+   Uint32_t Diff;        /* Difference from the previous TimeOffset */
+   Uint32_t LastDiff;    /* Previous difference */
+   Uint32_t i;           /* Record */
+
+   Status = mStdColRoom( BufferPtr, 2 * M_STD_VARINT_MAX * NumRecords );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   DeltaSize = 0;
+   XorSize   = 0;
+   for ( i = 1; i < NumRecords; i++ )
+   {
+      DeltaSize += mStdColVarintSize( M_STD_ZIGZAG( (Uint32_t) RecordsPtr[ i ].Value -
+                                                    (Uint32_t) RecordsPtr[ i - 1 ].Value ) );
+      XorSize   += mStdColVarintSize( (Uint32_t) RecordsPtr[ i ].Value ^
+                                      (Uint32_t) RecordsPtr[ i - 1 ].Value );
+   }
+   *EncodingPtr = XorSize < DeltaSize ? I_STD_COL_XOR : I_STD_COL_DELTA;
+
+   /* TimeOffsets, by the differences between successive differences */
+   mStdColPutVarint( BufferPtr, RecordsPtr[ 0 ].TimeOffset );
+   LastDiff = 0;
+   for ( i = 1; i < NumRecords; i++ )
+   {
+      Diff = RecordsPtr[ i ].TimeOffset - RecordsPtr[ i - 1 ].TimeOffset;
+      mStdColPutVarint( BufferPtr, M_STD_ZIGZAG( Diff - LastDiff ) );
+      LastDiff = Diff;
+   }
+
+   /* Values */
+   mStdColPutVarint( BufferPtr, M_STD_ZIGZAG( RecordsPtr[ 0 ].Value ) );
+   for ( i = 1; i < NumRecords; i++ )
+   {
+      if ( *EncodingPtr == I_STD_COL_XOR )
+      {
+         mStdColPutVarint( BufferPtr, (Uint32_t) RecordsPtr[ i ].Value ^
+                                      (Uint32_t) RecordsPtr[ i - 1 ].Value );
+      }
+      else
+      {
+         mStdColPutVarint( BufferPtr, M_STD_ZIGZAG( (Uint32_t) RecordsPtr[ i ].Value -
+                                                    (Uint32_t) RecordsPtr[ i - 1 ].Value ) );
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColDecode
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Decode the records of a chunk.
+**
+** Description:
+**    Reverses mStdColEncode, checking the chunk holds exactly the
+**    records its entry says it does.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_READ_DATA_ERR.
+**
+** Arguments:
+**    unsigned char  *DataPtr      (in)
+**       Data of the chunk.
+**    iStdColChunk_t *ChunkPtr     (in)
+**       Entry of the chunk.
+**    eSdbCode_t      Code         (in)
+**       Storage code of the chunk.
+**    eSdbRawFmt_t   *RecordsPtr   (out)
+**       The chunk's records.
+**
+*****************************************************************************/
+static Status_t mStdColDecode( unsigned char *DataPtr,
+                               iStdColChunk_t *ChunkPtr,
+                               eSdbCode_t Code,
+                               eSdbRawFmt_t *RecordsPtr )
+{
+   unsigned char *EndPtr;     /* End of the chunk */
+   Uint32_t       Value;      /* Number decoded */
+   Uint32_t       Diff;       /* Difference from the previous TimeOffset */
+   Uint32_t       i;          /* Record */
+
+   EndPtr = DataPtr + ChunkPtr->Size;
+
+   Diff = 0;
+   for ( i = 0; i < ChunkPtr->NumRecords; i++ )
+   {
+      if ( mStdColGetVarint( &DataPtr, EndPtr, &Value ) == FALSE )
+      {
+         return E_STD_READ_DATA_ERR;
+      }
+      RecordsPtr[ i ].Code = Code;
+      if ( i == 0 )
+      {
+         RecordsPtr[ i ].TimeOffset = Value;
+      }
+      else
+      {
+         Diff += M_STD_UNZIGZAG( Value );
+         RecordsPtr[ i ].TimeOffset = RecordsPtr[ i - 1 ].TimeOffset + Diff;
+      }
+   }
+
+   for ( i = 0; i < ChunkPtr->NumRecords; i++ )
+   {
+      if ( mStdColGetVarint( &DataPtr, EndPtr, &Value ) == FALSE )
+      {
+         return E_STD_READ_DATA_ERR;
+      }
+      if ( i == 0 )
+      {
+         RecordsPtr[ i ].Value = (Int32_t) M_STD_UNZIGZAG( Value );
+      }
+      else if ( ChunkPtr->Encoding == I_STD_COL_XOR )
+      {
+         RecordsPtr[ i ].Value = (Int32_t) ( (Uint32_t) RecordsPtr[ i - 1 ].Value ^ Value );
+      }
+      else
+      {
+         RecordsPtr[ i ].Value = (Int32_t) ( (Uint32_t) RecordsPtr[ i - 1 ].Value +
+                                             M_STD_UNZIGZAG( Value ) );
+      }
+   }
+
+   return DataPtr == EndPtr ? SYS_NOMINAL : E_STD_READ_DATA_ERR;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColRoom
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Make room for more bytes in a buffer.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdColBuffer_t *BufferPtr   (in/out)
+**       The buffer.
+**    Uint32_t         Size        (in)
+**       Bytes to make room for following those in use.
+**
+*****************************************************************************/
+static Status_t mStdColRoom( mStdColBuffer_t *BufferPtr, Uint32_t Size )
+{
+   unsigned char *NewDataPtr;   /* Data once more room is made */
+   Uint32_t       NewMax;       /* Bytes there will be room for */
+
+   if ( BufferPtr->Size + Size <= BufferPtr->Max )
+   {
+      return SYS_NOMINAL;
+   }
+
+   NewMax = BufferPtr->Max == 0 ? M_STD_COL_MIN : BufferPtr->Max;
+   while ( BufferPtr->Size + Size > NewMax )
+   {
+      NewMax *= 2;
+   }
+
+   NewDataPtr = (unsigned char *) TTL_REALLOC( BufferPtr->Data, NewMax );
+   if ( NewDataPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   BufferPtr->Data = NewDataPtr;
+   BufferPtr->Max  = NewMax;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColPutVarint
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Add a number to a buffer as a varint.
+**
+** Description:
+**    Seven bits are written per byte, least significant first, with the
+**    top bit set on all but the last. There must be room for
+**    M_STD_VARINT_MAX bytes.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    mStdColBuffer_t *BufferPtr   (in/out)
+**       The buffer.
+**    Uint32_t         Value       (in)
+**       The number.
+**
+*****************************************************************************/
+static void mStdColPutVarint( mStdColBuffer_t *BufferPtr, Uint32_t Value )
+{
+   while ( Value >= 0x80 )
+   {
+      BufferPtr->Data[ BufferPtr->Size++ ] = (unsigned char) ( ( Value & 0x7f ) | 0x80 );
+      Value >>= 7;
+   }
+   BufferPtr->Data[ BufferPtr->Size++ ] = (unsigned char) Value;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColGetVarint
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Read a number written by mStdColPutVarint.
+**
+** Description:
+**
+** Return type:
+**    Bool_t
+**       FALSE if the varint runs past the end of the data, or is longer
+**       than a number of 32 bits.
+**
+** Arguments:
+**    unsigned char **DataPtr    (in/out)
+**       Data, moved past the varint.
+**    unsigned char  *EndPtr     (in)
+**       End of the data.
+**    Uint32_t       *ValuePtr   (out)
+**       The number.
+**
+*****************************************************************************/
+static Bool_t mStdColGetVarint( unsigned char **DataPtr,
+                                unsigned char *EndPtr,
+                                Uint32_t *ValuePtr )
+{
+   unsigned char *BytePtr;   /* Byte of the varint */
+   int            Shift;     /* Bits already read */
+
+   *ValuePtr = 0;
+   for ( BytePtr = *DataPtr, Shift = 0;
+         ( BytePtr < EndPtr ) && ( Shift < 7 * M_STD_VARINT_MAX ); BytePtr++, Shift += 7 )
+   {
+      *ValuePtr |= (Uint32_t) ( *BytePtr & 0x7f ) << Shift;
+      if ( ( *BytePtr & 0x80 ) == 0 )
+      {
+         *DataPtr = BytePtr + 1;
+         return TRUE;
+      }
+   }
+
+   return FALSE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColVarintSize
+**
+** Type:
+**    Uint32_t
+**
+** Purpose:
+**    Find the bytes taken by a number written as a varint.
+**
+** Description:
+**
+** Return type:
+**    Uint32_t
+**       From 1 to M_STD_VARINT_MAX.
+**
+** Arguments:
+**    Uint32_t Value   (in)
+**       The number.
+**
+*****************************************************************************/
+static Uint32_t mStdColVarintSize( Uint32_t Value )
+{
+   Uint32_t Size;   /* Bytes taken */
+
+   for ( Size = 1; Value >= 0x80; Size++ )
+   {
+      Value >>= 7;
+   }
+
+   return Size;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColWrite
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write the file of a day of a columnar archive.
+**
+** Description:
+**    The header is followed by the hours, codes and chunks, then the
+**    chunks' data in the same order. It is written to a temporary file
+**    which replaces any existing file once complete.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_FILE_WRITE_ERR.
+**
+** Arguments:
+**    char            *FilePtr      (in)
+**       Name of the day's file.
+**    iStdColHeader_t *HeaderPtr    (in)
+**       Header of the file.
+**    iStdColHour_t   *HoursPtr     (in)
+**       Hours of the day.
+**    mStdColPiece_t  *PiecesPtr    (in)
+**       Chunks, in order of code and hour, given their offsets.
+**    mStdColBuffer_t *BuffersPtr   (in)
+**       Data of the chunks of each hour.
+**
+*****************************************************************************/
+static Status_t mStdColWrite( char *FilePtr,
+                              iStdColHeader_t *HeaderPtr,
+                              iStdColHour_t *HoursPtr,
+                              mStdColPiece_t *PiecesPtr,
+                              mStdColBuffer_t *BuffersPtr )
+{
+   char            TempFile[ FILENAME_MAX + 8 ];  /* Name while being written */
+   FILE           *OutFile;     /* File being written */
+   iStdColCode_t   Entry;       /* Entry of a code */
+   mStdColPiece_t *PiecePtr;    /* Chunk being written */
+   Uint32_t        i;           /* Chunk */
+   Uint32_t        j;           /* Chunk following a code's chunks */
+   Bool_t          Ok;          /* All written */
+
+   sprintf( TempFile, "%s.tmp", FilePtr );
+
+   if ( ( OutFile = fopen( TempFile, "wb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to open file %s", TempFile);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   Ok = ( fwrite( HeaderPtr, sizeof( iStdColHeader_t ), 1, OutFile ) == 1 ) &&
+        ( fwrite( HoursPtr, sizeof( iStdColHour_t ), HeaderPtr->NumHours, OutFile )
+          == HeaderPtr->NumHours );
+
+   for ( i = 0; ( i < HeaderPtr->NumChunks ) && Ok; i = j )
+   {
+      memset( &Entry, 0, sizeof( Entry ) );
+      Entry.Code       = PiecesPtr[ i ].Code;
+      Entry.FirstChunk = i;
+      for ( j = i; ( j < HeaderPtr->NumChunks ) && ( PiecesPtr[ j ].Code == Entry.Code ); j++ )
+      {
+         Entry.NumRecords += PiecesPtr[ j ].Chunk.NumRecords;
+         Entry.NumChunks++;
+      }
+      Ok = fwrite( &Entry, sizeof( Entry ), 1, OutFile ) == 1;
+   }
+
+   for ( i = 0; ( i < HeaderPtr->NumChunks ) && Ok; i++ )
+   {
+      Ok = fwrite( &(PiecesPtr[ i ].Chunk), sizeof( iStdColChunk_t ), 1, OutFile ) == 1;
+   }
+
+   for ( i = 0; ( i < HeaderPtr->NumChunks ) && Ok; i++ )
+   {
+      PiecePtr = PiecesPtr + i;
+      Ok = fwrite( BuffersPtr[ PiecePtr->Chunk.Hour ].Data + PiecePtr->From, 1,
+                   PiecePtr->Chunk.Size, OutFile ) == PiecePtr->Chunk.Size;
+   }
+
+   if ( ( fclose( OutFile ) != 0 ) || !Ok ||
+        ( rename( TempFile, FilePtr ) != 0 ) )
+   {
+      remove( TempFile );
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to write file %s", FilePtr);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColFindDay
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find a day of a columnar archive, loading it if not yet searched.
+**
+** Description:
+**    Days loaded are kept until the archive is closed, including those
+**    not converted, so that their Sdb files are read without looking for
+**    the day's file again. A day once loaded is not changed, so it may be
+**    used without holding the lock.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdColumns_t *ColumnsPtr   (in/out)
+**       The archive.
+**    Int32_t        Key          (in)
+**       The day, as yymmdd.
+**    mStdColDay_t **DayPtr       (out)
+**       The day.
+**
+*****************************************************************************/
+static Status_t mStdColFindDay( eStdColumns_t *ColumnsPtr,
+                                Int32_t Key,
+                                mStdColDay_t **DayPtr )
+{
+   mStdColDay_t **NewDaysPtr;   /* Days once more room is made */
+   Uint32_t       i;            /* Day */
+
+   pthread_mutex_lock( &(ColumnsPtr->Lock) );
+
+   for ( i = 0; i < ColumnsPtr->NumDays; i++ )
+   {
+      if ( ColumnsPtr->Days[ i ]->Key == Key )
+      {
+         *DayPtr = ColumnsPtr->Days[ i ];
+         pthread_mutex_unlock( &(ColumnsPtr->Lock) );
+         return SYS_NOMINAL;
+      }
+   }
+
+   if ( ColumnsPtr->NumDays == ColumnsPtr->MaxDays )
+   {
+      NewDaysPtr = (mStdColDay_t **) TTL_REALLOC( ColumnsPtr->Days,
+                      sizeof( mStdColDay_t * ) * ( ColumnsPtr->MaxDays + 32 ) );
+      if ( NewDaysPtr == NULL )
+      {
+         pthread_mutex_unlock( &(ColumnsPtr->Lock) );
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      ColumnsPtr->Days     = NewDaysPtr;
+      ColumnsPtr->MaxDays += 32;
+   }
+
+   *DayPtr = (mStdColDay_t *) TTL_CALLOC( 1, sizeof( mStdColDay_t ) );
+   if ( *DayPtr == NULL )
+   {
+      pthread_mutex_unlock( &(ColumnsPtr->Lock) );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   (*DayPtr)->Key = Key;
+   mStdColLoadDay( ColumnsPtr, *DayPtr );
+   ColumnsPtr->Days[ ColumnsPtr->NumDays++ ] = *DayPtr;
+
+   pthread_mutex_unlock( &(ColumnsPtr->Lock) );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColLoadDay
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Read the directory of a day of a columnar archive.
+**
+** Description:
+**    The header, hours, codes and chunks are read and checked against
+**    one another. A day which has not been converted, or whose file is
+**    not valid, is left not present, so its Sdb files are read instead.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdColumns_t *ColumnsPtr   (in)
+**       The archive.
+**    mStdColDay_t  *DayPtr       (in/out)
+**       The day, given its key.
+**
+*****************************************************************************/
+static void mStdColLoadDay( eStdColumns_t *ColumnsPtr, mStdColDay_t *DayPtr )
+{
+   char             File[ FILENAME_MAX ]; /* Name of the day's file */
+   FILE            *InFile;      /* The day's file */
+   iStdColHeader_t *HeaderPtr;   /* Its header */
+   struct stat      Stat;        /* Its size */
+   Uint32_t         NumChunks;   /* Chunks of the codes */
+   Uint32_t         i;           /* Code or chunk */
+   Bool_t           Ok;          /* Valid so far */
+
+   mStdColFileName( ColumnsPtr->Dir, DayPtr->Key, File );
+   HeaderPtr = &(DayPtr->Header);
+
+   if ( ( InFile = fopen( File, "rb" ) ) == NULL )
+   {
+      return;
+   }
+
+   Ok = ( fstat( fileno( InFile ), &Stat ) == 0 ) &&
+        ( fread( HeaderPtr, sizeof( iStdColHeader_t ), 1, InFile ) == 1 ) &&
+        ( memcmp( HeaderPtr->Magic, I_STD_COL_MAGIC, 4 ) == 0 ) &&
+        ( HeaderPtr->Version == I_STD_COL_VERSION ) &&
+        ( HeaderPtr->NumHours <= I_STD_COL_MAX_HOURS ) &&
+        ( HeaderPtr->NumCodes <= HeaderPtr->NumChunks ) &&
+        ( HeaderPtr->NumChunks <= HeaderPtr->NumCodes * HeaderPtr->NumHours );
+
+   if ( Ok )
+   {
+      DayPtr->DataStart = (long) ( sizeof( iStdColHeader_t ) +
+                                   sizeof( iStdColHour_t ) * HeaderPtr->NumHours +
+                                   sizeof( iStdColCode_t ) * HeaderPtr->NumCodes +
+                                   sizeof( iStdColChunk_t ) * HeaderPtr->NumChunks );
+      DayPtr->Hours  = (iStdColHour_t *) TTL_MALLOC( sizeof( iStdColHour_t ) * HeaderPtr->NumHours + 1 );
+      DayPtr->Codes  = (iStdColCode_t *) TTL_MALLOC( sizeof( iStdColCode_t ) * HeaderPtr->NumCodes + 1 );
+      DayPtr->Chunks = (iStdColChunk_t *) TTL_MALLOC( sizeof( iStdColChunk_t ) * HeaderPtr->NumChunks + 1 );
+
+      Ok = ( (off_t) ( DayPtr->DataStart + (long) HeaderPtr->DataSize ) == Stat.st_size ) &&
+           ( DayPtr->Hours != NULL ) && ( DayPtr->Codes != NULL ) && ( DayPtr->Chunks != NULL ) &&
+           ( fread( DayPtr->Hours, sizeof( iStdColHour_t ), HeaderPtr->NumHours, InFile )
+             == HeaderPtr->NumHours ) &&
+           ( fread( DayPtr->Codes, sizeof( iStdColCode_t ), HeaderPtr->NumCodes, InFile )
+             == HeaderPtr->NumCodes ) &&
+           ( fread( DayPtr->Chunks, sizeof( iStdColChunk_t ), HeaderPtr->NumChunks, InFile )
+             == HeaderPtr->NumChunks );
+   }
+
+   /* Every chunk must lie within the data, and belong to one code */
+   NumChunks = 0;
+   for ( i = 0; ( i < HeaderPtr->NumCodes ) && Ok; i++ )
+   {
+      Ok = ( DayPtr->Codes[ i ].FirstChunk == NumChunks ) &&
+           ( ( i == 0 ) || ( DayPtr->Codes[ i ].Code > DayPtr->Codes[ i - 1 ].Code ) );
+      NumChunks += DayPtr->Codes[ i ].NumChunks;
+   }
+   Ok = Ok && ( NumChunks == HeaderPtr->NumChunks );
+   for ( i = 0; ( i < HeaderPtr->NumChunks ) && Ok; i++ )
+   {
+      Ok = ( DayPtr->Chunks[ i ].Hour < HeaderPtr->NumHours ) &&
+           ( DayPtr->Chunks[ i ].Offset <= HeaderPtr->DataSize ) &&
+           ( DayPtr->Chunks[ i ].Size <= HeaderPtr->DataSize - DayPtr->Chunks[ i ].Offset ) &&
+           ( DayPtr->Chunks[ i ].NumRecords <= DayPtr->Chunks[ i ].Size );
+   }
+
+   fclose( InFile );
+
+   if ( !Ok )
+   {
+      eLogWarning(E_STD_READ_HEAD_ERR,"Ignoring invalid file %s", File);
+      TTL_FREE( DayPtr->Hours );
+      TTL_FREE( DayPtr->Codes );
+      TTL_FREE( DayPtr->Chunks );
+      DayPtr->Hours  = NULL;
+      DayPtr->Codes  = NULL;
+      DayPtr->Chunks = NULL;
+      return;
+   }
+
+   DayPtr->Present = TRUE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColFreeDay
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Free a day of a columnar archive.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    mStdColDay_t *DayPtr   (in)
+**       The day.
+**
+*****************************************************************************/
+static void mStdColFreeDay( mStdColDay_t *DayPtr )
+{
+   TTL_FREE( DayPtr->Hours );
+   TTL_FREE( DayPtr->Codes );
+   TTL_FREE( DayPtr->Chunks );
+   TTL_FREE( DayPtr );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCompareRecords
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order the records of an hour by storage code, then position.
+**
+** Description:
+**    Used with qsort, so that each code's records keep their order.
+**
+** Return type:
+**    int
+**       Negative, zero or positive as the first record comes before, is,
+**       or comes after the second.
+**
+** Arguments:
+**    const void *FirstPtr    (in)
+**    const void *SecondPtr   (in)
+**       Records compared.
+**
+*****************************************************************************/
+static int mStdCompareRecords( const void *FirstPtr, const void *SecondPtr )
+{
+   const mStdColRecord_t *First;    /* First record */
+   const mStdColRecord_t *Second;   /* Second record */
+
+   First  = (const mStdColRecord_t *) FirstPtr;
+   Second = (const mStdColRecord_t *) SecondPtr;
+
+   if ( First->Code != Second->Code )
+   {
+      return First->Code < Second->Code ? -1 : 1;
+   }
+   if ( First->Sequence != Second->Sequence )
+   {
+      return First->Sequence < Second->Sequence ? -1 : 1;
+   }
+
+   return 0;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdComparePieces
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order the chunks of a day by storage code, then hour.
+**
+** Description:
+**    Used with qsort.
+**
+** Return type:
+**    int
+**       Negative, zero or positive as the first chunk comes before, is,
+**       or comes after the second.
+**
+** Arguments:
+**    const void *FirstPtr    (in)
+**    const void *SecondPtr   (in)
+**       Chunks compared.
+**
+*****************************************************************************/
+static int mStdComparePieces( const void *FirstPtr, const void *SecondPtr )
+{
+   const mStdColPiece_t *First;    /* First chunk */
+   const mStdColPiece_t *Second;   /* Second chunk */
+
+   First  = (const mStdColPiece_t *) FirstPtr;
+   Second = (const mStdColPiece_t *) SecondPtr;
+
+   if ( First->Code != Second->Code )
+   {
+      return First->Code < Second->Code ? -1 : 1;
+   }
+   if ( First->Chunk.Hour != Second->Chunk.Hour )
+   {
+      return First->Chunk.Hour < Second->Chunk.Hour ? -1 : 1;
+   }
+
+   return 0;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCompareCodes
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order the codes of a day by storage code.
+**
+** Description:
+**    Used with bsearch.
+**
+** Return type:
+**    int
+**       Negative, zero or positive as the first code is less than, equal
+**       to or greater than the second.
+**
+** Arguments:
+**    const void *FirstPtr    (in)
+**    const void *SecondPtr   (in)
+**       Codes compared.
+**
+*****************************************************************************/
+static int mStdCompareCodes( const void *FirstPtr, const void *SecondPtr )
+{
+   eSdbCode_t First;    /* Code of the first entry */
+   eSdbCode_t Second;   /* Code of the second entry */
+
+   First  = ( (const iStdColCode_t *) FirstPtr )->Code;
+   Second = ( (const iStdColCode_t *) SecondPtr )->Code;
+
+   if ( First < Second )
+   {
+      return -1;
+   }
+
+   return First > Second ? 1 : 0;
+}
+
+/* EOF */
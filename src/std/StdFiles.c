@@ -0,0 +1,409 @@
+/*****************************************************************************
+** Module Name:
+**     StdFiles.c
+**
+** Purpose:
+**     Lists of Sdb files named to Std, read in place of the files found from
+**     the time of each hour and the archive's directory.
+**
+** Description:
+**     A search usually takes the name of each hour's file from the hour
+**     and a single directory, so the files of an archive laid out any other
+**     way, such as in a directory per year on an NFS mount, had first to be
+**     copied to a directory of their own. Instead the files may be named,
+**     or given as patterns, and are then read where they are. Each must be
+**     named for its hour as in the archive, "yymmddhh.sdb", ".sdb.gz" or
+**     ".sdb.bgz", which gives the hour it holds. Should two files be given
+**     of one hour, the one a search would use is kept: the plain file,
+**     else the block-compressed one.
+**
+**     The list is sorted by hour, and a reader given it goes straight from
+**     each hour listed to the next, looking for no other files.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <glob.h>
+#include <ctype.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_FILES_PLAIN  0   /* Ranks of the files of an hour, best first */
+#define M_STD_FILES_BGZF   1
+#define M_STD_FILES_GZIP   2
+
+/* A file of the list */
+typedef struct mStdFile_s
+{
+   Int32_t       Hour;      /* Start of the hour it holds */
+   Uint32_t      Rank;      /* M_STD_FILES_PLAIN and so on */
+   char         *Name;      /* Path of the file */
+} mStdFile_t;
+
+/* A list of Sdb files, by hour */
+struct eStdFiles_s
+{
+   mStdFile_t   *Files;     /* The files, in order of hour */
+   Uint32_t      NumFiles;  /* Number of files */
+   Uint32_t      MaxFiles;  /* Files there is room for */
+};
+
+/* Local function prototypes */
+static Status_t mStdFilesAdd ( eStdFiles_t *FilesPtr, char *PathPtr );
+static int      mStdFilesCompare ( const void *APtr, const void *BPtr );
+
+
+/*****************************************************************************
+** Function Name:
+**    eStdFilesOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Make a list of the Sdb files to be read.
+**
+** Description:
+**    The files are given by names or patterns, as understood by glob(3),
+**    separated by white space. Each name, and each pattern, must give at
+**    least one file, named for its hour as in the archive.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if no file
+**       matches a name or pattern, E_STD_READ_HEAD_ERR if a file is not
+**       named as an Sdb file, or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char         *ListPtr    (in)
+**       Names and patterns of the files.
+**    eStdFiles_t **FilesPtr   (out)
+**       The list, until closed with eStdFilesClose, or NULL after an
+**       error.
+**
+*****************************************************************************/
+Status_t eStdFilesOpen( char *ListPtr, eStdFiles_t **FilesPtr )
+{
+   Status_t     Status;                   /* Return value of function calls */
+   eStdFiles_t *NewPtr;                   /* The list */
+   glob_t       Matches;                  /* Files matching a pattern */
+   char         Pattern[ FILENAME_MAX ];  /* A name or pattern */
+   char        *StartPtr;                 /* Start of it in the list */
+   size_t       Length;                   /* Its length */
+   size_t       i;                        /* File matched */
+   Uint32_t     Kept;                     /* Files kept once sorted */
+
+   *FilesPtr = NULL;
+
+   NewPtr = (eStdFiles_t *) TTL_CALLOC( 1, sizeof( eStdFiles_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   Status = SYS_NOMINAL;
+   while ( Status == SYS_NOMINAL )
+   {
+      while ( isspace( (unsigned char) *ListPtr ) )
+      {
+         ListPtr++;
+      }
+      if ( *ListPtr == '\0' )
+      {
+         break;
+      }
+      StartPtr = ListPtr;
+      while ( ( *ListPtr != '\0' ) && !isspace( (unsigned char) *ListPtr ) )
+      {
+         ListPtr++;
+      }
+      Length = (size_t) ( ListPtr - StartPtr );
+      if ( Length >= sizeof( Pattern ) )
+      {
+         Length = sizeof( Pattern ) - 1;
+      }
+      memcpy( Pattern, StartPtr, Length );
+      Pattern[ Length ] = '\0';
+
+      if ( ( glob( Pattern, 0, NULL, &Matches ) != 0 ) || ( Matches.gl_pathc == 0 ) )
+      {
+         eLogErr(E_STD_FILE_OPEN_ERR,"No Sdb files match %s", Pattern);
+         Status = E_STD_FILE_OPEN_ERR;
+      }
+      for ( i = 0; ( Status == SYS_NOMINAL ) && ( i < Matches.gl_pathc ); i++ )
+      {
+         Status = mStdFilesAdd( NewPtr, Matches.gl_pathv[ i ] );
+      }
+      globfree( &Matches );
+   }
+
+   if ( ( Status == SYS_NOMINAL ) && ( NewPtr->NumFiles == 0 ) )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"No Sdb files given");
+      Status = E_STD_FILE_OPEN_ERR;
+   }
+   if ( Status != SYS_NOMINAL )
+   {
+      eStdFilesClose( NewPtr );
+      return Status;
+   }
+
+   /* Keep the file of each hour a search would use */
+   qsort( NewPtr->Files, NewPtr->NumFiles, sizeof( mStdFile_t ), mStdFilesCompare );
+   Kept = 1;
+   for ( i = 1; i < NewPtr->NumFiles; i++ )
+   {
+      if ( NewPtr->Files[ i ].Hour == NewPtr->Files[ Kept - 1 ].Hour )
+      {
+         eLogWarning(0,"Ignoring %s, %s is of the same hour",
+                     NewPtr->Files[ i ].Name, NewPtr->Files[ Kept - 1 ].Name);
+         TTL_FREE( NewPtr->Files[ i ].Name );
+         continue;
+      }
+      NewPtr->Files[ Kept++ ] = NewPtr->Files[ i ];
+   }
+   NewPtr->NumFiles = Kept;
+
+   *FilesPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdFilesNext
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the next hour of a list with a file.
+**
+** Description:
+**    Moves on from the start of an hour to the first hour, it or later,
+**    with a file in the list, and gives the file's name.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL if an hour was found, or E_STD_EOF if there
+**       are no files of the hour or later.
+**
+** Arguments:
+**    eStdFiles_t *FilesPtr   (in)
+**       The list.
+**    Int32_t     *HourPtr    (in/out)
+**       Start of the hour to search from, then of the hour found.
+**    char        *FilePtr    (out)
+**       Path of the hour's Sdb file, FILENAME_MAX characters, if found.
+**
+*****************************************************************************/
+Status_t eStdFilesNext( eStdFiles_t *FilesPtr, Int32_t *HourPtr, char *FilePtr )
+{
+   Uint32_t Low;    /* First file which may be of the hour or later */
+   Uint32_t High;   /* File following the last which may not */
+   Uint32_t Mid;    /* File between them */
+
+   Low  = 0;
+   High = FilesPtr->NumFiles;
+   while ( Low < High )
+   {
+      Mid = Low + ( High - Low ) / 2;
+      if ( FilesPtr->Files[ Mid ].Hour < *HourPtr )
+      {
+         Low = Mid + 1;
+      }
+      else
+      {
+         High = Mid;
+      }
+   }
+
+   if ( Low == FilesPtr->NumFiles )
+   {
+      return E_STD_EOF;
+   }
+
+   *HourPtr = FilesPtr->Files[ Low ].Hour;
+   strcpy( FilePtr, FilesPtr->Files[ Low ].Name );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdFilesClose
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Free a list of Sdb files.
+**
+** Description:
+**    No reader given the list may use it afterwards.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdFiles_t *FilesPtr   (in)
+**       The list, may be NULL.
+**
+*****************************************************************************/
+Status_t eStdFilesClose( eStdFiles_t *FilesPtr )
+{
+   Uint32_t i;   /* File of the list */
+
+   if ( FilesPtr == NULL )
+   {
+      return SYS_NOMINAL;
+   }
+
+   for ( i = 0; i < FilesPtr->NumFiles; i++ )
+   {
+      TTL_FREE( FilesPtr->Files[ i ].Name );
+   }
+   TTL_FREE( FilesPtr->Files );
+   TTL_FREE( FilesPtr );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFilesAdd
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Add a file to a list.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_READ_HEAD_ERR if the file is
+**       not named as an Sdb file, or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdFiles_t *FilesPtr   (in/out)
+**       The list.
+**    char        *PathPtr    (in)
+**       Path of the file.
+**
+*****************************************************************************/
+static Status_t mStdFilesAdd( eStdFiles_t *FilesPtr, char *PathPtr )
+{
+   mStdFile_t *MorePtr;   /* Files extended */
+   mStdFile_t *FilePtr;   /* File added */
+   char       *NamePtr;   /* Its name, less any directory */
+   Int32_t     Hour;      /* Hours since the epoch of its hour */
+   Bool_t      Gzipped;   /* It is compressed */
+   size_t      Length;    /* Length of its path */
+
+   NamePtr = strrchr( PathPtr, '/' );
+   NamePtr = ( NamePtr == NULL ) ? PathPtr : NamePtr + 1;
+   Length  = strlen( PathPtr );
+
+   if ( ( Length >= FILENAME_MAX ) ||
+        ( iStdCatHourOfName( NamePtr, &Hour, &Gzipped ) == FALSE ) )
+   {
+      eLogErr(E_STD_READ_HEAD_ERR,"%s is not named yymmddhh.%s", PathPtr, I_STD_EXT_SDB);
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   if ( FilesPtr->NumFiles == FilesPtr->MaxFiles )
+   {
+      MorePtr = (mStdFile_t *) TTL_REALLOC( FilesPtr->Files, sizeof( mStdFile_t ) *
+                                            ( FilesPtr->MaxFiles * 2 + 16 ) );
+      if ( MorePtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      FilesPtr->Files    = MorePtr;
+      FilesPtr->MaxFiles = FilesPtr->MaxFiles * 2 + 16;
+   }
+
+   FilePtr       = FilesPtr->Files + FilesPtr->NumFiles;
+   FilePtr->Hour = Hour * E_STD_SECONDS_PER_HOUR;
+   FilePtr->Name = (char *) TTL_MALLOC( Length + 1 );
+   if ( FilePtr->Name == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   strcpy( FilePtr->Name, PathPtr );
+
+   if ( Gzipped == FALSE )
+   {
+      FilePtr->Rank = M_STD_FILES_PLAIN;
+   }
+   else if ( strcmp( PathPtr + Length - strlen( I_STD_EXT_BGZF ), I_STD_EXT_BGZF ) == 0 )
+   {
+      FilePtr->Rank = M_STD_FILES_BGZF;
+   }
+   else
+   {
+      FilePtr->Rank = M_STD_FILES_GZIP;
+   }
+
+   FilesPtr->NumFiles++;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFilesCompare
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order files by hour, and the files of an hour best first.
+**
+** Description:
+**    For qsort.
+**
+** Return type:
+**    int
+**       Negative, zero or positive as the first file is before, the same
+**       as or after the second.
+**
+** Arguments:
+**    const void *APtr   (in)
+**       First file.
+**    const void *BPtr   (in)
+**       Second file.
+**
+*****************************************************************************/
+static int mStdFilesCompare( const void *APtr, const void *BPtr )
+{
+   const mStdFile_t *FileAPtr = (const mStdFile_t *) APtr;
+   const mStdFile_t *FileBPtr = (const mStdFile_t *) BPtr;
+
+   if ( FileAPtr->Hour != FileBPtr->Hour )
+   {
+      return ( FileAPtr->Hour < FileBPtr->Hour ) ? -1 : 1;
+   }
+   if ( FileAPtr->Rank != FileBPtr->Rank )
+   {
+      return ( FileAPtr->Rank < FileBPtr->Rank ) ? -1 : 1;
+   }
+
+   return strcmp( FileAPtr->Name, FileBPtr->Name );
+}
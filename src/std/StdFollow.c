@@ -0,0 +1,368 @@
+/*****************************************************************************
+** Module Name:
+**     StdFollow.c
+**
+** Purpose:
+**     Keep searching the Sdb file being written, as records are added.
+**
+** Description:
+**     Once the hours before the current one have been searched, the
+**     current hour's file is followed with an eStdTail_t. Each time the
+**     SDB appends to it, only the records added are searched, and what
+**     matches is written to the outputs and flushed, so the outputs keep
+**     up with the SDB to within the time between checks. The file of
+**     each hour is followed in turn until the outputs' stop times have
+**     passed, or Std is interrupted or terminated, when it finishes
+**     writing the outputs as usual.
+**
+**     Records are routed to each output up to its stop time, and the file
+**     is followed until the stop times of every output have passed. An
+**     output whose configuration gives no stop time is followed until Std
+**     is interrupted or terminated. A stride, if given, is applied as the
+**     records arrive, exactly as when searching files.
+**     When strides are summarised, the latest stride is held back until a
+**     record from a later one arrives, or Std stops. A record arriving for
+**     a stride already written out gives that stride another row.
+**     A record repeating the time of one already written out is written
+**     again, where a single search would have kept only the first.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <signal.h>
+#include <time.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local variables */
+static volatile sig_atomic_t mStdStopped = 0;   /* Set once asked to stop */
+
+/* Local definitions */
+#define M_STD_FOLLOW_FOREVER  0x7FFFFFFF   /* Stop time of an output with none */
+
+/* Local function prototypes */
+static void     mStdFollowStop ( int Signal );
+static Status_t mStdFollowRoute ( eStdTail_t *TailPtr, eSdbRawFmt_t *SdbDataPtr,
+                                  size_t NumRecords );
+static Status_t mStdFollowWrite ( void );
+
+/*****************************************************************************
+** Function Name:
+**    iStdSearchFollow
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Search the Sdb files of each hour as they are written.
+**
+** Description:
+**    First writes out anything already found, then follows the files
+**    from the hour of the start time, checking for new records each
+**    time the archive's directory changes, or every
+**    iStdGlobVar.FollowSecs seconds. Outputs given no stop time by their
+**    configuration are made to have none. Returns once the latest stop
+**    time has passed and the records up to it have been read, or once
+**    SIGINT or SIGTERM is caught, leaving the last records found in the
+**    outputs to be written as usual. The lookup must already have been
+**    built.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or the first error met.
+**
+** Arguments:
+**    eTtlTime_t StartTime      (in)
+**       Time in the first hour followed.
+**
+*****************************************************************************/
+Status_t iStdSearchFollow ( eTtlTime_t StartTime )
+{
+   Status_t       Status;       /* Return value of function calls */
+   eStdTail_t    *TailPtr;      /* Follower of the file being written */
+   eSdbRawFmt_t  *SdbDataPtr;   /* Records added to it */
+   size_t         NumRecords;   /* Number of records added */
+   iStdOutput_t  *OutputPtr;    /* Output whose stop time is found */
+   Int32_t        StopSecs;     /* Latest stop time of the outputs */
+   Int32_t        CheckedSecs;  /* Time the file was last read up to */
+   Int32_t        k;            /* Counter stepping through outputs */
+
+   Status = mStdFollowWrite( );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   StopSecs = 0;
+   for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+   {
+      OutputPtr = iStdGlobVar.Outputs + k;
+      if ( OutputPtr->StopGiven == FALSE )
+      {
+         OutputPtr->TtlStopTime.t_sec  = M_STD_FOLLOW_FOREVER;
+         OutputPtr->TtlStopTime.t_nsec = 0;
+      }
+      if ( ( k == 0 ) || ( OutputPtr->TtlStopTime.t_sec > StopSecs ) )
+      {
+         StopSecs = OutputPtr->TtlStopTime.t_sec;
+      }
+   }
+
+   /* Every output may already have all it asked for */
+   if ( StopSecs < StartTime.t_sec )
+   {
+      return SYS_NOMINAL;
+   }
+
+   Status = eStdTailOpen( StartTime, iStdGlobVar.DatPath, &TailPtr );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   signal( SIGINT,  mStdFollowStop );
+   signal( SIGTERM, mStdFollowStop );
+
+   CheckedSecs = 0;
+   while ( ( mStdStopped == 0 ) && ( Status == SYS_NOMINAL ) &&
+           ( CheckedSecs <= StopSecs ) )
+   {
+      /* Records up to now are in the file before it is read */
+      CheckedSecs = (Int32_t) time( NULL );
+
+      do
+      {
+         Status = eStdTailNext( TailPtr, &SdbDataPtr, &NumRecords );
+         if ( Status == SYS_NOMINAL )
+         {
+            Status = mStdFollowRoute( TailPtr, SdbDataPtr, NumRecords );
+         }
+      } while ( ( Status == SYS_NOMINAL ) && ( NumRecords > 0 ) );
+
+      if ( Status == SYS_NOMINAL )
+      {
+         Status = mStdFollowWrite( );
+      }
+
+      if ( ( Status == SYS_NOMINAL ) && ( mStdStopped == 0 ) &&
+           ( CheckedSecs <= StopSecs ) )
+      {
+         Status = eStdTailWait( TailPtr, iStdGlobVar.FollowSecs );
+      }
+   }
+
+   eStdTailClose( TailPtr );
+
+   signal( SIGINT,  SIG_DFL );
+   signal( SIGTERM, SIG_DFL );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFollowStop
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Handle a signal asking Std to stop following.
+**
+** Description:
+**    Only notes the request, which is acted on once the records already
+**    found have been written.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    int Signal                (in)
+**       Signal caught.
+**
+*****************************************************************************/
+static void mStdFollowStop ( int Signal )
+{
+   (void) Signal;
+
+   mStdStopped = 1;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFollowRoute
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Store the records added to the file being followed.
+**
+** Description:
+**    Each record routed to a column of an output, and between the start
+**    and stop times of that output, is stored in the column, subject to
+**    the stride.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    eStdTail_t   *TailPtr     (in)
+**       Follower the records were returned by.
+**    eSdbRawFmt_t *SdbDataPtr  (in)
+**       The records.
+**    size_t        NumRecords  (in)
+**       Number of records.
+**
+*****************************************************************************/
+static Status_t mStdFollowRoute ( eStdTail_t *TailPtr, eSdbRawFmt_t *SdbDataPtr,
+                                  size_t NumRecords )
+{
+   Status_t       Status;                /* Return value of function calls */
+   eSdbRawFmt_t  *SdbLinePtr;            /* Current line of Sdb */
+   size_t         CurrentLine;           /* Index of current line */
+   eTtlTime_t     TimeStamp;             /* Timestamp of current Sdb datum */
+   Int32_t        Target;                /* Index of current routing target */
+   iStdTarget_t  *TargetPtr;             /* Current routing target */
+   iStdOutput_t  *OutputPtr;             /* Output routed to */
+   iStdData_t    *StdDataPtr;            /* Column routed to */
+   char           TimeStr[ E_TIM_BUFFER_LENGTH ];
+
+   for ( CurrentLine = 0; CurrentLine < NumRecords; CurrentLine++ )
+   {
+      SdbLinePtr = SdbDataPtr + CurrentLine;
+
+      Target = iStdLookupFind( SdbLinePtr->Code );
+      if ( Target < 0 )
+      {
+         continue;
+      }
+
+      Status = eStdTailTime( TailPtr, SdbLinePtr, &TimeStamp );
+      if ( Status != SYS_NOMINAL )
+      {
+         return Status;
+      }
+
+      for ( ; Target >= 0; Target = TargetPtr->Next )
+      {
+         TargetPtr  = iStdGlobVar.Lookup.Targets + Target;
+         OutputPtr  = iStdGlobVar.Outputs + TargetPtr->Output;
+         StdDataPtr = OutputPtr->StdData + TargetPtr->Column;
+
+         if ( ( TimeStamp.t_sec < OutputPtr->TtlStartTime.t_sec ) ||
+              ( TimeStamp.t_sec > OutputPtr->TtlStopTime.t_sec ) ||
+              ( TimeStamp.t_sec < StdDataPtr->NextStrideTime.t_sec ) )
+         {
+            continue;
+         }
+
+         /* Increment the next-stride-time by the stride, could be 0 */
+         StdDataPtr->NextStrideTime.t_sec += iStdGlobVar.Stride;
+
+         if ( eCluCommon.DebugLevel >= E_LOG_INFO )
+         {
+            iStdFormatTimeString( &TimeStamp, TimeStr );
+            eLogInfo("Got data match. Writing data %s %d",TimeStr,SdbLinePtr->Value);
+         }
+
+         Status = iStdStoreData( OutputPtr, TimeStamp, TargetPtr->Column,
+                                 SdbLinePtr->Value );
+         if ( Status != SYS_NOMINAL )
+         {
+            return Status;
+         }
+         OutputPtr->LinesOfData++;
+         StdDataPtr->NumOfPoints++;
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFollowWrite
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write out the data found since the outputs were last written.
+**
+** Description:
+**    The data of each output is sorted, written and flushed, and its
+**    columns emptied. The numbers of entries found are kept for the
+**    summary written once Std stops, as are the samples of strides still
+**    open when summarising.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    None.
+**
+*****************************************************************************/
+static Status_t mStdFollowWrite ( void )
+{
+   Status_t       Status;       /* Return value of function calls */
+   iStdOutput_t  *OutputPtr;    /* Output being written */
+   Int32_t        NumSamples;   /* Samples waiting to be written */
+   Int32_t        j;            /* Counter stepping through columns */
+   Int32_t        k;            /* Counter stepping through outputs */
+
+   for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+   {
+      OutputPtr = iStdGlobVar.Outputs + k;
+
+      NumSamples = 0;
+      for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+      {
+         NumSamples += OutputPtr->StdData[j].NumSamples;
+      }
+      if ( NumSamples == 0 )
+      {
+         continue;
+      }
+
+      Status = iStdSortData( OutputPtr );
+      if ( Status != SYS_NOMINAL )
+      {
+         return Status;
+      }
+
+      if ( iStdGlobVar.Window > 0 )
+      {
+         Status = iStdAggregate( OutputPtr, FALSE );
+         if ( Status != SYS_NOMINAL )
+         {
+            return Status;
+         }
+      }
+
+      Status = iStdWriteToFile( OutputPtr );
+      if ( ( Status != SYS_NOMINAL ) || ( fflush( OutputPtr->OutFilePtr ) != 0 ) )
+      {
+         return E_STD_FILE_WRITE_ERR;
+      }
+
+      eLogNotice( 0, "Written %6d new data entries to %s", NumSamples, OutputPtr->OutFile );
+
+      iStdEmptyData( OutputPtr );
+   }
+
+   return SYS_NOMINAL;
+}
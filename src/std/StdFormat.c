@@ -0,0 +1,506 @@
+/*****************************************************************************
+** Module Name:
+**     StdFormat.c
+**
+** Purpose:
+**     Fast formatting of time stamps and values written by Std.
+**
+** Description:
+**     Output is built up in a large buffer which is written to the output
+**     file in a single fwrite whenever it fills. Integers are converted
+**     by hand rather than by fprintf. The date and time of a time stamp
+**     are calculated arithmetically from the seconds since 1970 (Std
+**     always works in UTC, see iStdCluInit) rather than via localtime and
+**     strftime, and the text for the current second is cached, as rows
+**     within a second only differ in their milliseconds.
+**
+**     The text produced is identical to that produced by eTimToString and
+**     printf, so the output files are unchanged.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+#define M_STD_SECS_PER_DAY   86400
+#define M_STD_MAX_FIELD      32     /* Longest single item written at once */
+
+/* Local function prototypes */
+static void mStdFormatCivil ( Int32_t Days, Int32_t *YearPtr,
+                              Int32_t *MonthPtr, Int32_t *DatePtr );
+static char *mStdFormatTwo ( char *TextPtr, Int32_t Value );
+static char *mStdFormatDateTime ( char *TextPtr, Int32_t Seconds, char Separator );
+
+/*****************************************************************************
+** Function Name:
+**    iStdFormatInit
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Prepare to format output to a file.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdFormat_t *FormatPtr   (out)
+**       Formatter to be set up.
+**    FILE *OutFilePtr          (in)
+**       Output file the formatted text is written to.
+**
+*****************************************************************************/
+Status_t iStdFormatInit ( iStdFormat_t *FormatPtr, FILE *OutFilePtr )
+{
+   memset( FormatPtr, 0, sizeof( *FormatPtr ) );
+
+   FormatPtr->BufferPtr = (char *) TTL_MALLOC( I_STD_FORMAT_BUFSIZE );
+   if ( FormatPtr->BufferPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   FormatPtr->OutFilePtr = OutFilePtr;
+   FormatPtr->Length     = 0;
+   FormatPtr->CachedSec  = -1;
+   FormatPtr->Error      = FALSE;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdFormatEnd
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write out anything still buffered and release the formatter.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_FILE_WRITE_ERR if any
+**       write to the output file failed.
+**
+** Arguments:
+**    iStdFormat_t *FormatPtr   (in/out)
+**       Formatter being finished with.
+**
+*****************************************************************************/
+Status_t iStdFormatEnd ( iStdFormat_t *FormatPtr )
+{
+   iStdFormatFlush( FormatPtr );
+
+   if ( FormatPtr->BufferPtr != NULL )
+   {
+      TTL_FREE( FormatPtr->BufferPtr );
+      FormatPtr->BufferPtr = NULL;
+   }
+
+   return ( FormatPtr->Error == TRUE ) ? E_STD_FILE_WRITE_ERR : SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdFormatFlush
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Write the buffered text to the output file.
+**
+** Description:
+**    Any failure is remembered and reported by iStdFormatEnd.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdFormat_t *FormatPtr   (in/out)
+**       Formatter whose buffer is to be written.
+**
+*****************************************************************************/
+void iStdFormatFlush ( iStdFormat_t *FormatPtr )
+{
+   if ( FormatPtr->Length > 0 )
+   {
+      if ( fwrite( FormatPtr->BufferPtr, 1, FormatPtr->Length,
+                   FormatPtr->OutFilePtr ) != FormatPtr->Length )
+      {
+         FormatPtr->Error = TRUE;
+      }
+      FormatPtr->Length = 0;
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdFormatText
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Add a string to the output.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdFormat_t *FormatPtr   (in/out)
+**       Formatter.
+**    const char *TextPtr       (in)
+**       Null terminated string.
+**
+*****************************************************************************/
+void iStdFormatText ( iStdFormat_t *FormatPtr, const char *TextPtr )
+{
+   size_t Length;
+
+   Length = strlen( TextPtr );
+   if ( FormatPtr->Length + Length > I_STD_FORMAT_BUFSIZE )
+   {
+      iStdFormatFlush( FormatPtr );
+      if ( Length > I_STD_FORMAT_BUFSIZE )
+      {
+         if ( fwrite( TextPtr, 1, Length, FormatPtr->OutFilePtr ) != Length )
+         {
+            FormatPtr->Error = TRUE;
+         }
+         return;
+      }
+   }
+
+   memcpy( FormatPtr->BufferPtr + FormatPtr->Length, TextPtr, Length );
+   FormatPtr->Length += Length;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdFormatInt
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Add an integer to the output, as printf "%d" would.
+**
+** Description:
+**    If MinDigits is greater than the number of digits needed the number
+**    is padded with leading zeroes, as printf "%.Nd" would.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdFormat_t *FormatPtr   (in/out)
+**       Formatter.
+**    Int32_t Value             (in)
+**       Value to be written.
+**    Int32_t MinDigits         (in)
+**       Minimum number of digits to write.
+**
+*****************************************************************************/
+void iStdFormatInt ( iStdFormat_t *FormatPtr, Int32_t Value, Int32_t MinDigits )
+{
+   char      Digits[ M_STD_MAX_FIELD ];  /* Digits, least significant last */
+   char     *DigitPtr;
+   char     *OutPtr;
+   Uint32_t  Magnitude;
+
+   I_STD_FORMAT_ROOM( FormatPtr, M_STD_MAX_FIELD );
+   OutPtr = FormatPtr->BufferPtr + FormatPtr->Length;
+
+   if ( Value < 0 )
+   {
+      *OutPtr++ = '-';
+      Magnitude = 0U - (Uint32_t) Value;
+   }
+   else
+   {
+      Magnitude = (Uint32_t) Value;
+   }
+
+   DigitPtr = Digits + sizeof( Digits );
+   do
+   {
+      *--DigitPtr = (char) ( '0' + ( Magnitude % 10 ) );
+      Magnitude /= 10;
+      MinDigits--;
+   } while ( Magnitude != 0 );
+
+   while ( ( MinDigits-- > 0 ) && ( DigitPtr > Digits ) )
+   {
+      *--DigitPtr = '0';
+   }
+
+   while ( DigitPtr < Digits + sizeof( Digits ) )
+   {
+      *OutPtr++ = *DigitPtr++;
+   }
+
+   FormatPtr->Length = OutPtr - FormatPtr->BufferPtr;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdFormatTime
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Add a time stamp to the output.
+**
+** Description:
+**    If DateTime is TRUE the time stamp is first written as the date
+**    and time columns, "dd/mm/yy<tab>HH:MM:SS.mmm<tab>", matching
+**    eTimToString. Then the seconds since 1970 are written as printf "%f"
+**    would. The date and time text is only worked out once per second.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdFormat_t *FormatPtr   (in/out)
+**       Formatter.
+**    eTtlTime_t *TimePtr       (in)
+**       Time stamp to be written.
+**    Bool_t DateTime           (in)
+**       Whether to write the date and time columns.
+**
+*****************************************************************************/
+void iStdFormatTime ( iStdFormat_t *FormatPtr, eTtlTime_t *TimePtr, Bool_t DateTime )
+{
+   Int32_t  Seconds;     /* Seconds since 1970 */
+   Int32_t  Micro;       /* Microseconds, as rounded by "%f" */
+   char    *TextPtr;
+
+   if ( DateTime == TRUE )
+   {
+      /* Work out the date and time text if this is a new second */
+      if ( TimePtr->t_sec != FormatPtr->CachedSec )
+      {
+         TextPtr = mStdFormatDateTime( FormatPtr->CachedText,
+                                       TimePtr->t_sec, '\t' );
+         *TextPtr++ = '.';
+         *TextPtr   = '\0';
+
+         FormatPtr->CachedSec    = TimePtr->t_sec;
+         FormatPtr->CachedLength = TextPtr - FormatPtr->CachedText;
+      }
+
+      I_STD_FORMAT_ROOM( FormatPtr, M_STD_MAX_FIELD );
+      memcpy( FormatPtr->BufferPtr + FormatPtr->Length,
+              FormatPtr->CachedText, FormatPtr->CachedLength );
+      FormatPtr->Length += FormatPtr->CachedLength;
+
+      /* Milliseconds are truncated, as by eTimToString */
+      iStdFormatInt( FormatPtr, TimePtr->t_nsec / E_TTL_NANOSECS_PER_MILLISEC, 3 );
+      I_STD_FORMAT_CHAR( FormatPtr, '\t' );
+   }
+
+   /* Seconds since 1970, to the nearest microsecond */
+   Seconds = TimePtr->t_sec;
+   Micro   = ( TimePtr->t_nsec + 500 ) / 1000;
+   if ( Micro >= (Int32_t) E_TTL_MICROSECS_PER_SEC )
+   {
+      Seconds++;
+      Micro -= E_TTL_MICROSECS_PER_SEC;
+   }
+   iStdFormatInt( FormatPtr, Seconds, 1 );
+   I_STD_FORMAT_CHAR( FormatPtr, '.' );
+   iStdFormatInt( FormatPtr, Micro, 6 );
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdFormatTimeString
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Convert a time stamp to a string.
+**
+** Description:
+**    Gives the same "dd/mm/yy HH:MM:SS.mmm" string as eTimToString, but
+**    without using localtime, so may be called from any thread.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eTtlTime_t *TimePtr       (in)
+**       Time stamp to be converted.
+**    char *TextPtr             (out)
+**       String, with room for at least E_TIM_BUFFER_LENGTH characters.
+**
+*****************************************************************************/
+void iStdFormatTimeString ( eTtlTime_t *TimePtr, char *TextPtr )
+{
+   Int32_t Milli;   /* Milliseconds, truncated as by eTimToString */
+
+   TextPtr = mStdFormatDateTime( TextPtr, TimePtr->t_sec, ' ' );
+
+   Milli = TimePtr->t_nsec / E_TTL_NANOSECS_PER_MILLISEC;
+   *TextPtr++ = '.';
+   *TextPtr++ = (char) ( '0' + ( Milli / 100 ) % 10 );
+   TextPtr = mStdFormatTwo( TextPtr, Milli % 100 );
+   *TextPtr = '\0';
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFormatDateTime
+**
+** Type:
+**    char *
+**
+** Purpose:
+**    Write the date and time of a time stamp as "dd/mm/yy HH:MM:SS".
+**
+** Description:
+**
+** Return type:
+**    char *
+**       Pointer to the character following the text.
+**
+** Arguments:
+**    char *TextPtr             (out)
+**       Where to write the text.
+**    Int32_t Seconds           (in)
+**       Seconds since 1970.
+**    char Separator            (in)
+**       Written between the date and the time.
+**
+*****************************************************************************/
+static char *mStdFormatDateTime ( char *TextPtr, Int32_t Seconds, char Separator )
+{
+   Int32_t  Days;        /* Days since 1970 */
+   Int32_t  SecOfDay;    /* Seconds since midnight */
+   Int32_t  Year, Month, Date;
+
+   Days     = Seconds / M_STD_SECS_PER_DAY;
+   SecOfDay = Seconds % M_STD_SECS_PER_DAY;
+   if ( SecOfDay < 0 )
+   {
+      SecOfDay += M_STD_SECS_PER_DAY;
+      Days--;
+   }
+   mStdFormatCivil( Days, &Year, &Month, &Date );
+
+   TextPtr = mStdFormatTwo( TextPtr, Date );
+   *TextPtr++ = '/';
+   TextPtr = mStdFormatTwo( TextPtr, Month );
+   *TextPtr++ = '/';
+   TextPtr = mStdFormatTwo( TextPtr, Year % 100 );
+   *TextPtr++ = Separator;
+   TextPtr = mStdFormatTwo( TextPtr, SecOfDay / 3600 );
+   *TextPtr++ = ':';
+   TextPtr = mStdFormatTwo( TextPtr, ( SecOfDay / 60 ) % 60 );
+   *TextPtr++ = ':';
+   TextPtr = mStdFormatTwo( TextPtr, SecOfDay % 60 );
+
+   return TextPtr;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFormatCivil
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Convert a count of days since 1970 into a calendar date.
+**
+** Description:
+**    Works in 400 year eras of the Gregorian calendar, with years taken
+**    to start on the 1st of March so that the leap day falls at the end.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    Int32_t Days              (in)
+**       Days since 1st January 1970.
+**    Int32_t *YearPtr          (out)
+**    Int32_t *MonthPtr         (out)
+**       1 to 12.
+**    Int32_t *DatePtr          (out)
+**       1 to 31.
+**
+*****************************************************************************/
+static void mStdFormatCivil ( Int32_t Days, Int32_t *YearPtr,
+                              Int32_t *MonthPtr, Int32_t *DatePtr )
+{
+   Int32_t Era;          /* 400 year era */
+   Int32_t DayOfEra;     /* 0 to 146096 */
+   Int32_t YearOfEra;    /* 0 to 399 */
+   Int32_t DayOfYear;    /* 0 to 365, from 1st March */
+   Int32_t MonthIndex;   /* 0 to 11, from March */
+
+   Days += 719468;       /* Days from 1st March 0000 to 1st January 1970 */
+   Era = ( Days >= 0 ? Days : Days - 146096 ) / 146097;
+   DayOfEra   = Days - Era * 146097;
+   YearOfEra  = ( DayOfEra - DayOfEra / 1460 + DayOfEra / 36524
+                  - DayOfEra / 146096 ) / 365;
+   DayOfYear  = DayOfEra - ( 365 * YearOfEra + YearOfEra / 4 - YearOfEra / 100 );
+   MonthIndex = ( 5 * DayOfYear + 2 ) / 153;
+
+   *DatePtr  = DayOfYear - ( 153 * MonthIndex + 2 ) / 5 + 1;
+   *MonthPtr = MonthIndex < 10 ? MonthIndex + 3 : MonthIndex - 9;
+   *YearPtr  = YearOfEra + Era * 400 + ( *MonthPtr <= 2 ? 1 : 0 );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFormatTwo
+**
+** Type:
+**    char *
+**
+** Purpose:
+**    Write a value from 0 to 99 as two digits.
+**
+** Description:
+**
+** Return type:
+**    char *
+**       Pointer to the character following the digits.
+**
+** Arguments:
+**    char *TextPtr             (out)
+**       Where to write the digits.
+**    Int32_t Value             (in)
+**       Value to write.
+**
+*****************************************************************************/
+static char *mStdFormatTwo ( char *TextPtr, Int32_t Value )
+{
+   *TextPtr++ = (char) ( '0' + Value / 10 );
+   *TextPtr++ = (char) ( '0' + Value % 10 );
+   return TextPtr;
+}
@@ -0,0 +1,1607 @@
+/*****************************************************************************
+** Module Name:
+**     StdGzIndex.c
+**
+** Purpose:
+**     Random access into gzipped Sdb files, through an index of access
+**     points.
+**
+** Description:
+**     A gzip file can normally only be inflated from its start. The index
+**     built here records, at the start of a deflate block every span of
+**     inflated data, where the block starts in the gzipped file and the
+**     last 32 KB inflated before it. Inflation can then be resumed from
+**     any access point. The least and greatest TimeOffset of the records
+**     in each span are also kept, so that a search for part of an hour
+**     need only inflate the spans which overlap it.
+**
+**     The index of "yymmddhh.sdb.gz" is kept alongside it in
+**     "yymmddhh.sdb.gzidx". It is ignored if the gzipped file has since
+**     changed size.
+**
+**     The vendored zlib can neither report where deflate blocks start nor
+**     be given a window to resume from. The index is therefore built with
+**     a small inflater of its own, and when resuming zlib is given the
+**     window as a stored block followed by the remaining data shifted to
+**     start on a byte boundary.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <zlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_MAXBITS    15     /* Longest Huffman code */
+#define M_STD_MAXLCODES  286    /* Most literal/length codes */
+#define M_STD_MAXDCODES  30     /* Most distance codes */
+#define M_STD_FIXLCODES  288    /* Literal/length codes of a fixed block */
+#define M_STD_RAWSIZE    65536  /* Gzipped data read at once when resuming */
+#define M_STD_GZ_TRAILER 8      /* Size of the gzip trailer */
+#define M_STD_GZ_FEXTRA  0x04   /* Gzip header flags */
+#define M_STD_GZ_FNAME   0x08
+#define M_STD_GZ_FCOMMENT 0x10
+#define M_STD_GZ_FHCRC   0x02
+#define M_STD_GZ_MORE    16     /* Points allocated for at a time */
+
+/* Canonical Huffman code, as counts per length and symbols in code order */
+typedef struct mStdHuffman_s
+{
+   short        *Count;
+   short        *Symbol;
+} mStdHuffman_t;
+
+/* State of the inflater building an index */
+typedef struct mStdBuild_s
+{
+   unsigned char *InPtr;                       /* Whole gzipped file */
+   size_t         InLen;                       /* Size of the file */
+   size_t         InPos;                       /* Next byte to be read */
+   Uint32_t       BitBuf;                      /* Bits read but not used */
+   int            BitCnt;                      /* Number of them */
+   Bool_t         Error;                       /* Data is not valid */
+   unsigned char  Window[ I_STD_GZ_WINSIZE ];  /* Last data inflated */
+   Uint32_t       Out;                         /* Bytes inflated */
+   size_t         SpanSize;                    /* Least bytes between points */
+   iStdGzPoint_t *Points;                      /* Access points found */
+   unsigned char *Windows;                     /* Window of each point */
+   Uint32_t       NumPoints;                   /* Number of points */
+   Uint32_t       MaxPoints;                   /* Points there is room for */
+   unsigned char  Record[ sizeof( eSdbRawFmt_t ) ]; /* Record being built */
+   size_t         RecordLen;                   /* Bytes of it so far */
+} mStdBuild_t;
+
+/* Inflation of a gzipped Sdb file from an access point */
+struct iStdGzStream_s
+{
+   z_stream       Strm;                 /* Raw inflation */
+   FILE          *GzFile;               /* Gzipped file */
+   unsigned char *RawPtr;               /* Data as read from the file */
+   unsigned char *ShiftPtr;             /* Data shifted to a byte boundary */
+   int            Shift;                /* Bits to shift by */
+   int            Pending;              /* Raw byte part shifted, or -1 */
+   Bool_t         RawEnd;               /* All of the file has been read */
+   Bool_t         Ended;                /* End of the deflate data */
+};
+
+/* Literal/length and distance bases and extra bits, RFC 1951 */
+static const short mStdLenBase[ 29 ] = {
+   3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+   35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const short mStdLenExtra[ 29 ] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+   3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const short mStdDistBase[ 30 ] = {
+   1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+   257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+   8193, 12289, 16385, 24577 };
+static const short mStdDistExtra[ 30 ] = {
+   0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+   7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/* Order of code length code lengths in a dynamic block header */
+static const short mStdLenOrder[ 19 ] = {
+   16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+/* Local function prototypes */
+static Uint32_t mStdBits ( mStdBuild_t *BuildPtr, int Need );
+static void     mStdPut ( mStdBuild_t *BuildPtr, unsigned char Byte );
+static int      mStdDecode ( mStdBuild_t *BuildPtr, mStdHuffman_t *HuffPtr );
+static int      mStdConstruct ( mStdHuffman_t *HuffPtr, short *LengthPtr, int Num );
+static void     mStdStored ( mStdBuild_t *BuildPtr );
+static void     mStdCodes ( mStdBuild_t *, mStdHuffman_t *, mStdHuffman_t * );
+static void     mStdFixed ( mStdBuild_t *BuildPtr );
+static void     mStdDynamic ( mStdBuild_t *BuildPtr );
+static Status_t mStdAddPoint ( mStdBuild_t *BuildPtr );
+static Status_t mStdSkipGzHeader ( mStdBuild_t *BuildPtr );
+static Status_t mStdWriteIndex ( mStdBuild_t *BuildPtr, char *GzFilePtr );
+static void     mStdIndexName ( char *GzFilePtr, char *IndexFilePtr );
+static Status_t mStdFillShifted ( iStdGzStream_t *StreamPtr );
+
+
+/*****************************************************************************
+** Function Name:
+**    eStdGzIndexBuild
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Build the index of access points of a gzipped Sdb file.
+**
+** Description:
+**    Inflates the whole file, adding an access point at the first deflate
+**    block to start at least SpanSize bytes after the previous point, and
+**    writes the index alongside the file. The file must hold a single
+**    gzip member, as written by gzip. Block-structured Sdb files are not
+**    indexed, as readers pass over their blocks without an index.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if the file
+**       could not be read, E_STD_READ_DATA_ERR if it is not valid gzip,
+**       E_STD_READ_HEAD_ERR if it is block-structured,
+**       E_STD_FILE_WRITE_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char     *GzFilePtr         (in)
+**       Name of the gzipped Sdb file.
+**    size_t    SpanSize          (in)
+**       Least inflated bytes between access points.
+**    Uint32_t *NumPointsPtr      (out)
+**       Number of access points written.
+**
+*****************************************************************************/
+Status_t eStdGzIndexBuild( char *GzFilePtr,
+                           size_t SpanSize,
+                           Uint32_t *NumPointsPtr )
+{
+   Status_t     Status;         /* Return value of function calls */
+   mStdBuild_t *BuildPtr;       /* State of the inflater */
+   FILE        *GzFile;         /* The gzipped file */
+   gzFile       SdbFile;        /* The file, read through zlib */
+   char         Magic[ E_STD_FILE_HDR_SIZE ]; /* Header of the Sdb file */
+   struct stat  Stat;           /* Size of the gzipped file */
+   Uint32_t     Last;           /* Set on the last block */
+   Uint32_t     Type;           /* Type of block */
+   size_t       Trailer;        /* Position of the gzip trailer */
+
+   *NumPointsPtr = 0;
+
+   if ( SpanSize < I_STD_GZ_MIN_SPAN )
+   {
+      SpanSize = I_STD_GZ_MIN_SPAN;
+   }
+
+   /* Block-structured files need no index */
+   if ( ( SdbFile = gzopen( GzFilePtr, "rb" ) ) != NULL )
+   {
+      if ( ( gzread( SdbFile, Magic, sizeof( Magic ) ) == (int) sizeof( Magic ) ) &&
+           ( memcmp( Magic, E_SDB_HEADER_STRING_V2, E_STD_FILE_HDR_SIZE ) == 0 ) )
+      {
+         gzclose( SdbFile );
+         eLogErr(E_STD_READ_HEAD_ERR,"File %s is block-structured, not indexed",
+                 GzFilePtr);
+         return E_STD_READ_HEAD_ERR;
+      }
+      gzclose( SdbFile );
+   }
+
+   BuildPtr = (mStdBuild_t *) TTL_CALLOC( 1, sizeof( mStdBuild_t ) );
+   if ( BuildPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   BuildPtr->SpanSize = SpanSize;
+
+   /* The whole of the gzipped file is read in at once */
+   if ( ( ( GzFile = fopen( GzFilePtr, "rb" ) ) == NULL ) ||
+        ( fstat( fileno( GzFile ), &Stat ) != 0 ) )
+   {
+      if ( GzFile != NULL )
+      {
+         fclose( GzFile );
+      }
+      TTL_FREE( BuildPtr );
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to open file %s", GzFilePtr);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   BuildPtr->InLen = (size_t) Stat.st_size;
+   BuildPtr->InPtr = (unsigned char *) TTL_MALLOC( BuildPtr->InLen + 1 );
+   if ( BuildPtr->InPtr == NULL )
+   {
+      fclose( GzFile );
+      TTL_FREE( BuildPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if ( fread( BuildPtr->InPtr, 1, BuildPtr->InLen, GzFile ) != BuildPtr->InLen )
+   {
+      fclose( GzFile );
+      TTL_FREE( BuildPtr->InPtr );
+      TTL_FREE( BuildPtr );
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to read file %s", GzFilePtr);
+      return E_STD_FILE_OPEN_ERR;
+   }
+   fclose( GzFile );
+
+   /* Inflate each block in turn, adding access points as we go */
+   Status = mStdSkipGzHeader( BuildPtr );
+   Last   = 0;
+   while ( ( Status == SYS_NOMINAL ) && ( Last == 0 ) )
+   {
+      if ( ( BuildPtr->NumPoints == 0 ) ||
+           ( BuildPtr->Out - BuildPtr->Points[ BuildPtr->NumPoints - 1 ].OutOffset
+             >= BuildPtr->SpanSize ) )
+      {
+         Status = mStdAddPoint( BuildPtr );
+         if ( Status != SYS_NOMINAL )
+         {
+            break;
+         }
+      }
+
+      Last = mStdBits( BuildPtr, 1 );
+      Type = mStdBits( BuildPtr, 2 );
+      switch ( Type )
+      {
+         case 0:
+            mStdStored( BuildPtr );
+            break;
+         case 1:
+            mStdFixed( BuildPtr );
+            break;
+         case 2:
+            mStdDynamic( BuildPtr );
+            break;
+         default:
+            BuildPtr->Error = TRUE;
+            break;
+      }
+
+      if ( BuildPtr->Error == TRUE )
+      {
+         Status = E_STD_READ_DATA_ERR;
+      }
+   }
+
+   /* Anything after the trailer would be another member, not indexed */
+   Trailer = BuildPtr->InPos;
+   if ( ( Status == SYS_NOMINAL ) &&
+        ( Trailer + M_STD_GZ_TRAILER != BuildPtr->InLen ) )
+   {
+      Status = E_STD_READ_DATA_ERR;
+   }
+
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdWriteIndex( BuildPtr, GzFilePtr );
+      *NumPointsPtr = BuildPtr->NumPoints;
+   }
+   else if ( Status == E_STD_READ_DATA_ERR )
+   {
+      eLogErr(Status,"File %s is not a single gzip member of valid data",
+              GzFilePtr);
+   }
+
+   TTL_FREE( BuildPtr->Windows );
+   TTL_FREE( BuildPtr->Points );
+   TTL_FREE( BuildPtr->InPtr );
+   TTL_FREE( BuildPtr );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdGzIndexLoad
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Load the index of a gzipped Sdb file, if it has one.
+**
+** Description:
+**    Reads the header and access points of the index. The windows are
+**    read as each point is used, so the index file is kept open.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if there is no
+**       index or it is out of date, E_STD_READ_HEAD_ERR if it is not
+**       valid or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char          *GzFilePtr   (in)
+**       Name of the gzipped Sdb file.
+**    iStdGzIndex_t **IndexPtr   (out)
+**       The index, to be freed with iStdGzIndexFree.
+**
+*****************************************************************************/
+Status_t iStdGzIndexLoad( char *GzFilePtr, iStdGzIndex_t **IndexPtr )
+{
+   iStdGzIndex_t *NewPtr;                        /* Index being loaded */
+   char           IndexFile[ FILENAME_MAX ];     /* Name of the index */
+   struct stat    Stat;                          /* Size of the gzipped file */
+   size_t         Size;                          /* Size of the points */
+
+   *IndexPtr = NULL;
+
+   if ( strlen( GzFilePtr ) + sizeof( I_STD_EXT_GZINDEX ) > FILENAME_MAX )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   NewPtr = (iStdGzIndex_t *) TTL_CALLOC( 1, sizeof( iStdGzIndex_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   strcpy( NewPtr->GzFile, GzFilePtr );
+
+   mStdIndexName( GzFilePtr, IndexFile );
+   if ( ( NewPtr->IndexFile = fopen( IndexFile, "rb" ) ) == NULL )
+   {
+      TTL_FREE( NewPtr );
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   if ( ( fread( &NewPtr->Header, sizeof( iStdGzHeader_t ), 1,
+                 NewPtr->IndexFile ) != 1 ) ||
+        ( memcmp( NewPtr->Header.Magic, I_STD_GZ_MAGIC, 4 ) != 0 ) ||
+        ( NewPtr->Header.Version != I_STD_GZ_VERSION ) ||
+        ( NewPtr->Header.NumPoints == 0 ) )
+   {
+      eLogWarning(E_STD_READ_HEAD_ERR,"Ignoring invalid index %s", IndexFile);
+      iStdGzIndexFree( NewPtr );
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   /* The gzipped file may have been replaced since it was indexed */
+   if ( ( stat( GzFilePtr, &Stat ) != 0 ) ||
+        ( (Uint32_t) Stat.st_size != NewPtr->Header.GzSize ) )
+   {
+      eLogNotice(0,"Ignoring out of date index %s", IndexFile);
+      iStdGzIndexFree( NewPtr );
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   Size = sizeof( iStdGzPoint_t ) * NewPtr->Header.NumPoints;
+   NewPtr->Points = (iStdGzPoint_t *) TTL_MALLOC( Size );
+   if ( NewPtr->Points == NULL )
+   {
+      iStdGzIndexFree( NewPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if ( fread( NewPtr->Points, Size, 1, NewPtr->IndexFile ) != 1 )
+   {
+      eLogWarning(E_STD_READ_HEAD_ERR,"Ignoring invalid index %s", IndexFile);
+      iStdGzIndexFree( NewPtr );
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   *IndexPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdGzIndexFree
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Free an index loaded by iStdGzIndexLoad.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdGzIndex_t *IndexPtr   (in)
+**       The index, may be NULL.
+**
+*****************************************************************************/
+void iStdGzIndexFree( iStdGzIndex_t *IndexPtr )
+{
+   if ( IndexPtr == NULL )
+   {
+      return;
+   }
+
+   if ( IndexPtr->IndexFile != NULL )
+   {
+      fclose( IndexPtr->IndexFile );
+   }
+
+   TTL_FREE( IndexPtr->Points );
+   TTL_FREE( IndexPtr );
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdGzStreamOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Start inflating a gzipped Sdb file from an access point.
+**
+** Description:
+**    Inflation is raw, starting at the deflate block of the access point.
+**    Its window is first passed through as a stored block, so that the
+**    block may refer back to it. The data read by iStdGzStreamRead
+**    starts at the access point's OutOffset.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR,
+**       E_STD_READ_DATA_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdGzIndex_t  *IndexPtr   (in)
+**       Index of the file.
+**    Uint32_t        Point      (in)
+**       Access point to start from.
+**    iStdGzStream_t **StreamPtr (out)
+**       The inflation, to be closed with iStdGzStreamClose.
+**
+*****************************************************************************/
+Status_t iStdGzStreamOpen( iStdGzIndex_t *IndexPtr,
+                           Uint32_t Point,
+                           iStdGzStream_t **StreamPtr )
+{
+   iStdGzStream_t *NewPtr;        /* Inflation being started */
+   iStdGzPoint_t  *PointPtr;      /* Access point started from */
+   unsigned char  *StoredPtr;     /* Window as a stored block */
+   unsigned char  *DiscardPtr;    /* Window as inflated again */
+   Uint32_t        Size;          /* Size of the window */
+   int             Result;        /* Return value of zlib */
+   Status_t        Status;
+
+   *StreamPtr = NULL;
+   PointPtr   = IndexPtr->Points + Point;
+   Size       = PointPtr->WindowSize;
+
+   NewPtr = (iStdGzStream_t *) TTL_CALLOC( 1, sizeof( iStdGzStream_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   NewPtr->RawPtr   = (unsigned char *) TTL_MALLOC( M_STD_RAWSIZE );
+   NewPtr->ShiftPtr = (unsigned char *) TTL_MALLOC( M_STD_RAWSIZE );
+   StoredPtr        = (unsigned char *) TTL_MALLOC( I_STD_GZ_WINSIZE + 5 );
+   DiscardPtr       = (unsigned char *) TTL_MALLOC( I_STD_GZ_WINSIZE );
+   if ( ( NewPtr->RawPtr == NULL ) || ( NewPtr->ShiftPtr == NULL ) ||
+        ( StoredPtr == NULL ) || ( DiscardPtr == NULL ) )
+   {
+      TTL_FREE( StoredPtr );
+      TTL_FREE( DiscardPtr );
+      TTL_FREE( NewPtr->RawPtr );
+      TTL_FREE( NewPtr->ShiftPtr );
+      TTL_FREE( NewPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   NewPtr->Shift   = (int) PointPtr->InBits;
+   NewPtr->Pending = -1;
+
+   if ( inflateInit2( &NewPtr->Strm, -MAX_WBITS ) != Z_OK )
+   {
+      NewPtr->Strm.state = NULL;
+      Status = E_STD_MEM_ALLOC_ERR;
+   }
+   else if ( ( ( NewPtr->GzFile = fopen( IndexPtr->GzFile, "rb" ) ) == NULL ) ||
+             ( fseek( NewPtr->GzFile, (long) PointPtr->InOffset, SEEK_SET ) != 0 ) )
+   {
+      Status = E_STD_FILE_OPEN_ERR;
+   }
+   else
+   {
+      Status = SYS_NOMINAL;
+   }
+
+   /* Pass the window through as a non-final stored block */
+   if ( ( Status == SYS_NOMINAL ) && ( Size > 0 ) )
+   {
+      StoredPtr[ 0 ] = 0;
+      StoredPtr[ 1 ] = (unsigned char) ( Size & 0xff );
+      StoredPtr[ 2 ] = (unsigned char) ( ( Size >> 8 ) & 0xff );
+      StoredPtr[ 3 ] = (unsigned char) ( ~Size & 0xff );
+      StoredPtr[ 4 ] = (unsigned char) ( ( ~Size >> 8 ) & 0xff );
+
+      if ( ( fseek( IndexPtr->IndexFile, (long) PointPtr->WindowOffset, SEEK_SET ) != 0 ) ||
+           ( fread( StoredPtr + 5, 1, Size, IndexPtr->IndexFile ) != Size ) )
+      {
+         Status = E_STD_READ_DATA_ERR;
+      }
+      else
+      {
+         NewPtr->Strm.next_in   = StoredPtr;
+         NewPtr->Strm.avail_in  = Size + 5;
+         NewPtr->Strm.next_out  = DiscardPtr;
+         NewPtr->Strm.avail_out = I_STD_GZ_WINSIZE;
+         Result = inflate( &NewPtr->Strm, Z_NO_FLUSH );
+         if ( ( Result != Z_OK ) || ( NewPtr->Strm.avail_in != 0 ) ||
+              ( NewPtr->Strm.avail_out != I_STD_GZ_WINSIZE - Size ) )
+         {
+            Status = E_STD_READ_DATA_ERR;
+         }
+      }
+   }
+
+   TTL_FREE( StoredPtr );
+   TTL_FREE( DiscardPtr );
+
+   if ( Status != SYS_NOMINAL )
+   {
+      eLogErr(Status,"Unable to inflate %s from access point %u",
+              IndexPtr->GzFile, Point);
+      iStdGzStreamClose( NewPtr );
+      return Status;
+   }
+
+   NewPtr->Strm.avail_in = 0;
+   *StreamPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdGzStreamRead
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Inflate the next data from a gzipped Sdb file.
+**
+** Description:
+**    Fills the buffer unless the end of the deflate data is reached
+**    first.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or E_STD_READ_DATA_ERR.
+**
+** Arguments:
+**    iStdGzStream_t *StreamPtr   (in/out)
+**       The inflation.
+**    void           *BufferPtr   (out)
+**       Buffer for the data.
+**    size_t          Size        (in)
+**       Size of the buffer.
+**    size_t         *NumBytesPtr (out)
+**       Number of bytes inflated, less than Size at the end of the data.
+**
+*****************************************************************************/
+Status_t iStdGzStreamRead( iStdGzStream_t *StreamPtr,
+                           void *BufferPtr,
+                           size_t Size,
+                           size_t *NumBytesPtr )
+{
+   int      Result;      /* Return value of zlib */
+   Status_t Status;
+
+   StreamPtr->Strm.next_out  = (Bytef *) BufferPtr;
+   StreamPtr->Strm.avail_out = (uInt) Size;
+
+   while ( ( StreamPtr->Strm.avail_out > 0 ) && ( StreamPtr->Ended == FALSE ) )
+   {
+      if ( StreamPtr->Strm.avail_in == 0 )
+      {
+         if ( StreamPtr->RawEnd == TRUE )
+         {
+            /* Truncated file, keep what was inflated */
+            break;
+         }
+
+         Status = mStdFillShifted( StreamPtr );
+         if ( Status != SYS_NOMINAL )
+         {
+            *NumBytesPtr = Size - StreamPtr->Strm.avail_out;
+            return Status;
+         }
+      }
+
+      Result = inflate( &StreamPtr->Strm, Z_NO_FLUSH );
+      if ( Result == Z_STREAM_END )
+      {
+         StreamPtr->Ended = TRUE;
+      }
+      else if ( ( Result != Z_OK ) && ( Result != Z_BUF_ERROR ) )
+      {
+         *NumBytesPtr = Size - StreamPtr->Strm.avail_out;
+         return E_STD_READ_DATA_ERR;
+      }
+   }
+
+   *NumBytesPtr = Size - StreamPtr->Strm.avail_out;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdGzStreamClose
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Finish inflating a gzipped Sdb file from an access point.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdGzStream_t *StreamPtr   (in)
+**       The inflation, may be NULL.
+**
+*****************************************************************************/
+void iStdGzStreamClose( iStdGzStream_t *StreamPtr )
+{
+   if ( StreamPtr == NULL )
+   {
+      return;
+   }
+
+   if ( StreamPtr->Strm.state != NULL )
+   {
+      inflateEnd( &StreamPtr->Strm );
+   }
+
+   if ( StreamPtr->GzFile != NULL )
+   {
+      fclose( StreamPtr->GzFile );
+   }
+
+   TTL_FREE( StreamPtr->RawPtr );
+   TTL_FREE( StreamPtr->ShiftPtr );
+   TTL_FREE( StreamPtr );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFillShifted
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read more of the gzipped file for a resumed inflation.
+**
+** Description:
+**    The access point may start part way through a byte, so the data is
+**    shifted down by the bits belonging to the previous block. Deflate
+**    packs bits from the least significant end of each byte.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL, or E_STD_READ_DATA_ERR if reading fails.
+**
+** Arguments:
+**    iStdGzStream_t *StreamPtr   (in/out)
+**       The inflation, with no input left.
+**
+*****************************************************************************/
+static Status_t mStdFillShifted( iStdGzStream_t *StreamPtr )
+{
+   size_t NumRead;     /* Bytes read from the file */
+   size_t NumOut;      /* Bytes of shifted data */
+   size_t i;           /* Byte being shifted */
+   int    Shift;       /* Bits to shift by */
+
+   Shift   = StreamPtr->Shift;
+   NumRead = fread( StreamPtr->RawPtr, 1, M_STD_RAWSIZE, StreamPtr->GzFile );
+   if ( ferror( StreamPtr->GzFile ) )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   if ( NumRead < M_STD_RAWSIZE )
+   {
+      StreamPtr->RawEnd = TRUE;
+   }
+
+   if ( Shift == 0 )
+   {
+      memcpy( StreamPtr->ShiftPtr, StreamPtr->RawPtr, NumRead );
+      NumOut = NumRead;
+   }
+   else
+   {
+      NumOut = 0;
+      for ( i = 0; i < NumRead; i++ )
+      {
+         if ( StreamPtr->Pending >= 0 )
+         {
+            StreamPtr->ShiftPtr[ NumOut++ ] = (unsigned char)
+               ( ( StreamPtr->Pending >> Shift ) |
+                 ( StreamPtr->RawPtr[ i ] << ( 8 - Shift ) ) );
+         }
+         StreamPtr->Pending = StreamPtr->RawPtr[ i ];
+      }
+
+      if ( ( StreamPtr->RawEnd == TRUE ) && ( StreamPtr->Pending >= 0 ) )
+      {
+         StreamPtr->ShiftPtr[ NumOut++ ] =
+            (unsigned char) ( StreamPtr->Pending >> Shift );
+         StreamPtr->Pending = -1;
+      }
+   }
+
+   StreamPtr->Strm.next_in  = StreamPtr->ShiftPtr;
+   StreamPtr->Strm.avail_in = (uInt) NumOut;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBits
+**
+** Type:
+**    Uint32_t
+**
+** Purpose:
+**    Read bits from the deflate data being indexed.
+**
+** Description:
+**    Sets the error flag, and returns zero, at the end of the data.
+**
+** Return type:
+**    Uint32_t
+**       The bits, first read in the least significant bit.
+**
+** Arguments:
+**    mStdBuild_t *BuildPtr   (in/out)
+**       State of the inflater.
+**    int          Need       (in)
+**       Number of bits, at most 16.
+**
+*****************************************************************************/
+static Uint32_t mStdBits( mStdBuild_t *BuildPtr, int Need )
+{
+   Uint32_t Val;     /* Bits accumulated */
+
+   Val = BuildPtr->BitBuf;
+   while ( BuildPtr->BitCnt < Need )
+   {
+      if ( BuildPtr->InPos >= BuildPtr->InLen )
+      {
+         BuildPtr->Error = TRUE;
+         return 0;
+      }
+      Val |= (Uint32_t) BuildPtr->InPtr[ BuildPtr->InPos++ ] << BuildPtr->BitCnt;
+      BuildPtr->BitCnt += 8;
+   }
+
+   BuildPtr->BitBuf  = Val >> Need;
+   BuildPtr->BitCnt -= Need;
+
+   return Val & ( ( 1UL << Need ) - 1 );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdPut
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Take a byte inflated while building the index.
+**
+** Description:
+**    Keeps the window, and gathers bytes into records so the number and
+**    time range of the records starting in each span can be recorded.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    mStdBuild_t *BuildPtr   (in/out)
+**       State of the inflater.
+**    unsigned char Byte      (in)
+**       Byte inflated.
+**
+*****************************************************************************/
+static void mStdPut( mStdBuild_t *BuildPtr, unsigned char Byte )
+{
+   eSdbRawFmt_t   Record;      /* Record just completed */
+   iStdGzPoint_t *PointPtr;    /* Point of the span the record starts in */
+   Uint32_t       Start;       /* Offset the record starts at */
+
+   BuildPtr->Window[ BuildPtr->Out & ( I_STD_GZ_WINSIZE - 1 ) ] = Byte;
+   BuildPtr->Out++;
+
+   /* The header and hour precede the records */
+   if ( BuildPtr->Out <= E_STD_FILE_HDR_SIZE + sizeof( Uint32_t ) )
+   {
+      return;
+   }
+
+   BuildPtr->Record[ BuildPtr->RecordLen++ ] = Byte;
+   if ( BuildPtr->RecordLen < sizeof( eSdbRawFmt_t ) )
+   {
+      return;
+   }
+   BuildPtr->RecordLen = 0;
+
+   memcpy( &Record, BuildPtr->Record, sizeof( eSdbRawFmt_t ) );
+   Start    = BuildPtr->Out - sizeof( eSdbRawFmt_t );
+   PointPtr = BuildPtr->Points + BuildPtr->NumPoints - 1;
+   if ( Start < PointPtr->OutOffset )
+   {
+      PointPtr--;
+   }
+
+   if ( ( PointPtr->NumRecords == 0 ) || ( Record.TimeOffset < PointPtr->MinTime ) )
+   {
+      PointPtr->MinTime = Record.TimeOffset;
+   }
+   if ( ( PointPtr->NumRecords == 0 ) || ( Record.TimeOffset > PointPtr->MaxTime ) )
+   {
+      PointPtr->MaxTime = Record.TimeOffset;
+   }
+   PointPtr->NumRecords++;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdDecode
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Decode a symbol using a canonical Huffman code.
+**
+** Description:
+**    Reads a bit at a time, comparing the code so far with the first code
+**    of each length.
+**
+** Return type:
+**    int
+**       The symbol, or -1 with the error flag set if the code is invalid.
+**
+** Arguments:
+**    mStdBuild_t   *BuildPtr   (in/out)
+**       State of the inflater.
+**    mStdHuffman_t *HuffPtr    (in)
+**       The code.
+**
+*****************************************************************************/
+static int mStdDecode( mStdBuild_t *BuildPtr, mStdHuffman_t *HuffPtr )
+{
+   int Len;       /* Bits in the code so far */
+   int Code;      /* Code so far */
+   int First;     /* First code of this length */
+   int Count;     /* Number of codes of this length */
+   int Index;     /* Index of the first code of this length in Symbol */
+
+   Code = First = Index = 0;
+   for ( Len = 1; Len <= M_STD_MAXBITS; Len++ )
+   {
+      Code |= (int) mStdBits( BuildPtr, 1 );
+      Count = HuffPtr->Count[ Len ];
+      if ( Code - Count < First )
+      {
+         return HuffPtr->Symbol[ Index + ( Code - First ) ];
+      }
+      Index  += Count;
+      First  += Count;
+      First <<= 1;
+      Code  <<= 1;
+   }
+
+   BuildPtr->Error = TRUE;
+   return -1;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdConstruct
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Build a canonical Huffman code from the lengths of its codes.
+**
+** Description:
+**
+** Return type:
+**    int
+**       Zero for a complete code, negative if over-subscribed and positive
+**       if incomplete.
+**
+** Arguments:
+**    mStdHuffman_t *HuffPtr    (out)
+**       The code.
+**    short         *LengthPtr  (in)
+**       Length of the code of each symbol, zero if unused.
+**    int            Num        (in)
+**       Number of symbols.
+**
+*****************************************************************************/
+static int mStdConstruct( mStdHuffman_t *HuffPtr, short *LengthPtr, int Num )
+{
+   int   Symbol;                     /* Current symbol */
+   int   Len;                        /* Current length */
+   int   Left;                       /* Codes of this length left unused */
+   short Offs[ M_STD_MAXBITS + 1 ];  /* Offsets in Symbol of each length */
+
+   for ( Len = 0; Len <= M_STD_MAXBITS; Len++ )
+   {
+      HuffPtr->Count[ Len ] = 0;
+   }
+   for ( Symbol = 0; Symbol < Num; Symbol++ )
+   {
+      HuffPtr->Count[ LengthPtr[ Symbol ] ]++;
+   }
+   if ( HuffPtr->Count[ 0 ] == Num )
+   {
+      return 0;
+   }
+
+   Left = 1;
+   for ( Len = 1; Len <= M_STD_MAXBITS; Len++ )
+   {
+      Left <<= 1;
+      Left  -= HuffPtr->Count[ Len ];
+      if ( Left < 0 )
+      {
+         return Left;
+      }
+   }
+
+   Offs[ 1 ] = 0;
+   for ( Len = 1; Len < M_STD_MAXBITS; Len++ )
+   {
+      Offs[ Len + 1 ] = Offs[ Len ] + HuffPtr->Count[ Len ];
+   }
+   for ( Symbol = 0; Symbol < Num; Symbol++ )
+   {
+      if ( LengthPtr[ Symbol ] != 0 )
+      {
+         HuffPtr->Symbol[ Offs[ LengthPtr[ Symbol ] ]++ ] = (short) Symbol;
+      }
+   }
+
+   return Left;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdStored
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Inflate a stored block.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    mStdBuild_t *BuildPtr   (in/out)
+**       State of the inflater, following the block type.
+**
+*****************************************************************************/
+static void mStdStored( mStdBuild_t *BuildPtr )
+{
+   unsigned Len;     /* Length of the block */
+
+   /* Stored blocks start on a byte boundary */
+   BuildPtr->BitBuf = 0;
+   BuildPtr->BitCnt = 0;
+
+   if ( BuildPtr->InPos + 4 > BuildPtr->InLen )
+   {
+      BuildPtr->Error = TRUE;
+      return;
+   }
+   Len = BuildPtr->InPtr[ BuildPtr->InPos ] |
+         ( BuildPtr->InPtr[ BuildPtr->InPos + 1 ] << 8 );
+   if ( ( BuildPtr->InPtr[ BuildPtr->InPos + 2 ] != ( ~Len & 0xff ) ) ||
+        ( BuildPtr->InPtr[ BuildPtr->InPos + 3 ] != ( ( ~Len >> 8 ) & 0xff ) ) )
+   {
+      BuildPtr->Error = TRUE;
+      return;
+   }
+   BuildPtr->InPos += 4;
+
+   if ( BuildPtr->InPos + Len > BuildPtr->InLen )
+   {
+      BuildPtr->Error = TRUE;
+      return;
+   }
+   while ( Len-- > 0 )
+   {
+      mStdPut( BuildPtr, BuildPtr->InPtr[ BuildPtr->InPos++ ] );
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCodes
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Inflate the compressed data of a block.
+**
+** Description:
+**    Decodes literals and length/distance pairs until the end of block.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    mStdBuild_t   *BuildPtr   (in/out)
+**       State of the inflater.
+**    mStdHuffman_t *LenPtr     (in)
+**       Literal/length code.
+**    mStdHuffman_t *DistPtr    (in)
+**       Distance code.
+**
+*****************************************************************************/
+static void mStdCodes( mStdBuild_t   *BuildPtr,
+                       mStdHuffman_t *LenPtr,
+                       mStdHuffman_t *DistPtr )
+{
+   int      Symbol;     /* Decoded symbol */
+   Uint32_t Len;        /* Length of a copy */
+   Uint32_t Dist;       /* Distance back of a copy */
+
+   for ( ; ; )
+   {
+      Symbol = mStdDecode( BuildPtr, LenPtr );
+      if ( BuildPtr->Error == TRUE )
+      {
+         return;
+      }
+
+      if ( Symbol < 256 )
+      {
+         mStdPut( BuildPtr, (unsigned char) Symbol );
+         continue;
+      }
+
+      if ( Symbol == 256 )
+      {
+         return;
+      }
+
+      Symbol -= 257;
+      if ( Symbol >= 29 )
+      {
+         BuildPtr->Error = TRUE;
+         return;
+      }
+      Len = mStdLenBase[ Symbol ] + mStdBits( BuildPtr, mStdLenExtra[ Symbol ] );
+
+      Symbol = mStdDecode( BuildPtr, DistPtr );
+      if ( ( BuildPtr->Error == TRUE ) || ( Symbol < 0 ) || ( Symbol >= 30 ) )
+      {
+         BuildPtr->Error = TRUE;
+         return;
+      }
+      Dist = mStdDistBase[ Symbol ] + mStdBits( BuildPtr, mStdDistExtra[ Symbol ] );
+      if ( ( BuildPtr->Error == TRUE ) || ( Dist > BuildPtr->Out ) )
+      {
+         BuildPtr->Error = TRUE;
+         return;
+      }
+
+      while ( Len-- > 0 )
+      {
+         mStdPut( BuildPtr, BuildPtr->Window[ ( BuildPtr->Out - Dist ) &
+                                              ( I_STD_GZ_WINSIZE - 1 ) ] );
+      }
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdFixed
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Inflate a block compressed with the fixed Huffman codes.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    mStdBuild_t *BuildPtr   (in/out)
+**       State of the inflater, following the block type.
+**
+*****************************************************************************/
+static void mStdFixed( mStdBuild_t *BuildPtr )
+{
+   short         LenCount[ M_STD_MAXBITS + 1 ];
+   short         LenSymbol[ M_STD_FIXLCODES ];
+   short         DistCount[ M_STD_MAXBITS + 1 ];
+   short         DistSymbol[ M_STD_MAXDCODES ];
+   short         Lengths[ M_STD_FIXLCODES ];
+   mStdHuffman_t LenCode;
+   mStdHuffman_t DistCode;
+   int           Symbol;
+
+   LenCode.Count   = LenCount;
+   LenCode.Symbol  = LenSymbol;
+   DistCode.Count  = DistCount;
+   DistCode.Symbol = DistSymbol;
+
+   for ( Symbol = 0; Symbol < 144; Symbol++ )
+   {
+      Lengths[ Symbol ] = 8;
+   }
+   for ( ; Symbol < 256; Symbol++ )
+   {
+      Lengths[ Symbol ] = 9;
+   }
+   for ( ; Symbol < 280; Symbol++ )
+   {
+      Lengths[ Symbol ] = 7;
+   }
+   for ( ; Symbol < M_STD_FIXLCODES; Symbol++ )
+   {
+      Lengths[ Symbol ] = 8;
+   }
+   mStdConstruct( &LenCode, Lengths, M_STD_FIXLCODES );
+
+   for ( Symbol = 0; Symbol < M_STD_MAXDCODES; Symbol++ )
+   {
+      Lengths[ Symbol ] = 5;
+   }
+   mStdConstruct( &DistCode, Lengths, M_STD_MAXDCODES );
+
+   mStdCodes( BuildPtr, &LenCode, &DistCode );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdDynamic
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Inflate a block compressed with Huffman codes of its own.
+**
+** Description:
+**    Reads the codes from the block header, then the data.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    mStdBuild_t *BuildPtr   (in/out)
+**       State of the inflater, following the block type.
+**
+*****************************************************************************/
+static void mStdDynamic( mStdBuild_t *BuildPtr )
+{
+   short         LenCount[ M_STD_MAXBITS + 1 ];
+   short         LenSymbol[ M_STD_MAXLCODES ];
+   short         DistCount[ M_STD_MAXBITS + 1 ];
+   short         DistSymbol[ M_STD_MAXDCODES ];
+   short         Lengths[ M_STD_MAXLCODES + M_STD_MAXDCODES ];
+   mStdHuffman_t LenCode;
+   mStdHuffman_t DistCode;
+   int           NumLen;      /* Number of literal/length codes */
+   int           NumDist;     /* Number of distance codes */
+   int           NumCode;     /* Number of code length codes */
+   int           Index;       /* Length being read */
+   int           Symbol;      /* Decoded code length symbol */
+   int           Len;         /* Length to repeat */
+   int           Err;         /* Result of building a code */
+
+   LenCode.Count   = LenCount;
+   LenCode.Symbol  = LenSymbol;
+   DistCode.Count  = DistCount;
+   DistCode.Symbol = DistSymbol;
+
+   NumLen  = (int) mStdBits( BuildPtr, 5 ) + 257;
+   NumDist = (int) mStdBits( BuildPtr, 5 ) + 1;
+   NumCode = (int) mStdBits( BuildPtr, 4 ) + 4;
+   if ( ( NumLen > M_STD_MAXLCODES ) || ( NumDist > M_STD_MAXDCODES ) )
+   {
+      BuildPtr->Error = TRUE;
+      return;
+   }
+
+   /* Code lengths of the code length code */
+   for ( Index = 0; Index < NumCode; Index++ )
+   {
+      Lengths[ mStdLenOrder[ Index ] ] = (short) mStdBits( BuildPtr, 3 );
+   }
+   for ( ; Index < 19; Index++ )
+   {
+      Lengths[ mStdLenOrder[ Index ] ] = 0;
+   }
+   if ( ( BuildPtr->Error == TRUE ) ||
+        ( mStdConstruct( &LenCode, Lengths, 19 ) != 0 ) )
+   {
+      BuildPtr->Error = TRUE;
+      return;
+   }
+
+   /* Code lengths of the literal/length and distance codes */
+   Index = 0;
+   while ( Index < NumLen + NumDist )
+   {
+      Symbol = mStdDecode( BuildPtr, &LenCode );
+      if ( BuildPtr->Error == TRUE )
+      {
+         return;
+      }
+
+      if ( Symbol < 16 )
+      {
+         Lengths[ Index++ ] = (short) Symbol;
+         continue;
+      }
+
+      Len = 0;
+      if ( Symbol == 16 )
+      {
+         if ( Index == 0 )
+         {
+            BuildPtr->Error = TRUE;
+            return;
+         }
+         Len    = Lengths[ Index - 1 ];
+         Symbol = 3 + (int) mStdBits( BuildPtr, 2 );
+      }
+      else if ( Symbol == 17 )
+      {
+         Symbol = 3 + (int) mStdBits( BuildPtr, 3 );
+      }
+      else
+      {
+         Symbol = 11 + (int) mStdBits( BuildPtr, 7 );
+      }
+
+      if ( Index + Symbol > NumLen + NumDist )
+      {
+         BuildPtr->Error = TRUE;
+         return;
+      }
+      while ( Symbol-- > 0 )
+      {
+         Lengths[ Index++ ] = (short) Len;
+      }
+   }
+
+   /* There must be an end of block code */
+   if ( Lengths[ 256 ] == 0 )
+   {
+      BuildPtr->Error = TRUE;
+      return;
+   }
+
+   /* Incomplete codes are only allowed for a single length */
+   Err = mStdConstruct( &LenCode, Lengths, NumLen );
+   if ( ( Err < 0 ) || ( ( Err > 0 ) && ( NumLen - LenCode.Count[ 0 ] != 1 ) ) )
+   {
+      BuildPtr->Error = TRUE;
+      return;
+   }
+
+   Err = mStdConstruct( &DistCode, Lengths + NumLen, NumDist );
+   if ( ( Err < 0 ) || ( ( Err > 0 ) && ( NumDist - DistCode.Count[ 0 ] != 1 ) ) )
+   {
+      BuildPtr->Error = TRUE;
+      return;
+   }
+
+   mStdCodes( BuildPtr, &LenCode, &DistCode );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdAddPoint
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Add an access point at the start of the next deflate block.
+**
+** Description:
+**    Records the position of the block and copies the window.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdBuild_t *BuildPtr   (in/out)
+**       State of the inflater, at the start of a block.
+**
+*****************************************************************************/
+static Status_t mStdAddPoint( mStdBuild_t *BuildPtr )
+{
+   iStdGzPoint_t *PointPtr;    /* Point added */
+   unsigned char *WindowPtr;   /* Copy of the window */
+   void          *NewPtr;      /* Reallocated array */
+   Uint32_t       Bit;         /* Bit position of the block */
+   Uint32_t       Size;        /* Bytes of window */
+   Uint32_t       Wrap;        /* Index of the oldest byte in the window */
+
+   if ( BuildPtr->NumPoints == BuildPtr->MaxPoints )
+   {
+      NewPtr = TTL_REALLOC( BuildPtr->Points, sizeof( iStdGzPoint_t ) *
+                            ( BuildPtr->MaxPoints + M_STD_GZ_MORE ) );
+      if ( NewPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      BuildPtr->Points = (iStdGzPoint_t *) NewPtr;
+
+      NewPtr = TTL_REALLOC( BuildPtr->Windows, I_STD_GZ_WINSIZE *
+                            ( BuildPtr->MaxPoints + M_STD_GZ_MORE ) );
+      if ( NewPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      BuildPtr->Windows = (unsigned char *) NewPtr;
+
+      BuildPtr->MaxPoints += M_STD_GZ_MORE;
+   }
+
+   PointPtr  = BuildPtr->Points + BuildPtr->NumPoints;
+   WindowPtr = BuildPtr->Windows + I_STD_GZ_WINSIZE * BuildPtr->NumPoints;
+
+   Bit  = (Uint32_t) BuildPtr->InPos * 8 - BuildPtr->BitCnt;
+   Size = BuildPtr->Out < I_STD_GZ_WINSIZE ? BuildPtr->Out : I_STD_GZ_WINSIZE;
+
+   memset( PointPtr, 0, sizeof( iStdGzPoint_t ) );
+   PointPtr->InOffset   = Bit / 8;
+   PointPtr->InBits     = Bit % 8;
+   PointPtr->OutOffset  = BuildPtr->Out;
+   PointPtr->WindowSize = Size;
+
+   /* Oldest first */
+   Wrap = BuildPtr->Out & ( I_STD_GZ_WINSIZE - 1 );
+   if ( Size < I_STD_GZ_WINSIZE )
+   {
+      memcpy( WindowPtr, BuildPtr->Window, Size );
+   }
+   else
+   {
+      memcpy( WindowPtr, BuildPtr->Window + Wrap, I_STD_GZ_WINSIZE - Wrap );
+      memcpy( WindowPtr + I_STD_GZ_WINSIZE - Wrap, BuildPtr->Window, Wrap );
+   }
+
+   BuildPtr->NumPoints++;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSkipGzHeader
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Step over the gzip header preceding the deflate data.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL, or E_STD_READ_DATA_ERR if it is not a gzip
+**       header.
+**
+** Arguments:
+**    mStdBuild_t *BuildPtr   (in/out)
+**       State of the inflater, at the start of the file.
+**
+*****************************************************************************/
+static Status_t mStdSkipGzHeader( mStdBuild_t *BuildPtr )
+{
+   unsigned char *InPtr;    /* The file */
+   size_t         Pos;      /* Position in the header */
+   unsigned       Flags;    /* Header flags */
+
+   InPtr = BuildPtr->InPtr;
+
+   if ( ( BuildPtr->InLen < 10 ) || ( InPtr[ 0 ] != 0x1f ) ||
+        ( InPtr[ 1 ] != 0x8b ) || ( InPtr[ 2 ] != Z_DEFLATED ) )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+   Flags = InPtr[ 3 ];
+   Pos   = 10;
+
+   if ( Flags & M_STD_GZ_FEXTRA )
+   {
+      if ( Pos + 2 > BuildPtr->InLen )
+      {
+         return E_STD_READ_DATA_ERR;
+      }
+      Pos += 2 + ( InPtr[ Pos ] | ( InPtr[ Pos + 1 ] << 8 ) );
+   }
+   if ( Flags & M_STD_GZ_FNAME )
+   {
+      while ( ( Pos < BuildPtr->InLen ) && ( InPtr[ Pos ] != 0 ) )
+      {
+         Pos++;
+      }
+      Pos++;
+   }
+   if ( Flags & M_STD_GZ_FCOMMENT )
+   {
+      while ( ( Pos < BuildPtr->InLen ) && ( InPtr[ Pos ] != 0 ) )
+      {
+         Pos++;
+      }
+      Pos++;
+   }
+   if ( Flags & M_STD_GZ_FHCRC )
+   {
+      Pos += 2;
+   }
+
+   if ( Pos >= BuildPtr->InLen )
+   {
+      return E_STD_READ_DATA_ERR;
+   }
+
+   BuildPtr->InPos = Pos;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdWriteIndex
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write the index of a gzipped Sdb file.
+**
+** Description:
+**    Writes to a temporary file which replaces any existing index once
+**    complete, so a search never sees a partly written index.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or E_STD_FILE_WRITE_ERR.
+**
+** Arguments:
+**    mStdBuild_t *BuildPtr   (in/out)
+**       State of the inflater, having inflated the whole file.
+**    char        *GzFilePtr  (in)
+**       Name of the gzipped file.
+**
+*****************************************************************************/
+static Status_t mStdWriteIndex( mStdBuild_t *BuildPtr, char *GzFilePtr )
+{
+   iStdGzHeader_t Header;                        /* Header of the index */
+   char           IndexFile[ FILENAME_MAX ];     /* Name of the index */
+   char           TempFile[ FILENAME_MAX + 8 ];  /* Name while being written */
+   FILE          *OutFile;                       /* Index being written */
+   Uint32_t       Offset;                        /* Position of next window */
+   Uint32_t       i;                             /* Point being written */
+   Bool_t         Ok;                            /* All written */
+
+   if ( strlen( GzFilePtr ) + sizeof( I_STD_EXT_GZINDEX ) > FILENAME_MAX )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+   mStdIndexName( GzFilePtr, IndexFile );
+   sprintf( TempFile, "%s.tmp", IndexFile );
+
+   memcpy( Header.Magic, I_STD_GZ_MAGIC, 4 );
+   Header.Version   = I_STD_GZ_VERSION;
+   Header.GzSize    = (Uint32_t) BuildPtr->InLen;
+   Header.OutSize   = BuildPtr->Out;
+   Header.SpanSize  = (Uint32_t) BuildPtr->SpanSize;
+   Header.NumPoints = BuildPtr->NumPoints;
+
+   /* Windows follow the points */
+   Offset = sizeof( iStdGzHeader_t ) + sizeof( iStdGzPoint_t ) * BuildPtr->NumPoints;
+   for ( i = 0; i < BuildPtr->NumPoints; i++ )
+   {
+      BuildPtr->Points[ i ].WindowOffset = Offset;
+      Offset += BuildPtr->Points[ i ].WindowSize;
+   }
+
+   if ( ( OutFile = fopen( TempFile, "wb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to open file %s", TempFile);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   Ok = ( fwrite( &Header, sizeof( iStdGzHeader_t ), 1, OutFile ) == 1 ) &&
+        ( fwrite( BuildPtr->Points, sizeof( iStdGzPoint_t ),
+                  BuildPtr->NumPoints, OutFile ) == BuildPtr->NumPoints );
+   for ( i = 0; ( i < BuildPtr->NumPoints ) && Ok; i++ )
+   {
+      Ok = fwrite( BuildPtr->Windows + I_STD_GZ_WINSIZE * i, 1,
+                   BuildPtr->Points[ i ].WindowSize, OutFile )
+           == BuildPtr->Points[ i ].WindowSize;
+   }
+
+   if ( ( fclose( OutFile ) != 0 ) || !Ok ||
+        ( rename( TempFile, IndexFile ) != 0 ) )
+   {
+      remove( TempFile );
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to write index %s", IndexFile);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdIndexName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Generate the name of the index of a gzipped Sdb file.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    char *GzFilePtr      (in)
+**       Name of the gzipped file.
+**    char *IndexFilePtr   (out)
+**       Name of its index, FILENAME_MAX characters.
+**
+*****************************************************************************/
+static void mStdIndexName( char *GzFilePtr, char *IndexFilePtr )
+{
+   sprintf( IndexFilePtr, "%s%s", GzFilePtr, I_STD_EXT_GZINDEX );
+}
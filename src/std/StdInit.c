@@ -77,9 +77,37 @@
 *****************************************************************************/
 
 
+#include <sys/stat.h>
+#include <glob.h>
+
 /* Local include files */
 #include "StdPrivate.h"
 
+/* Local definitions */
+
+/* A source or datum name looked up, kept for the next time it is wanted */
+typedef struct mStdName_s
+{
+   Bool_t      Datum;      /* Name of a datum rather than a source */
+   Uint32_t    SourceId;   /* Source of the datum */
+   Uint32_t    Id;         /* Identifier of the source or datum */
+   char        Name[ E_STD_MAX_STRING_LEN ];
+} mStdName_t;
+
+/* Local variables */
+static mStdName_t *mStdNames    = NULL;  /* Names looked up so far */
+static Int32_t     mStdNumNames = 0;     /* Number of names kept */
+static Int32_t     mStdMaxNames = 0;     /* Names there is room for */
+
+/* Local function prototypes */
+Status_t mStdInitOutput ( iStdOutput_t *OutputPtr, char *ConfigFilePtr );
+Status_t mStdMakeRoom ( iStdOutput_t *OutputPtr, Int32_t NumData );
+static mStdName_t *mStdNameFind ( Bool_t Datum, Uint32_t SourceId, Uint32_t Id,
+                                  char *NamePtr );
+static void mStdNameKeep ( Bool_t Datum, Uint32_t SourceId, Uint32_t Id,
+                           char *NamePtr );
+static Status_t mStdReadAggs ( char *ListPtr );
+
 
 /*****************************************************************************
 ** Function Name:
@@ -118,17 +146,12 @@ Status_t iStdCluInit ( int argc, char *argv[] )
 {
    Status_t Status = SYS_NOMINAL;      /* Return status of function calls */
    char     Switch[ E_CLU_SWITCH_LEN ];/* to report error parsing a switch */
-   /*Int32_t  Id;*/
-   Int32_t  NumDataSearch;
-   /*unsigned Datum;*/
-   iStdData_t *StdDataPtr;
    eTtlTime_t Time;
    eStdTime_t *StartTimePtr;
    eStdTime_t *StopTimePtr;
    eStdTime_t TimeNow;
    char       TimeStr[E_STD_MAX_STRING_LEN];
    char      *ParamPtr = NULL;
-   int        i;
 
    /* data for command-line utilities */
    eCluProgNamePtr              = I_STD_PROGRAM_NAME;
@@ -150,32 +173,12 @@ Status_t iStdCluInit ( int argc, char *argv[] )
    strcpy( eCluCommon.CilName,    E_STD_DFLT_CIL     );
    strcpy( eCluCommon.CilMap,     E_STD_DFLT_CIL_MAP );
 
-   /* Initialise the file and data search parameters */
+   /* Initialise the file parameters, searches are set up per config file */
    iStdGlobVar.LoadFile = FALSE;
-   iStdGlobVar.NumDataSearch = 0;
-   StdDataPtr = iStdGlobVar.StdData;
+   iStdGlobVar.NumOutputs = 0;
+   iStdGlobVar.Outputs = NULL;
    StartTimePtr = &iStdGlobVar.StartTime;
    StopTimePtr = &iStdGlobVar.StopTime;
-   NumDataSearch = iStdGlobVar.NumDataSearch;
-   strncpy ( iStdGlobVar.OutFile, E_STD_DFLT_OUTFILE, E_STD_MAX_STRING_LEN);
-
-   
-   /*
-   ** Initialise the first data structure to all source
-   ** and all data id's.
-   */
-   for(i=0; i<E_STD_MAX_SEARCH_DATA; i++)
-   {
-      (StdDataPtr+i)->DataFlag = FALSE;
-      (StdDataPtr+i)->SourceId = E_CIL_BOL;
-      (StdDataPtr+i)->DatumId  = 0;      
-      strncpy ( (StdDataPtr+i)->SourceName, "???", E_STD_MAX_STRING_LEN);
-      strncpy ( (StdDataPtr+i)->DatumName , "???", E_STD_MAX_STRING_LEN);
-      strncpy ( (StdDataPtr+i)->DatumUnits, "???", E_STD_MAX_STRING_LEN);      
-      (StdDataPtr+i)->NumOfPoints = 0;
-      memset( &( (StdDataPtr+i)->NextStrideTime ), 0, 
-              sizeof( (StdDataPtr+i)->NextStrideTime ) );
-   }
 
 
    /* register with the command-line utilities (CLU), ignore all except help */
@@ -273,6 +276,291 @@ Status_t iStdCluInit ( int argc, char *argv[] )
       iStdGlobVar.WriteMatlab = FALSE;
       iStdGlobVar.WriteGnuplot = TRUE;
    }
+
+   iStdGlobVar.WriteInflux = I_STD_DFLT_INFLUX; /* Default */
+   strcpy( iStdGlobVar.Measurement, I_STD_DFLT_MEASURE );
+
+   if ( eCluCustomArgExists( I_STD_ARG_INFLUX ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Write line protocol for import with "influx -import" */
+      iStdGlobVar.WriteMatlab  = FALSE;
+      iStdGlobVar.WriteGnuplot = FALSE;
+      iStdGlobVar.WriteInflux  = TRUE;
+
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_INFLUX );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         strncpy( iStdGlobVar.Measurement, ParamPtr, I_STD_MAX_MEASURE - 1 );
+      }
+      eLogNotice(0,"Writing InfluxDB measurement \"%s\"",iStdGlobVar.Measurement);
+   }
+
+   iStdGlobVar.WriteLong = I_STD_DFLT_LONG; /* Default */
+
+   if ( eCluCustomArgExists( I_STD_ARG_LONG ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* A line per sample, in place of any other format */
+      iStdGlobVar.WriteMatlab  = FALSE;
+      iStdGlobVar.WriteGnuplot = FALSE;
+      iStdGlobVar.WriteInflux  = FALSE;
+      iStdGlobVar.WriteLong    = TRUE;
+   }
+
+   iStdGlobVar.WriteBinary = I_STD_DFLT_BINARY; /* Default */
+
+   if ( eCluCustomArgExists( I_STD_ARG_BINARY ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Binary records, in place of any other format */
+      iStdGlobVar.WriteMatlab  = FALSE;
+      iStdGlobVar.WriteGnuplot = FALSE;
+      iStdGlobVar.WriteInflux  = FALSE;
+      iStdGlobVar.WriteLong    = FALSE;
+      iStdGlobVar.WriteBinary  = TRUE;
+   }
+
+   /* By default read as many hours at once as there are processors */
+   iStdGlobVar.NumThreads = (Int32_t) sysconf( _SC_NPROCESSORS_ONLN );
+
+   if ( eCluCustomArgExists( I_STD_ARG_THREADS ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_THREADS );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         iStdGlobVar.NumThreads = (Int32_t) strtol( ParamPtr, NULL, 0 );
+      }
+   }
+
+   if ( iStdGlobVar.NumThreads < 1 )
+   {
+      iStdGlobVar.NumThreads = 1;
+   }
+   else if ( iStdGlobVar.NumThreads > I_STD_MAX_THREADS )
+   {
+      iStdGlobVar.NumThreads = I_STD_MAX_THREADS;
+   }
+
+   eLogNotice(0,"Worker threads = %d",iStdGlobVar.NumThreads);
+
+   /* Records read from gzipped files at once */
+   iStdGlobVar.ChunkSize = I_STD_DFLT_CHUNK;
+
+   if ( eCluCustomArgExists( I_STD_ARG_CHUNK ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_CHUNK );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         iStdGlobVar.ChunkSize = (size_t) strtoul( ParamPtr, NULL, 0 );
+      }
+   }
+
+   if ( iStdGlobVar.ChunkSize < 1 )
+   {
+      iStdGlobVar.ChunkSize = 1;
+   }
+
+   eLogNotice(0,"Chunk size = %lu records",(unsigned long) iStdGlobVar.ChunkSize);
+
+   /* Pass over hours holding nothing wanted, if the archive is catalogued */
+   iStdGlobVar.CatalogPtr = NULL;
+
+   if ( eCluCustomArgExists( I_STD_ARG_CATALOG ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_CATALOG );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         /* Without the catalog every hour is searched, just more slowly */
+         Status = eStdCatalogOpen( ParamPtr, &(iStdGlobVar.CatalogPtr) );
+         if ( SYS_NOMINAL != Status )
+         {
+            eLogWarning(Status,"Unable to use catalog %s",ParamPtr);
+         }
+         else
+         {
+            eLogNotice(0,"Archive catalog = \"%s\"",ParamPtr);
+         }
+      }
+   }
+
+   /* Read converted days from the columnar archive, if there is one */
+   iStdGlobVar.ColumnsPtr = NULL;
+
+   if ( eCluCustomArgExists( I_STD_ARG_COLUMNS ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_COLUMNS );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         /* Without the archive every hour is read from its Sdb file */
+         Status = eStdColumnsOpen( ParamPtr, &(iStdGlobVar.ColumnsPtr) );
+         if ( SYS_NOMINAL != Status )
+         {
+            eLogWarning(Status,"Unable to use columnar archive %s",ParamPtr);
+         }
+         else
+         {
+            eLogNotice(0,"Columnar archive = \"%s\"",ParamPtr);
+         }
+      }
+   }
+
+   /* Read only the Sdb files named, wherever they are */
+   iStdGlobVar.FilesPtr = NULL;
+
+   if ( eCluCustomArgExists( I_STD_ARG_FILES ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_FILES );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         /* Reading the path instead would not be what was asked for */
+         Status = eStdFilesOpen( ParamPtr, &(iStdGlobVar.FilesPtr) );
+         if ( SYS_NOMINAL != Status )
+         {
+            eLogErr(Status,"Unable to use Sdb files %s",ParamPtr);
+            return Status;
+         }
+         eLogNotice(0,"Sdb files = \"%s\"",ParamPtr);
+      }
+   }
+
+   /* Keep searching the file being written, once the hours before are done */
+   iStdGlobVar.FollowSecs = 0;
+
+   if ( eCluCustomArgExists( I_STD_ARG_FOLLOW ) == E_CLU_ARG_SUPPLIED )
+   {
+      iStdGlobVar.FollowSecs = I_STD_DFLT_FOLLOW;
+
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_FOLLOW );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         iStdGlobVar.FollowSecs = (Int32_t) strtol( ParamPtr, NULL, 0 );
+         if ( iStdGlobVar.FollowSecs < 1 )
+         {
+            iStdGlobVar.FollowSecs = 1;
+         }
+      }
+
+      eLogNotice(0,"Following the Sdb file being written, checking every %d seconds",
+                 iStdGlobVar.FollowSecs);
+   }
+
+   /* Roll up the whole days searched, from the records as they are decoded */
+   iStdGlobVar.RollupDir[0] = '\0';
+
+   if ( eCluCustomArgExists( I_STD_ARG_ROLLUP ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_ROLLUP );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         if ( strlen( ParamPtr ) >= I_STD_MAX_PATH_LEN )
+         {
+            eLogErr(E_STD_FILE_WRITE_ERR,"Rollup archive name %s is too long",ParamPtr);
+            return E_STD_FILE_WRITE_ERR;
+         }
+         strcpy( iStdGlobVar.RollupDir, ParamPtr );
+         eLogNotice(0,"Rollup archive = \"%s\"",ParamPtr);
+      }
+   }
+
+   /* Serve extraction requests in place of reading configuration files */
+   iStdGlobVar.ServePath[0] = '\0';
+   iStdGlobVar.NumWorkers   = I_STD_DFLT_WORKERS;
+
+   if ( eCluCustomArgExists( I_STD_ARG_SERVE ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_SERVE );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         if ( strlen( ParamPtr ) >= I_STD_MAX_PATH_LEN )
+         {
+            eLogErr(E_STD_FILE_OPEN_ERR,"Socket name %s is too long",ParamPtr);
+            return E_STD_FILE_OPEN_ERR;
+         }
+         strcpy( iStdGlobVar.ServePath, ParamPtr );
+      }
+   }
+
+   if ( eCluCustomArgExists( I_STD_ARG_WORKERS ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_WORKERS );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         iStdGlobVar.NumWorkers = (Int32_t) strtol( ParamPtr, NULL, 0 );
+      }
+   }
+
+   if ( iStdGlobVar.NumWorkers < 1 )
+   {
+      iStdGlobVar.NumWorkers = 1;
+   }
+   else if ( iStdGlobVar.NumWorkers > I_STD_MAX_WORKERS )
+   {
+      iStdGlobVar.NumWorkers = I_STD_MAX_WORKERS;
+   }
+
+   /* Summarise each stride, in place of keeping its first sample */
+   iStdGlobVar.Window  = 0;
+   iStdGlobVar.NumAggs = 0;
+
+   if ( eCluCustomArgExists( I_STD_ARG_AGG ) == E_CLU_ARG_SUPPLIED )
+   {
+      /* Get pointer to parameter */
+      ParamPtr = eCluGetCustomParam( I_STD_ARG_AGG );
+      /* If parameter supplied */
+      if ( ParamPtr != NULL )
+      {
+         Status = mStdReadAggs( ParamPtr );
+         if ( SYS_NOMINAL != Status )
+         {
+            return Status;
+         }
+      }
+
+      if ( ( iStdGlobVar.NumAggs == 0 ) || ( iStdGlobVar.Stride <= 0 ) )
+      {
+         eLogErr(E_STD_GEN_ERROR,"Summarising needs a stride and a summary");
+         return E_STD_GEN_ERROR;
+      }
+
+      /* Every sample is wanted, so none are passed over by the stride */
+      iStdGlobVar.Window = iStdGlobVar.Stride;
+      iStdGlobVar.Stride = 0;
+
+      eLogNotice(0,"Summarising strides of %d seconds by %s",
+                 iStdGlobVar.Window,ParamPtr);
+   }
+
+   if ( iStdGlobVar.ServePath[0] != '\0' )
+   {
+      eLogNotice(0,"Serving requests on \"%s\" with %d workers",
+                 iStdGlobVar.ServePath,iStdGlobVar.NumWorkers);
+
+      /* A request is answered once its search is done */
+      if ( iStdGlobVar.FollowSecs > 0 )
+      {
+         eLogWarning(0,"Requests served are not followed");
+         iStdGlobVar.FollowSecs = 0;
+      }
+   }
+
    /* 
    ** Set the default start and stop times to now 
    ** just in case a time is not specified in the
@@ -311,6 +599,157 @@ Status_t iStdCluInit ( int argc, char *argv[] )
    return (Status);
 }
 
+/*****************************************************************************
+** Function Name:
+**    iStdReadConfigs
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read in every configuration file to be extracted.
+**
+** Description:
+**    By default the single configuration file given by the common '-conf'
+**    switch is used. If '-configs' is supplied its parameter is either a
+**    directory, in which case all *.cfg files within it are read, or a
+**    file name pattern (e.g. "datums*.cfg"). One output is set up for
+**    each configuration file so that all of them can be filled from a
+**    single pass over the Sdb data.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success;
+**
+** Arguments:
+**    void
+**
+*****************************************************************************/
+
+Status_t iStdReadConfigs ( void )
+{
+   Status_t     Status;              /* Return status of function calls */
+   char        *ParamPtr;            /* Parameter supplied with '-configs' */
+   char         Pattern[ FILENAME_MAX ]; /* Pattern of config files to read */
+   struct stat  FileStat;            /* To check for a directory */
+   glob_t       ConfigFiles;         /* List of matched config files */
+   size_t       i;                   /* Counter */
+
+   /* Only a single configuration file requested */
+   if ( eCluCustomArgExists( I_STD_ARG_CONFIGS ) != E_CLU_ARG_SUPPLIED )
+   {
+      return iStdReadSingleConfig ( eCluCommon.ConfigFile );
+   }
+
+   /* Work out which files are wanted */
+   ParamPtr = eCluGetCustomParam( I_STD_ARG_CONFIGS );
+   if ( ( ParamPtr == NULL ) || 
+        ( strlen( ParamPtr ) + strlen( I_STD_EXT_CONFIG ) + 1 >= FILENAME_MAX ) )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR, "Invalid list of configuration files");
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   strcpy( Pattern, ParamPtr );
+   if ( ( stat( ParamPtr, &FileStat ) == 0 ) && S_ISDIR( FileStat.st_mode ) )
+   {
+      if ( Pattern[ strlen( Pattern ) - 1 ] != '/' )
+      {
+         strcat( Pattern, "/" );
+      }
+      strcat( Pattern, I_STD_EXT_CONFIG );
+   }
+
+   if ( ( glob( Pattern, 0, NULL, &ConfigFiles ) != 0 ) || 
+        ( ConfigFiles.gl_pathc == 0 ) )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR, "No configuration files match %s", Pattern);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   iStdGlobVar.Outputs = (iStdOutput_t *) 
+                TTL_MALLOC( sizeof(iStdOutput_t) * ConfigFiles.gl_pathc );
+   if ( iStdGlobVar.Outputs == NULL )
+   {
+      globfree( &ConfigFiles );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   iStdGlobVar.NumOutputs = (Int32_t) ConfigFiles.gl_pathc;
+
+   /* Read each of the files in turn */
+   for ( i = 0; i < ConfigFiles.gl_pathc; i++ )
+   {
+      Status = mStdInitOutput( iStdGlobVar.Outputs + i, ConfigFiles.gl_pathv[ i ] );
+      if( SYS_NOMINAL == Status )
+      {
+         Status = iStdReadConfig ( ConfigFiles.gl_pathv[ i ], iStdGlobVar.Outputs + i );
+      }
+      if( SYS_NOMINAL != Status )
+      {
+         eLogErr(Status, "Can't read configuration file %s", 
+                 ConfigFiles.gl_pathv[ i ]);
+         globfree( &ConfigFiles );
+         return Status;
+      }
+   }
+
+   eLogNotice(0, "Extracting %d configuration files from %s", 
+              iStdGlobVar.NumOutputs, Pattern);
+
+   globfree( &ConfigFiles );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdReadSingleConfig
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read in a single configuration file to be extracted.
+**
+** Description:
+**    A single output is set up from the file. Should the file not be
+**    read, the output is left searching for the source/datum pair given
+**    by default.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char *ConfigFilePtr       (in)
+**       Configuration file to be read.
+**
+*****************************************************************************/
+
+Status_t iStdReadSingleConfig ( char *ConfigFilePtr )
+{
+   Status_t     Status;              /* Return status of function calls */
+
+   iStdGlobVar.Outputs = (iStdOutput_t *) TTL_MALLOC( sizeof(iStdOutput_t) );
+   if ( iStdGlobVar.Outputs == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   iStdGlobVar.NumOutputs = 1;
+   Status = mStdInitOutput( iStdGlobVar.Outputs, ConfigFilePtr );
+   if( SYS_NOMINAL != Status )
+   {
+      return Status;
+   }
+
+   Status = iStdReadConfig ( ConfigFilePtr, iStdGlobVar.Outputs );
+   if( SYS_NOMINAL != Status )
+   {
+      eLogInfo("Can't read configuration file %s",ConfigFilePtr);
+   }
+   return SYS_NOMINAL;
+}
+
 /*****************************************************************************
 ** Function Name:
 **    StdReadConfig
@@ -332,6 +771,8 @@ Status_t iStdCluInit ( int argc, char *argv[] )
 ** Argu11nts:
 **    char *ConfigFilePtr[]             (in)
 **       Pointer to the configuration file to be searched.
+**    iStdOutput_t *OutputPtr           (out)
+**       Search and output details to be filled in from the file.
 **
 ** Authors:
 **    djm: Derek J. McKay (TTL)
@@ -339,7 +780,7 @@ Status_t iStdCluInit ( int argc, char *argv[] )
 **
 *****************************************************************************/
 
-Status_t iStdReadConfig ( char *ConfigFilePtr )
+Status_t iStdReadConfig ( char *ConfigFilePtr, iStdOutput_t *OutputPtr )
 {
    Status_t    Status = SYS_NOMINAL;       /* Current status */
    char        Line[ E_CFU_STRING_LEN ];   /* To store line of config file */
@@ -356,15 +797,13 @@ Status_t iStdReadConfig ( char *ConfigFilePtr )
    eStdTime_t  *StopTimePtr;  /* Time to finish search */
   
    /*
-   ** Update values from the global structure and
+   ** Update values from the output structure and
    ** initialise pointers.
    */
-   NumDataSearch = iStdGlobVar.NumDataSearch;
-   StdDataPtr    = iStdGlobVar.StdData;
-   StartTimePtr  = &iStdGlobVar.StartTime; 
-   StopTimePtr   = &iStdGlobVar.StopTime;
-   iStdLastMatchedPtr  = NULL;
-   iStdLinesOfData     = 0;
+   NumDataSearch = OutputPtr->NumDataSearch;
+   StdDataPtr    = OutputPtr->StdData;
+   StartTimePtr  = &OutputPtr->StartTime; 
+   StopTimePtr   = &OutputPtr->StopTime;
    
    /* Open the configuration file */
    Status = eCfuSetup ( ConfigFilePtr );
@@ -375,7 +814,8 @@ Status_t iStdReadConfig ( char *ConfigFilePtr )
       Set the numver of datum to search for to 1 so we
       can use the command line options.
       */
-      iStdGlobVar.NumDataSearch = 1;      
+      OutputPtr->NumDataSearch = 1;      
+      eCfuComplete();
       return Status;
    }
    else
@@ -403,8 +843,9 @@ Status_t iStdReadConfig ( char *ConfigFilePtr )
             ItemFound = 1;
             if( eCfuGetParam( Value1 ) == SYS_NOMINAL)
             {
-               strncpy( iStdGlobVar.OutFile, Value1, E_STD_MAX_STRING_LEN);
-               eLogDebug("Output file = %s", iStdGlobVar.OutFile);
+               strncpy( OutputPtr->OutFile, Value1, E_STD_MAX_STRING_LEN - 1 );
+               OutputPtr->OutFile[ E_STD_MAX_STRING_LEN - 1 ] = '\0';
+               eLogDebug("Output file = %s", OutputPtr->OutFile);
             }
             else
             {
@@ -427,6 +868,7 @@ Status_t iStdReadConfig ( char *ConfigFilePtr )
                   StartTimePtr->Minute      = Minute;
                   StartTimePtr->Second      = Second;                   
                   StartTimePtr->MilliSecond = 0;
+                  OutputPtr->StartGiven     = TRUE;
                   eLogDebug("Start time = %.2d/%.2d/%.2d %.2d:%.2d:%.2d",Year,Month,Date,Hour,Minute,Second);
                }
                else
@@ -455,6 +897,7 @@ Status_t iStdReadConfig ( char *ConfigFilePtr )
                   StopTimePtr->Minute      = Minute;
                   StopTimePtr->Second      = Second;
                   StopTimePtr->MilliSecond = 0;
+                  OutputPtr->StopGiven     = TRUE;
                   eLogDebug("Stop time  = %.2d/%.2d/%.2d %.2d:%.2d:%.2d",Year,Month,Date,Hour,Minute,Second);
                }
                else
@@ -479,8 +922,7 @@ Status_t iStdReadConfig ( char *ConfigFilePtr )
          ** Both source and datum Id's can be either integers
          ** or a string e.g. it will accept either 20 or AGS.       
          */
-         if( (strncmp (KeyWord, "DATA", strlen(KeyWord)) == 0) &&
-             NumDataSearch < E_STD_MAX_SEARCH_DATA )
+         if( (strncmp (KeyWord, "DATA", strlen(KeyWord)) == 0) )
          {
             ItemFound = 1;
             eLogDebug("Found a config item");
@@ -488,6 +930,17 @@ Status_t iStdReadConfig ( char *ConfigFilePtr )
                  eCfuGetParam( Value2 ) == SYS_NOMINAL   )
             {
 
+               /* Make sure there is room for another data item */
+               Status = mStdMakeRoom( OutputPtr, NumDataSearch + 1 );
+               if( SYS_NOMINAL != Status )
+               {
+                  eLogErr(Status,"Error allocating memory for data item %d", 
+                          NumDataSearch + 1);
+                  eCfuComplete();
+                  return Status;
+               }
+               StdDataPtr = OutputPtr->StdData;
+
                /* 
                ** Found a data item to search for so increment the
                ** counter. 
@@ -553,12 +1006,15 @@ Status_t iStdReadConfig ( char *ConfigFilePtr )
       }
    }
 
+   /* Finished with the configuration file */
+   eCfuComplete();
+
    /*
    ** Managed to read the configuration file 
    ** and found NumDataSearch items to look 
    ** for
    */
-   iStdGlobVar.NumDataSearch=NumDataSearch;
+   OutputPtr->NumDataSearch=NumDataSearch;
 
    /* Every thing has worked if we make it here */
    return SYS_NOMINAL;
@@ -576,35 +1032,40 @@ Status_t iStdReadConfig ( char *ConfigFilePtr )
 **    or vice versa.
 **
 ** Description:
+**    Each name or identifier found is kept, so that the CIL map and ID
+**    tables are read for it only the first time it is asked for, however
+**    many outputs, or requests served, ask for it afterwards.
 **
 ** Return type:
 **    Status_t
 **       Returns SYS_NOMINAL on success;
 **
 ** Arguments;
-**    void
+**    iStdOutput_t *OutputPtr   (in/out)
+**       Source/datum pairs to be completed.
 **
 ** Authors:
 **    man: Martin Norbury
 **
 *****************************************************************************/
 
-Status_t iStdSrcDtmName ( void ) 
+Status_t iStdSrcDtmName ( iStdOutput_t *OutputPtr ) 
 {
    Status_t Status;
    int i;
    Int32_t     ReadSourceInt, ReadDatumInt;/* Source and Datum to search for*/
    iStdData_t *StdDataPtr; /* Pointer to requested data id's */
+   mStdName_t *NamePtr;    /* Name already looked up */
 
    /* Initialise the pointer to the data */
-   StdDataPtr = iStdGlobVar.StdData;
+   StdDataPtr = OutputPtr->StdData;
 
    /* 
    ** Get the CIL name, datum name and units
    ** for the data we are searching for
    */
 
-   for( i=0 ; i<iStdGlobVar.NumDataSearch; i++)
+   for( i=0 ; i<OutputPtr->NumDataSearch; i++)
    {
 
       /* 
@@ -614,26 +1075,44 @@ Status_t iStdSrcDtmName ( void )
       ** then there is a problem.
       */
       if( (StdDataPtr+i)->SourceId == 0 )
-      {                                                                                
-         eLogDebug("Getting source ID from CIL name %s",(StdDataPtr+i)->SourceName);     
-         Status = eCilLookup( eCluCommon.CilMap, (StdDataPtr+i)->SourceName, &ReadSourceInt);
-         (StdDataPtr+i)->SourceId = (Uint32_t) ReadSourceInt;
-         if( Status != SYS_NOMINAL )
+      {
+         NamePtr = mStdNameFind( FALSE, 0, 0, (StdDataPtr+i)->SourceName );
+         if( NamePtr != NULL )
          {
-            eLogErr(Status, "Error getting CIL Id for %s", (StdDataPtr+i)->SourceName );
-            return Status;
+            (StdDataPtr+i)->SourceId = NamePtr->Id;
+         }
+         else
+         {
+            eLogDebug("Getting source ID from CIL name %s",(StdDataPtr+i)->SourceName);     
+            Status = eCilLookup( eCluCommon.CilMap, (StdDataPtr+i)->SourceName, &ReadSourceInt);
+            (StdDataPtr+i)->SourceId = (Uint32_t) ReadSourceInt;
+            if( Status != SYS_NOMINAL )
+            {
+               eLogErr(Status, "Error getting CIL Id for %s", (StdDataPtr+i)->SourceName );
+               return Status;
+            }
+            mStdNameKeep( FALSE, 0, (StdDataPtr+i)->SourceId, (StdDataPtr+i)->SourceName );
          }
          eLogDebug("Source name %s is %d", (StdDataPtr+i)->SourceName, (StdDataPtr+i)->SourceId);
       }                  
       else if ( strcmp( (StdDataPtr+i)->SourceName, "???") == 0)
       {
-         eLogDebug("Getting CIL name for source ID %d", (StdDataPtr+i)->SourceId);      
-         Status = eCilName( eCluCommon.CilMap, (StdDataPtr+i)->SourceId, 
-                            E_CIL_IDLEN, (StdDataPtr+i)->SourceName);
-         if( Status != SYS_NOMINAL )
+         NamePtr = mStdNameFind( FALSE, 0, (StdDataPtr+i)->SourceId, NULL );
+         if( NamePtr != NULL )
          {
-            eLogErr(Status, "Error getting CIL name for Id=0x%x", (StdDataPtr+i)->SourceId );
-            return Status;
+            strcpy( (StdDataPtr+i)->SourceName, NamePtr->Name );
+         }
+         else
+         {
+            eLogDebug("Getting CIL name for source ID %d", (StdDataPtr+i)->SourceId);      
+            Status = eCilName( eCluCommon.CilMap, (StdDataPtr+i)->SourceId, 
+                               E_CIL_IDLEN, (StdDataPtr+i)->SourceName);
+            if( Status != SYS_NOMINAL )
+            {
+               eLogErr(Status, "Error getting CIL name for Id=0x%x", (StdDataPtr+i)->SourceId );
+               return Status;
+            }
+            mStdNameKeep( FALSE, 0, (StdDataPtr+i)->SourceId, (StdDataPtr+i)->SourceName );
          }
          eLogDebug("Source Id %d is %s", (StdDataPtr+i)->SourceId, (StdDataPtr+i)->SourceName);
       }
@@ -651,26 +1130,49 @@ Status_t iStdSrcDtmName ( void )
 
       if( (StdDataPtr+i)->DatumId == 0 )
       {         
-        eLogDebug("Getting datum ID from datum name %s",(StdDataPtr+i)->DatumName);    
-        Status = eHtiGetGeneralId( (StdDataPtr+i)->SourceId, (StdDataPtr+i)->DatumName, &ReadDatumInt);
-        (StdDataPtr+i)->DatumId = (Uint32_t) ReadDatumInt;
-        if( Status != SYS_NOMINAL )
+        NamePtr = mStdNameFind( TRUE, (StdDataPtr+i)->SourceId, 0, (StdDataPtr+i)->DatumName );
+        if( NamePtr != NULL )
+        {
+           (StdDataPtr+i)->DatumId = NamePtr->Id;
+        }
+        else
         {
-           eLogErr(Status, "Error getting datum Id for %s", (StdDataPtr+i)->DatumName );
-           return Status;
+           eLogDebug("Getting datum ID from datum name %s",(StdDataPtr+i)->DatumName);    
+           Status = eHtiGetGeneralId( (StdDataPtr+i)->SourceId, (StdDataPtr+i)->DatumName, &ReadDatumInt);
+           (StdDataPtr+i)->DatumId = (Uint32_t) ReadDatumInt;
+           if( Status != SYS_NOMINAL )
+           {
+              eLogErr(Status, "Error getting datum Id for %s", (StdDataPtr+i)->DatumName );
+              return Status;
+           }
+           mStdNameKeep( TRUE, (StdDataPtr+i)->SourceId, (StdDataPtr+i)->DatumId,
+                         (StdDataPtr+i)->DatumName );
         }
         
         eLogDebug("Source name %s is %d", (StdDataPtr+i)->DatumName, (StdDataPtr+i)->DatumId);
       }
       else if ( strcmp( (StdDataPtr+i)->DatumName, "???") == 0)
       {
-         eLogDebug("Getting datum name from datum ID %d", (StdDataPtr+i)->DatumId);
-         Status = eHtiGetDataLabel( (StdDataPtr+i)->SourceId, (StdDataPtr+i)->DatumId, (StdDataPtr+i)->DatumName );
-         if( Status != SYS_NOMINAL )
+         NamePtr = mStdNameFind( TRUE, (StdDataPtr+i)->SourceId, (StdDataPtr+i)->DatumId, NULL );
+         if( NamePtr != NULL )
          {
-            eLogErr(Status, "Error getting datum name for Id=0x%x", (StdDataPtr+i)->SourceId );
-            sprintf( (StdDataPtr+i)->DatumName, "0x%x", (StdDataPtr+i)->DatumId );
-            Status = SYS_NOMINAL;
+            strcpy( (StdDataPtr+i)->DatumName, NamePtr->Name );
+         }
+         else
+         {
+            eLogDebug("Getting datum name from datum ID %d", (StdDataPtr+i)->DatumId);
+            Status = eHtiGetDataLabel( (StdDataPtr+i)->SourceId, (StdDataPtr+i)->DatumId, (StdDataPtr+i)->DatumName );
+            if( Status != SYS_NOMINAL )
+            {
+               eLogErr(Status, "Error getting datum name for Id=0x%x", (StdDataPtr+i)->SourceId );
+               sprintf( (StdDataPtr+i)->DatumName, "0x%x", (StdDataPtr+i)->DatumId );
+               Status = SYS_NOMINAL;
+            }
+            else
+            {
+               mStdNameKeep( TRUE, (StdDataPtr+i)->SourceId, (StdDataPtr+i)->DatumId,
+                             (StdDataPtr+i)->DatumName );
+            }
          }
          eLogDebug("Datum Id %d is %s", (StdDataPtr+i)->DatumId, (StdDataPtr+i)->DatumName); 
       }
@@ -703,21 +1205,21 @@ Status_t iStdSrcDtmName ( void )
 **       Returns SYS_NOMINAL on success;
 **
 ** Arguments;
-**    eTtlTime_t *StartTime   (out)
-**       Pointer to the Ttl format start time
-**    eTtlTime_t *StopTime    (out)
-**       Pointer to the Ttl format stop time
+**    iStdOutput_t *OutputPtr (in/out)
+**       Output whose start and stop times are to be converted.
 **
 ** Authors:
 **    man: Martin Norbury
 **
 *****************************************************************************/
-Status_t iStdStartStopTime( eTtlTime_t *TtlStartPtr, eTtlTime_t *TtlStopPtr )
+Status_t iStdStartStopTime( iStdOutput_t *OutputPtr )
 {
    struct tm starttime;
    struct tm stoptime;
    eStdTime_t  *StdStartPtr; /* Time to begin search */
    eStdTime_t  *StdStopPtr;  /* Time to finish search */
+   eTtlTime_t  *TtlStartPtr; /* Time to begin search (Ttl format) */
+   eTtlTime_t  *TtlStopPtr;  /* Time to finish search (Ttl format) */
    char       TimeStr[E_STD_MAX_STRING_LEN]; /* String to contain timestamp */
    Status_t   Status;
 
@@ -738,8 +1240,10 @@ Status_t iStdStartStopTime( eTtlTime_t *TtlStartPtr, eTtlTime_t *TtlStopPtr )
    setenv( "TZ", "0", 1 );
    eLogInfo( "Now TZ=%s", getenv( "TZ" ) );
 
-   StdStartPtr = &iStdGlobVar.StartTime; 
-   StdStopPtr  = &iStdGlobVar.StopTime;
+   StdStartPtr = &OutputPtr->StartTime; 
+   StdStopPtr  = &OutputPtr->StopTime;
+   TtlStartPtr = &OutputPtr->TtlStartTime;
+   TtlStopPtr  = &OutputPtr->TtlStopTime;
 
    starttime.tm_year  = StdStartPtr->Year - 1900;
    starttime.tm_mon   = StdStartPtr->Month -1;
@@ -784,3 +1288,382 @@ Status_t iStdStartStopTime( eTtlTime_t *TtlStartPtr, eTtlTime_t *TtlStopPtr )
    eLogNotice(0,"Stop time  %s",TimeStr);
    return SYS_NOMINAL;
 }
+
+/*****************************************************************************
+** Function Name:
+**    mStdInitOutput
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Set an output to its defaults before reading its configuration file.
+**
+** Description:
+**    All source/datum pairs are cleared, the output file defaults to the
+**    standard output file and the search times default to those set up
+**    when the command line was parsed.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success;
+**
+** Arguments;
+**    iStdOutput_t *OutputPtr  (out)
+**       Output to be initialised.
+**    char *ConfigFilePtr      (in)
+**       Name of the configuration file describing the output.
+**
+*****************************************************************************/
+Status_t mStdInitOutput ( iStdOutput_t *OutputPtr, char *ConfigFilePtr )
+{
+   memset( OutputPtr, 0, sizeof( *OutputPtr ) );
+
+   strncpy( OutputPtr->ConfigFile, ConfigFilePtr, FILENAME_MAX - 1 );
+   strncpy( OutputPtr->OutFile, E_STD_DFLT_OUTFILE, E_STD_MAX_STRING_LEN);
+   OutputPtr->OutFilePtr     = NULL;
+   OutputPtr->StartTime      = iStdGlobVar.StartTime;
+   OutputPtr->StopTime       = iStdGlobVar.StopTime;
+   OutputPtr->NumDataSearch  = 0;
+   OutputPtr->MaxDataSearch  = 0;
+   OutputPtr->StdData        = NULL;
+   OutputPtr->LinesOfData    = 0;
+
+   /*
+   ** Initialise the first data structure to all source
+   ** and all data id's.
+   */
+   return mStdMakeRoom( OutputPtr, I_STD_DFLT_COLUMNS );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdMakeRoom
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Ensure an output has room for a given number of source/datum pairs.
+**
+** Description:
+**    The space for source/datum pairs is grown by doubling as required.
+**    Newly allocated pairs are initialised to all source and all data
+**    id's.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments;
+**    iStdOutput_t *OutputPtr  (in/out)
+**       Output to make room in.
+**    Int32_t NumData          (in)
+**       Number of source/datum pairs needed.
+**
+*****************************************************************************/
+Status_t mStdMakeRoom ( iStdOutput_t *OutputPtr, Int32_t NumData )
+{
+   int         i;
+   int         MaxData;
+   iStdData_t *StdDataPtr;
+
+   if ( NumData <= OutputPtr->MaxDataSearch )
+   {
+      return SYS_NOMINAL;
+   }
+
+   MaxData = ( OutputPtr->MaxDataSearch > 0 ) ? OutputPtr->MaxDataSearch : 1;
+   while ( MaxData < NumData )
+   {
+      MaxData *= 2;
+   }
+
+   StdDataPtr = (iStdData_t *) TTL_REALLOC( OutputPtr->StdData, 
+                                            MaxData * sizeof( iStdData_t ) );
+   if ( StdDataPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   for(i=OutputPtr->MaxDataSearch; i<MaxData; i++)
+   {
+      memset( StdDataPtr+i, 0, sizeof( iStdData_t ) );
+      (StdDataPtr+i)->DataFlag = FALSE;
+      (StdDataPtr+i)->SourceId = E_CIL_BOL;
+      (StdDataPtr+i)->DatumId  = 0;      
+      strncpy ( (StdDataPtr+i)->SourceName, "???", E_STD_MAX_STRING_LEN);
+      strncpy ( (StdDataPtr+i)->DatumName , "???", E_STD_MAX_STRING_LEN);
+      strncpy ( (StdDataPtr+i)->DatumUnits, "???", E_STD_MAX_STRING_LEN);      
+      (StdDataPtr+i)->NumOfPoints = 0;
+   }
+
+   OutputPtr->StdData       = StdDataPtr;
+   OutputPtr->MaxDataSearch = MaxData;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdFreeOutputs
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Give up every output, once it has been written.
+**
+** Description:
+**    The columns of each output are freed, and the outputs themselves,
+**    leaving none.
+**
+** Return type:
+**    void
+**
+** Arguments;
+**    None.
+**
+*****************************************************************************/
+void iStdFreeOutputs ( void )
+{
+   Int32_t      k;            /* Counter stepping through outputs */
+
+   for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+   {
+      iStdFreeData( iStdGlobVar.Outputs + k );
+      TTL_FREE( iStdGlobVar.Outputs[k].StdData );
+   }
+
+   TTL_FREE( iStdGlobVar.Outputs );
+   iStdGlobVar.Outputs    = NULL;
+   iStdGlobVar.NumOutputs = 0;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdExpandAggs
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Give each summary of a stride a column of its own.
+**
+** Description:
+**    When strides are summarised, each source/datum pair of an output is
+**    repeated once for each summary asked for, in the order given, so the
+**    summaries of a datum sit side by side. Does nothing otherwise. Must
+**    be called before any data is stored.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments;
+**    iStdOutput_t *OutputPtr  (in/out)
+**       Output whose source/datum pairs are repeated.
+**
+*****************************************************************************/
+Status_t iStdExpandAggs ( iStdOutput_t *OutputPtr )
+{
+   Status_t    Status;
+   Int32_t     i;            /* Source/datum pair being repeated */
+   Int32_t     m;            /* Summary of the pair */
+   iStdData_t *StdDataPtr;   /* Pointer to list of datum to search for */
+
+   if ( iStdGlobVar.NumAggs == 0 )
+   {
+      return SYS_NOMINAL;
+   }
+
+   Status = mStdMakeRoom( OutputPtr, OutputPtr->NumDataSearch * iStdGlobVar.NumAggs );
+   if ( SYS_NOMINAL != Status )
+   {
+      return Status;
+   }
+
+   /* From the end, so no pair is overwritten before it is repeated */
+   StdDataPtr = OutputPtr->StdData;
+   for ( i = OutputPtr->NumDataSearch - 1; i >= 0; i-- )
+   {
+      for ( m = iStdGlobVar.NumAggs - 1; m >= 0; m-- )
+      {
+         StdDataPtr[ i * iStdGlobVar.NumAggs + m ]     = StdDataPtr[i];
+         StdDataPtr[ i * iStdGlobVar.NumAggs + m ].Agg = iStdGlobVar.Aggs[m];
+      }
+   }
+
+   OutputPtr->NumDataSearch *= iStdGlobVar.NumAggs;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdReadAggs
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the summaries of each stride asked for.
+**
+** Description:
+**    The summaries are named by iStdAggName and separated by commas, e.g.
+**    "min,max,mean". They are kept in iStdGlobVar.Aggs in the order given.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_GEN_ERROR if a summary is
+**       not known, or too many are given.
+**
+** Arguments;
+**    char *ListPtr            (in)
+**       Summaries, as given to the aggregate switch.
+**
+*****************************************************************************/
+static Status_t mStdReadAggs ( char *ListPtr )
+{
+   char        List[ E_STD_STRING_LEN ];   /* Copy of the list, to split up */
+   char       *NamePtr;                    /* Name of a summary */
+   Int32_t     Agg;                        /* Summary named */
+
+   strncpy( List, ListPtr, E_STD_STRING_LEN - 1 );
+   List[ E_STD_STRING_LEN - 1 ] = '\0';
+
+   for ( NamePtr = strtok( List, "," ); NamePtr != NULL;
+         NamePtr = strtok( NULL, "," ) )
+   {
+      for ( Agg = 0; Agg < I_STD_NUM_AGGS; Agg++ )
+      {
+         if ( strcmp( NamePtr, iStdAggName( Agg ) ) == 0 )
+         {
+            break;
+         }
+      }
+
+      if ( Agg == I_STD_NUM_AGGS )
+      {
+         eLogErr(E_STD_GEN_ERROR,"Unknown summary \"%s\", expected one of "
+                 "min,max,mean,first,last,count,firsttime,lasttime",NamePtr);
+         return E_STD_GEN_ERROR;
+      }
+
+      if ( iStdGlobVar.NumAggs == I_STD_NUM_AGGS )
+      {
+         eLogErr(E_STD_GEN_ERROR,"Too many summaries in \"%s\"",ListPtr);
+         return E_STD_GEN_ERROR;
+      }
+
+      iStdGlobVar.Aggs[ iStdGlobVar.NumAggs++ ] = Agg;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdNameFind
+**
+** Type:
+**    mStdName_t *
+**
+** Purpose:
+**    Find a source or datum name already looked up.
+**
+** Description:
+**    Finds the name of an identifier or, when a name is given, the
+**    identifier of that name.
+**
+** Return type:
+**    mStdName_t *
+**       The name and identifier, or NULL if not yet looked up.
+**
+** Arguments;
+**    Bool_t   Datum            (in)
+**       Whether a datum rather than a source is wanted.
+**    Uint32_t SourceId         (in)
+**       Source of the datum, ignored for a source.
+**    Uint32_t Id               (in)
+**       Identifier whose name is wanted, ignored if a name is given.
+**    char    *NamePtr          (in)
+**       Name whose identifier is wanted, or NULL.
+**
+*****************************************************************************/
+static mStdName_t *mStdNameFind ( Bool_t Datum, Uint32_t SourceId, Uint32_t Id,
+                                  char *NamePtr )
+{
+   mStdName_t  *EntryPtr;     /* Name being compared */
+   Int32_t      i;            /* Counter */
+
+   for ( i = 0; i < mStdNumNames; i++ )
+   {
+      EntryPtr = mStdNames + i;
+      if ( ( EntryPtr->Datum != Datum ) ||
+           ( Datum && ( EntryPtr->SourceId != SourceId ) ) )
+      {
+         continue;
+      }
+      if ( ( NamePtr != NULL ) ? ( strcmp( EntryPtr->Name, NamePtr ) == 0 )
+                               : ( EntryPtr->Id == Id ) )
+      {
+         return EntryPtr;
+      }
+   }
+
+   return NULL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdNameKeep
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Keep a source or datum name looked up, for the next time it is wanted.
+**
+** Description:
+**    Should there not be room to keep it, it is simply looked up again.
+**
+** Return type:
+**    void
+**
+** Arguments;
+**    Bool_t   Datum            (in)
+**       Whether the name is of a datum rather than a source.
+**    Uint32_t SourceId         (in)
+**       Source of the datum.
+**    Uint32_t Id               (in)
+**       Identifier of the source or datum.
+**    char    *NamePtr          (in)
+**       Its name.
+**
+*****************************************************************************/
+static void mStdNameKeep ( Bool_t Datum, Uint32_t SourceId, Uint32_t Id,
+                           char *NamePtr )
+{
+   mStdName_t  *NewPtr;       /* Grown list of names */
+   Int32_t      MaxNames;     /* Names there will be room for */
+
+   if ( mStdNumNames == mStdMaxNames )
+   {
+      MaxNames = ( mStdMaxNames > 0 ) ? 2 * mStdMaxNames : I_STD_DFLT_COLUMNS;
+      NewPtr = (mStdName_t *) TTL_REALLOC( mStdNames, MaxNames * sizeof( mStdName_t ) );
+      if ( NewPtr == NULL )
+      {
+         return;
+      }
+      mStdNames    = NewPtr;
+      mStdMaxNames = MaxNames;
+   }
+
+   NewPtr = mStdNames + mStdNumNames++;
+   NewPtr->Datum    = Datum;
+   NewPtr->SourceId = Datum ? SourceId : 0;
+   NewPtr->Id       = Id;
+   strncpy( NewPtr->Name, NamePtr, E_STD_MAX_STRING_LEN - 1 );
+   NewPtr->Name[ E_STD_MAX_STRING_LEN - 1 ] = '\0';
+}
@@ -76,22 +76,130 @@
 
 #include <math.h>
 #include <zlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 
 /* Include files */
 #include "StdPrivate.h"
 
+/* Local definitions */
+
+#define M_STD_RING_SIZE  3   /* Blocks of a gzipped file read ahead */
+
+/* A block of records decompressed ahead of the reader's consumer */
+typedef struct mStdBlock_s
+{
+   eSdbRawFmt_t *DataPtr;       /* Records, room for the chunk size or a
+                                   block of a block-structured file */
+   size_t        NumRecords;    /* Number of records held */
+   Bool_t        Full;          /* Holds records not yet consumed */
+   Bool_t        Last;          /* Final block of the file */
+   Status_t      Status;        /* Result of reading the block */
+} mStdBlock_t;
+
+/*
+** State of one retrieval of Sdb data. Each reader owns its file, buffer
+** and hour base, so several may be in use at once.
+*/
+struct eStdReader_s
+{
+   eTtlTime_t    StartTime;     /* Start of retrieval */
+   eTtlTime_t    StopTime;      /* End of retrieval */
+   char          Path[ E_STD_STRING_LEN ]; /* Directory holding Sdb files */
+   eTtlTime_t    Time;          /* Current hour being searched */
+   eTtlTime_t    TimeHour;      /* Time stamp of the current Sdb file */
+   FILE         *InFile;        /* File pointer to current Sdb file */
+   gzFile        GzInFile;      /* File pointer to current gzipped Sdb file */
+   Bool_t        Gzipped;       /* Current Sdb file is gzipped */
+   Bool_t        Blocked;       /* Current Sdb file is block-structured */
+   iStdBgzf_t   *BgzfPtr;       /* Current Sdb file, if block-compressed */
+   eSdbDataBlock_t *SdbBlockPtr; /* Block read from a block-structured file */
+   Uint32_t      BlockNum;      /* Block of the file next read, structured
+                                   or compressed */
+   Bool_t        NewSdbFile;    /* A new file should be loaded */
+   Bool_t        Finished;      /* Passed the stop time */
+   eSdbRawFmt_t *DataPtr;       /* Chunk of Sdb data */
+   char         *MapPtr;        /* Current Sdb file mapped, or NULL */
+   size_t        MapSize;       /* Size of the mapping in bytes */
+   size_t        MapOffset;     /* Bytes of the mapping already consumed */
+   size_t        SpanSize;      /* Most mapped records per call, 0 for all */
+   size_t        ChunkSize;     /* Records read from a file per call */
+   Bool_t        ReadAhead;     /* A producer thread is decompressing */
+   Bool_t        StopReading;   /* Tells the producer thread to finish */
+   Bool_t        Consuming;     /* Ring[ Consumer ] was last returned */
+   int           Producer;      /* Next block to be filled */
+   int           Consumer;      /* Next block to be returned */
+   pthread_t     Thread;        /* Producer thread */
+   pthread_mutex_t Lock;        /* Guards the ring */
+   pthread_cond_t  Filled;      /* Signalled when a block is filled */
+   pthread_cond_t  Emptied;     /* Signalled when a block is consumed */
+   mStdBlock_t   Ring[ M_STD_RING_SIZE ]; /* Blocks read ahead */
+   char          FilePath[ FILENAME_MAX ]; /* Name of the current Sdb file */
+   iStdGzIndex_t *GzIndexPtr;   /* Index of a gzipped file read in part */
+   iStdGzStream_t *GzStreamPtr; /* Inflation of the current run of spans */
+   Uint32_t      NextPoint;     /* Next access point to consider */
+   Uint32_t      NeedFrom;      /* Least TimeOffset wanted from the file */
+   Uint32_t      NeedTo;        /* Greatest TimeOffset wanted */
+   Uint32_t      RecordsLeft;   /* Records left in the current run */
+   eSdbCode_t   *WantCodes;     /* Storage codes wanted, NULL for all */
+   size_t        NumWant;       /* Number of codes wanted */
+   eSdbCode_t   *MatchCodes;    /* The same in order, matched by eStdReaderBatch */
+   eSdbRawFmt_t *BatchPtr;      /* Records returned but not yet decoded */
+   size_t        BatchLeft;     /* Number of them */
+   iStdSdbBlocks_t Blocks;      /* Blocks of the current file needed */
+   Uint32_t      RecordNum;     /* Record of the file next read */
+   eStdCatalog_t *CatalogPtr;   /* Catalog of the archive, NULL if none */
+   char          CatalogFile[ FILENAME_MAX ]; /* Hour's file in it, or empty */
+   eStdColumns_t *ColumnsPtr;   /* Columnar archive, NULL if none */
+   iStdColRead_t Columns;       /* Records of the hour read from it */
+   Bool_t        ColumnHour;    /* Current hour is read from it */
+   iStdBundle_t *BundlePtr;     /* Bundle of the current day or month, or NULL */
+   Uint32_t      SegOffset;     /* Offset of the current file in its bundle */
+   Uint32_t      SegSize;       /* Bytes of it there, 0 if not bundled */
+   eStdFiles_t  *FilesPtr;      /* Files named to be read, NULL if none */
+   char          ListedFile[ FILENAME_MAX ]; /* Hour's file in the list, or empty */
+};
+
 /* Local function prototypes */
-Status_t mStdOpenSdbFile      ( eStdTime_t Time, FILE **InFilePtr, gzFile **GzInFilePtr, char *PathPtr );
+Status_t mStdOpenSdbFile      ( eStdTime_t Time, eStdReader_t *ReaderPtr );
 Status_t mStdConvertTime      ( eTtlTime_t InTime, eStdTime_t *OutTimePtr );
-Status_t mStdReadSdbHeader    ( FILE *InFilePtr, gzFile *GzInFilePtr, size_t *NumBytes );
-Status_t mStdReadSdbTimeStamp ( FILE *InFilePtr, gzFile *GzInFilePtr, eTtlTime_t *TimeHour);
-Status_t mStdReadSdbChunk     ( FILE *, gzFile *, eSdbRawFmt_t *, size_t, size_t *);
+Status_t mStdReadSdbHeader    ( eStdReader_t *ReaderPtr, size_t *NumBytes );
+Status_t mStdReadSdbTimeStamp ( eStdReader_t *ReaderPtr, eTtlTime_t *TimeHour);
+Status_t mStdReadSdbChunk     ( eStdReader_t *, eSdbRawFmt_t *, size_t, size_t *);
 Status_t mStdSetHour          ( eTtlTime_t, eTtlTime_t *);
+static void mStdSdbFileName   ( eStdTime_t Time, char *PathPtr, char *NamePtr );
+static void mStdPrefetchSdbFile( eStdReader_t *ReaderPtr );
+static void mStdMapSdbFile    ( eStdReader_t *ReaderPtr );
+static Status_t mStdStartReadAhead( eStdReader_t *ReaderPtr );
+static void *mStdReadAheadThread( void *ArgPtr );
+static Status_t mStdReadAheadChunk( eStdReader_t *, eSdbRawFmt_t **, size_t * );
+static void mStdStopReadAhead ( eStdReader_t *ReaderPtr );
+static Bool_t mStdUseGzIndex  ( eStdReader_t *ReaderPtr );
+static Bool_t mStdSpanNeeded  ( eStdReader_t *ReaderPtr, Uint32_t Point );
+static Status_t mStdReadIndexedChunk( eStdReader_t *, size_t * );
+static Status_t mStdMapSdbSpan( eStdReader_t *, eSdbRawFmt_t **, size_t * );
+static Status_t mStdColumnSpan( eStdReader_t *, eSdbRawFmt_t **, size_t * );
+static Status_t mStdBgzfSpan  ( eStdReader_t *, eSdbRawFmt_t **, size_t * );
+static void mStdNeedRange     ( eStdReader_t *, eTtlTime_t *, Uint32_t *, Uint32_t * );
+static Bool_t mStdSelectBlocks( eStdReader_t *ReaderPtr );
+static void mStdDropBlocks    ( eStdReader_t *, eSdbRawFmt_t *, size_t * );
+static Status_t mStdReadBlocked( eStdReader_t *, eSdbRawFmt_t **, size_t * );
+static Status_t mStdNextSdbBlock( eStdReader_t *, eSdbDataBlock_t ** );
+static size_t mStdUnpackBlock ( eStdReader_t *, eSdbDataBlock_t *, eSdbRawFmt_t * );
+static void mStdCloseSdbFile  ( eStdReader_t *ReaderPtr );
+static Bool_t mStdFindBundle  ( eStdReader_t *ReaderPtr, eStdTime_t *TimePtr );
+static Status_t mStdOpenBundleHour( eStdReader_t *ReaderPtr, eStdTime_t *TimePtr );
+static Status_t mStdFindSdbFile( eStdReader_t *ReaderPtr, char *SdbFilePath );
+static Status_t mStdOpenListedFile( eStdReader_t *ReaderPtr );
+static FILE    *mStdOpenStream( char *PathPtr );
+static gzFile   mStdOpenGzStream( char *PathPtr );
+static int      mStdCompareCodes( const void *FirstPtr, const void *SecondPtr );
 
-Bool_t   mStdGzippedFile;
-
-/* Module scope variables */
-static eTtlTime_t TimeHour;
+/* Module scope variables, for the single reader of eStdRetrieveData */
+static eStdReader_t *mStdReader = NULL;
+static eTtlTime_t    TimeHour;
 
 /*****************************************************************************
 ** Function Name:
@@ -108,13 +216,16 @@ static eTtlTime_t TimeHour;
 **    a time range to search between, the function must generate
 **    the Sdb filename to search.
 **    Each time the function is called a chunk of size 
-**    E_STD_SDB_CHUNK_SIZE is recovered. A static time counter
+**    E_STD_SDB_CHUNK_SIZE is recovered. A static reader
 **    is used to allow future calls to this function to continue
 **    from the end of the previous Sdb chunk read. This function 
 **    can be called repeatadly until the Finished flag is true,
 **    at which point the data with in the time range has been 
 **    retrieved.
 **
+**    Only one retrieval at a time can be made this way. Use
+**    eStdReaderOpen etc. to make several.
+**
 ** Return type:
 **    Status_t
 **       Returns SYS_NOMINAL on success.
@@ -143,669 +254,3164 @@ Status_t eStdRetrieveData( eTtlTime_t StartTime,
                            size_t    *NumRecordsPtr)
 {
    Status_t          Status;   
-   size_t            NumBytes;
-   static Bool_t     NewSdbFile = TRUE;   /* Flag indicating a new file should be loaded */
-   static Bool_t     FirstTime  = TRUE;   /* Flag indicating this is first call*/
-   static FILE      *InFile = NULL;       /* File pointer to current Sdb file */
-   static gzFile    *GzInFile = NULL;     /* File pointer to current Sdb file */
-   static eTtlTime_t Time;                /* Current hour being searched */
-   eStdTime_t        StdTime;
-   static eSdbRawFmt_t *DataPtr;
- 
-   /* Set the finished flag to FALSE */
-   *FinishedPtr = FALSE;
 
-   /* Set the current time */
-   if( FirstTime )
+   /* Set the finished flag to FALSE, nothing has been read yet */
+   *FinishedPtr   = FALSE;
+   *NumRecordsPtr = 0;
+
+   /* If this is the first call, start a new retrieval */
+   if( mStdReader == NULL )
    {
-      /* Allocate some memory for Sdb data */
-      DataPtr = (eSdbRawFmt_t *) TTL_MALLOC( sizeof(eSdbRawFmt_t) * E_STD_SDB_CHUNK_SIZE);
-      if( DataPtr == NULL )
+      Status = eStdReaderOpen( StartTime, StopTime, PathPtr, &mStdReader );
+      if( SYS_NOMINAL != Status )
       {
-         return E_STD_MEM_ALLOC_ERR;
+         return Status;
       }
 
-      /* If this is the first call, set time to start time */   
-      mStdSetHour(StartTime, &Time);
+      /* Callers of this function expect at most a chunk per call */
+      mStdReader->SpanSize = E_STD_SDB_CHUNK_SIZE;
 
-      /* Ensure file is opened afresh. */
-      *FinishedPtr    = FALSE;
-      NewSdbFile      = TRUE;
-      InFile          = NULL;
-      GzInFile        = NULL;
-      
-      /* Initialise the TimeHour variable */
       TimeHour.t_sec  = StartTime.t_sec;
       TimeHour.t_nsec = StartTime.t_nsec;
+   }
+
+   Status = eStdReaderNext( mStdReader, SdbDataPtr, NumRecordsPtr, FinishedPtr );
 
-      FirstTime       = FALSE;
+   /* Keep the hour base for eStdSearchData and eStdRecordTime */
+   if( *NumRecordsPtr > 0 )
+   {
+      TimeHour = mStdReader->TimeHour;
    }
-   
-   /* Initialise the data array */
-   if( DataPtr != NULL )
+
+   /* Allow clients to start a new search once this one has ended */
+   if( ( SYS_NOMINAL != Status ) || ( *FinishedPtr == TRUE ) )
    {
-      *SdbDataPtr = DataPtr;
+      eStdReaderClose( mStdReader );
+      mStdReader = NULL;
    }
-   else
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Start a retrieval of Sdb data between two times.
+** 
+** Description:
+**    Creates a reader which owns all the state of the retrieval. Sdb
+**    files are not opened until eStdReaderNext is called.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eTtlTime_t    StartTime          (in)
+**       The start time of the Sdb search.
+**    eTtlTime_t    StopTime           (in)
+**       The stop time of the sdb search.
+**    char         *PathPtr            (in)
+**       Pointer to alternate path for data
+**    eStdReader_t **ReaderPtr         (out)
+**       The new reader.
+**
+*****************************************************************************/
+Status_t eStdReaderOpen( eTtlTime_t StartTime,
+                         eTtlTime_t StopTime,
+                         char *PathPtr,
+                         eStdReader_t **ReaderPtr )
+{
+   eStdReader_t *NewPtr;   /* Reader being created */
+
+   *ReaderPtr = NULL;
+
+   NewPtr = (eStdReader_t *) TTL_CALLOC( 1, sizeof( eStdReader_t ) );
+   if( NewPtr == NULL )
    {
-      FirstTime     = TRUE;
       return E_STD_MEM_ALLOC_ERR;
    }
 
-   /* Check to see if we've passed the stop time */
-   if( Time.t_sec > StopTime.t_sec )
-   {
-      TTL_FREE( *SdbDataPtr );
-      *FinishedPtr  = TRUE;
-      FirstTime     = TRUE;
-      /* Ensure file is closed properly. */
-      if ( mStdGzippedFile == FALSE )
-      { 
-         if (InFile != NULL)
-         {
-           fclose(InFile);
-         }
-      }
-      else
+   /* Allocate some memory for Sdb data */
+   NewPtr->DataPtr = (eSdbRawFmt_t *) TTL_MALLOC( sizeof(eSdbRawFmt_t) * E_STD_SDB_CHUNK_SIZE);
+   if( NewPtr->DataPtr == NULL )
+   {
+      TTL_FREE( NewPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if( ( pthread_mutex_init( &(NewPtr->Lock), NULL ) != 0 ) ||
+       ( pthread_cond_init( &(NewPtr->Filled), NULL ) != 0 ) ||
+       ( pthread_cond_init( &(NewPtr->Emptied), NULL ) != 0 ) )
+   {
+      TTL_FREE( NewPtr->DataPtr );
+      TTL_FREE( NewPtr );
+      return E_STD_THREAD_ERR;
+   }
+
+   strncpy( NewPtr->Path, PathPtr, E_STD_STRING_LEN - 1 );
+   NewPtr->StartTime  = StartTime;
+   NewPtr->StopTime   = StopTime;
+   NewPtr->InFile     = NULL;
+   NewPtr->GzInFile   = NULL;
+   NewPtr->MapPtr     = NULL;
+   NewPtr->SpanSize   = 0;
+   NewPtr->ChunkSize  = E_STD_SDB_CHUNK_SIZE;
+   NewPtr->ReadAhead  = FALSE;
+   NewPtr->NewSdbFile = TRUE;
+   NewPtr->Finished   = FALSE;
+
+   /* Start from the hour holding the start time */
+   mStdSetHour( StartTime, &(NewPtr->Time) );
+
+   NewPtr->TimeHour.t_sec  = StartTime.t_sec;
+   NewPtr->TimeHour.t_nsec = StartTime.t_nsec;
+
+   *ReaderPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderChunk
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Set the number of records a reader reads from a file at once.
+** 
+** Description:
+**    Gzipped Sdb files, and any which cannot be mapped into memory, are
+**    read this many records at a time. Larger chunks make fewer, bigger
+**    reads and let the decompression of gzipped files run further ahead
+**    of the caller. The default is E_STD_SDB_CHUNK_SIZE. Must be called
+**    before the first call to eStdReaderNext.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_ARRAY_SIZE if NumRecords
+**       is zero or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr          (in/out)
+**       The reader.
+**    size_t        NumRecords         (in)
+**       Number of records to read at once.
+**
+*****************************************************************************/
+Status_t eStdReaderChunk( eStdReader_t *ReaderPtr, size_t NumRecords )
+{
+   eSdbRawFmt_t *NewDataPtr;   /* Chunk of the new size */
+
+   if( NumRecords == 0 )
+   {
+      return E_STD_ARRAY_SIZE;
+   }
+
+   NewDataPtr = (eSdbRawFmt_t *) TTL_MALLOC( sizeof(eSdbRawFmt_t) * NumRecords );
+   if( NewDataPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   TTL_FREE( ReaderPtr->DataPtr );
+   ReaderPtr->DataPtr   = NewDataPtr;
+   ReaderPtr->ChunkSize = NumRecords;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderCodes
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Tell a reader which storage codes are wanted from the Sdb files.
+**
+** Description:
+**    Where an hour's Sdb file has a series index, built by
+**    eStdSdbIndexBuild, the reader then passes over the file if it holds
+**    no records of the codes in the time range, and over blocks of the
+**    file holding none. Records of other codes may still be returned by
+**    eStdReaderNext, though not by eStdReaderBatch. Without a call, or
+**    with no codes, all records are returned. Must be called before the
+**    first call to eStdReaderNext.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr          (in/out)
+**       The reader.
+**    eSdbCode_t   *CodesPtr           (in)
+**       Storage codes wanted, copied by the reader.
+**    size_t        NumCodes           (in)
+**       Number of codes wanted.
+**
+*****************************************************************************/
+Status_t eStdReaderCodes( eStdReader_t *ReaderPtr,
+                          eSdbCode_t *CodesPtr,
+                          size_t NumCodes )
+{
+   eSdbCode_t *NewCodesPtr;   /* Copy of the codes */
+   eSdbCode_t *MatchCodesPtr; /* Copy of the codes, in order */
+
+   NewCodesPtr   = NULL;
+   MatchCodesPtr = NULL;
+   if( NumCodes > 0 )
+   {
+      NewCodesPtr   = (eSdbCode_t *) TTL_MALLOC( sizeof( eSdbCode_t ) * NumCodes );
+      MatchCodesPtr = (eSdbCode_t *) TTL_MALLOC( sizeof( eSdbCode_t ) * NumCodes );
+      if( ( NewCodesPtr == NULL ) || ( MatchCodesPtr == NULL ) )
       {
-         if (GzInFile != NULL)
-         {
-#if 0
-           gzclose(GzInFile);
-#endif
-         }
+         TTL_FREE( NewCodesPtr );
+         TTL_FREE( MatchCodesPtr );
+         return E_STD_MEM_ALLOC_ERR;
       }
+      memcpy( NewCodesPtr, CodesPtr, sizeof( eSdbCode_t ) * NumCodes );
+      memcpy( MatchCodesPtr, CodesPtr, sizeof( eSdbCode_t ) * NumCodes );
+      qsort( MatchCodesPtr, NumCodes, sizeof( eSdbCode_t ), mStdCompareCodes );
+   }
+
+   TTL_FREE( ReaderPtr->WantCodes );
+   TTL_FREE( ReaderPtr->MatchCodes );
+   ReaderPtr->WantCodes  = NewCodesPtr;
+   ReaderPtr->MatchCodes = MatchCodesPtr;
+   ReaderPtr->NumWant    = NumCodes;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderCatalog
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Give a reader the catalog of the archive it reads.
+**
+** Description:
+**    The reader then passes over hours the catalog shows hold none of the
+**    storage codes wanted, given by eStdReaderCodes, or have no Sdb file,
+**    without looking for their files. The files of hours catalogued are
+**    read from wherever the catalog found them in the archive, rather
+**    than from the reader's directory. Hours the catalog cannot be relied
+**    on for are read as usual. The catalog is not copied and must not be
+**    closed before the reader. Must be called before the first call to
+**    eStdReaderNext.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdReader_t  *ReaderPtr         (in/out)
+**       The reader.
+**    eStdCatalog_t *CatalogPtr        (in)
+**       Catalog opened by eStdCatalogOpen, or NULL for none.
+**
+*****************************************************************************/
+Status_t eStdReaderCatalog( eStdReader_t *ReaderPtr,
+                            eStdCatalog_t *CatalogPtr )
+{
+   ReaderPtr->CatalogPtr = CatalogPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderColumns
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Give a reader a columnar archive of the Sdb data it reads.
+**
+** Description:
+**    The reader then reads the records of the storage codes wanted, given
+**    by eStdReaderCodes, from the archive for each hour of a day which
+**    has been converted to it, rather than the hour's Sdb file. Only
+**    those records are returned. Hours of days not converted are read
+**    from their Sdb files as usual, as are all hours if no codes are
+**    given. The archive is not copied and must not be closed before the
+**    reader. Must be called before the first call to eStdReaderNext.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdReader_t  *ReaderPtr         (in/out)
+**       The reader.
+**    eStdColumns_t *ColumnsPtr        (in)
+**       Archive opened by eStdColumnsOpen, or NULL for none.
+**
+*****************************************************************************/
+Status_t eStdReaderColumns( eStdReader_t *ReaderPtr,
+                            eStdColumns_t *ColumnsPtr )
+{
+   ReaderPtr->ColumnsPtr = ColumnsPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderFiles
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Give a reader the Sdb files it is to read.
+**
+** Description:
+**    The reader then reads each hour's records from the file in the list
+**    of that hour, wherever it is, rather than looking for the hour's
+**    file under its path. Hours without a file in the list are passed
+**    straight over. The list takes precedence over any catalog, columnar
+**    archive or bundle the reader has. It is not copied and must not be
+**    closed before the reader. Must be called before the first call to
+**    eStdReaderNext.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr          (in/out)
+**       The reader.
+**    eStdFiles_t  *FilesPtr           (in)
+**       List opened by eStdFilesOpen, or NULL for none.
+**
+*****************************************************************************/
+Status_t eStdReaderFiles( eStdReader_t *ReaderPtr,
+                          eStdFiles_t *FilesPtr )
+{
+   ReaderPtr->FilesPtr = FilesPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderNext
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Retrieves the next span of Sdb data.
+** 
+** Description:
+**    Opens each hour's Sdb file in turn, skipping hours with no file,
+**    and returns its records. Plain Sdb files are mapped into memory
+**    and all of an hour's records are returned at once, in place.
+**    Gzipped files are decompressed by a thread of the reader's own,
+**    a few chunks ahead of the caller, and returned a chunk at a time,
+**    as are any plain files which cannot be mapped. If only part of the
+**    hour of a gzipped file is wanted, and it has been indexed by
+**    eStdGzIndexBuild, only the spans of the file holding records in
+**    the time range are inflated. Given the storage codes wanted, by
+**    eStdReaderCodes, files and blocks of files which their series
+**    index shows hold none of them are passed over, as are hours the
+**    catalog of the archive, given by eStdReaderCatalog, shows hold none
+**    of them. Block-structured (version 2) Sdb files are read a block
+**    at a time, passing over blocks whose headers show they hold nothing
+**    wanted and, with a warning, any which fail their checksum. Hours of
+**    days in the columnar archive, given by eStdReaderColumns, are read
+**    from it instead, a whole hour at once. Given a list of files, by
+**    eStdReaderFiles, only the hours with a file in it are read, from
+**    those files. While
+**    each file is read the next hour's is prefetched. The records remain owned by
+**    the reader and are only valid until the next call. Once the stop
+**    time has been passed Finished is set and no records are returned.
+**    After an error the reader is finished and should be closed.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr          (in/out)
+**       The reader.
+**    eSdbRawFmt_t **SdbDataPtr        (out)
+**       Pointer to the Sdb data chunk. 
+**    size_t       *NumRecordsPtr      (out)
+**       Number of records in the chunk.
+**    Bool_t       *FinishedPtr        (out)
+**       Indicates if the Sdb search finished.
+**
+*****************************************************************************/
+Status_t eStdReaderNext( eStdReader_t *ReaderPtr,
+                         eSdbRawFmt_t **SdbDataPtr,
+                         size_t *NumRecordsPtr,
+                         Bool_t *FinishedPtr )
+{
+   Status_t          Status;   
+   size_t            NumBytes;
+   eStdTime_t        StdTime;
+   Bool_t            Opened;
+
+   *FinishedPtr   = FALSE;
+   *NumRecordsPtr = 0;
+   *SdbDataPtr    = ReaderPtr->DataPtr;
 
+   /* Check to see if we've passed the stop time */
+   if( ( ReaderPtr->Finished == TRUE ) ||
+       ( ReaderPtr->Time.t_sec > ReaderPtr->StopTime.t_sec ) )
+   {
+      mStdCloseSdbFile( ReaderPtr );
+      ReaderPtr->Finished = TRUE;
+      *FinishedPtr        = TRUE;
       return SYS_NOMINAL;
    }
    
    /* Check to see if we need to open new file */
-   if( NewSdbFile )
+   if( ReaderPtr->NewSdbFile )
    {
-      NewSdbFile = FALSE;     
+      ReaderPtr->NewSdbFile = FALSE;     
+
+      /* Release the previous file, whose records are no longer in use */
+      mStdCloseSdbFile( ReaderPtr );
 
       /* Try and open a file until we find one */
       do
       {
+         /* Go straight to the next hour the catalog shows may be wanted */
+         ReaderPtr->CatalogFile[0] = '\0';
+         ReaderPtr->ListedFile[0]  = '\0';
+         if( ( ReaderPtr->FilesPtr != NULL ) &&
+             ( ReaderPtr->Time.t_sec <= ReaderPtr->StopTime.t_sec ) )
+         {
+            /* Or to the next hour with a file in the list, if there is one */
+            if( eStdFilesNext( ReaderPtr->FilesPtr, &(ReaderPtr->Time.t_sec),
+                               ReaderPtr->ListedFile ) != SYS_NOMINAL )
+            {
+               ReaderPtr->Time.t_sec = ReaderPtr->StopTime.t_sec + 1;
+            }
+         }
+         else if( ( ReaderPtr->CatalogPtr != NULL ) &&
+                  ( ReaderPtr->Time.t_sec <= ReaderPtr->StopTime.t_sec ) )
+         {
+            eStdCatalogNext( ReaderPtr->CatalogPtr, ReaderPtr->WantCodes,
+                             ReaderPtr->NumWant, &(ReaderPtr->Time.t_sec),
+                             ReaderPtr->CatalogFile );
+         }
 
          /* 
          ** Check to see if we're trying to open a file
          ** which is past the stop time
          */
-         if( Time.t_sec > StopTime.t_sec )
+         if( ReaderPtr->Time.t_sec > ReaderPtr->StopTime.t_sec )
          {
             /* Not an error just return finished */
-            TTL_FREE( *SdbDataPtr );
-
-            /* Ensure file is closed properly. */
-            NewSdbFile  = TRUE;
-            if ( mStdGzippedFile == FALSE )
-            {
-               if (InFile != NULL)
-               {
-                 fclose(InFile);
-               }
-            }
-            else
-            {
-               if (GzInFile != NULL)
-               {
-                 gzclose(GzInFile);
-               }
-            }
-
-            FirstTime     = TRUE;
-            *FinishedPtr  = TRUE;
+            ReaderPtr->Finished = TRUE;
+            *FinishedPtr        = TRUE;
             eLogDebug("Passed stop time.");
             return SYS_NOMINAL;
          }
 
          /* Convert from Ttl to Std time format */
-         Status = mStdConvertTime( Time, &StdTime );
+         Status = mStdConvertTime( ReaderPtr->Time, &StdTime );
          if( SYS_NOMINAL != Status )
          {
-            TTL_FREE( *SdbDataPtr );
+            ReaderPtr->Finished = TRUE;
+            return Status;
+         }
 
-            /* Ensure file is closed properly. */
-            NewSdbFile    = TRUE;
-            if ( mStdGzippedFile == FALSE )
-            {
-               if (InFile != NULL)
-               {
-                 fclose(InFile);
-               }
-            }
-            else
+         /* A day in the columnar archive needs no Sdb file */
+         if( ( ReaderPtr->ColumnsPtr != NULL ) && ( ReaderPtr->NumWant > 0 ) &&
+             ( ReaderPtr->FilesPtr == NULL ) )
+         {
+            Status = iStdColumnsHour( ReaderPtr->ColumnsPtr, ReaderPtr->Time.t_sec,
+                                      ReaderPtr->WantCodes, ReaderPtr->NumWant,
+                                      &(ReaderPtr->Columns), &(ReaderPtr->ColumnHour) );
+            if( SYS_NOMINAL != Status )
             {
-               if (GzInFile != NULL)
-               {
-                 gzclose(GzInFile);
-               }
+               ReaderPtr->Finished = TRUE;
+               return Status;
             }
-
-            FirstTime     = TRUE;
-            return Status;
          }
 
-         eLogDebug("Opening new file");
-         Status = mStdOpenSdbFile( StdTime, &InFile, &GzInFile, PathPtr );
+         if( ReaderPtr->ColumnHour == FALSE )
+         {
+            eLogDebug("Opening new file");
+            Status = mStdOpenSdbFile( StdTime, ReaderPtr );
+         }
 
-         if( ( InFile == NULL ) && ( GzInFile == NULL ) )
+         Opened = ( ReaderPtr->ColumnHour == TRUE ) ?
+                  ( ReaderPtr->Columns.NumRecords > 0 ) :
+                  ( ( ReaderPtr->InFile != NULL ) || ( ReaderPtr->GzInFile != NULL ) );
+         if( Opened == FALSE )
          {
             /* Advance the time by one hour */
-            Time.t_sec += E_STD_SECONDS_PER_HOUR;          
+            ReaderPtr->Time.t_sec += E_STD_SECONDS_PER_HOUR;          
          }
 
-      }while( (InFile == NULL) && (GzInFile == NULL) );
-
-      /* Read the Sdb header (not needed) */
-      Status = mStdReadSdbHeader ( InFile, GzInFile, &NumBytes );
-      if ( SYS_NOMINAL != Status )
-      {
-        TTL_FREE( *SdbDataPtr );
-
-        /* Ensure file is closed properly. */
-        NewSdbFile    = TRUE;
-        if ( mStdGzippedFile == FALSE )
-        {
-           if (InFile != NULL)
-           {
-              fclose(InFile);
-           }
-        }
-        else
-        {
-           if (GzInFile != NULL)
-           {
-              gzclose(GzInFile);
-           }
-        }
-
-        FirstTime     = TRUE;
-        return Status;
-      }
-
-      /* Read the Sdb hour */
-      Status = mStdReadSdbTimeStamp ( InFile, GzInFile, &TimeHour );
-      if ( SYS_NOMINAL != Status )
-      {
-        TTL_FREE( *SdbDataPtr );
-
-        /* Ensure file is closed properly. */
-        NewSdbFile  = TRUE;
-
-        if ( mStdGzippedFile == FALSE )
-        {
-           if (InFile != NULL)
-           {
-             fclose(InFile);
-           } 
-        }
-        else
-        {
-           if (GzInFile != NULL)
-           {
-              gzclose(GzInFile);
-           }
-        }
-
-        FirstTime     = TRUE;
-        return Status;
-      }
-   }
-
-   /* Retrieve chunk of Sdb data */
-   Status = mStdReadSdbChunk ( InFile, GzInFile, *SdbDataPtr, E_STD_SDB_CHUNK_SIZE, NumRecordsPtr);
-   if( (SYS_NOMINAL != Status) && (Status != E_STD_EOF) )
-   {
-      TTL_FREE( *SdbDataPtr );
+      }while( Opened == FALSE );
 
-      /* Ensure file is closed properly. */
-      NewSdbFile    = TRUE;
-      if ( mStdGzippedFile == FALSE )
+      /* The hour's records have all been read from the columnar archive */
+      if( ReaderPtr->ColumnHour == TRUE )
       {
-         if (InFile != NULL)
-         {
-           fclose(InFile);
-         }
+         ReaderPtr->TimeHour.t_sec  = ReaderPtr->Columns.TimeHour;
+         ReaderPtr->TimeHour.t_nsec = 0;
       }
       else
       {
-         if (GzInFile != NULL)
+         /* Read the Sdb header (not needed) */
+         Status = mStdReadSdbHeader ( ReaderPtr, &NumBytes );
+         if ( SYS_NOMINAL != Status )
          {
-           gzclose(GzInFile);
+           mStdCloseSdbFile( ReaderPtr );
+           ReaderPtr->Finished = TRUE;
+           return Status;
          }
-      }
 
-      FirstTime     = TRUE;
-      return Status;
-   }
+         /* Read the Sdb hour */
+         Status = mStdReadSdbTimeStamp ( ReaderPtr, &(ReaderPtr->TimeHour) );
+         if ( SYS_NOMINAL != Status )
+         {
+           mStdCloseSdbFile( ReaderPtr );
+           ReaderPtr->Finished = TRUE;
+           return Status;
+         }
 
-   /* Check to see if we are at the end of sdb file */
-   if( Status == E_STD_EOF )
-   {
-      /* Next time we need to load new Sdb file */
-      eLogDebug("End of file. Closing file.");
-      if ( mStdGzippedFile == FALSE )
+         /* Find the records of the hour wanted */
+         mStdNeedRange( ReaderPtr, &(ReaderPtr->TimeHour),
+                        &(ReaderPtr->NeedFrom), &(ReaderPtr->NeedTo) );
+         ReaderPtr->BlockNum = 0;
+
+         /* Decompress the rest of a gzipped file in the background */
+         if ( ( ReaderPtr->Gzipped == TRUE ) &&
+              ( mStdUseGzIndex( ReaderPtr ) == FALSE ) )
+         {
+            Status = mStdStartReadAhead( ReaderPtr );
+            if ( SYS_NOMINAL != Status )
+            {
+               mStdCloseSdbFile( ReaderPtr );
+               ReaderPtr->Finished = TRUE;
+               return Status;
+            }
+         }
+
+         /* Have the next hour's file on its way while this one is read */
+         mStdPrefetchSdbFile( ReaderPtr );
+      }
+   }
+
+   /* Retrieve span of mapped Sdb data, or read a chunk of it */
+   if( ReaderPtr->ColumnHour == TRUE )
+   {
+      Status = mStdColumnSpan ( ReaderPtr, SdbDataPtr, NumRecordsPtr );
+   }
+   else if( ( ReaderPtr->Blocked == TRUE ) && ( ReaderPtr->ReadAhead == FALSE ) )
+   {
+      Status = mStdReadBlocked ( ReaderPtr, SdbDataPtr, NumRecordsPtr );
+   }
+   else if( ReaderPtr->BgzfPtr != NULL )
+   {
+      Status = mStdBgzfSpan ( ReaderPtr, SdbDataPtr, NumRecordsPtr );
+   }
+   else if( ReaderPtr->MapPtr != NULL )
+   {
+      Status = mStdMapSdbSpan ( ReaderPtr, SdbDataPtr, NumRecordsPtr );
+   }
+   else if( ReaderPtr->ReadAhead == TRUE )
+   {
+      Status = mStdReadAheadChunk ( ReaderPtr, SdbDataPtr, NumRecordsPtr );
+      mStdDropBlocks ( ReaderPtr, *SdbDataPtr, NumRecordsPtr );
+   }
+   else if( ReaderPtr->GzIndexPtr != NULL )
+   {
+      Status = mStdReadIndexedChunk ( ReaderPtr, NumRecordsPtr );
+   }
+   else
+   {
+      Status = mStdReadSdbChunk ( ReaderPtr, ReaderPtr->DataPtr, ReaderPtr->ChunkSize, NumRecordsPtr);
+      mStdDropBlocks ( ReaderPtr, ReaderPtr->DataPtr, NumRecordsPtr );
+   }
+   if( (SYS_NOMINAL != Status) && (Status != E_STD_EOF) )
+   {
+      mStdCloseSdbFile( ReaderPtr );
+      ReaderPtr->Finished = TRUE;
+      return Status;
+   }
+
+   /* Check to see if we are at the end of sdb file */
+   if( Status == E_STD_EOF )
+   {
+      /*
+      ** Next time we need to load new Sdb file. It is closed then, as
+      ** the records just returned may lie in its mapping.
+      */
+      eLogDebug("End of file.");
+
+      /* Advance the time by one hour */
+      ReaderPtr->Time.t_sec += E_STD_SECONDS_PER_HOUR;
+      ReaderPtr->NewSdbFile  = TRUE;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderTime
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Calculate the time stamp of a line of raw sdb data from a reader.
+** 
+** Description:
+**    Adds the time offset held in the line of Sdb data to the start of
+**    the hour of the Sdb file the reader last returned records from.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr      (in)
+**       The reader the line was retrieved by.
+**    eSdbRawFmt_t *SdbLinePtr     (in)
+**       A line from the Sdb chunk.
+**    eTtlTime_t   *TimeStampPtr   (out)
+**       Time stamp when datum was submitted.
+**
+*****************************************************************************/
+Status_t eStdReaderTime( eStdReader_t *ReaderPtr,
+                         eSdbRawFmt_t *SdbLinePtr,
+                         eTtlTime_t *TimeStampPtr )
+{
+   eTtlTime_t    TimeOffset;
+
+   TimeOffset.t_sec  = SdbLinePtr->TimeOffset / E_TTL_MICROSECS_PER_SEC;
+   TimeOffset.t_nsec = (SdbLinePtr->TimeOffset % (long)E_TTL_MICROSECS_PER_SEC) *
+                       ((long)E_TTL_NANOSECS_PER_SEC / (long)E_TTL_MICROSECS_PER_SEC);
+   
+   return eTimSum(&(ReaderPtr->TimeHour), &TimeOffset, TimeStampPtr);
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderHour
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Give the hour of the Sdb file a reader last returned records from.
+**
+** Description:
+**    Records are returned a file at a time, so this is the hour of every
+**    record last returned, whatever their time stamps.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr      (in)
+**       The reader.
+**    eTtlTime_t   *HourPtr        (out)
+**       Time stamp of the hour's Sdb file.
+**
+*****************************************************************************/
+Status_t eStdReaderHour( eStdReader_t *ReaderPtr,
+                         eTtlTime_t *HourPtr )
+{
+   *HourPtr = ReaderPtr->TimeHour;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderBatch
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Retrieve the next batch of decoded records from a reader.
+** 
+** Description:
+**    Fills the array given with the records next read which are of the
+**    storage codes wanted, given by eStdReaderCodes, and whose time stamp
+**    lies within the reader's start and stop times, to the second. Each
+**    is given with its time, so callers need neither search the records
+**    returned by eStdReaderNext nor call eStdReaderTime. Records are read
+**    as by eStdReaderNext, in as many calls as it takes to fill the
+**    array, and those left over are kept for the next call. Once the stop
+**    time has been passed Finished is set, possibly with the last samples.
+**    The two ways of retrieving records should not be mixed on a reader.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or the error met reading.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr          (in/out)
+**       The reader.
+**    eStdSample_t *SamplesPtr         (out)
+**       Samples decoded.
+**    size_t        MaxSamples         (in)
+**       Number of samples there is room for.
+**    size_t       *NumSamplesPtr      (out)
+**       Number of samples decoded.
+**    Bool_t       *FinishedPtr        (out)
+**       Indicates if the Sdb search finished.
+**
+*****************************************************************************/
+Status_t eStdReaderBatch( eStdReader_t *ReaderPtr,
+                          eStdSample_t *SamplesPtr,
+                          size_t MaxSamples,
+                          size_t *NumSamplesPtr,
+                          Bool_t *FinishedPtr )
+{
+   Status_t      Status;
+   eSdbRawFmt_t *SdbLinePtr;    /* Record being decoded */
+   eSdbRawFmt_t *SdbEndPtr;     /* End of the records returned */
+   eStdSample_t *SamplePtr;     /* Sample being filled */
+   eStdSample_t *SampleEndPtr;  /* End of the samples */
+   eSdbCode_t   *CodesPtr;      /* Storage codes wanted, in order */
+   size_t        Low;           /* Codes still to search */
+   size_t        High;
+   size_t        Middle;        /* Code compared */
+   Int32_t       Seconds;       /* Time stamp of the record */
+   Int32_t       NanoSecs;
+   Bool_t        Finished;      /* Passed the stop time */
+
+   *NumSamplesPtr = 0;
+   *FinishedPtr   = FALSE;
+   CodesPtr       = ReaderPtr->MatchCodes;
+   SamplePtr      = SamplesPtr;
+   SampleEndPtr   = SamplesPtr + MaxSamples;
+
+   while( SamplePtr < SampleEndPtr )
+   {
+      /* Read more records once those returned have all been decoded */
+      if( ReaderPtr->BatchLeft == 0 )
+      {
+         Status = eStdReaderNext( ReaderPtr, &(ReaderPtr->BatchPtr),
+                                  &(ReaderPtr->BatchLeft), &Finished );
+         if( SYS_NOMINAL != Status )
+         {
+            ReaderPtr->BatchLeft = 0;
+            *NumSamplesPtr = SamplePtr - SamplesPtr;
+            return Status;
+         }
+         if( Finished == TRUE )
+         {
+            *FinishedPtr = TRUE;
+            break;
+         }
+         continue;
+      }
+
+      SdbLinePtr = ReaderPtr->BatchPtr;
+      SdbEndPtr  = SdbLinePtr + ReaderPtr->BatchLeft;
+      for( ; ( SdbLinePtr < SdbEndPtr ) && ( SamplePtr < SampleEndPtr ); SdbLinePtr++ )
+      {
+         if( CodesPtr != NULL )
+         {
+            Low  = 0;
+            High = ReaderPtr->NumWant;
+            while( Low < High )
+            {
+               Middle = ( Low + High ) / 2;
+               if( CodesPtr[ Middle ] < SdbLinePtr->Code )
+               {
+                  Low = Middle + 1;
+               }
+               else
+               {
+                  High = Middle;
+               }
+            }
+            if( ( Low == ReaderPtr->NumWant ) || ( CodesPtr[ Low ] != SdbLinePtr->Code ) )
+            {
+               continue;
+            }
+         }
+
+         /* As eStdReaderTime, without the call for each record */
+         Seconds  = ReaderPtr->TimeHour.t_sec +
+                    SdbLinePtr->TimeOffset / (long)E_TTL_MICROSECS_PER_SEC;
+         NanoSecs = ReaderPtr->TimeHour.t_nsec +
+                    (SdbLinePtr->TimeOffset % (long)E_TTL_MICROSECS_PER_SEC) *
+                    ((long)E_TTL_NANOSECS_PER_SEC / (long)E_TTL_MICROSECS_PER_SEC);
+         if( NanoSecs >= E_TTL_NANOSECS_PER_SEC )
+         {
+            Seconds++;
+            NanoSecs -= E_TTL_NANOSECS_PER_SEC;
+         }
+         if( ( Seconds < ReaderPtr->StartTime.t_sec ) ||
+             ( Seconds > ReaderPtr->StopTime.t_sec ) )
+         {
+            continue;
+         }
+
+         SamplePtr->Code             = SdbLinePtr->Code;
+         SamplePtr->TimeStamp.t_sec  = Seconds;
+         SamplePtr->TimeStamp.t_nsec = NanoSecs;
+         SamplePtr->Value            = SdbLinePtr->Value;
+         SamplePtr++;
+      }
+
+      ReaderPtr->BatchLeft -= SdbLinePtr - ReaderPtr->BatchPtr;
+      ReaderPtr->BatchPtr   = SdbLinePtr;
+   }
+
+   *NumSamplesPtr = SamplePtr - SamplesPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderForEach
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Pass every decoded record of a reader to a function.
+** 
+** Description:
+**    Retrieves the samples by eStdReaderBatch, up to E_STD_SAMPLE_BATCH
+**    at a time, and calls the function given with each batch, until the
+**    stop time has been passed. Stops early if the function returns
+**    anything but SYS_NOMINAL. The samples are only valid during the
+**    call.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, the error met reading,
+**       E_STD_MEM_ALLOC_ERR, or what the function returned to stop.
+**
+** Arguments:
+**    eStdReader_t  *ReaderPtr         (in/out)
+**       The reader.
+**    eStdSampleFn_t SampleFn          (in)
+**       Function called with each batch.
+**    void          *ContextPtr        (in)
+**       Passed to the function.
+**
+*****************************************************************************/
+Status_t eStdReaderForEach( eStdReader_t *ReaderPtr,
+                            eStdSampleFn_t SampleFn,
+                            void *ContextPtr )
+{
+   Status_t      Status;
+   eStdSample_t *SamplesPtr;    /* Batch of samples */
+   size_t        NumSamples;    /* Samples in the batch */
+   Bool_t        Finished;      /* Passed the stop time */
+
+   SamplesPtr = (eStdSample_t *) TTL_MALLOC( sizeof( eStdSample_t ) * E_STD_SAMPLE_BATCH );
+   if( SamplesPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   Finished = FALSE;
+   Status   = SYS_NOMINAL;
+   while( ( SYS_NOMINAL == Status ) && !Finished )
+   {
+      Status = eStdReaderBatch( ReaderPtr, SamplesPtr, E_STD_SAMPLE_BATCH,
+                                &NumSamples, &Finished );
+      if( ( SYS_NOMINAL == Status ) && ( NumSamples > 0 ) )
+      {
+         Status = SampleFn( SamplesPtr, NumSamples, ContextPtr );
+      }
+   }
+
+   TTL_FREE( SamplesPtr );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdReaderClose
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Finish with a reader.
+** 
+** Description:
+**    Closes any open Sdb file and frees the reader, including the chunk
+**    of data last returned by it.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr      (in)
+**       The reader, may be NULL.
+**
+*****************************************************************************/
+Status_t eStdReaderClose( eStdReader_t *ReaderPtr )
+{
+   int i;   /* Block of the ring */
+
+   if( ReaderPtr == NULL )
+   {
+      return SYS_NOMINAL;
+   }
+
+   mStdCloseSdbFile( ReaderPtr );
+   iStdBundleClose( ReaderPtr->BundlePtr );
+
+   for( i = 0; i < M_STD_RING_SIZE; i++ )
+   {
+      TTL_FREE( ReaderPtr->Ring[i].DataPtr );
+   }
+
+   pthread_cond_destroy( &(ReaderPtr->Emptied) );
+   pthread_cond_destroy( &(ReaderPtr->Filled) );
+   pthread_mutex_destroy( &(ReaderPtr->Lock) );
+
+   iStdColReadFree( &(ReaderPtr->Columns) );
+   TTL_FREE( ReaderPtr->WantCodes );
+   TTL_FREE( ReaderPtr->MatchCodes );
+   TTL_FREE( ReaderPtr->SdbBlockPtr );
+   TTL_FREE( ReaderPtr->DataPtr );
+   TTL_FREE( ReaderPtr );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdSearchData
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Searches a line of raw sdb data for requested source/datum pairs.
+** 
+** Description:
+**    This function accepts a single line of raw Sdb data and checks to
+**    see if it matches requested source/datum pairs. If a match is found
+**    the function returns the timestamp and value of the source/datum
+**    pair.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    Int32_t       CilId          (in)
+**       Cil Id to search for.
+**    Int32_t       DatId          (in)
+**       Data Id to search for.
+**    eSdbRawFmt_t  SdbLine        (in)
+**       A line from the Sdb chunk.
+**    eTtlTime_t   *TimeStamp      (out)
+**       Time stamp when datum was submitted.
+**    Int32_t      *Value          (out)
+**       Value of datum.  
+**    Bool_t       *GotData        (out)
+**       Flag indicating if we've found data.
+** Authors:
+**    Martin Norbury (man)
+**
+*****************************************************************************/
+Status_t eStdSearchData( Int32_t CilId, 
+                         Int32_t DatId, 
+                         eSdbRawFmt_t SdbLine,
+                         eTtlTime_t *TimeStampPtr,
+                         Int32_t *Value,
+                         Bool_t *GotMatch )
+{             
+   Status_t      Status;
+   eSdbSngReq_t  SrcDat;
+       
+   /* Decode the line of Sdb data */
+   Status = eSdbStoreIdDecode(&(SdbLine.Code), &SrcDat);    
+   if ( SYS_NOMINAL != Status )
+   {
+      return Status;
+   }   
+
+   /* Check to see if source/datum pairs match */
+   if( (CilId != SrcDat.SourceId) || (DatId != SrcDat.DatumId) )
+   {  
+      /* Not what we're looking for so return */
+      *GotMatch = FALSE;
+      return SYS_NOMINAL;
+   }
+
+   /* Calculate the time stamp */
+   Status = eStdRecordTime( &SdbLine, TimeStampPtr );
+   if ( Status != SYS_NOMINAL)
+   {
+      return Status;
+   }
+
+   *GotMatch = TRUE;
+
+   *Value = SdbLine.Value;
+
+   return SYS_NOMINAL;
+}
+/*****************************************************************************
+** Function Name:
+**    eStdRecordTime
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Calculate the time stamp of a line of raw sdb data.
+** 
+** Description:
+**    Adds the time offset held in the line of Sdb data to the start of
+**    the hour of the Sdb file it was most recently read from by
+**    eStdRetrieveData. Intended
+**    for use once a line is known to be of interest, as an alternative
+**    to eStdSearchData.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    eSdbRawFmt_t *SdbLinePtr     (in)
+**       A line from the Sdb chunk.
+**    eTtlTime_t   *TimeStampPtr   (out)
+**       Time stamp when datum was submitted.
+**
+*****************************************************************************/
+Status_t eStdRecordTime( eSdbRawFmt_t *SdbLinePtr, eTtlTime_t *TimeStampPtr )
+{
+   eTtlTime_t    TimeOffset;
+
+   TimeOffset.t_sec  = SdbLinePtr->TimeOffset / E_TTL_MICROSECS_PER_SEC;
+   TimeOffset.t_nsec = (SdbLinePtr->TimeOffset % (long)E_TTL_MICROSECS_PER_SEC) *
+                       ((long)E_TTL_NANOSECS_PER_SEC / (long)E_TTL_MICROSECS_PER_SEC);
+   
+   return eTimSum(&TimeHour, &TimeOffset, TimeStampPtr);
+}
+/*****************************************************************************
+** Function Name:
+**    mStdConvertTime
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Convert time from eTtlTime_t format to eStdTime_t format.
+**
+** Description:
+**    eTtlTime is elapsed time in seconds and nanoseconds relative
+**    to some arbitrary point in the past. eSdtTime is expressed in
+**    year, month, day, hour, minute, second and milliseconds.
+**    Uses localtime_r so may be called from several threads at once.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success. 
+**
+** Arguments:
+**    iTtlTime_t    InTime      (in)
+**       Input time format.
+**    eStdTime_t   *OutTimePtr  (out)
+**       Output time format.
+**    
+** Authors:
+**    man: Martin Norbury
+**
+*****************************************************************************/
+Status_t mStdConvertTime( eTtlTime_t InTime, eStdTime_t *OutTimePtr )
+{
+   time_t     Seconds;      /* Time in seconds */
+   struct tm  Tm;           /* Broken down time */
+
+   /* Break down the time, reentrantly as readers may be in any thread */
+   Seconds = (time_t) InTime.t_sec;
+   if( localtime_r( &Seconds, &Tm ) == NULL )
+   {
+      eLogErr(E_STD_GEN_ERROR,"Error converting system time");
+      return E_STD_GEN_ERROR;
+   }
+
+   /* Year without century, as given by eTimToString */
+   OutTimePtr->Year        = Tm.tm_year % 100;
+   OutTimePtr->Month       = Tm.tm_mon + 1;
+   OutTimePtr->Date        = Tm.tm_mday;
+   OutTimePtr->Hour        = Tm.tm_hour;
+   OutTimePtr->Minute      = Tm.tm_min;
+   OutTimePtr->Second      = Tm.tm_sec;
+   OutTimePtr->MilliSecond = InTime.t_nsec / E_TTL_NANOSECS_PER_MILLISEC;
+
+   return SYS_NOMINAL;
+}
+/*****************************************************************************
+** Function Name:
+**    mStdReadSdbHeader
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the header portion of the Sdb file.
+**
+** Description:
+**    Reads the header portion of the Sdb file, which is only used to tell
+**    block-structured files from the original format.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_READ_HEAD_ERR if there was
+**       a problem reading the header data i.e. the number of bytes read by
+**       fread is not equal to the expected header size.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr     (in)
+**       Reader with the current Sdb file open.
+**    size_t *NumBytes            (out)
+**       Pointer to the number of bytes read by fread.
+**
+** Authors:
+**    man: Martin Norbury
+**
+*****************************************************************************/
+Status_t mStdReadSdbHeader ( eStdReader_t *ReaderPtr, size_t *NumBytes)
+{
+   char Buf[E_STD_BUFSIZE]; /* Dummy buffer */
+
+   if( (ReaderPtr->InFile == NULL ) &&
+       (ReaderPtr->GzInFile == NULL ) )
+   {
+      return E_STD_NULL_FILE_POINTER;
+   }
+
+   /* Read the header */
+   if ( ReaderPtr->MapPtr != NULL )
+   {
+      *NumBytes = ReaderPtr->MapSize < E_STD_FILE_HDR_SIZE ?
+                  ReaderPtr->MapSize : E_STD_FILE_HDR_SIZE;
+      memcpy( Buf, ReaderPtr->MapPtr + ReaderPtr->MapOffset, *NumBytes );
+      ReaderPtr->MapOffset += *NumBytes;
+   }
+   else if ( ReaderPtr->BgzfPtr != NULL )
+   {
+      iStdBgzfInfo( ReaderPtr->BgzfPtr, Buf, NULL, NULL );
+      *NumBytes = E_STD_FILE_HDR_SIZE;
+   }
+   else if ( ReaderPtr->Gzipped == FALSE )
+   {
+      *NumBytes = fread(Buf, sizeof(char), E_STD_FILE_HDR_SIZE, ReaderPtr->InFile);
+   }
+   else
+   {
+      *NumBytes = gzread( ReaderPtr->GzInFile, Buf, sizeof(char) * E_STD_FILE_HDR_SIZE );
+   }
+
+   if(*NumBytes != E_STD_FILE_HDR_SIZE)
+   {
+      return E_STD_READ_HEAD_ERR; 
+   }   
+
+   ReaderPtr->Blocked = ( memcmp( Buf, E_SDB_HEADER_STRING_V2, E_STD_FILE_HDR_SIZE ) == 0 )
+                        ? TRUE : FALSE;
+
+   return SYS_NOMINAL;
+}
+/*****************************************************************************
+** Function Name:
+**    mStdReadSdbTimeStamp
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the timestamp for the current Sdb file.
+**
+** Description:
+**    Read the timestamp for the current Sdb file. All Sdb time measurements
+**    are read as an offset relative to this timestamp.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_READ_TIME_ERR if there was
+**       a problem reading the timestamp.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr (in)
+**       Reader with the current Sdb file open.
+**    eTtlTime_t  *TimeHour  (out)
+**       Timestamp of the current Sdb file.
+**
+** Authors:
+**    man: Martin Norbury
+**
+*****************************************************************************/
+Status_t mStdReadSdbTimeStamp ( eStdReader_t *ReaderPtr, eTtlTime_t *TimeHour )
+{
+   int NumRecords;    /* Number of records read in by fread */
+   char Header[ I_STD_RECORDS_START ]; /* Header of a block-compressed file */
+
+   if( (ReaderPtr->InFile == NULL ) &&
+       (ReaderPtr->GzInFile == NULL ) )
+   {
+      return E_STD_NULL_FILE_POINTER;
+   }
+
+   /* Get the file "time-stamp", from which all other times are offset. */
+   if ( ReaderPtr->MapPtr != NULL )
+   {
+      NumRecords = 0;
+      if ( ReaderPtr->MapSize - ReaderPtr->MapOffset >= sizeof(TimeHour->t_sec) )
+      {
+         memcpy( &(TimeHour->t_sec), ReaderPtr->MapPtr + ReaderPtr->MapOffset,
+                 sizeof(TimeHour->t_sec) );
+         ReaderPtr->MapOffset += sizeof(TimeHour->t_sec);
+         NumRecords = 1;
+      }
+   }
+   else if ( ReaderPtr->BgzfPtr != NULL )
+   {
+      iStdBgzfInfo( ReaderPtr->BgzfPtr, Header, NULL, NULL );
+      memcpy( &(TimeHour->t_sec), Header + E_STD_FILE_HDR_SIZE, sizeof(TimeHour->t_sec) );
+      NumRecords = 1;
+   }
+   else if ( ReaderPtr->Gzipped == FALSE )
+   {
+      NumRecords = fread(&(TimeHour->t_sec), sizeof(TimeHour->t_sec), 1, ReaderPtr->InFile);
+   }
+   else
+   {
+      NumRecords = gzread( ReaderPtr->GzInFile, &(TimeHour->t_sec), sizeof(TimeHour->t_sec) * 1) / sizeof(TimeHour->t_sec);
+   }
+
+   if(NumRecords != 1)
+   {
+      return E_STD_READ_TIME_ERR;
+   }
+   
+   TimeHour->t_nsec = 0;
+
+   return SYS_NOMINAL;
+}
+/*****************************************************************************
+** Function Name:
+**    mStdReadSdbChunk
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read in a chunk of the SDB file.
+**
+** Description:
+**    Reads in an SDB file a chunk at a time. Reading in a large section of 
+**    the SDB file is faster than multiple calls to the fread statement.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success. Currently this function cannot fail.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr     (in)
+**       Reader with the current SDB file open.
+**    eSdbRawFmt_t *SdbChunkPtr   (in)
+**       Pointer to structure to store the SDB date read in.
+**    size_t  SdbChunkSize        (in)
+**       Number of eSdbRawFmt elements to be read in.
+**    size_t *NumRecords          (out)
+**       Number of eSdbRawFmt elements actually read in.
+**
+** Authors:
+**    djm: Derek J. McKay (TTL)
+**    man: Martin Norbury
+**
+*****************************************************************************/
+Status_t mStdReadSdbChunk ( eStdReader_t *ReaderPtr,
+                            eSdbRawFmt_t *SdbChunkPtr,
+                            size_t        SdbChunkSize,
+                            size_t       *NumRecords)
+{
+
+   if( (ReaderPtr->InFile == NULL ) &&
+       (ReaderPtr->GzInFile == NULL ) )
+   {
+      return E_STD_NULL_FILE_POINTER;
+   }
+
+   if ( ReaderPtr->Gzipped == FALSE )
+   {
+      *NumRecords = fread (SdbChunkPtr, sizeof (eSdbRawFmt_t), SdbChunkSize, ReaderPtr->InFile);
+   }
+   else
+   {
+      *NumRecords = gzread ( ReaderPtr->GzInFile, SdbChunkPtr, sizeof (eSdbRawFmt_t) * SdbChunkSize ) / sizeof (eSdbRawFmt_t) ;
+   }
+
+   eLogDebug("Read %d records from time point %x.", NumRecords, SdbChunkPtr->TimeOffset);
+
+   /* Check for end of file. */
+   if ( ReaderPtr->Gzipped == FALSE )
+   {
+      if (feof(ReaderPtr->InFile))
+      {
+        return E_STD_EOF;
+      }
+      else
+      {
+        return SYS_NOMINAL;
+      }
+   }
+   else
+   {
+      if (gzeof(ReaderPtr->GzInFile))
+      {
+        return E_STD_EOF;
+      }
+      else
+      {
+        return SYS_NOMINAL;
+      }
+   }
+}
+/*****************************************************************************
+** Function Name:
+**    mStdOpenSdbFile
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Open an Sdb file from disk.
+**
+** Description:
+**    This function generates the name of the Sdb file, based on the
+**    year, month, day and hour, unless the reader's catalog has found
+**    the hour's file. The plain file is opened if there is one, else the
+**    block-compressed one, else the gzipped one. A block-compressed file
+**    which is not valid is passed over with a warning. The function then
+**    returns the file pointer. If a bundle holds the hour's day or month
+**    no file is looked for, and the hour's file is read from the bundle.
+**    If the reader was given a list of files, only the hour's file in the
+**    list is opened.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**       Returns E_STD_FILE_OPEN_ERR if failed to open Sdb file 
+**
+** Arguments:
+**    eStdTime_t    Time        (in)
+**       Time used to generate filename.
+**    eStdReader_t *ReaderPtr   (in/out)
+**       Reader to open the sdb file for.
+**    
+** Authors:
+**    man: Martin Norbury
+**
+*****************************************************************************/
+Status_t mStdOpenSdbFile( eStdTime_t    Time, 
+                          eStdReader_t *ReaderPtr )
+{
+   Status_t Status;
+   char     SdbFilePath[ FILENAME_MAX ];
+
+   mStdSdbFileName( Time, ReaderPtr->Path, SdbFilePath );
+   eLogNotice(0,"Starting to process time index %.8s",
+              SdbFilePath + strlen( ReaderPtr->Path ) );
+
+   if( ReaderPtr->ListedFile[0] != '\0' )
+   {
+      Status = mStdOpenListedFile( ReaderPtr );
+   }
+   else if( mStdFindBundle( ReaderPtr, &Time ) == TRUE )
+   {
+      return mStdOpenBundleHour( ReaderPtr, &Time );
+   }
+   else
+   {
+      Status = mStdFindSdbFile( ReaderPtr, SdbFilePath );
+   }
+   if( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   /* Pass over the file if its series index shows nothing wanted in it */
+   if( mStdSelectBlocks( ReaderPtr ) == FALSE )
+   {
+      mStdCloseSdbFile( ReaderPtr );
+      return SYS_NOMINAL;
+   }
+
+   if( ( ReaderPtr->Gzipped == FALSE ) && ( ReaderPtr->BgzfPtr == NULL ) )
+   {
+      mStdMapSdbFile( ReaderPtr );
+   }
+   
+   return SYS_NOMINAL;
+} 
+
+/*****************************************************************************
+** Function Name:
+**    mStdFindSdbFile
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find and open the Sdb file of an hour.
+**
+** Description:
+**    The plain file is opened if there is one, else the block-compressed
+**    one, else the gzipped one, from the name of the hour's file or that
+**    the reader's catalog found. A block-compressed file which is not
+**    valid is passed over with a warning.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or E_STD_FILE_OPEN_ERR if the hour
+**       has no file.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr     (in/out)
+**       Reader to open the file for.
+**    char         *SdbFilePath   (in)
+**       Name of the hour's plain file, FILENAME_MAX characters, used to
+**       form the others.
+**    
+*****************************************************************************/
+static Status_t mStdFindSdbFile( eStdReader_t *ReaderPtr, char *SdbFilePath )
+{
+   size_t Len;                             /* Length of the catalog's name */
+
+   /* Use the file the catalog found, trying a plain one first as usual */
+   if( ReaderPtr->CatalogFile[0] != '\0' )
+   {
+      strcpy( SdbFilePath, ReaderPtr->CatalogFile );
+      Len = strlen( SdbFilePath );
+      if( ( Len > strlen( I_STD_EXT_GZIP ) ) &&
+          ( strcmp( SdbFilePath + Len - strlen( I_STD_EXT_GZIP ), I_STD_EXT_GZIP ) == 0 ) )
+      {
+         SdbFilePath[ Len - strlen( I_STD_EXT_GZIP ) ] = '\0';
+      }
+      else if( ( Len > strlen( I_STD_EXT_BGZF ) ) &&
+               ( strcmp( SdbFilePath + Len - strlen( I_STD_EXT_BGZF ), I_STD_EXT_BGZF ) == 0 ) )
+      {
+         SdbFilePath[ Len - strlen( I_STD_EXT_BGZF ) ] = '\0';
+      }
+   }
+
+   strcpy( ReaderPtr->FilePath, SdbFilePath );
+
+   if( (ReaderPtr->InFile = mStdOpenStream( SdbFilePath )) == NULL)
+   {
+      /* If unable to open file, try block-compressed version */
+      strcat( ReaderPtr->FilePath, I_STD_EXT_BGZF );
+      if( ( (ReaderPtr->InFile = mStdOpenStream( ReaderPtr->FilePath )) != NULL ) &&
+          ( iStdBgzfOpen( ReaderPtr->InFile, 0, 0, &(ReaderPtr->BgzfPtr) ) != SYS_NOMINAL ) )
+      {
+         eLogWarning(E_STD_READ_DATA_ERR,"Ignoring invalid file %s", ReaderPtr->FilePath);
+         fclose( ReaderPtr->InFile );
+         ReaderPtr->InFile = NULL;
+      }
+      if( ReaderPtr->InFile == NULL )
+      {
+         strcpy( ReaderPtr->FilePath, SdbFilePath );
+      }
+   }
+
+   if( ReaderPtr->InFile == NULL )
+   {
+      /* If unable to open either, try gzipped version */
+      strcat( SdbFilePath, I_STD_EXT_GZIP  );
+      strcat( ReaderPtr->FilePath, I_STD_EXT_GZIP );
+      if( (ReaderPtr->GzInFile = mStdOpenGzStream( SdbFilePath )) == NULL) 
+      {
+         eLogNotice(E_STD_FILE_OPEN_ERR,"Unable to open file %s", SdbFilePath );
+         return E_STD_FILE_OPEN_ERR;
+      }
+      else
+      {
+         ReaderPtr->Gzipped = TRUE;
+      }
+   }
+   else
+   {
+      ReaderPtr->Gzipped = FALSE;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdOpenListedFile
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Open the Sdb file of an hour named in the reader's list of files.
+**
+** Description:
+**    Only the file named is opened, as gzipped, block-compressed or
+**    plain by its name. A block-compressed file which is not valid is
+**    passed over with a warning, as is a file which can no longer be
+**    opened.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or E_STD_FILE_OPEN_ERR.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in/out)
+**       Reader to open the file for.
+**    
+*****************************************************************************/
+static Status_t mStdOpenListedFile( eStdReader_t *ReaderPtr )
+{
+   size_t Len;   /* Length of the file's name */
+
+   strcpy( ReaderPtr->FilePath, ReaderPtr->ListedFile );
+   Len = strlen( ReaderPtr->FilePath );
+
+   ReaderPtr->Gzipped = ( ( Len > strlen( I_STD_EXT_GZIP ) ) &&
+                          ( strcmp( ReaderPtr->FilePath + Len - strlen( I_STD_EXT_GZIP ),
+                                    I_STD_EXT_GZIP ) == 0 ) ) ? TRUE : FALSE;
+
+   if( ReaderPtr->Gzipped == TRUE )
+   {
+      ReaderPtr->GzInFile = mStdOpenGzStream( ReaderPtr->FilePath );
+   }
+   else
+   {
+      ReaderPtr->InFile = mStdOpenStream( ReaderPtr->FilePath );
+      if( ( ReaderPtr->InFile != NULL ) &&
+          ( Len > strlen( I_STD_EXT_BGZF ) ) &&
+          ( strcmp( ReaderPtr->FilePath + Len - strlen( I_STD_EXT_BGZF ), I_STD_EXT_BGZF ) == 0 ) &&
+          ( iStdBgzfOpen( ReaderPtr->InFile, 0, 0, &(ReaderPtr->BgzfPtr) ) != SYS_NOMINAL ) )
+      {
+         eLogWarning(E_STD_READ_DATA_ERR,"Ignoring invalid file %s", ReaderPtr->FilePath);
+         fclose( ReaderPtr->InFile );
+         ReaderPtr->InFile = NULL;
+         return E_STD_FILE_OPEN_ERR;
+      }
+   }
+
+   if( ( ReaderPtr->InFile == NULL ) && ( ReaderPtr->GzInFile == NULL ) )
+   {
+      eLogWarning(E_STD_FILE_OPEN_ERR,"Unable to open file %s", ReaderPtr->FilePath);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdOpenStream
+**
+** Type:
+**    FILE *
+**
+** Purpose:
+**    Open an Sdb file to be read from start to end.
+**
+** Description:
+**    The kernel is advised the file will be read sequentially, so reads
+**    ahead further, making fewer, larger reads of a file over NFS.
+**
+** Return type:
+**    FILE *
+**       The file, or NULL if it could not be opened.
+**
+** Arguments:
+**    char *PathPtr   (in)
+**       Path of the file.
+**    
+*****************************************************************************/
+static FILE *mStdOpenStream( char *PathPtr )
+{
+   FILE *InFile;   /* The file */
+
+   if( ( InFile = fopen( PathPtr, "rb" ) ) != NULL )
+   {
+      posix_fadvise( fileno( InFile ), 0, 0, POSIX_FADV_SEQUENTIAL );
+   }
+
+   return InFile;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdOpenGzStream
+**
+** Type:
+**    gzFile
+**
+** Purpose:
+**    Open a gzipped Sdb file to be read from start to end.
+**
+** Description:
+**    As mStdOpenStream, for a gzipped file.
+**
+** Return type:
+**    gzFile
+**       The file, or NULL if it could not be opened.
+**
+** Arguments:
+**    char *PathPtr   (in)
+**       Path of the file.
+**    
+*****************************************************************************/
+static gzFile mStdOpenGzStream( char *PathPtr )
+{
+   gzFile GzInFile;   /* The file */
+   int    Fd;         /* Its descriptor */
+
+   if( ( Fd = open( PathPtr, O_RDONLY ) ) < 0 )
+   {
+      return NULL;
+   }
+   posix_fadvise( Fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+   if( ( GzInFile = gzdopen( Fd, "rb" ) ) == NULL )
+   {
+      close( Fd );
+   }
+
+   return GzInFile;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSdbFileName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Generate the name of the Sdb file for an hour.
+**
+** Description:
+**    The name is formed from the year, month, day and hour, following
+**    the directory holding the Sdb files.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdTime_t    Time        (in)
+**       Time used to generate filename.
+**    char         *PathPtr     (in)
+**       Directory holding the Sdb files.
+**    char         *NamePtr     (out)
+**       Path of the Sdb file, at least E_STD_STRING_LEN * 2 characters.
+**    
+*****************************************************************************/
+static void mStdSdbFileName( eStdTime_t Time, char *PathPtr, char *NamePtr )
+{
+   strncpy( NamePtr, PathPtr, E_STD_MAX_STRING_LEN );
+   NamePtr[ E_STD_MAX_STRING_LEN ] = '\0';
+   sprintf( NamePtr + strlen( NamePtr ), "%.2d%.2d%.2d%.2d.sdb",
+            Time.Year, Time.Month, Time.Date, Time.Hour );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdPrefetchSdbFile
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Start reading the Sdb file for the hour after the current one.
+**
+** Description:
+**    Advises the kernel that the next hour's file, plain or compressed,
+**    will be needed soon, so it is read from disk or NFS while the current
+**    one is being searched. With a catalog that is the file of the next
+**    hour it shows is wanted, and with a bundle of its day or month, its
+**    part of the bundle. With a list of files it is the next file in the
+**    list. Nothing is done if the next hour is past the
+**    stop time. Failures are ignored as this is only advice.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in)
+**       Reader with the current hour's file open.
+**    
+*****************************************************************************/
+static void mStdPrefetchSdbFile( eStdReader_t *ReaderPtr )
+{
+   eTtlTime_t NextTime;                          /* The next hour */
+   eStdTime_t StdTime;                           /* Next hour broken down */
+   char       SdbFilePath[ FILENAME_MAX + sizeof( I_STD_EXT_BGZF ) ];
+   int        Fd;                                /* The next hour's file */
+   size_t     Len;                               /* Length of its plain name */
+   Bool_t     Found;                             /* The catalog found it */
+
+   NextTime.t_sec  = ReaderPtr->Time.t_sec + E_STD_SECONDS_PER_HOUR;
+   NextTime.t_nsec = 0;
+
+   if( ReaderPtr->FilesPtr != NULL )
+   {
+      Found = ( NextTime.t_sec <= ReaderPtr->StopTime.t_sec ) &&
+              ( eStdFilesNext( ReaderPtr->FilesPtr, &(NextTime.t_sec),
+                               SdbFilePath ) == SYS_NOMINAL );
+      if( ( Found == FALSE ) || ( NextTime.t_sec > ReaderPtr->StopTime.t_sec ) )
+      {
+         return;
+      }
+   }
+   else
+   {
+      Found = ( NextTime.t_sec <= ReaderPtr->StopTime.t_sec ) &&
+              ( ReaderPtr->CatalogPtr != NULL ) &&
+              ( eStdCatalogNext( ReaderPtr->CatalogPtr, ReaderPtr->WantCodes,
+                                 ReaderPtr->NumWant, &(NextTime.t_sec),
+                                 SdbFilePath ) == SYS_NOMINAL );
+   }
+
+   if( ( NextTime.t_sec > ReaderPtr->StopTime.t_sec ) ||
+       ( mStdConvertTime( NextTime, &StdTime ) != SYS_NOMINAL ) )
+   {
+      return;
+   }
+
+   if( ( ReaderPtr->FilesPtr == NULL ) &&
+       ( mStdFindBundle( ReaderPtr, &StdTime ) == TRUE ) )
+   {
+      iStdBundleAdvise( ReaderPtr->BundlePtr, &StdTime );
+      return;
+   }
+
+   if( Found == FALSE )
+   {
+      mStdSdbFileName( StdTime, ReaderPtr->Path, SdbFilePath );
+   }
+
+   if( ( Fd = open( SdbFilePath, O_RDONLY ) ) < 0 )
+   {
+      Len = strlen( SdbFilePath );
+      strcpy( SdbFilePath + Len, I_STD_EXT_BGZF );
+      if( ( Fd = open( SdbFilePath, O_RDONLY ) ) < 0 )
+      {
+         strcpy( SdbFilePath + Len, I_STD_EXT_GZIP );
+         if( ( Fd = open( SdbFilePath, O_RDONLY ) ) < 0 )
+         {
+            return;
+         }
+      }
+   }
+
+   posix_fadvise( Fd, 0, 0, POSIX_FADV_WILLNEED );
+   close( Fd );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdMapSdbFile
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Map the plain Sdb file a reader has just opened into memory.
+**
+** Description:
+**    The whole file is mapped read-only and the kernel advised that it
+**    will be read sequentially and soon, so it can read ahead. Records
+**    are then used in place rather than copied through stdio. If only
+**    some blocks of the file are needed, only those are read ahead. If
+**    the file cannot be mapped the reader is left to use fread. A file
+**    held in a bundle is mapped where it lies in the bundle.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in/out)
+**       Reader with a plain Sdb file open.
+**    
+*****************************************************************************/
+static void mStdMapSdbFile( eStdReader_t *ReaderPtr )
+{
+   struct stat Stat;      /* Size of the open file */
+   size_t      Size;      /* Bytes of the Sdb file */
+   void       *MapPtr;    /* Start of the mapping */
+   size_t      PageSize;  /* Size of a page of memory */
+   size_t      From;      /* Start of a run of blocks needed */
+   size_t      To;        /* End of the run */
+   Uint32_t    Record;    /* Record to find the next run from */
+   Uint32_t    Start;     /* First record of a run */
+   Uint32_t    End;       /* Record following a run */
+
+   ReaderPtr->MapPtr    = NULL;
+   ReaderPtr->MapSize   = 0;
+   ReaderPtr->MapOffset = 0;
+
+   if( ReaderPtr->SegSize > 0 )
+   {
+      Size = (size_t) ReaderPtr->SegSize;
+   }
+   else if( ( fstat( fileno( ReaderPtr->InFile ), &Stat ) != 0 ) ||
+            ( Stat.st_size <= 0 ) )
+   {
+      return;
+   }
+   else
+   {
+      Size = (size_t) Stat.st_size;
+   }
+
+   MapPtr = mmap( NULL, Size, PROT_READ, MAP_PRIVATE,
+                  fileno( ReaderPtr->InFile ), (off_t) ReaderPtr->SegOffset );
+   if( MapPtr == MAP_FAILED )
+   {
+      eLogDebug("Unable to map Sdb file, reading it instead");
+      return;
+   }
+
+   if( ReaderPtr->Blocks.Bitmap == NULL )
+   {
+      posix_madvise( MapPtr, Size, POSIX_MADV_SEQUENTIAL );
+      posix_madvise( MapPtr, Size, POSIX_MADV_WILLNEED );
+   }
+   else
+   {
+      /* Only read the runs of blocks needed */
+      posix_madvise( MapPtr, Size, POSIX_MADV_RANDOM );
+
+      PageSize = (size_t) sysconf( _SC_PAGESIZE );
+      Record   = 0;
+      while( iStdSdbBlocksRun( &(ReaderPtr->Blocks), Record, &Start, &End ) == TRUE )
+      {
+         From = I_STD_RECORDS_START + (size_t) Start * sizeof( eSdbRawFmt_t );
+         To   = I_STD_RECORDS_START + (size_t) End * sizeof( eSdbRawFmt_t );
+         if( From >= Size )
+         {
+            break;
+         }
+         if( To > Size )
+         {
+            To = Size;
+         }
+         From -= From % PageSize;
+         posix_madvise( (char *) MapPtr + From, To - From, POSIX_MADV_WILLNEED );
+         Record = End;
+      }
+   }
+
+   ReaderPtr->MapPtr  = (char *) MapPtr;
+   ReaderPtr->MapSize = Size;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdColumnSpan
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Return the next span of records read from the columnar archive.
+**
+** Description:
+**    All the hour's remaining records are returned, without copying
+**    them, unless the reader limits its spans.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL, or E_STD_EOF once the last records of the
+**       hour have been returned.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr     (in/out)
+**       Reader with the current hour read from the columnar archive.
+**    eSdbRawFmt_t **SdbDataPtr   (out)
+**       Start of the span.
+**    size_t *NumRecords          (out)
+**       Number of records in the span.
+**
+*****************************************************************************/
+static Status_t mStdColumnSpan( eStdReader_t *ReaderPtr,
+                                eSdbRawFmt_t **SdbDataPtr,
+                                size_t       *NumRecords )
+{
+   iStdColRead_t *ReadPtr;   /* Records of the hour */
+
+   ReadPtr     = &(ReaderPtr->Columns);
+   *SdbDataPtr = ReadPtr->Records + ReadPtr->NextRecord;
+   *NumRecords = ReadPtr->NumRecords - ReadPtr->NextRecord;
+   if( ( ReaderPtr->SpanSize > 0 ) && ( *NumRecords > ReaderPtr->SpanSize ) )
+   {
+      *NumRecords = ReaderPtr->SpanSize;
+   }
+   ReadPtr->NextRecord += *NumRecords;
+
+   return ( ReadPtr->NextRecord < ReadPtr->NumRecords ) ? SYS_NOMINAL : E_STD_EOF;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdMapSdbSpan
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Return the next span of records from a mapped Sdb file.
+**
+** Description:
+**    Points at the records following those already returned, without
+**    copying them. All the remaining records are returned unless the
+**    reader limits its spans, or only some blocks of the file are
+**    needed, when the next run of blocks needed is returned. A partial
+**    record at the end of the file is ignored, as it would be by fread.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL, or E_STD_EOF once the last records in the
+**       file have been returned.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr     (in/out)
+**       Reader with the current Sdb file mapped.
+**    eSdbRawFmt_t **SdbDataPtr   (out)
+**       Start of the span within the mapping.
+**    size_t *NumRecords          (out)
+**       Number of records in the span.
+**
+*****************************************************************************/
+static Status_t mStdMapSdbSpan( eStdReader_t *ReaderPtr,
+                                eSdbRawFmt_t **SdbDataPtr,
+                                size_t       *NumRecords )
+{
+   Uint32_t Record;    /* Record following those already returned */
+   Uint32_t Total;     /* Whole records in the mapping */
+   Uint32_t Start;     /* First record of the run returned */
+   Uint32_t End;       /* Record following the run */
+
+   Record = (Uint32_t) ( ( ReaderPtr->MapOffset - I_STD_RECORDS_START ) / sizeof( eSdbRawFmt_t ) );
+   Total  = (Uint32_t) ( ( ReaderPtr->MapSize - I_STD_RECORDS_START ) / sizeof( eSdbRawFmt_t ) );
+
+   *NumRecords = 0;
+   *SdbDataPtr = (eSdbRawFmt_t *) ( ReaderPtr->MapPtr + ReaderPtr->MapOffset );
+
+   if( ( iStdSdbBlocksRun( &(ReaderPtr->Blocks), Record, &Start, &End ) == FALSE ) ||
+       ( Start >= Total ) )
+   {
+      return E_STD_EOF;
+   }
+
+   if( End > Total )
+   {
+      End = Total;
+   }
+
+   *NumRecords = End - Start;
+   if( ( ReaderPtr->SpanSize > 0 ) && ( *NumRecords > ReaderPtr->SpanSize ) )
+   {
+      *NumRecords = ReaderPtr->SpanSize;
+   }
+
+   *SdbDataPtr = (eSdbRawFmt_t *) ( ReaderPtr->MapPtr + I_STD_RECORDS_START ) + Start;
+   ReaderPtr->MapOffset = I_STD_RECORDS_START + ( Start + *NumRecords ) * sizeof( eSdbRawFmt_t );
+
+   eLogDebug("Mapped %d records.", *NumRecords);
+
+   /* Finished if no more records are needed */
+   Record = Start + (Uint32_t) *NumRecords;
+   if( ( Record >= Total ) ||
+       ( iStdSdbBlocksRun( &(ReaderPtr->Blocks), Record, &Start, &End ) == FALSE ) ||
+       ( Start >= Total ) )
+   {
+      return E_STD_EOF;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdBgzfSpan
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Return the wanted records of the next block of a block-compressed
+**    Sdb file.
+**
+** Description:
+**    Blocks holding none of the records needed are passed over without
+**    inflating them. A block failing its CRC is warned of and skipped,
+**    so the rest of the hour is still read.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL, or E_STD_EOF once the last block needed has
+**       been returned.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr     (in/out)
+**       Reader with a block-compressed Sdb file open.
+**    eSdbRawFmt_t **SdbDataPtr   (out)
+**       Records of the block.
+**    size_t *NumRecords          (out)
+**       Number of records returned.
+**
+*****************************************************************************/
+static Status_t mStdBgzfSpan( eStdReader_t *ReaderPtr,
+                              eSdbRawFmt_t **SdbDataPtr,
+                              size_t       *NumRecords )
+{
+   Uint32_t NumBlocks; /* Blocks of records in the file */
+   Uint32_t First;     /* Record of the file starting the block */
+   Uint32_t Start;     /* First record of the next run needed */
+   Uint32_t End;       /* Record following the run */
+   size_t   Count;     /* Records in the block */
+
+   *NumRecords = 0;
+   iStdBgzfInfo( ReaderPtr->BgzfPtr, NULL, &NumBlocks, NULL );
+
+   while( ReaderPtr->BlockNum < NumBlocks )
+   {
+      iStdBgzfRead( ReaderPtr->BgzfPtr, ReaderPtr->BlockNum, &First, NULL, &Count );
+      ReaderPtr->BlockNum++;
+
+      /* Pass over the block if none of its records are needed */
+      if( ( iStdSdbBlocksRun( &(ReaderPtr->Blocks), First, &Start, &End ) == FALSE ) ||
+          ( Start >= First + (Uint32_t) Count ) )
+      {
+         continue;
+      }
+
+      if( iStdBgzfRead( ReaderPtr->BgzfPtr, ReaderPtr->BlockNum - 1,
+                        &First, SdbDataPtr, &Count ) != SYS_NOMINAL )
+      {
+         eLogWarning(E_STD_READ_DATA_ERR, "Block %u of %s is corrupt, skipped",
+                     ReaderPtr->BlockNum - 1, ReaderPtr->FilePath);
+         continue;
+      }
+
+      ReaderPtr->RecordNum = First;
+      mStdDropBlocks( ReaderPtr, *SdbDataPtr, &Count );
+      if( Count > 0 )
+      {
+         *NumRecords = Count;
+         eLogDebug("Inflated %d records.", *NumRecords);
+         return ( ReaderPtr->BlockNum < NumBlocks ) ? SYS_NOMINAL : E_STD_EOF;
+      }
+   }
+
+   return E_STD_EOF;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdStartReadAhead
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Start decompressing a gzipped Sdb file ahead of the reader.
+**
+** Description:
+**    Allocates the ring of blocks, if not already done, and starts the
+**    producer thread which fills them from the reader's gzipped file.
+**    The header and time stamp must have been read already.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_MEM_ALLOC_ERR or
+**       E_STD_THREAD_ERR.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in/out)
+**       Reader with a gzipped Sdb file open.
+**    
+*****************************************************************************/
+static Status_t mStdStartReadAhead( eStdReader_t *ReaderPtr )
+{
+   int    i;      /* Block of the ring */
+   size_t Size;   /* Bytes of each block */
+
+   Size = sizeof(eSdbRawFmt_t) * ReaderPtr->ChunkSize;
+   if( Size < E_SDB_BLOCK_SIZE )
+   {
+      Size = E_SDB_BLOCK_SIZE;
+   }
+
+   for( i = 0; i < M_STD_RING_SIZE; i++ )
+   {
+      if( ReaderPtr->Ring[i].DataPtr == NULL )
+      {
+         ReaderPtr->Ring[i].DataPtr = (eSdbRawFmt_t *) TTL_MALLOC( Size );
+         if( ReaderPtr->Ring[i].DataPtr == NULL )
+         {
+            return E_STD_MEM_ALLOC_ERR;
+         }
+      }
+      ReaderPtr->Ring[i].Full = FALSE;
+   }
+
+   ReaderPtr->Producer    = 0;
+   ReaderPtr->Consumer    = 0;
+   ReaderPtr->Consuming   = FALSE;
+   ReaderPtr->StopReading = FALSE;
+
+   if( pthread_create( &(ReaderPtr->Thread), NULL,
+                       mStdReadAheadThread, ReaderPtr ) != 0 )
+   {
+      eLogErr(E_STD_THREAD_ERR,"Unable to start decompression thread");
+      return E_STD_THREAD_ERR;
+   }
+
+   ReaderPtr->ReadAhead = TRUE;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdReadAheadThread
+**
+** Type:
+**    void *
+**
+** Purpose:
+**    Producer thread decompressing a gzipped Sdb file into the ring.
+**
+** Description:
+**    Fills each free block of the ring in turn with a chunk of records,
+**    waiting while all are full. From a block-structured file, each
+**    block of the ring is filled with the wanted records of one block of
+**    the file, and may be left empty. Finishes after the last block of
+**    the file, a read error, or when told to stop.
+**
+** Return type:
+**    void *
+**       Always NULL.
+**
+** Arguments:
+**    void *ArgPtr      (in)
+**       The reader.
+**    
+*****************************************************************************/
+static void *mStdReadAheadThread( void *ArgPtr )
+{
+   eStdReader_t *ReaderPtr;    /* Reader owning the ring */
+   mStdBlock_t  *BlockPtr;     /* Block being filled */
+   size_t        WantBytes;    /* Size of a full block */
+   int           NumBytes;     /* Bytes decompressed */
+   Bool_t        Last;         /* Reached the end of the file */
+   Bool_t        Stop;         /* Told to finish */
+
+   ReaderPtr = (eStdReader_t *) ArgPtr;
+   WantBytes = sizeof( eSdbRawFmt_t ) * ReaderPtr->ChunkSize;
+   if( ReaderPtr->Blocked == TRUE )
+   {
+      WantBytes = E_SDB_BLOCK_SIZE;
+   }
+
+   do
+   {
+      /* Wait for the block to be consumed */
+      pthread_mutex_lock( &(ReaderPtr->Lock) );
+      BlockPtr = ReaderPtr->Ring + ReaderPtr->Producer;
+      while( ( BlockPtr->Full == TRUE ) && ( ReaderPtr->StopReading == FALSE ) )
+      {
+         pthread_cond_wait( &(ReaderPtr->Emptied), &(ReaderPtr->Lock) );
+      }
+      Stop = ReaderPtr->StopReading;
+      pthread_mutex_unlock( &(ReaderPtr->Lock) );
+
+      if( Stop == TRUE )
+      {
+         break;
+      }
+
+      /* The block is ours until marked full */
+      NumBytes = gzread( ReaderPtr->GzInFile, BlockPtr->DataPtr, WantBytes );
+
+      BlockPtr->Status     = SYS_NOMINAL;
+      BlockPtr->NumRecords = 0;
+      if( NumBytes < 0 )
+      {
+         BlockPtr->Status = E_STD_READ_DATA_ERR;
+         Last             = TRUE;
+      }
+      else if( ReaderPtr->Blocked == TRUE )
+      {
+         /* A partial block at the end of the file is ignored */
+         if( (size_t) NumBytes == WantBytes )
+         {
+            ReaderPtr->BlockNum++;
+            BlockPtr->NumRecords = mStdUnpackBlock( ReaderPtr,
+               (eSdbDataBlock_t *) BlockPtr->DataPtr, BlockPtr->DataPtr );
+         }
+         Last = ( (size_t) NumBytes < WantBytes ) || gzeof( ReaderPtr->GzInFile );
+      }
+      else
+      {
+         BlockPtr->NumRecords = (size_t) NumBytes / sizeof( eSdbRawFmt_t );
+         Last = ( (size_t) NumBytes < WantBytes ) || gzeof( ReaderPtr->GzInFile );
+      }
+      BlockPtr->Last = Last;
+
+      pthread_mutex_lock( &(ReaderPtr->Lock) );
+      BlockPtr->Full      = TRUE;
+      ReaderPtr->Producer = ( ReaderPtr->Producer + 1 ) % M_STD_RING_SIZE;
+      pthread_cond_signal( &(ReaderPtr->Filled) );
+      pthread_mutex_unlock( &(ReaderPtr->Lock) );
+
+   } while( Last == FALSE );
+
+   return NULL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdReadAheadChunk
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Return the next block decompressed by the producer thread.
+**
+** Description:
+**    Hands the block returned by the previous call back to the producer,
+**    then waits for the next to be filled. The block is returned in
+**    place, so stays valid until the next call.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL, E_STD_EOF with the last block of the file,
+**       or E_STD_READ_DATA_ERR if it could not be decompressed.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr     (in/out)
+**       Reader decompressing a gzipped file.
+**    eSdbRawFmt_t **SdbDataPtr   (out)
+**       The records of the block.
+**    size_t *NumRecords          (out)
+**       Number of records in the block.
+**    
+*****************************************************************************/
+static Status_t mStdReadAheadChunk( eStdReader_t *ReaderPtr,
+                                    eSdbRawFmt_t **SdbDataPtr,
+                                    size_t       *NumRecords )
+{
+   mStdBlock_t *BlockPtr;     /* Block returned */
+   Status_t     Status;
+
+   pthread_mutex_lock( &(ReaderPtr->Lock) );
+
+   /* Release the block returned last time */
+   if( ReaderPtr->Consuming == TRUE )
+   {
+      ReaderPtr->Ring[ ReaderPtr->Consumer ].Full = FALSE;
+      ReaderPtr->Consumer  = ( ReaderPtr->Consumer + 1 ) % M_STD_RING_SIZE;
+      ReaderPtr->Consuming = FALSE;
+      pthread_cond_signal( &(ReaderPtr->Emptied) );
+   }
+
+   BlockPtr = ReaderPtr->Ring + ReaderPtr->Consumer;
+   while( BlockPtr->Full == FALSE )
+   {
+      pthread_cond_wait( &(ReaderPtr->Filled), &(ReaderPtr->Lock) );
+   }
+   ReaderPtr->Consuming = TRUE;
+
+   pthread_mutex_unlock( &(ReaderPtr->Lock) );
+
+   *SdbDataPtr = BlockPtr->DataPtr;
+   *NumRecords = BlockPtr->NumRecords;
+
+   eLogDebug("Decompressed %d records.", *NumRecords);
+
+   Status = BlockPtr->Status;
+   if( ( Status == SYS_NOMINAL ) && ( BlockPtr->Last == TRUE ) )
+   {
+      Status = E_STD_EOF;
+   }
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdStopReadAhead
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Stop the producer thread of a reader, if it has one.
+**
+** Description:
+**    Tells the producer to finish, should it be waiting for a block to
+**    be consumed, and waits for it. The gzipped file is then free to be
+**    closed.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in/out)
+**       The reader.
+**    
+*****************************************************************************/
+static void mStdStopReadAhead( eStdReader_t *ReaderPtr )
+{
+   if( ReaderPtr->ReadAhead == FALSE )
+   {
+      return;
+   }
+
+   pthread_mutex_lock( &(ReaderPtr->Lock) );
+   ReaderPtr->StopReading = TRUE;
+   pthread_cond_signal( &(ReaderPtr->Emptied) );
+   pthread_mutex_unlock( &(ReaderPtr->Lock) );
+
+   pthread_join( ReaderPtr->Thread, NULL );
+
+   ReaderPtr->ReadAhead = FALSE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdUseGzIndex
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Decide whether to read a gzipped Sdb file through its index.
+**
+** Description:
+**    The index is only worth using when the time range of the reader
+**    starts or stops within the hour, or only some blocks of the file
+**    hold the codes wanted, so that some spans of the file can be passed
+**    over. Block-structured files are not indexed, as their blocks can be
+**    passed over without one. The hour's time stamp must have been read.
+**
+** Return type:
+**    Bool_t
+**       TRUE if the file is to be read through its index.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in/out)
+**       Reader with a gzipped Sdb file open.
+**    
+*****************************************************************************/
+static Bool_t mStdUseGzIndex( eStdReader_t *ReaderPtr )
+{
+   Uint32_t Point;      /* Access point being checked */
+   Uint32_t NumNeeded;  /* Spans holding records wanted */
+   Uint32_t NumFull;    /* Spans holding any records */
+
+   if( ReaderPtr->Blocked == TRUE )
+   {
+      return FALSE;
+   }
+
+   if( ( ReaderPtr->NeedFrom == 0 ) && ( ReaderPtr->NeedTo == 0xffffffff ) &&
+       ( ReaderPtr->Blocks.Bitmap == NULL ) )
+   {
+      return FALSE;
+   }
+
+   if( iStdGzIndexLoad( ReaderPtr->FilePath, &(ReaderPtr->GzIndexPtr) ) != SYS_NOMINAL )
+   {
+      return FALSE;
+   }
+
+   NumNeeded = NumFull = 0;
+   for( Point = 0; Point < ReaderPtr->GzIndexPtr->Header.NumPoints; Point++ )
+   {
+      if( ReaderPtr->GzIndexPtr->Points[ Point ].NumRecords > 0 )
+      {
+         NumFull++;
+      }
+      if( mStdSpanNeeded( ReaderPtr, Point ) )
+      {
+         NumNeeded++;
+      }
+   }
+
+   if( NumNeeded == NumFull )
+   {
+      iStdGzIndexFree( ReaderPtr->GzIndexPtr );
+      ReaderPtr->GzIndexPtr = NULL;
+      return FALSE;
+   }
+
+   eLogDebug("Inflating %u of %u spans of %s", NumNeeded, NumFull,
+             ReaderPtr->FilePath);
+
+   ReaderPtr->NextPoint   = 0;
+   ReaderPtr->RecordsLeft = 0;
+
+   return TRUE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSpanNeeded
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Check whether a span of an indexed file holds records wanted.
+**
+** Description:
+**    The span is wanted if its records overlap the time range wanted
+**    and any of them lie in blocks needed.
+**
+** Return type:
+**    Bool_t
+**       TRUE if the times of records in the span overlap those wanted.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in)
+**       Reader of an indexed file.
+**    Uint32_t      Point       (in)
+**       Access point starting the span.
+**    
+*****************************************************************************/
+static Bool_t mStdSpanNeeded( eStdReader_t *ReaderPtr, Uint32_t Point )
+{
+   iStdGzIndex_t *IndexPtr;   /* Index of the file */
+   iStdGzPoint_t *PointPtr;   /* The access point */
+   Uint32_t       SpanEnd;    /* Offset the span ends at */
+   Uint32_t       First;      /* First record starting in the span */
+   Uint32_t       Last;       /* Record following those in the span */
+   Uint32_t       Start;      /* First record of a run of blocks needed */
+   Uint32_t       End;        /* Record following the run */
+
+   IndexPtr = ReaderPtr->GzIndexPtr;
+   PointPtr = IndexPtr->Points + Point;
+
+   if( ( PointPtr->NumRecords == 0 ) ||
+       ( PointPtr->MaxTime < ReaderPtr->NeedFrom ) ||
+       ( PointPtr->MinTime > ReaderPtr->NeedTo ) )
+   {
+      return FALSE;
+   }
+
+   /* The span must also hold a record in a block needed */
+   SpanEnd = Point + 1 < IndexPtr->Header.NumPoints ?
+             IndexPtr->Points[ Point + 1 ].OutOffset : IndexPtr->Header.OutSize;
+   First   = PointPtr->OutOffset <= I_STD_RECORDS_START ? 0 :
+             ( PointPtr->OutOffset - I_STD_RECORDS_START + sizeof( eSdbRawFmt_t ) - 1 )
+             / sizeof( eSdbRawFmt_t );
+   Last    = SpanEnd <= I_STD_RECORDS_START ? 0 :
+             ( SpanEnd - I_STD_RECORDS_START + sizeof( eSdbRawFmt_t ) - 1 )
+             / sizeof( eSdbRawFmt_t );
+
+   return ( iStdSdbBlocksRun( &(ReaderPtr->Blocks), First, &Start, &End ) == TRUE ) &&
+          ( Start < Last );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdReadIndexedChunk
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read a chunk of records from the wanted spans of an indexed file.
+**
+** Description:
+**    Consecutive wanted spans are inflated as a run, starting from the
+**    access point of the first. Records are returned if they start
+**    within the run. Spans not wanted are never inflated.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL, E_STD_EOF once the last run has been read,
+**       or the status of inflating the file.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr     (in/out)
+**       Reader of an indexed file.
+**    size_t *NumRecords          (out)
+**       Number of records read into the reader's chunk.
+**
+*****************************************************************************/
+static Status_t mStdReadIndexedChunk( eStdReader_t *ReaderPtr,
+                                      size_t *NumRecords )
+{
+   iStdGzIndex_t *IndexPtr;    /* Index of the file */
+   Status_t       Status;
+   Uint32_t       First;       /* First access point of a run */
+   Uint32_t       RunStart;    /* Offset the run starts at */
+   Uint32_t       RunEnd;      /* Offset the run ends at */
+   Uint32_t       RecordStart; /* Offset of the first record of the run */
+   size_t         Want;        /* Records to read */
+   size_t         NumBytes;    /* Bytes inflated */
+   char           Discard[ sizeof( eSdbRawFmt_t ) ];
+
+   IndexPtr    = ReaderPtr->GzIndexPtr;
+   *NumRecords = 0;
+
+   while( *NumRecords < ReaderPtr->ChunkSize )
+   {
+      /* Start inflating the next run of wanted spans */
+      if( ReaderPtr->GzStreamPtr == NULL )
       {
-         fclose( InFile) ;
+         while( ( ReaderPtr->NextPoint < IndexPtr->Header.NumPoints ) &&
+                ( mStdSpanNeeded( ReaderPtr, ReaderPtr->NextPoint ) == FALSE ) )
+         {
+            ReaderPtr->NextPoint++;
+         }
+         if( ReaderPtr->NextPoint >= IndexPtr->Header.NumPoints )
+         {
+            return E_STD_EOF;
+         }
+
+         First = ReaderPtr->NextPoint;
+         while( ( ReaderPtr->NextPoint < IndexPtr->Header.NumPoints ) &&
+                ( mStdSpanNeeded( ReaderPtr, ReaderPtr->NextPoint ) == TRUE ) )
+         {
+            ReaderPtr->NextPoint++;
+         }
+
+         RunStart = IndexPtr->Points[ First ].OutOffset;
+         RunEnd   = ReaderPtr->NextPoint < IndexPtr->Header.NumPoints ?
+                    IndexPtr->Points[ ReaderPtr->NextPoint ].OutOffset :
+                    IndexPtr->Header.OutSize;
+
+         /* Records follow the header and time stamp */
+         RecordStart = I_STD_RECORDS_START;
+         if( RunStart > RecordStart )
+         {
+            RecordStart += ( ( RunStart - RecordStart + sizeof( eSdbRawFmt_t ) - 1 )
+                             / sizeof( eSdbRawFmt_t ) ) * sizeof( eSdbRawFmt_t );
+         }
+         ReaderPtr->RecordsLeft = RecordStart >= RunEnd ? 0 :
+            ( RunEnd - RecordStart + sizeof( eSdbRawFmt_t ) - 1 ) / sizeof( eSdbRawFmt_t );
+
+         Status = iStdGzStreamOpen( IndexPtr, First, &(ReaderPtr->GzStreamPtr) );
+         if( Status != SYS_NOMINAL )
+         {
+            return Status;
+         }
+
+         /* Pass over the end of a record started in the previous span */
+         Status = iStdGzStreamRead( ReaderPtr->GzStreamPtr, Discard,
+                                    RecordStart - RunStart, &NumBytes );
+         if( ( Status == SYS_NOMINAL ) && ( NumBytes != RecordStart - RunStart ) )
+         {
+            ReaderPtr->RecordsLeft = 0;
+         }
       }
       else
       {
-         gzclose( GzInFile) ;
+         Status = SYS_NOMINAL;
       }
 
-      /* Advance the time by one hour */
-      Time.t_sec += E_STD_SECONDS_PER_HOUR;
-      InFile     = NULL; 
-      NewSdbFile = TRUE;
+      Want = ReaderPtr->ChunkSize - *NumRecords;
+      if( Want > ReaderPtr->RecordsLeft )
+      {
+         Want = ReaderPtr->RecordsLeft;
+      }
+
+      NumBytes = 0;
+      if( ( Status == SYS_NOMINAL ) && ( Want > 0 ) )
+      {
+         Status = iStdGzStreamRead( ReaderPtr->GzStreamPtr,
+                                    ReaderPtr->DataPtr + *NumRecords,
+                                    Want * sizeof( eSdbRawFmt_t ), &NumBytes );
+      }
+      if( Status != SYS_NOMINAL )
+      {
+         return Status;
+      }
+
+      /* A partial record at the end of the file is ignored */
+      *NumRecords            += NumBytes / sizeof( eSdbRawFmt_t );
+      ReaderPtr->RecordsLeft -= NumBytes / sizeof( eSdbRawFmt_t );
+
+      if( ( NumBytes < Want * sizeof( eSdbRawFmt_t ) ) ||
+          ( ReaderPtr->RecordsLeft == 0 ) )
+      {
+         iStdGzStreamClose( ReaderPtr->GzStreamPtr );
+         ReaderPtr->GzStreamPtr = NULL;
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdNeedRange
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Find the TimeOffsets wanted from the Sdb file of an hour.
+**
+** Description:
+**    Records are wanted for whole seconds, as times are compared, so the
+**    range runs to the end of the last second wanted.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in)
+**       The reader.
+**    eTtlTime_t   *HourPtr     (in)
+**       Start of the hour.
+**    Uint32_t     *FromPtr     (out)
+**       Least TimeOffset wanted.
+**    Uint32_t     *ToPtr       (out)
+**       Greatest TimeOffset wanted, 0xffffffff to the end of the hour.
+**    
+*****************************************************************************/
+static void mStdNeedRange( eStdReader_t *ReaderPtr,
+                           eTtlTime_t   *HourPtr,
+                           Uint32_t     *FromPtr,
+                           Uint32_t     *ToPtr )
+{
+   Int32_t FromSec;    /* First second of the hour wanted */
+   Int32_t ToSec;      /* Last second of the hour wanted */
+
+   FromSec = ReaderPtr->StartTime.t_sec - HourPtr->t_sec;
+   ToSec   = ReaderPtr->StopTime.t_sec  - HourPtr->t_sec;
+
+   *FromPtr = FromSec <= 0 ? 0 : (Uint32_t) FromSec * E_TTL_MICROSECS_PER_SEC;
+   *ToPtr   = ToSec >= E_STD_SECONDS_PER_HOUR - 1 ? 0xffffffff :
+              ToSec < 0 ? 0 : (Uint32_t) ( ToSec + 1 ) * E_TTL_MICROSECS_PER_SEC - 1;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSelectBlocks
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Find the blocks of a newly opened Sdb file which are needed.
+**
+** Description:
+**    If the reader has been given the codes wanted, and the file has an
+**    up to date series index, the blocks holding records of those codes
+**    in the time range are found. Otherwise every block is needed.
+**
+** Return type:
+**    Bool_t
+**       FALSE if the file holds nothing wanted, so can be passed over.
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in/out)
+**       Reader with an Sdb file just opened.
+**    
+*****************************************************************************/
+static Bool_t mStdSelectBlocks( eStdReader_t *ReaderPtr )
+{
+   Uint32_t NeedFrom;   /* Least TimeOffset wanted */
+   Uint32_t NeedTo;     /* Greatest TimeOffset wanted */
+
+   ReaderPtr->RecordNum = 0;
+
+   if( ReaderPtr->NumWant == 0 )
+   {
+      return TRUE;
+   }
+
+   mStdNeedRange( ReaderPtr, &(ReaderPtr->Time), &NeedFrom, &NeedTo );
+   if( iStdSdbIndexSelect( ReaderPtr->FilePath, ReaderPtr->WantCodes,
+                           ReaderPtr->NumWant, NeedFrom, NeedTo,
+                           &(ReaderPtr->Blocks) ) != SYS_NOMINAL )
+   {
+      return TRUE;
+   }
+
+   if( ReaderPtr->Blocks.NumNeeded == 0 )
+   {
+      eLogDebug("Nothing wanted in %s", ReaderPtr->FilePath);
+      iStdSdbBlocksFree( &(ReaderPtr->Blocks) );
+      return FALSE;
+   }
+
+   eLogDebug("Searching %u of %u blocks of %s", ReaderPtr->Blocks.NumNeeded,
+             ReaderPtr->Blocks.NumBlocks, ReaderPtr->FilePath);
+
+   if( ReaderPtr->Blocks.NumNeeded == ReaderPtr->Blocks.NumBlocks )
+   {
+      iStdSdbBlocksFree( &(ReaderPtr->Blocks) );
+   }
+
+   return TRUE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdDropBlocks
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Remove records of blocks not needed from a chunk read.
+**
+** Description:
+**    The records kept are moved down to the start of the chunk. Chunks
+**    must be passed in the order they were read from the file.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdReader_t *ReaderPtr   (in/out)
+**       Reader of the chunk.
+**    eSdbRawFmt_t *DataPtr     (in/out)
+**       Records of the chunk.
+**    size_t       *NumRecords  (in/out)
+**       Number of records in the chunk.
+**    
+*****************************************************************************/
+static void mStdDropBlocks( eStdReader_t *ReaderPtr,
+                            eSdbRawFmt_t *DataPtr,
+                            size_t       *NumRecords )
+{
+   Uint32_t First;     /* Record of the file starting the chunk */
+   Uint32_t Last;      /* Record following the chunk */
+   Uint32_t Record;    /* Record to find the next run from */
+   Uint32_t Start;     /* First record of a run of blocks needed */
+   Uint32_t End;       /* Record following the run */
+   size_t   Kept;      /* Records kept */
+
+   First = ReaderPtr->RecordNum;
+   Last  = First + (Uint32_t) *NumRecords;
+   ReaderPtr->RecordNum = Last;
+
+   if( ReaderPtr->Blocks.Bitmap == NULL )
+   {
+      return;
+   }
+
+   Kept   = 0;
+   Record = First;
+   while( ( Record < Last ) &&
+          ( iStdSdbBlocksRun( &(ReaderPtr->Blocks), Record, &Start, &End ) == TRUE ) &&
+          ( Start < Last ) )
+   {
+      if( End > Last )
+      {
+         End = Last;
+      }
+      memmove( DataPtr + Kept, DataPtr + ( Start - First ),
+               sizeof( eSdbRawFmt_t ) * ( End - Start ) );
+      Kept  += End - Start;
+      Record = End;
    }
 
-   return SYS_NOMINAL;
+   *NumRecords = Kept;
 }
 
 /*****************************************************************************
 ** Function Name:
-**    eStdSearchData
+**    mStdReadBlocked
 **
 ** Type:
 **    Status_t
 **
 ** Purpose:
-**    Searches a line of raw sdb data for requested source/datum pairs.
-** 
+**    Return the wanted records of the next block of a block-structured
+**    Sdb file.
+**
 ** Description:
-**    This function accepts a single line of raw Sdb data and checks to
-**    see if it matches requested source/datum pairs. If a match is found
-**    the function returns the timestamp and value of the source/datum
-**    pair.
+**    Blocks are taken in turn from the mapping of the file, or read into
+**    the reader's block, until one holding records wanted is found. Its
+**    records are returned in place.
 **
 ** Return type:
 **    Status_t
-**       Returns SYS_NOMINAL on success.
+**       Returns SYS_NOMINAL, E_STD_EOF with no records once there are no
+**       more blocks, or E_STD_MEM_ALLOC_ERR.
 **
 ** Arguments:
-**    Int32_t       CilId          (in)
-**       Cil Id to search for.
-**    Int32_t       DatId          (in)
-**       Data Id to search for.
-**    eSdbRawFmt_t  SdbLine        (in)
-**       A line from the Sdb chunk.
-**    eTtlTime_t   *TimeStamp      (out)
-**       Time stamp when datum was submitted.
-**    Int32_t      *Value          (out)
-**       Value of datum.  
-**    Bool_t       *GotData        (out)
-**       Flag indicating if we've found data.
-** Authors:
-**    Martin Norbury (man)
+**    eStdReader_t *ReaderPtr     (in/out)
+**       Reader of a block-structured file, mapped or not gzipped.
+**    eSdbRawFmt_t **SdbDataPtr   (out)
+**       The records of the block.
+**    size_t *NumRecords          (out)
+**       Number of records in the block.
 **
 *****************************************************************************/
-Status_t eStdSearchData( Int32_t CilId, 
-                         Int32_t DatId, 
-                         eSdbRawFmt_t SdbLine,
-                         eTtlTime_t *TimeStampPtr,
-                         Int32_t *Value,
-                         Bool_t *GotMatch )
-{             
-   Status_t      Status;
-   eTtlTime_t    TimeOffset;
-   eSdbSngReq_t  SrcDat;
-   char       TimeStr[E_STD_MAX_STRING_LEN];
-       
-   /* Decode the line of Sdb data */
-   Status = eSdbStoreIdDecode(&(SdbLine.Code), &SrcDat);    
-   if ( SYS_NOMINAL != Status )
-   {
-      return Status;
-   }   
-
-   /* Check to see if source/datum pairs match */
-   if( (CilId != SrcDat.SourceId) || (DatId != SrcDat.DatumId) )
-   {  
-      /* Not what we're looking for so return */
-      *GotMatch = FALSE;
-      return SYS_NOMINAL;
-   }
+static Status_t mStdReadBlocked( eStdReader_t *ReaderPtr,
+                                 eSdbRawFmt_t **SdbDataPtr,
+                                 size_t       *NumRecords )
+{
+   eSdbDataBlock_t *BlockPtr;   /* Block of the file */
+   Status_t         Status;
 
-   /* Calculate the time stamp */
-   TimeOffset.t_sec  = SdbLine.TimeOffset / E_TTL_MICROSECS_PER_SEC;
-   TimeOffset.t_nsec = (SdbLine.TimeOffset % (long)E_TTL_MICROSECS_PER_SEC) *
-                       ((long)E_TTL_NANOSECS_PER_SEC / (long)E_TTL_MICROSECS_PER_SEC);
-   
-   Status = eTimSum(&TimeHour, &TimeOffset, TimeStampPtr);
-   if ( Status != SYS_NOMINAL)
-   {
-      return Status;
-   }
+   *NumRecords = 0;
 
-   /* Get the time of datum */
-   Status = eTimToString( TimeStampPtr, E_STD_MAX_STRING_LEN, TimeStr);
-   if( Status != SYS_NOMINAL)
+   do
    {
-      eLogErr(Status,"Error converting system time to string");           
-      exit( EXIT_FAILURE );
-   }
-
-   *GotMatch = TRUE;
+      Status = mStdNextSdbBlock( ReaderPtr, &BlockPtr );
+      if( Status != SYS_NOMINAL )
+      {
+         return Status;
+      }
+      *SdbDataPtr = BlockPtr->Records;
+      *NumRecords = mStdUnpackBlock( ReaderPtr, BlockPtr, NULL );
+   } while( *NumRecords == 0 );
 
-   *Value = SdbLine.Value;
+   eLogDebug("Read %d records of block %u.", *NumRecords, ReaderPtr->BlockNum - 1);
 
    return SYS_NOMINAL;
 }
+
 /*****************************************************************************
 ** Function Name:
-**    mStdConvertTime
+**    mStdNextSdbBlock
 **
 ** Type:
 **    Status_t
 **
 ** Purpose:
-**    Convert time from eTtlTime_t format to eStdTime_t format.
+**    Get the next block of a block-structured Sdb file.
 **
 ** Description:
-**    eTtlTime is elapsed time in seconds and nanoseconds relative
-**    to some arbitrary point in the past. eSdtTime is expressed in
-**    year, month, day, hour, minute, second and milliseconds.
+**    The block is found in the mapping of the file, else read into the
+**    reader's block, allocated when first needed. A partial block at the
+**    end of the file is ignored.
 **
 ** Return type:
 **    Status_t
-**       Returns SYS_NOMINAL on success. 
+**       Returns SYS_NOMINAL, E_STD_EOF if there are no more blocks, or
+**       E_STD_MEM_ALLOC_ERR.
 **
 ** Arguments:
-**    iTtlTime_t    InTime      (in)
-**       Input time format.
-**    eStdTime_t   *OutTimePtr  (out)
-**       Output time format.
-**    
-** Authors:
-**    man: Martin Norbury
+**    eStdReader_t    *ReaderPtr  (in/out)
+**       Reader of a block-structured file, mapped or not gzipped.
+**    eSdbDataBlock_t **BlockPtr  (out)
+**       The block, valid until the next call.
 **
 *****************************************************************************/
-Status_t mStdConvertTime( eTtlTime_t InTime, eStdTime_t *OutTimePtr )
+static Status_t mStdNextSdbBlock( eStdReader_t *ReaderPtr,
+                                  eSdbDataBlock_t **BlockPtr )
 {
-   Status_t   Status;       /* Status of function calls */
-   char       TimeStr[E_STD_MAX_STRING_LEN]; /* String to store time */
-
-   /* Convert the Ttl format time to a string */
-   Status = eTimToString( &InTime, E_STD_MAX_STRING_LEN, TimeStr);
-   if( Status != SYS_NOMINAL)
+   if( ReaderPtr->MapPtr != NULL )
    {
-      eLogErr(Status,"Error converting system time to string");
-      return Status;
+      if( ReaderPtr->MapSize - ReaderPtr->MapOffset < E_SDB_BLOCK_SIZE )
+      {
+         return E_STD_EOF;
+      }
+      *BlockPtr = (eSdbDataBlock_t *) ( ReaderPtr->MapPtr + ReaderPtr->MapOffset );
+      ReaderPtr->MapOffset += E_SDB_BLOCK_SIZE;
+   }
+   else
+   {
+      if( ReaderPtr->SdbBlockPtr == NULL )
+      {
+         ReaderPtr->SdbBlockPtr = (eSdbDataBlock_t *) TTL_MALLOC( sizeof( eSdbDataBlock_t ) );
+         if( ReaderPtr->SdbBlockPtr == NULL )
+         {
+            return E_STD_MEM_ALLOC_ERR;
+         }
+      }
+      if( fread( ReaderPtr->SdbBlockPtr, E_SDB_BLOCK_SIZE, 1, ReaderPtr->InFile ) != 1 )
+      {
+         return E_STD_EOF;
+      }
+      *BlockPtr = ReaderPtr->SdbBlockPtr;
    }
-   sscanf( TimeStr,"%d/%d/%d %d:%d:%d.%d", &(OutTimePtr->Date), &(OutTimePtr->Month),
-                                           &(OutTimePtr->Year), &(OutTimePtr->Hour), 
-                                           &(OutTimePtr->Minute), &(OutTimePtr->Second), 
-                                           &(OutTimePtr->MilliSecond));
+
+   ReaderPtr->BlockNum++;
 
    return SYS_NOMINAL;
 }
+
 /*****************************************************************************
 ** Function Name:
-**    mStdReadSdbHeader
+**    mStdUnpackBlock
 **
 ** Type:
-**    Status_t
+**    size_t
 **
 ** Purpose:
-**    Read the header portion of the Sdb file.
+**    Find the records wanted from a block of a block-structured file.
 **
 ** Description:
-**    Reads the header portion of the Sdb file which is discarded as it is
-**    not required.
+**    A block is passed over if its header shows it holds no records in
+**    the time range wanted or, given the storage codes wanted, none of
+**    them. Otherwise it is checked, and passed over with a warning if it
+**    has been corrupted. The records of a block not passed over may be
+**    moved elsewhere, such as to the start of the buffer the block was
+**    read into.
 **
 ** Return type:
-**    Status_t
-**       Returns SYS_NOMINAL on success or E_STD_READ_HEAD_ERR if there was
-**       a problem reading the header data i.e. the number of bytes read by
-**       fread is not equal to the expected header size.
+**    size_t
+**       Number of records wanted, 0 if the block is passed over.
 **
 ** Arguments:
-**    FILE *InFilePtr             (in)
-**       Pointer to the current output file.
-**    size_t *NumBytes            (out)
-**       Pointer to the number of bytes read by fread.
-**
-** Authors:
-**    man: Martin Norbury
+**    eStdReader_t    *ReaderPtr  (in)
+**       Reader of the file, BlockNum counting the block.
+**    eSdbDataBlock_t *BlockPtr   (in)
+**       The block, which has just been read.
+**    eSdbRawFmt_t    *DataPtr    (out)
+**       Where to move the records to, or NULL to leave them in place.
 **
 *****************************************************************************/
-Status_t mStdReadSdbHeader ( FILE *InFilePtr, gzFile *GzInFilePtr, size_t *NumBytes)
+static size_t mStdUnpackBlock( eStdReader_t    *ReaderPtr,
+                               eSdbDataBlock_t *BlockPtr,
+                               eSdbRawFmt_t    *DataPtr )
 {
-   char Buf[E_STD_BUFSIZE]; /* Dummy buffer */
+   eSdbBlockHdr_t *HdrPtr;   /* Header of the block */
+   size_t          NumRecords; /* Records of the block */
+   size_t          i;        /* Code wanted */
+
+   HdrPtr = &(BlockPtr->Hdr);
 
-   if( (mStdGzippedFile == FALSE) &&
-       (InFilePtr == NULL ) &&
-       (GzInFilePtr == NULL ) )
+   if( ( HdrPtr->NumRecords == 0 ) ||
+       ( HdrPtr->LastOffset < ReaderPtr->NeedFrom ) ||
+       ( HdrPtr->FirstOffset > ReaderPtr->NeedTo ) )
    {
-      return E_STD_NULL_FILE_POINTER;
+      return 0;
    }
 
-   /* Read the header */
-   if ( mStdGzippedFile == FALSE )
+   if( ReaderPtr->NumWant > 0 )
    {
-      *NumBytes = fread(Buf, sizeof(char), E_STD_FILE_HDR_SIZE, InFilePtr);
+      for( i = 0; i < ReaderPtr->NumWant; i++ )
+      {
+         if( eSdbBlockMayHold( HdrPtr, ReaderPtr->WantCodes[i] ) == TRUE )
+         {
+            break;
+         }
+      }
+      if( i == ReaderPtr->NumWant )
+      {
+         return 0;
+      }
    }
-   else
+
+   if( eSdbBlockCheck( BlockPtr ) != SYS_NOMINAL )
    {
-      *NumBytes = gzread( GzInFilePtr, Buf, sizeof(char) * E_STD_FILE_HDR_SIZE );
+      eLogWarning(E_STD_READ_DATA_ERR, "Block %u of %s is corrupt, skipped",
+                  ReaderPtr->BlockNum - 1, ReaderPtr->FilePath);
+      return 0;
    }
 
-   if(*NumBytes != E_STD_FILE_HDR_SIZE)
+   /* The header may be overwritten by the records moved */
+   NumRecords = HdrPtr->NumRecords;
+   if( DataPtr != NULL )
    {
-      return E_STD_READ_HEAD_ERR; 
-   }   
+      memmove( DataPtr, BlockPtr->Records, sizeof( eSdbRawFmt_t ) * NumRecords );
+   }
 
-   return SYS_NOMINAL;
+   return NumRecords;
 }
+
 /*****************************************************************************
 ** Function Name:
-**    mStdReadSdbTimeStamp
+**    mStdFindBundle
 **
 ** Type:
-**    Status_t
+**    Bool_t
 **
 ** Purpose:
-**    Read the timestamp for the current Sdb file.
+**    Find the bundle holding an hour's Sdb file, if any.
 **
 ** Description:
-**    Read the timestamp for the current Sdb file. All Sdb time measurements
-**    are read as an offset relative to this timestamp.
+**    The reader keeps the bundle last found, which holds the hours that
+**    follow until the end of its day or month. Otherwise it is released
+**    and the bundle of the hour's day or month looked for.
 **
 ** Return type:
-**    Status_t
-**       Returns SYS_NOMINAL on success or E_STD_READ_TIME_ERR if there was
-**       a problem reading the timestamp.
+**    Bool_t
+**       TRUE if the reader's bundle now covers the hour.
 **
 ** Arguments:
-**    File        *InFilePtr (in)
-**       Pointer to current Sdb file.
-**    eTtlTime_t  *TimeHour  (out)
-**       Timestamp of the current Sdb file.
-**
-** Authors:
-**    man: Martin Norbury
-**
+**    eStdReader_t *ReaderPtr   (in/out)
+**       The reader.
+**    eStdTime_t   *TimePtr     (in)
+**       The hour.
+**    
 *****************************************************************************/
-Status_t mStdReadSdbTimeStamp ( FILE *InFilePtr, gzFile *GzInFilePtr, eTtlTime_t *TimeHour )
+static Bool_t mStdFindBundle( eStdReader_t *ReaderPtr, eStdTime_t *TimePtr )
 {
-   int NumRecords;    /* Number of records read in by fread */
-
-   if( (mStdGzippedFile == FALSE) &&
-       (InFilePtr == NULL ) &&
-       (GzInFilePtr == NULL ) )
-   {
-      return E_STD_NULL_FILE_POINTER;
-   }
-
-   /* Get the file "time-stamp", from which all other times are offset. */
-   if ( mStdGzippedFile == FALSE )
-   {
-      NumRecords = fread(&(TimeHour->t_sec), sizeof(TimeHour->t_sec), 1, InFilePtr);
-   }
-   else
+   if( ( ReaderPtr->BundlePtr != NULL ) &&
+       ( iStdBundleCovers( ReaderPtr->BundlePtr, TimePtr ) == TRUE ) )
    {
-      NumRecords = gzread( GzInFilePtr, &(TimeHour->t_sec), sizeof(TimeHour->t_sec) * 1) / sizeof(TimeHour->t_sec);
+      return TRUE;
    }
 
-   if(NumRecords != 1)
-   {
-      return E_STD_READ_TIME_ERR;
-   }
-   
-   TimeHour->t_nsec = 0;
+   iStdBundleClose( ReaderPtr->BundlePtr );
+   ReaderPtr->BundlePtr = NULL;
 
-   return SYS_NOMINAL;
+   return ( iStdBundleOpen( ReaderPtr->Path, TimePtr,
+                            &(ReaderPtr->BundlePtr) ) == SYS_NOMINAL ) ? TRUE : FALSE;
 }
+
 /*****************************************************************************
 ** Function Name:
-**    mStdReadSdbChunk
+**    mStdOpenBundleHour
 **
 ** Type:
 **    Status_t
 **
 ** Purpose:
-**    Read in a chunk of the SDB file.
+**    Open an hour's Sdb file held in the reader's bundle.
 **
 ** Description:
-**    Reads in an SDB file a chunk at a time. Reading in a large section of 
-**    the SDB file is faster than multiple calls to the fread statement.
+**    A plain file is mapped where it lies in the bundle, and a
+**    block-compressed one opened there. A plain file which cannot be
+**    mapped is passed over with a warning, as reading it through stdio
+**    would run on into the next hour's. Series indexes are not used, as
+**    they are not bundled.
 **
 ** Return type:
 **    Status_t
-**       Returns SYS_NOMINAL on success. Currently this function cannot fail.
+**       Returns SYS_NOMINAL on success, or E_STD_FILE_OPEN_ERR if the
+**       bundle holds no file of the hour or it could not be opened.
 **
 ** Arguments:
-**    FILE *InFilePtr             (in)
-**       Pointer to the current loaded SDB file.
-**    eSdbRawFmt_t *SdbChunkPtr   (in)
-**       Pointer to structure to store the SDB date read in.
-**    size_t  SdbChunkSize        (in)
-**       Number of eSdbRawFmt elements to be read in.
-**    size_t *NumRecords          (out)
-**       Number of eSdbRawFmt elements actually read in.
-**
-** Authors:
-**    djm: Derek J. McKay (TTL)
-**    man: Martin Norbury
-**
+**    eStdReader_t *ReaderPtr   (in/out)
+**       Reader whose bundle covers the hour.
+**    eStdTime_t   *TimePtr     (in)
+**       The hour.
+**    
 *****************************************************************************/
-Status_t mStdReadSdbChunk ( FILE         *InFilePtr,
-                            gzFile       *GzInFilePtr,
-                            eSdbRawFmt_t *SdbChunkPtr,
-                            size_t        SdbChunkSize,
-                            size_t       *NumRecords)
+static Status_t mStdOpenBundleHour( eStdReader_t *ReaderPtr, eStdTime_t *TimePtr )
 {
+   Status_t         Status;   /* Return value of function calls */
+   iStdBundleSlot_t Slot;     /* Where the file lies in the bundle */
 
-   if( (mStdGzippedFile == FALSE) &&
-       (InFilePtr == NULL ) &&
-       (GzInFilePtr == NULL ) )
-   {
-      return E_STD_NULL_FILE_POINTER;
-   }
-
-   if ( mStdGzippedFile == FALSE )
-   {
-      *NumRecords = fread (SdbChunkPtr, sizeof (eSdbRawFmt_t), SdbChunkSize, InFilePtr);
-   }
-   else
+   Status = iStdBundleHour( ReaderPtr->BundlePtr, TimePtr, &(ReaderPtr->InFile),
+                            &Slot, ReaderPtr->FilePath );
+   if( Status != SYS_NOMINAL )
    {
-      *NumRecords = gzread ( GzInFilePtr, SdbChunkPtr, sizeof (eSdbRawFmt_t) * SdbChunkSize ) / sizeof (eSdbRawFmt_t) ;
+      ReaderPtr->InFile = NULL;
+      eLogNotice(E_STD_FILE_OPEN_ERR,"No file of hour %.2d in bundle of %.2d/%.2d/%.2d",
+                 TimePtr->Hour, TimePtr->Date, TimePtr->Month, TimePtr->Year);
+      return E_STD_FILE_OPEN_ERR;
    }
 
-   eLogDebug("Read %d records from time point %x.", NumRecords, SdbChunkPtr->TimeOffset);
+   ReaderPtr->Gzipped   = FALSE;
+   ReaderPtr->RecordNum = 0;
 
-   /* Check for end of file. */
-   if ( mStdGzippedFile == FALSE )
+   if( Slot.Kind == I_STD_BUNDLE_BGZF )
    {
-      if (feof(InFilePtr))
-      {
-        return E_STD_EOF;
-      }
-      else
+      if( iStdBgzfOpen( ReaderPtr->InFile, Slot.Offset, Slot.Size,
+                        &(ReaderPtr->BgzfPtr) ) != SYS_NOMINAL )
       {
-        return SYS_NOMINAL;
+         eLogWarning(E_STD_READ_DATA_ERR,"Ignoring invalid file %s", ReaderPtr->FilePath);
+         mStdCloseSdbFile( ReaderPtr );
+         return E_STD_FILE_OPEN_ERR;
       }
+      return SYS_NOMINAL;
    }
-   else
+
+   ReaderPtr->SegOffset = Slot.Offset;
+   ReaderPtr->SegSize   = Slot.Size;
+   mStdMapSdbFile( ReaderPtr );
+   if( ReaderPtr->MapPtr == NULL )
    {
-      if (gzeof(GzInFilePtr))
-      {
-        return E_STD_EOF;
-      }
-      else
-      {
-        return SYS_NOMINAL;
-      }
+      eLogWarning(E_STD_READ_DATA_ERR,"Unable to map %s", ReaderPtr->FilePath);
+      mStdCloseSdbFile( ReaderPtr );
+      return E_STD_FILE_OPEN_ERR;
    }
+
+   return SYS_NOMINAL;
 }
+
 /*****************************************************************************
 ** Function Name:
-**    mStdOpenSdbFile
+**    mStdCloseSdbFile
 **
 ** Type:
-**    Status_t
+**    void
 **
 ** Purpose:
-**    Open an Sdb file from disk.
+**    Close the Sdb file a reader has open, if any.
 **
 ** Description:
-**    This function generates the name of the Sdb file, based on the
-**    year, month, day and hour. The function then returns the file
-**    pointer.
 **
 ** Return type:
-**    Status_t
-**       Returns SYS_NOMINAL on success.
-**       Returns E_STD_FILE_OPEN_ERR if failed to open Sdb file 
+**    void
 **
 ** Arguments:
-**    eStdTime_t    Time        (in)
-**       Time used to generate filename.
-**    FILE         **InFilePtr  (out)
-**       File pointer to sdb file.
+**    eStdReader_t *ReaderPtr   (in/out)
+**       Reader whose file is closed.
 **    
-** Authors:
-**    man: Martin Norbury
-**
 *****************************************************************************/
-Status_t mStdOpenSdbFile( eStdTime_t   Time, 
-                          FILE       **InFilePtr,
-                          gzFile     **GzInFilePtr,
-                          char        *PathPtr )
+static void mStdCloseSdbFile( eStdReader_t *ReaderPtr )
 {
-   char SdbFile[ E_STD_STRING_LEN ]; /* String to hold current sdb filename*/
-   char SdbFilePath[ E_STD_STRING_LEN ];
+   ReaderPtr->ColumnHour = FALSE;
+
+   if ( ReaderPtr->MapPtr != NULL )
+   {
+      munmap( ReaderPtr->MapPtr, ReaderPtr->MapSize );
+      ReaderPtr->MapPtr = NULL;
+   }
 
-   strncpy( SdbFilePath, PathPtr, E_STD_MAX_STRING_LEN);
-   sprintf(SdbFile,"%.2d%.2d%.2d%.2d.sdb",
-                    Time.Year, Time.Month,
-                    Time.Date, Time.Hour);
-   eLogNotice(0,"Starting to process time index %.8s", SdbFile);
-   strcat (SdbFilePath, SdbFile);
+   iStdBgzfClose( ReaderPtr->BgzfPtr );
+   ReaderPtr->BgzfPtr   = NULL;
+   ReaderPtr->SegOffset = 0;
+   ReaderPtr->SegSize   = 0;
 
-   if( (*InFilePtr = fopen(SdbFilePath, "rb")) == NULL)
+   if ( ReaderPtr->InFile != NULL )
    {
-      /* If unable to open file, try gzipped version */
-      strcat( SdbFilePath, I_STD_EXT_GZIP  );
-      if( (*GzInFilePtr = gzopen(SdbFilePath, "rb")) == NULL) 
-      {
-         eLogNotice(E_STD_FILE_OPEN_ERR,"Unable to open file %s[%s]", SdbFile, I_STD_EXT_GZIP );
-         return E_STD_FILE_OPEN_ERR;
-      }
-      else
-      {
-         mStdGzippedFile = TRUE;
-      }
+      fclose( ReaderPtr->InFile );
+      ReaderPtr->InFile = NULL;
    }
-   else
+
+   iStdGzStreamClose( ReaderPtr->GzStreamPtr );
+   ReaderPtr->GzStreamPtr = NULL;
+   iStdGzIndexFree( ReaderPtr->GzIndexPtr );
+   ReaderPtr->GzIndexPtr = NULL;
+   iStdSdbBlocksFree( &(ReaderPtr->Blocks) );
+
+   if ( ReaderPtr->GzInFile != NULL )
    {
-      mStdGzippedFile = FALSE;
+      mStdStopReadAhead( ReaderPtr );
+      gzclose( ReaderPtr->GzInFile );
+      ReaderPtr->GzInFile = NULL;
    }
-   
-   return SYS_NOMINAL;
-} 
+}
 
 /*****************************************************************************
 ** Function Name:
@@ -847,3 +3453,42 @@ Status_t mStdSetHour( eTtlTime_t Time, eTtlTime_t *TimeHourPtr)
    return SYS_NOMINAL;
 }
 
+/*****************************************************************************
+** Function Name:
+**    mStdCompareCodes
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order the storage codes wanted by a reader.
+**
+** Description:
+**    Used with qsort.
+**
+** Return type:
+**    int
+**       Negative, zero or positive as the first code is less than, the
+**       same as or greater than the second.
+**
+** Arguments:
+**    const void *FirstPtr    (in)
+**    const void *SecondPtr   (in)
+**       Codes compared.
+**
+*****************************************************************************/
+static int mStdCompareCodes( const void *FirstPtr, const void *SecondPtr )
+{
+   eSdbCode_t First;    /* First code */
+   eSdbCode_t Second;   /* Second code */
+
+   First  = *(const eSdbCode_t *) FirstPtr;
+   Second = *(const eSdbCode_t *) SecondPtr;
+
+   if( First < Second )
+   {
+      return -1;
+   }
+
+   return First > Second ? 1 : 0;
+}
@@ -0,0 +1,304 @@
+/*****************************************************************************
+** Module Name:
+**     StdLookup.c
+**
+** Purpose:
+**     Classify each Sdb record against the requested source/datum pairs.
+**
+** Description:
+**     Every source/datum pair requested by any configuration file is
+**     encoded once into the packed storage code written to the Sdb files.
+**     The codes are held in an open-addressed hash table, each slot
+**     naming the chain of (output, column) targets the code is routed to.
+**     A bitmap indexed on the source part of the code rejects the bulk of
+**     unwanted records before the hash table is consulted, so classifying
+**     a record costs at most one probe regardless of the number of pairs
+**     being searched for.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+#define M_STD_HASH_MULT  0x9E3779B1U  /* Multiplier for Fibonacci hashing */
+#define M_STD_NO_TARGET  -1           /* Empty slot / end of target chain */
+
+/* Local function prototypes */
+static Status_t mStdLookupAdd ( eSdbCode_t Code, Int32_t Output, Int32_t Column );
+
+/*****************************************************************************
+** Function Name:
+**    iStdLookupBuild
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Build the storage code lookup for every output.
+**
+** Description:
+**    Encodes each source/datum pair of each output into its storage code
+**    and enters it into the lookup. The table is sized to a power of two
+**    at least twice the number of pairs so probe sequences stay short.
+**    Pairs that can't be encoded can never be present in the Sdb files
+**    and are reported and skipped.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR if the
+**       table could not be allocated.
+**
+** Arguments:
+**    None.
+**
+*****************************************************************************/
+Status_t iStdLookupBuild ( void )
+{
+   Status_t      Status;      /* Return value of function calls */
+   iStdLookup_t *LookupPtr;   /* Pointer to the lookup being built */
+   iStdOutput_t *OutputPtr;   /* Output whose pairs are being added */
+   iStdData_t   *StdDataPtr;  /* Pointer to requested data id's */
+   eSdbSngReq_t  SrcDat;      /* Source/datum pair to encode */
+   eSdbCode_t    Code;        /* Storage code of source/datum pair */
+   Int32_t       NumPairs;    /* Total number of pairs requested */
+   Uint32_t      i;           /* Counter */
+   Int32_t       j;           /* Counter stepping through columns */
+   Int32_t       k;           /* Counter stepping through outputs */
+
+   LookupPtr = &iStdGlobVar.Lookup;
+   memset( LookupPtr, 0, sizeof( *LookupPtr ) );
+
+   NumPairs = 0;
+   for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+   {
+      NumPairs += iStdGlobVar.Outputs[k].NumDataSearch;
+   }
+
+   /* Size the hash table, keeping the load factor at or below one half */
+   LookupPtr->Size  = 2;
+   LookupPtr->Shift = 31;
+   while ( LookupPtr->Size < (Uint32_t) ( 2 * NumPairs ) )
+   {
+      LookupPtr->Size <<= 1;
+      LookupPtr->Shift--;
+   }
+
+   LookupPtr->Codes   = (eSdbCode_t *) TTL_MALLOC( LookupPtr->Size * sizeof( eSdbCode_t ) );
+   LookupPtr->First   = (Int32_t *) TTL_MALLOC( LookupPtr->Size * sizeof( Int32_t ) );
+   LookupPtr->Last    = (Int32_t *) TTL_MALLOC( LookupPtr->Size * sizeof( Int32_t ) );
+   LookupPtr->Targets = (iStdTarget_t *) TTL_MALLOC( ( NumPairs + 1 ) * sizeof( iStdTarget_t ) );
+   LookupPtr->Wanted  = (eSdbCode_t *) TTL_MALLOC( ( NumPairs + 1 ) * sizeof( eSdbCode_t ) );
+   if ( ( LookupPtr->Codes == NULL ) || ( LookupPtr->First == NULL ) ||
+        ( LookupPtr->Last == NULL ) || ( LookupPtr->Targets == NULL ) ||
+        ( LookupPtr->Wanted == NULL ) )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   for ( i = 0; i < LookupPtr->Size; i++ )
+   {
+      LookupPtr->First[i] = M_STD_NO_TARGET;
+   }
+
+   /* Enter the pairs in output/column order so routing preserves it */
+   for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+   {
+      OutputPtr  = iStdGlobVar.Outputs + k;
+      StdDataPtr = OutputPtr->StdData;
+
+      for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+      {
+         SrcDat.SourceId = (StdDataPtr+j)->SourceId;
+         SrcDat.DatumId  = (StdDataPtr+j)->DatumId;
+
+         Status = eSdbStoreIdEncode( &SrcDat, &Code );
+         if ( SYS_NOMINAL != Status )
+         {
+            eLogWarning( Status, "Can't encode %s, %s (0x%x,0x%x), never matched",
+                         (StdDataPtr+j)->SourceName, (StdDataPtr+j)->DatumName,
+                         (StdDataPtr+j)->SourceId, (StdDataPtr+j)->DatumId );
+            continue;
+         }
+
+         Status = mStdLookupAdd( Code, k, j );
+         if ( SYS_NOMINAL != Status )
+         {
+            return Status;
+         }
+      }
+   }
+
+   eLogDebug( "Built lookup of %d source/datum pairs in %u slots",
+              LookupPtr->NumTargets, LookupPtr->Size );
+
+   return SYS_NOMINAL;
+
+}
+/*****************************************************************************
+** Function Name:
+**    iStdLookupFind
+**
+** Type:
+**    Int32_t
+**
+** Purpose:
+**    Find the columns a storage code is routed to.
+**
+** Description:
+**    Rejects the code straight away if its source is not requested at
+**    all, otherwise probes the hash table for it. The targets for a code
+**    are chained through iStdTarget_t.Next, ending in a negative index.
+**
+** Return type:
+**    Int32_t
+**       Index of the first target in iStdGlobVar.Lookup.Targets, or a
+**       negative value if the code isn't being searched for.
+**
+** Arguments:
+**    eSdbCode_t Code              (in)
+**       Storage code of an Sdb record.
+**
+*****************************************************************************/
+Int32_t iStdLookupFind ( eSdbCode_t Code )
+{
+   iStdLookup_t *LookupPtr;   /* Pointer to the lookup */
+   Uint32_t      Source;      /* Source part of the storage code */
+   Uint32_t      Slot;        /* Slot being probed */
+
+   LookupPtr = &iStdGlobVar.Lookup;
+
+   Source = Code >> E_SDB_CODE_MASKSIZE;
+   if ( ( LookupPtr->SourceMap[ Source >> 5 ] & ( 1U << ( Source & 31 ) ) ) == 0 )
+   {
+      return M_STD_NO_TARGET;
+   }
+
+   Slot = (Uint32_t) ( Code * M_STD_HASH_MULT ) >> LookupPtr->Shift;
+   while ( LookupPtr->First[ Slot ] != M_STD_NO_TARGET )
+   {
+      if ( LookupPtr->Codes[ Slot ] == Code )
+      {
+         return LookupPtr->First[ Slot ];
+      }
+      Slot = ( Slot + 1 ) & ( LookupPtr->Size - 1 );
+   }
+
+   return M_STD_NO_TARGET;
+
+}
+/*****************************************************************************
+** Function Name:
+**    iStdLookupFree
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Give up the storage code lookup.
+**
+** Description:
+**    Leaves the lookup empty, routing no code anywhere, ready to be built
+**    again for other outputs.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    None.
+**
+*****************************************************************************/
+void iStdLookupFree ( void )
+{
+   iStdLookup_t *LookupPtr;   /* Pointer to the lookup */
+
+   LookupPtr = &iStdGlobVar.Lookup;
+
+   TTL_FREE( LookupPtr->Codes );
+   TTL_FREE( LookupPtr->First );
+   TTL_FREE( LookupPtr->Last );
+   TTL_FREE( LookupPtr->Targets );
+   TTL_FREE( LookupPtr->Wanted );
+
+   memset( LookupPtr, 0, sizeof( *LookupPtr ) );
+
+}
+/*****************************************************************************
+** Function Name:
+**    mStdLookupAdd
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Route a storage code to a column of an output.
+**
+** Description:
+**    Finds the slot for the code, claiming an empty one if the code is
+**    new, and appends the target to the end of the code's chain. New
+**    codes are also listed in Wanted, for the readers.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    eSdbCode_t Code              (in)
+**       Storage code of the source/datum pair.
+**    Int32_t    Output            (in)
+**       Index of the output in iStdGlobVar.Outputs.
+**    Int32_t    Column            (in)
+**       Index of the column in the output's StdData.
+**
+*****************************************************************************/
+static Status_t mStdLookupAdd ( eSdbCode_t Code, Int32_t Output, Int32_t Column )
+{
+   iStdLookup_t *LookupPtr;   /* Pointer to the lookup */
+   iStdTarget_t *TargetPtr;   /* Target being added */
+   Uint32_t      Source;      /* Source part of the storage code */
+   Uint32_t      Slot;        /* Slot being probed */
+
+   LookupPtr = &iStdGlobVar.Lookup;
+
+   Source = Code >> E_SDB_CODE_MASKSIZE;
+   LookupPtr->SourceMap[ Source >> 5 ] |= 1U << ( Source & 31 );
+
+   Slot = (Uint32_t) ( Code * M_STD_HASH_MULT ) >> LookupPtr->Shift;
+   while ( ( LookupPtr->First[ Slot ] != M_STD_NO_TARGET ) &&
+           ( LookupPtr->Codes[ Slot ] != Code ) )
+   {
+      Slot = ( Slot + 1 ) & ( LookupPtr->Size - 1 );
+   }
+
+   TargetPtr = LookupPtr->Targets + LookupPtr->NumTargets;
+   TargetPtr->Output = Output;
+   TargetPtr->Column = Column;
+   TargetPtr->Next   = M_STD_NO_TARGET;
+
+   if ( LookupPtr->First[ Slot ] == M_STD_NO_TARGET )
+   {
+      LookupPtr->Codes[ Slot ] = Code;
+      LookupPtr->First[ Slot ] = LookupPtr->NumTargets;
+      LookupPtr->Wanted[ LookupPtr->NumCodes++ ] = Code;
+   }
+   else
+   {
+      LookupPtr->Targets[ LookupPtr->Last[ Slot ] ].Next = LookupPtr->NumTargets;
+   }
+   LookupPtr->Last[ Slot ] = LookupPtr->NumTargets;
+
+   LookupPtr->NumTargets++;
+
+   return SYS_NOMINAL;
+
+}
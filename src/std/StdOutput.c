@@ -48,6 +48,12 @@
 #include "StdPrivate.h"
 
 /* Local function prototypes */
+static Status_t mStdWriteInfluxHeader ( FILE *OutFilePtr );
+static Status_t mStdWriteInflux ( iStdOutput_t *OutputPtr, iStdFormat_t *FormatPtr );
+static void mStdWriteInfluxKey ( iStdFormat_t *FormatPtr, char *KeyPtr );
+static Status_t mStdWriteLong ( iStdOutput_t *OutputPtr, iStdFormat_t *FormatPtr );
+static Status_t mStdWriteBinaryHeader ( iStdOutput_t *OutputPtr );
+static Status_t mStdWriteBinary ( iStdOutput_t *OutputPtr, iStdFormat_t *FormatPtr );
 
 /*****************************************************************************
 ** Function Name:
@@ -69,22 +75,43 @@
 **       a problem writing to disk.
 **
 ** Arguments:
-**    FILE *InFilePtr             (in)
-**       Pointer to the current output file.
+**    iStdOutput_t *OutputPtr     (in)
+**       Output whose file the header is written to.
 **
 ** Authors:
 **    man: Martin Norbury
 **
 *****************************************************************************/
-Status_t iStdWriteHeader ( FILE *OutFilePtr )
+Status_t iStdWriteHeader ( iStdOutput_t *OutputPtr )
 {
    int         ret;        /* Return value of the fprint call */
    int         i;          /* counter to cycle through source datum pairs*/
    iStdData_t *StdDataPtr; /* Pointer to requested data id's */ 
+   FILE       *OutFilePtr; /* Pointer to the output file */
    
    /* Initialise pointer to data */
-   StdDataPtr = iStdGlobVar.StdData;
+   StdDataPtr = OutputPtr->StdData;
+   OutFilePtr = OutputPtr->OutFilePtr;
    
+   /* Line protocol has no column headers */
+   if ( iStdGlobVar.WriteInflux == TRUE )
+   {
+      return mStdWriteInfluxHeader( OutFilePtr );
+   }
+
+   /* The columns are described in binary too */
+   if ( iStdGlobVar.WriteBinary == TRUE )
+   {
+      return mStdWriteBinaryHeader( OutputPtr );
+   }
+
+   /* The source and datum are given on each line */
+   if ( iStdGlobVar.WriteLong == TRUE )
+   {
+      ret = fprintf(OutFilePtr,"Date\tTime\tSeconds\tSource\tDatum\tValue\n");
+      return ( ret < 0 ) ? E_STD_FILE_WRITE_ERR : SYS_NOMINAL;
+   }
+
    /* Write the column headers */
    if ( iStdGlobVar.WriteMatlab == TRUE )
    {
@@ -109,11 +136,22 @@ Status_t iStdWriteHeader ( FILE *OutFilePtr )
    ** Write the source and datum id's along with the
    ** appropriate hexadecimal value.
    */
-   for(i=0; i<iStdGlobVar.NumDataSearch; i++)
+   for(i=0; i<OutputPtr->NumDataSearch; i++)
    {
-      ret = fprintf(OutFilePtr,"%s(0x%x),%s(0x%x) \t",
-                (StdDataPtr+i)->DatumName, (StdDataPtr+i)->DatumId,
-                (StdDataPtr+i)->SourceName, (StdDataPtr+i)->SourceId);
+      if ( iStdGlobVar.Window > 0 )
+      {
+         /* Followed by the summary of each stride the column holds */
+         ret = fprintf(OutFilePtr,"%s.%s(0x%x),%s(0x%x) \t",
+                   (StdDataPtr+i)->DatumName, iStdAggName( (StdDataPtr+i)->Agg ),
+                   (StdDataPtr+i)->DatumId,
+                   (StdDataPtr+i)->SourceName, (StdDataPtr+i)->SourceId);
+      }
+      else
+      {
+         ret = fprintf(OutFilePtr,"%s(0x%x),%s(0x%x) \t",
+                   (StdDataPtr+i)->DatumName, (StdDataPtr+i)->DatumId,
+                   (StdDataPtr+i)->SourceName, (StdDataPtr+i)->SourceId);
+      }
       if( ret < 0 )
       {
          /* Error writing to file */
@@ -152,70 +190,54 @@ Status_t iStdWriteHeader ( FILE *OutFilePtr )
 **       fread is not equal to the expected header size.
 **
 ** Arguments:
-**    FILE *InFilePtr             (in)
-**       Pointer to the current output file.
-**    size_t *NumBytes            (out)
-**       Pointer to the number of bytes read by fread.
+**    iStdOutput_t *OutputPtr     (in)
+**       Output whose matched data is written.
 **
 ** Authors:
 **    man: Martin Norbury
 **
 *****************************************************************************/
-Status_t iStdWriteToScreen ( void )
+Status_t iStdWriteToScreen ( iStdOutput_t *OutputPtr )
 {
+   Status_t           Status;
    int                j;
-   iStdMatchedData_t *IndexPtr;
+   iStdRow_t          Row;        /* Cursor stepping through rows */
    iStdData_t        *StdDataPtr; /* Pointer to requested data id's */
-   Bool_t             Continue =TRUE;
+   Int32_t            Value;      /* Value of column in current row */
 
    /* Initialise data pointer */
-   StdDataPtr = iStdGlobVar.StdData;
+   StdDataPtr = OutputPtr->StdData;
 
-   /*
-   ** Wind back through linked list to find first entry. 
-   */
-   IndexPtr = iStdLastMatchedPtr;
-   while (Continue)
+   Status = iStdRowStart( OutputPtr, &Row );
+   if( Status != SYS_NOMINAL )
    {
-      if (IndexPtr->PreviousPtr != NULL)
-      {
-        IndexPtr = IndexPtr->PreviousPtr;
-      }
-      else
-      {
-        Continue = FALSE;
-      }
+      return Status;
    }
 
    /*
    ** Loop through the source datum pairs to see which 
    ** one contains the data.
    */
-
-   Continue = TRUE;
-   while (Continue)
+   while ( iStdRowNext( OutputPtr, &Row ) )
    { 
-      for(j=0;j<iStdGlobVar.NumDataSearch;j++)
+      for(j=0;j<OutputPtr->NumDataSearch;j++)
       {
+         if ( iStdRowValue( OutputPtr, &Row, j, &Value ) == FALSE )
+         {
+            Value = 0;
+         }
+
          eLogInfo(
                   "%s %s,%s (0x%2.2x) = %8.8x %d",
                   iStdGlobVar.LastTimeStr, 
                   (StdDataPtr+j)->SourceName, (StdDataPtr+j)->DatumName,
                   (StdDataPtr+j)->SourceId, (StdDataPtr+j)->DatumId,
-                  IndexPtr->Value[j]
+                  Value
                  );
       }
-
-      if (IndexPtr->NextPtr != NULL)
-      {
-        IndexPtr = IndexPtr->NextPtr;
-      }
-      else
-      {
-        Continue = FALSE;
-      }
-
    }
+
+   iStdRowEnd( &Row );
  
    return SYS_NOMINAL;   
 
@@ -234,131 +256,127 @@ Status_t iStdWriteToScreen ( void )
 **    Write Sdb data which satisfies the search criteria to file. Source
 **    datum pairs have their own columns. If no data is present for a 
 **    particular source datum pair, a tab is inserted to maintain the
-**    tab delimeted format.
+**    tab delimeted format. Rows are formatted into a buffer which is
+**    written out in large blocks (see StdFormat.c).
 **
 ** Return type:
 **    Status_t
-**       Returns SYS_NOMINAL on success. 
+**       Returns SYS_NOMINAL on success or E_STD_FILE_WRITE_ERR. 
 **
 ** Arguments:
-**    FILE *OutFilePtr             (in)
-**       Pointer to output file.
-**    char *TimeStr                (in)
-**       String containing the current timestamp
+**    iStdOutput_t *OutputPtr      (in)
+**       Output whose matched data is written to its output file.
 **
 ** Authors:
 **    man: Martin Norbury
 **
 *****************************************************************************/
-Status_t iStdWriteToFile ( FILE *OutFilePtr )
+Status_t iStdWriteToFile ( iStdOutput_t *OutputPtr )
 {
    int                j;            /* Counter to cycle through search datum id's*/
-   eStdTime_t         StdTime;      /* The Lst time stamp */
-   iStdData_t        *StdDataPtr;   /* Pointer to requested data id's */
-   iStdMatchedData_t *IndexPtr;
-   Bool_t             Continue =TRUE;
-   char               TimeStr[E_STD_MAX_STRING_LEN]; /* String to contain timestamp */
+   iStdRow_t          Row;          /* Cursor stepping through rows */
+   Int32_t            Value;        /* Value of column in current row */
    Status_t           Status;
-   double             TimeSecs;
-
-   /* Initialise the Sdb data pointer */
-   StdDataPtr = iStdGlobVar.StdData;
+   iStdFormat_t       Format;       /* Buffered output to file */
+   char              *NoDataPtr;    /* Written when a column has no data */
+   Bool_t             DateTime;     /* Write date and time columns */
 
    /*fprintf(OutFilePtr, "%s", iStdGlobVar.TimeStr);*/
    eLogDebug("Writing to file");
 
-   /* Initialise data pointer */
-   StdDataPtr = iStdGlobVar.StdData;
+   Status = iStdFormatInit( &Format, OutputPtr->OutFilePtr );
+   if( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
 
-   /*
-   ** Wind back through linked list to find first entry. 
-   */
-   IndexPtr = iStdLastMatchedPtr;
-   while (Continue)
+   if ( iStdGlobVar.WriteInflux == TRUE )
    {
-      if (IndexPtr->PreviousPtr != NULL)
+      Status = mStdWriteInflux( OutputPtr, &Format );
+      if( Status != SYS_NOMINAL )
       {
-        IndexPtr = IndexPtr->PreviousPtr;
+         iStdFormatEnd( &Format );
+         return Status;
       }
-      else
+
+      return iStdFormatEnd( &Format );
+   }
+
+   if ( iStdGlobVar.WriteBinary == TRUE )
+   {
+      Status = mStdWriteBinary( OutputPtr, &Format );
+      if( Status != SYS_NOMINAL )
       {
-        Continue = FALSE;
+         iStdFormatEnd( &Format );
+         return Status;
       }
-   }
 
-   /*
-   ** Loop through the source datum pairs to see which 
-   ** one contains the data.
-   */
+      return iStdFormatEnd( &Format );
+   }
 
-   Continue = TRUE;
-   while (Continue)
+   if ( iStdGlobVar.WriteLong == TRUE )
    {
-      /* Print the start and stop time to screen */
-      Status = eTimToString( &IndexPtr->TimeStamp, E_STD_MAX_STRING_LEN, TimeStr);
-      if( Status != SYS_NOMINAL)
+      Status = mStdWriteLong( OutputPtr, &Format );
+      if( Status != SYS_NOMINAL )
       {
-        eLogErr(Status,"Error converting time to string");
-        exit(EXIT_FAILURE);
+         iStdFormatEnd( &Format );
+         return Status;
       }
 
-      sscanf(TimeStr,"%d/%d/%d %d:%d:%d.%d",&(StdTime.Year),&(StdTime.Month),&(StdTime.Date),
-                                         &(StdTime.Hour),&(StdTime.Minute),
-                                         &(StdTime.Second),&(StdTime.MilliSecond));
+      return iStdFormatEnd( &Format );
+   }
 
-      /* Print the time stamp */
-      TimeSecs = (double) IndexPtr->TimeStamp.t_sec + 
-                           ( (double) IndexPtr->TimeStamp.t_nsec / E_TTL_NANO_PER_UNIT );
+   Status = iStdRowStart( OutputPtr, &Row );
+   if( Status != SYS_NOMINAL )
+   {
+      iStdFormatEnd( &Format );
+      return Status;
+   }
 
-      if ( iStdGlobVar.WriteMatlab == TRUE )
-      {
-         fprintf(OutFilePtr, "%f\t", 
-                 TimeSecs);
-      }
-      else
-      {
-         fprintf(OutFilePtr, "%.2d/%.2d/%.2d\t%.2d:%.2d:%.2d.%.3d\t%f\t", 
-                 StdTime.Year, StdTime.Month, StdTime.Date, 
-                 StdTime.Hour, StdTime.Minute, StdTime.Second, StdTime.MilliSecond,
-                 TimeSecs);
-      }
+   DateTime = ( iStdGlobVar.WriteMatlab == TRUE ) ? FALSE : TRUE;
 
-      for(j=0;j<iStdGlobVar.NumDataSearch;j++)
+   /* No data for a datum id, so insert tab */
+   if ( ( iStdGlobVar.WriteMatlab == TRUE ) ||
+        ( iStdGlobVar.WriteGnuplot == TRUE ) )
+   {
+      NoDataPtr = "NaN\t";
+   }
+   else
+   {
+      NoDataPtr = "\t";
+   }
+
+   /*
+   ** Loop through the source datum pairs to see which 
+   ** one contains the data.
+   */
+   while ( iStdRowNext( OutputPtr, &Row ) )
+   {
+      /* Print the time stamp */
+      iStdFormatTime( &Format, &Row.TimeStamp, DateTime );
+      I_STD_FORMAT_CHAR( &Format, '\t' );
+
+      for(j=0;j<OutputPtr->NumDataSearch;j++)
       {
-         if( IndexPtr->SetFlag[j] )
+         if( iStdRowValue( OutputPtr, &Row, j, &Value ) )
          {
             /* We've got some data so print it to file */
-            fprintf(OutFilePtr,"%d\t",IndexPtr->Value[j]);
+            iStdFormatInt( &Format, Value, 1 );
+            I_STD_FORMAT_CHAR( &Format, '\t' );
          }
          else
          {
-            /* No data for this datum id, so insert tab */
-            if ( ( iStdGlobVar.WriteMatlab == TRUE ) ||
-                 ( iStdGlobVar.WriteGnuplot == TRUE ) )
-            {
-               fprintf(OutFilePtr,"NaN\t");
-            }
-            else
-            {
-               fprintf(OutFilePtr,"\t");
-            }
+            iStdFormatText( &Format, NoDataPtr );
          }
       }
 
-      if (IndexPtr->NextPtr != NULL)
-      {
-        IndexPtr = IndexPtr->NextPtr;
-      }
-      else
-      {
-        Continue = FALSE;
-      }
-
-      fprintf(OutFilePtr,"\n");
+      I_STD_FORMAT_CHAR( &Format, '\n' );
 
    }
+
+   iStdRowEnd( &Row );
  
-   return SYS_NOMINAL;
+   return iStdFormatEnd( &Format );
 
 }
     
@@ -421,3 +439,344 @@ Status_t iStdCompareTime ( eTtlTime_t LastTime, eTtlTime_t ThisTime, Bool_t *New
 
    return SYS_NOMINAL;
 }
+/*****************************************************************************
+** Function Name:
+**    mStdWriteInfluxHeader
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write the header of an InfluxDB line protocol file.
+**
+** Description:
+**    Writes the DDL section creating the database and the DML context
+**    expected by "influx -import". The database has the same name as the
+**    measurement.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_FILE_WRITE_ERR if there was
+**       a problem writing to disk.
+**
+** Arguments:
+**    FILE *OutFilePtr             (in)
+**       Pointer to the output file.
+**
+*****************************************************************************/
+static Status_t mStdWriteInfluxHeader ( FILE *OutFilePtr )
+{
+   int ret;   /* Return value of the fprint call */
+
+   ret = fprintf( OutFilePtr, "# DDL\nCREATE DATABASE %s\n\n"
+                              "# DML\n# CONTEXT-DATABASE: %s\n\n",
+                  iStdGlobVar.Measurement, iStdGlobVar.Measurement );
+   if( ret < 0 )
+   {
+      /* Error writing to file */
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+/*****************************************************************************
+** Function Name:
+**    mStdWriteInflux
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write Sdb data satisfying the search criteria as line protocol.
+**
+** Description:
+**    One line is written per time stamp, holding a field named
+**    "SOURCE.DATUM" for each source/datum pair with data at that time, or
+**    "SOURCE.DATUM.SUMMARY" when strides are summarised.
+**    Values are written without the integer suffix so they have the same
+**    (float) field type as data previously imported. The time stamp is
+**    written in integer nanoseconds.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr      (in)
+**       Output whose matched data is written to its output file.
+**    iStdFormat_t *FormatPtr      (in/out)
+**       Buffered output to file.
+**
+*****************************************************************************/
+static Status_t mStdWriteInflux ( iStdOutput_t *OutputPtr, iStdFormat_t *FormatPtr )
+{
+   Status_t           Status;
+   int                j;            /* Counter to cycle through search datum id's */
+   iStdRow_t          Row;          /* Cursor stepping through rows */
+   Int32_t            Value;        /* Value of column in current row */
+   iStdData_t        *StdDataPtr;   /* Pointer to requested data id's */
+   char               Separator;    /* Written before each field */
+
+   StdDataPtr = OutputPtr->StdData;
+
+   Status = iStdRowStart( OutputPtr, &Row );
+   if( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   while ( iStdRowNext( OutputPtr, &Row ) )
+   {
+      mStdWriteInfluxKey( FormatPtr, iStdGlobVar.Measurement );
+
+      Separator = ' ';
+      for(j=0;j<OutputPtr->NumDataSearch;j++)
+      {
+         if( iStdRowValue( OutputPtr, &Row, j, &Value ) )
+         {
+            I_STD_FORMAT_CHAR( FormatPtr, Separator );
+            mStdWriteInfluxKey( FormatPtr, (StdDataPtr+j)->SourceName );
+            I_STD_FORMAT_CHAR( FormatPtr, '.' );
+            mStdWriteInfluxKey( FormatPtr, (StdDataPtr+j)->DatumName );
+            if ( iStdGlobVar.Window > 0 )
+            {
+               I_STD_FORMAT_CHAR( FormatPtr, '.' );
+               mStdWriteInfluxKey( FormatPtr, iStdAggName( (StdDataPtr+j)->Agg ) );
+            }
+            I_STD_FORMAT_CHAR( FormatPtr, '=' );
+            iStdFormatInt( FormatPtr, Value, 1 );
+            Separator = ',';
+         }
+      }
+
+      /* Nanoseconds since 1970, without overflowing 32 bits */
+      I_STD_FORMAT_CHAR( FormatPtr, ' ' );
+      if ( Row.TimeStamp.t_sec > 0 )
+      {
+         iStdFormatInt( FormatPtr, Row.TimeStamp.t_sec, 1 );
+         iStdFormatInt( FormatPtr, Row.TimeStamp.t_nsec, 9 );
+      }
+      else
+      {
+         iStdFormatInt( FormatPtr, Row.TimeStamp.t_nsec, 1 );
+      }
+      I_STD_FORMAT_CHAR( FormatPtr, '\n' );
+   }
+
+   iStdRowEnd( &Row );
+
+   return SYS_NOMINAL;
+}
+/*****************************************************************************
+** Function Name:
+**    mStdWriteInfluxKey
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Write a measurement or field name as line protocol.
+**
+** Description:
+**    Spaces, commas and equals signs are escaped with a backslash.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdFormat_t *FormatPtr      (in/out)
+**       Buffered output to file.
+**    char *KeyPtr                 (in)
+**       Name to be written.
+**
+*****************************************************************************/
+static void mStdWriteInfluxKey ( iStdFormat_t *FormatPtr, char *KeyPtr )
+{
+   for ( ; *KeyPtr != '\0'; KeyPtr++ )
+   {
+      if ( ( *KeyPtr == ' ' ) || ( *KeyPtr == ',' ) || ( *KeyPtr == '=' ) )
+      {
+         I_STD_FORMAT_CHAR( FormatPtr, '\\' );
+      }
+      I_STD_FORMAT_CHAR( FormatPtr, *KeyPtr );
+   }
+}
+/*****************************************************************************
+** Function Name:
+**    mStdWriteLong
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write Sdb data satisfying the search criteria a sample per line.
+**
+** Description:
+**    Each line holds the time stamp, as the date, time and seconds
+**    columns of the default format, followed by the source, the datum, or
+**    "DATUM.SUMMARY" when strides are summarised, and the value, all tab
+**    separated. The samples of all the columns are written in time order,
+**    those sharing a time stamp in column order, so the size of the file
+**    follows the number of samples rather than of time stamps and columns.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr      (in)
+**       Output whose matched data is written to its output file.
+**    iStdFormat_t *FormatPtr      (in/out)
+**       Buffered output to file.
+**
+*****************************************************************************/
+static Status_t mStdWriteLong ( iStdOutput_t *OutputPtr, iStdFormat_t *FormatPtr )
+{
+   Status_t           Status;
+   iStdCursor_t       Cursor;       /* Cursor stepping through samples */
+   iStdSample_t      *SamplePtr;    /* Sample being written */
+   iStdData_t        *StdDataPtr;   /* Column of the sample */
+   Int32_t            Column;       /* Index of the column */
+
+   Status = iStdCursorStart( OutputPtr, &Cursor );
+   if( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   while ( iStdCursorNext( OutputPtr, &Cursor, &Column, &SamplePtr ) )
+   {
+      StdDataPtr = OutputPtr->StdData + Column;
+
+      iStdFormatTime( FormatPtr, &SamplePtr->TimeStamp, TRUE );
+      I_STD_FORMAT_CHAR( FormatPtr, '\t' );
+      iStdFormatText( FormatPtr, StdDataPtr->SourceName );
+      I_STD_FORMAT_CHAR( FormatPtr, '\t' );
+      iStdFormatText( FormatPtr, StdDataPtr->DatumName );
+      if ( iStdGlobVar.Window > 0 )
+      {
+         I_STD_FORMAT_CHAR( FormatPtr, '.' );
+         iStdFormatText( FormatPtr, iStdAggName( StdDataPtr->Agg ) );
+      }
+      I_STD_FORMAT_CHAR( FormatPtr, '\t' );
+      iStdFormatInt( FormatPtr, SamplePtr->Value, 1 );
+      I_STD_FORMAT_CHAR( FormatPtr, '\n' );
+   }
+
+   iStdCursorEnd( &Cursor );
+
+   return SYS_NOMINAL;
+}
+/*****************************************************************************
+** Function Name:
+**    mStdWriteBinaryHeader
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write the header of a binary output.
+**
+** Description:
+**    The header is followed by a description of each column, giving its
+**    source and datum, their ids, the units and, when strides are
+**    summarised, the summary. See eStdBinary_t in Std.h.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_FILE_WRITE_ERR if there was
+**       a problem writing to disk.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr     (in)
+**       Output whose file the header is written to.
+**
+*****************************************************************************/
+static Status_t mStdWriteBinaryHeader ( iStdOutput_t *OutputPtr )
+{
+   unsigned char      Header[ E_STD_BIN_HEADER_SIZE ];
+   unsigned char      Entry[ E_STD_BIN_COLUMN_SIZE ];
+   eStdBinaryColumn_t Column;       /* Description of a column */
+   iStdData_t        *StdDataPtr;   /* Column described */
+   int                i;            /* counter to cycle through source datum pairs */
+
+   iStdBinaryHeader( Header, OutputPtr->NumDataSearch );
+   if ( fwrite( Header, sizeof( Header ), 1, OutputPtr->OutFilePtr ) != 1 )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   for ( i = 0; i < OutputPtr->NumDataSearch; i++ )
+   {
+      StdDataPtr = OutputPtr->StdData + i;
+
+      memset( &Column, 0, sizeof( Column ) );
+      Column.SourceId = StdDataPtr->SourceId;
+      Column.DatumId  = StdDataPtr->DatumId;
+      strcpy( Column.SourceName, StdDataPtr->SourceName );
+      strcpy( Column.DatumName,  StdDataPtr->DatumName );
+      strcpy( Column.DatumUnits, StdDataPtr->DatumUnits );
+      if ( iStdGlobVar.Window > 0 )
+      {
+         strcpy( Column.Summary, iStdAggName( StdDataPtr->Agg ) );
+      }
+
+      iStdBinaryColumn( Entry, &Column );
+      if ( fwrite( Entry, sizeof( Entry ), 1, OutputPtr->OutFilePtr ) != 1 )
+      {
+         return E_STD_FILE_WRITE_ERR;
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+/*****************************************************************************
+** Function Name:
+**    mStdWriteBinary
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write Sdb data satisfying the search criteria as binary records.
+**
+** Description:
+**    A fixed-size record is written per sample, in time order, those
+**    sharing a time stamp in column order, as by mStdWriteLong.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr      (in)
+**       Output whose matched data is written to its output file.
+**    iStdFormat_t *FormatPtr      (in/out)
+**       Buffered output to file.
+**
+*****************************************************************************/
+static Status_t mStdWriteBinary ( iStdOutput_t *OutputPtr, iStdFormat_t *FormatPtr )
+{
+   Status_t           Status;
+   iStdCursor_t       Cursor;       /* Cursor stepping through samples */
+   iStdSample_t      *SamplePtr;    /* Sample being written */
+   Int32_t            Column;       /* Index of its column */
+
+   Status = iStdCursorStart( OutputPtr, &Cursor );
+   if( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   while ( iStdCursorNext( OutputPtr, &Cursor, &Column, &SamplePtr ) )
+   {
+      I_STD_FORMAT_ROOM( FormatPtr, E_STD_BIN_RECORD_SIZE );
+      iStdBinaryRecord( (unsigned char *) FormatPtr->BufferPtr + FormatPtr->Length,
+                        &SamplePtr->TimeStamp, (Uint32_t) Column, SamplePtr->Value );
+      FormatPtr->Length += E_STD_BIN_RECORD_SIZE;
+   }
+
+   iStdCursorEnd( &Cursor );
+
+   return SYS_NOMINAL;
+}
@@ -122,6 +122,9 @@
 #ifndef STD_PRIVATE_H_DEFINED
 #define STD_PRIVATE_H_DEFINED
  
+#include <pthread.h>
+#include <unistd.h>
+
 #include "Std.h"
 #include "Wfl.h"
 
@@ -129,10 +132,10 @@
 
 #define I_STD_PROGRAM_NAME   "Std"
 #define I_STD_PROGRAM_ABOUT  "Sdb Test Dump utility"
-#define I_STD_RELEASE_DATE   "3 October 2006"
-#define I_STD_YEAR           "2003-06"
+#define I_STD_RELEASE_DATE   "17 October 2026"
+#define I_STD_YEAR           "2003-26"
 #define I_STD_MAJOR_VERSION  1
-#define I_STD_MINOR_VERSION  13
+#define I_STD_MINOR_VERSION  38
 
 /* Common arguments defaults */
 
@@ -162,7 +165,7 @@
 
 #define E_STD_CUSTOM_IDPATH  0
 
-#define I_STD_CUSTOM_ARGS    4
+#define I_STD_CUSTOM_ARGS    18
 
 /* Definitions */
 #define E_STD_IDTABLE_STR    "%s %s \"%[^\"]\"" /* Format of ID table entry */
@@ -174,29 +177,161 @@
 #define E_STD_MONTHS_IN_YEAR 12
 #define I_STD_EXT_SDB        "sdb"
 #define I_STD_EXT_GZIP       ".gz"
+#define I_STD_EXT_BGZF       ".bgz"  /* In place of .gz of a block-compressed file */
+#define I_STD_EXT_GZINDEX    "idx"   /* Appended to a gzipped file's name */
+#define I_STD_EXT_SDBINDEX   "idx"   /* Appended to an Sdb file's name, less .gz or .bgz */
+#define I_STD_EXT_CONFIG     "*.cfg"
+#define I_STD_EXT_COLUMNS    "col"   /* Day of a columnar archive, "yymmdd.col" */
+#define I_STD_EXT_ROLLUP     "rup"   /* Day of a rollup archive, "yymmdd.rup" */
+#define I_STD_EXT_BUNDLE     "sdbpack" /* Bundle of a day or month, "yymmdd.sdbpack" or "yymm.sdbpack" */
 
 #define I_STD_SWITCH_PATH    "path <path>"
 #define I_STD_SWITCH_STRIDE  "stride [secs]"
 #define I_STD_SWITCH_MLB     "matlab"
 #define I_STD_SWITCH_GPT     "gnuplot"
+#define I_STD_SWITCH_CONFIGS "configs <dir|pattern>"
+#define I_STD_SWITCH_INFLUX  "influx <measurement>"
+#define I_STD_SWITCH_THREADS "threads <n>"
+#define I_STD_SWITCH_CHUNK   "chunk <records>"
+#define I_STD_SWITCH_CATALOG "catalog <file>"
+#define I_STD_SWITCH_COLUMNS "columns <dir>"
+#define I_STD_SWITCH_FILES   "files <files|patterns>"
+#define I_STD_SWITCH_FOLLOW  "follow [secs]"
+#define I_STD_SWITCH_SERVE   "serve <socket>"
+#define I_STD_SWITCH_WORKERS "workers <n>"
+#define I_STD_SWITCH_AGG     "aggregate <modes>"
+#define I_STD_SWITCH_LONG    "long"
+#define I_STD_SWITCH_BINARY  "binary"
+#define I_STD_SWITCH_ROLLUP  "rollup <dir>"
 
 #define I_STD_EXPL_PATH      "Data directory"
 #define I_STD_EXPL_STRIDE    "Gap between extracted measurements"
 #define I_STD_EXPL_MLB       "Write file suitable for matlab"
 #define I_STD_EXPL_GPT       "Write file suitable for gnuplot"
+#define I_STD_EXPL_CONFIGS   "Extract several configuration files at once"
+#define I_STD_EXPL_INFLUX    "Write InfluxDB line protocol"
+#define I_STD_EXPL_THREADS   "Number of hours read at once (default one per CPU)"
+#define I_STD_EXPL_CHUNK     "Records decompressed from gzipped files at once"
+#define I_STD_EXPL_CATALOG   "Archive catalog used to pass over hours"
+#define I_STD_EXPL_COLUMNS   "Columnar archive read in place of Sdb files"
+#define I_STD_EXPL_FILES     "Sdb files read where they are, in place of path"
+#define I_STD_EXPL_FOLLOW    "Keep following the Sdb file being written"
+#define I_STD_EXPL_SERVE     "Serve extraction requests on a UNIX socket"
+#define I_STD_EXPL_WORKERS   "Requests served at once (default 4)"
+#define I_STD_EXPL_AGG       "Summarise each stride, e.g. min,max,mean,count"
+#define I_STD_EXPL_LONG      "One line per sample: source, datum and value"
+#define I_STD_EXPL_BINARY    "Fixed-size binary records, see sdbdump"
+#define I_STD_EXPL_ROLLUP    "Roll up whole days searched into this archive"
 #define I_STD_MAX_PATH_LEN   100
+#define I_STD_DFLT_COLUMNS   16   /* Columns allowed for initially per output */
+#define I_STD_NUM_SOURCES    ( 1 << ( 32 - E_SDB_CODE_MASKSIZE ) )
 #define I_STD_DFLT_STRIDE    0
+#define I_STD_DFLT_FOLLOW    10   /* Most seconds between checks when following */
+#define I_STD_DFLT_WORKERS   4    /* Worker processes serving requests */
+#define I_STD_MAX_WORKERS    64   /* Most worker processes */
+#define I_STD_SERVE_BACKLOG  16   /* Requests waiting for a worker */
+#define I_STD_SERVE_END      "END" /* Line ending a request */
 #define I_STD_DFLT_MLB       FALSE
+#define I_STD_DFLT_INFLUX    FALSE
+#define I_STD_DFLT_LONG      FALSE
+#define I_STD_DFLT_BINARY    FALSE
+#define I_STD_DFLT_MEASURE   "sdbfull"
+#define I_STD_MAX_MEASURE    64
+#define I_STD_MAX_THREADS    64   /* Most worker threads used */
+#define I_STD_HOURS_AHEAD    2    /* Hours per thread read ahead of output */
+#define I_STD_DFLT_CHUNK     131072 /* Records read at once, 1.5 MB */
 #define I_STD_DFLT_GPT       FALSE
+#define I_STD_FORMAT_BUFSIZE ( 256 * 1024 ) /* Output buffered before writing */
+#define I_STD_GZ_MAGIC       "SDBZ" /* Start of a gzip access point index */
+#define I_STD_GZ_VERSION     1      /* Format of the index */
+#define I_STD_GZ_WINSIZE     32768  /* History needed to resume inflating */
+#define I_STD_GZ_DFLT_SPAN   ( 1024 * 1024 ) /* Uncompressed bytes per span */
+#define I_STD_GZ_MIN_SPAN    1024   /* Smallest span allowed */
+#define I_STD_IDX_MAGIC      "SDBX" /* Start of a series index */
+#define I_STD_IDX_VERSION    1      /* Format of the index */
+#define I_STD_IDX_DFLT_BLOCK 4096   /* Records per block of the index */
+#define I_STD_RECORDS_START  ( E_STD_FILE_HDR_SIZE + sizeof( Uint32_t ) ) /* Offset of first record */
+#define I_STD_CAT_MAGIC      "SDBC" /* Start of an archive catalog */
+#define I_STD_CAT_VERSION    1      /* Format of the catalog */
+#define I_STD_CAT_SPAN       65536  /* Hours covered by each set of a code */
+#define I_STD_CAT_MAX_LIST   4096   /* Most hours of a set held as a list */
+#define I_STD_CAT_SETTLE     60     /* Seconds after an hour its file may change */
+#define I_STD_COL_MAGIC      "SDBS" /* Start of a day of a columnar archive */
+#define I_STD_COL_VERSION    1      /* Format of the day */
+#define I_STD_COL_MAX_HOURS  25     /* Hours of a day, when the clocks go back */
+#define I_STD_COL_DELTA      0      /* Values held as differences */
+#define I_STD_COL_XOR        1      /* Values held as exclusive or */
+#define I_STD_BIN_MAGIC      "SDBB" /* Start of a binary output */
+#define I_STD_BIN_VERSION    1      /* Format of the output */
+#define I_STD_RUP_MAGIC      "SDBU" /* Start of a day of a rollup archive */
+#define I_STD_RUP_VERSION    1      /* Format of the day */
+#define I_STD_BGZF_RECORDS   5440   /* Records per block of a block-compressed file */
+#define I_STD_BGZF_MAX_BLOCK 65536  /* Largest block, compressed or not */
+#define I_STD_BUNDLE_MAGIC   "SDBP" /* Start of a bundle of Sdb files */
+#define I_STD_BUNDLE_VERSION 1      /* Format of the bundle */
+#define I_STD_BUNDLE_ALIGN   65536  /* Hours start at multiples of this, to be mapped */
+#define I_STD_BUNDLE_HOURS   24     /* Hours of a day's bundle */
+#define I_STD_BUNDLE_MAX_HOURS ( E_STD_DAYS_IN_MONTH * I_STD_BUNDLE_HOURS ) /* Of a month's */
+#define I_STD_BUNDLE_PLAIN   1      /* Hour held as a plain Sdb file */
+#define I_STD_BUNDLE_BGZF    2      /* Hour held as a block-compressed Sdb file */
 
 enum iStdCustomArg_e
 {
    I_STD_ARG_PATH,
    I_STD_ARG_STRIDE,
    I_STD_ARG_MLB,
-   I_STD_ARG_GPT
+   I_STD_ARG_GPT,
+   I_STD_ARG_CONFIGS,
+   I_STD_ARG_INFLUX,
+   I_STD_ARG_THREADS,
+   I_STD_ARG_CHUNK,
+   I_STD_ARG_CATALOG,
+   I_STD_ARG_COLUMNS,
+   I_STD_ARG_FILES,
+   I_STD_ARG_FOLLOW,
+   I_STD_ARG_SERVE,
+   I_STD_ARG_WORKERS,
+   I_STD_ARG_AGG,
+   I_STD_ARG_LONG,
+   I_STD_ARG_BINARY,
+   I_STD_ARG_ROLLUP
 };
 
+/* How the samples of a stride are summarised, see iStdAggregate */
+enum iStdAgg_e
+{
+   I_STD_AGG_MIN,
+   I_STD_AGG_MAX,
+   I_STD_AGG_MEAN,        /* Rounded to the nearest integer */
+   I_STD_AGG_FIRST,
+   I_STD_AGG_LAST,
+   I_STD_AGG_COUNT,
+   I_STD_AGG_FIRSTTIME,   /* Seconds since 1970 of the first sample */
+   I_STD_AGG_LASTTIME,    /* Seconds since 1970 of the last sample */
+   I_STD_NUM_AGGS
+};
+
+/* A single value matching the search, and when it was submitted */
+typedef struct iStdSample_s
+{
+   eTtlTime_t   TimeStamp;
+   Int32_t      Value;
+} iStdSample_t;
+
+/* Running summary of the samples of a stride, see iStdSummariseData */
+typedef struct iStdSummary_s
+{
+   Int32_t      Start;         /* Start of the stride */
+   Int32_t      Min;
+   Int32_t      Max;
+   double       Sum;           /* Exact for any number of samples likely */
+   Int32_t      Count;
+   Int32_t      First;         /* Value of the earliest sample */
+   Int32_t      Last;          /* Value of the latest sample */
+   eTtlTime_t   FirstTime;     /* Time of the earliest sample */
+   eTtlTime_t   LastTime;      /* Time of the latest sample */
+} iStdSummary_t;
+
 /* Structude definition */
 typedef struct iStdData_s
 {
@@ -209,26 +344,382 @@ typedef struct iStdData_s
    Uint32_t     NumOfPoints;
    Int32_t      Value;
    eTtlTime_t   NextStrideTime;
+   iStdSample_t *Samples;    /* Matched data, in time order */
+   Int32_t      NumSamples;  /* Number of samples stored */
+   Int32_t      MaxSamples;  /* Number of samples there is room for */
+   Int32_t      SizeClass;   /* MaxSamples is 2^SizeClass */
+   Bool_t       Unsorted;    /* Samples not stored in time order */
+   Int32_t      Agg;         /* Summary of each stride, when aggregating */
+   iStdSummary_t *Summaries; /* Strides summarised, in order, see iStdSummariseData */
+   Int32_t      NumSummaries; /* Number of strides summarised */
+   Int32_t      MaxSummaries; /* Number there is room for */
 } iStdData_t;
 
+/* Cursor for stepping through the rows of an output in time order */
+typedef struct iStdRow_s
+{
+   eTtlTime_t   TimeStamp;   /* Time stamp of the current row */
+   eTtlTime_t   NextTime;    /* Used while finding the next row */
+   Int32_t     *Index;       /* Per column, next sample not yet passed over */
+   Bool_t       Started;     /* Set once the first row has been found */
+} iStdRow_t;
+
+/* Cursor for stepping through the samples of an output in time order */
+typedef struct iStdCursor_s
+{
+   Int32_t     *Index;       /* Per column, next sample not yet output */
+   Int32_t     *Heap;        /* Columns with samples left, earliest first */
+   Int32_t      NumHeap;     /* Number of columns in the heap */
+} iStdCursor_t;
+
+/* Output buffer, and text of the last time stamp second formatted */
+typedef struct iStdFormat_s
+{
+   FILE        *OutFilePtr;        /* File the buffer is written to */
+   char        *BufferPtr;         /* Text not yet written */
+   size_t       Length;            /* Number of characters in buffer */
+   Bool_t       Error;             /* Set if a write has failed */
+   Int32_t      CachedSec;         /* Second of the cached text */
+   size_t       CachedLength;      /* Length of the cached text */
+   char         CachedText[ 32 ];  /* "dd/mm/yy<tab>HH:MM:SS." */
+} iStdFormat_t;
+
+/* Make room for at least Size more characters in the output buffer */
+#define I_STD_FORMAT_ROOM( FormatPtr, Size ) \
+   do \
+   { \
+      if ( (FormatPtr)->Length + (Size) > I_STD_FORMAT_BUFSIZE ) \
+      { \
+         iStdFormatFlush( FormatPtr ); \
+      } \
+   } while ( 0 )
+
+/* Add a single character to the output buffer */
+#define I_STD_FORMAT_CHAR( FormatPtr, Char ) \
+   do \
+   { \
+      I_STD_FORMAT_ROOM( FormatPtr, 1 ); \
+      (FormatPtr)->BufferPtr[ (FormatPtr)->Length++ ] = (Char); \
+   } while ( 0 )
+
+/* Header of an index of access points into a gzipped Sdb file */
+typedef struct iStdGzHeader_s
+{
+   char         Magic[ 4 ];    /* I_STD_GZ_MAGIC */
+   Uint32_t     Version;       /* I_STD_GZ_VERSION */
+   Uint32_t     GzSize;        /* Size of the gzipped file indexed */
+   Uint32_t     OutSize;       /* Size of the file once inflated */
+   Uint32_t     SpanSize;      /* Least inflated bytes between points */
+   Uint32_t     NumPoints;     /* Number of access points following */
+} iStdGzHeader_t;
+
+/*
+** An access point, at the start of a deflate block, from which the file can
+** be inflated given the window of data inflated before it. The span of a
+** point runs to the next point and holds the records starting within it.
+*/
+typedef struct iStdGzPoint_s
+{
+   Uint32_t     InOffset;      /* Byte of gzipped file holding first bit */
+   Uint32_t     InBits;        /* Bits of that byte used by the last block */
+   Uint32_t     OutOffset;     /* Offset in the inflated file */
+   Uint32_t     NumRecords;    /* Records starting in the span */
+   Uint32_t     MinTime;       /* Least TimeOffset of those records */
+   Uint32_t     MaxTime;       /* Greatest TimeOffset of those records */
+   Uint32_t     WindowSize;    /* Bytes of window, at most I_STD_GZ_WINSIZE */
+   Uint32_t     WindowOffset;  /* Position of the window in the index */
+} iStdGzPoint_t;
+
+/* An index loaded for use, with the windows left in the index file */
+typedef struct iStdGzIndex_s
+{
+   iStdGzHeader_t Header;
+   iStdGzPoint_t *Points;      /* Header.NumPoints access points */
+   FILE          *IndexFile;   /* Index, for reading windows */
+   char           GzFile[ FILENAME_MAX ]; /* Gzipped file indexed */
+} iStdGzIndex_t;
+
+/* Inflation of a gzipped Sdb file from an access point */
+typedef struct iStdGzStream_s iStdGzStream_t;
+
+/* A block-compressed Sdb file opened for random access */
+typedef struct iStdBgzf_s iStdBgzf_t;
+
+/* Header of the series index of an Sdb file, plain or gzipped */
+typedef struct iStdSdbIdxHeader_s
+{
+   char         Magic[ 4 ];    /* I_STD_IDX_MAGIC */
+   Uint32_t     Version;       /* I_STD_IDX_VERSION */
+   Uint32_t     FileSize;      /* Size of the Sdb file indexed */
+   Uint32_t     NumRecords;    /* Records in the file */
+   Uint32_t     BlockSize;     /* Records per block */
+   Uint32_t     NumBlocks;     /* Blocks in the file */
+   Uint32_t     NumCodes;      /* Storage codes present, following */
+} iStdSdbIdxHeader_t;
+
+/*
+** A storage code present in an indexed Sdb file. The codes are in order,
+** and are followed by a bitmap for each, in the same order, of the blocks
+** holding its records.
+*/
+typedef struct iStdSdbIdxCode_s
+{
+   eSdbCode_t   Code;          /* Storage code */
+   Uint32_t     NumRecords;    /* Records of the code in the file */
+   Uint32_t     MinTime;       /* Least TimeOffset of those records */
+   Uint32_t     MaxTime;       /* Greatest TimeOffset of those records */
+} iStdSdbIdxCode_t;
+
+/* Blocks of an Sdb file holding the records wanted from it */
+typedef struct iStdSdbBlocks_s
+{
+   Uint32_t     BlockSize;     /* Records per block */
+   Uint32_t     NumBlocks;     /* Blocks in the file */
+   Uint32_t     NumNeeded;     /* Blocks holding records wanted */
+   Uint32_t    *Bitmap;        /* Bit set per block needed, NULL for all */
+} iStdSdbBlocks_t;
+
+/* Whether a block is needed, given a bitmap */
+#define I_STD_BLOCK_NEEDED( BlocksPtr, Block ) \
+   ( ( (BlocksPtr)->Bitmap[ (Block) >> 5 ] & ( 1U << ( (Block) & 31 ) ) ) != 0 )
+
+/* Header of an archive catalog, followed by its names, hours and codes */
+typedef struct iStdCatHeader_s
+{
+   char         Magic[ 4 ];    /* I_STD_CAT_MAGIC */
+   Uint32_t     Version;       /* I_STD_CAT_VERSION */
+   Int32_t      Updated;       /* When the archive was last searched for files */
+   Uint32_t     NumHours;      /* Hours with an Sdb file */
+   Uint32_t     NumCodes;      /* Storage codes found */
+   Uint32_t     NamesSize;     /* Bytes of file names, the archive's first */
+} iStdCatHeader_t;
+
+/* An hour of an archive catalog */
+typedef struct iStdCatHour_s
+{
+   Int32_t      Hour;          /* Hours since the epoch */
+   Uint32_t     FileSize;      /* Size of the Sdb file when catalogued */
+   Int32_t      FileTime;      /* Modification time of the file then */
+   Uint32_t     DataSize;      /* Bytes of records catalogued */
+   Uint32_t     NumRecords;    /* Records catalogued */
+   Uint32_t     NumCodes;      /* Storage codes found */
+   Uint32_t     Name;          /* Offset of its file name in the archive */
+   Uint32_t     Partial;       /* Set if records may not have been catalogued */
+} iStdCatHour_t;
+
+/* A storage code of an archive catalog, followed by its sets of hours */
+typedef struct iStdCatCode_s
+{
+   eSdbCode_t   Code;          /* Storage code */
+   Int32_t      FirstHour;     /* First hour holding it */
+   Int32_t      LastHour;      /* Last hour holding it */
+   Uint32_t     NumHours;      /* Hours holding it */
+   double       NumRecords;    /* Records of it */
+   Uint32_t     NumSets;       /* Sets of hours which follow */
+   Uint32_t     Spare;         /* Keeps the size the same on every host */
+} iStdCatCode_t;
+
+/*
+** The hours holding a code within one span of I_STD_CAT_SPAN hours, as a
+** sorted list of hours within the span or, when there are too many for
+** that to be smaller, a bitmap of the whole span.
+*/
+typedef struct iStdCatSet_s
+{
+   Uint16_t     Key;           /* Hour / I_STD_CAT_SPAN */
+   Uint16_t     IsBitmap;      /* Held as a bitmap rather than a list */
+   Uint32_t     NumHours;      /* Hours in the set */
+   Uint16_t    *List;          /* Hour % I_STD_CAT_SPAN of each, in order */
+   Uint32_t    *Bitmap;        /* Bit set per hour of the span */
+   Uint32_t     MaxList;       /* Hours there is room for in the list */
+} iStdCatSet_t;
+
+/*
+** Header of a day of a columnar archive, followed by its hours, its codes,
+** the chunks of each code in turn and lastly the data of the chunks.
+*/
+typedef struct iStdColHeader_s
+{
+   char         Magic[ 4 ];    /* I_STD_COL_MAGIC */
+   Uint32_t     Version;       /* I_STD_COL_VERSION */
+   Int32_t      Start;         /* Start of the day */
+   Uint32_t     NumHours;      /* Hours of the day */
+   Uint32_t     NumCodes;      /* Storage codes found */
+   Uint32_t     NumChunks;     /* Chunks of all the codes */
+   Uint32_t     DataSize;      /* Bytes of data of the chunks */
+   Uint32_t     NumRecords;    /* Records of the day */
+} iStdColHeader_t;
+
+/* An hour of a day of a columnar archive */
+typedef struct iStdColHour_s
+{
+   Int32_t      Hour;          /* Start of the hour */
+   Int32_t      TimeHour;      /* Time stamp of its Sdb file */
+   Uint32_t     NumRecords;    /* Records of the hour */
+   Uint32_t     Present;       /* Set if its Sdb file held records */
+} iStdColHour_t;
+
+/* A storage code of a day, whose chunks follow one another in hour order */
+typedef struct iStdColCode_s
+{
+   eSdbCode_t   Code;          /* Storage code */
+   Uint32_t     NumRecords;    /* Records of it in the day */
+   Uint32_t     FirstChunk;    /* First of its chunks */
+   Uint32_t     NumChunks;     /* Hours holding it */
+} iStdColCode_t;
+
+/*
+** Header of a day of a rollup archive, followed by its codes and then the
+** points of each level in turn.
+*/
+typedef struct iStdRupHeader_s
+{
+   char         Magic[ 4 ];    /* I_STD_RUP_MAGIC */
+   Uint32_t     Version;       /* I_STD_RUP_VERSION */
+   Int32_t      Start;         /* Start of the day */
+   Uint32_t     NumCodes;      /* Storage codes found */
+   Uint32_t     NumRecords;    /* Records of the day */
+   Uint32_t     Resolution[ E_STD_ROLLUP_LEVELS ]; /* Seconds of each interval */
+   Uint32_t     NumPoints[ E_STD_ROLLUP_LEVELS ];  /* Points of each level */
+} iStdRupHeader_t;
+
+/* A storage code of a day of a rollup archive */
+typedef struct iStdRupCode_s
+{
+   eSdbCode_t   Code;          /* Storage code */
+   Uint32_t     NumRecords;    /* Records of it in the day */
+   Uint32_t     FirstPoint[ E_STD_ROLLUP_LEVELS ]; /* First of its points at each level */
+   Uint32_t     NumPoints[ E_STD_ROLLUP_LEVELS ];  /* Its points at each level */
+} iStdRupCode_t;
+
+/* The records of a storage code in one hour of a day */
+typedef struct iStdColChunk_s
+{
+   Uint32_t     Hour;          /* Hour of the day */
+   Uint32_t     NumRecords;    /* Records of the chunk */
+   Uint32_t     Offset;        /* Offset of its data in the data of the chunks */
+   Uint32_t     Size;          /* Bytes of its data */
+   Uint32_t     Encoding;      /* I_STD_COL_DELTA or I_STD_COL_XOR */
+} iStdColChunk_t;
+
+/*
+** Header of a bundle of the Sdb files of a day or month, followed by an
+** iStdBundleSlot_t for each hour, in order, and then the hours' files.
+*/
+typedef struct iStdBundleHeader_s
+{
+   char         Magic[ 4 ];    /* I_STD_BUNDLE_MAGIC */
+   Uint32_t     Version;       /* I_STD_BUNDLE_VERSION */
+   Uint32_t     Year;          /* Of the hours, without century */
+   Uint32_t     Month;
+   Uint32_t     Date;          /* 0 for a month's bundle */
+   Uint32_t     NumHours;      /* I_STD_BUNDLE_HOURS or I_STD_BUNDLE_MAX_HOURS */
+} iStdBundleHeader_t;
+
+/* Where the Sdb file of an hour lies in a bundle */
+typedef struct iStdBundleSlot_s
+{
+   Uint32_t     Offset;        /* Offset of the file, 0 if the hour has none */
+   Uint32_t     Size;          /* Bytes of the file */
+   Uint32_t     Kind;          /* I_STD_BUNDLE_PLAIN or I_STD_BUNDLE_BGZF */
+   Uint32_t     Spare;
+} iStdBundleSlot_t;
+
+/* A bundle opened for reading, shared by the readers using it */
+typedef struct iStdBundle_s iStdBundle_t;
+
+/* Records of an hour read from a columnar archive by one reader */
+typedef struct iStdColRead_s
+{
+   FILE          *DayFile;     /* File of the day last read, or NULL */
+   Int32_t        Day;         /* That day, as yymmdd */
+   unsigned char *ChunkPtr;    /* Chunk being decoded */
+   size_t         ChunkMax;    /* Bytes there is room for */
+   eSdbRawFmt_t  *Records;     /* Records of the hour */
+   size_t         NumRecords;  /* Number of records */
+   size_t         MaxRecords;  /* Records there is room for */
+   size_t         NextRecord;  /* Next record to be returned */
+   Int32_t        TimeHour;    /* Time stamp of the hour's Sdb file */
+} iStdColRead_t;
+
+/*
+** Everything extracted on behalf of a single configuration file. Several of
+** these may be filled from one pass over the Sdb files.
+*/
+typedef struct iStdOutput_s
+{
+   char         ConfigFile[ FILENAME_MAX ];      /* Configuration file read */
+   char         OutFile[ E_STD_MAX_STRING_LEN ]; /* File to write results to */
+   FILE        *OutFilePtr;                      /* Handle of output file */
+   eStdTime_t   StartTime;                       /* Start of search */
+   eStdTime_t   StopTime;                        /* End of search */
+   eTtlTime_t   TtlStartTime;                    /* Start of search (Ttl format) */
+   eTtlTime_t   TtlStopTime;                     /* End of search (Ttl format) */
+   Bool_t       StartGiven;                      /* The configuration gave the start */
+   Bool_t       StopGiven;                       /* The configuration gave the end */
+   Int32_t      NumDataSearch;                   /* Number of datum id's to search for */
+   Int32_t      MaxDataSearch;                   /* Number there is room for */
+   iStdData_t  *StdData;                         /* Datum id's to search for */
+   Int32_t      LinesOfData;                     /* Number of lines of data */
+} iStdOutput_t;
+
+/* One column, of one output, that a storage code is routed to */
+typedef struct iStdTarget_s
+{
+   Int32_t      Output;   /* Index into iStdGlobVar.Outputs */
+   Int32_t      Column;   /* Index into the output's StdData */
+   Int32_t      Next;     /* Next target for the same code, negative at end */
+} iStdTarget_t;
+
+/* Lookup from Sdb storage code to the columns it is routed to */
+typedef struct iStdLookup_s
+{
+   Uint32_t      SourceMap[ I_STD_NUM_SOURCES / 32 ]; /* Sources requested */
+   Uint32_t      Size;       /* Number of slots, a power of two */
+   Uint32_t      Shift;      /* Bits discarded from hash to index a slot */
+   eSdbCode_t   *Codes;      /* Storage code held in each slot */
+   Int32_t      *First;      /* First target of each slot, negative if empty */
+   Int32_t      *Last;       /* Last target of each slot */
+   Int32_t       NumTargets; /* Number of targets in use */
+   iStdTarget_t *Targets;    /* Targets, chained per storage code */
+   Uint32_t      NumCodes;   /* Number of distinct codes */
+   eSdbCode_t   *Wanted;     /* The distinct codes, in the order added */
+} iStdLookup_t;
+
 typedef struct iStdGlobVar_s
 {
-   Int32_t  NumDataSearch;    /* Number of datum id's to search for */
    char IdPath[ E_STD_STRING_LEN ]; /* Path for ID lookup tables */
    char InDir  [ E_STD_MAX_STRING_LEN ];
-   char OutFile[ E_STD_MAX_STRING_LEN ];
    char         TimeStr[E_TIM_BUFFER_LENGTH];
    char         LastTimeStr[E_TIM_BUFFER_LENGTH];
-   iStdData_t  StdData[E_STD_MAX_SEARCH_DATA];
+   Int32_t      NumOutputs;  /* Number of configuration files being extracted */
+   iStdOutput_t *Outputs;    /* One entry per configuration file */
+   iStdLookup_t Lookup;      /* Routes storage codes to outputs */
    Bool_t GotConfig;
    Bool_t DisplayNames; /* Use look-up table to display identifier names */
    Bool_t LoadFile;     /* Flag to show if a file has been supplied */
-   eStdTime_t StartTime;
-   eStdTime_t StopTime;
+   eStdTime_t StartTime; /* Default start time if not configured */
+   eStdTime_t StopTime;  /* Default stop time if not configured */
    char DatPath[ I_STD_MAX_PATH_LEN ];
    Int32_t    Stride;
    Bool_t WriteMatlab;
    Bool_t WriteGnuplot;
+   Bool_t WriteInflux;  /* Write InfluxDB line protocol */
+   char   Measurement[ I_STD_MAX_MEASURE ]; /* InfluxDB measurement/database */
+   Bool_t WriteLong;    /* Write a line per sample rather than per time stamp */
+   Bool_t WriteBinary;  /* Write binary records, see eStdBinaryOpen */
+   Int32_t NumThreads;  /* Number of hours read at once */
+   size_t  ChunkSize;   /* Records read from a file at once */
+   eStdCatalog_t *CatalogPtr; /* Archive catalog, NULL if not used */
+   eStdColumns_t *ColumnsPtr; /* Columnar archive, NULL if not used */
+   eStdFiles_t   *FilesPtr;   /* Sdb files named to be read, NULL if none */
+   Int32_t        FollowSecs; /* Seconds between checks when following, 0 if not */
+   char    RollupDir[ I_STD_MAX_PATH_LEN ]; /* Rollup archive fed while searching, or "" */
+   char    ServePath[ I_STD_MAX_PATH_LEN ]; /* Socket requests are served on, or "" */
+   Int32_t NumWorkers;  /* Worker processes serving requests */
+   Int32_t Window;      /* Seconds of each stride summarised, 0 if not aggregating */
+   Int32_t NumAggs;     /* Summaries of each stride, one column each */
+   Int32_t Aggs[ I_STD_NUM_AGGS ];
 } iStdGlobVar_t;
 
 
@@ -239,19 +730,6 @@ typedef struct iStdGlobVar_s
 #define E_STD_EXTERN extern
 #endif
 
-/* Structure to store a time point with matching data. */
-struct iStdMatchedData_s
-{
-  eTtlTime_t                 TimeStamp;
-  Int32_t                    Value[E_STD_MAX_SEARCH_DATA];
-  Bool_t                     SetFlag[E_STD_MAX_SEARCH_DATA];
-  struct iStdMatchedData_s  *PreviousPtr;
-  struct iStdMatchedData_s  *NextPtr;
-}; 
-typedef struct iStdMatchedData_s   iStdMatchedData_t;
-E_STD_EXTERN   iStdMatchedData_t  *iStdLastMatchedPtr;
-E_STD_EXTERN   Int32_t             iStdLinesOfData;   /* Number of lines of data */
-
 
 
 /* for parsing custom command-line arguments */
@@ -264,6 +742,20 @@ eCluArgSpec_t eCluCustomArg[ I_STD_CUSTOM_ARGS + 1 ] =
   { I_STD_SWITCH_STRIDE,1, I_STD_EXPL_STRIDE,                 FALSE, NULL },
   { I_STD_SWITCH_MLB,  1, I_STD_EXPL_MLB,                     FALSE, NULL },
   { I_STD_SWITCH_GPT,  1, I_STD_EXPL_GPT,                     FALSE, NULL },
+  { I_STD_SWITCH_CONFIGS,7, I_STD_EXPL_CONFIGS,               FALSE, NULL },
+  { I_STD_SWITCH_INFLUX, 1, I_STD_EXPL_INFLUX,                FALSE, NULL },
+  { I_STD_SWITCH_THREADS,1, I_STD_EXPL_THREADS,               FALSE, NULL },
+  { I_STD_SWITCH_CHUNK,  2, I_STD_EXPL_CHUNK,                 FALSE, NULL },
+  { I_STD_SWITCH_CATALOG,3, I_STD_EXPL_CATALOG,               FALSE, NULL },
+  { I_STD_SWITCH_COLUMNS,3, I_STD_EXPL_COLUMNS,               FALSE, NULL },
+  { I_STD_SWITCH_FILES,  2, I_STD_EXPL_FILES,                 FALSE, NULL },
+  { I_STD_SWITCH_FOLLOW, 2, I_STD_EXPL_FOLLOW,                FALSE, NULL },
+  { I_STD_SWITCH_SERVE,  2, I_STD_EXPL_SERVE,                 FALSE, NULL },
+  { I_STD_SWITCH_WORKERS,1, I_STD_EXPL_WORKERS,               FALSE, NULL },
+  { I_STD_SWITCH_AGG,    1, I_STD_EXPL_AGG,                   FALSE, NULL },
+  { I_STD_SWITCH_LONG,   3, I_STD_EXPL_LONG,                  FALSE, NULL },
+  { I_STD_SWITCH_BINARY, 1, I_STD_EXPL_BINARY,                FALSE, NULL },
+  { I_STD_SWITCH_ROLLUP, 2, I_STD_EXPL_ROLLUP,                FALSE, NULL },
   { E_CLU_EOL,         0, E_CLU_EOL,                          FALSE, NULL }
 };
 #else
@@ -275,25 +767,82 @@ E_STD_EXTERN iStdGlobVar_t iStdGlobVar;
 
 /* Local function prototypes */
 Status_t iStdCluInit ( int argc, char *argv[]);
-Status_t iStdReadConfig ( char *ConfigFilePtr );
+Status_t iStdReadConfigs ( void );
+Status_t iStdReadSingleConfig ( char *ConfigFilePtr );
+Status_t iStdReadConfig ( char *ConfigFilePtr, iStdOutput_t *OutputPtr );
+void     iStdFreeOutputs ( void );
+Status_t iStdExpandAggs ( iStdOutput_t *OutputPtr );
 Status_t iStdReadSdbChunk ( FILE *, eSdbRawFmt_t *, size_t, size_t *);
 Status_t iStdSearchChunk ( eSdbRawFmt_t, eSdbSngReq_t, eTtlTime_t, Bool_t *, Bool_t * );
-Status_t iStdWriteHeader ( FILE *OutFilePtr );
+Status_t iStdWriteHeader ( iStdOutput_t *OutputPtr );
 Status_t iStdReadSdbHeader ( FILE *InFilePtr, size_t *NumBytes );
 Status_t iStdReadSdbTimeStamp ( FILE *InFilePtr, eTtlTime_t *TimeHour);
-Status_t iStdWriteToScreen ( void );
-Status_t iStdWriteToFile ( FILE *OutFilePtr );
-Status_t iStdSrcDtmName ( void );
+Status_t iStdWriteToScreen ( iStdOutput_t *OutputPtr );
+Status_t iStdWriteToFile ( iStdOutput_t *OutputPtr );
+Status_t iStdSrcDtmName ( iStdOutput_t *OutputPtr );
 Status_t iStdAdvanceTime ( eStdTime_t *, Bool_t * );
-Status_t iStdStartStopTime( eTtlTime_t *TtlStartPtr, eTtlTime_t *TtlStopPtr );
+Status_t iStdStartStopTime( iStdOutput_t *OutputPtr );
 Status_t iStdCompareTime ( eTtlTime_t LastTime, eTtlTime_t ThisTime, Bool_t *NewTime);
-Status_t iStdStoreData(eTtlTime_t TimeStamp, Int32_t DataItem, Int32_t Value);
-Status_t iStdAddMatch(eTtlTime_t TimeStamp, Int32_t DataItem, Int32_t Value, iStdMatchedData_t *PreviousDataPtr);
-Status_t iStdAddNew  (eTtlTime_t TimeStamp, Int32_t DataItem, Int32_t Value, iStdMatchedData_t *PreviousDataPtr);
-Status_t iStdFindTimeMatch( eTtlTime_t TimeStamp, iStdMatchedData_t **DataPreviousPtr); 
+Status_t iStdStoreData(iStdOutput_t *OutputPtr, eTtlTime_t TimeStamp, Int32_t DataItem, Int32_t Value);
+Status_t iStdAppendData ( iStdOutput_t *OutputPtr, Int32_t DataItem, iStdData_t *FromPtr );
+void     iStdClearData ( iStdOutput_t *OutputPtr );
+void     iStdFreeData ( iStdOutput_t *OutputPtr );
+Status_t iStdSortData ( iStdOutput_t *OutputPtr );
+Status_t iStdSummariseData ( iStdOutput_t *OutputPtr );
+Status_t iStdAggregate ( iStdOutput_t *OutputPtr, Bool_t Final );
+void     iStdEmptyData ( iStdOutput_t *OutputPtr );
+char    *iStdAggName ( Int32_t Agg );
+Status_t iStdRowStart ( iStdOutput_t *OutputPtr, iStdRow_t *RowPtr );
+Bool_t   iStdRowNext ( iStdOutput_t *OutputPtr, iStdRow_t *RowPtr );
+Bool_t   iStdRowValue ( iStdOutput_t *OutputPtr, iStdRow_t *RowPtr, Int32_t Column, Int32_t *ValuePtr );
+void     iStdRowEnd ( iStdRow_t *RowPtr );
+Status_t iStdCursorStart ( iStdOutput_t *OutputPtr, iStdCursor_t *CursorPtr );
+Bool_t   iStdCursorNext ( iStdOutput_t *OutputPtr, iStdCursor_t *CursorPtr, Int32_t *ColumnPtr, iStdSample_t **SamplePtr );
+void     iStdCursorEnd ( iStdCursor_t *CursorPtr );
 Status_t iStdCompareTime  ( eTtlTime_t LastTime, eTtlTime_t ThisTime, Bool_t *NewTime);
 Status_t iStdCompareTimeString ( char *pLstTimeStr,char *pTimeStr, Bool_t *pNewTime, Bool_t GotData );
 Status_t iStdGetTimeStamp ( eSdbRawFmt_t , eTtlTime_t , Bool_t *, Bool_t);
+Status_t iStdLookupBuild ( void );
+Int32_t  iStdLookupFind ( eSdbCode_t Code );
+void     iStdLookupFree ( void );
+Status_t iStdFormatInit ( iStdFormat_t *FormatPtr, FILE *OutFilePtr );
+Status_t iStdFormatEnd ( iStdFormat_t *FormatPtr );
+void     iStdFormatFlush ( iStdFormat_t *FormatPtr );
+void     iStdFormatText ( iStdFormat_t *FormatPtr, const char *TextPtr );
+void     iStdFormatInt ( iStdFormat_t *FormatPtr, Int32_t Value, Int32_t MinDigits );
+void     iStdFormatTime ( iStdFormat_t *FormatPtr, eTtlTime_t *TimePtr, Bool_t DateTime );
+void     iStdFormatTimeString ( eTtlTime_t *TimePtr, char *TextPtr );
+Status_t iStdSearchSetup ( eTtlTime_t *StartTimePtr, eTtlTime_t *StopTimePtr );
+Status_t iStdSearch ( eTtlTime_t StartTime, eTtlTime_t StopTime );
+Status_t iStdSearchWrite ( Bool_t Screen );
+Status_t iStdSearchThreaded ( eTtlTime_t StartTime, eTtlTime_t StopTime );
+Status_t iStdSearchFollow ( eTtlTime_t StartTime );
+void     iStdRollupHour ( eTtlTime_t Hour );
+void     iStdRollupAdd ( eSdbCode_t Code, eTtlTime_t TimeStamp, Int32_t Value );
+Status_t iStdServe ( void );
+Status_t iStdGzIndexLoad ( char *GzFilePtr, iStdGzIndex_t **IndexPtr );
+void     iStdGzIndexFree ( iStdGzIndex_t *IndexPtr );
+Status_t iStdGzStreamOpen ( iStdGzIndex_t *IndexPtr, Uint32_t Point, iStdGzStream_t **StreamPtr );
+Status_t iStdGzStreamRead ( iStdGzStream_t *StreamPtr, void *BufferPtr, size_t Size, size_t *NumBytesPtr );
+void     iStdGzStreamClose ( iStdGzStream_t *StreamPtr );
+Status_t iStdSdbIndexSelect ( char *SdbFilePtr, eSdbCode_t *CodesPtr, size_t NumCodes, Uint32_t NeedFrom, Uint32_t NeedTo, iStdSdbBlocks_t *BlocksPtr );
+Bool_t   iStdSdbBlocksRun ( iStdSdbBlocks_t *BlocksPtr, Uint32_t Record, Uint32_t *StartPtr, Uint32_t *EndPtr );
+void     iStdSdbBlocksFree ( iStdSdbBlocks_t *BlocksPtr );
+Status_t iStdColumnsHour ( eStdColumns_t *ColumnsPtr, Int32_t Hour, eSdbCode_t *CodesPtr, size_t NumCodes, iStdColRead_t *ReadPtr, Bool_t *CoveredPtr );
+void     iStdColReadFree ( iStdColRead_t *ReadPtr );
+void     iStdBinaryHeader ( unsigned char *BufferPtr, Uint32_t NumColumns );
+void     iStdBinaryColumn ( unsigned char *BufferPtr, eStdBinaryColumn_t *ColumnPtr );
+void     iStdBinaryRecord ( unsigned char *BufferPtr, eTtlTime_t *TimePtr, Uint32_t Column, Int32_t Value );
+Bool_t   iStdCatHourOfName ( char *NamePtr, Int32_t *HourPtr, Bool_t *GzippedPtr );
+Status_t iStdBgzfOpen ( FILE *InFile, Uint32_t Offset, Uint32_t Size, iStdBgzf_t **BgzfPtr );
+void     iStdBgzfInfo ( iStdBgzf_t *BgzfPtr, char *HeaderPtr, Uint32_t *NumBlocksPtr, Uint32_t *NumRecordsPtr );
+Status_t iStdBgzfRead ( iStdBgzf_t *BgzfPtr, Uint32_t Block, Uint32_t *FirstPtr, eSdbRawFmt_t **DataPtr, size_t *NumRecordsPtr );
+void     iStdBgzfClose ( iStdBgzf_t *BgzfPtr );
+Status_t iStdBundleOpen ( char *PathPtr, eStdTime_t *TimePtr, iStdBundle_t **BundlePtr );
+Bool_t   iStdBundleCovers ( iStdBundle_t *BundlePtr, eStdTime_t *TimePtr );
+Status_t iStdBundleHour ( iStdBundle_t *BundlePtr, eStdTime_t *TimePtr, FILE **InFilePtr, iStdBundleSlot_t *SlotPtr, char *NamePtr );
+void     iStdBundleAdvise ( iStdBundle_t *BundlePtr, eStdTime_t *TimePtr );
+void     iStdBundleClose ( iStdBundle_t *BundlePtr );
 
 
 #endif
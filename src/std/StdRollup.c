@@ -0,0 +1,1557 @@
+/*****************************************************************************
+** Module Name:
+**     StdRollup.c
+**
+** Purpose:
+**     Rollup archive of Sdb data, holding each series summarised at a few
+**     fixed resolutions, so that a view of weeks need not read every
+**     record of every hour.
+**
+** Description:
+**     The rollup archive holds a file per day, "yymmdd.rup". For each
+**     storage code found in the day, each level of the file holds a point
+**     per interval of the level's resolution holding records, giving the
+**     number of records and their least, greatest and summed values, from
+**     which the mean follows. Intervals without records have no point.
+**     The levels are of 10 seconds, 1 minute, 10 minutes and 1 hour,
+**     counted from the start of the day.
+**
+**     A day is rolled up once it ended I_STD_CAT_SETTLE seconds ago,
+**     either by Std from the records it decodes while searching, see
+**     eStdRollupStart, or from its Sdb files, of any format, see
+**     eStdRollupBuild. Either way each hour is decoded once, its records
+**     summarised straight into the finest level, and each coarser level
+**     is then made from the one before it. So any level can be made again
+**     from the finest, without the Sdb files, see eStdRollupRebuild.
+**
+**     After the header come the codes, in order, and then the points of
+**     each level in turn, those of each code together in time order. The
+**     points are of fixed size, so those of a code at a level are read in
+**     one go, see eStdRollupSeries.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_RUP_CHUNK    65536    /* Records read at once when rolling up */
+#define M_STD_RUP_MIN      4096     /* Records or points allowed for initially */
+#define M_STD_RUP_BATCH    1048576  /* Records held before they are summarised */
+#define M_STD_NAME_LEN     10       /* Length of "yymmdd.rup" */
+
+/* A record of an hour being rolled up */
+typedef struct mStdRupRecord_s
+{
+   eSdbCode_t         Code;      /* Storage code */
+   Int32_t            Time;      /* Second of the record */
+   Int32_t            Value;
+} mStdRupRecord_t;
+
+/* A point of the finest level, before the points are put in code order */
+typedef struct mStdRupPiece_s
+{
+   eSdbCode_t         Code;      /* Storage code */
+   eStdRollupPoint_t  Point;
+} mStdRupPiece_t;
+
+/* Everything held of a day of a rollup archive being read */
+struct eStdRollup_s
+{
+   FILE              *InFile;    /* The day's file */
+   iStdRupHeader_t    Header;    /* Its header */
+   iStdRupCode_t     *Codes;     /* Its storage codes, in order */
+   eStdRollupPoint_t *Points;    /* Points last read */
+   Uint32_t           MaxPoints; /* Points there is room for */
+};
+
+/* A day being rolled up from the records fed to it */
+struct eStdRollupFeed_s
+{
+   iStdRupHeader_t    Header;     /* Header of the day's file */
+   Int32_t            End;        /* Start of the day after */
+   char               File[ FILENAME_MAX ]; /* Name of the day's file */
+   mStdRupRecord_t   *Records;    /* Records not yet summarised */
+   Uint32_t           NumRecords; /* Number of them */
+   Uint32_t           MaxRecords; /* Records there is room for */
+   mStdRupPiece_t    *Pieces;     /* Points of the finest level */
+   Uint32_t           NumPieces;  /* Number of them */
+   Uint32_t           MaxPieces;  /* Points there is room for */
+};
+
+/* Local variables */
+static Uint32_t mStdRupResolution[ E_STD_ROLLUP_LEVELS ] = { 10, 60, 600, 3600 };
+
+/* Local function prototypes */
+static Int32_t  mStdRupDayOf ( Int32_t Time, Int32_t *StartPtr );
+static void     mStdRupFileName ( char *DirPtr, Int32_t Key, char *FilePtr );
+static Status_t mStdRupFeedHour ( char *ArchivePtr, Int32_t Hour, eStdRollupFeed_t *FeedPtr );
+static Status_t mStdRupAddHour ( iStdRupHeader_t *, Int32_t, mStdRupRecord_t *, Uint32_t, mStdRupPiece_t **, Uint32_t *, Uint32_t * );
+static Status_t mStdRupCodes ( mStdRupPiece_t *, Uint32_t, iStdRupHeader_t *, iStdRupCode_t **, eStdRollupPoint_t ** );
+static Status_t mStdRupDerive ( iStdRupHeader_t *, iStdRupCode_t *, eStdRollupPoint_t **, Uint32_t );
+static void     mStdRupMerge ( eStdRollupPoint_t *ToPtr, eStdRollupPoint_t *FromPtr );
+static Status_t mStdRupWrite ( char *, iStdRupHeader_t *, iStdRupCode_t *, eStdRollupPoint_t ** );
+static Status_t mStdRupRead ( char *, iStdRupHeader_t *, iStdRupCode_t **, FILE ** );
+static int      mStdCompareRecords ( const void *FirstPtr, const void *SecondPtr );
+static int      mStdComparePieces ( const void *FirstPtr, const void *SecondPtr );
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupBuild
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Roll up a day of Sdb files into the rollup archive.
+**
+** Description:
+**    Reads the Sdb file of each hour of the day in turn, plain, gzipped
+**    or block-structured, and feeds its records to the day as Std does
+**    when given the rollup switch, see eStdRollupStart. A day is only
+**    rolled up once it ended I_STD_CAT_SETTLE seconds ago, as its last
+**    Sdb file may be written until then.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_TIME_OUT_RANGE if the day
+**       has not ended, E_STD_READ_DATA_ERR if an Sdb file could not be
+**       read, E_STD_FILE_WRITE_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char       *RollupDirPtr   (in)
+**       Directory holding the rollup archive.
+**    char       *ArchivePtr     (in)
+**       Directory holding the Sdb files, as given to eStdReaderOpen.
+**    eTtlTime_t  Day            (in)
+**       Any time of the day.
+**    Uint32_t   *NumCodesPtr    (out)
+**       Number of storage codes found.
+**    Uint32_t   *NumRecordsPtr  (out)
+**       Number of records rolled up.
+**
+*****************************************************************************/
+Status_t eStdRollupBuild( char *RollupDirPtr,
+                          char *ArchivePtr,
+                          eTtlTime_t Day,
+                          Uint32_t *NumCodesPtr,
+                          Uint32_t *NumRecordsPtr )
+{
+   Status_t          Status;        /* Return value of function calls */
+   eStdRollupFeed_t *FeedPtr;       /* The day being rolled up */
+   Int32_t           Hour;          /* Start of an hour of the day */
+
+   *NumCodesPtr   = 0;
+   *NumRecordsPtr = 0;
+
+   Status = eStdRollupStart( RollupDirPtr, Day, &FeedPtr );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   for ( Hour = FeedPtr->Header.Start;
+         ( Hour < FeedPtr->End ) && ( Status == SYS_NOMINAL );
+         Hour += E_STD_SECONDS_PER_HOUR )
+   {
+      Status = mStdRupFeedHour( ArchivePtr, Hour, FeedPtr );
+   }
+
+   if ( Status != SYS_NOMINAL )
+   {
+      eStdRollupFinish( FeedPtr, FALSE, NumCodesPtr, NumRecordsPtr );
+      return Status;
+   }
+
+   return eStdRollupFinish( FeedPtr, TRUE, NumCodesPtr, NumRecordsPtr );
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupDay
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the day of a rollup archive a time falls in.
+**
+** Description:
+**    Days are those of local time, as are the names of Sdb files, so a
+**    day is an hour longer, or shorter, when the clocks change.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eTtlTime_t  Time        (in)
+**       The time.
+**    eTtlTime_t *StartPtr    (out)
+**       Start of its day.
+**    eTtlTime_t *EndPtr      (out)
+**       Start of the day after.
+**
+*****************************************************************************/
+Status_t eStdRollupDay( eTtlTime_t Time,
+                        eTtlTime_t *StartPtr,
+                        eTtlTime_t *EndPtr )
+{
+   Int32_t Key;        /* yymmdd of the day */
+   Int32_t Start;      /* Start of the day */
+   Int32_t NumHours;   /* Hours of the day */
+
+   Key = mStdRupDayOf( Time.t_sec, &Start );
+   NumHours = 0;
+   while ( ( NumHours < I_STD_COL_MAX_HOURS ) &&
+           ( mStdRupDayOf( Start + NumHours * E_STD_SECONDS_PER_HOUR, NULL ) == Key ) )
+   {
+      NumHours++;
+   }
+
+   StartPtr->t_sec  = Start;
+   StartPtr->t_nsec = 0;
+   EndPtr->t_sec    = Start + NumHours * E_STD_SECONDS_PER_HOUR;
+   EndPtr->t_nsec   = 0;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupStart
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Start rolling up a day from records fed to it as they are decoded.
+**
+** Description:
+**    The records of the day are given with eStdRollupAdd in any order,
+**    by whatever pass decodes its hours, so the Sdb files need not be
+**    read again to roll it up. They are summarised into the points of
+**    the finest level M_STD_RUP_BATCH at a time, so only that many are
+**    held at once. The day may only be started once it ended
+**    I_STD_CAT_SETTLE seconds ago, as its last Sdb file may be written
+**    until then.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_TIME_OUT_RANGE if the day
+**       has not ended, E_STD_FILE_WRITE_ERR if the directory name is too
+**       long, or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char              *RollupDirPtr   (in)
+**       Directory holding the rollup archive.
+**    eTtlTime_t         Day            (in)
+**       Any time of the day.
+**    eStdRollupFeed_t **FeedPtr        (out)
+**       The day being rolled up, until given to eStdRollupFinish.
+**
+*****************************************************************************/
+Status_t eStdRollupStart( char *RollupDirPtr,
+                          eTtlTime_t Day,
+                          eStdRollupFeed_t **FeedPtr )
+{
+   eStdRollupFeed_t *NewPtr;    /* Day being started */
+   eTtlTime_t        Start;     /* Start of the day */
+   eTtlTime_t        End;       /* Start of the day after */
+
+   *FeedPtr = NULL;
+
+   if ( strlen( RollupDirPtr ) + M_STD_NAME_LEN + 2 > FILENAME_MAX )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   NewPtr = (eStdRollupFeed_t *) TTL_CALLOC( 1, sizeof( eStdRollupFeed_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   eStdRollupDay( Day, &Start, &End );
+   mStdRupFileName( RollupDirPtr, mStdRupDayOf( Day.t_sec, NULL ), NewPtr->File );
+   if ( (Int32_t) time( NULL ) < End.t_sec + I_STD_CAT_SETTLE )
+   {
+      eLogErr(E_STD_TIME_OUT_RANGE,"Day of %s has not yet ended", NewPtr->File);
+      TTL_FREE( NewPtr );
+      return E_STD_TIME_OUT_RANGE;
+   }
+
+   memcpy( NewPtr->Header.Magic, I_STD_RUP_MAGIC, 4 );
+   NewPtr->Header.Version = I_STD_RUP_VERSION;
+   NewPtr->Header.Start   = Start.t_sec;
+   memcpy( NewPtr->Header.Resolution, mStdRupResolution,
+           sizeof( NewPtr->Header.Resolution ) );
+   NewPtr->End = End.t_sec;
+
+   *FeedPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupAdd
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Feed a record to a day being rolled up.
+**
+** Description:
+**    Records outside the day are passed over, so whole hours may be fed
+**    without looking at their times.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdRollupFeed_t *FeedPtr       (in/out)
+**       The day being rolled up.
+**    eSdbCode_t        Code          (in)
+**       Storage code of the record.
+**    eTtlTime_t        TimeStamp     (in)
+**       Time of the record.
+**    Int32_t           Value         (in)
+**       Value of the record.
+**
+*****************************************************************************/
+Status_t eStdRollupAdd( eStdRollupFeed_t *FeedPtr,
+                        eSdbCode_t Code,
+                        eTtlTime_t TimeStamp,
+                        Int32_t Value )
+{
+   Status_t         Status;          /* Return value of function calls */
+   mStdRupRecord_t *NewRecordsPtr;   /* Records once more room is made */
+   mStdRupRecord_t *RecordPtr;       /* Record being added */
+
+   if ( ( TimeStamp.t_sec < FeedPtr->Header.Start ) ||
+        ( TimeStamp.t_sec >= FeedPtr->End ) )
+   {
+      return SYS_NOMINAL;
+   }
+
+   if ( FeedPtr->NumRecords == FeedPtr->MaxRecords )
+   {
+      /* Summarise those held, once as many are held as allowed */
+      if ( FeedPtr->MaxRecords >= M_STD_RUP_BATCH )
+      {
+         Status = mStdRupAddHour( &(FeedPtr->Header), FeedPtr->End,
+                                  FeedPtr->Records, FeedPtr->NumRecords,
+                                  &(FeedPtr->Pieces), &(FeedPtr->MaxPieces),
+                                  &(FeedPtr->NumPieces) );
+         if ( Status != SYS_NOMINAL )
+         {
+            return Status;
+         }
+         FeedPtr->NumRecords = 0;
+      }
+      else
+      {
+         FeedPtr->MaxRecords = FeedPtr->MaxRecords == 0 ? M_STD_RUP_MIN :
+                               FeedPtr->MaxRecords * 2;
+         NewRecordsPtr = (mStdRupRecord_t *) TTL_REALLOC( FeedPtr->Records,
+                            sizeof( mStdRupRecord_t ) * FeedPtr->MaxRecords );
+         if ( NewRecordsPtr == NULL )
+         {
+            return E_STD_MEM_ALLOC_ERR;
+         }
+         FeedPtr->Records = NewRecordsPtr;
+      }
+   }
+
+   RecordPtr = FeedPtr->Records + FeedPtr->NumRecords++;
+   RecordPtr->Code  = Code;
+   RecordPtr->Time  = TimeStamp.t_sec;
+   RecordPtr->Value = Value;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupFinish
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Finish rolling up a day, and write its file.
+**
+** Description:
+**    The records still held are summarised, the coarser levels made from
+**    the finest, and the day's file written to a temporary file which
+**    replaces any existing file of the day once complete. The day is
+**    freed, whether written or not, so one whose records could not all
+**    be fed is finished without being written.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_WRITE_ERR or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdRollupFeed_t *FeedPtr        (in)
+**       The day being rolled up.
+**    Bool_t            Write          (in)
+**       Whether the day's file is written.
+**    Uint32_t         *NumCodesPtr    (out)
+**       Number of storage codes found.
+**    Uint32_t         *NumRecordsPtr  (out)
+**       Number of records rolled up.
+**
+*****************************************************************************/
+Status_t eStdRollupFinish( eStdRollupFeed_t *FeedPtr,
+                           Bool_t Write,
+                           Uint32_t *NumCodesPtr,
+                           Uint32_t *NumRecordsPtr )
+{
+   Status_t           Status;        /* Return value of function calls */
+   iStdRupCode_t     *CodesPtr;      /* Codes of the day */
+   eStdRollupPoint_t *Points[ E_STD_ROLLUP_LEVELS ]; /* Points of each level */
+   Uint32_t           l;             /* Level */
+
+   *NumCodesPtr   = 0;
+   *NumRecordsPtr = 0;
+
+   memset( Points, 0, sizeof( Points ) );
+   CodesPtr = NULL;
+   Status   = SYS_NOMINAL;
+
+   if ( Write == TRUE )
+   {
+      Status = mStdRupAddHour( &(FeedPtr->Header), FeedPtr->End,
+                               FeedPtr->Records, FeedPtr->NumRecords,
+                               &(FeedPtr->Pieces), &(FeedPtr->MaxPieces),
+                               &(FeedPtr->NumPieces) );
+
+      if ( Status == SYS_NOMINAL )
+      {
+         Status = mStdRupCodes( FeedPtr->Pieces, FeedPtr->NumPieces,
+                                &(FeedPtr->Header), &CodesPtr, Points );
+      }
+
+      for ( l = 1; ( l < E_STD_ROLLUP_LEVELS ) && ( Status == SYS_NOMINAL ); l++ )
+      {
+         Status = mStdRupDerive( &(FeedPtr->Header), CodesPtr, Points, l );
+      }
+
+      if ( Status == SYS_NOMINAL )
+      {
+         Status = mStdRupWrite( FeedPtr->File, &(FeedPtr->Header), CodesPtr, Points );
+      }
+
+      if ( Status == SYS_NOMINAL )
+      {
+         *NumCodesPtr   = FeedPtr->Header.NumCodes;
+         *NumRecordsPtr = FeedPtr->Header.NumRecords;
+      }
+   }
+
+   for ( l = 0; l < E_STD_ROLLUP_LEVELS; l++ )
+   {
+      TTL_FREE( Points[ l ] );
+   }
+   TTL_FREE( CodesPtr );
+   TTL_FREE( FeedPtr->Records );
+   TTL_FREE( FeedPtr->Pieces );
+   TTL_FREE( FeedPtr );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupRebuild
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Make the coarser levels of a day of a rollup archive again.
+**
+** Description:
+**    Only the finest level is read, and each coarser level made from the
+**    one before it, as when the day was rolled up. The Sdb files are not
+**    read, so a day may be rebuilt after they are gone. The day's file is
+**    replaced as by eStdRollupBuild.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if the day has
+**       not been rolled up, E_STD_READ_DATA_ERR if its file could not be
+**       read, E_STD_FILE_WRITE_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char       *RollupDirPtr   (in)
+**       Directory holding the rollup archive.
+**    eTtlTime_t  Day            (in)
+**       Any time of the day.
+**    Uint32_t   *NumCodesPtr    (out)
+**       Number of storage codes of the day.
+**
+*****************************************************************************/
+Status_t eStdRollupRebuild( char *RollupDirPtr,
+                            eTtlTime_t Day,
+                            Uint32_t *NumCodesPtr )
+{
+   Status_t           Status;        /* Return value of function calls */
+   iStdRupHeader_t    Header;        /* Header of the day's file */
+   iStdRupCode_t     *CodesPtr;      /* Codes of the day */
+   eStdRollupPoint_t *Points[ E_STD_ROLLUP_LEVELS ]; /* Points of each level */
+   FILE              *InFile;        /* The day's file */
+   char               File[ FILENAME_MAX ]; /* Name of the day's file */
+   Uint32_t           l;             /* Level */
+
+   *NumCodesPtr = 0;
+
+   if ( strlen( RollupDirPtr ) + M_STD_NAME_LEN + 2 > FILENAME_MAX )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   mStdRupFileName( RollupDirPtr, mStdRupDayOf( Day.t_sec, NULL ), File );
+   Status = mStdRupRead( File, &Header, &CodesPtr, &InFile );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   /* The finest points follow the codes */
+   memset( Points, 0, sizeof( Points ) );
+   Points[ 0 ] = (eStdRollupPoint_t *) TTL_MALLOC( sizeof( eStdRollupPoint_t ) *
+                                                   ( Header.NumPoints[ 0 ] + 1 ) );
+   if ( Points[ 0 ] == NULL )
+   {
+      Status = E_STD_MEM_ALLOC_ERR;
+   }
+   else if ( fread( Points[ 0 ], sizeof( eStdRollupPoint_t ), Header.NumPoints[ 0 ],
+                    InFile ) != Header.NumPoints[ 0 ] )
+   {
+      eLogErr(E_STD_READ_DATA_ERR,"Unable to read file %s", File);
+      Status = E_STD_READ_DATA_ERR;
+   }
+   fclose( InFile );
+
+   /* The resolutions are those of this build, not of the file */
+   memcpy( Header.Resolution, mStdRupResolution, sizeof( Header.Resolution ) );
+   for ( l = 1; ( l < E_STD_ROLLUP_LEVELS ) && ( Status == SYS_NOMINAL ); l++ )
+   {
+      Status = mStdRupDerive( &Header, CodesPtr, Points, l );
+   }
+
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = mStdRupWrite( File, &Header, CodesPtr, Points );
+   }
+
+   if ( Status == SYS_NOMINAL )
+   {
+      *NumCodesPtr = Header.NumCodes;
+   }
+
+   for ( l = 0; l < E_STD_ROLLUP_LEVELS; l++ )
+   {
+      TTL_FREE( Points[ l ] );
+   }
+   TTL_FREE( CodesPtr );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Start reading a day of a rollup archive.
+**
+** Description:
+**    The header and codes of the day are read, and the file kept open for
+**    the points of each series to be read as asked for, see
+**    eStdRollupSeries, until closed with eStdRollupClose.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if the day has
+**       not been rolled up, E_STD_READ_DATA_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char          *RollupDirPtr   (in)
+**       Directory holding the rollup archive.
+**    eTtlTime_t     Day            (in)
+**       Any time of the day.
+**    eStdRollup_t **RollupPtr      (out)
+**       The day.
+**
+*****************************************************************************/
+Status_t eStdRollupOpen( char *RollupDirPtr,
+                         eTtlTime_t Day,
+                         eStdRollup_t **RollupPtr )
+{
+   Status_t      Status;                /* Return value of function calls */
+   eStdRollup_t *NewPtr;                /* Day being opened */
+   char          File[ FILENAME_MAX ];  /* Name of the day's file */
+
+   *RollupPtr = NULL;
+
+   if ( strlen( RollupDirPtr ) + M_STD_NAME_LEN + 2 > FILENAME_MAX )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   NewPtr = (eStdRollup_t *) TTL_CALLOC( 1, sizeof( eStdRollup_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   mStdRupFileName( RollupDirPtr, mStdRupDayOf( Day.t_sec, NULL ), File );
+   Status = mStdRupRead( File, &(NewPtr->Header), &(NewPtr->Codes),
+                         &(NewPtr->InFile) );
+   if ( Status != SYS_NOMINAL )
+   {
+      TTL_FREE( NewPtr );
+      return Status;
+   }
+
+   *RollupPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupCode
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find a storage code of a day of a rollup archive.
+**
+** Description:
+**    The codes are numbered from 0, in order.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_EOF if there are no more
+**       codes.
+**
+** Arguments:
+**    eStdRollup_t *RollupPtr     (in)
+**       The day.
+**    Uint32_t      Index         (in)
+**       Number of the code.
+**    eSdbCode_t   *CodePtr       (out)
+**       The code.
+**    Uint32_t     *NumRecordsPtr (out)
+**       Number of its records in the day.
+**
+*****************************************************************************/
+Status_t eStdRollupCode( eStdRollup_t *RollupPtr,
+                         Uint32_t Index,
+                         eSdbCode_t *CodePtr,
+                         Uint32_t *NumRecordsPtr )
+{
+   if ( Index >= RollupPtr->Header.NumCodes )
+   {
+      return E_STD_EOF;
+   }
+
+   *CodePtr       = RollupPtr->Codes[ Index ].Code;
+   *NumRecordsPtr = RollupPtr->Codes[ Index ].NumRecords;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupSeries
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the points of a storage code at one level of a day.
+**
+** Description:
+**    The points are in time order, each at the start of its interval.
+**    They are held by the day, and remain valid until the next call.
+**    A code not found in the day has no points.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_ARRAY_SIZE if there is no
+**       such level, E_STD_READ_DATA_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eStdRollup_t       *RollupPtr     (in/out)
+**       The day.
+**    eSdbCode_t          Code          (in)
+**       Storage code wanted.
+**    Uint32_t            Level         (in)
+**       Level wanted, 0 for the finest.
+**    eStdRollupPoint_t **PointsPtr     (out)
+**       Its points.
+**    Uint32_t           *NumPointsPtr  (out)
+**       Number of points.
+**    Uint32_t           *ResolutionPtr (out)
+**       Seconds of each interval of the level.
+**
+*****************************************************************************/
+Status_t eStdRollupSeries( eStdRollup_t *RollupPtr,
+                           eSdbCode_t Code,
+                           Uint32_t Level,
+                           eStdRollupPoint_t **PointsPtr,
+                           Uint32_t *NumPointsPtr,
+                           Uint32_t *ResolutionPtr )
+{
+   iStdRupCode_t     *CodePtr;       /* The code's entry */
+   eStdRollupPoint_t *NewPointsPtr;  /* Points once more room is made */
+   Uint32_t           Low;           /* Bounds of the codes searched */
+   Uint32_t           High;
+   Uint32_t           Mid;
+   Uint32_t           l;             /* Level before the one wanted */
+   long               Offset;        /* Offset of the points in the file */
+
+   *PointsPtr    = RollupPtr->Points;
+   *NumPointsPtr = 0;
+
+   if ( Level >= E_STD_ROLLUP_LEVELS )
+   {
+      return E_STD_ARRAY_SIZE;
+   }
+   *ResolutionPtr = RollupPtr->Header.Resolution[ Level ];
+
+   Low  = 0;
+   High = RollupPtr->Header.NumCodes;
+   while ( Low < High )
+   {
+      Mid = ( Low + High ) / 2;
+      if ( RollupPtr->Codes[ Mid ].Code < Code )
+      {
+         Low = Mid + 1;
+      }
+      else
+      {
+         High = Mid;
+      }
+   }
+   if ( ( Low == RollupPtr->Header.NumCodes ) || ( RollupPtr->Codes[ Low ].Code != Code ) )
+   {
+      return SYS_NOMINAL;
+   }
+   CodePtr = RollupPtr->Codes + Low;
+
+   if ( CodePtr->NumPoints[ Level ] > RollupPtr->MaxPoints )
+   {
+      NewPointsPtr = (eStdRollupPoint_t *) TTL_REALLOC( RollupPtr->Points,
+                        sizeof( eStdRollupPoint_t ) * CodePtr->NumPoints[ Level ] );
+      if ( NewPointsPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      RollupPtr->Points    = NewPointsPtr;
+      RollupPtr->MaxPoints = CodePtr->NumPoints[ Level ];
+   }
+
+   Offset = sizeof( iStdRupHeader_t ) +
+            sizeof( iStdRupCode_t ) * RollupPtr->Header.NumCodes;
+   for ( l = 0; l < Level; l++ )
+   {
+      Offset += sizeof( eStdRollupPoint_t ) * RollupPtr->Header.NumPoints[ l ];
+   }
+   Offset += sizeof( eStdRollupPoint_t ) * CodePtr->FirstPoint[ Level ];
+
+   if ( ( fseek( RollupPtr->InFile, Offset, SEEK_SET ) != 0 ) ||
+        ( fread( RollupPtr->Points, sizeof( eStdRollupPoint_t ),
+                 CodePtr->NumPoints[ Level ], RollupPtr->InFile )
+          != CodePtr->NumPoints[ Level ] ) )
+   {
+      eLogErr(E_STD_READ_DATA_ERR,"Unable to read points of code 0x%x",
+              (unsigned int) Code);
+      return E_STD_READ_DATA_ERR;
+   }
+
+   *PointsPtr    = RollupPtr->Points;
+   *NumPointsPtr = CodePtr->NumPoints[ Level ];
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdRollupClose
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Finish reading a day of a rollup archive.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdRollup_t *RollupPtr     (in)
+**       The day, which may be NULL.
+**
+*****************************************************************************/
+Status_t eStdRollupClose( eStdRollup_t *RollupPtr )
+{
+   if ( RollupPtr == NULL )
+   {
+      return SYS_NOMINAL;
+   }
+
+   fclose( RollupPtr->InFile );
+   TTL_FREE( RollupPtr->Codes );
+   TTL_FREE( RollupPtr->Points );
+   TTL_FREE( RollupPtr );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRupDayOf
+**
+** Type:
+**    Int32_t
+**
+** Purpose:
+**    Find the day of a time.
+**
+** Description:
+**    Days are those of local time, as are the names of Sdb files.
+**
+** Return type:
+**    Int32_t
+**       The day, as the number yymmdd.
+**
+** Arguments:
+**    Int32_t  Time        (in)
+**       Seconds since the epoch.
+**    Int32_t *StartPtr    (out)
+**       Start of the day, or NULL if not wanted.
+**
+*****************************************************************************/
+static Int32_t mStdRupDayOf( Int32_t Time, Int32_t *StartPtr )
+{
+   time_t    Seconds;   /* The time */
+   struct tm Tm;        /* Broken down time */
+
+   Seconds = (time_t) Time;
+   localtime_r( &Seconds, &Tm );
+
+   if ( StartPtr != NULL )
+   {
+      Tm.tm_hour  = 0;
+      Tm.tm_min   = 0;
+      Tm.tm_sec   = 0;
+      Tm.tm_isdst = -1;
+      *StartPtr   = (Int32_t) mktime( &Tm );
+   }
+
+   return ( Tm.tm_year % 100 ) * 10000 + ( Tm.tm_mon + 1 ) * 100 + Tm.tm_mday;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRupFileName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Generate the name of the file of a day of a rollup archive.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    char    *DirPtr      (in)
+**       Directory holding the archive.
+**    Int32_t  Key         (in)
+**       The day, as yymmdd.
+**    char    *FilePtr     (out)
+**       Name of the day's file, FILENAME_MAX characters.
+**
+*****************************************************************************/
+static void mStdRupFileName( char *DirPtr, Int32_t Key, char *FilePtr )
+{
+   size_t Len;   /* Length of the directory */
+
+   strcpy( FilePtr, DirPtr );
+   Len = strlen( FilePtr );
+   if ( ( Len > 0 ) && ( FilePtr[ Len - 1 ] != '/' ) )
+   {
+      FilePtr[ Len++ ] = '/';
+   }
+   sprintf( FilePtr + Len, "%.6ld.%s", (long) Key, I_STD_EXT_ROLLUP );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRupFeedHour
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Feed every record of an hour's Sdb file to a day being rolled up.
+**
+** Description:
+**    The file is read by a reader of its own, so any file a search would
+**    read may be rolled up. There are no records if the hour has no Sdb
+**    file.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_READ_DATA_ERR or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char             *ArchivePtr     (in)
+**       Directory holding the Sdb files.
+**    Int32_t           Hour           (in)
+**       Start of the hour.
+**    eStdRollupFeed_t *FeedPtr        (in/out)
+**       The day being rolled up.
+**
+*****************************************************************************/
+static Status_t mStdRupFeedHour( char *ArchivePtr,
+                                 Int32_t Hour,
+                                 eStdRollupFeed_t *FeedPtr )
+{
+   Status_t         Status;         /* Return value of function calls */
+   eStdReader_t    *ReaderPtr;      /* Reader of the hour's file */
+   eTtlTime_t       HourStart;      /* Start of the hour */
+   eTtlTime_t       HourEnd;        /* End of the hour */
+   eTtlTime_t       TimeStamp;      /* Time of a record */
+   eSdbRawFmt_t    *SdbDataPtr;     /* Records returned */
+   size_t           NumRead;        /* Records returned at once */
+   size_t           i;              /* Record returned */
+   Bool_t           Finished;       /* Hour read */
+
+   HourStart.t_sec  = Hour;
+   HourStart.t_nsec = 0;
+   HourEnd.t_sec    = Hour + E_STD_SECONDS_PER_HOUR - 1;
+   HourEnd.t_nsec   = 0;
+
+   Status = eStdReaderOpen( HourStart, HourEnd, ArchivePtr, &ReaderPtr );
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = eStdReaderChunk( ReaderPtr, M_STD_RUP_CHUNK );
+   }
+
+   Finished = FALSE;
+   while ( ( Status == SYS_NOMINAL ) && ( Finished == FALSE ) )
+   {
+      Status = eStdReaderNext( ReaderPtr, &SdbDataPtr, &NumRead, &Finished );
+
+      for ( i = 0; ( Status == SYS_NOMINAL ) && ( i < NumRead ); i++ )
+      {
+         eStdReaderTime( ReaderPtr, SdbDataPtr + i, &TimeStamp );
+         Status = eStdRollupAdd( FeedPtr, SdbDataPtr[ i ].Code, TimeStamp,
+                                 SdbDataPtr[ i ].Value );
+      }
+   }
+
+   eStdReaderClose( ReaderPtr );
+
+   if ( Status == E_STD_MEM_ALLOC_ERR )
+   {
+      return Status;
+   }
+   if ( Status != SYS_NOMINAL )
+   {
+      eLogErr(E_STD_READ_DATA_ERR,"Unable to roll up hour of %s", ArchivePtr);
+      return E_STD_READ_DATA_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRupAddHour
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Add the records held of a day to the points of the finest level.
+**
+** Description:
+**    The records are put in order of code and time, and those of each
+**    code falling in the same interval summarised as a point. Records
+**    outside the day are passed over. An interval whose records are
+**    summarised in more than one go, such as one written late in the
+**    file of the next hour, is given a point each time, which are merged
+**    once the day is complete.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdRupHeader_t  *HeaderPtr     (in/out)
+**       Header of the day, counting the records added.
+**    Int32_t           End           (in)
+**       End of the day.
+**    mStdRupRecord_t  *RecordsPtr    (in)
+**       Records held, put in order.
+**    Uint32_t          NumRecords    (in)
+**       Number of records.
+**    mStdRupPiece_t  **PiecesPtr     (in/out)
+**       Points of the finest level, reallocated as needed.
+**    Uint32_t         *MaxPiecesPtr  (in/out)
+**       Points there is room for.
+**    Uint32_t         *NumPiecesPtr  (in/out)
+**       Points so far.
+**
+*****************************************************************************/
+static Status_t mStdRupAddHour( iStdRupHeader_t *HeaderPtr,
+                                Int32_t End,
+                                mStdRupRecord_t *RecordsPtr,
+                                Uint32_t NumRecords,
+                                mStdRupPiece_t **PiecesPtr,
+                                Uint32_t *MaxPiecesPtr,
+                                Uint32_t *NumPiecesPtr )
+{
+   mStdRupRecord_t *RecordPtr;      /* Record being added */
+   mStdRupPiece_t  *PiecePtr;       /* Point it is added to */
+   mStdRupPiece_t  *NewPiecesPtr;   /* Points once more room is made */
+   Int32_t          Time;           /* Start of the record's interval */
+   Uint32_t         i;              /* Record */
+
+   if ( NumRecords == 0 )
+   {
+      return SYS_NOMINAL;
+   }
+
+   qsort( RecordsPtr, NumRecords, sizeof( mStdRupRecord_t ), mStdCompareRecords );
+
+   PiecePtr = NULL;
+   for ( i = 0; i < NumRecords; i++ )
+   {
+      RecordPtr = RecordsPtr + i;
+      if ( ( RecordPtr->Time < HeaderPtr->Start ) || ( RecordPtr->Time >= End ) )
+      {
+         continue;
+      }
+      Time = RecordPtr->Time - ( RecordPtr->Time - HeaderPtr->Start ) %
+                               (Int32_t) HeaderPtr->Resolution[ 0 ];
+
+      if ( ( PiecePtr != NULL ) && ( PiecePtr->Code == RecordPtr->Code ) &&
+           ( PiecePtr->Point.Time == Time ) )
+      {
+         if ( RecordPtr->Value < PiecePtr->Point.Min )
+         {
+            PiecePtr->Point.Min = RecordPtr->Value;
+         }
+         if ( RecordPtr->Value > PiecePtr->Point.Max )
+         {
+            PiecePtr->Point.Max = RecordPtr->Value;
+         }
+         PiecePtr->Point.Sum += RecordPtr->Value;
+         PiecePtr->Point.Count++;
+         HeaderPtr->NumRecords++;
+         continue;
+      }
+
+      if ( *NumPiecesPtr == *MaxPiecesPtr )
+      {
+         *MaxPiecesPtr = *MaxPiecesPtr == 0 ? M_STD_RUP_MIN : *MaxPiecesPtr * 2;
+         NewPiecesPtr  = (mStdRupPiece_t *) TTL_REALLOC( *PiecesPtr,
+                            sizeof( mStdRupPiece_t ) * *MaxPiecesPtr );
+         if ( NewPiecesPtr == NULL )
+         {
+            return E_STD_MEM_ALLOC_ERR;
+         }
+         *PiecesPtr = NewPiecesPtr;
+      }
+
+      PiecePtr = *PiecesPtr + (*NumPiecesPtr)++;
+      PiecePtr->Code        = RecordPtr->Code;
+      PiecePtr->Point.Time  = Time;
+      PiecePtr->Point.Count = 1;
+      PiecePtr->Point.Min   = RecordPtr->Value;
+      PiecePtr->Point.Max   = RecordPtr->Value;
+      PiecePtr->Point.Sum   = RecordPtr->Value;
+      HeaderPtr->NumRecords++;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRupCodes
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Put the points of the finest level in order, and find the codes.
+**
+** Description:
+**    Points of a code for the same interval, from different hours, are
+**    merged. Each code found is given an entry, holding where its points
+**    of the finest level are.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdRupPiece_t     *PiecesPtr     (in)
+**       Points of the finest level, put in order.
+**    Uint32_t            NumPieces     (in)
+**       Number of points.
+**    iStdRupHeader_t    *HeaderPtr     (in/out)
+**       Header of the day, given the numbers of codes and points.
+**    iStdRupCode_t     **CodesPtr      (out)
+**       Codes of the day.
+**    eStdRollupPoint_t **PointsPtr     (out)
+**       Points of each level, of which the finest are filled in.
+**
+*****************************************************************************/
+static Status_t mStdRupCodes( mStdRupPiece_t *PiecesPtr,
+                              Uint32_t NumPieces,
+                              iStdRupHeader_t *HeaderPtr,
+                              iStdRupCode_t **CodesPtr,
+                              eStdRollupPoint_t **PointsPtr )
+{
+   iStdRupCode_t     *CodePtr;      /* Entry of the code being found */
+   eStdRollupPoint_t *PointPtr;     /* Point being filled in */
+   Uint32_t           NumCodes;     /* Codes found */
+   Uint32_t           NumPoints;    /* Points kept */
+   Uint32_t           i;            /* Point being put in order */
+
+   if ( NumPieces > 0 )
+   {
+      qsort( PiecesPtr, NumPieces, sizeof( mStdRupPiece_t ), mStdComparePieces );
+   }
+
+   NumCodes = 0;
+   for ( i = 0; i < NumPieces; i++ )
+   {
+      if ( ( i == 0 ) || ( PiecesPtr[ i ].Code != PiecesPtr[ i - 1 ].Code ) )
+      {
+         NumCodes++;
+      }
+   }
+
+   *CodesPtr     = (iStdRupCode_t *) TTL_CALLOC( NumCodes + 1, sizeof( iStdRupCode_t ) );
+   PointsPtr[ 0 ] = (eStdRollupPoint_t *) TTL_MALLOC( sizeof( eStdRollupPoint_t ) *
+                                                      ( NumPieces + 1 ) );
+   if ( ( *CodesPtr == NULL ) || ( PointsPtr[ 0 ] == NULL ) )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   CodePtr   = NULL;
+   PointPtr  = NULL;
+   NumCodes  = 0;
+   NumPoints = 0;
+   for ( i = 0; i < NumPieces; i++ )
+   {
+      if ( ( CodePtr == NULL ) || ( PiecesPtr[ i ].Code != CodePtr->Code ) )
+      {
+         CodePtr = *CodesPtr + NumCodes++;
+         CodePtr->Code = PiecesPtr[ i ].Code;
+         CodePtr->FirstPoint[ 0 ] = NumPoints;
+      }
+      else if ( PiecesPtr[ i ].Point.Time == PointPtr->Time )
+      {
+         mStdRupMerge( PointPtr, &(PiecesPtr[ i ].Point) );
+         CodePtr->NumRecords += PiecesPtr[ i ].Point.Count;
+         continue;
+      }
+
+      PointPtr = PointsPtr[ 0 ] + NumPoints++;
+      *PointPtr = PiecesPtr[ i ].Point;
+      CodePtr->NumPoints[ 0 ]++;
+      CodePtr->NumRecords += PointPtr->Count;
+   }
+
+   HeaderPtr->NumCodes       = NumCodes;
+   HeaderPtr->NumPoints[ 0 ] = NumPoints;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRupDerive
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Make the points of a level from those of the level before it.
+**
+** Description:
+**    Each interval of the level covers a whole number of intervals of the
+**    level before it, whose points are merged.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdRupHeader_t    *HeaderPtr     (in/out)
+**       Header of the day, given the number of points of the level.
+**    iStdRupCode_t      *CodesPtr      (in/out)
+**       Codes of the day, given where their points of the level are.
+**    eStdRollupPoint_t **PointsPtr     (in/out)
+**       Points of each level, of which the level's are filled in.
+**    Uint32_t            Level         (in)
+**       Level to be made, not the finest.
+**
+*****************************************************************************/
+static Status_t mStdRupDerive( iStdRupHeader_t *HeaderPtr,
+                               iStdRupCode_t *CodesPtr,
+                               eStdRollupPoint_t **PointsPtr,
+                               Uint32_t Level )
+{
+   iStdRupCode_t     *CodePtr;      /* Code whose points are made */
+   eStdRollupPoint_t *FromPtr;      /* Point of the level before */
+   eStdRollupPoint_t *PointPtr;     /* Point being made */
+   Int32_t            Time;         /* Start of the interval of a point */
+   Uint32_t           NumPoints;    /* Points made */
+   Uint32_t           c;            /* Code */
+   Uint32_t           i;            /* Point of the level before */
+
+   /* There are never more points than at the level before */
+   TTL_FREE( PointsPtr[ Level ] );
+   PointsPtr[ Level ] = (eStdRollupPoint_t *) TTL_MALLOC( sizeof( eStdRollupPoint_t ) *
+                           ( HeaderPtr->NumPoints[ Level - 1 ] + 1 ) );
+   if ( PointsPtr[ Level ] == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   NumPoints = 0;
+   for ( c = 0; c < HeaderPtr->NumCodes; c++ )
+   {
+      CodePtr  = CodesPtr + c;
+      PointPtr = NULL;
+      CodePtr->FirstPoint[ Level ] = NumPoints;
+      CodePtr->NumPoints[ Level ]  = 0;
+
+      for ( i = 0; i < CodePtr->NumPoints[ Level - 1 ]; i++ )
+      {
+         FromPtr = PointsPtr[ Level - 1 ] + CodePtr->FirstPoint[ Level - 1 ] + i;
+         Time    = FromPtr->Time - ( FromPtr->Time - HeaderPtr->Start ) %
+                                   (Int32_t) HeaderPtr->Resolution[ Level ];
+
+         if ( ( PointPtr != NULL ) && ( PointPtr->Time == Time ) )
+         {
+            mStdRupMerge( PointPtr, FromPtr );
+            continue;
+         }
+
+         PointPtr = PointsPtr[ Level ] + NumPoints++;
+         *PointPtr = *FromPtr;
+         PointPtr->Time = Time;
+         CodePtr->NumPoints[ Level ]++;
+      }
+   }
+
+   HeaderPtr->NumPoints[ Level ] = NumPoints;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRupMerge
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Merge one point into another.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdRollupPoint_t *ToPtr     (in/out)
+**       Point merged into.
+**    eStdRollupPoint_t *FromPtr   (in)
+**       Point merged.
+**
+*****************************************************************************/
+static void mStdRupMerge( eStdRollupPoint_t *ToPtr, eStdRollupPoint_t *FromPtr )
+{
+   if ( FromPtr->Min < ToPtr->Min )
+   {
+      ToPtr->Min = FromPtr->Min;
+   }
+   if ( FromPtr->Max > ToPtr->Max )
+   {
+      ToPtr->Max = FromPtr->Max;
+   }
+   ToPtr->Sum   += FromPtr->Sum;
+   ToPtr->Count += FromPtr->Count;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRupWrite
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write the file of a day of a rollup archive.
+**
+** Description:
+**    The header is followed by the codes and then the points of each
+**    level in turn. It is written to a temporary file which replaces any
+**    existing file once complete. The temporary file is named for the
+**    process, as workers serving requests may each roll up the same day.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_FILE_WRITE_ERR.
+**
+** Arguments:
+**    char              *FilePtr      (in)
+**       Name of the day's file.
+**    iStdRupHeader_t   *HeaderPtr    (in)
+**       Header of the file.
+**    iStdRupCode_t     *CodesPtr     (in)
+**       Codes of the day.
+**    eStdRollupPoint_t **PointsPtr   (in)
+**       Points of each level.
+**
+*****************************************************************************/
+static Status_t mStdRupWrite( char *FilePtr,
+                              iStdRupHeader_t *HeaderPtr,
+                              iStdRupCode_t *CodesPtr,
+                              eStdRollupPoint_t **PointsPtr )
+{
+   char      TempFile[ FILENAME_MAX + 32 ]; /* Name while being written */
+   FILE     *OutFile;     /* File being written */
+   Uint32_t  l;           /* Level */
+   Bool_t    Ok;          /* All written */
+
+   sprintf( TempFile, "%s.%ld.tmp", FilePtr, (long) getpid( ) );
+
+   if ( ( OutFile = fopen( TempFile, "wb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to open file %s", TempFile);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   Ok = ( fwrite( HeaderPtr, sizeof( iStdRupHeader_t ), 1, OutFile ) == 1 ) &&
+        ( fwrite( CodesPtr, sizeof( iStdRupCode_t ), HeaderPtr->NumCodes, OutFile )
+          == HeaderPtr->NumCodes );
+
+   for ( l = 0; ( l < E_STD_ROLLUP_LEVELS ) && Ok; l++ )
+   {
+      Ok = fwrite( PointsPtr[ l ], sizeof( eStdRollupPoint_t ), HeaderPtr->NumPoints[ l ],
+                   OutFile ) == HeaderPtr->NumPoints[ l ];
+   }
+
+   if ( ( fclose( OutFile ) != 0 ) || !Ok ||
+        ( rename( TempFile, FilePtr ) != 0 ) )
+   {
+      remove( TempFile );
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to write file %s", FilePtr);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRupRead
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the header and codes of a day of a rollup archive.
+**
+** Description:
+**    The file is left open, positioned at the points of the finest level.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if there is no
+**       such file, E_STD_READ_DATA_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char             *FilePtr      (in)
+**       Name of the day's file.
+**    iStdRupHeader_t  *HeaderPtr    (out)
+**       Header of the file.
+**    iStdRupCode_t   **CodesPtr     (out)
+**       Codes of the day.
+**    FILE            **InFilePtr    (out)
+**       The open file.
+**
+*****************************************************************************/
+static Status_t mStdRupRead( char *FilePtr,
+                             iStdRupHeader_t *HeaderPtr,
+                             iStdRupCode_t **CodesPtr,
+                             FILE **InFilePtr )
+{
+   FILE *InFile;   /* The day's file */
+
+   *CodesPtr  = NULL;
+   *InFilePtr = NULL;
+
+   if ( ( InFile = fopen( FilePtr, "rb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to open file %s", FilePtr);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   if ( ( fread( HeaderPtr, sizeof( iStdRupHeader_t ), 1, InFile ) != 1 ) ||
+        ( memcmp( HeaderPtr->Magic, I_STD_RUP_MAGIC, 4 ) != 0 ) ||
+        ( HeaderPtr->Version != I_STD_RUP_VERSION ) )
+   {
+      fclose( InFile );
+      eLogErr(E_STD_READ_DATA_ERR,"File %s is not a rollup", FilePtr);
+      return E_STD_READ_DATA_ERR;
+   }
+
+   *CodesPtr = (iStdRupCode_t *) TTL_MALLOC( sizeof( iStdRupCode_t ) *
+                                             ( HeaderPtr->NumCodes + 1 ) );
+   if ( *CodesPtr == NULL )
+   {
+      fclose( InFile );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if ( fread( *CodesPtr, sizeof( iStdRupCode_t ), HeaderPtr->NumCodes, InFile )
+        != HeaderPtr->NumCodes )
+   {
+      fclose( InFile );
+      TTL_FREE( *CodesPtr );
+      *CodesPtr = NULL;
+      eLogErr(E_STD_READ_DATA_ERR,"Unable to read file %s", FilePtr);
+      return E_STD_READ_DATA_ERR;
+   }
+
+   *InFilePtr = InFile;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCompareRecords
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order records of an hour by code and time, for qsort.
+**
+** Description:
+**
+** Return type:
+**    int
+**       Negative, zero or positive.
+**
+** Arguments:
+**    const void *FirstPtr     (in)
+**    const void *SecondPtr    (in)
+**       Records compared.
+**
+*****************************************************************************/
+static int mStdCompareRecords( const void *FirstPtr, const void *SecondPtr )
+{
+   const mStdRupRecord_t *First  = (const mStdRupRecord_t *) FirstPtr;
+   const mStdRupRecord_t *Second = (const mStdRupRecord_t *) SecondPtr;
+
+   if ( First->Code != Second->Code )
+   {
+      return First->Code < Second->Code ? -1 : 1;
+   }
+   if ( First->Time != Second->Time )
+   {
+      return First->Time < Second->Time ? -1 : 1;
+   }
+   return 0;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdComparePieces
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order points of the finest level by code and time, for qsort.
+**
+** Description:
+**
+** Return type:
+**    int
+**       Negative, zero or positive.
+**
+** Arguments:
+**    const void *FirstPtr     (in)
+**    const void *SecondPtr    (in)
+**       Points compared.
+**
+*****************************************************************************/
+static int mStdComparePieces( const void *FirstPtr, const void *SecondPtr )
+{
+   const mStdRupPiece_t *First  = (const mStdRupPiece_t *) FirstPtr;
+   const mStdRupPiece_t *Second = (const mStdRupPiece_t *) SecondPtr;
+
+   if ( First->Code != Second->Code )
+   {
+      return First->Code < Second->Code ? -1 : 1;
+   }
+   if ( First->Point.Time != Second->Point.Time )
+   {
+      return First->Point.Time < Second->Point.Time ? -1 : 1;
+   }
+   return 0;
+}
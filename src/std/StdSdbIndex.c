@@ -0,0 +1,864 @@
+/*****************************************************************************
+** Module Name:
+**     StdSdbIndex.c
+**
+** Purpose:
+**     Series index of an Sdb file, so that searches for a few source/datum
+**     pairs need not examine every record of every hour.
+**
+** Description:
+**     The index lists each storage code present in an hour's Sdb file with
+**     the number of its records and the least and greatest TimeOffset of
+**     them. The records of the file are divided into blocks of a fixed
+**     number of records, and for each code a bitmap is kept of the blocks
+**     holding its records. A search can then pass over files, or blocks
+**     of a file, holding none of the codes it wants in its time range.
+**
+**     The index of "yymmddhh.sdb", or of "yymmddhh.sdb.gz", is kept
+**     alongside it in "yymmddhh.sdbidx". It is ignored if the Sdb file
+**     has since changed size, as the file for the current hour will
+**     while it is still being written.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <zlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_HASH_MULT  0x9E3779B1U  /* Multiplier for Fibonacci hashing */
+#define M_STD_IDX_CHUNK  4096         /* Records read at once when indexing */
+#define M_STD_MIN_SLOTS  256          /* Codes allowed for initially */
+
+/* A storage code being indexed, with the blocks found holding it so far */
+typedef struct mStdSeries_s
+{
+   iStdSdbIdxCode_t Entry;     /* Entry to be written, unused if no records */
+   Uint32_t        *Bitmap;    /* Blocks holding its records */
+   Uint32_t         NumWords;  /* Size of the bitmap */
+} mStdSeries_t;
+
+/* Codes being indexed, hashed on the storage code */
+typedef struct mStdSeriesTable_s
+{
+   Uint32_t      Size;         /* Number of slots, a power of two */
+   Uint32_t      Shift;        /* Bits discarded from hash to index a slot */
+   Uint32_t      NumUsed;      /* Number of slots in use */
+   mStdSeries_t *Slots;
+} mStdSeriesTable_t;
+
+/* Local function prototypes */
+static mStdSeries_t *mStdSeriesFind ( mStdSeriesTable_t *TablePtr, eSdbCode_t Code );
+static Status_t mStdSeriesGrow ( mStdSeriesTable_t *TablePtr );
+static Status_t mStdSeriesMark ( mStdSeries_t *SeriesPtr, Uint32_t Block );
+static void     mStdSeriesFree ( mStdSeriesTable_t *TablePtr );
+static Status_t mStdWriteSdbIndex ( mStdSeriesTable_t *, iStdSdbIdxHeader_t *, char * );
+static void     mStdSdbIndexName ( char *SdbFilePtr, char *IndexFilePtr );
+static int      mStdCompareCodes ( const void *FirstPtr, const void *SecondPtr );
+
+/*****************************************************************************
+** Function Name:
+**    eStdSdbIndexBuild
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Build the series index of an Sdb file.
+**
+** Description:
+**    Reads every record of the file, plain or gzipped, noting for each
+**    storage code the number of its records, their range of TimeOffset
+**    and the blocks of BlockSize records they lie in. The index is then
+**    written alongside the file. Block-structured Sdb files are not
+**    indexed, as their blocks carry the same information.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if the file
+**       could not be read, E_STD_READ_HEAD_ERR if it is not an Sdb file
+**       of the original format,
+**       E_STD_FILE_WRITE_ERR or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char     *SdbFilePtr        (in)
+**       Name of the Sdb file.
+**    Uint32_t  BlockSize         (in)
+**       Records per block, 0 for I_STD_IDX_DFLT_BLOCK.
+**    Uint32_t *NumCodesPtr       (out)
+**       Number of storage codes found.
+**
+*****************************************************************************/
+Status_t eStdSdbIndexBuild( char *SdbFilePtr,
+                            Uint32_t BlockSize,
+                            Uint32_t *NumCodesPtr )
+{
+   Status_t           Status;        /* Return value of function calls */
+   iStdSdbIdxHeader_t Header;        /* Header of the index */
+   mStdSeriesTable_t  Table;         /* Codes found */
+   mStdSeries_t      *SeriesPtr;     /* Code of a record */
+   eSdbRawFmt_t      *ChunkPtr;      /* Records read at once */
+   gzFile             InFile;        /* The Sdb file, read through zlib */
+   struct stat        Stat;          /* Size of the Sdb file */
+   char               Magic[ E_STD_FILE_HDR_SIZE ]; /* Header of the file */
+   Int32_t            Hour;          /* Time stamp of the file */
+   int                NumBytes;      /* Bytes read */
+   int                i;             /* Record of the chunk */
+
+   *NumCodesPtr = 0;
+
+   if ( BlockSize == 0 )
+   {
+      BlockSize = I_STD_IDX_DFLT_BLOCK;
+   }
+
+   /* zlib reads plain files as they are */
+   if ( ( stat( SdbFilePtr, &Stat ) != 0 ) ||
+        ( ( InFile = gzopen( SdbFilePtr, "rb" ) ) == NULL ) )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to open file %s", SdbFilePtr);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   memset( Magic, 0, sizeof( Magic ) );
+   if ( ( gzread( InFile, Magic, E_STD_FILE_HDR_SIZE ) != E_STD_FILE_HDR_SIZE ) ||
+        ( memcmp( Magic, E_SDB_HEADER_STRING, E_STD_FILE_HDR_SIZE ) != 0 ) ||
+        ( gzread( InFile, &Hour, sizeof( Hour ) ) != sizeof( Hour ) ) )
+   {
+      gzclose( InFile );
+      if ( memcmp( Magic, E_SDB_HEADER_STRING_V2, E_STD_FILE_HDR_SIZE ) == 0 )
+      {
+         eLogErr(E_STD_READ_HEAD_ERR,"File %s is block-structured, not indexed",
+                 SdbFilePtr);
+         return E_STD_READ_HEAD_ERR;
+      }
+      eLogErr(E_STD_READ_HEAD_ERR,"File %s is not an Sdb file", SdbFilePtr);
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   memset( &Table, 0, sizeof( Table ) );
+   ChunkPtr = (eSdbRawFmt_t *) TTL_MALLOC( sizeof( eSdbRawFmt_t ) * M_STD_IDX_CHUNK );
+   Status   = ChunkPtr == NULL ? E_STD_MEM_ALLOC_ERR : mStdSeriesGrow( &Table );
+
+   memset( &Header, 0, sizeof( Header ) );
+   memcpy( Header.Magic, I_STD_IDX_MAGIC, 4 );
+   Header.Version   = I_STD_IDX_VERSION;
+   Header.FileSize  = (Uint32_t) Stat.st_size;
+   Header.BlockSize = BlockSize;
+
+   /* A partial record at the end of the file is ignored, as by a search */
+   while ( Status == SYS_NOMINAL )
+   {
+      NumBytes = gzread( InFile, ChunkPtr, sizeof( eSdbRawFmt_t ) * M_STD_IDX_CHUNK );
+      if ( NumBytes < 0 )
+      {
+         Status = E_STD_READ_DATA_ERR;
+         eLogErr(Status,"Unable to read file %s", SdbFilePtr);
+         break;
+      }
+
+      for ( i = 0; ( i < NumBytes / (int) sizeof( eSdbRawFmt_t ) ) &&
+                   ( Status == SYS_NOMINAL ); i++ )
+      {
+         SeriesPtr = mStdSeriesFind( &Table, ChunkPtr[ i ].Code );
+         if ( SeriesPtr->Entry.NumRecords == 0 )
+         {
+            SeriesPtr->Entry.MinTime = ChunkPtr[ i ].TimeOffset;
+            SeriesPtr->Entry.MaxTime = ChunkPtr[ i ].TimeOffset;
+            Table.NumUsed++;
+         }
+         else if ( ChunkPtr[ i ].TimeOffset < SeriesPtr->Entry.MinTime )
+         {
+            SeriesPtr->Entry.MinTime = ChunkPtr[ i ].TimeOffset;
+         }
+         else if ( ChunkPtr[ i ].TimeOffset > SeriesPtr->Entry.MaxTime )
+         {
+            SeriesPtr->Entry.MaxTime = ChunkPtr[ i ].TimeOffset;
+         }
+         SeriesPtr->Entry.NumRecords++;
+
+         Status = mStdSeriesMark( SeriesPtr, Header.NumRecords / BlockSize );
+         Header.NumRecords++;
+
+         /* Keep the table no more than half full */
+         if ( ( Status == SYS_NOMINAL ) && ( 2 * Table.NumUsed > Table.Size ) )
+         {
+            Status = mStdSeriesGrow( &Table );
+         }
+      }
+
+      if ( NumBytes < (int) ( sizeof( eSdbRawFmt_t ) * M_STD_IDX_CHUNK ) )
+      {
+         break;
+      }
+   }
+
+   gzclose( InFile );
+   TTL_FREE( ChunkPtr );
+
+   if ( Status == SYS_NOMINAL )
+   {
+      Header.NumBlocks = ( Header.NumRecords + BlockSize - 1 ) / BlockSize;
+      Header.NumCodes  = Table.NumUsed;
+      Status = mStdWriteSdbIndex( &Table, &Header, SdbFilePtr );
+      *NumCodesPtr = Header.NumCodes;
+   }
+
+   mStdSeriesFree( &Table );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdSdbIndexSelect
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the blocks of an Sdb file holding the records wanted from it.
+**
+** Description:
+**    Looks up each of the codes wanted in the file's series index. The
+**    blocks of each code present with records in the time range wanted
+**    are combined into a single bitmap. No blocks are needed if none of
+**    the codes are present in the range.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if there is no
+**       index or it is out of date, E_STD_READ_HEAD_ERR if it is not
+**       valid or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    char            *SdbFilePtr   (in)
+**       Name of the Sdb file, plain or gzipped.
+**    eSdbCode_t      *CodesPtr     (in)
+**       Storage codes wanted.
+**    size_t           NumCodes     (in)
+**       Number of codes wanted.
+**    Uint32_t         NeedFrom     (in)
+**       Least TimeOffset wanted.
+**    Uint32_t         NeedTo       (in)
+**       Greatest TimeOffset wanted.
+**    iStdSdbBlocks_t *BlocksPtr    (out)
+**       The blocks needed, to be freed with iStdSdbBlocksFree.
+**
+*****************************************************************************/
+Status_t iStdSdbIndexSelect( char *SdbFilePtr,
+                             eSdbCode_t *CodesPtr,
+                             size_t NumCodes,
+                             Uint32_t NeedFrom,
+                             Uint32_t NeedTo,
+                             iStdSdbBlocks_t *BlocksPtr )
+{
+   iStdSdbIdxHeader_t Header;                    /* Header of the index */
+   iStdSdbIdxCode_t  *EntriesPtr;                /* Codes present */
+   iStdSdbIdxCode_t  *EntryPtr;                  /* Code wanted, if present */
+   iStdSdbIdxCode_t   Key;                       /* Code looked up */
+   Uint32_t          *WordsPtr;                  /* Bitmap of one code */
+   char               IndexFile[ FILENAME_MAX ]; /* Name of the index */
+   FILE              *IndexIn;                   /* The index */
+   struct stat        Stat;                      /* Size of the Sdb file */
+   size_t             NumWords;                  /* Words of a bitmap */
+   size_t             i;                         /* Code wanted */
+   size_t             j;                         /* Word of a bitmap */
+
+   memset( BlocksPtr, 0, sizeof( *BlocksPtr ) );
+
+   if ( strlen( SdbFilePtr ) + sizeof( I_STD_EXT_SDBINDEX ) > FILENAME_MAX )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+   mStdSdbIndexName( SdbFilePtr, IndexFile );
+
+   if ( ( IndexIn = fopen( IndexFile, "rb" ) ) == NULL )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   if ( ( fread( &Header, sizeof( Header ), 1, IndexIn ) != 1 ) ||
+        ( memcmp( Header.Magic, I_STD_IDX_MAGIC, 4 ) != 0 ) ||
+        ( Header.Version != I_STD_IDX_VERSION ) ||
+        ( Header.BlockSize == 0 ) ||
+        ( Header.NumBlocks != ( Header.NumRecords + Header.BlockSize - 1 )
+                              / Header.BlockSize ) )
+   {
+      fclose( IndexIn );
+      eLogWarning(E_STD_READ_HEAD_ERR,"Ignoring invalid index %s", IndexFile);
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   /* The Sdb file may have been added to, or replaced, since it was indexed */
+   if ( ( stat( SdbFilePtr, &Stat ) != 0 ) ||
+        ( (Uint32_t) Stat.st_size != Header.FileSize ) )
+   {
+      fclose( IndexIn );
+      eLogDebug("Ignoring out of date index %s", IndexFile);
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   NumWords   = ( Header.NumBlocks + 31 ) / 32;
+   EntriesPtr = (iStdSdbIdxCode_t *) TTL_MALLOC( sizeof( iStdSdbIdxCode_t ) * Header.NumCodes + 1 );
+   WordsPtr   = (Uint32_t *) TTL_MALLOC( sizeof( Uint32_t ) * NumWords + 1 );
+   BlocksPtr->Bitmap = (Uint32_t *) TTL_CALLOC( NumWords + 1, sizeof( Uint32_t ) );
+   if ( ( EntriesPtr == NULL ) || ( WordsPtr == NULL ) || ( BlocksPtr->Bitmap == NULL ) )
+   {
+      fclose( IndexIn );
+      TTL_FREE( EntriesPtr );
+      TTL_FREE( WordsPtr );
+      iStdSdbBlocksFree( BlocksPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if ( fread( EntriesPtr, sizeof( iStdSdbIdxCode_t ), Header.NumCodes, IndexIn )
+        != Header.NumCodes )
+   {
+      fclose( IndexIn );
+      TTL_FREE( EntriesPtr );
+      TTL_FREE( WordsPtr );
+      iStdSdbBlocksFree( BlocksPtr );
+      eLogWarning(E_STD_READ_HEAD_ERR,"Ignoring invalid index %s", IndexFile);
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   BlocksPtr->BlockSize = Header.BlockSize;
+   BlocksPtr->NumBlocks = Header.NumBlocks;
+
+   /* Combine the blocks of each code wanted within the time range */
+   for ( i = 0; i < NumCodes; i++ )
+   {
+      Key.Code = CodesPtr[ i ];
+      EntryPtr = (iStdSdbIdxCode_t *) bsearch( &Key, EntriesPtr, Header.NumCodes,
+                                               sizeof( iStdSdbIdxCode_t ),
+                                               mStdCompareCodes );
+      if ( ( EntryPtr == NULL ) ||
+           ( EntryPtr->MaxTime < NeedFrom ) || ( EntryPtr->MinTime > NeedTo ) )
+      {
+         continue;
+      }
+
+      if ( ( fseek( IndexIn, (long) ( sizeof( Header ) +
+                                      sizeof( iStdSdbIdxCode_t ) * Header.NumCodes +
+                                      sizeof( Uint32_t ) * NumWords *
+                                      (size_t) ( EntryPtr - EntriesPtr ) ),
+                    SEEK_SET ) != 0 ) ||
+           ( fread( WordsPtr, sizeof( Uint32_t ), NumWords, IndexIn ) != NumWords ) )
+      {
+         /* Can't tell which blocks hold the code, so all may */
+         memset( WordsPtr, 0xff, sizeof( Uint32_t ) * NumWords );
+      }
+
+      for ( j = 0; j < NumWords; j++ )
+      {
+         BlocksPtr->Bitmap[ j ] |= WordsPtr[ j ];
+      }
+   }
+
+   fclose( IndexIn );
+   TTL_FREE( EntriesPtr );
+   TTL_FREE( WordsPtr );
+
+   for ( i = 0; i < BlocksPtr->NumBlocks; i++ )
+   {
+      if ( I_STD_BLOCK_NEEDED( BlocksPtr, i ) )
+      {
+         BlocksPtr->NumNeeded++;
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdSdbBlocksRun
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Find the next run of records in blocks needed.
+**
+** Description:
+**    Finds the first needed block holding or following a record, and
+**    the needed blocks following it. If no bitmap is held every block
+**    is needed.
+**
+** Return type:
+**    Bool_t
+**       FALSE if no block holding or following the record is needed.
+**
+** Arguments:
+**    iStdSdbBlocks_t *BlocksPtr   (in)
+**       Blocks needed.
+**    Uint32_t         Record      (in)
+**       Record of the file to start from.
+**    Uint32_t        *StartPtr    (out)
+**       First record of the run, Record or later.
+**    Uint32_t        *EndPtr      (out)
+**       Record following the run, which may be past the end of the file.
+**
+*****************************************************************************/
+Bool_t iStdSdbBlocksRun( iStdSdbBlocks_t *BlocksPtr,
+                         Uint32_t Record,
+                         Uint32_t *StartPtr,
+                         Uint32_t *EndPtr )
+{
+   Uint32_t Block;   /* Block being checked */
+
+   if ( BlocksPtr->Bitmap == NULL )
+   {
+      *StartPtr = Record;
+      *EndPtr   = 0xffffffff;
+      return TRUE;
+   }
+
+   Block = Record / BlocksPtr->BlockSize;
+   while ( ( Block < BlocksPtr->NumBlocks ) &&
+           ( I_STD_BLOCK_NEEDED( BlocksPtr, Block ) == FALSE ) )
+   {
+      Block++;
+   }
+   if ( Block >= BlocksPtr->NumBlocks )
+   {
+      return FALSE;
+   }
+
+   *StartPtr = Block * BlocksPtr->BlockSize;
+   if ( *StartPtr < Record )
+   {
+      *StartPtr = Record;
+   }
+
+   while ( ( Block < BlocksPtr->NumBlocks ) &&
+           ( I_STD_BLOCK_NEEDED( BlocksPtr, Block ) == TRUE ) )
+   {
+      Block++;
+   }
+   *EndPtr = Block * BlocksPtr->BlockSize;
+
+   return TRUE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdSdbBlocksFree
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Free the bitmap of blocks found by iStdSdbIndexSelect.
+**
+** Description:
+**    Every block is then taken to be needed.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdSdbBlocks_t *BlocksPtr   (in/out)
+**       The blocks.
+**
+*****************************************************************************/
+void iStdSdbBlocksFree( iStdSdbBlocks_t *BlocksPtr )
+{
+   TTL_FREE( BlocksPtr->Bitmap );
+   BlocksPtr->Bitmap = NULL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSeriesFind
+**
+** Type:
+**    mStdSeries_t *
+**
+** Purpose:
+**    Find the slot for a storage code being indexed.
+**
+** Description:
+**    Probes from the code's hash until the code, or an unused slot for
+**    it, is found. The table must have an unused slot.
+**
+** Return type:
+**    mStdSeries_t *
+**       The slot, unused if the code hasn't been seen before.
+**
+** Arguments:
+**    mStdSeriesTable_t *TablePtr   (in)
+**       Codes being indexed.
+**    eSdbCode_t         Code       (in)
+**       Storage code of a record.
+**
+*****************************************************************************/
+static mStdSeries_t *mStdSeriesFind( mStdSeriesTable_t *TablePtr, eSdbCode_t Code )
+{
+   mStdSeries_t *SeriesPtr;   /* Slot being probed */
+   Uint32_t      Slot;        /* Index of the slot */
+
+   Slot = (Uint32_t) ( Code * M_STD_HASH_MULT ) >> TablePtr->Shift;
+   for ( ; ; )
+   {
+      SeriesPtr = TablePtr->Slots + Slot;
+      if ( ( SeriesPtr->Entry.NumRecords == 0 ) || ( SeriesPtr->Entry.Code == Code ) )
+      {
+         SeriesPtr->Entry.Code = Code;
+         return SeriesPtr;
+      }
+      Slot = ( Slot + 1 ) & ( TablePtr->Size - 1 );
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSeriesGrow
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Double the slots of the table of codes being indexed.
+**
+** Description:
+**    Allocates M_STD_MIN_SLOTS slots if the table is empty, otherwise
+**    moves the codes into a table of twice the size.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdSeriesTable_t *TablePtr   (in/out)
+**       Codes being indexed.
+**
+*****************************************************************************/
+static Status_t mStdSeriesGrow( mStdSeriesTable_t *TablePtr )
+{
+   mStdSeriesTable_t Old;     /* Table being replaced */
+   Uint32_t          i;       /* Slot of the old table */
+
+   Old = *TablePtr;
+
+   if ( Old.Size == 0 )
+   {
+      TablePtr->Size  = M_STD_MIN_SLOTS;
+      TablePtr->Shift = 24;
+   }
+   else
+   {
+      TablePtr->Size  = Old.Size * 2;
+      TablePtr->Shift = Old.Shift - 1;
+   }
+
+   TablePtr->Slots = (mStdSeries_t *) TTL_CALLOC( TablePtr->Size, sizeof( mStdSeries_t ) );
+   if ( TablePtr->Slots == NULL )
+   {
+      *TablePtr = Old;
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   for ( i = 0; i < Old.Size; i++ )
+   {
+      if ( Old.Slots[ i ].Entry.NumRecords > 0 )
+      {
+         *mStdSeriesFind( TablePtr, Old.Slots[ i ].Entry.Code ) = Old.Slots[ i ];
+      }
+   }
+
+   TTL_FREE( Old.Slots );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSeriesMark
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Note that a block holds a record of a code.
+**
+** Description:
+**    The code's bitmap is extended as the blocks of the file are read.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdSeries_t *SeriesPtr   (in/out)
+**       The code.
+**    Uint32_t      Block       (in)
+**       Block holding one of its records.
+**
+*****************************************************************************/
+static Status_t mStdSeriesMark( mStdSeries_t *SeriesPtr, Uint32_t Block )
+{
+   Uint32_t *NewPtr;     /* Extended bitmap */
+   Uint32_t  NumWords;   /* Size of the extended bitmap */
+
+   if ( ( Block >> 5 ) >= SeriesPtr->NumWords )
+   {
+      NumWords = SeriesPtr->NumWords == 0 ? 4 : SeriesPtr->NumWords;
+      while ( ( Block >> 5 ) >= NumWords )
+      {
+         NumWords *= 2;
+      }
+
+      NewPtr = (Uint32_t *) TTL_REALLOC( SeriesPtr->Bitmap, sizeof( Uint32_t ) * NumWords );
+      if ( NewPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      memset( NewPtr + SeriesPtr->NumWords, 0,
+              sizeof( Uint32_t ) * ( NumWords - SeriesPtr->NumWords ) );
+
+      SeriesPtr->Bitmap   = NewPtr;
+      SeriesPtr->NumWords = NumWords;
+   }
+
+   SeriesPtr->Bitmap[ Block >> 5 ] |= 1U << ( Block & 31 );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSeriesFree
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Free the table of codes being indexed.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    mStdSeriesTable_t *TablePtr   (in/out)
+**       Codes being indexed.
+**
+*****************************************************************************/
+static void mStdSeriesFree( mStdSeriesTable_t *TablePtr )
+{
+   Uint32_t i;   /* Slot of the table */
+
+   for ( i = 0; i < TablePtr->Size; i++ )
+   {
+      TTL_FREE( TablePtr->Slots[ i ].Bitmap );
+   }
+   TTL_FREE( TablePtr->Slots );
+
+   memset( TablePtr, 0, sizeof( *TablePtr ) );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdWriteSdbIndex
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write the series index of an Sdb file.
+**
+** Description:
+**    Sorts the codes found and writes them, then their bitmaps, to a
+**    temporary file which replaces any existing index once complete, so
+**    a search never sees a partly written index.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_WRITE_ERR or
+**       E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdSeriesTable_t  *TablePtr    (in/out)
+**       Codes found, which are sorted.
+**    iStdSdbIdxHeader_t *HeaderPtr   (in)
+**       Header of the index.
+**    char               *SdbFilePtr  (in)
+**       Name of the Sdb file.
+**
+*****************************************************************************/
+static Status_t mStdWriteSdbIndex( mStdSeriesTable_t  *TablePtr,
+                                   iStdSdbIdxHeader_t *HeaderPtr,
+                                   char               *SdbFilePtr )
+{
+   char          IndexFile[ FILENAME_MAX ];     /* Name of the index */
+   char          TempFile[ FILENAME_MAX + 8 ];  /* Name while being written */
+   FILE         *OutFile;                       /* Index being written */
+   mStdSeries_t *SeriesPtr;                     /* Code being written */
+   mStdSeries_t  Swap;                          /* Code being moved */
+   Uint32_t      NumWords;                      /* Words of each bitmap */
+   Uint32_t      Zero;                          /* Padding of a bitmap */
+   Uint32_t      i;                             /* Code being written */
+   Uint32_t      j;                             /* Word of its bitmap */
+   Bool_t        Ok;                            /* All written */
+
+   if ( strlen( SdbFilePtr ) + sizeof( I_STD_EXT_SDBINDEX ) > FILENAME_MAX )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+   mStdSdbIndexName( SdbFilePtr, IndexFile );
+   sprintf( TempFile, "%s.tmp", IndexFile );
+
+   /* Gather the codes in use at the start of the table, in order */
+   SeriesPtr = TablePtr->Slots;
+   for ( i = 0; i < TablePtr->Size; i++ )
+   {
+      if ( TablePtr->Slots[ i ].Entry.NumRecords > 0 )
+      {
+         Swap       = *SeriesPtr;
+         *SeriesPtr = TablePtr->Slots[ i ];
+         TablePtr->Slots[ i ] = Swap;
+         SeriesPtr++;
+      }
+   }
+   qsort( TablePtr->Slots, TablePtr->NumUsed, sizeof( mStdSeries_t ), mStdCompareCodes );
+
+   if ( ( OutFile = fopen( TempFile, "wb" ) ) == NULL )
+   {
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to open file %s", TempFile);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   Ok = fwrite( HeaderPtr, sizeof( iStdSdbIdxHeader_t ), 1, OutFile ) == 1;
+   for ( i = 0; ( i < TablePtr->NumUsed ) && Ok; i++ )
+   {
+      Ok = fwrite( &(TablePtr->Slots[ i ].Entry), sizeof( iStdSdbIdxCode_t ), 1,
+                   OutFile ) == 1;
+   }
+
+   /* Bitmaps are all the same size, of every block in the file */
+   NumWords = ( HeaderPtr->NumBlocks + 31 ) / 32;
+   Zero     = 0;
+   for ( i = 0; ( i < TablePtr->NumUsed ) && Ok; i++ )
+   {
+      SeriesPtr = TablePtr->Slots + i;
+      for ( j = 0; ( j < NumWords ) && Ok; j++ )
+      {
+         Ok = fwrite( j < SeriesPtr->NumWords ? SeriesPtr->Bitmap + j : &Zero,
+                      sizeof( Uint32_t ), 1, OutFile ) == 1;
+      }
+   }
+
+   if ( ( fclose( OutFile ) != 0 ) || !Ok ||
+        ( rename( TempFile, IndexFile ) != 0 ) )
+   {
+      remove( TempFile );
+      eLogErr(E_STD_FILE_WRITE_ERR,"Unable to write index %s", IndexFile);
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSdbIndexName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Generate the name of the series index of an Sdb file.
+**
+** Description:
+**    A plain file and its compressed versions share an index name.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    char *SdbFilePtr     (in)
+**       Name of the Sdb file, plain or compressed.
+**    char *IndexFilePtr   (out)
+**       Name of its index, FILENAME_MAX characters.
+**
+*****************************************************************************/
+static void mStdSdbIndexName( char *SdbFilePtr, char *IndexFilePtr )
+{
+   size_t Len;   /* Length of the name, less any .gz or .bgz */
+
+   Len = strlen( SdbFilePtr );
+   if ( ( Len >= strlen( I_STD_EXT_GZIP ) ) &&
+        ( strcmp( SdbFilePtr + Len - strlen( I_STD_EXT_GZIP ), I_STD_EXT_GZIP ) == 0 ) )
+   {
+      Len -= strlen( I_STD_EXT_GZIP );
+   }
+   else if ( ( Len >= strlen( I_STD_EXT_BGZF ) ) &&
+             ( strcmp( SdbFilePtr + Len - strlen( I_STD_EXT_BGZF ), I_STD_EXT_BGZF ) == 0 ) )
+   {
+      Len -= strlen( I_STD_EXT_BGZF );
+   }
+
+   memcpy( IndexFilePtr, SdbFilePtr, Len );
+   strcpy( IndexFilePtr + Len, I_STD_EXT_SDBINDEX );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCompareCodes
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Order entries of a series index by storage code.
+**
+** Description:
+**    Used with qsort and bsearch. The code is the first member of both
+**    iStdSdbIdxCode_t and mStdSeries_t.
+**
+** Return type:
+**    int
+**       Negative, zero or positive as the first code is less than, equal
+**       to or greater than the second.
+**
+** Arguments:
+**    const void *FirstPtr    (in)
+**    const void *SecondPtr   (in)
+**       Entries compared.
+**
+*****************************************************************************/
+static int mStdCompareCodes( const void *FirstPtr, const void *SecondPtr )
+{
+   eSdbCode_t First;    /* Code of the first entry */
+   eSdbCode_t Second;   /* Code of the second entry */
+
+   First  = ( (const iStdSdbIdxCode_t *) FirstPtr )->Code;
+   Second = ( (const iStdSdbIdxCode_t *) SecondPtr )->Code;
+
+   if ( First < Second )
+   {
+      return -1;
+   }
+
+   return First > Second ? 1 : 0;
+}
+
+/* EOF */
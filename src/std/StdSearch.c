@@ -0,0 +1,675 @@
+/*****************************************************************************
+** Module Name:
+**     StdSearch.c
+**
+** Purpose:
+**     Search the Sdb files for every output, and write out what is found.
+**
+** Description:
+**     The steps of a single extraction, from setting up the outputs read
+**     from the configuration files to writing out the data found for
+**     them. They are used by Std run once from the command line and, for
+**     each request in turn, by a worker serving extraction requests.
+**
+**     The hours of the search are read one after another, or shared out
+**     between threads when there are threads to spare (see StdThread.c).
+**
+**     Given the rollup switch, every record decoded is also fed to the
+**     rollup archive, so each whole day searched is rolled up without
+**     its Sdb files being read a second time (see StdRollup.c). Every
+**     storage code is then read, not just those wanted by the outputs.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+/* The day being rolled up as the Sdb files are searched */
+typedef struct mStdRollup_s
+{
+   eStdRollupFeed_t *FeedPtr;    /* Day being fed, NULL if none */
+   eTtlTime_t        StartTime;  /* Start of the search */
+   eTtlTime_t        StopTime;   /* End of the search */
+   eTtlTime_t        DayStart;   /* Start of the day last met */
+   eTtlTime_t        DayEnd;     /* Start of the day after it */
+} mStdRollup_t;
+
+/* Local variables */
+static mStdRollup_t mStdRollup;
+
+/* Local function prototypes */
+static Status_t mStdSearchHours ( eTtlTime_t StartTime, eTtlTime_t StopTime );
+static void     mStdRollupFinish ( Bool_t Write );
+
+/*****************************************************************************
+** Function Name:
+**    iStdSearchSetup
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Prepare every output to be searched for.
+**
+** Description:
+**    The names and identifiers of the source/datum pairs are completed,
+**    each output's file is opened, unless it already has a stream to be
+**    written to, and its header written. The search times of the outputs
+**    are converted, and the lookup from storage codes to the columns of
+**    the outputs built.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or the first error met.
+**
+** Arguments:
+**    eTtlTime_t *StartTimePtr  (out)
+**       Earliest start time of the outputs.
+**    eTtlTime_t *StopTimePtr   (out)
+**       Latest stop time of the outputs.
+**
+*****************************************************************************/
+Status_t iStdSearchSetup ( eTtlTime_t *StartTimePtr, eTtlTime_t *StopTimePtr )
+{
+   Status_t       Status;       /* Return value of function calls */
+   iStdOutput_t  *OutputPtr;    /* Output being set up */
+   iStdData_t    *StdDataPtr;   /* Pointer to requested data id's */
+   Int32_t        i;            /* Counter */
+   Int32_t        k;            /* Counter stepping through outputs */
+
+   for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+   {
+      OutputPtr = iStdGlobVar.Outputs + k;
+
+      /* Each summary of a stride has a column of its own */
+      Status = iStdExpandAggs ( OutputPtr );
+      if( SYS_NOMINAL != Status )
+      {
+         eLogErr(Status, "Error making room for summaries");
+         return Status;
+      }
+
+      /* Work out Datum/Source name from Datum/Source Id */
+      Status = iStdSrcDtmName ( OutputPtr );
+      if( SYS_NOMINAL != Status )
+      {
+         eLogErr(Status, "Error getting source/datum names/id's");
+         return Status;
+      }
+
+      /* Open the output file for writing tab formatted data to */
+      if( OutputPtr->OutFilePtr == NULL )
+      {
+         OutputPtr->OutFilePtr = fopen(OutputPtr->OutFile,"w");
+         if( OutputPtr->OutFilePtr == NULL)
+         {
+            eLogErr(E_STD_FILE_WRITE_ERR,"Error: unable to open output file %s",
+                    OutputPtr->OutFile);
+            return E_STD_FILE_WRITE_ERR;
+         }
+      }
+
+      Status = iStdWriteHeader( OutputPtr );
+      if( SYS_NOMINAL != Status )
+      {
+         eLogErr(Status, "Error writing to output file");
+      }
+
+      /*
+      ** Work out the start and stop times i.e. convert the
+      ** start and stop times read from the configuration file
+      ** as a string into Ttl time format.
+      */
+      Status = iStdStartStopTime( OutputPtr );
+
+      /* Set the initial 'next stride' time to be the start time */
+      StdDataPtr = OutputPtr->StdData;
+      for(i=0; i<OutputPtr->NumDataSearch; i++)
+      {
+         memcpy( &( (StdDataPtr+i)->NextStrideTime ), &OutputPtr->TtlStartTime,
+                 sizeof( (StdDataPtr+i)->NextStrideTime ) );
+      }
+
+      /* The Sdb files are read once to cover the range of every output */
+      if ( ( k == 0 ) || ( OutputPtr->TtlStartTime.t_sec < StartTimePtr->t_sec ) )
+      {
+         *StartTimePtr = OutputPtr->TtlStartTime;
+      }
+      if ( ( k == 0 ) || ( OutputPtr->TtlStopTime.t_sec > StopTimePtr->t_sec ) )
+      {
+         *StopTimePtr = OutputPtr->TtlStopTime;
+      }
+   }
+
+   /* Work out which output columns each storage code is routed to */
+   Status = iStdLookupBuild ( );
+   if( SYS_NOMINAL != Status )
+   {
+      eLogErr(Status, "Error building source/datum lookup");
+      return Status;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdSearch
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Search the Sdb files between two times for every output.
+**
+** Description:
+**    Several hours are searched at once if there are threads to spare,
+**    otherwise the hours are searched one after another. The outputs
+**    must have been set up with iStdSearchSetup. A day fed to the rollup
+**    archive is only written once the search has succeeded.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or the first error met.
+**
+** Arguments:
+**    eTtlTime_t StartTime      (in)
+**       Start of the search.
+**    eTtlTime_t StopTime       (in)
+**       End of the search.
+**
+*****************************************************************************/
+Status_t iStdSearch ( eTtlTime_t StartTime, eTtlTime_t StopTime )
+{
+   Status_t Status;   /* Return value of function calls */
+
+   mStdRollup.FeedPtr       = NULL;
+   mStdRollup.StartTime     = StartTime;
+   mStdRollup.StopTime      = StopTime;
+   mStdRollup.DayEnd.t_sec  = 0;
+   mStdRollup.DayEnd.t_nsec = 0;
+
+   if ( ( iStdGlobVar.NumThreads > 1 ) &&
+        ( StopTime.t_sec / E_STD_SECONDS_PER_HOUR > StartTime.t_sec / E_STD_SECONDS_PER_HOUR ) )
+   {
+      Status = iStdSearchThreaded( StartTime, StopTime );
+   }
+   else
+   {
+      Status = mStdSearchHours( StartTime, StopTime );
+   }
+
+   mStdRollupFinish( Status == SYS_NOMINAL ? TRUE : FALSE );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdSearchWrite
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write out the data found for every output, and close the outputs.
+**
+** Description:
+**    The data of each output is put into time order and written to its
+**    file, which is then closed, and a summary of what was found logged.
+**    A failure to write one output does not stop the others being
+**    written.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_WRITE_ERR if an output
+**       could not be written, or the error sorting an output.
+**
+** Arguments:
+**    Bool_t Screen             (in)
+**       Whether the data is also logged, row by row.
+**
+*****************************************************************************/
+Status_t iStdSearchWrite ( Bool_t Screen )
+{
+   Status_t       Status;             /* Return value of function calls */
+   Status_t       WriteStatus;        /* First output that failed to be written */
+   iStdOutput_t  *OutputPtr;          /* Output being written */
+   iStdData_t    *StdDataPtr;         /* Pointer to requested data id's */
+   Int32_t        j;                  /* Column of source/datum pair */
+   Int32_t        k;                  /* Counter stepping through outputs */
+
+   WriteStatus = SYS_NOMINAL;
+
+   for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+   {
+      OutputPtr  = iStdGlobVar.Outputs + k;
+      StdDataPtr = OutputPtr->StdData;
+
+      /* Print the data if we have any */
+      if( OutputPtr->LinesOfData > 0 )
+      {
+
+         /* Put the data into time order */
+         Status = iStdSortData ( OutputPtr );
+         if( SYS_NOMINAL != Status )
+         {
+            eLogErr(Status, "Error sorting data.");
+            return Status;
+         }
+
+         /* Summarise each stride, if asked to */
+         if ( iStdGlobVar.Window > 0 )
+         {
+            Status = iStdAggregate ( OutputPtr, TRUE );
+            if( SYS_NOMINAL != Status )
+            {
+               eLogErr(Status, "Error summarising data.");
+               return Status;
+            }
+         }
+
+         if( Screen )
+         {
+            Status = iStdWriteToScreen ( OutputPtr );
+            if( SYS_NOMINAL != Status )
+            {
+               eLogErr(Status, "Error writing to screen.");
+            }
+         }
+
+         /* Output the data to disk */
+         Status = iStdWriteToFile ( OutputPtr );
+         if( SYS_NOMINAL != Status )
+         {
+            eLogErr(Status, "Error writing data to file.");
+            WriteStatus = E_STD_FILE_WRITE_ERR;
+         }
+
+      }
+
+      /* Close the output file */
+      if( fclose( OutputPtr->OutFilePtr ) != 0 )
+      {
+         WriteStatus = E_STD_FILE_WRITE_ERR;
+      }
+      OutputPtr->OutFilePtr = NULL;
+
+      /* Output summary of data retrieved */
+      for ( j=0; j < OutputPtr->NumDataSearch; j++ )
+      {
+         eLogNotice( 0, "Retrieved %6d entries for %s, %s",
+                     (StdDataPtr+j)->NumOfPoints,
+                     (StdDataPtr+j)->SourceName,
+                     (StdDataPtr+j)->DatumName );
+      }
+      eLogNotice( 0, "Retrieved %6d data entries in total for %s",
+                  OutputPtr->LinesOfData, OutputPtr->OutFile );
+   }
+
+   return WriteStatus;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSearchHours
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Search the Sdb files between two times, one hour after another.
+**
+** Description:
+**    Each record routed to a column of an output, and within the time
+**    range of that output, is stored in the column, subject to the
+**    stride.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or the first error met.
+**
+** Arguments:
+**    eTtlTime_t StartTime      (in)
+**       Start of the search.
+**    eTtlTime_t StopTime       (in)
+**       End of the search.
+**
+*****************************************************************************/
+static Status_t mStdSearchHours ( eTtlTime_t StartTime, eTtlTime_t StopTime )
+{
+   Status_t       Status;                          /* Function return status */
+   eTtlTime_t     TimeStamp;                       /* Timestamp of current Sdb datum */
+   eStdReader_t  *ReaderPtr;                       /* Retrieval of Sdb data */
+   eSdbRawFmt_t  *SdbDataPtr;                      /* Pointer to chunk of Sdb data */
+   eSdbRawFmt_t  *SdbLinePtr;                      /* Current line of Sdb */
+   Bool_t         Finished;                        /* Flag to indicate search has finished */
+   Int32_t        Value;                           /* Value of datum retrieved from Sdb */
+   Int32_t        j;                               /* Column of source/datum pair */
+   Int32_t        CurrentLine = 0;                 /* Current line of Sdb chunk */
+   iStdOutput_t  *OutputPtr;                       /* Output being searched for */
+   iStdTarget_t  *TargetPtr;                       /* Output column routed to */
+   Int32_t        Target;                          /* Index of TargetPtr */
+   iStdData_t    *StdDataPtr;                      /* Pointer to requested data id's */
+   size_t         NumRecords = 0;                  /* Number of records retrieved. */
+   char           TimeStr[E_STD_MAX_STRING_LEN];   /* String to contain timestamp */
+   eTtlTime_t     HourTime;                        /* Hour of the records retrieved */
+   Int32_t        SummedHour = -1;                 /* Hour whose records are being summarised */
+   Int32_t        k;                               /* Counter stepping through outputs */
+   Bool_t         RollUp;                          /* Every record is rolled up */
+
+   Status = eStdReaderOpen( StartTime, StopTime, iStdGlobVar.DatPath, &ReaderPtr );
+   if( SYS_NOMINAL != Status )
+   {
+      return Status;
+   }
+
+   /* The rollup needs every record, not just those wanted */
+   RollUp = ( iStdGlobVar.RollupDir[0] != '\0' ) ? TRUE : FALSE;
+
+   Status = eStdReaderChunk( ReaderPtr, iStdGlobVar.ChunkSize );
+   if( ( SYS_NOMINAL == Status ) && ( RollUp == FALSE ) )
+   {
+      Status = eStdReaderCodes( ReaderPtr, iStdGlobVar.Lookup.Wanted,
+                                iStdGlobVar.Lookup.NumCodes );
+   }
+   if( SYS_NOMINAL == Status )
+   {
+      Status = eStdReaderCatalog( ReaderPtr, iStdGlobVar.CatalogPtr );
+   }
+   if( SYS_NOMINAL == Status )
+   {
+      Status = eStdReaderColumns( ReaderPtr, iStdGlobVar.ColumnsPtr );
+   }
+   if( SYS_NOMINAL == Status )
+   {
+      Status = eStdReaderFiles( ReaderPtr, iStdGlobVar.FilesPtr );
+   }
+
+   Finished = FALSE;
+   while( ( SYS_NOMINAL == Status ) && !Finished )
+   {
+      /* Reset the line index */
+      CurrentLine = 0;
+
+      /* Retrieve the next span of Sdb data, mapped in place where possible */
+      Status = eStdReaderNext( ReaderPtr, &SdbDataPtr, &NumRecords, &Finished );
+      if( SYS_NOMINAL != Status )
+      {
+         break;
+      }
+      if (Finished)
+      {
+        eLogDebug("Retrieved data. Finshed flag is TRUE");
+      }
+      else
+      {
+        eLogDebug("Retrieved data. Finshed flag is FALSE");
+      }
+
+      /* The records are all of one hour's file, which may start a day */
+      if( ( RollUp == TRUE ) && ( NumRecords > 0 ) )
+      {
+         eStdReaderHour( ReaderPtr, &HourTime );
+         iStdRollupHour( HourTime );
+      }
+
+      /* Strides are summarised an hour at a time, so few samples are held */
+      if( ( iStdGlobVar.Window > 0 ) && ( NumRecords > 0 ) )
+      {
+         eStdReaderHour( ReaderPtr, &HourTime );
+         if( HourTime.t_sec != SummedHour )
+         {
+            for( k = 0; ( SYS_NOMINAL == Status ) && ( k < iStdGlobVar.NumOutputs ); k++ )
+            {
+               Status = iStdSummariseData( iStdGlobVar.Outputs + k );
+            }
+            SummedHour = HourTime.t_sec;
+         }
+      }
+
+      /* Loop through each line of the returned Sdb data */
+      while( ( SYS_NOMINAL == Status ) && ( CurrentLine < (int) NumRecords ) )
+      {
+         SdbLinePtr = SdbDataPtr + CurrentLine;
+         CurrentLine++;
+
+         /*
+         ** Check to see if this line matches any of the source datum
+         ** pairs specified in the configuration files
+         */
+         Target = iStdLookupFind( SdbLinePtr->Code );
+         if( ( Target < 0 ) && ( RollUp == FALSE ) )
+         {
+            continue;
+         }
+
+         /* Only now is the time stamp of the line worth calculating */
+         Status = eStdReaderTime( ReaderPtr, SdbLinePtr, &TimeStamp );
+         if( SYS_NOMINAL != Status )
+         {
+            eLogErr(Status,"Error searching data");
+            break;
+         }
+         Value = SdbLinePtr->Value;
+
+         if( RollUp == TRUE )
+         {
+            iStdRollupAdd( SdbLinePtr->Code, TimeStamp, Value );
+         }
+
+         /* Route the line to every output column requesting it */
+         for( ; Target >= 0; Target = TargetPtr->Next )
+         {
+            TargetPtr  = iStdGlobVar.Lookup.Targets + Target;
+            OutputPtr  = iStdGlobVar.Outputs + TargetPtr->Output;
+            StdDataPtr = OutputPtr->StdData;
+            j          = TargetPtr->Column;
+
+            /* Check to see if data is within time range we want */
+            if( ( TimeStamp.t_sec < OutputPtr->TtlStartTime.t_sec ) ||
+                ( TimeStamp.t_sec > OutputPtr->TtlStopTime.t_sec ) )
+            {
+               continue;
+            }
+
+            /*
+            ** Only store this datum if it's the first following the start of
+            ** a new 'stride' for a given datum. If so we save it to allow us
+            ** to print all source/datum pairs with the same timestamp at a
+            ** later date
+            */
+            if ( TimeStamp.t_sec >= (StdDataPtr+j)->NextStrideTime.t_sec )
+            {
+               /* Increment the next-stride-time by the stride, could be 0 */
+               (StdDataPtr+j)->NextStrideTime.t_sec += iStdGlobVar.Stride;
+
+               /* The time of datum is only worth converting if it is logged */
+               if ( eCluCommon.DebugLevel >= E_LOG_INFO )
+               {
+                  iStdFormatTimeString( &TimeStamp, TimeStr );
+                  eLogInfo("Got data match. Writing data %s %d",TimeStr,Value);
+               }
+
+               /* Store the datum in its column, sorted later */
+               Status = iStdStoreData( OutputPtr, TimeStamp, j, Value );
+               if( Status != SYS_NOMINAL)
+               {
+                  eLogErr(Status,"Error storing matching data.");
+                  break;
+               }
+               else
+               {
+                  OutputPtr->LinesOfData++;
+                  (StdDataPtr+j)->NumOfPoints++;
+               }
+            }
+
+         }/* End of target for loop */
+
+      }/* End of CurrentLine while loop */
+
+   }
+
+   eStdReaderClose( ReaderPtr );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdRollupHour
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Tell the rollup archive the hour of the records about to be fed.
+**
+** Description:
+**    Hours are met in order. The first hour of a day finishes the day
+**    before, writing its file, and starts the new day, if it is searched
+**    from start to end, so only whole days are rolled up. Records of a
+**    day not being rolled up are passed over by iStdRollupAdd.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eTtlTime_t Hour           (in)
+**       Any time of the hour of the Sdb file the records are from.
+**
+*****************************************************************************/
+void iStdRollupHour ( eTtlTime_t Hour )
+{
+   Status_t Status;   /* Return value of function calls */
+
+   /* Still the day last met */
+   if ( Hour.t_sec < mStdRollup.DayEnd.t_sec )
+   {
+      return;
+   }
+
+   mStdRollupFinish( TRUE );
+
+   eStdRollupDay( Hour, &mStdRollup.DayStart, &mStdRollup.DayEnd );
+   if ( ( mStdRollup.DayStart.t_sec < mStdRollup.StartTime.t_sec ) ||
+        ( mStdRollup.DayEnd.t_sec - 1 > mStdRollup.StopTime.t_sec ) )
+   {
+      return;
+   }
+
+   /* Without the rollup the search still succeeds */
+   Status = eStdRollupStart( iStdGlobVar.RollupDir, Hour, &mStdRollup.FeedPtr );
+   if ( ( Status != SYS_NOMINAL ) && ( Status != E_STD_TIME_OUT_RANGE ) )
+   {
+      eLogWarning(Status,"Unable to roll up day into %s",iStdGlobVar.RollupDir);
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdRollupAdd
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Feed a record decoded while searching to the rollup archive.
+**
+** Description:
+**    The record is passed over unless its day is being rolled up. A day
+**    that cannot be fed every record is abandoned, without being written.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eSdbCode_t Code           (in)
+**       Storage code of the record.
+**    eTtlTime_t TimeStamp      (in)
+**       Time of the record.
+**    Int32_t    Value          (in)
+**       Value of the record.
+**
+*****************************************************************************/
+void iStdRollupAdd ( eSdbCode_t Code, eTtlTime_t TimeStamp, Int32_t Value )
+{
+   Status_t Status;   /* Return value of function calls */
+
+   if ( mStdRollup.FeedPtr == NULL )
+   {
+      return;
+   }
+
+   Status = eStdRollupAdd( mStdRollup.FeedPtr, Code, TimeStamp, Value );
+   if ( Status != SYS_NOMINAL )
+   {
+      eLogWarning(Status,"Unable to roll up day into %s",iStdGlobVar.RollupDir);
+      mStdRollupFinish( FALSE );
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRollupFinish
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Finish the day being rolled up, if there is one.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    Bool_t Write              (in)
+**       Whether the day's file is written, or the day abandoned.
+**
+*****************************************************************************/
+static void mStdRollupFinish ( Bool_t Write )
+{
+   Status_t Status;                         /* Return value of function calls */
+   Uint32_t NumCodes;                       /* Storage codes of the day */
+   Uint32_t NumRecords;                     /* Records of the day */
+   char     TimeStr[ E_STD_MAX_STRING_LEN ]; /* Start of the day */
+
+   if ( mStdRollup.FeedPtr == NULL )
+   {
+      return;
+   }
+
+   Status = eStdRollupFinish( mStdRollup.FeedPtr, Write, &NumCodes, &NumRecords );
+   mStdRollup.FeedPtr = NULL;
+
+   if ( Write == FALSE )
+   {
+      return;
+   }
+
+   iStdFormatTimeString( &mStdRollup.DayStart, TimeStr );
+   if ( Status != SYS_NOMINAL )
+   {
+      eLogWarning(Status,"Unable to roll up day from %s",TimeStr);
+   }
+   else
+   {
+      eLogNotice(0,"Rolled up %lu records of %lu storage codes from %s",
+                 (unsigned long) NumRecords, (unsigned long) NumCodes, TimeStr);
+   }
+}
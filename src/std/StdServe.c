@@ -0,0 +1,592 @@
+/*****************************************************************************
+** Module Name:
+**     StdServe.c
+**
+** Purpose:
+**     Serve extraction requests on a local UNIX socket.
+**
+** Description:
+**     Run once per extraction, Std starts up, reads the CIL map and ID
+**     tables for every source/datum pair and opens any catalog and
+**     columnar archive each time. Serving, it does so only once, and a
+**     pool of worker processes forked from it then answers requests for
+**     as long as it runs. The names and identifiers looked up by a worker
+**     are kept for the requests it serves later, and the Sdb files of
+**     the hours read recently are left cached by the system.
+**
+**     A request is the text of a configuration file, written to the
+**     socket and ended by a line "END" or by the client shutting down
+**     its side of the connection. It must give its start and stop times
+**     and the data to search for, or it fails.
+**     Its output file is ignored, the data found being written back on
+**     the same connection once the search is done, after which the
+**     connection is closed. A line "FORMAT text|matlab|gnuplot|long|binary|
+**     influx [measurement]" chooses the format of the data, the format given on
+**     the command line being used otherwise. A request that fails ends
+**     with a line "ERROR <status>".
+**
+**     Each worker serves one request at a time, searching its hours with
+**     as many threads as a single run of Std would. Workers that die are
+**     replaced. Std stops serving on SIGINT or SIGTERM, stopping the
+**     workers and removing the socket.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+#define M_STD_SERVE_TEMP   "/tmp/StdRequestXXXXXX" /* Request as a configuration file */
+#define M_STD_SERVE_SEPS   " ,\t\r\n"              /* Separate the words of a line */
+
+/* Output format given on the command line, used unless a request says */
+typedef struct mStdFormat_s
+{
+   Bool_t       WriteMatlab;
+   Bool_t       WriteGnuplot;
+   Bool_t       WriteInflux;
+   Bool_t       WriteLong;
+   Bool_t       WriteBinary;
+   char         Measurement[ I_STD_MAX_MEASURE ];
+} mStdFormat_t;
+
+/* Local variables */
+static volatile sig_atomic_t mStdStopped = 0;   /* Set once asked to stop */
+static pid_t        mStdWorkers[ I_STD_MAX_WORKERS ]; /* Process of each worker */
+static mStdFormat_t mStdDefault;                /* Format from the command line */
+
+/* Local function prototypes */
+static void     mStdServeStop ( int Signal );
+static Status_t mStdServeStart ( Int32_t Worker, int Socket );
+static void     mStdServeWorker ( int Socket );
+static Status_t mStdServeRequest ( int Connection );
+static Status_t mStdServeFormat ( char *LinePtr );
+
+/*****************************************************************************
+** Function Name:
+**    iStdServe
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Serve extraction requests until asked to stop.
+**
+** Description:
+**    Listens on the socket iStdGlobVar.ServePath, replacing any socket
+**    left there, and starts iStdGlobVar.NumWorkers workers to accept
+**    requests from it. Then waits, replacing any worker that dies, until
+**    SIGINT or SIGTERM is caught.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL once stopped, E_STD_FILE_OPEN_ERR if the
+**       socket could not be set up, or E_STD_THREAD_ERR if the workers
+**       could not be started.
+**
+** Arguments:
+**    None.
+**
+*****************************************************************************/
+Status_t iStdServe ( void )
+{
+   Status_t            Status;       /* Return value of function calls */
+   int                 Socket;       /* Socket listened on */
+   struct sockaddr_un  Address;      /* Its name */
+   struct stat         FileStat;     /* To check what is there already */
+   struct sigaction    Action;       /* Handling of signals */
+   pid_t               Pid;          /* Worker that has ended */
+   int                 ExitStatus;   /* How it ended */
+   Int32_t             i;            /* Counter stepping through workers */
+
+   mStdDefault.WriteMatlab  = iStdGlobVar.WriteMatlab;
+   mStdDefault.WriteGnuplot = iStdGlobVar.WriteGnuplot;
+   mStdDefault.WriteInflux  = iStdGlobVar.WriteInflux;
+   mStdDefault.WriteLong    = iStdGlobVar.WriteLong;
+   mStdDefault.WriteBinary  = iStdGlobVar.WriteBinary;
+   strcpy( mStdDefault.Measurement, iStdGlobVar.Measurement );
+
+   /* A socket left by an earlier server is replaced, anything else is not */
+   if ( ( lstat( iStdGlobVar.ServePath, &FileStat ) == 0 ) &&
+        S_ISSOCK( FileStat.st_mode ) )
+   {
+      unlink( iStdGlobVar.ServePath );
+   }
+
+   memset( &Address, 0, sizeof( Address ) );
+   Address.sun_family = AF_UNIX;
+   strncpy( Address.sun_path, iStdGlobVar.ServePath, sizeof( Address.sun_path ) - 1 );
+
+   Socket = socket( AF_UNIX, SOCK_STREAM, 0 );
+   if ( Socket < 0 )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to create a socket: %s",strerror( errno ));
+      return E_STD_FILE_OPEN_ERR;
+   }
+   if ( ( bind( Socket, (struct sockaddr *) &Address, sizeof( Address ) ) != 0 ) ||
+        ( listen( Socket, I_STD_SERVE_BACKLOG ) != 0 ) )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to listen on %s: %s",
+              iStdGlobVar.ServePath,strerror( errno ));
+      close( Socket );
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   /* Waiting for workers must be interrupted by a request to stop */
+   memset( &Action, 0, sizeof( Action ) );
+   sigemptyset( &Action.sa_mask );
+   Action.sa_handler = mStdServeStop;
+   sigaction( SIGINT,  &Action, NULL );
+   sigaction( SIGTERM, &Action, NULL );
+
+   /* A client going away only fails the writes to it */
+   signal( SIGPIPE, SIG_IGN );
+
+   Status = SYS_NOMINAL;
+   for ( i = 0; ( i < iStdGlobVar.NumWorkers ) && ( Status == SYS_NOMINAL ); i++ )
+   {
+      Status = mStdServeStart( i, Socket );
+   }
+
+   while ( ( mStdStopped == 0 ) && ( Status == SYS_NOMINAL ) )
+   {
+      Pid = waitpid( -1, &ExitStatus, 0 );
+      if ( Pid < 0 )
+      {
+         if ( errno != EINTR )
+         {
+            Status = E_STD_THREAD_ERR;
+         }
+         continue;
+      }
+
+      for ( i = 0; i < iStdGlobVar.NumWorkers; i++ )
+      {
+         if ( mStdWorkers[i] == Pid )
+         {
+            eLogWarning(0,"Worker %d (pid %d) ended with status 0x%x, replacing it",
+                        i,(int) Pid,ExitStatus);
+            mStdWorkers[i] = 0;
+            if ( mStdStopped == 0 )
+            {
+               Status = mStdServeStart( i, Socket );
+            }
+         }
+      }
+   }
+
+   /* Stop the workers, abandoning any requests they are serving */
+   for ( i = 0; i < iStdGlobVar.NumWorkers; i++ )
+   {
+      if ( mStdWorkers[i] > 0 )
+      {
+         kill( mStdWorkers[i], SIGTERM );
+      }
+   }
+   for ( i = 0; i < iStdGlobVar.NumWorkers; i++ )
+   {
+      if ( mStdWorkers[i] > 0 )
+      {
+         waitpid( mStdWorkers[i], &ExitStatus, 0 );
+         mStdWorkers[i] = 0;
+      }
+   }
+
+   close( Socket );
+   unlink( iStdGlobVar.ServePath );
+
+   signal( SIGINT,  SIG_DFL );
+   signal( SIGTERM, SIG_DFL );
+
+   eLogNotice(0,"Stopped serving requests on \"%s\"",iStdGlobVar.ServePath);
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdServeStop
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Handle a signal asking Std to stop serving.
+**
+** Description:
+**    Only notes the request, which is acted on by the process waiting for
+**    the workers.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    int Signal                (in)
+**       Signal caught.
+**
+*****************************************************************************/
+static void mStdServeStop ( int Signal )
+{
+   (void) Signal;
+
+   mStdStopped = 1;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdServeStart
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Start a worker.
+**
+** Description:
+**    The worker is a process of its own, sharing the tables already read
+**    and the socket listened on, and does not return.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or E_STD_THREAD_ERR.
+**
+** Arguments:
+**    Int32_t Worker            (in)
+**       Index of the worker.
+**    int     Socket            (in)
+**       Socket listened on.
+**
+*****************************************************************************/
+static Status_t mStdServeStart ( Int32_t Worker, int Socket )
+{
+   pid_t       Pid;          /* Process of the worker */
+
+   /* Nothing waiting to be written is to be written again by the worker */
+   fflush( NULL );
+
+   Pid = fork( );
+   if ( Pid < 0 )
+   {
+      eLogErr(E_STD_THREAD_ERR,"Unable to start worker %d: %s",Worker,strerror( errno ));
+      return E_STD_THREAD_ERR;
+   }
+
+   if ( Pid == 0 )
+   {
+      signal( SIGINT,  SIG_DFL );
+      signal( SIGTERM, SIG_DFL );
+      mStdServeWorker( Socket );
+   }
+
+   mStdWorkers[ Worker ] = Pid;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdServeWorker
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Serve requests, one at a time, for as long as Std is serving.
+**
+** Description:
+**    Never returns, the process ending if a connection can no longer be
+**    accepted.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    int Socket                (in)
+**       Socket listened on.
+**
+*****************************************************************************/
+static void mStdServeWorker ( int Socket )
+{
+   Status_t    Status;       /* Return value of function calls */
+   int         Connection;   /* Connection of a request */
+
+   for ( ; ; )
+   {
+      Connection = accept( Socket, NULL, NULL );
+      if ( Connection < 0 )
+      {
+         if ( ( errno == EINTR ) || ( errno == ECONNABORTED ) )
+         {
+            continue;
+         }
+         eLogErr(E_STD_FILE_OPEN_ERR,"Unable to accept a request: %s",strerror( errno ));
+         exit( EXIT_FAILURE );
+      }
+
+      Status = mStdServeRequest( Connection );
+      if ( Status != SYS_NOMINAL )
+      {
+         eLogErr(Status,"Error serving a request");
+      }
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdServeRequest
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Serve a single request.
+**
+** Description:
+**    Reads the request, searches for what it asks for and writes back the
+**    data found, exactly as Std would to an output file, then closes the
+**    connection. A request not giving its start and stop times, or any
+**    data to search for, is refused.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or the first error met.
+**
+** Arguments:
+**    int Connection            (in)
+**       Connection the request is read from and answered on.
+**
+*****************************************************************************/
+static Status_t mStdServeRequest ( int Connection )
+{
+   Status_t       Status;                       /* Return value of function calls */
+   FILE          *InPtr;                        /* Request being read */
+   FILE          *OutPtr;                       /* Answer being written */
+   FILE          *ConfigPtr;                    /* Request as a configuration file */
+   int            ConfigFd;                     /* That file, once created */
+   char           ConfigFile[ FILENAME_MAX ];   /* Its name */
+   char           Line[ E_CFU_STRING_LEN ];     /* Line of the request */
+   char           Word[ E_CFU_STRING_LEN ];     /* First word of the line */
+   eTtlTime_t     StartTime;                    /* Start of the search */
+   eTtlTime_t     StopTime;                     /* End of the search */
+
+   InPtr  = fdopen( Connection, "r" );
+   OutPtr = fdopen( dup( Connection ), "w" );
+   if ( ( InPtr == NULL ) || ( OutPtr == NULL ) )
+   {
+      if ( InPtr != NULL )
+      {
+         fclose( InPtr );
+      }
+      else
+      {
+         close( Connection );
+      }
+      if ( OutPtr != NULL )
+      {
+         fclose( OutPtr );
+      }
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   iStdGlobVar.WriteMatlab  = mStdDefault.WriteMatlab;
+   iStdGlobVar.WriteGnuplot = mStdDefault.WriteGnuplot;
+   iStdGlobVar.WriteInflux  = mStdDefault.WriteInflux;
+   iStdGlobVar.WriteLong    = mStdDefault.WriteLong;
+   iStdGlobVar.WriteBinary  = mStdDefault.WriteBinary;
+   strcpy( iStdGlobVar.Measurement, mStdDefault.Measurement );
+
+   /* The configuration file reader takes the request from a file */
+   strcpy( ConfigFile, M_STD_SERVE_TEMP );
+   ConfigFd  = mkstemp( ConfigFile );
+   ConfigPtr = ( ConfigFd < 0 ) ? NULL : fdopen( ConfigFd, "w" );
+   if ( ConfigPtr == NULL )
+   {
+      eLogErr(E_STD_FILE_OPEN_ERR,"Unable to create %s: %s",ConfigFile,strerror( errno ));
+      if ( ConfigFd >= 0 )
+      {
+         close( ConfigFd );
+         unlink( ConfigFile );
+      }
+      fprintf( OutPtr, "ERROR 0x%x\n", E_STD_FILE_OPEN_ERR );
+      fclose( OutPtr );
+      fclose( InPtr );
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   Status = SYS_NOMINAL;
+   while ( fgets( Line, sizeof( Line ), InPtr ) != NULL )
+   {
+      Word[0] = '\0';
+      sscanf( Line, "%[^" M_STD_SERVE_SEPS "]", Word );
+
+      if ( strcmp( Word, I_STD_SERVE_END ) == 0 )
+      {
+         break;
+      }
+      else if ( strcmp( Word, "FORMAT" ) == 0 )
+      {
+         if ( Status == SYS_NOMINAL )
+         {
+            Status = mStdServeFormat( Line );
+         }
+      }
+      else
+      {
+         fputs( Line, ConfigPtr );
+      }
+   }
+
+   if ( ( fclose( ConfigPtr ) != 0 ) && ( Status == SYS_NOMINAL ) )
+   {
+      Status = E_STD_FILE_WRITE_ERR;
+   }
+
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = iStdReadSingleConfig( ConfigFile );
+   }
+   unlink( ConfigFile );
+
+   /* Searching from the command line's times or for its data is not asked for */
+   if ( ( Status == SYS_NOMINAL ) &&
+        ( ( iStdGlobVar.Outputs->StartGiven == FALSE ) ||
+          ( iStdGlobVar.Outputs->StopGiven == FALSE ) ) )
+   {
+      eLogErr(E_STD_GEN_ERROR,"Request gives no start and stop time");
+      Status = E_STD_GEN_ERROR;
+   }
+   if ( ( Status == SYS_NOMINAL ) && ( iStdGlobVar.Outputs->NumDataSearch == 0 ) )
+   {
+      eLogErr(E_STD_GEN_ERROR,"Request gives no data to search for");
+      Status = E_STD_GEN_ERROR;
+   }
+
+   /* The data found is written back in place of the output file */
+   if ( Status == SYS_NOMINAL )
+   {
+      strcpy( iStdGlobVar.Outputs->OutFile, iStdGlobVar.ServePath );
+      iStdGlobVar.Outputs->OutFilePtr = OutPtr;
+
+      Status = iStdSearchSetup( &StartTime, &StopTime );
+      if ( Status == SYS_NOMINAL )
+      {
+         Status = iStdSearch( StartTime, StopTime );
+      }
+      if ( Status == SYS_NOMINAL )
+      {
+         Status = iStdSearchWrite( FALSE );
+      }
+
+      /* Left open only if the data was not written */
+      OutPtr = iStdGlobVar.Outputs->OutFilePtr;
+   }
+
+   if ( OutPtr != NULL )
+   {
+      fprintf( OutPtr, "\nERROR 0x%x\n", Status );
+      fclose( OutPtr );
+   }
+   fclose( InPtr );
+
+   iStdLookupFree( );
+   iStdFreeOutputs( );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdServeFormat
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Choose the format of the data written back for a request.
+**
+** Description:
+**    The line is "FORMAT" followed by "text", "matlab", "gnuplot", "long",
+**    "binary" or "influx", and for InfluxDB the measurement, if not the one given
+**    on the command line.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or E_STD_GEN_ERROR if the format is
+**       not known.
+**
+** Arguments:
+**    char *LinePtr             (in)
+**       Line of the request giving the format.
+**
+*****************************************************************************/
+static Status_t mStdServeFormat ( char *LinePtr )
+{
+   char          *WordPtr;     /* Word of the line */
+
+   WordPtr = strtok( LinePtr, M_STD_SERVE_SEPS );
+   WordPtr = strtok( NULL, M_STD_SERVE_SEPS );
+   if ( WordPtr == NULL )
+   {
+      eLogErr(E_STD_GEN_ERROR,"No format given by request");
+      return E_STD_GEN_ERROR;
+   }
+
+   iStdGlobVar.WriteMatlab  = FALSE;
+   iStdGlobVar.WriteGnuplot = FALSE;
+   iStdGlobVar.WriteInflux  = FALSE;
+   iStdGlobVar.WriteLong    = FALSE;
+   iStdGlobVar.WriteBinary  = FALSE;
+
+   if ( strcmp( WordPtr, "matlab" ) == 0 )
+   {
+      iStdGlobVar.WriteMatlab = TRUE;
+   }
+   else if ( strcmp( WordPtr, "gnuplot" ) == 0 )
+   {
+      iStdGlobVar.WriteGnuplot = TRUE;
+   }
+   else if ( strcmp( WordPtr, "long" ) == 0 )
+   {
+      iStdGlobVar.WriteLong = TRUE;
+   }
+   else if ( strcmp( WordPtr, "binary" ) == 0 )
+   {
+      iStdGlobVar.WriteBinary = TRUE;
+   }
+   else if ( strcmp( WordPtr, "influx" ) == 0 )
+   {
+      iStdGlobVar.WriteInflux = TRUE;
+
+      WordPtr = strtok( NULL, M_STD_SERVE_SEPS );
+      if ( WordPtr != NULL )
+      {
+         strncpy( iStdGlobVar.Measurement, WordPtr, I_STD_MAX_MEASURE - 1 );
+         iStdGlobVar.Measurement[ I_STD_MAX_MEASURE - 1 ] = '\0';
+      }
+   }
+   else if ( strcmp( WordPtr, "text" ) != 0 )
+   {
+      eLogErr(E_STD_GEN_ERROR,"Unknown format %s requested",WordPtr);
+      return E_STD_GEN_ERROR;
+   }
+
+   return SYS_NOMINAL;
+}
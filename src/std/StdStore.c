@@ -0,0 +1,1511 @@
+/*****************************************************************************
+** Module Name:
+**     StdStore.c
+**
+** Purpose:
+**     Stores data matching the search criteria until it is output.
+**
+** Description:
+**     Matched data is held column by column. Each requested source/datum
+**     pair keeps its own array of (time stamp, value) samples, appended to
+**     as data arrives and grown by doubling, which is put in time order
+**     once the search is complete. The arrays are carved from large blocks
+**     of memory rather than allocated one by one, and arrays outgrown by
+**     one column are recycled for the next, so the cost of storing a sample
+**     is close to its 12 bytes however many columns are requested. The
+**     arena is shared by all threads, so is guarded by a mutex.
+**
+**     Rows of the output, one per distinct time stamp, are only assembled
+**     when the data is written, by merging the columns in time order.
+**
+**     When strides are summarised, the samples in range are stored as
+**     usual but only until the file of their hour has been searched. They
+**     are then put in time order and folded into a running summary of
+**     their stride, one per stride of each column, and dropped. So the
+**     samples of a single hour are held at once, however long the search.
+**     The summaries are only turned into samples, one per stride at its
+**     start, as they are written. Records found out of order are still
+**     counted in the right stride, the summary keeping its earliest and
+**     latest samples by comparing their times.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+#define M_STD_ARENA_SIZE   ( 1024 * 1024 ) /* Bytes claimed for the arena at once */
+#define M_STD_MIN_CLASS    4               /* Smallest array holds 2^4 samples */
+#define M_STD_NUM_CLASSES  28              /* Number of array size classes, the
+                                              largest holding 2^27 samples */
+#define M_STD_ARENA_MAX    ( M_STD_ARENA_SIZE / 4 ) /* Largest array carved from it */
+#define M_STD_MIN_SUMMARIES 16             /* Strides a column has room for at first */
+
+/* Size in bytes of an array of a given size class */
+#define M_STD_CLASS_BYTES( Class ) ( sizeof( iStdSample_t ) << ( Class ) )
+
+/* Ordering of two time stamps, negative, zero or positive */
+#define M_STD_TIME_CMP( T1, T2 ) \
+   ( ( (T1).t_sec  != (T2).t_sec  ) ? ( ( (T1).t_sec  < (T2).t_sec  ) ? -1 : 1 ) : \
+     ( (T1).t_nsec != (T2).t_nsec ) ? ( ( (T1).t_nsec < (T2).t_nsec ) ? -1 : 1 ) : 0 )
+
+/* Local variables */
+static char   *mStdArenaPtr  = NULL;  /* Next free byte of the arena */
+static size_t  mStdArenaLeft = 0;     /* Bytes left in the arena */
+static void   *mStdFreeList[ M_STD_NUM_CLASSES ]; /* Recycled arena arrays by class */
+static pthread_mutex_t mStdArenaLock = PTHREAD_MUTEX_INITIALIZER;
+static char   *mStdAggNames[ I_STD_NUM_AGGS ] =
+{
+   "min", "max", "mean", "first", "last", "count", "firsttime", "lasttime"
+};
+
+/* Local function prototypes */
+static iStdSample_t *mStdArenaAlloc ( Int32_t Class );
+static void mStdArenaFree ( iStdSample_t *SamplesPtr, Int32_t Class );
+static Status_t mStdGrowColumn ( iStdData_t *StdDataPtr );
+static void mStdMergeSort ( iStdSample_t *SamplesPtr, Int32_t NumSamples,
+                            iStdSample_t *WorkPtr );
+static Status_t mStdSummaryFind ( iStdData_t *StdDataPtr, Int32_t Start,
+                                  iStdSummary_t **SummaryPtr );
+static void mStdSummaryAdd ( iStdSummary_t *SummaryPtr, iStdSample_t *SamplePtr );
+static Int32_t mStdSummaryValue ( iStdSummary_t *SummaryPtr, Int32_t Agg );
+static Bool_t mStdCursorBefore ( iStdOutput_t *OutputPtr, iStdCursor_t *CursorPtr,
+                                 Int32_t First, Int32_t Second );
+static void mStdCursorSift ( iStdOutput_t *OutputPtr, iStdCursor_t *CursorPtr,
+                             Int32_t Position );
+
+/*****************************************************************************
+** Function Name:
+**    iStdStoreData
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Store a data value that matches the search criterior.
+**
+** Description:
+**    Appends the sample to the end of its column. The Sdb doesn't guarantee
+**    the order of records in a file, so if the sample is earlier than the
+**    last one stored the column is marked as needing to be sorted by
+**    iStdSortData before it is output.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in/out)
+**       Output the data is being stored for.
+**    eTtlTime TimeStamp        (in)
+**       Time stamp for data that matches search.
+**    Int32_t  DataItem         (in)
+**       Index into array of requested data items.
+**    Int32_t  Value            (in)
+**       Data value.
+**
+*****************************************************************************/
+Status_t iStdStoreData(iStdOutput_t *OutputPtr, eTtlTime_t TimeStamp,
+                       Int32_t DataItem, Int32_t Value)
+{
+   Status_t      Status;
+   iStdData_t   *StdDataPtr;   /* Column being stored to */
+   iStdSample_t *SamplePtr;    /* Sample being stored */
+
+   StdDataPtr = OutputPtr->StdData + DataItem;
+
+   if ( StdDataPtr->NumSamples == StdDataPtr->MaxSamples )
+   {
+      Status = mStdGrowColumn( StdDataPtr );
+      if ( Status != SYS_NOMINAL )
+      {
+         return Status;
+      }
+   }
+
+   SamplePtr = StdDataPtr->Samples + StdDataPtr->NumSamples;
+   SamplePtr->TimeStamp = TimeStamp;
+   SamplePtr->Value     = Value;
+
+   if ( ( StdDataPtr->NumSamples > 0 ) &&
+        ( M_STD_TIME_CMP( TimeStamp, (SamplePtr-1)->TimeStamp ) <= 0 ) )
+   {
+      StdDataPtr->Unsorted = TRUE;
+   }
+
+   StdDataPtr->NumSamples++;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdSortData
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Put the data stored for an output into time order.
+**
+** Description:
+**    Each column stored out of order is sorted with a stable merge sort
+**    that merges the runs already in order, so a file that is almost in
+**    order costs little more than a single pass. Where a column has more
+**    than one value with the same time stamp the first one found is kept.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in/out)
+**       Output whose data is to be sorted.
+**
+*****************************************************************************/
+Status_t iStdSortData ( iStdOutput_t *OutputPtr )
+{
+   Int32_t       j;            /* Counter stepping through columns */
+   Int32_t       i;            /* Sample being checked */
+   Int32_t       Kept;         /* Number of samples kept */
+   iStdData_t   *StdDataPtr;   /* Column being sorted */
+   iStdSample_t *WorkPtr;      /* Work space for the merge */
+   char          TimeStr[ E_TIM_BUFFER_LENGTH ];
+
+   for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+   {
+      StdDataPtr = OutputPtr->StdData + j;
+      if ( StdDataPtr->Unsorted == FALSE )
+      {
+         continue;
+      }
+
+      WorkPtr = mStdArenaAlloc( StdDataPtr->SizeClass );
+      if ( WorkPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      mStdMergeSort( StdDataPtr->Samples, StdDataPtr->NumSamples, WorkPtr );
+      mStdArenaFree( WorkPtr, StdDataPtr->SizeClass );
+
+      /* Remove duplicates, the sort kept them in the order they were found */
+      Kept = 1;
+      for ( i = 1; i < StdDataPtr->NumSamples; i++ )
+      {
+         if ( M_STD_TIME_CMP( StdDataPtr->Samples[i].TimeStamp,
+                              StdDataPtr->Samples[Kept-1].TimeStamp ) == 0 )
+         {
+            iStdFormatTimeString( &StdDataPtr->Samples[i].TimeStamp, TimeStr );
+            eLogInfo("Duplicate data/timestamp pair (%s)", TimeStr );
+            continue;
+         }
+         StdDataPtr->Samples[ Kept++ ] = StdDataPtr->Samples[i];
+      }
+      StdDataPtr->NumSamples = Kept;
+      StdDataPtr->Unsorted   = FALSE;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdSummariseData
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Fold the samples stored for an output into the summaries of strides.
+**
+** Description:
+**    Strides of iStdGlobVar.Window seconds are counted from the start time
+**    of the output. The columns are put in time order, dropping duplicates
+**    as iStdSortData does, and each sample is added to the summary of its
+**    stride, which is started if the column has none yet. The columns are
+**    then emptied, so only the summaries are kept between calls.
+**
+**    A sample repeating the time of the earliest or latest sample already
+**    summarised in its stride is passed over, keeping the first found.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in/out)
+**       Output whose data is to be summarised.
+**
+*****************************************************************************/
+Status_t iStdSummariseData ( iStdOutput_t *OutputPtr )
+{
+   Status_t       Status;
+   Int32_t        j;            /* Counter stepping through columns */
+   Int32_t        i;            /* Sample being summarised */
+   Int32_t        Start;        /* Start of the stride of a sample */
+   iStdData_t    *StdDataPtr;   /* Column being summarised */
+   iStdSample_t  *SamplePtr;    /* Sample being summarised */
+   iStdSummary_t *SummaryPtr;   /* Summary of its stride */
+
+   Status = iStdSortData( OutputPtr );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+   {
+      StdDataPtr = OutputPtr->StdData + j;
+
+      SummaryPtr = NULL;
+      for ( i = 0; i < StdDataPtr->NumSamples; i++ )
+      {
+         SamplePtr = StdDataPtr->Samples + i;
+         Start     = SamplePtr->TimeStamp.t_sec -
+                     ( SamplePtr->TimeStamp.t_sec - OutputPtr->TtlStartTime.t_sec ) %
+                     iStdGlobVar.Window;
+
+         /* The column is sorted, so its strides come in turn */
+         if ( ( SummaryPtr == NULL ) || ( SummaryPtr->Start != Start ) )
+         {
+            Status = mStdSummaryFind( StdDataPtr, Start, &SummaryPtr );
+            if ( Status != SYS_NOMINAL )
+            {
+               return Status;
+            }
+         }
+
+         mStdSummaryAdd( SummaryPtr, SamplePtr );
+      }
+
+      StdDataPtr->NumSamples = 0;
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdAggregate
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Turn the summaries of the strides of an output into samples.
+**
+** Description:
+**    Any samples still stored are first summarised by iStdSummariseData.
+**    Each summary of a column then becomes one sample, time stamped with
+**    the start of the stride, whose value is the summary given by the
+**    column's Agg, and the summary is given up.
+**
+**    Unless Final is set, the latest stride of the output may yet receive
+**    more samples, so its summaries are kept for the next call and left
+**    out of the samples to be written.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or the error growing a column.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in/out)
+**       Output whose data is to be summarised.
+**    Bool_t Final              (in)
+**       Set if no more samples will be stored.
+**
+*****************************************************************************/
+Status_t iStdAggregate ( iStdOutput_t *OutputPtr, Bool_t Final )
+{
+   Status_t       Status;
+   Int32_t        j;            /* Counter stepping through columns */
+   Int32_t        i;            /* Summary being written */
+   Int32_t        Kept;         /* Number of summaries written */
+   Int32_t        Latest;       /* Start of the latest stride with a sample */
+   iStdData_t    *StdDataPtr;   /* Column being summarised */
+   iStdSummary_t *SummaryPtr;   /* Summary being written */
+
+   Status = iStdSummariseData( OutputPtr );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   /* The columns share the strides held back, so rows are not split */
+   Latest = OutputPtr->TtlStartTime.t_sec;
+   for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+   {
+      StdDataPtr = OutputPtr->StdData + j;
+      if ( ( StdDataPtr->NumSummaries > 0 ) &&
+           ( StdDataPtr->Summaries[ StdDataPtr->NumSummaries - 1 ].Start > Latest ) )
+      {
+         Latest = StdDataPtr->Summaries[ StdDataPtr->NumSummaries - 1 ].Start;
+      }
+   }
+
+   for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+   {
+      StdDataPtr = OutputPtr->StdData + j;
+
+      Kept = StdDataPtr->NumSummaries;
+      while ( ( Final == FALSE ) && ( Kept > 0 ) &&
+              ( StdDataPtr->Summaries[ Kept - 1 ].Start >= Latest ) )
+      {
+         Kept--;
+      }
+
+      while ( StdDataPtr->MaxSamples < Kept )
+      {
+         Status = mStdGrowColumn( StdDataPtr );
+         if ( Status != SYS_NOMINAL )
+         {
+            return Status;
+         }
+      }
+
+      for ( i = 0; i < Kept; i++ )
+      {
+         SummaryPtr = StdDataPtr->Summaries + i;
+         StdDataPtr->Samples[i].TimeStamp.t_sec  = SummaryPtr->Start;
+         StdDataPtr->Samples[i].TimeStamp.t_nsec = 0;
+         StdDataPtr->Samples[i].Value = mStdSummaryValue( SummaryPtr, StdDataPtr->Agg );
+      }
+      StdDataPtr->NumSamples = Kept;
+
+      StdDataPtr->NumSummaries -= Kept;
+      if ( StdDataPtr->NumSummaries > 0 )
+      {
+         memmove( StdDataPtr->Summaries, StdDataPtr->Summaries + Kept,
+                  StdDataPtr->NumSummaries * sizeof( iStdSummary_t ) );
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdEmptyData
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Empty the columns of an output once their data has been written.
+**
+** Description:
+**    Unlike iStdClearData, the counts of entries are kept, as are the
+**    summaries of any stride still open, left by iStdAggregate.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in/out)
+**       Output whose data has been written.
+**
+*****************************************************************************/
+void iStdEmptyData ( iStdOutput_t *OutputPtr )
+{
+   Int32_t     j;            /* Counter stepping through columns */
+
+   for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+   {
+      OutputPtr->StdData[j].NumSamples = 0;
+      OutputPtr->StdData[j].Unsorted   = FALSE;
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdAggName
+**
+** Type:
+**    char *
+**
+** Purpose:
+**    Name of a summary of a stride.
+**
+** Description:
+**    As given to the aggregate switch and shown in column headers.
+**
+** Return type:
+**    char *
+**       The name, or NULL if there is no such summary.
+**
+** Arguments:
+**    Int32_t Agg               (in)
+**       Summary, one of iStdAgg_e.
+**
+*****************************************************************************/
+char *iStdAggName ( Int32_t Agg )
+{
+   if ( ( Agg < 0 ) || ( Agg >= I_STD_NUM_AGGS ) )
+   {
+      return NULL;
+   }
+
+   return mStdAggNames[ Agg ];
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdAppendData
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Append all the samples of one column to a column of an output.
+**
+** Description:
+**    Used to gather the data found by each worker thread into the output.
+**    The column is marked as needing to be sorted unless the samples
+**    follow on in time order from those already stored.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in/out)
+**       Output the data is being stored for.
+**    Int32_t  DataItem         (in)
+**       Index into array of requested data items.
+**    iStdData_t *FromPtr       (in)
+**       Column holding the samples to append.
+**
+*****************************************************************************/
+Status_t iStdAppendData ( iStdOutput_t *OutputPtr, Int32_t DataItem,
+                          iStdData_t *FromPtr )
+{
+   Status_t      Status;
+   iStdData_t   *StdDataPtr;   /* Column being stored to */
+
+   if ( FromPtr->NumSamples == 0 )
+   {
+      return SYS_NOMINAL;
+   }
+
+   StdDataPtr = OutputPtr->StdData + DataItem;
+
+   while ( StdDataPtr->NumSamples + FromPtr->NumSamples > StdDataPtr->MaxSamples )
+   {
+      Status = mStdGrowColumn( StdDataPtr );
+      if ( Status != SYS_NOMINAL )
+      {
+         return Status;
+      }
+   }
+
+   if ( ( FromPtr->Unsorted == TRUE ) ||
+        ( ( StdDataPtr->NumSamples > 0 ) &&
+          ( M_STD_TIME_CMP( FromPtr->Samples[0].TimeStamp,
+                            StdDataPtr->Samples[ StdDataPtr->NumSamples - 1 ].TimeStamp ) <= 0 ) ) )
+   {
+      StdDataPtr->Unsorted = TRUE;
+   }
+
+   memcpy( StdDataPtr->Samples + StdDataPtr->NumSamples, FromPtr->Samples,
+           FromPtr->NumSamples * sizeof( iStdSample_t ) );
+   StdDataPtr->NumSamples += FromPtr->NumSamples;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdClearData
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Empty the columns of an output, keeping their memory for reuse.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in/out)
+**       Output whose data is no longer needed.
+**
+*****************************************************************************/
+void iStdClearData ( iStdOutput_t *OutputPtr )
+{
+   Int32_t j;   /* Counter stepping through columns */
+
+   for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+   {
+      OutputPtr->StdData[j].NumSamples  = 0;
+      OutputPtr->StdData[j].NumOfPoints = 0;
+      OutputPtr->StdData[j].Unsorted    = FALSE;
+      OutputPtr->StdData[j].NumSummaries = 0;
+   }
+
+   OutputPtr->LinesOfData = 0;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdFreeData
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Give up the memory holding the columns of an output.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in/out)
+**       Output whose data is no longer needed.
+**
+*****************************************************************************/
+void iStdFreeData ( iStdOutput_t *OutputPtr )
+{
+   Int32_t     j;            /* Counter stepping through columns */
+   iStdData_t *StdDataPtr;   /* Column being freed */
+
+   iStdClearData( OutputPtr );
+
+   for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+   {
+      StdDataPtr = OutputPtr->StdData + j;
+      if ( StdDataPtr->Samples != NULL )
+      {
+         mStdArenaFree( StdDataPtr->Samples, StdDataPtr->SizeClass );
+         StdDataPtr->Samples    = NULL;
+         StdDataPtr->MaxSamples = 0;
+         StdDataPtr->SizeClass  = 0;
+      }
+      if ( StdDataPtr->Summaries != NULL )
+      {
+         TTL_FREE( StdDataPtr->Summaries );
+         StdDataPtr->Summaries    = NULL;
+         StdDataPtr->MaxSummaries = 0;
+      }
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdRowStart
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Prepare to step through the rows of an output.
+**
+** Description:
+**    A row is made of the samples of every column sharing the same time
+**    stamp. The row cursor keeps, for each column, the index of the next
+**    sample not yet output. Must be followed by iStdRowNext to get to the
+**    first row, and finally by iStdRowEnd.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in)
+**       Output whose rows are to be stepped through.
+**    iStdRow_t    *RowPtr      (out)
+**       Row cursor.
+**
+*****************************************************************************/
+Status_t iStdRowStart ( iStdOutput_t *OutputPtr, iStdRow_t *RowPtr )
+{
+   memset( RowPtr, 0, sizeof( *RowPtr ) );
+
+   RowPtr->Index = (Int32_t *) TTL_CALLOC( OutputPtr->NumDataSearch + 1, sizeof( Int32_t ) );
+   if ( RowPtr->Index == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   RowPtr->Started = FALSE;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdRowNext
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Step on to the next row of an output.
+**
+** Description:
+**    Passes over the samples making up the current row and then finds the
+**    earliest time stamp still to be output, which becomes the time stamp
+**    of the new row.
+**
+** Return type:
+**    Bool_t
+**       TRUE if there is another row, FALSE once all have been output.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in)
+**       Output whose rows are being stepped through.
+**    iStdRow_t    *RowPtr      (in/out)
+**       Row cursor.
+**
+*****************************************************************************/
+Bool_t iStdRowNext ( iStdOutput_t *OutputPtr, iStdRow_t *RowPtr )
+{
+   Int32_t       j;
+   iStdData_t   *StdDataPtr;
+   iStdSample_t *SamplePtr;
+   Bool_t        GotRow = FALSE;
+
+   for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+   {
+      StdDataPtr = OutputPtr->StdData + j;
+      if ( RowPtr->Index[j] >= StdDataPtr->NumSamples )
+      {
+         continue;
+      }
+
+      SamplePtr = StdDataPtr->Samples + RowPtr->Index[j];
+
+      /* Pass over the sample if it was in the current row */
+      if ( ( RowPtr->Started == TRUE ) &&
+           ( M_STD_TIME_CMP( SamplePtr->TimeStamp, RowPtr->TimeStamp ) == 0 ) )
+      {
+         RowPtr->Index[j]++;
+         if ( RowPtr->Index[j] >= StdDataPtr->NumSamples )
+         {
+            continue;
+         }
+         SamplePtr++;
+      }
+
+      if ( ( GotRow == FALSE ) ||
+           ( M_STD_TIME_CMP( SamplePtr->TimeStamp, RowPtr->NextTime ) < 0 ) )
+      {
+         RowPtr->NextTime = SamplePtr->TimeStamp;
+         GotRow = TRUE;
+      }
+   }
+
+   RowPtr->TimeStamp = RowPtr->NextTime;
+   RowPtr->Started   = TRUE;
+
+   return GotRow;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdRowValue
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Get the value of a column in the current row.
+**
+** Description:
+**
+** Return type:
+**    Bool_t
+**       TRUE if the column has a value at the time of the row.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in)
+**       Output whose rows are being stepped through.
+**    iStdRow_t    *RowPtr      (in)
+**       Row cursor.
+**    Int32_t       Column      (in)
+**       Column of interest.
+**    Int32_t      *ValuePtr    (out)
+**       Value of the column, if any.
+**
+*****************************************************************************/
+Bool_t iStdRowValue ( iStdOutput_t *OutputPtr, iStdRow_t *RowPtr,
+                      Int32_t Column, Int32_t *ValuePtr )
+{
+   iStdData_t   *StdDataPtr;
+   iStdSample_t *SamplePtr;
+
+   StdDataPtr = OutputPtr->StdData + Column;
+   if ( RowPtr->Index[ Column ] >= StdDataPtr->NumSamples )
+   {
+      return FALSE;
+   }
+
+   SamplePtr = StdDataPtr->Samples + RowPtr->Index[ Column ];
+   if ( M_STD_TIME_CMP( SamplePtr->TimeStamp, RowPtr->TimeStamp ) != 0 )
+   {
+      return FALSE;
+   }
+
+   *ValuePtr = SamplePtr->Value;
+
+   return TRUE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdRowEnd
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Finish stepping through the rows of an output.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdRow_t    *RowPtr      (in/out)
+**       Row cursor.
+**
+*****************************************************************************/
+void iStdRowEnd ( iStdRow_t *RowPtr )
+{
+   if ( RowPtr->Index != NULL )
+   {
+      TTL_FREE( RowPtr->Index );
+      RowPtr->Index = NULL;
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdCursorStart
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Prepare to step through the samples of an output one at a time.
+**
+** Description:
+**    Unlike a row cursor, which visits every column at every time stamp,
+**    a sample cursor keeps the columns in a heap ordered by their next
+**    sample, so stepping through costs in proportion to the number of
+**    samples rather than rows times columns. Samples sharing a time stamp
+**    are given in column order. Must be followed by iStdCursorNext for
+**    each sample, and finally by iStdCursorEnd.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in)
+**       Output whose samples are to be stepped through.
+**    iStdCursor_t *CursorPtr   (out)
+**       Sample cursor.
+**
+*****************************************************************************/
+Status_t iStdCursorStart ( iStdOutput_t *OutputPtr, iStdCursor_t *CursorPtr )
+{
+   Int32_t j;   /* Counter stepping through columns */
+
+   memset( CursorPtr, 0, sizeof( *CursorPtr ) );
+
+   CursorPtr->Index = (Int32_t *) TTL_CALLOC( 2 * OutputPtr->NumDataSearch + 1,
+                                              sizeof( Int32_t ) );
+   if ( CursorPtr->Index == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+   CursorPtr->Heap = CursorPtr->Index + OutputPtr->NumDataSearch;
+
+   for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+   {
+      if ( OutputPtr->StdData[j].NumSamples > 0 )
+      {
+         CursorPtr->Heap[ CursorPtr->NumHeap++ ] = j;
+      }
+   }
+
+   for ( j = CursorPtr->NumHeap / 2 - 1; j >= 0; j-- )
+   {
+      mStdCursorSift( OutputPtr, CursorPtr, j );
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdCursorNext
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Step on to the next sample of an output.
+**
+** Description:
+**
+** Return type:
+**    Bool_t
+**       TRUE if there is another sample, FALSE once all have been output.
+**
+** Arguments:
+**    iStdOutput_t  *OutputPtr   (in)
+**       Output whose samples are being stepped through.
+**    iStdCursor_t  *CursorPtr   (in/out)
+**       Sample cursor.
+**    Int32_t       *ColumnPtr   (out)
+**       Column of the sample.
+**    iStdSample_t **SamplePtr   (out)
+**       The sample.
+**
+*****************************************************************************/
+Bool_t iStdCursorNext ( iStdOutput_t *OutputPtr, iStdCursor_t *CursorPtr,
+                        Int32_t *ColumnPtr, iStdSample_t **SamplePtr )
+{
+   Int32_t j;   /* Column of the earliest sample */
+
+   if ( CursorPtr->NumHeap == 0 )
+   {
+      return FALSE;
+   }
+
+   j = CursorPtr->Heap[0];
+   *ColumnPtr = j;
+   *SamplePtr = OutputPtr->StdData[j].Samples + CursorPtr->Index[j]++;
+
+   /* A column with no samples left leaves the heap */
+   if ( CursorPtr->Index[j] >= OutputPtr->StdData[j].NumSamples )
+   {
+      CursorPtr->Heap[0] = CursorPtr->Heap[ --CursorPtr->NumHeap ];
+   }
+   mStdCursorSift( OutputPtr, CursorPtr, 0 );
+
+   return TRUE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    iStdCursorEnd
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Finish stepping through the samples of an output.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdCursor_t *CursorPtr   (in/out)
+**       Sample cursor.
+**
+*****************************************************************************/
+void iStdCursorEnd ( iStdCursor_t *CursorPtr )
+{
+   if ( CursorPtr->Index != NULL )
+   {
+      TTL_FREE( CursorPtr->Index );
+      CursorPtr->Index = NULL;
+      CursorPtr->Heap  = NULL;
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCursorBefore
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Compare the next samples of two columns of a sample cursor.
+**
+** Description:
+**
+** Return type:
+**    Bool_t
+**       TRUE if the first column's sample is to be output first.
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in)
+**       Output whose samples are being stepped through.
+**    iStdCursor_t *CursorPtr   (in)
+**       Sample cursor.
+**    Int32_t       First       (in)
+**    Int32_t       Second      (in)
+**       Columns compared.
+**
+*****************************************************************************/
+static Bool_t mStdCursorBefore ( iStdOutput_t *OutputPtr, iStdCursor_t *CursorPtr,
+                                 Int32_t First, Int32_t Second )
+{
+   int Cmp;   /* Order of the time stamps */
+
+   Cmp = M_STD_TIME_CMP(
+            OutputPtr->StdData[ First ].Samples[ CursorPtr->Index[ First ] ].TimeStamp,
+            OutputPtr->StdData[ Second ].Samples[ CursorPtr->Index[ Second ] ].TimeStamp );
+
+   return ( ( Cmp < 0 ) || ( ( Cmp == 0 ) && ( First < Second ) ) ) ? TRUE : FALSE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdCursorSift
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Move a column of a sample cursor's heap down to its place.
+**
+** Description:
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdOutput_t *OutputPtr   (in)
+**       Output whose samples are being stepped through.
+**    iStdCursor_t *CursorPtr   (in/out)
+**       Sample cursor.
+**    Int32_t       Position    (in)
+**       Place in the heap of the column.
+**
+*****************************************************************************/
+static void mStdCursorSift ( iStdOutput_t *OutputPtr, iStdCursor_t *CursorPtr,
+                             Int32_t Position )
+{
+   Int32_t *HeapPtr;   /* Columns, earliest next sample first */
+   Int32_t  Child;     /* Earlier of the children of the position */
+   Int32_t  Column;    /* Column being moved down */
+
+   HeapPtr = CursorPtr->Heap;
+   if ( Position >= CursorPtr->NumHeap )
+   {
+      return;
+   }
+   Column = HeapPtr[ Position ];
+
+   while ( ( Child = 2 * Position + 1 ) < CursorPtr->NumHeap )
+   {
+      if ( ( Child + 1 < CursorPtr->NumHeap ) &&
+           mStdCursorBefore( OutputPtr, CursorPtr, HeapPtr[ Child + 1 ], HeapPtr[ Child ] ) )
+      {
+         Child++;
+      }
+      if ( !mStdCursorBefore( OutputPtr, CursorPtr, HeapPtr[ Child ], Column ) )
+      {
+         break;
+      }
+      HeapPtr[ Position ] = HeapPtr[ Child ];
+      Position = Child;
+   }
+
+   HeapPtr[ Position ] = Column;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdMergeSort
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Sort an array of samples into time order.
+**
+** Description:
+**    Bottom-up natural merge sort. Each pass merges neighbouring runs that
+**    are already in order, alternating between the array and the work
+**    space, until a single run remains. Equal time stamps keep their
+**    original order.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdSample_t *SamplesPtr  (in/out)
+**       Array to be sorted.
+**    Int32_t NumSamples        (in)
+**       Number of samples in the array.
+**    iStdSample_t *WorkPtr     (in)
+**       Work space with room for NumSamples samples.
+**
+*****************************************************************************/
+static void mStdMergeSort ( iStdSample_t *SamplesPtr, Int32_t NumSamples,
+                            iStdSample_t *WorkPtr )
+{
+   iStdSample_t *SrcPtr;       /* Samples being merged from */
+   iStdSample_t *DstPtr;       /* Samples being merged to */
+   iStdSample_t *TmpPtr;
+   Int32_t       Start;        /* Start of first run */
+   Int32_t       Mid;          /* Start of second run */
+   Int32_t       End;          /* End of second run */
+   Int32_t       i, j, k;
+   Int32_t       NumRuns;      /* Number of runs found in a pass */
+
+   SrcPtr = SamplesPtr;
+   DstPtr = WorkPtr;
+
+   do
+   {
+      NumRuns = 0;
+      Start   = 0;
+      while ( Start < NumSamples )
+      {
+         /* Find the first run */
+         Mid = Start + 1;
+         while ( ( Mid < NumSamples ) &&
+                 ( M_STD_TIME_CMP( SrcPtr[Mid-1].TimeStamp, SrcPtr[Mid].TimeStamp ) <= 0 ) )
+         {
+            Mid++;
+         }
+
+         /* Find the second run */
+         End = Mid;
+         if ( End < NumSamples )
+         {
+            End++;
+            while ( ( End < NumSamples ) &&
+                    ( M_STD_TIME_CMP( SrcPtr[End-1].TimeStamp, SrcPtr[End].TimeStamp ) <= 0 ) )
+            {
+               End++;
+            }
+         }
+
+         /* Merge them, taking from the first run when equal */
+         i = Start;
+         j = Mid;
+         k = Start;
+         while ( ( i < Mid ) && ( j < End ) )
+         {
+            if ( M_STD_TIME_CMP( SrcPtr[j].TimeStamp, SrcPtr[i].TimeStamp ) < 0 )
+            {
+               DstPtr[k++] = SrcPtr[j++];
+            }
+            else
+            {
+               DstPtr[k++] = SrcPtr[i++];
+            }
+         }
+         while ( i < Mid )
+         {
+            DstPtr[k++] = SrcPtr[i++];
+         }
+         while ( j < End )
+         {
+            DstPtr[k++] = SrcPtr[j++];
+         }
+
+         NumRuns++;
+         Start = End;
+      }
+
+      TmpPtr = SrcPtr;
+      SrcPtr = DstPtr;
+      DstPtr = TmpPtr;
+
+   } while ( NumRuns > 1 );
+
+   /* The sorted samples are in SrcPtr following the last swap */
+   if ( SrcPtr != SamplesPtr )
+   {
+      memcpy( SamplesPtr, SrcPtr, NumSamples * sizeof( iStdSample_t ) );
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSummaryFind
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Find the summary of a stride of a column, starting it if need be.
+**
+** Description:
+**    The summaries are kept in order of their strides. Samples mostly
+**    arrive in time order, so the latest stride is checked first, and
+**    only a sample from an earlier stride needs a search.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdData_t *StdDataPtr       (in/out)
+**       Column being summarised.
+**    Int32_t Start                (in)
+**       Start of the stride.
+**    iStdSummary_t **SummaryPtr   (out)
+**       Summary of the stride.
+**
+*****************************************************************************/
+static Status_t mStdSummaryFind ( iStdData_t *StdDataPtr, Int32_t Start,
+                                  iStdSummary_t **SummaryPtr )
+{
+   iStdSummary_t *NewPtr;   /* Summaries given more room */
+   Int32_t        Low;      /* Place of the stride among the summaries */
+   Int32_t        High;
+   Int32_t        Mid;
+
+   Low = StdDataPtr->NumSummaries;
+   if ( ( Low > 0 ) && ( StdDataPtr->Summaries[ Low - 1 ].Start >= Start ) )
+   {
+      Low  = 0;
+      High = StdDataPtr->NumSummaries - 1;
+      while ( Low < High )
+      {
+         Mid = ( Low + High ) / 2;
+         if ( StdDataPtr->Summaries[ Mid ].Start < Start )
+         {
+            Low = Mid + 1;
+         }
+         else
+         {
+            High = Mid;
+         }
+      }
+
+      if ( StdDataPtr->Summaries[ Low ].Start == Start )
+      {
+         *SummaryPtr = StdDataPtr->Summaries + Low;
+         return SYS_NOMINAL;
+      }
+   }
+
+   if ( StdDataPtr->NumSummaries == StdDataPtr->MaxSummaries )
+   {
+      NewPtr = (iStdSummary_t *) TTL_REALLOC( StdDataPtr->Summaries,
+                  ( StdDataPtr->MaxSummaries > 0 ? 2 * StdDataPtr->MaxSummaries
+                                                 : M_STD_MIN_SUMMARIES ) *
+                  sizeof( iStdSummary_t ) );
+      if ( NewPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      StdDataPtr->Summaries    = NewPtr;
+      StdDataPtr->MaxSummaries = ( StdDataPtr->MaxSummaries > 0 ) ?
+                                 2 * StdDataPtr->MaxSummaries : M_STD_MIN_SUMMARIES;
+   }
+
+   /* A stride earlier than the latest is put in its place */
+   if ( Low < StdDataPtr->NumSummaries )
+   {
+      memmove( StdDataPtr->Summaries + Low + 1, StdDataPtr->Summaries + Low,
+               ( StdDataPtr->NumSummaries - Low ) * sizeof( iStdSummary_t ) );
+   }
+   StdDataPtr->NumSummaries++;
+
+   *SummaryPtr = StdDataPtr->Summaries + Low;
+   (*SummaryPtr)->Start = Start;
+   (*SummaryPtr)->Count = 0;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSummaryAdd
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Add a sample to the summary of a stride.
+**
+** Description:
+**    Samples may be added in any order, the earliest and latest being
+**    found by their times. A sample at the time of the earliest or latest
+**    already added is taken to repeat it, and passed over.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdSummary_t *SummaryPtr (in/out)
+**       Summary of the stride.
+**    iStdSample_t *SamplePtr   (in)
+**       Sample to be added.
+**
+*****************************************************************************/
+static void mStdSummaryAdd ( iStdSummary_t *SummaryPtr, iStdSample_t *SamplePtr )
+{
+   int FirstCmp;   /* Order of the sample and the earliest */
+   int LastCmp;    /* Order of the sample and the latest */
+
+   if ( SummaryPtr->Count == 0 )
+   {
+      SummaryPtr->Min       = SamplePtr->Value;
+      SummaryPtr->Max       = SamplePtr->Value;
+      SummaryPtr->Sum       = 0.0;
+      SummaryPtr->First     = SamplePtr->Value;
+      SummaryPtr->FirstTime = SamplePtr->TimeStamp;
+      SummaryPtr->Last      = SamplePtr->Value;
+      SummaryPtr->LastTime  = SamplePtr->TimeStamp;
+   }
+   else
+   {
+      FirstCmp = M_STD_TIME_CMP( SamplePtr->TimeStamp, SummaryPtr->FirstTime );
+      LastCmp  = M_STD_TIME_CMP( SamplePtr->TimeStamp, SummaryPtr->LastTime );
+      if ( ( FirstCmp == 0 ) || ( LastCmp == 0 ) )
+      {
+         return;
+      }
+      if ( FirstCmp < 0 )
+      {
+         SummaryPtr->First     = SamplePtr->Value;
+         SummaryPtr->FirstTime = SamplePtr->TimeStamp;
+      }
+      if ( LastCmp > 0 )
+      {
+         SummaryPtr->Last      = SamplePtr->Value;
+         SummaryPtr->LastTime  = SamplePtr->TimeStamp;
+      }
+   }
+
+   if ( SamplePtr->Value < SummaryPtr->Min )
+   {
+      SummaryPtr->Min = SamplePtr->Value;
+   }
+   if ( SamplePtr->Value > SummaryPtr->Max )
+   {
+      SummaryPtr->Max = SamplePtr->Value;
+   }
+   SummaryPtr->Sum += SamplePtr->Value;
+   SummaryPtr->Count++;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSummaryValue
+**
+** Type:
+**    Int32_t
+**
+** Purpose:
+**    Value written for the summary of a stride.
+**
+** Description:
+**
+** Return type:
+**    Int32_t
+**       The value.
+**
+** Arguments:
+**    iStdSummary_t *SummaryPtr (in)
+**       Summary of the stride.
+**    Int32_t Agg               (in)
+**       Summary wanted, one of iStdAgg_e.
+**
+*****************************************************************************/
+static Int32_t mStdSummaryValue ( iStdSummary_t *SummaryPtr, Int32_t Agg )
+{
+   double Mean;   /* Mean of the values */
+
+   switch ( Agg )
+   {
+      case I_STD_AGG_MIN:
+         return SummaryPtr->Min;
+      case I_STD_AGG_MAX:
+         return SummaryPtr->Max;
+      case I_STD_AGG_MEAN:
+         Mean = SummaryPtr->Sum / SummaryPtr->Count;
+         return (Int32_t) ( ( Mean < 0.0 ) ? ( Mean - 0.5 ) : ( Mean + 0.5 ) );
+      case I_STD_AGG_FIRST:
+         return SummaryPtr->First;
+      case I_STD_AGG_COUNT:
+         return SummaryPtr->Count;
+      case I_STD_AGG_FIRSTTIME:
+         return SummaryPtr->FirstTime.t_sec;
+      case I_STD_AGG_LASTTIME:
+         return SummaryPtr->LastTime.t_sec;
+      default:
+         return SummaryPtr->Last;
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdGrowColumn
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Double the number of samples a column can hold.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    iStdData_t *StdDataPtr    (in/out)
+**       Column to be grown.
+**
+*****************************************************************************/
+static Status_t mStdGrowColumn ( iStdData_t *StdDataPtr )
+{
+   iStdSample_t *SamplesPtr;   /* New array of samples */
+   Int32_t       Class;        /* Size class of the new array */
+
+   Class = ( StdDataPtr->Samples == NULL ) ? M_STD_MIN_CLASS
+                                           : StdDataPtr->SizeClass + 1;
+   if ( Class >= M_STD_NUM_CLASSES )
+   {
+      return E_STD_ARRAY_SIZE;
+   }
+
+   SamplesPtr = mStdArenaAlloc( Class );
+   if ( SamplesPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   if ( StdDataPtr->Samples != NULL )
+   {
+      memcpy( SamplesPtr, StdDataPtr->Samples,
+              StdDataPtr->NumSamples * sizeof( iStdSample_t ) );
+      mStdArenaFree( StdDataPtr->Samples, StdDataPtr->SizeClass );
+   }
+
+   StdDataPtr->Samples    = SamplesPtr;
+   StdDataPtr->SizeClass  = Class;
+   StdDataPtr->MaxSamples = (Int32_t) 1 << Class;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdArenaAlloc
+**
+** Type:
+**    iStdSample_t *
+**
+** Purpose:
+**    Allocate an array of samples.
+**
+** Description:
+**    Reuses an array of the same size class given up by another column if
+**    there is one, otherwise carves it from the arena. Arrays too large to
+**    sensibly carve from the arena are allocated individually.
+**
+** Return type:
+**    iStdSample_t *
+**       Pointer to the array, or NULL if memory is exhausted.
+**
+** Arguments:
+**    Int32_t Class             (in)
+**       Size class, the array holds 2^Class samples.
+**
+*****************************************************************************/
+static iStdSample_t *mStdArenaAlloc ( Int32_t Class )
+{
+   void   *BlockPtr;
+   size_t  Bytes;
+
+   pthread_mutex_lock( &mStdArenaLock );
+
+   if ( mStdFreeList[ Class ] != NULL )
+   {
+      BlockPtr = mStdFreeList[ Class ];
+      mStdFreeList[ Class ] = *(void **) BlockPtr;
+      pthread_mutex_unlock( &mStdArenaLock );
+      return (iStdSample_t *) BlockPtr;
+   }
+
+   Bytes = M_STD_CLASS_BYTES( Class );
+   if ( Bytes > M_STD_ARENA_MAX )
+   {
+      pthread_mutex_unlock( &mStdArenaLock );
+      return (iStdSample_t *) TTL_MALLOC( Bytes );
+   }
+
+   if ( Bytes > mStdArenaLeft )
+   {
+      mStdArenaPtr = (char *) TTL_MALLOC( M_STD_ARENA_SIZE );
+      if ( mStdArenaPtr == NULL )
+      {
+         mStdArenaLeft = 0;
+         pthread_mutex_unlock( &mStdArenaLock );
+         return NULL;
+      }
+      mStdArenaLeft = M_STD_ARENA_SIZE;
+   }
+
+   BlockPtr       = mStdArenaPtr;
+   mStdArenaPtr  += Bytes;
+   mStdArenaLeft -= Bytes;
+
+   pthread_mutex_unlock( &mStdArenaLock );
+
+   return (iStdSample_t *) BlockPtr;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdArenaFree
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Give up an array of samples for reuse.
+**
+** Description:
+**    Arrays carved from the arena are kept for reuse by other columns.
+**    Those allocated individually are freed, so a long-lived process,
+**    such as a worker serving requests, does not hold on to the memory
+**    its largest request needed.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    iStdSample_t *SamplesPtr  (in)
+**       Array no longer needed.
+**    Int32_t Class             (in)
+**       Size class of the array.
+**
+*****************************************************************************/
+static void mStdArenaFree ( iStdSample_t *SamplesPtr, Int32_t Class )
+{
+   if ( M_STD_CLASS_BYTES( Class ) > M_STD_ARENA_MAX )
+   {
+      TTL_FREE( SamplesPtr );
+      return;
+   }
+
+   pthread_mutex_lock( &mStdArenaLock );
+   *(void **) SamplesPtr = mStdFreeList[ Class ];
+   mStdFreeList[ Class ] = SamplesPtr;
+   pthread_mutex_unlock( &mStdArenaLock );
+}
@@ -0,0 +1,602 @@
+/*****************************************************************************
+** Module Name:
+**     StdTail.c
+**
+** Purpose:
+**     Follow the Sdb file being written, returning its records as they
+**     are appended.
+**
+** Description:
+**     The SDB appends the records of the current hour to the hour's file
+**     as they are received. Rather than wait for the hour to end and read
+**     the whole file, the file is kept open and each call returns only
+**     the records appended since the last, read from the offset the last
+**     call reached. Only whole records, or whole blocks of a version 2
+**     file, are read, so a record the SDB is part way through writing is
+**     left to be read once it is complete.
+**
+**     Once the SDB has moved on to the next hour's file, or the hour is
+**     over and no file for the next has appeared, what is left of the
+**     hour's file is read and the next hour's followed. The caller waits
+**     for more records with eStdTailWait, woken by inotify where the
+**     directory may be watched, else after a given time. Changes made
+**     over NFS by another host are not notified, so the time should not
+**     be too long.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Include files */
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Where the directory may be watched for changes, see Wfl.h */
+#ifdef E_WFL_OS_LINUX
+#include <sys/inotify.h>
+#endif
+
+/* Local definitions */
+
+#define M_STD_TAIL_BLOCKS   8    /* Blocks of a version 2 file read at once */
+#define M_STD_TAIL_RECORDS  ( M_STD_TAIL_BLOCKS * E_SDB_BLOCK_RECORDS ) /* Records returned at once */
+#define M_STD_TAIL_EVENTS   4096 /* Bytes of inotify events read at once */
+
+/* The hour's file being followed */
+struct eStdTail_s
+{
+   char             Path[ FILENAME_MAX ];     /* Directory of the Sdb files */
+   char             FilePath[ FILENAME_MAX + 16 ]; /* File of the hour followed */
+   Int32_t          Hour;       /* Start of the hour followed */
+   int              Fd;         /* The file, -1 until it has been created */
+   off_t            Offset;     /* Bytes of it read, 0 until its header is */
+   Bool_t           Blocked;    /* File is block-structured (version 2) */
+   Uint32_t         BlockNum;   /* Next block of a block-structured file */
+   eTtlTime_t       TimeHour;   /* Time the file's records are offset from */
+   eSdbDataBlock_t *BlocksPtr;  /* Blocks read from a block-structured file */
+   eSdbRawFmt_t    *DataPtr;    /* Records returned */
+   int              NotifyFd;   /* Watch on the directory, -1 if none */
+};
+
+/* Local function prototypes */
+static void     mStdTailName ( eStdTail_t *TailPtr );
+static Bool_t   mStdTailMovedOn ( eStdTail_t *TailPtr );
+static Status_t mStdTailHeader ( eStdTail_t *TailPtr );
+static Status_t mStdTailRead ( eStdTail_t *TailPtr, size_t *NumRecordsPtr );
+
+
+/*****************************************************************************
+** Function Name:
+**    eStdTailOpen
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Start following the Sdb files of an archive.
+**
+** Description:
+**    The file of the hour holding the start time is followed first,
+**    from its first record, whether or not it has yet been created.
+**    Records before the start time are not skipped.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_FILE_OPEN_ERR if the path
+**       is too long, or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    eTtlTime_t   StartTime   (in)
+**       Time in the first hour followed.
+**    char        *PathPtr     (in)
+**       Directory of the Sdb files, ending in '/'.
+**    eStdTail_t **TailPtr     (out)
+**       The follower, until closed with eStdTailClose, or NULL after an
+**       error.
+**
+*****************************************************************************/
+Status_t eStdTailOpen( eTtlTime_t StartTime, char *PathPtr, eStdTail_t **TailPtr )
+{
+   eStdTail_t *NewPtr;   /* The follower */
+
+   *TailPtr = NULL;
+
+   if ( strlen( PathPtr ) + 16 > FILENAME_MAX )
+   {
+      return E_STD_FILE_OPEN_ERR;
+   }
+
+   NewPtr = (eStdTail_t *) TTL_CALLOC( 1, sizeof( eStdTail_t ) );
+   if ( NewPtr == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   strcpy( NewPtr->Path, PathPtr );
+   NewPtr->Hour     = ( StartTime.t_sec / E_STD_SECONDS_PER_HOUR ) * E_STD_SECONDS_PER_HOUR;
+   NewPtr->Fd       = -1;
+   NewPtr->NotifyFd = -1;
+
+   NewPtr->DataPtr   = (eSdbRawFmt_t *) TTL_MALLOC( M_STD_TAIL_RECORDS * sizeof( eSdbRawFmt_t ) );
+   NewPtr->BlocksPtr = (eSdbDataBlock_t *) TTL_MALLOC( M_STD_TAIL_BLOCKS * sizeof( eSdbDataBlock_t ) );
+   if ( ( NewPtr->DataPtr == NULL ) || ( NewPtr->BlocksPtr == NULL ) )
+   {
+      eStdTailClose( NewPtr );
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+#ifdef E_WFL_OS_LINUX
+   /* Without a watch the caller is only woken after the time it gives */
+   NewPtr->NotifyFd = inotify_init();
+   if ( NewPtr->NotifyFd >= 0 )
+   {
+      fcntl( NewPtr->NotifyFd, F_SETFL, O_NONBLOCK );
+      if ( inotify_add_watch( NewPtr->NotifyFd,
+                              ( PathPtr[0] == '\0' ) ? "." : PathPtr,
+                              IN_MODIFY | IN_CREATE | IN_MOVED_TO ) < 0 )
+      {
+         close( NewPtr->NotifyFd );
+         NewPtr->NotifyFd = -1;
+      }
+   }
+#endif
+
+   mStdTailName( NewPtr );
+   eLogNotice(0,"Following %s", NewPtr->FilePath);
+
+   *TailPtr = NewPtr;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdTailNext
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Return the records appended to the file being followed.
+**
+** Description:
+**    Does not wait. The records returned are those appended since the
+**    last call, up to a chunk of them, all of one hour, so the caller
+**    should call again until none are returned, then wait. If the SDB
+**    has moved on to the next hour, the rest of the current hour's file
+**    is returned and the next hour's file followed. A block of a version
+**    2 file which fails its checks is passed over with a warning. The
+**    records remain owned by the follower and are only valid until the
+**    next call.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_READ_HEAD_ERR if a file is
+**       not an Sdb file, or E_STD_READ_DATA_ERR.
+**
+** Arguments:
+**    eStdTail_t    *TailPtr         (in/out)
+**       The follower.
+**    eSdbRawFmt_t **SdbDataPtr      (out)
+**       The records.
+**    size_t        *NumRecordsPtr   (out)
+**       Number of records, 0 if none have been appended.
+**
+*****************************************************************************/
+Status_t eStdTailNext( eStdTail_t *TailPtr, eSdbRawFmt_t **SdbDataPtr,
+                       size_t *NumRecordsPtr )
+{
+   Status_t Status;    /* Return value of function calls */
+   Bool_t   MovedOn;   /* Nothing more will be written to the hour's file */
+
+   *SdbDataPtr    = TailPtr->DataPtr;
+   *NumRecordsPtr = 0;
+
+   for ( ; ; )
+   {
+      /* Known before the last of the file is read, so none is missed */
+      MovedOn = mStdTailMovedOn( TailPtr );
+
+      if ( TailPtr->Fd < 0 )
+      {
+         TailPtr->Fd = open( TailPtr->FilePath, O_RDONLY );
+      }
+
+      if ( ( TailPtr->Fd >= 0 ) && ( TailPtr->Offset == 0 ) )
+      {
+         Status = mStdTailHeader( TailPtr );
+         if ( Status != SYS_NOMINAL )
+         {
+            return Status;
+         }
+      }
+
+      if ( TailPtr->Offset > 0 )
+      {
+         Status = mStdTailRead( TailPtr, NumRecordsPtr );
+         if ( ( Status != SYS_NOMINAL ) || ( *NumRecordsPtr > 0 ) )
+         {
+            return Status;
+         }
+      }
+
+      if ( MovedOn == FALSE )
+      {
+         return SYS_NOMINAL;
+      }
+
+      /* Go on to the next hour's file */
+      if ( TailPtr->Fd >= 0 )
+      {
+         close( TailPtr->Fd );
+         TailPtr->Fd = -1;
+      }
+      TailPtr->Hour    += E_STD_SECONDS_PER_HOUR;
+      TailPtr->Offset   = 0;
+      TailPtr->BlockNum = 0;
+      mStdTailName( TailPtr );
+      eLogNotice(0,"Following %s", TailPtr->FilePath);
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdTailTime
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Calculate the time stamp of a record returned by a follower.
+**
+** Description:
+**    Adds the time offset held in the record to the start of the hour of
+**    the file the follower last returned records from.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    eStdTail_t   *TailPtr        (in)
+**       The follower the record was returned by.
+**    eSdbRawFmt_t *SdbLinePtr     (in)
+**       The record.
+**    eTtlTime_t   *TimeStampPtr   (out)
+**       Time stamp when datum was submitted.
+**
+*****************************************************************************/
+Status_t eStdTailTime( eStdTail_t *TailPtr, eSdbRawFmt_t *SdbLinePtr,
+                       eTtlTime_t *TimeStampPtr )
+{
+   eTtlTime_t TimeOffset;   /* Offset of the record into its hour */
+
+   TimeOffset.t_sec  = SdbLinePtr->TimeOffset / E_TTL_MICROSECS_PER_SEC;
+   TimeOffset.t_nsec = (SdbLinePtr->TimeOffset % (long)E_TTL_MICROSECS_PER_SEC) *
+                       ((long)E_TTL_NANOSECS_PER_SEC / (long)E_TTL_MICROSECS_PER_SEC);
+
+   return eTimSum( &(TailPtr->TimeHour), &TimeOffset, TimeStampPtr );
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdTailWait
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Wait for records to be appended to the file being followed.
+**
+** Description:
+**    Returns once a file in the archive's directory has been written to
+**    or created, as notified by inotify, or once the time given has
+**    passed, whichever is first. Also returns early if a signal is
+**    caught, so the caller may stop.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdTail_t *TailPtr   (in)
+**       The follower.
+**    Int32_t     Seconds   (in)
+**       Longest time to wait.
+**
+*****************************************************************************/
+Status_t eStdTailWait( eStdTail_t *TailPtr, Int32_t Seconds )
+{
+   struct timeval Timeout;                      /* Longest time to wait */
+   fd_set         ReadFds;                      /* Watch waited on */
+   char           Events[ M_STD_TAIL_EVENTS ];  /* Notifications, not needed */
+
+   Timeout.tv_sec  = Seconds;
+   Timeout.tv_usec = 0;
+
+   if ( TailPtr->NotifyFd < 0 )
+   {
+      select( 0, NULL, NULL, NULL, &Timeout );
+      return SYS_NOMINAL;
+   }
+
+   FD_ZERO( &ReadFds );
+   FD_SET( TailPtr->NotifyFd, &ReadFds );
+   if ( select( TailPtr->NotifyFd + 1, &ReadFds, NULL, NULL, &Timeout ) > 0 )
+   {
+      /* Only that something changed matters, so the events are discarded */
+      while ( read( TailPtr->NotifyFd, Events, sizeof( Events ) ) > 0 )
+      {
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    eStdTailClose
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Stop following the Sdb files of an archive.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL.
+**
+** Arguments:
+**    eStdTail_t *TailPtr   (in)
+**       The follower, may be NULL.
+**
+*****************************************************************************/
+Status_t eStdTailClose( eStdTail_t *TailPtr )
+{
+   if ( TailPtr == NULL )
+   {
+      return SYS_NOMINAL;
+   }
+
+   if ( TailPtr->Fd >= 0 )
+   {
+      close( TailPtr->Fd );
+   }
+   if ( TailPtr->NotifyFd >= 0 )
+   {
+      close( TailPtr->NotifyFd );
+   }
+   TTL_FREE( TailPtr->DataPtr );
+   TTL_FREE( TailPtr->BlocksPtr );
+   TTL_FREE( TailPtr );
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdTailName
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Form the name of the file of the hour being followed.
+**
+** Description:
+**    As "yymmddhh.sdb" in local time, the name the SDB writes it by.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdTail_t *TailPtr   (in/out)
+**       The follower.
+**
+*****************************************************************************/
+static void mStdTailName( eStdTail_t *TailPtr )
+{
+   time_t    Seconds;   /* Start of the hour */
+   struct tm Tm;        /* Broken down */
+
+   Seconds = (time_t) TailPtr->Hour;
+   localtime_r( &Seconds, &Tm );
+   sprintf( TailPtr->FilePath, "%s%.2d%.2d%.2d%.2d.sdb", TailPtr->Path,
+            Tm.tm_year % 100, ( Tm.tm_mon + 1 ) % 100, Tm.tm_mday % 100,
+            Tm.tm_hour % 100 );
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdTailMovedOn
+**
+** Type:
+**    Bool_t
+**
+** Purpose:
+**    Find whether the SDB has finished with the hour being followed.
+**
+** Description:
+**    It has once the next hour's file has been created, or the hour has
+**    been over for longer than its file may still be written to.
+**
+** Return type:
+**    Bool_t
+**       TRUE if nothing more will be written to the hour's file.
+**
+** Arguments:
+**    eStdTail_t *TailPtr   (in)
+**       The follower.
+**
+*****************************************************************************/
+static Bool_t mStdTailMovedOn( eStdTail_t *TailPtr )
+{
+   eStdTail_t  Next;       /* The next hour, to name its file */
+   struct stat FileStat;   /* Status of its file */
+
+   if ( (Int32_t) time( NULL ) >= TailPtr->Hour + E_STD_SECONDS_PER_HOUR + I_STD_CAT_SETTLE )
+   {
+      return TRUE;
+   }
+
+   strcpy( Next.Path, TailPtr->Path );
+   Next.Hour = TailPtr->Hour + E_STD_SECONDS_PER_HOUR;
+   mStdTailName( &Next );
+
+   return ( stat( Next.FilePath, &FileStat ) == 0 ) ? TRUE : FALSE;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdTailHeader
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the header of the file being followed.
+**
+** Description:
+**    Gives the version of the file and the start of its hour. Nothing is
+**    read until the whole header has been written.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or E_STD_READ_HEAD_ERR if the
+**       file is not an Sdb file.
+**
+** Arguments:
+**    eStdTail_t *TailPtr   (in/out)
+**       The follower, with the file open.
+**
+*****************************************************************************/
+static Status_t mStdTailHeader( eStdTail_t *TailPtr )
+{
+   char     Header[ I_STD_RECORDS_START ];   /* Magic and start of the hour */
+   Uint32_t Seconds;                         /* Start of the hour */
+
+   if ( pread( TailPtr->Fd, Header, sizeof( Header ), 0 ) != (ssize_t) sizeof( Header ) )
+   {
+      return SYS_NOMINAL;
+   }
+
+   if ( memcmp( Header, E_SDB_HEADER_STRING_V2, E_STD_FILE_HDR_SIZE ) == 0 )
+   {
+      TailPtr->Blocked = TRUE;
+   }
+   else if ( memcmp( Header, E_SDB_HEADER_STRING, E_STD_FILE_HDR_SIZE ) == 0 )
+   {
+      TailPtr->Blocked = FALSE;
+   }
+   else
+   {
+      eLogErr(E_STD_READ_HEAD_ERR,"%s is not an Sdb file", TailPtr->FilePath);
+      return E_STD_READ_HEAD_ERR;
+   }
+
+   memcpy( &Seconds, Header + E_STD_FILE_HDR_SIZE, sizeof( Seconds ) );
+   TailPtr->TimeHour.t_sec  = (Int32_t) Seconds;
+   TailPtr->TimeHour.t_nsec = 0;
+   TailPtr->Offset          = I_STD_RECORDS_START;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdTailRead
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Read the whole records appended to the file being followed.
+**
+** Description:
+**    Reads on from where the last read ended, up to a chunk of records.
+**    A record, or block, only partly written is left for the next read.
+**    Blocks which fail their checks are read past, so that none are
+**    returned only if none have been appended.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or E_STD_READ_DATA_ERR.
+**
+** Arguments:
+**    eStdTail_t *TailPtr         (in/out)
+**       The follower, with the file's header read.
+**    size_t     *NumRecordsPtr   (out)
+**       Number of records read into the follower.
+**
+*****************************************************************************/
+static Status_t mStdTailRead( eStdTail_t *TailPtr, size_t *NumRecordsPtr )
+{
+   ssize_t          NumBytes;     /* Bytes read */
+   size_t           NumBlocks;    /* Whole blocks read */
+   size_t           i;            /* Block read */
+   eSdbDataBlock_t *BlockPtr;     /* The block */
+
+   *NumRecordsPtr = 0;
+
+   if ( TailPtr->Blocked == FALSE )
+   {
+      NumBytes = pread( TailPtr->Fd, TailPtr->DataPtr,
+                        M_STD_TAIL_RECORDS * sizeof( eSdbRawFmt_t ), TailPtr->Offset );
+      if ( NumBytes < 0 )
+      {
+         eLogErr(E_STD_READ_DATA_ERR,"Unable to read %s", TailPtr->FilePath);
+         return E_STD_READ_DATA_ERR;
+      }
+      *NumRecordsPtr   = (size_t) NumBytes / sizeof( eSdbRawFmt_t );
+      TailPtr->Offset += *NumRecordsPtr * sizeof( eSdbRawFmt_t );
+      return SYS_NOMINAL;
+   }
+
+   do
+   {
+      NumBytes = pread( TailPtr->Fd, TailPtr->BlocksPtr,
+                        M_STD_TAIL_BLOCKS * E_SDB_BLOCK_SIZE, TailPtr->Offset );
+      if ( NumBytes < 0 )
+      {
+         eLogErr(E_STD_READ_DATA_ERR,"Unable to read %s", TailPtr->FilePath);
+         return E_STD_READ_DATA_ERR;
+      }
+      NumBlocks = (size_t) NumBytes / E_SDB_BLOCK_SIZE;
+
+      for ( i = 0; i < NumBlocks; i++ )
+      {
+         BlockPtr = TailPtr->BlocksPtr + i;
+         if ( eSdbBlockCheck( BlockPtr ) != SYS_NOMINAL )
+         {
+            eLogWarning(E_STD_READ_DATA_ERR, "Block %u of %s is corrupt, skipped",
+                        TailPtr->BlockNum + (Uint32_t) i, TailPtr->FilePath);
+            continue;
+         }
+         memcpy( TailPtr->DataPtr + *NumRecordsPtr, BlockPtr->Records,
+                 BlockPtr->Hdr.NumRecords * sizeof( eSdbRawFmt_t ) );
+         *NumRecordsPtr += BlockPtr->Hdr.NumRecords;
+      }
+
+      TailPtr->Offset   += (off_t) ( NumBlocks * E_SDB_BLOCK_SIZE );
+      TailPtr->BlockNum += (Uint32_t) NumBlocks;
+
+   } while ( ( NumBlocks > 0 ) && ( *NumRecordsPtr == 0 ) );
+
+   return SYS_NOMINAL;
+}
@@ -0,0 +1,794 @@
+/*****************************************************************************
+** Module Name:
+**     StdThread.c
+**
+** Purpose:
+**     Search a long time range of Sdb files using several threads.
+**
+** Description:
+**     Each Sdb file holds an hour of data, so the hours of the search are
+**     shared out between a pool of worker threads. A worker reads its
+**     hour with its own eStdReader_t, stores the matching data in columns
+**     of its own and sorts them. The main thread takes the hours in turn,
+**     waiting for each to be finished, and appends their data to the
+**     outputs, so the data reaches the outputs in time order.
+**
+**     Workers only run a limited number of hours ahead of the hour being
+**     appended, so the memory used does not grow with the time range.
+**     Each hour in progress has a slot of its own, reused once the hour
+**     has been appended.
+**
+**     Strides depend on the order records are found, so when one is
+**     given the workers leave their data in the order found and the
+**     stride is applied as the data is appended, exactly as it would be
+**     when reading the hours one after another.
+**
+**     Given the rollup switch, a worker also keeps every record of its
+**     hour, which is fed to the rollup archive as the hour is appended,
+**     so the days are rolled up in order, as by a single thread.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+**
+** Version:
+**      $Id$
+**
+** History:
+**      $Log$
+**
+**
+*****************************************************************************/
+
+/* Local include files */
+#include "StdPrivate.h"
+
+/* Local definitions */
+
+#define M_STD_ROLLUP_MIN  4096   /* Records of an hour allowed for initially */
+
+/* A record of an hour kept to be rolled up */
+typedef struct mStdRecord_s
+{
+   eSdbCode_t    Code;      /* Storage code */
+   eTtlTime_t    TimeStamp; /* Time of the record */
+   Int32_t       Value;
+} mStdRecord_t;
+
+/* Data found in a single hour, for every output */
+typedef struct mStdHour_s
+{
+   Bool_t        Done;      /* Set once the hour has been searched */
+   Status_t      Status;    /* Outcome of the search */
+   iStdOutput_t *Outputs;   /* Columns of each output for this hour */
+   mStdRecord_t *Samples;   /* Every record of the hour, when rolling up */
+   size_t        NumSamples; /* Number of them */
+   size_t        MaxSamples; /* Records there is room for */
+} mStdHour_t;
+
+/* State shared between the main thread and the workers */
+typedef struct mStdPool_s
+{
+   pthread_mutex_t Lock;       /* Guards everything below */
+   pthread_cond_t  Changed;    /* Signalled when an hour is done or used */
+   eTtlTime_t      StartTime;  /* Start of the search */
+   eTtlTime_t      StopTime;   /* End of the search */
+   Int32_t         FirstHour;  /* Start of the first hour searched */
+   Int32_t         NumHours;   /* Number of hours searched */
+   Int32_t         NextHour;   /* Next hour to be given to a worker */
+   Int32_t         Appended;   /* Number of hours appended to the outputs */
+   Int32_t         NumSlots;   /* Most hours in progress at once */
+   mStdHour_t     *Slots;      /* Hour H is held in slot H % NumSlots */
+   Bool_t          Abort;      /* Set to make the workers give up */
+} mStdPool_t;
+
+/* Local variables */
+static mStdPool_t mStdPool;
+
+/* Local function prototypes */
+static void    *mStdWorker ( void *ArgPtr );
+static Status_t mStdSearchHour ( Int32_t Hour, mStdHour_t *SlotPtr );
+static Status_t mStdAppendHour ( mStdHour_t *SlotPtr );
+static Status_t mStdKeepSample ( mStdHour_t *SlotPtr, eSdbCode_t Code,
+                                 eTtlTime_t TimeStamp, Int32_t Value );
+static void     mStdRollupSlot ( Int32_t Hour, mStdHour_t *SlotPtr );
+static Status_t mStdSlotsCreate ( void );
+static void     mStdSlotsDestroy ( void );
+
+/*****************************************************************************
+** Function Name:
+**    iStdSearchThreaded
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Search the Sdb files between two times using several threads.
+**
+** Description:
+**    Starts iStdGlobVar.NumThreads workers, fewer if there are fewer
+**    hours, then appends the data of each hour to the outputs in turn.
+**    The lookup must already have been built. Once this returns, the
+**    outputs are filled just as if the hours had been read one after
+**    another.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, E_STD_THREAD_ERR if the threads
+**       could not be started, or the first error met by a worker.
+**
+** Arguments:
+**    eTtlTime_t StartTime      (in)
+**       Start of the search.
+**    eTtlTime_t StopTime       (in)
+**       End of the search.
+**
+*****************************************************************************/
+Status_t iStdSearchThreaded ( eTtlTime_t StartTime, eTtlTime_t StopTime )
+{
+   Status_t    Status;                          /* Return value of function calls */
+   pthread_t   Threads[ I_STD_MAX_THREADS ];    /* Worker threads */
+   Int32_t     NumThreads;                      /* Number of worker threads */
+   Int32_t     Hour;                            /* Hour being appended */
+   Int32_t     i;                               /* Counter */
+   mStdHour_t *SlotPtr;                         /* Slot of hour being appended */
+
+   mStdPool.StartTime = StartTime;
+   mStdPool.StopTime  = StopTime;
+   mStdPool.FirstHour = ( StartTime.t_sec / (Int32_t) E_TTL_SECS_PER_HOUR )
+                        * E_TTL_SECS_PER_HOUR;
+   mStdPool.NumHours  = ( StopTime.t_sec - mStdPool.FirstHour )
+                        / E_STD_SECONDS_PER_HOUR + 1;
+   mStdPool.NextHour  = 0;
+   mStdPool.Appended  = 0;
+   mStdPool.Abort     = FALSE;
+
+   NumThreads = iStdGlobVar.NumThreads;
+   if ( NumThreads > mStdPool.NumHours )
+   {
+      NumThreads = mStdPool.NumHours;
+   }
+   mStdPool.NumSlots = NumThreads * I_STD_HOURS_AHEAD;
+
+   eLogNotice( 0, "Searching %d hours with %d threads",
+               mStdPool.NumHours, NumThreads );
+
+   Status = mStdSlotsCreate( );
+   if ( Status != SYS_NOMINAL )
+   {
+      mStdSlotsDestroy( );
+      return Status;
+   }
+
+   pthread_mutex_init( &mStdPool.Lock, NULL );
+   pthread_cond_init( &mStdPool.Changed, NULL );
+
+   for ( i = 0; i < NumThreads; i++ )
+   {
+      if ( pthread_create( &Threads[i], NULL, mStdWorker, NULL ) != 0 )
+      {
+         /* Let those already started finish */
+         NumThreads = i;
+         Status     = E_STD_THREAD_ERR;
+         break;
+      }
+   }
+
+   /* Append each hour to the outputs as soon as it has been searched */
+   for ( Hour = 0; ( Status == SYS_NOMINAL ) && ( Hour < mStdPool.NumHours ); Hour++ )
+   {
+      SlotPtr = mStdPool.Slots + ( Hour % mStdPool.NumSlots );
+
+      pthread_mutex_lock( &mStdPool.Lock );
+      while ( SlotPtr->Done == FALSE )
+      {
+         pthread_cond_wait( &mStdPool.Changed, &mStdPool.Lock );
+      }
+      pthread_mutex_unlock( &mStdPool.Lock );
+
+      Status = SlotPtr->Status;
+      if ( Status == SYS_NOMINAL )
+      {
+         Status = mStdAppendHour( SlotPtr );
+      }
+      if ( Status == SYS_NOMINAL )
+      {
+         mStdRollupSlot( Hour, SlotPtr );
+      }
+
+      /* Free the slot for a later hour */
+      for ( i = 0; i < iStdGlobVar.NumOutputs; i++ )
+      {
+         iStdClearData( SlotPtr->Outputs + i );
+      }
+      SlotPtr->NumSamples = 0;
+
+      pthread_mutex_lock( &mStdPool.Lock );
+      SlotPtr->Done     = FALSE;
+      mStdPool.Appended = Hour + 1;
+      pthread_cond_broadcast( &mStdPool.Changed );
+      pthread_mutex_unlock( &mStdPool.Lock );
+   }
+
+   /* Stop the workers early following an error */
+   pthread_mutex_lock( &mStdPool.Lock );
+   if ( Status != SYS_NOMINAL )
+   {
+      mStdPool.Abort = TRUE;
+   }
+   pthread_cond_broadcast( &mStdPool.Changed );
+   pthread_mutex_unlock( &mStdPool.Lock );
+
+   for ( i = 0; i < NumThreads; i++ )
+   {
+      pthread_join( Threads[i], NULL );
+   }
+
+   pthread_cond_destroy( &mStdPool.Changed );
+   pthread_mutex_destroy( &mStdPool.Lock );
+
+   mStdSlotsDestroy( );
+
+   return Status;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdWorker
+**
+** Type:
+**    void *
+**
+** Purpose:
+**    Body of each worker thread.
+**
+** Description:
+**    Repeatedly takes the next hour still to be searched and searches it,
+**    waiting while it would get too far ahead of the hours appended to
+**    the outputs. Returns once every hour has been taken or the search
+**    is aborted.
+**
+** Return type:
+**    void *
+**       Always NULL.
+**
+** Arguments:
+**    void *ArgPtr              (in)
+**       Not used.
+**
+*****************************************************************************/
+static void *mStdWorker ( void *ArgPtr )
+{
+   Status_t    Status;    /* Outcome of searching an hour */
+   Int32_t     Hour;      /* Hour being searched */
+   mStdHour_t *SlotPtr;   /* Slot the hour is searched into */
+
+   (void) ArgPtr;
+
+   pthread_mutex_lock( &mStdPool.Lock );
+
+   for ( ;; )
+   {
+      while ( ( mStdPool.Abort == FALSE ) &&
+              ( mStdPool.NextHour < mStdPool.NumHours ) &&
+              ( mStdPool.NextHour >= mStdPool.Appended + mStdPool.NumSlots ) )
+      {
+         pthread_cond_wait( &mStdPool.Changed, &mStdPool.Lock );
+      }
+
+      if ( ( mStdPool.Abort == TRUE ) ||
+           ( mStdPool.NextHour >= mStdPool.NumHours ) )
+      {
+         break;
+      }
+
+      Hour    = mStdPool.NextHour++;
+      SlotPtr = mStdPool.Slots + ( Hour % mStdPool.NumSlots );
+
+      pthread_mutex_unlock( &mStdPool.Lock );
+      Status = mStdSearchHour( Hour, SlotPtr );
+      pthread_mutex_lock( &mStdPool.Lock );
+
+      SlotPtr->Status = Status;
+      SlotPtr->Done   = TRUE;
+      pthread_cond_broadcast( &mStdPool.Changed );
+   }
+
+   pthread_mutex_unlock( &mStdPool.Lock );
+
+   return NULL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSearchHour
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Search the Sdb file of a single hour.
+**
+** Description:
+**    Stores every record routed to a column of an output, and within the
+**    time range of that output, in the slot's copy of the column. Unless
+**    there is a stride the columns are then sorted.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    Int32_t Hour              (in)
+**       Index of the hour from the start of the search.
+**    mStdHour_t *SlotPtr       (in/out)
+**       Slot to store the data in.
+**
+*****************************************************************************/
+static Status_t mStdSearchHour ( Int32_t Hour, mStdHour_t *SlotPtr )
+{
+   Status_t       Status;                /* Return value of function calls */
+   eStdReader_t  *ReaderPtr;             /* Reader of the hour's Sdb file */
+   eSdbRawFmt_t  *SdbDataPtr;            /* Pointer to chunk of Sdb data */
+   eSdbRawFmt_t  *SdbLinePtr;            /* Current line of Sdb */
+   size_t         NumRecords;            /* Number of records in chunk */
+   size_t         CurrentLine;           /* Index of current line */
+   Bool_t         Finished;              /* Flag to indicate hour is finished */
+   eTtlTime_t     HourTime;              /* Start of the hour */
+   eTtlTime_t     HourEnd;               /* Last second of the hour searched */
+   eTtlTime_t     TimeStamp;             /* Timestamp of current Sdb datum */
+   Int32_t        Target;                /* Index of current routing target */
+   iStdTarget_t  *TargetPtr;             /* Current routing target */
+   iStdOutput_t  *OutputPtr;             /* Output routed to */
+   iStdOutput_t  *HourPtr;               /* Slot's columns for the output */
+   Int32_t        k;                     /* Counter stepping through outputs */
+   Bool_t         RollUp;                /* Every record is rolled up */
+   char           TimeStr[ E_TIM_BUFFER_LENGTH ];
+
+   HourTime.t_sec  = mStdPool.FirstHour + Hour * E_STD_SECONDS_PER_HOUR;
+   HourTime.t_nsec = 0;
+   HourEnd.t_sec   = HourTime.t_sec + E_STD_SECONDS_PER_HOUR - 1;
+   HourEnd.t_nsec  = 0;
+
+   /* The first and last hours may only be wanted in part */
+   if ( mStdPool.StartTime.t_sec > HourTime.t_sec )
+   {
+      HourTime = mStdPool.StartTime;
+   }
+   if ( mStdPool.StopTime.t_sec < HourEnd.t_sec )
+   {
+      HourEnd = mStdPool.StopTime;
+   }
+
+   Status = eStdReaderOpen( HourTime, HourEnd, iStdGlobVar.DatPath, &ReaderPtr );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   /* The rollup needs every record, not just those wanted */
+   RollUp = ( iStdGlobVar.RollupDir[0] != '\0' ) ? TRUE : FALSE;
+
+   Status = eStdReaderChunk( ReaderPtr, iStdGlobVar.ChunkSize );
+   if ( ( Status == SYS_NOMINAL ) && ( RollUp == FALSE ) )
+   {
+      Status = eStdReaderCodes( ReaderPtr, iStdGlobVar.Lookup.Wanted,
+                                iStdGlobVar.Lookup.NumCodes );
+   }
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = eStdReaderCatalog( ReaderPtr, iStdGlobVar.CatalogPtr );
+   }
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = eStdReaderColumns( ReaderPtr, iStdGlobVar.ColumnsPtr );
+   }
+   if ( Status == SYS_NOMINAL )
+   {
+      Status = eStdReaderFiles( ReaderPtr, iStdGlobVar.FilesPtr );
+   }
+   if ( Status != SYS_NOMINAL )
+   {
+      eStdReaderClose( ReaderPtr );
+      return Status;
+   }
+
+   do
+   {
+      Status = eStdReaderNext( ReaderPtr, &SdbDataPtr, &NumRecords, &Finished );
+      if ( Status != SYS_NOMINAL )
+      {
+         eStdReaderClose( ReaderPtr );
+         return Status;
+      }
+
+      for ( CurrentLine = 0; CurrentLine < NumRecords; CurrentLine++ )
+      {
+         SdbLinePtr = SdbDataPtr + CurrentLine;
+
+         Target = iStdLookupFind( SdbLinePtr->Code );
+         if ( ( Target < 0 ) && ( RollUp == FALSE ) )
+         {
+            continue;
+         }
+
+         Status = eStdReaderTime( ReaderPtr, SdbLinePtr, &TimeStamp );
+         if ( ( Status == SYS_NOMINAL ) && ( RollUp == TRUE ) )
+         {
+            Status = mStdKeepSample( SlotPtr, SdbLinePtr->Code, TimeStamp,
+                                     SdbLinePtr->Value );
+         }
+         if ( Status != SYS_NOMINAL )
+         {
+            eStdReaderClose( ReaderPtr );
+            return Status;
+         }
+
+         for ( ; Target >= 0; Target = TargetPtr->Next )
+         {
+            TargetPtr = iStdGlobVar.Lookup.Targets + Target;
+            OutputPtr = iStdGlobVar.Outputs + TargetPtr->Output;
+            HourPtr   = SlotPtr->Outputs + TargetPtr->Output;
+
+            /* Check to see if data is within time range we want */
+            if ( ( TimeStamp.t_sec < OutputPtr->TtlStartTime.t_sec ) ||
+                 ( TimeStamp.t_sec > OutputPtr->TtlStopTime.t_sec ) )
+            {
+               continue;
+            }
+
+            /* Without a stride, all data in range is wanted */
+            if ( ( iStdGlobVar.Stride == 0 ) && ( eCluCommon.DebugLevel >= E_LOG_INFO ) )
+            {
+               iStdFormatTimeString( &TimeStamp, TimeStr );
+               eLogInfo("Got data match. Writing data %s %d",TimeStr,SdbLinePtr->Value);
+            }
+
+            Status = iStdStoreData( HourPtr, TimeStamp, TargetPtr->Column,
+                                    SdbLinePtr->Value );
+            if ( Status != SYS_NOMINAL )
+            {
+               eStdReaderClose( ReaderPtr );
+               return Status;
+            }
+            HourPtr->StdData[ TargetPtr->Column ].NumOfPoints++;
+         }
+      }
+
+   } while ( !Finished );
+
+   eStdReaderClose( ReaderPtr );
+
+   if ( iStdGlobVar.Stride == 0 )
+   {
+      for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+      {
+         Status = iStdSortData( SlotPtr->Outputs + k );
+         if ( Status != SYS_NOMINAL )
+         {
+            return Status;
+         }
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdAppendHour
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Append the data found in an hour to the outputs.
+**
+** Description:
+**    Without a stride the sorted columns are appended whole, and when
+**    strides are summarised they are then folded into the summaries.
+**    Otherwise each sample is checked against the stride of its column in
+**    the order it was found, as in the single threaded search.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success.
+**
+** Arguments:
+**    mStdHour_t *SlotPtr       (in)
+**       Slot holding the hour's data.
+**
+*****************************************************************************/
+static Status_t mStdAppendHour ( mStdHour_t *SlotPtr )
+{
+   Status_t       Status;                /* Return value of function calls */
+   iStdOutput_t  *OutputPtr;             /* Output being appended to */
+   iStdData_t    *StdDataPtr;            /* Column being appended to */
+   iStdData_t    *FromPtr;               /* Column being appended */
+   iStdSample_t  *SamplePtr;             /* Sample being appended */
+   Int32_t        i;                     /* Counter stepping through samples */
+   Int32_t        j;                     /* Counter stepping through columns */
+   Int32_t        k;                     /* Counter stepping through outputs */
+   char           TimeStr[ E_TIM_BUFFER_LENGTH ];
+
+   for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+   {
+      OutputPtr = iStdGlobVar.Outputs + k;
+
+      for ( j = 0; j < OutputPtr->NumDataSearch; j++ )
+      {
+         StdDataPtr = OutputPtr->StdData + j;
+         FromPtr    = SlotPtr->Outputs[k].StdData + j;
+
+         if ( iStdGlobVar.Stride == 0 )
+         {
+            Status = iStdAppendData( OutputPtr, j, FromPtr );
+            if ( Status != SYS_NOMINAL )
+            {
+               return Status;
+            }
+            OutputPtr->LinesOfData  += FromPtr->NumOfPoints;
+            StdDataPtr->NumOfPoints += FromPtr->NumOfPoints;
+            continue;
+         }
+
+         for ( i = 0; i < FromPtr->NumSamples; i++ )
+         {
+            SamplePtr = FromPtr->Samples + i;
+            if ( SamplePtr->TimeStamp.t_sec < StdDataPtr->NextStrideTime.t_sec )
+            {
+               continue;
+            }
+
+            /* Increment the next-stride-time by the stride */
+            StdDataPtr->NextStrideTime.t_sec += iStdGlobVar.Stride;
+
+            /* The time of datum is only worth converting if it is logged */
+            if ( eCluCommon.DebugLevel >= E_LOG_INFO )
+            {
+               iStdFormatTimeString( &SamplePtr->TimeStamp, TimeStr );
+               eLogInfo("Got data match. Writing data %s %d",TimeStr,SamplePtr->Value);
+            }
+
+            Status = iStdStoreData( OutputPtr, SamplePtr->TimeStamp, j,
+                                    SamplePtr->Value );
+            if ( Status != SYS_NOMINAL )
+            {
+               return Status;
+            }
+            OutputPtr->LinesOfData++;
+            StdDataPtr->NumOfPoints++;
+         }
+      }
+
+      /* Only the summaries of strides are kept, not the hour's samples */
+      if ( iStdGlobVar.Window > 0 )
+      {
+         Status = iStdSummariseData( OutputPtr );
+         if ( Status != SYS_NOMINAL )
+         {
+            return Status;
+         }
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdKeepSample
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Keep a record of an hour, to be rolled up once the hour is appended.
+**
+** Description:
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    mStdHour_t *SlotPtr       (in/out)
+**       Slot of the hour.
+**    eSdbCode_t  Code          (in)
+**       Storage code of the record.
+**    eTtlTime_t  TimeStamp     (in)
+**       Time of the record.
+**    Int32_t     Value         (in)
+**       Value of the record.
+**
+*****************************************************************************/
+static Status_t mStdKeepSample ( mStdHour_t *SlotPtr, eSdbCode_t Code,
+                                 eTtlTime_t TimeStamp, Int32_t Value )
+{
+   mStdRecord_t *NewSamplesPtr;   /* Records once more room is made */
+   mStdRecord_t *SamplePtr;       /* Record being kept */
+
+   if ( SlotPtr->NumSamples == SlotPtr->MaxSamples )
+   {
+      SlotPtr->MaxSamples = SlotPtr->MaxSamples == 0 ? M_STD_ROLLUP_MIN :
+                            SlotPtr->MaxSamples * 2;
+      NewSamplesPtr = (mStdRecord_t *) TTL_REALLOC( SlotPtr->Samples,
+                         sizeof( mStdRecord_t ) * SlotPtr->MaxSamples );
+      if ( NewSamplesPtr == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+      SlotPtr->Samples = NewSamplesPtr;
+   }
+
+   SamplePtr = SlotPtr->Samples + SlotPtr->NumSamples++;
+   SamplePtr->Code      = Code;
+   SamplePtr->TimeStamp = TimeStamp;
+   SamplePtr->Value     = Value;
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdRollupSlot
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Feed the records kept of an hour to the rollup archive.
+**
+** Description:
+**    Called as each hour is appended, so the hours are fed in order.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    Int32_t     Hour          (in)
+**       Index of the hour from the start of the search.
+**    mStdHour_t *SlotPtr       (in)
+**       Slot holding the hour's records.
+**
+*****************************************************************************/
+static void mStdRollupSlot ( Int32_t Hour, mStdHour_t *SlotPtr )
+{
+   eTtlTime_t  HourTime;    /* Start of the hour */
+   size_t      i;           /* Record being fed */
+
+   if ( iStdGlobVar.RollupDir[0] == '\0' )
+   {
+      return;
+   }
+
+   HourTime.t_sec  = mStdPool.FirstHour + Hour * E_STD_SECONDS_PER_HOUR;
+   HourTime.t_nsec = 0;
+   iStdRollupHour( HourTime );
+
+   for ( i = 0; i < SlotPtr->NumSamples; i++ )
+   {
+      iStdRollupAdd( SlotPtr->Samples[i].Code, SlotPtr->Samples[i].TimeStamp,
+                     SlotPtr->Samples[i].Value );
+   }
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSlotsCreate
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Create the slots holding the hours in progress.
+**
+** Description:
+**    Each slot has a copy of every output's columns. Only the samples of
+**    the copies are used.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_MEM_ALLOC_ERR.
+**
+** Arguments:
+**    None.
+**
+*****************************************************************************/
+static Status_t mStdSlotsCreate ( void )
+{
+   mStdHour_t   *SlotPtr;    /* Slot being created */
+   iStdOutput_t *HourPtr;    /* Slot's copy of an output */
+   Int32_t       i;          /* Counter stepping through slots */
+   Int32_t       k;          /* Counter stepping through outputs */
+
+   mStdPool.Slots = (mStdHour_t *) TTL_CALLOC( mStdPool.NumSlots, sizeof( mStdHour_t ) );
+   if ( mStdPool.Slots == NULL )
+   {
+      return E_STD_MEM_ALLOC_ERR;
+   }
+
+   for ( i = 0; i < mStdPool.NumSlots; i++ )
+   {
+      SlotPtr = mStdPool.Slots + i;
+      SlotPtr->Done    = FALSE;
+      SlotPtr->Outputs = (iStdOutput_t *) TTL_CALLOC( iStdGlobVar.NumOutputs,
+                                                      sizeof( iStdOutput_t ) );
+      if ( SlotPtr->Outputs == NULL )
+      {
+         return E_STD_MEM_ALLOC_ERR;
+      }
+
+      for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+      {
+         HourPtr = SlotPtr->Outputs + k;
+         HourPtr->StdData = (iStdData_t *) TTL_CALLOC( iStdGlobVar.Outputs[k].NumDataSearch + 1,
+                                                       sizeof( iStdData_t ) );
+         if ( HourPtr->StdData == NULL )
+         {
+            return E_STD_MEM_ALLOC_ERR;
+         }
+         HourPtr->NumDataSearch = iStdGlobVar.Outputs[k].NumDataSearch;
+         HourPtr->MaxDataSearch = iStdGlobVar.Outputs[k].NumDataSearch;
+      }
+   }
+
+   return SYS_NOMINAL;
+}
+
+/*****************************************************************************
+** Function Name:
+**    mStdSlotsDestroy
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Free the slots and the data they hold.
+**
+** Description:
+**    Copes with slots that were only partly created.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    None.
+**
+*****************************************************************************/
+static void mStdSlotsDestroy ( void )
+{
+   mStdHour_t   *SlotPtr;    /* Slot being freed */
+   Int32_t       i;          /* Counter stepping through slots */
+   Int32_t       k;          /* Counter stepping through outputs */
+
+   if ( mStdPool.Slots == NULL )
+   {
+      return;
+   }
+
+   for ( i = 0; i < mStdPool.NumSlots; i++ )
+   {
+      SlotPtr = mStdPool.Slots + i;
+      if ( SlotPtr->Outputs == NULL )
+      {
+         continue;
+      }
+
+      for ( k = 0; k < iStdGlobVar.NumOutputs; k++ )
+      {
+         if ( SlotPtr->Outputs[k].StdData != NULL )
+         {
+            iStdFreeData( SlotPtr->Outputs + k );
+            TTL_FREE( SlotPtr->Outputs[k].StdData );
+         }
+      }
+      TTL_FREE( SlotPtr->Outputs );
+      if ( SlotPtr->Samples != NULL )
+      {
+         TTL_FREE( SlotPtr->Samples );
+      }
+   }
+
+   TTL_FREE( mStdPool.Slots );
+   mStdPool.Slots = NULL;
+}
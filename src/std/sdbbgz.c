@@ -0,0 +1,227 @@
+/*
+** Module Name:
+**    sdbbgz.c
+**
+** Purpose:
+**    A utility to convert the Sdb files of an archive to block-compressed
+**    ones.
+**
+** Description:
+**    Converts each plain or gzipped Sdb file below the archive's
+**    directory to a "yymmddhh.sdb.bgz" file beside it, which Std can
+**    inflate from any block, see eStdBgzfArchive. Several files are
+**    converted at once. The files converted are noted in the checkpoint
+**    file, so that running again after an interruption carries on where
+**    it left off, e.g.
+**
+**       sdbbgz -archive /sdb -checkpoint /sdb_puller/bgz.done -replace
+**
+**    With the replace switch each original is removed once its
+**    conversion has been checked.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+** Version:
+**    $Id$
+**
+** History:
+**    $Log$
+**
+**
+*/
+
+
+/* Include files */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "TtlSystem.h"
+#include "Wfl.h"
+#include "Clu.h"
+#include "Log.h"
+#include "Std.h"
+
+
+/* Application details - normally found in XxxPrivate.h */
+
+#define I_BGZ_PROGRAM_NAME   "sdbbgz"
+#define I_BGZ_PROGRAM_ABOUT  "Convert an SDB archive to block-compressed files"
+#define I_BGZ_RELEASE_DATE   "17 October 2026"
+#define I_BGZ_YEAR           "2026"
+#define I_BGZ_MAJOR_VERSION  0
+#define I_BGZ_MINOR_VERSION  1
+
+/* Common arguments defaults */
+
+#define M_BGZ_DFLT_QUIET     FALSE
+#define M_BGZ_DFLT_VERBOSE   TRUE
+#define M_BGZ_DFLT_SYSLOG    TRUE
+#define M_BGZ_DFLT_DEBUG     E_LOG_NOTICE
+#define M_BGZ_DFLT_PRIORITY  9
+#define M_BGZ_DFLT_HELP      FALSE
+#ifdef E_WFL_OS_QNX4
+#define M_BGZ_DFLT_CONFIG    "/opt/ttl/etc/sdbbgz.cfg"
+#define M_BGZ_DFLT_CIL_MAP   "/opt/ttl/etc/Cil.map"
+#else
+#define M_BGZ_DFLT_CONFIG    "/ttl/sw/etc/sdbbgz.cfg"
+#define M_BGZ_DFLT_CIL_MAP   "/ttl/sw/etc/Cil.map"
+#endif
+#define M_BGZ_DFLT_LOG       "sdbbgz.txt"
+#define M_BGZ_DFLT_CIL       "TU0"
+#define M_BGZ_DFLT_THREADS   4
+
+/* custom arguments - note that these must match the order in eCluCustomArg[] */
+
+#define M_BGZ_CUSTOM_ARCHIVE    0
+#define M_BGZ_CUSTOM_CHECKPOINT 1
+#define M_BGZ_CUSTOM_THREADS    2
+#define M_BGZ_CUSTOM_REPLACE    3
+
+#define M_BGZ_CUSTOM_ARGS       4
+
+
+/* for parsing custom command-line arguments */
+
+eCluArgSpec_t eCluCustomArg[ M_BGZ_CUSTOM_ARGS + 1 ] =
+/*  arg [param],    match, description,                       FALSE, NULL */
+{ { "archive <dir>",   1, "Directory of the SDB files",       FALSE, NULL },
+  { "checkpoint <file>",1,"File noting the files converted",  FALSE, NULL },
+  { "threads <n>",     1, "Number of files converted at once",FALSE, NULL },
+  { "replace",         1, "Remove each original once checked",FALSE, NULL },
+  { E_CLU_EOL,         0, E_CLU_EOL,                          FALSE, NULL }
+};
+
+
+int main(
+   int argc,
+   char *argv[]
+)
+{
+/*
+** Function Name:
+**    main
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Top level function of the "sdbbgz" program.
+**
+** Description:
+**    Converts the archive, reporting the number of files converted and
+**    of those which could not be. Failures are logged as they occur.
+**
+** Arguments:
+**    int argc                 (in)
+**       Number of arguments on the command line (including the
+**       executable name).
+**    char *argv[]             (in)
+**       Array of null-terminated character strings containing
+**       the command line arguments.
+**
+*/
+
+   /* Local variables */
+   Status_t   CluStatus;     /* Return value from called CLU functions */
+   Status_t   Status;        /* Return value from called functions */
+   char       Switch[ E_CLU_SWITCH_LEN ];/* to report error parsing a switch */
+   char      *CheckpointPtr; /* File noting the files converted */
+   Int32_t    NumThreads;    /* Files converted at once */
+   Bool_t     Replace;       /* Remove each original */
+   Uint32_t   NumDone;       /* Files converted */
+   Uint32_t   NumFailed;     /* Files not converted */
+
+   CheckpointPtr = NULL;
+   NumThreads    = M_BGZ_DFLT_THREADS;
+   Replace       = FALSE;
+
+   /* data for command-line utilities */
+   eCluProgNamePtr              = I_BGZ_PROGRAM_NAME;
+   eCluProgAboutPtr             = I_BGZ_PROGRAM_ABOUT;
+   eCluReleaseDatePtr           = I_BGZ_RELEASE_DATE;
+   eCluYearPtr                  = I_BGZ_YEAR;
+   eCluMajorVer                 = I_BGZ_MAJOR_VERSION;
+   eCluMinorVer                 = I_BGZ_MINOR_VERSION;
+
+   /* set default parameters before parsing command-line */
+   eCluCommon.Quiet             = M_BGZ_DFLT_QUIET;
+   eCluCommon.Verbose           = M_BGZ_DFLT_VERBOSE;
+   eCluCommon.Syslog            = M_BGZ_DFLT_SYSLOG;
+   eCluCommon.DebugLevel        = M_BGZ_DFLT_DEBUG;
+   eCluCommon.Priority          = M_BGZ_DFLT_PRIORITY;
+   eCluCommon.Help              = M_BGZ_DFLT_HELP;
+   strcpy( eCluCommon.ConfigFile, M_BGZ_DFLT_CONFIG  );
+   strcpy( eCluCommon.LogFile,    M_BGZ_DFLT_LOG     );
+   strcpy( eCluCommon.CilName,    M_BGZ_DFLT_CIL     );
+   strcpy( eCluCommon.CilMap,     M_BGZ_DFLT_CIL_MAP );
+
+   /* register with the command-line utilities (CLU) */
+   CluStatus = eCluSetup( argc, argv,
+                          E_CLU_IGN_QUIET | E_CLU_IGN_VERBOSE
+                           | E_CLU_IGN_PRIORITY | E_CLU_IGN_CONFIGFILE
+                           | E_CLU_IGN_CIL_NAME );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      printf( "Error parsing the command-line\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   /* parse the incoming command-line */
+   CluStatus = eCluParseArgs( Switch );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      eCluShowUsage( NULL, NULL );
+      printf( "Error parsing the command-line switch '%s'\n", Switch );
+      exit( EXIT_FAILURE );
+   }
+
+   /* check for help requested */
+   if ( eCluCommon.Help == TRUE )
+   {
+      exit( EXIT_SUCCESS );
+   }
+
+   /* if archive unspecified */
+   if ( eCluCustomArgExists( M_BGZ_CUSTOM_ARCHIVE ) != E_CLU_ARG_SUPPLIED )
+   {
+      eCluShowUsage( NULL, NULL );
+      exit( EXIT_SUCCESS );
+   }
+
+   if ( eCluCustomArgExists( M_BGZ_CUSTOM_CHECKPOINT ) == E_CLU_ARG_SUPPLIED )
+   {
+      CheckpointPtr = eCluGetCustomParam( M_BGZ_CUSTOM_CHECKPOINT );
+   }
+   if ( eCluCustomArgExists( M_BGZ_CUSTOM_THREADS ) == E_CLU_ARG_SUPPLIED )
+   {
+      NumThreads = (Int32_t) strtol( eCluGetCustomParam( M_BGZ_CUSTOM_THREADS ), NULL, 0 );
+   }
+   if ( eCluCustomArgExists( M_BGZ_CUSTOM_REPLACE ) == E_CLU_ARG_SUPPLIED )
+   {
+      Replace = TRUE;
+   }
+
+   Status = eCluSignOn( NULL, NULL );
+   if ( Status != SYS_NOMINAL )
+   {
+      printf( "Error: Failed to sign-on (%d = 0x%x)\n", Status, Status );
+      exit( EXIT_FAILURE );
+   }
+
+   Status = eStdBgzfArchive( eCluGetCustomParam( M_BGZ_CUSTOM_ARCHIVE ), CheckpointPtr,
+                             NumThreads, Replace, &NumDone, &NumFailed );
+   if ( Status != SYS_NOMINAL )
+   {
+      printf( "Error: unable to convert %s (0x%x)\n",
+              eCluGetCustomParam( M_BGZ_CUSTOM_ARCHIVE ), Status );
+      exit( EXIT_FAILURE );
+   }
+
+   fprintf( stderr, "%s: %lu files converted, %lu failed\n",
+            eCluGetCustomParam( M_BGZ_CUSTOM_ARCHIVE ),
+            (unsigned long) NumDone, (unsigned long) NumFailed );
+
+   return NumFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,298 @@
+/*
+** Module Name:
+**    sdbbundle.c
+**
+** Purpose:
+**    A utility to bundle the hourly files of days or months of an Sdb
+**    archive.
+**
+** Description:
+**    Bundles the Sdb files of each day named into a single file beside
+**    them, or with the month switch those of each month, so that a
+**    search opens one file per day or month, see eStdBundleBuild. A day
+**    is given as yyyy/mm/dd, defaulting to yesterday, or for months to
+**    a day of last month, and with the days switch the days, or months,
+**    before it are bundled too, e.g.
+**
+**       sdbbundle -path /sdb -days 7 -replace
+**       sdbbundle -path /sdb -month
+**
+**    A month may be bundled from the bundles of its days. With the
+**    replace switch the files bundled are removed. Std reads bundles in
+**    place of the files they hold, unaided.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+** Version:
+**    $Id$
+**
+** History:
+**    $Log$
+**
+**
+*/
+
+
+/* Include files */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "TtlSystem.h"
+#include "Wfl.h"
+#include "Clu.h"
+#include "Log.h"
+#include "Std.h"
+
+
+/* Application details - normally found in XxxPrivate.h */
+
+#define I_BUN_PROGRAM_NAME   "sdbbundle"
+#define I_BUN_PROGRAM_ABOUT  "Bundle the hourly files of an SDB archive"
+#define I_BUN_RELEASE_DATE   "17 October 2026"
+#define I_BUN_YEAR           "2026"
+#define I_BUN_MAJOR_VERSION  0
+#define I_BUN_MINOR_VERSION  1
+
+/* Common arguments defaults */
+
+#define M_BUN_DFLT_QUIET     FALSE
+#define M_BUN_DFLT_VERBOSE   TRUE
+#define M_BUN_DFLT_SYSLOG    TRUE
+#define M_BUN_DFLT_DEBUG     E_LOG_NOTICE
+#define M_BUN_DFLT_PRIORITY  9
+#define M_BUN_DFLT_HELP      FALSE
+#ifdef E_WFL_OS_QNX4
+#define M_BUN_DFLT_CONFIG    "/opt/ttl/etc/sdbbundle.cfg"
+#define M_BUN_DFLT_CIL_MAP   "/opt/ttl/etc/Cil.map"
+#else
+#define M_BUN_DFLT_CONFIG    "/ttl/sw/etc/sdbbundle.cfg"
+#define M_BUN_DFLT_CIL_MAP   "/ttl/sw/etc/Cil.map"
+#endif
+#define M_BUN_DFLT_LOG       "sdbbundle.txt"
+#define M_BUN_DFLT_CIL       "TU0"
+#define M_BUN_DFLT_DAYS      1
+#define M_BUN_SECS_PER_DAY   86400
+#define M_BUN_TIME_FORMAT    "%Y/%m/%d"
+#define M_BUN_MONTH_FORMAT   "%Y/%m"
+#define M_BUN_TIME_LEN       16
+
+/* custom arguments - note that these must match the order in eCluCustomArg[] */
+
+#define M_BUN_CUSTOM_PATH    0
+#define M_BUN_CUSTOM_DAY     1
+#define M_BUN_CUSTOM_DAYS    2
+#define M_BUN_CUSTOM_MONTH   3
+#define M_BUN_CUSTOM_REPLACE 4
+
+#define M_BUN_CUSTOM_ARGS    5
+
+
+/* for parsing custom command-line arguments */
+
+eCluArgSpec_t eCluCustomArg[ M_BUN_CUSTOM_ARGS + 1 ] =
+/*  arg [param],    match, description,                       FALSE, NULL */
+{ { "path <dir>",      1, "Directory of the SDB files",       FALSE, NULL },
+  { "day <yyyy/mm/dd>",2, "Last day, or day of last month, to bundle", FALSE, NULL },
+  { "days <n>",        4, "Number of days, or months, to bundle", FALSE, NULL },
+  { "month",           1, "Bundle months rather than days",   FALSE, NULL },
+  { "replace",         1, "Remove the files bundled",         FALSE, NULL },
+  { E_CLU_EOL,         0, E_CLU_EOL,                          FALSE, NULL }
+};
+
+
+int main(
+   int argc,
+   char *argv[]
+)
+{
+/*
+** Function Name:
+**    main
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Top level function of the "sdbbundle" program.
+**
+** Description:
+**    Bundles each day or month in turn, oldest first, reporting the
+**    number of hours bundled of each. One which has not yet ended is
+**    skipped.
+**
+** Arguments:
+**    int argc                 (in)
+**       Number of arguments on the command line (including the
+**       executable name).
+**    char *argv[]             (in)
+**       Array of null-terminated character strings containing
+**       the command line arguments.
+**
+*/
+
+   /* Local variables */
+   Status_t   CluStatus;     /* Return value from called CLU functions */
+   Status_t   Status;        /* Return value from called functions */
+   char       Switch[ E_CLU_SWITCH_LEN ];/* to report error parsing a switch */
+   char      *PathPtr;       /* Directory of the Sdb files */
+   struct tm  DayTm;         /* Last day to bundle */
+   struct tm  PeriodTm;      /* Day or month being bundled */
+   time_t     LastDay;       /* Noon of the last day to bundle */
+   time_t     Noon;          /* Noon of the day being bundled */
+   eTtlTime_t Period;        /* Day or month being bundled */
+   Bool_t     Months;        /* Bundle months rather than days */
+   Bool_t     Replace;       /* Remove the files bundled */
+   int        Year;          /* Date given by the day switch */
+   int        Month;
+   int        Date;
+   long       NumDays;       /* Number of days or months to bundle */
+   long       i;             /* Days or months before the last */
+   char       DayText[ M_BUN_TIME_LEN ];/* Day being bundled, as text */
+   Uint32_t   NumHours;      /* Hours bundled of a day or month */
+   int        NumFailed;     /* Number not bundled */
+
+   PathPtr = E_STD_DFLT_SDB_PATH;
+   NumDays = M_BUN_DFLT_DAYS;
+
+   /* data for command-line utilities */
+   eCluProgNamePtr              = I_BUN_PROGRAM_NAME;
+   eCluProgAboutPtr             = I_BUN_PROGRAM_ABOUT;
+   eCluReleaseDatePtr           = I_BUN_RELEASE_DATE;
+   eCluYearPtr                  = I_BUN_YEAR;
+   eCluMajorVer                 = I_BUN_MAJOR_VERSION;
+   eCluMinorVer                 = I_BUN_MINOR_VERSION;
+
+   /* set default parameters before parsing command-line */
+   eCluCommon.Quiet             = M_BUN_DFLT_QUIET;
+   eCluCommon.Verbose           = M_BUN_DFLT_VERBOSE;
+   eCluCommon.Syslog            = M_BUN_DFLT_SYSLOG;
+   eCluCommon.DebugLevel        = M_BUN_DFLT_DEBUG;
+   eCluCommon.Priority          = M_BUN_DFLT_PRIORITY;
+   eCluCommon.Help              = M_BUN_DFLT_HELP;
+   strcpy( eCluCommon.ConfigFile, M_BUN_DFLT_CONFIG  );
+   strcpy( eCluCommon.LogFile,    M_BUN_DFLT_LOG     );
+   strcpy( eCluCommon.CilName,    M_BUN_DFLT_CIL     );
+   strcpy( eCluCommon.CilMap,     M_BUN_DFLT_CIL_MAP );
+
+   /* register with the command-line utilities (CLU) */
+   CluStatus = eCluSetup( argc, argv,
+                          E_CLU_IGN_QUIET | E_CLU_IGN_VERBOSE
+                           | E_CLU_IGN_PRIORITY | E_CLU_IGN_CONFIGFILE
+                           | E_CLU_IGN_CIL_NAME );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      printf( "Error parsing the command-line\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   /* parse the incoming command-line */
+   CluStatus = eCluParseArgs( Switch );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      eCluShowUsage( NULL, NULL );
+      printf( "Error parsing the command-line switch '%s'\n", Switch );
+      exit( EXIT_FAILURE );
+   }
+
+   /* check for help requested */
+   if ( eCluCommon.Help == TRUE )
+   {
+      exit( EXIT_SUCCESS );
+   }
+
+   Months  = ( eCluCustomArgExists( M_BUN_CUSTOM_MONTH ) == E_CLU_ARG_SUPPLIED ) ? TRUE : FALSE;
+   Replace = ( eCluCustomArgExists( M_BUN_CUSTOM_REPLACE ) == E_CLU_ARG_SUPPLIED ) ? TRUE : FALSE;
+
+   if ( eCluCustomArgExists( M_BUN_CUSTOM_PATH ) == E_CLU_ARG_SUPPLIED )
+   {
+      PathPtr = eCluGetCustomParam( M_BUN_CUSTOM_PATH );
+   }
+
+   if ( eCluCustomArgExists( M_BUN_CUSTOM_DAYS ) == E_CLU_ARG_SUPPLIED )
+   {
+      NumDays = strtol( eCluGetCustomParam( M_BUN_CUSTOM_DAYS ), NULL, 0 );
+      if ( NumDays < 1 )
+      {
+         printf( "Error: at least one day must be bundled\n" );
+         exit( EXIT_FAILURE );
+      }
+   }
+
+   /* Take noon of the last day, which no change of daylight saving moves */
+   LastDay = time( NULL ) - M_BUN_SECS_PER_DAY;
+   localtime_r( &LastDay, &DayTm );
+   if ( Months == TRUE )
+   {
+      DayTm.tm_mday = 1;
+      DayTm.tm_mon--;
+   }
+   if ( eCluCustomArgExists( M_BUN_CUSTOM_DAY ) == E_CLU_ARG_SUPPLIED )
+   {
+      if ( sscanf( eCluGetCustomParam( M_BUN_CUSTOM_DAY ), "%d/%d/%d",
+                   &Year, &Month, &Date ) != 3 )
+      {
+         printf( "Error: day '%s' is not yyyy/mm/dd\n",
+                 eCluGetCustomParam( M_BUN_CUSTOM_DAY ) );
+         exit( EXIT_FAILURE );
+      }
+      DayTm.tm_year = Year - 1900;
+      DayTm.tm_mon  = Month - 1;
+      DayTm.tm_mday = Date;
+   }
+   DayTm.tm_hour  = 12;
+   DayTm.tm_min   = 0;
+   DayTm.tm_sec   = 0;
+   DayTm.tm_isdst = -1;
+
+   Status = eCluSignOn( NULL, NULL );
+   if ( Status != SYS_NOMINAL )
+   {
+      printf( "Error: Failed to sign-on (%d = 0x%x)\n", Status, Status );
+      exit( EXIT_FAILURE );
+   }
+
+   /* Bundle each day or month in turn, carrying on past any which fail */
+   NumFailed = 0;
+   for ( i = NumDays - 1; i >= 0; i-- )
+   {
+      PeriodTm = DayTm;
+      if ( Months == TRUE )
+      {
+         PeriodTm.tm_mday = 1;
+         PeriodTm.tm_mon -= (int) i;
+      }
+      else
+      {
+         PeriodTm.tm_mday -= (int) i;
+      }
+      PeriodTm.tm_isdst = -1;
+      Noon = mktime( &PeriodTm );
+      Period.t_sec  = Noon;
+      Period.t_nsec = 0;
+      strftime( DayText, sizeof( DayText ),
+                Months == TRUE ? M_BUN_MONTH_FORMAT : M_BUN_TIME_FORMAT,
+                localtime( &Noon ) );
+
+      Status = eStdBundleBuild( PathPtr, Period, Months, Replace, &NumHours );
+      if ( Status == SYS_NOMINAL )
+      {
+         printf( "%s: %lu hours\n", DayText, (unsigned long) NumHours );
+      }
+      else if ( Status == E_STD_TIME_OUT_RANGE )
+      {
+         printf( "%s: not yet ended\n", DayText );
+      }
+      else
+      {
+         printf( "%s: not bundled (0x%x)\n", DayText, Status );
+         NumFailed++;
+      }
+   }
+
+   return NumFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* EOF */
@@ -0,0 +1,404 @@
+/*
+** Module Name:
+**    sdbcatalog.c
+**
+** Purpose:
+**    A utility to catalog which source/datum pairs each hour of an Sdb
+**    archive holds.
+**
+** Description:
+**    Given the archive switch, brings the catalog up to date with the
+**    archive, reading only the hours added since it was last updated,
+**    see eStdCatalogUpdate. With the new switch the files of the hours
+**    added or grown are then listed, one per line, for the import
+**    daemon to work through, e.g.
+**
+**       sdbcatalog -catalog /sdb_puller/catalog/sdb.cat -archive /sdb -new
+**
+**    Given a source, and optionally a datum, of either name or number,
+**    reports when each of its datums first and last appeared and in how
+**    many hours, listing those hours with the hours switch, e.g.
+**
+**       sdbcatalog -catalog /sdb_puller/catalog/sdb.cat -source AZM -hours
+**
+**    Otherwise the extent of the catalog is reported.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+** Version:
+**    $Id$
+**
+** History:
+**    $Log$
+**
+**
+*/
+
+
+/* Include files */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "TtlSystem.h"
+#include "Wfl.h"
+#include "Clu.h"
+#include "Log.h"
+#include "Std.h"
+
+
+/* Application details - normally found in XxxPrivate.h */
+
+#define I_CAT_PROGRAM_NAME   "sdbcatalog"
+#define I_CAT_PROGRAM_ABOUT  "Catalog the source/datum pairs of an SDB archive"
+#define I_CAT_RELEASE_DATE   "17 October 2026"
+#define I_CAT_YEAR           "2026"
+#define I_CAT_MAJOR_VERSION  0
+#define I_CAT_MINOR_VERSION  1
+
+/* Common arguments defaults */
+
+#define M_CAT_DFLT_QUIET     FALSE
+#define M_CAT_DFLT_VERBOSE   TRUE
+#define M_CAT_DFLT_SYSLOG    TRUE
+#define M_CAT_DFLT_DEBUG     E_LOG_NOTICE
+#define M_CAT_DFLT_PRIORITY  9
+#define M_CAT_DFLT_HELP      FALSE
+#ifdef E_WFL_OS_QNX4
+#define M_CAT_DFLT_CONFIG    "/opt/ttl/etc/sdbcatalog.cfg"
+#define M_CAT_DFLT_CIL_MAP   "/opt/ttl/etc/Cil.map"
+#else
+#define M_CAT_DFLT_CONFIG    "/ttl/sw/etc/sdbcatalog.cfg"
+#define M_CAT_DFLT_CIL_MAP   "/ttl/sw/etc/Cil.map"
+#endif
+#define M_CAT_DFLT_LOG       "sdbcatalog.txt"
+#define M_CAT_DFLT_CIL       "TU0"
+#define M_CAT_DFLT_THREADS   4
+#define M_CAT_TIME_FORMAT    "%Y/%m/%d %H:00"
+#define M_CAT_TIME_LEN       32
+
+/* custom arguments - note that these must match the order in eCluCustomArg[] */
+
+#define M_CAT_CUSTOM_CATALOG 0
+#define M_CAT_CUSTOM_ARCHIVE 1
+#define M_CAT_CUSTOM_THREADS 2
+#define M_CAT_CUSTOM_NEW     3
+#define M_CAT_CUSTOM_SOURCE  4
+#define M_CAT_CUSTOM_DATUM   5
+#define M_CAT_CUSTOM_HOURS   6
+
+#define M_CAT_CUSTOM_ARGS    7
+
+
+/* for parsing custom command-line arguments */
+
+eCluArgSpec_t eCluCustomArg[ M_CAT_CUSTOM_ARGS + 1 ] =
+/*  arg [param],    match, description,                       FALSE, NULL */
+{ { "catalog <file>",  1, "Catalog of the archive",           FALSE, NULL },
+  { "archive <dir>",   1, "Bring the catalog up to date first", FALSE, NULL },
+  { "threads <n>",     1, "Number of files read at once",     FALSE, NULL },
+  { "new",             1, "List files of the hours updated",  FALSE, NULL },
+  { "source <id>",     1, "Source to report, name or number", FALSE, NULL },
+  { "datum <id>",      1, "Datum to report, name or number",  FALSE, NULL },
+  { "hours",           1, "List the hours holding them",      FALSE, NULL },
+  { E_CLU_EOL,         0, E_CLU_EOL,                          FALSE, NULL }
+};
+
+/* Local function prototypes */
+
+static void mCatHourString( Int32_t Hour, char *TextPtr );
+
+
+int main(
+   int argc,
+   char *argv[]
+)
+{
+/*
+** Function Name:
+**    main
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Top level function of the "sdbcatalog" program.
+**
+** Description:
+**    Updates the catalog if asked, then reports on the source or datum
+**    asked for, or on the whole catalog.
+**
+** Arguments:
+**    int argc                 (in)
+**       Number of arguments on the command line (including the
+**       executable name).
+**    char *argv[]             (in)
+**       Array of null-terminated character strings containing
+**       the command line arguments.
+**
+*/
+
+   /* Local variables */
+   Status_t          CluStatus;       /* Return value from called CLU functions */
+   Status_t          Status;          /* Return value from called functions */
+   char              Switch[ E_CLU_SWITCH_LEN ];/* to report error parsing a switch */
+   eStdCatalog_t    *CatalogPtr;      /* The catalog */
+   eStdCatalogCode_t Code;            /* A code of the catalog */
+   eSdbSngReq_t      SrcDat;          /* Source and datum of a code */
+   char             *ParamPtr;        /* Parameter of a switch */
+   char             *EndPtr;          /* End of a number */
+   char              File[ FILENAME_MAX ];  /* File of an hour */
+   char              SourceName[ E_CIL_IDLEN + 1 ];        /* Name of a source */
+   char              DatumName[ E_HTI_MAX_STRING_LEN + 1 ]; /* Name of a datum */
+   char              First[ M_CAT_TIME_LEN ];   /* First hour holding a code */
+   char              Last[ M_CAT_TIME_LEN ];    /* Last hour holding a code */
+   Int32_t           SourceId;        /* Source reported */
+   Int32_t           DatumId;         /* Datum reported */
+   Int32_t           NumThreads;      /* Files read at once */
+   Int32_t           Hour;            /* Start of an hour */
+   Uint32_t          NumNew;          /* Hours added or grown */
+   Uint32_t          NumHours;        /* Hours catalogued */
+   Uint32_t          i;               /* Code or hour */
+   Bool_t            Updated;         /* An hour was updated */
+   int               NumFound;        /* Codes reported */
+
+   NumThreads = M_CAT_DFLT_THREADS;
+
+   /* data for command-line utilities */
+   eCluProgNamePtr              = I_CAT_PROGRAM_NAME;
+   eCluProgAboutPtr             = I_CAT_PROGRAM_ABOUT;
+   eCluReleaseDatePtr           = I_CAT_RELEASE_DATE;
+   eCluYearPtr                  = I_CAT_YEAR;
+   eCluMajorVer                 = I_CAT_MAJOR_VERSION;
+   eCluMinorVer                 = I_CAT_MINOR_VERSION;
+
+   /* set default parameters before parsing command-line */
+   eCluCommon.Quiet             = M_CAT_DFLT_QUIET;
+   eCluCommon.Verbose           = M_CAT_DFLT_VERBOSE;
+   eCluCommon.Syslog            = M_CAT_DFLT_SYSLOG;
+   eCluCommon.DebugLevel        = M_CAT_DFLT_DEBUG;
+   eCluCommon.Priority          = M_CAT_DFLT_PRIORITY;
+   eCluCommon.Help              = M_CAT_DFLT_HELP;
+   strcpy( eCluCommon.ConfigFile, M_CAT_DFLT_CONFIG  );
+   strcpy( eCluCommon.LogFile,    M_CAT_DFLT_LOG     );
+   strcpy( eCluCommon.CilName,    M_CAT_DFLT_CIL     );
+   strcpy( eCluCommon.CilMap,     M_CAT_DFLT_CIL_MAP );
+
+   /* register with the command-line utilities (CLU) */
+   CluStatus = eCluSetup( argc, argv,
+                          E_CLU_IGN_QUIET | E_CLU_IGN_VERBOSE
+                           | E_CLU_IGN_PRIORITY | E_CLU_IGN_CONFIGFILE
+                           | E_CLU_IGN_CIL_NAME );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      printf( "Error parsing the command-line\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   /* parse the incoming command-line */
+   CluStatus = eCluParseArgs( Switch );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      eCluShowUsage( NULL, NULL );
+      printf( "Error parsing the command-line switch '%s'\n", Switch );
+      exit( EXIT_FAILURE );
+   }
+
+   /* check for help requested */
+   if ( eCluCommon.Help == TRUE )
+   {
+      exit( EXIT_SUCCESS );
+   }
+
+   /* if catalog unspecified */
+   if ( eCluCustomArgExists( M_CAT_CUSTOM_CATALOG ) != E_CLU_ARG_SUPPLIED )
+   {
+      eCluShowUsage( NULL, NULL );
+      exit( EXIT_SUCCESS );
+   }
+
+   if ( eCluCustomArgExists( M_CAT_CUSTOM_THREADS ) == E_CLU_ARG_SUPPLIED )
+   {
+      NumThreads = (Int32_t) strtol( eCluGetCustomParam( M_CAT_CUSTOM_THREADS ), NULL, 0 );
+   }
+
+   Status = eCluSignOn( NULL, NULL );
+   if ( Status != SYS_NOMINAL )
+   {
+      printf( "Error: Failed to sign-on (%d = 0x%x)\n", Status, Status );
+      exit( EXIT_FAILURE );
+   }
+
+   if ( eCluCustomArgExists( M_CAT_CUSTOM_ARCHIVE ) == E_CLU_ARG_SUPPLIED )
+   {
+      Status = eStdCatalogUpdate( eCluGetCustomParam( M_CAT_CUSTOM_CATALOG ),
+                                  eCluGetCustomParam( M_CAT_CUSTOM_ARCHIVE ),
+                                  NumThreads, &CatalogPtr, &NumNew );
+
+      /* A file which could not be read is left to the next update */
+      if ( CatalogPtr == NULL )
+      {
+         printf( "Error: %s not updated (0x%x)\n",
+                 eCluGetCustomParam( M_CAT_CUSTOM_CATALOG ), Status );
+         exit( EXIT_FAILURE );
+      }
+      if ( Status != SYS_NOMINAL )
+      {
+         fprintf( stderr, "Warning: some files not catalogued (0x%x)\n", Status );
+      }
+      fprintf( stderr, "%s: %lu hours updated\n",
+               eCluGetCustomParam( M_CAT_CUSTOM_CATALOG ), (unsigned long) NumNew );
+   }
+   else
+   {
+      Status = eStdCatalogOpen( eCluGetCustomParam( M_CAT_CUSTOM_CATALOG ), &CatalogPtr );
+      if ( Status != SYS_NOMINAL )
+      {
+         printf( "Error: unable to read %s (0x%x)\n",
+                 eCluGetCustomParam( M_CAT_CUSTOM_CATALOG ), Status );
+         exit( EXIT_FAILURE );
+      }
+   }
+
+   /* Count the hours, listing those updated if asked */
+   NumHours = 0;
+   while ( eStdCatalogHour( CatalogPtr, NumHours, &Hour, File, &Updated ) == SYS_NOMINAL )
+   {
+      if ( ( Updated == TRUE ) &&
+           ( eCluCustomArgExists( M_CAT_CUSTOM_NEW ) == E_CLU_ARG_SUPPLIED ) )
+      {
+         printf( "%s\n", File );
+      }
+      NumHours++;
+   }
+
+   if ( eCluCustomArgExists( M_CAT_CUSTOM_SOURCE ) != E_CLU_ARG_SUPPLIED )
+   {
+      if ( eCluCustomArgExists( M_CAT_CUSTOM_NEW ) != E_CLU_ARG_SUPPLIED )
+      {
+         First[ 0 ] = Last[ 0 ] = '\0';
+         if ( eStdCatalogHour( CatalogPtr, 0, &Hour, File, &Updated ) == SYS_NOMINAL )
+         {
+            mCatHourString( Hour, First );
+            eStdCatalogHour( CatalogPtr, NumHours - 1, &Hour, File, &Updated );
+            mCatHourString( Hour, Last );
+         }
+         for ( i = 0; eStdCatalogCode( CatalogPtr, i, &Code ) == SYS_NOMINAL; i++ )
+         {
+         }
+         printf( "%lu hours from %s to %s, %lu source/datum pairs\n",
+                 (unsigned long) NumHours, First, Last, (unsigned long) i );
+      }
+      eStdCatalogClose( CatalogPtr );
+      return Status == SYS_NOMINAL ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+
+   /* Find the source, and datum, asked for */
+   ParamPtr = eCluGetCustomParam( M_CAT_CUSTOM_SOURCE );
+   SourceId = (Int32_t) strtol( ParamPtr, &EndPtr, 0 );
+   if ( ( *EndPtr != '\0' ) &&
+        ( eCilLookup( eCluCommon.CilMap, ParamPtr, &SourceId ) != SYS_NOMINAL ) )
+   {
+      printf( "Error: unknown source %s\n", ParamPtr );
+      exit( EXIT_FAILURE );
+   }
+
+   DatumId = -1;
+   if ( eCluCustomArgExists( M_CAT_CUSTOM_DATUM ) == E_CLU_ARG_SUPPLIED )
+   {
+      ParamPtr = eCluGetCustomParam( M_CAT_CUSTOM_DATUM );
+      DatumId  = (Int32_t) strtol( ParamPtr, &EndPtr, 0 );
+      if ( ( *EndPtr != '\0' ) &&
+           ( eHtiGetGeneralId( SourceId, ParamPtr, &DatumId ) != SYS_NOMINAL ) )
+      {
+         printf( "Error: unknown datum %s\n", ParamPtr );
+         exit( EXIT_FAILURE );
+      }
+   }
+
+   /* Report each datum of the source found, in order */
+   NumFound = 0;
+   for ( i = 0; eStdCatalogCode( CatalogPtr, i, &Code ) == SYS_NOMINAL; i++ )
+   {
+      if ( ( eSdbStoreIdDecode( &(Code.Code), &SrcDat ) != SYS_NOMINAL ) ||
+           ( SrcDat.SourceId != SourceId ) ||
+           ( ( DatumId >= 0 ) && ( SrcDat.DatumId != DatumId ) ) )
+      {
+         continue;
+      }
+      NumFound++;
+
+      if ( eCilName( eCluCommon.CilMap, SrcDat.SourceId, E_CIL_IDLEN, SourceName )
+           != SYS_NOMINAL )
+      {
+         sprintf( SourceName, "0x%x", SrcDat.SourceId );
+      }
+      if ( eHtiGetDataLabel( SrcDat.SourceId, SrcDat.DatumId, DatumName ) != SYS_NOMINAL )
+      {
+         sprintf( DatumName, "0x%x", SrcDat.DatumId );
+      }
+      mCatHourString( Code.FirstHour, First );
+      mCatHourString( Code.LastHour, Last );
+
+      printf( "%s %s: first %s, last %s, %lu hours, %.0f records\n",
+              SourceName, DatumName, First, Last,
+              (unsigned long) Code.NumHours, Code.NumRecords );
+
+      if ( eCluCustomArgExists( M_CAT_CUSTOM_HOURS ) == E_CLU_ARG_SUPPLIED )
+      {
+         Hour = Code.FirstHour;
+         while ( ( Hour <= Code.LastHour ) &&
+                 ( eStdCatalogNext( CatalogPtr, &(Code.Code), 1, &Hour, File )
+                   == SYS_NOMINAL ) )
+         {
+            mCatHourString( Hour, First );
+            printf( "   %s %s\n", First, File );
+            Hour += E_STD_SECONDS_PER_HOUR;
+         }
+      }
+   }
+
+   if ( NumFound == 0 )
+   {
+      printf( "Not found in any hour catalogued\n" );
+   }
+
+   eStdCatalogClose( CatalogPtr );
+
+   return EXIT_SUCCESS;
+}
+
+
+static void mCatHourString( Int32_t Hour, char *TextPtr )
+{
+/*
+** Function Name:
+**    mCatHourString
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Format the start of an hour.
+**
+** Description:
+**    The hour is given in UTC.
+**
+** Arguments:
+**    Int32_t Hour             (in)
+**       Start of the hour, seconds since the epoch.
+**    char *TextPtr            (out)
+**       The hour, M_CAT_TIME_LEN characters.
+**
+*/
+
+   /* Local variables */
+   time_t Time;              /* The hour */
+
+   Time = (time_t) Hour;
+   strftime( TextPtr, M_CAT_TIME_LEN, M_CAT_TIME_FORMAT, gmtime( &Time ) );
+}
+
+/* EOF */
@@ -0,0 +1,279 @@
+/*
+** Module Name:
+**    sdbcolumns.c
+**
+** Purpose:
+**    A utility to convert days of an Sdb archive to the columnar archive.
+**
+** Description:
+**    Converts each day named to a single file of the columnar archive,
+**    holding the records of each storage code together, so that a
+**    search for a few series reads only their records, see
+**    eStdColumnsBuild. A day is given as yyyy/mm/dd, defaulting to
+**    yesterday, and with the days switch the days before it are
+**    converted too, e.g.
+**
+**       sdbcolumns -out /sdb_puller/columns -path /sdb -days 7
+**
+**    Std then reads the converted days with its columns switch.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+** Version:
+**    $Id$
+**
+** History:
+**    $Log$
+**
+**
+*/
+
+
+/* Include files */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "TtlSystem.h"
+#include "Wfl.h"
+#include "Clu.h"
+#include "Log.h"
+#include "Std.h"
+
+
+/* Application details - normally found in XxxPrivate.h */
+
+#define I_COL_PROGRAM_NAME   "sdbcolumns"
+#define I_COL_PROGRAM_ABOUT  "Convert days of an SDB archive to columns"
+#define I_COL_RELEASE_DATE   "17 October 2026"
+#define I_COL_YEAR           "2026"
+#define I_COL_MAJOR_VERSION  0
+#define I_COL_MINOR_VERSION  1
+
+/* Common arguments defaults */
+
+#define M_COL_DFLT_QUIET     FALSE
+#define M_COL_DFLT_VERBOSE   TRUE
+#define M_COL_DFLT_SYSLOG    TRUE
+#define M_COL_DFLT_DEBUG     E_LOG_NOTICE
+#define M_COL_DFLT_PRIORITY  9
+#define M_COL_DFLT_HELP      FALSE
+#ifdef E_WFL_OS_QNX4
+#define M_COL_DFLT_CONFIG    "/opt/ttl/etc/sdbcolumns.cfg"
+#define M_COL_DFLT_CIL_MAP   "/opt/ttl/etc/Cil.map"
+#else
+#define M_COL_DFLT_CONFIG    "/ttl/sw/etc/sdbcolumns.cfg"
+#define M_COL_DFLT_CIL_MAP   "/ttl/sw/etc/Cil.map"
+#endif
+#define M_COL_DFLT_LOG       "sdbcolumns.txt"
+#define M_COL_DFLT_CIL       "TU0"
+#define M_COL_DFLT_DAYS      1
+#define M_COL_SECS_PER_DAY   86400
+#define M_COL_TIME_FORMAT    "%Y/%m/%d"
+#define M_COL_TIME_LEN       16
+
+/* custom arguments - note that these must match the order in eCluCustomArg[] */
+
+#define M_COL_CUSTOM_OUT     0
+#define M_COL_CUSTOM_PATH    1
+#define M_COL_CUSTOM_DAY     2
+#define M_COL_CUSTOM_DAYS    3
+
+#define M_COL_CUSTOM_ARGS    4
+
+
+/* for parsing custom command-line arguments */
+
+eCluArgSpec_t eCluCustomArg[ M_COL_CUSTOM_ARGS + 1 ] =
+/*  arg [param],    match, description,                       FALSE, NULL */
+{ { "out <dir>",       1, "Directory of the columnar archive", FALSE, NULL },
+  { "path <dir>",      1, "Directory of the SDB files",       FALSE, NULL },
+  { "day <yyyy/mm/dd>",2, "Last day to convert",              FALSE, NULL },
+  { "days <n>",        4, "Number of days to convert",        FALSE, NULL },
+  { E_CLU_EOL,         0, E_CLU_EOL,                          FALSE, NULL }
+};
+
+
+int main(
+   int argc,
+   char *argv[]
+)
+{
+/*
+** Function Name:
+**    main
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Top level function of the "sdbcolumns" program.
+**
+** Description:
+**    Converts each day in turn, oldest first, reporting the number of
+**    storage codes and records found in each. A day which has not yet
+**    ended is skipped.
+**
+** Arguments:
+**    int argc                 (in)
+**       Number of arguments on the command line (including the
+**       executable name).
+**    char *argv[]             (in)
+**       Array of null-terminated character strings containing
+**       the command line arguments.
+**
+*/
+
+   /* Local variables */
+   Status_t   CluStatus;     /* Return value from called CLU functions */
+   Status_t   Status;        /* Return value from called functions */
+   char       Switch[ E_CLU_SWITCH_LEN ];/* to report error parsing a switch */
+   char      *PathPtr;       /* Directory of the Sdb files */
+   struct tm  DayTm;         /* Last day to convert */
+   time_t     LastDay;       /* Noon of the last day to convert */
+   time_t     Noon;          /* Noon of the day being converted */
+   eTtlTime_t Day;           /* Day being converted */
+   int        Year;          /* Date given by the day switch */
+   int        Month;
+   int        Date;
+   long       NumDays;       /* Number of days to convert */
+   long       i;             /* Days before the last being converted */
+   char       DayText[ M_COL_TIME_LEN ];/* Day being converted, as text */
+   Uint32_t   NumCodes;      /* Storage codes found in a day */
+   Uint32_t   NumRecords;    /* Records converted of a day */
+   int        NumFailed;     /* Number of days not converted */
+
+   PathPtr = E_STD_DFLT_SDB_PATH;
+   NumDays = M_COL_DFLT_DAYS;
+
+   /* data for command-line utilities */
+   eCluProgNamePtr              = I_COL_PROGRAM_NAME;
+   eCluProgAboutPtr             = I_COL_PROGRAM_ABOUT;
+   eCluReleaseDatePtr           = I_COL_RELEASE_DATE;
+   eCluYearPtr                  = I_COL_YEAR;
+   eCluMajorVer                 = I_COL_MAJOR_VERSION;
+   eCluMinorVer                 = I_COL_MINOR_VERSION;
+
+   /* set default parameters before parsing command-line */
+   eCluCommon.Quiet             = M_COL_DFLT_QUIET;
+   eCluCommon.Verbose           = M_COL_DFLT_VERBOSE;
+   eCluCommon.Syslog            = M_COL_DFLT_SYSLOG;
+   eCluCommon.DebugLevel        = M_COL_DFLT_DEBUG;
+   eCluCommon.Priority          = M_COL_DFLT_PRIORITY;
+   eCluCommon.Help              = M_COL_DFLT_HELP;
+   strcpy( eCluCommon.ConfigFile, M_COL_DFLT_CONFIG  );
+   strcpy( eCluCommon.LogFile,    M_COL_DFLT_LOG     );
+   strcpy( eCluCommon.CilName,    M_COL_DFLT_CIL     );
+   strcpy( eCluCommon.CilMap,     M_COL_DFLT_CIL_MAP );
+
+   /* register with the command-line utilities (CLU) */
+   CluStatus = eCluSetup( argc, argv,
+                          E_CLU_IGN_QUIET | E_CLU_IGN_VERBOSE
+                           | E_CLU_IGN_PRIORITY | E_CLU_IGN_CONFIGFILE
+                           | E_CLU_IGN_CIL_NAME );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      printf( "Error parsing the command-line\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   /* parse the incoming command-line */
+   CluStatus = eCluParseArgs( Switch );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      eCluShowUsage( NULL, NULL );
+      printf( "Error parsing the command-line switch '%s'\n", Switch );
+      exit( EXIT_FAILURE );
+   }
+
+   /* check for help requested */
+   if ( eCluCommon.Help == TRUE )
+   {
+      exit( EXIT_SUCCESS );
+   }
+
+   /* if the columnar archive is unspecified */
+   if ( eCluCustomArgExists( M_COL_CUSTOM_OUT ) != E_CLU_ARG_SUPPLIED )
+   {
+      eCluShowUsage( NULL, NULL );
+      exit( EXIT_SUCCESS );
+   }
+
+   if ( eCluCustomArgExists( M_COL_CUSTOM_PATH ) == E_CLU_ARG_SUPPLIED )
+   {
+      PathPtr = eCluGetCustomParam( M_COL_CUSTOM_PATH );
+   }
+
+   if ( eCluCustomArgExists( M_COL_CUSTOM_DAYS ) == E_CLU_ARG_SUPPLIED )
+   {
+      NumDays = strtol( eCluGetCustomParam( M_COL_CUSTOM_DAYS ), NULL, 0 );
+      if ( NumDays < 1 )
+      {
+         printf( "Error: at least one day must be converted\n" );
+         exit( EXIT_FAILURE );
+      }
+   }
+
+   /* Take noon of the last day, which no change of daylight saving moves */
+   LastDay = time( NULL ) - M_COL_SECS_PER_DAY;
+   localtime_r( &LastDay, &DayTm );
+   if ( eCluCustomArgExists( M_COL_CUSTOM_DAY ) == E_CLU_ARG_SUPPLIED )
+   {
+      if ( sscanf( eCluGetCustomParam( M_COL_CUSTOM_DAY ), "%d/%d/%d",
+                   &Year, &Month, &Date ) != 3 )
+      {
+         printf( "Error: day '%s' is not yyyy/mm/dd\n",
+                 eCluGetCustomParam( M_COL_CUSTOM_DAY ) );
+         exit( EXIT_FAILURE );
+      }
+      DayTm.tm_year = Year - 1900;
+      DayTm.tm_mon  = Month - 1;
+      DayTm.tm_mday = Date;
+   }
+   DayTm.tm_hour  = 12;
+   DayTm.tm_min   = 0;
+   DayTm.tm_sec   = 0;
+   DayTm.tm_isdst = -1;
+
+   Status = eCluSignOn( NULL, NULL );
+   if ( Status != SYS_NOMINAL )
+   {
+      printf( "Error: Failed to sign-on (%d = 0x%x)\n", Status, Status );
+      exit( EXIT_FAILURE );
+   }
+
+   /* Convert each day in turn, carrying on past any which fail */
+   NumFailed = 0;
+   for ( i = NumDays - 1; i >= 0; i-- )
+   {
+      DayTm.tm_isdst = -1;
+      Noon = mktime( &DayTm ) - i * M_COL_SECS_PER_DAY;
+      Day.t_sec  = Noon;
+      Day.t_nsec = 0;
+      strftime( DayText, sizeof( DayText ), M_COL_TIME_FORMAT,
+                localtime( &Noon ) );
+
+      Status = eStdColumnsBuild( eCluGetCustomParam( M_COL_CUSTOM_OUT ),
+                                 PathPtr, Day, &NumCodes, &NumRecords );
+      if ( Status == SYS_NOMINAL )
+      {
+         printf( "%s: %lu codes, %lu records\n", DayText,
+                 (unsigned long) NumCodes, (unsigned long) NumRecords );
+      }
+      else if ( Status == E_STD_TIME_OUT_RANGE )
+      {
+         printf( "%s: not yet ended\n", DayText );
+      }
+      else
+      {
+         printf( "%s: not converted (0x%x)\n", DayText, Status );
+         NumFailed++;
+      }
+   }
+
+   return NumFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* EOF */
@@ -0,0 +1,481 @@
+/*
+** Module Name:
+**    sdbdump.c
+**
+** Purpose:
+**    A utility to write a binary output of Std as text.
+**
+** Description:
+**    Reads an output written by Std with its binary switch, see
+**    eStdBinaryOpen, and writes it in Std's default text format, a row
+**    per time stamp and a column per source/datum pair, so the two may
+**    be compared, e.g.
+**
+**       Std -conf datum.cfg -binary
+**       sdbdump -in datum.dat -out datum.txt
+**
+**    The text is written to the standard output if no file is given.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+** Version:
+**    $Id$
+**
+** History:
+**    $Log$
+**
+**
+*/
+
+
+/* Include files */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "TtlSystem.h"
+#include "Wfl.h"
+#include "Clu.h"
+#include "Log.h"
+#include "Std.h"
+
+
+/* Application details - normally found in XxxPrivate.h */
+
+#define I_DMP_PROGRAM_NAME   "sdbdump"
+#define I_DMP_PROGRAM_ABOUT  "Write a binary output of Std as text"
+#define I_DMP_RELEASE_DATE   "17 October 2026"
+#define I_DMP_YEAR           "2026"
+#define I_DMP_MAJOR_VERSION  0
+#define I_DMP_MINOR_VERSION  1
+
+/* Common arguments defaults */
+
+#define M_DMP_DFLT_QUIET     FALSE
+#define M_DMP_DFLT_VERBOSE   TRUE
+#define M_DMP_DFLT_SYSLOG    TRUE
+#define M_DMP_DFLT_DEBUG     E_LOG_NOTICE
+#define M_DMP_DFLT_PRIORITY  9
+#define M_DMP_DFLT_HELP      FALSE
+#ifdef E_WFL_OS_QNX4
+#define M_DMP_DFLT_CONFIG    "/opt/ttl/etc/sdbdump.cfg"
+#define M_DMP_DFLT_CIL_MAP   "/opt/ttl/etc/Cil.map"
+#else
+#define M_DMP_DFLT_CONFIG    "/ttl/sw/etc/sdbdump.cfg"
+#define M_DMP_DFLT_CIL_MAP   "/ttl/sw/etc/Cil.map"
+#endif
+#define M_DMP_DFLT_LOG       "sdbdump.txt"
+#define M_DMP_DFLT_CIL       "TU0"
+#define M_DMP_BATCH          4096  /* Records read at once */
+#define M_DMP_TIME_FORMAT    "%d/%m/%y\t%H:%M:%S"
+#define M_DMP_TIME_LEN       32
+
+/* custom arguments - note that these must match the order in eCluCustomArg[] */
+
+#define M_DMP_CUSTOM_IN      0
+#define M_DMP_CUSTOM_OUT     1
+
+#define M_DMP_CUSTOM_ARGS    2
+
+
+/* Local function prototypes */
+
+static Status_t mDmpHeader( eStdBinary_t *BinaryPtr, Uint32_t NumColumns,
+                            FILE *OutFilePtr );
+static void     mDmpRows( eStdBinaryRecord_t *GroupPtr, size_t NumGroup,
+                          Uint32_t NumColumns, Int32_t *ValuesPtr,
+                          Bool_t *PresentPtr, FILE *OutFilePtr );
+
+
+/* for parsing custom command-line arguments */
+
+eCluArgSpec_t eCluCustomArg[ M_DMP_CUSTOM_ARGS + 1 ] =
+/*  arg [param],    match, description,                       FALSE, NULL */
+{ { "in <file>",       1, "Binary output written by Std",     FALSE, NULL },
+  { "out <file>",      1, "Text written (default stdout)",    FALSE, NULL },
+  { E_CLU_EOL,         0, E_CLU_EOL,                          FALSE, NULL }
+};
+
+
+int main(
+   int argc,
+   char *argv[]
+)
+{
+/*
+** Function Name:
+**    main
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Top level function of the "sdbdump" program.
+**
+** Description:
+**    Writes the header naming the columns, then reads the records in
+**    batches. Records sharing a time stamp are gathered and written as
+**    rows, see mDmpRows.
+**
+** Arguments:
+**    int argc                 (in)
+**       Number of arguments on the command line (including the
+**       executable name).
+**    char *argv[]             (in)
+**       Array of null-terminated character strings containing
+**       the command line arguments.
+**
+*/
+
+   /* Local variables */
+   Status_t            CluStatus;    /* Return value from called CLU functions */
+   Status_t            Status;       /* Return value from called functions */
+   char                Switch[ E_CLU_SWITCH_LEN ];/* to report error parsing a switch */
+   eStdBinary_t       *BinaryPtr;    /* Binary output being read */
+   FILE               *OutFilePtr;   /* Text written */
+   Uint32_t            NumColumns;   /* Columns of the output */
+   eStdBinaryRecord_t *RecordsPtr;   /* Records read at once */
+   eStdBinaryRecord_t *GroupPtr;     /* Records sharing a time stamp */
+   eStdBinaryRecord_t *NewGroupPtr;  /* Group once more room is made */
+   size_t              MaxGroup;     /* Records there is room for in the group */
+   size_t              NumGroup;     /* Records in the group */
+   size_t              NumRead;      /* Records read at once */
+   size_t              i;            /* Record read */
+   Int32_t            *ValuesPtr;    /* Value of each column of a row */
+   Bool_t             *PresentPtr;   /* Whether each column has a value */
+
+   /* data for command-line utilities */
+   eCluProgNamePtr              = I_DMP_PROGRAM_NAME;
+   eCluProgAboutPtr             = I_DMP_PROGRAM_ABOUT;
+   eCluReleaseDatePtr           = I_DMP_RELEASE_DATE;
+   eCluYearPtr                  = I_DMP_YEAR;
+   eCluMajorVer                 = I_DMP_MAJOR_VERSION;
+   eCluMinorVer                 = I_DMP_MINOR_VERSION;
+
+   /* set default parameters before parsing command-line */
+   eCluCommon.Quiet             = M_DMP_DFLT_QUIET;
+   eCluCommon.Verbose           = M_DMP_DFLT_VERBOSE;
+   eCluCommon.Syslog            = M_DMP_DFLT_SYSLOG;
+   eCluCommon.DebugLevel        = M_DMP_DFLT_DEBUG;
+   eCluCommon.Priority          = M_DMP_DFLT_PRIORITY;
+   eCluCommon.Help              = M_DMP_DFLT_HELP;
+   strcpy( eCluCommon.ConfigFile, M_DMP_DFLT_CONFIG  );
+   strcpy( eCluCommon.LogFile,    M_DMP_DFLT_LOG     );
+   strcpy( eCluCommon.CilName,    M_DMP_DFLT_CIL     );
+   strcpy( eCluCommon.CilMap,     M_DMP_DFLT_CIL_MAP );
+
+   /* register with the command-line utilities (CLU) */
+   CluStatus = eCluSetup( argc, argv,
+                          E_CLU_IGN_QUIET | E_CLU_IGN_VERBOSE
+                           | E_CLU_IGN_PRIORITY | E_CLU_IGN_CONFIGFILE
+                           | E_CLU_IGN_CIL_NAME );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      printf( "Error parsing the command-line\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   /* parse the incoming command-line */
+   CluStatus = eCluParseArgs( Switch );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      eCluShowUsage( NULL, NULL );
+      printf( "Error parsing the command-line switch '%s'\n", Switch );
+      exit( EXIT_FAILURE );
+   }
+
+   /* check for help requested */
+   if ( eCluCommon.Help == TRUE )
+   {
+      exit( EXIT_SUCCESS );
+   }
+
+   /* if the binary output is unspecified */
+   if ( eCluCustomArgExists( M_DMP_CUSTOM_IN ) != E_CLU_ARG_SUPPLIED )
+   {
+      eCluShowUsage( NULL, NULL );
+      exit( EXIT_SUCCESS );
+   }
+
+   OutFilePtr = stdout;
+   if ( eCluCustomArgExists( M_DMP_CUSTOM_OUT ) == E_CLU_ARG_SUPPLIED )
+   {
+      OutFilePtr = fopen( eCluGetCustomParam( M_DMP_CUSTOM_OUT ), "w" );
+      if ( OutFilePtr == NULL )
+      {
+         printf( "Error: unable to open '%s'\n",
+                 eCluGetCustomParam( M_DMP_CUSTOM_OUT ) );
+         exit( EXIT_FAILURE );
+      }
+   }
+   else
+   {
+      /* The sign-on message would be mixed with the text */
+      eCluCommon.Verbose = FALSE;
+   }
+
+   Status = eCluSignOn( NULL, NULL );
+   if ( Status != SYS_NOMINAL )
+   {
+      printf( "Error: Failed to sign-on (%d = 0x%x)\n", Status, Status );
+      exit( EXIT_FAILURE );
+   }
+
+   Status = eStdBinaryOpen( eCluGetCustomParam( M_DMP_CUSTOM_IN ),
+                            &BinaryPtr, &NumColumns );
+   if ( Status != SYS_NOMINAL )
+   {
+      fprintf( stderr, "Error: '%s' not read (0x%x)\n",
+               eCluGetCustomParam( M_DMP_CUSTOM_IN ), Status );
+      exit( EXIT_FAILURE );
+   }
+
+   RecordsPtr = (eStdBinaryRecord_t *) TTL_MALLOC( M_DMP_BATCH * sizeof( eStdBinaryRecord_t ) );
+   ValuesPtr  = (Int32_t *) TTL_CALLOC( NumColumns + 1, sizeof( Int32_t ) );
+   PresentPtr = (Bool_t *) TTL_CALLOC( NumColumns + 1, sizeof( Bool_t ) );
+   GroupPtr   = NULL;
+   MaxGroup   = 0;
+   NumGroup   = 0;
+   if ( ( RecordsPtr == NULL ) || ( ValuesPtr == NULL ) || ( PresentPtr == NULL ) )
+   {
+      fprintf( stderr, "Error: out of memory\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   Status = mDmpHeader( BinaryPtr, NumColumns, OutFilePtr );
+
+   do
+   {
+      if ( Status == SYS_NOMINAL )
+      {
+         Status = eStdBinaryRead( BinaryPtr, RecordsPtr, M_DMP_BATCH, &NumRead );
+      }
+      if ( Status != SYS_NOMINAL )
+      {
+         break;
+      }
+
+      for ( i = 0; i < NumRead; i++ )
+      {
+         if ( RecordsPtr[i].Column >= NumColumns )
+         {
+            continue;
+         }
+
+         /* A new time stamp ends the rows of the last */
+         if ( ( NumGroup > 0 ) &&
+              ( ( RecordsPtr[i].TimeStamp.t_sec  != GroupPtr[0].TimeStamp.t_sec ) ||
+                ( RecordsPtr[i].TimeStamp.t_nsec != GroupPtr[0].TimeStamp.t_nsec ) ) )
+         {
+            mDmpRows( GroupPtr, NumGroup, NumColumns, ValuesPtr, PresentPtr, OutFilePtr );
+            NumGroup = 0;
+         }
+
+         if ( NumGroup == MaxGroup )
+         {
+            MaxGroup    = ( MaxGroup == 0 ) ? NumColumns + 1 : MaxGroup * 2;
+            NewGroupPtr = (eStdBinaryRecord_t *) TTL_REALLOC( GroupPtr,
+                             MaxGroup * sizeof( eStdBinaryRecord_t ) );
+            if ( NewGroupPtr == NULL )
+            {
+               fprintf( stderr, "Error: out of memory\n" );
+               exit( EXIT_FAILURE );
+            }
+            GroupPtr = NewGroupPtr;
+         }
+         GroupPtr[ NumGroup++ ] = RecordsPtr[i];
+      }
+   } while ( NumRead > 0 );
+
+   if ( NumGroup > 0 )
+   {
+      mDmpRows( GroupPtr, NumGroup, NumColumns, ValuesPtr, PresentPtr, OutFilePtr );
+   }
+
+   eStdBinaryClose( BinaryPtr );
+   TTL_FREE( RecordsPtr );
+   TTL_FREE( GroupPtr );
+   TTL_FREE( ValuesPtr );
+   TTL_FREE( PresentPtr );
+
+   if ( ( fflush( OutFilePtr ) != 0 ) || ( Status != SYS_NOMINAL ) )
+   {
+      fprintf( stderr, "Error: not all written (0x%x)\n", Status );
+      exit( EXIT_FAILURE );
+   }
+   if ( OutFilePtr != stdout )
+   {
+      fclose( OutFilePtr );
+   }
+
+   return EXIT_SUCCESS;
+}
+
+
+static Status_t mDmpHeader(
+   eStdBinary_t *BinaryPtr,
+   Uint32_t NumColumns,
+   FILE *OutFilePtr
+)
+{
+/*
+** Function Name:
+**    mDmpHeader
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Write the line naming the columns.
+**
+** Description:
+**    Each column is named as by Std, with its summary if it has one.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success or E_STD_FILE_WRITE_ERR.
+**
+** Arguments:
+**    eStdBinary_t *BinaryPtr  (in)
+**       Binary output being read.
+**    Uint32_t NumColumns      (in)
+**       Number of its columns.
+**    FILE *OutFilePtr         (in)
+**       Text written.
+**
+*/
+
+   /* Local variables */
+   eStdBinaryColumn_t Column;   /* Column being named */
+   Uint32_t           j;        /* Index of the column */
+
+   fprintf( OutFilePtr, "Date\tTime\tSeconds\t" );
+
+   for ( j = 0; j < NumColumns; j++ )
+   {
+      eStdBinaryColumn( BinaryPtr, j, &Column );
+      if ( Column.Summary[0] != '\0' )
+      {
+         fprintf( OutFilePtr, "%s.%s(0x%x),%s(0x%x) \t", Column.DatumName,
+                  Column.Summary, Column.DatumId, Column.SourceName, Column.SourceId );
+      }
+      else
+      {
+         fprintf( OutFilePtr, "%s(0x%x),%s(0x%x) \t", Column.DatumName,
+                  Column.DatumId, Column.SourceName, Column.SourceId );
+      }
+   }
+
+   if ( fprintf( OutFilePtr, "\n" ) < 0 )
+   {
+      return E_STD_FILE_WRITE_ERR;
+   }
+
+   return SYS_NOMINAL;
+}
+
+
+static void mDmpRows(
+   eStdBinaryRecord_t *GroupPtr,
+   size_t NumGroup,
+   Uint32_t NumColumns,
+   Int32_t *ValuesPtr,
+   Bool_t *PresentPtr,
+   FILE *OutFilePtr
+)
+{
+/*
+** Function Name:
+**    mDmpRows
+**
+** Type:
+**    void
+**
+** Purpose:
+**    Write the records sharing a time stamp as rows.
+**
+** Description:
+**    As Std does, the first record of each column goes in the first row,
+**    and a column with more records at the time stamp has them written in
+**    rows of their own following it. The time stamp is written as the
+**    date and time in UTC, with milliseconds truncated, and the seconds
+**    since 1970 to the nearest microsecond.
+**
+** Return type:
+**    void
+**
+** Arguments:
+**    eStdBinaryRecord_t *GroupPtr  (in)
+**       Records sharing a time stamp, in order.
+**    size_t NumGroup               (in)
+**       Number of records.
+**    Uint32_t NumColumns           (in)
+**       Number of columns.
+**    Int32_t *ValuesPtr            (out)
+**       Work space, a value per column.
+**    Bool_t *PresentPtr            (out)
+**       Work space, a flag per column.
+**    FILE *OutFilePtr              (in)
+**       Text written.
+**
+*/
+
+   /* Local variables */
+   char        TimeText[ M_DMP_TIME_LEN ];  /* Date and time of the rows */
+   time_t      Seconds;     /* Time stamp, as time_t */
+   struct tm   Tm;          /* Broken down time stamp */
+   long        WholeSecs;   /* Seconds since 1970, rounded */
+   long        Micro;       /* and microseconds */
+   size_t      Written;     /* Records written */
+   size_t      i;           /* Record of the group */
+   Uint32_t    j;           /* Column */
+
+   Seconds = (time_t) GroupPtr[0].TimeStamp.t_sec;
+   gmtime_r( &Seconds, &Tm );
+   strftime( TimeText, sizeof( TimeText ), M_DMP_TIME_FORMAT, &Tm );
+
+   WholeSecs = GroupPtr[0].TimeStamp.t_sec;
+   Micro     = ( GroupPtr[0].TimeStamp.t_nsec + 500 ) / 1000;
+   if ( Micro >= 1000000 )
+   {
+      WholeSecs++;
+      Micro -= 1000000;
+   }
+
+   Written = 0;
+   while ( Written < NumGroup )
+   {
+      /* Each row takes the earliest record not yet written of each column */
+      memset( PresentPtr, 0, NumColumns * sizeof( Bool_t ) );
+      for ( i = 0; i < NumGroup; i++ )
+      {
+         j = GroupPtr[i].Column;
+         if ( ( GroupPtr[i].Column != NumColumns ) && ( PresentPtr[j] == FALSE ) )
+         {
+            PresentPtr[j] = TRUE;
+            ValuesPtr[j]  = GroupPtr[i].Value;
+            GroupPtr[i].Column = NumColumns;
+            Written++;
+         }
+      }
+
+      fprintf( OutFilePtr, "%s.%03ld\t%ld.%06ld\t", TimeText,
+               (long) GroupPtr[0].TimeStamp.t_nsec / 1000000, WholeSecs, Micro );
+      for ( j = 0; j < NumColumns; j++ )
+      {
+         if ( PresentPtr[j] == TRUE )
+         {
+            fprintf( OutFilePtr, "%ld\t", (long) ValuesPtr[j] );
+         }
+         else
+         {
+            fputc( '\t', OutFilePtr );
+         }
+      }
+      fputc( '\n', OutFilePtr );
+   }
+}
+
+/* EOF */
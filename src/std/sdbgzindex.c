@@ -0,0 +1,224 @@
+/*
+** Module Name:
+**    sdbgzindex.c
+**
+** Purpose:
+**    A utility to index gzipped Sdb files for random access.
+**
+** Description:
+**    Builds, alongside each gzipped Sdb file named, the index of access
+**    points used by Std to inflate only the parts of an hour it needs.
+**    See eStdGzIndexBuild. The file name may be a pattern, quoted to
+**    protect it from the shell, so that a whole archive may be indexed
+**    at once, e.g.
+**
+**       sdbgzindex -file "/ttl/sw/data/0809*.sdb.gz"
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+** Version:
+**    $Id$
+**
+** History:
+**    $Log$
+**
+**
+*/
+
+
+/* Include files */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <glob.h>
+
+#include "TtlSystem.h"
+#include "Wfl.h"
+#include "Clu.h"
+#include "Log.h"
+#include "Std.h"
+
+
+/* Application details - normally found in XxxPrivate.h */
+
+#define I_IDX_PROGRAM_NAME   "sdbgzindex"
+#define I_IDX_PROGRAM_ABOUT  "Index gzipped SDB files for random access"
+#define I_IDX_RELEASE_DATE   "17 October 2026"
+#define I_IDX_YEAR           "2026"
+#define I_IDX_MAJOR_VERSION  0
+#define I_IDX_MINOR_VERSION  1
+
+/* Common arguments defaults */
+
+#define M_IDX_DFLT_QUIET     FALSE
+#define M_IDX_DFLT_VERBOSE   TRUE
+#define M_IDX_DFLT_SYSLOG    TRUE
+#define M_IDX_DFLT_DEBUG     E_LOG_NOTICE
+#define M_IDX_DFLT_PRIORITY  9
+#define M_IDX_DFLT_HELP      FALSE
+#ifdef E_WFL_OS_QNX4
+#define M_IDX_DFLT_CONFIG    "/opt/ttl/etc/sdbgzindex.cfg"
+#define M_IDX_DFLT_CIL_MAP   "/opt/ttl/etc/Cil.map"
+#else
+#define M_IDX_DFLT_CONFIG    "/ttl/sw/etc/sdbgzindex.cfg"
+#define M_IDX_DFLT_CIL_MAP   "/ttl/sw/etc/Cil.map"
+#endif
+#define M_IDX_DFLT_LOG       "sdbgzindex.txt"
+#define M_IDX_DFLT_CIL       "TU0"
+#define M_IDX_DFLT_SPAN      ( 1024 * 1024 )
+
+/* custom arguments - note that these must match the order in eCluCustomArg[] */
+
+#define M_IDX_CUSTOM_FILE    0
+#define M_IDX_CUSTOM_SPAN    1
+
+#define M_IDX_CUSTOM_ARGS    2
+
+
+/* for parsing custom command-line arguments */
+
+eCluArgSpec_t eCluCustomArg[ M_IDX_CUSTOM_ARGS + 1 ] =
+/*  arg [param],    match, description,                       FALSE, NULL */
+{ { "file <pattern>",  1, "Gzipped SDB file(s) to index",     FALSE, NULL },
+  { "span <bytes>",    1, "Data between access points",       FALSE, NULL },
+  { E_CLU_EOL,         0, E_CLU_EOL,                          FALSE, NULL }
+};
+
+
+int main(
+   int argc,
+   char *argv[]
+)
+{
+/*
+** Function Name:
+**    main
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Top level function of the "sdbgzindex" program.
+**
+** Description:
+**    Indexes each gzipped Sdb file matching the file switch in turn,
+**    reporting the number of access points written to each.
+**
+** Arguments:
+**    int argc                 (in)
+**       Number of arguments on the command line (including the
+**       executable name).
+**    char *argv[]             (in)
+**       Array of null-terminated character strings containing
+**       the command line arguments.
+**
+*/
+
+   /* Local variables */
+   Status_t CluStatus;       /* Return value from called CLU functions */
+   Status_t Status;          /* Return value from called functions */
+   char     Switch[ E_CLU_SWITCH_LEN ];/* to report error parsing a switch */
+   glob_t   Files;           /* Files matching the pattern */
+   size_t   SpanSize;        /* Data between access points */
+   size_t   i;               /* Index of the file being indexed */
+   Uint32_t NumPoints;       /* Access points written to an index */
+   int      NumFailed;       /* Number of files not indexed */
+
+   SpanSize = M_IDX_DFLT_SPAN;
+
+   /* data for command-line utilities */
+   eCluProgNamePtr              = I_IDX_PROGRAM_NAME;
+   eCluProgAboutPtr             = I_IDX_PROGRAM_ABOUT;
+   eCluReleaseDatePtr           = I_IDX_RELEASE_DATE;
+   eCluYearPtr                  = I_IDX_YEAR;
+   eCluMajorVer                 = I_IDX_MAJOR_VERSION;
+   eCluMinorVer                 = I_IDX_MINOR_VERSION;
+
+   /* set default parameters before parsing command-line */
+   eCluCommon.Quiet             = M_IDX_DFLT_QUIET;
+   eCluCommon.Verbose           = M_IDX_DFLT_VERBOSE;
+   eCluCommon.Syslog            = M_IDX_DFLT_SYSLOG;
+   eCluCommon.DebugLevel        = M_IDX_DFLT_DEBUG;
+   eCluCommon.Priority          = M_IDX_DFLT_PRIORITY;
+   eCluCommon.Help              = M_IDX_DFLT_HELP;
+   strcpy( eCluCommon.ConfigFile, M_IDX_DFLT_CONFIG  );
+   strcpy( eCluCommon.LogFile,    M_IDX_DFLT_LOG     );
+   strcpy( eCluCommon.CilName,    M_IDX_DFLT_CIL     );
+   strcpy( eCluCommon.CilMap,     M_IDX_DFLT_CIL_MAP );
+
+   /* register with the command-line utilities (CLU) */
+   CluStatus = eCluSetup( argc, argv,
+                          E_CLU_IGN_QUIET | E_CLU_IGN_VERBOSE
+                           | E_CLU_IGN_PRIORITY | E_CLU_IGN_CONFIGFILE
+                           | E_CLU_IGN_CIL_NAME );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      printf( "Error parsing the command-line\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   /* parse the incoming command-line */
+   CluStatus = eCluParseArgs( Switch );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      eCluShowUsage( NULL, NULL );
+      printf( "Error parsing the command-line switch '%s'\n", Switch );
+      exit( EXIT_FAILURE );
+   }
+
+   /* check for help requested */
+   if ( eCluCommon.Help == TRUE )
+   {
+      exit( EXIT_SUCCESS );
+   }
+
+   /* if filename unspecified */
+   if ( eCluCustomArgExists( M_IDX_CUSTOM_FILE ) != E_CLU_ARG_SUPPLIED )
+   {
+      eCluShowUsage( NULL, NULL );
+      exit( EXIT_SUCCESS );
+   }
+
+   if ( eCluCustomArgExists( M_IDX_CUSTOM_SPAN ) == E_CLU_ARG_SUPPLIED )
+   {
+      SpanSize = (size_t) strtoul( eCluGetCustomParam( M_IDX_CUSTOM_SPAN ), NULL, 0 );
+   }
+
+   Status = eCluSignOn( NULL, NULL );
+   if ( Status != SYS_NOMINAL )
+   {
+      printf( "Error: Failed to sign-on (%d = 0x%x)\n", Status, Status );
+      exit( EXIT_FAILURE );
+   }
+
+   if ( glob( eCluGetCustomParam( M_IDX_CUSTOM_FILE ), 0, NULL, &Files ) != 0 )
+   {
+      printf( "Error: no files match '%s'\n",
+              eCluGetCustomParam( M_IDX_CUSTOM_FILE ) );
+      exit( EXIT_FAILURE );
+   }
+
+   /* Index each file in turn, carrying on past any which fail */
+   NumFailed = 0;
+   for ( i = 0; i < Files.gl_pathc; i++ )
+   {
+      Status = eStdGzIndexBuild( Files.gl_pathv[ i ], SpanSize, &NumPoints );
+      if ( Status == SYS_NOMINAL )
+      {
+         printf( "%s: %lu access points\n", Files.gl_pathv[ i ],
+                 (unsigned long) NumPoints );
+      }
+      else
+      {
+         printf( "%s: not indexed (0x%x)\n", Files.gl_pathv[ i ], Status );
+         NumFailed++;
+      }
+   }
+
+   globfree( &Files );
+
+   return NumFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* EOF */
@@ -0,0 +1,414 @@
+/*
+** Module Name:
+**    sdbrollup.c
+**
+** Purpose:
+**    A utility to roll up days of an Sdb archive into the rollup archive.
+**
+** Description:
+**    Rolls up each day named into a single file of the rollup archive,
+**    holding the count, least, greatest and mean value of each storage
+**    code over every 10 seconds, minute, 10 minutes and hour, see
+**    eStdRollupBuild. A day is given as yyyy/mm/dd, defaulting to
+**    yesterday, and with the days switch the days before it are rolled
+**    up too, e.g.
+**
+**       sdbrollup -out /sdb_puller/rollup -path /sdb -days 7
+**
+**    With the rebuild switch, the coarser levels of days already rolled
+**    up are made again from the finest, without reading the Sdb files.
+**    With the show switch, the points of one level of each day are
+**    printed, one per line, instead.
+**
+** Copyright (c) Telescope Technologies Limited (TTL), 2001
+**
+** Version:
+**    $Id$
+**
+** History:
+**    $Log$
+**
+**
+*/
+
+
+/* Include files */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "TtlSystem.h"
+#include "Wfl.h"
+#include "Clu.h"
+#include "Log.h"
+#include "Std.h"
+
+
+/* Application details - normally found in XxxPrivate.h */
+
+#define I_RUP_PROGRAM_NAME   "sdbrollup"
+#define I_RUP_PROGRAM_ABOUT  "Roll up days of an SDB archive"
+#define I_RUP_RELEASE_DATE   "17 October 2026"
+#define I_RUP_YEAR           "2026"
+#define I_RUP_MAJOR_VERSION  0
+#define I_RUP_MINOR_VERSION  1
+
+/* Common arguments defaults */
+
+#define M_RUP_DFLT_QUIET     FALSE
+#define M_RUP_DFLT_VERBOSE   TRUE
+#define M_RUP_DFLT_SYSLOG    TRUE
+#define M_RUP_DFLT_DEBUG     E_LOG_NOTICE
+#define M_RUP_DFLT_PRIORITY  9
+#define M_RUP_DFLT_HELP      FALSE
+#ifdef E_WFL_OS_QNX4
+#define M_RUP_DFLT_CONFIG    "/opt/ttl/etc/sdbrollup.cfg"
+#define M_RUP_DFLT_CIL_MAP   "/opt/ttl/etc/Cil.map"
+#else
+#define M_RUP_DFLT_CONFIG    "/ttl/sw/etc/sdbrollup.cfg"
+#define M_RUP_DFLT_CIL_MAP   "/ttl/sw/etc/Cil.map"
+#endif
+#define M_RUP_DFLT_LOG       "sdbrollup.txt"
+#define M_RUP_DFLT_CIL       "TU0"
+#define M_RUP_DFLT_DAYS      1
+#define M_RUP_SECS_PER_DAY   86400
+#define M_RUP_TIME_FORMAT    "%Y/%m/%d"
+#define M_RUP_TIME_LEN       16
+#define M_RUP_SHOW_FORMAT    "%Y/%m/%d %H:%M:%S"
+
+/* custom arguments - note that these must match the order in eCluCustomArg[] */
+
+#define M_RUP_CUSTOM_OUT     0
+#define M_RUP_CUSTOM_PATH    1
+#define M_RUP_CUSTOM_DAY     2
+#define M_RUP_CUSTOM_DAYS    3
+#define M_RUP_CUSTOM_REBUILD 4
+#define M_RUP_CUSTOM_SHOW    5
+
+#define M_RUP_CUSTOM_ARGS    6
+
+
+/* Local function prototypes */
+
+static Status_t mRupShow( char *RollupDirPtr, eTtlTime_t Day, Uint32_t Level );
+
+
+/* for parsing custom command-line arguments */
+
+eCluArgSpec_t eCluCustomArg[ M_RUP_CUSTOM_ARGS + 1 ] =
+/*  arg [param],    match, description,                       FALSE, NULL */
+{ { "out <dir>",       1, "Directory of the rollup archive",  FALSE, NULL },
+  { "path <dir>",      1, "Directory of the SDB files",       FALSE, NULL },
+  { "day <yyyy/mm/dd>",2, "Last day to roll up",              FALSE, NULL },
+  { "days <n>",        4, "Number of days to roll up",        FALSE, NULL },
+  { "rebuild",         1, "Remake coarser levels from 10s",   FALSE, NULL },
+  { "show <level>",    2, "Print points of level 0 to 3",     FALSE, NULL },
+  { E_CLU_EOL,         0, E_CLU_EOL,                          FALSE, NULL }
+};
+
+
+int main(
+   int argc,
+   char *argv[]
+)
+{
+/*
+** Function Name:
+**    main
+**
+** Type:
+**    int
+**
+** Purpose:
+**    Top level function of the "sdbrollup" program.
+**
+** Description:
+**    Converts each day in turn, oldest first, reporting the number of
+**    storage codes and records found in each. A day which has not yet
+**    ended is skipped.
+**
+** Arguments:
+**    int argc                 (in)
+**       Number of arguments on the command line (including the
+**       executable name).
+**    char *argv[]             (in)
+**       Array of null-terminated character strings containing
+**       the command line arguments.
+**
+*/
+
+   /* Local variables */
+   Status_t   CluStatus;     /* Return value from called CLU functions */
+   Status_t   Status;        /* Return value from called functions */
+   char       Switch[ E_CLU_SWITCH_LEN ];/* to report error parsing a switch */
+   char      *PathPtr;       /* Directory of the Sdb files */
+   struct tm  DayTm;         /* Last day to roll up */
+   time_t     LastDay;       /* Noon of the last day to roll up */
+   time_t     Noon;          /* Noon of the day being rolled up */
+   eTtlTime_t Day;           /* Day being rolled up */
+   int        Year;          /* Date given by the day switch */
+   int        Month;
+   int        Date;
+   long       NumDays;       /* Number of days to roll up */
+   long       Level;         /* Level to show, or -1 */
+   long       i;             /* Days before the last being rolled up */
+   char       DayText[ M_RUP_TIME_LEN ];/* Day being rolled up, as text */
+   Uint32_t   NumCodes;      /* Storage codes found in a day */
+   Uint32_t   NumRecords;    /* Records rolled up of a day */
+   int        NumFailed;     /* Number of days not rolled up */
+
+   PathPtr = E_STD_DFLT_SDB_PATH;
+   NumDays = M_RUP_DFLT_DAYS;
+   Level   = -1;
+
+   /* data for command-line utilities */
+   eCluProgNamePtr              = I_RUP_PROGRAM_NAME;
+   eCluProgAboutPtr             = I_RUP_PROGRAM_ABOUT;
+   eCluReleaseDatePtr           = I_RUP_RELEASE_DATE;
+   eCluYearPtr                  = I_RUP_YEAR;
+   eCluMajorVer                 = I_RUP_MAJOR_VERSION;
+   eCluMinorVer                 = I_RUP_MINOR_VERSION;
+
+   /* set default parameters before parsing command-line */
+   eCluCommon.Quiet             = M_RUP_DFLT_QUIET;
+   eCluCommon.Verbose           = M_RUP_DFLT_VERBOSE;
+   eCluCommon.Syslog            = M_RUP_DFLT_SYSLOG;
+   eCluCommon.DebugLevel        = M_RUP_DFLT_DEBUG;
+   eCluCommon.Priority          = M_RUP_DFLT_PRIORITY;
+   eCluCommon.Help              = M_RUP_DFLT_HELP;
+   strcpy( eCluCommon.ConfigFile, M_RUP_DFLT_CONFIG  );
+   strcpy( eCluCommon.LogFile,    M_RUP_DFLT_LOG     );
+   strcpy( eCluCommon.CilName,    M_RUP_DFLT_CIL     );
+   strcpy( eCluCommon.CilMap,     M_RUP_DFLT_CIL_MAP );
+
+   /* register with the command-line utilities (CLU) */
+   CluStatus = eCluSetup( argc, argv,
+                          E_CLU_IGN_QUIET | E_CLU_IGN_VERBOSE
+                           | E_CLU_IGN_PRIORITY | E_CLU_IGN_CONFIGFILE
+                           | E_CLU_IGN_CIL_NAME );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      printf( "Error parsing the command-line\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   /* parse the incoming command-line */
+   CluStatus = eCluParseArgs( Switch );
+   if ( CluStatus != SYS_NOMINAL )
+   {
+      eCluShowUsage( NULL, NULL );
+      printf( "Error parsing the command-line switch '%s'\n", Switch );
+      exit( EXIT_FAILURE );
+   }
+
+   /* check for help requested */
+   if ( eCluCommon.Help == TRUE )
+   {
+      exit( EXIT_SUCCESS );
+   }
+
+   /* if the rollup archive is unspecified */
+   if ( eCluCustomArgExists( M_RUP_CUSTOM_OUT ) != E_CLU_ARG_SUPPLIED )
+   {
+      eCluShowUsage( NULL, NULL );
+      exit( EXIT_SUCCESS );
+   }
+
+   if ( eCluCustomArgExists( M_RUP_CUSTOM_PATH ) == E_CLU_ARG_SUPPLIED )
+   {
+      PathPtr = eCluGetCustomParam( M_RUP_CUSTOM_PATH );
+   }
+
+   if ( eCluCustomArgExists( M_RUP_CUSTOM_DAYS ) == E_CLU_ARG_SUPPLIED )
+   {
+      NumDays = strtol( eCluGetCustomParam( M_RUP_CUSTOM_DAYS ), NULL, 0 );
+      if ( NumDays < 1 )
+      {
+         printf( "Error: at least one day must be rolled up\n" );
+         exit( EXIT_FAILURE );
+      }
+   }
+
+   if ( eCluCustomArgExists( M_RUP_CUSTOM_SHOW ) == E_CLU_ARG_SUPPLIED )
+   {
+      Level = strtol( eCluGetCustomParam( M_RUP_CUSTOM_SHOW ), NULL, 0 );
+      if ( ( Level < 0 ) || ( Level >= E_STD_ROLLUP_LEVELS ) )
+      {
+         printf( "Error: level must be 0 to %d\n", E_STD_ROLLUP_LEVELS - 1 );
+         exit( EXIT_FAILURE );
+      }
+   }
+
+   /* Take noon of the last day, which no change of daylight saving moves */
+   LastDay = time( NULL ) - M_RUP_SECS_PER_DAY;
+   localtime_r( &LastDay, &DayTm );
+   if ( eCluCustomArgExists( M_RUP_CUSTOM_DAY ) == E_CLU_ARG_SUPPLIED )
+   {
+      if ( sscanf( eCluGetCustomParam( M_RUP_CUSTOM_DAY ), "%d/%d/%d",
+                   &Year, &Month, &Date ) != 3 )
+      {
+         printf( "Error: day '%s' is not yyyy/mm/dd\n",
+                 eCluGetCustomParam( M_RUP_CUSTOM_DAY ) );
+         exit( EXIT_FAILURE );
+      }
+      DayTm.tm_year = Year - 1900;
+      DayTm.tm_mon  = Month - 1;
+      DayTm.tm_mday = Date;
+   }
+   DayTm.tm_hour  = 12;
+   DayTm.tm_min   = 0;
+   DayTm.tm_sec   = 0;
+   DayTm.tm_isdst = -1;
+
+   Status = eCluSignOn( NULL, NULL );
+   if ( Status != SYS_NOMINAL )
+   {
+      printf( "Error: Failed to sign-on (%d = 0x%x)\n", Status, Status );
+      exit( EXIT_FAILURE );
+   }
+
+   /* Roll up each day in turn, carrying on past any which fail */
+   NumFailed = 0;
+   for ( i = NumDays - 1; i >= 0; i-- )
+   {
+      DayTm.tm_isdst = -1;
+      Noon = mktime( &DayTm ) - i * M_RUP_SECS_PER_DAY;
+      Day.t_sec  = Noon;
+      Day.t_nsec = 0;
+      strftime( DayText, sizeof( DayText ), M_RUP_TIME_FORMAT,
+                localtime( &Noon ) );
+
+      if ( Level >= 0 )
+      {
+         Status = mRupShow( eCluGetCustomParam( M_RUP_CUSTOM_OUT ), Day,
+                            (Uint32_t) Level );
+         if ( Status != SYS_NOMINAL )
+         {
+            printf( "%s: not shown (0x%x)\n", DayText, Status );
+            NumFailed++;
+         }
+         continue;
+      }
+
+      if ( eCluCustomArgExists( M_RUP_CUSTOM_REBUILD ) == E_CLU_ARG_SUPPLIED )
+      {
+         Status = eStdRollupRebuild( eCluGetCustomParam( M_RUP_CUSTOM_OUT ),
+                                     Day, &NumCodes );
+         if ( Status == SYS_NOMINAL )
+         {
+            printf( "%s: %lu codes rebuilt\n", DayText, (unsigned long) NumCodes );
+         }
+         else
+         {
+            printf( "%s: not rebuilt (0x%x)\n", DayText, Status );
+            NumFailed++;
+         }
+         continue;
+      }
+
+      Status = eStdRollupBuild( eCluGetCustomParam( M_RUP_CUSTOM_OUT ),
+                                PathPtr, Day, &NumCodes, &NumRecords );
+      if ( Status == SYS_NOMINAL )
+      {
+         printf( "%s: %lu codes, %lu records\n", DayText,
+                 (unsigned long) NumCodes, (unsigned long) NumRecords );
+      }
+      else if ( Status == E_STD_TIME_OUT_RANGE )
+      {
+         printf( "%s: not yet ended\n", DayText );
+      }
+      else
+      {
+         printf( "%s: not rolled up (0x%x)\n", DayText, Status );
+         NumFailed++;
+      }
+   }
+
+   return NumFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+static Status_t mRupShow(
+   char *RollupDirPtr,
+   eTtlTime_t Day,
+   Uint32_t Level
+)
+{
+/*
+** Function Name:
+**    mRupShow
+**
+** Type:
+**    Status_t
+**
+** Purpose:
+**    Print the points of one level of a day of the rollup archive.
+**
+** Description:
+**    Prints a line per point, giving the storage code in hex, the start
+**    of the interval as yyyy/mm/dd hh:mm:ss, and the count, least,
+**    greatest and mean value of its records.
+**
+** Return type:
+**    Status_t
+**       Returns SYS_NOMINAL on success, or the error opening or reading
+**       the day.
+**
+** Arguments:
+**    char *RollupDirPtr       (in)
+**       Directory holding the rollup archive.
+**    eTtlTime_t Day           (in)
+**       Any time of the day.
+**    Uint32_t Level           (in)
+**       Level to print.
+**
+*/
+
+   /* Local variables */
+   Status_t           Status;      /* Return value from called functions */
+   eStdRollup_t      *RollupPtr;   /* Day being printed */
+   eStdRollupPoint_t *PointsPtr;   /* Points of a code */
+   eSdbCode_t         Code;        /* Storage code being printed */
+   Uint32_t           NumRecords;  /* Its records in the day */
+   Uint32_t           NumPoints;   /* Its points at the level */
+   Uint32_t           Resolution;  /* Seconds of each interval */
+   Uint32_t           c;           /* Code of the day */
+   Uint32_t           p;           /* Point of the code */
+   time_t             Time;        /* Start of an interval */
+   char               TimeText[ M_RUP_TIME_LEN * 2 ];
+
+   Status = eStdRollupOpen( RollupDirPtr, Day, &RollupPtr );
+   if ( Status != SYS_NOMINAL )
+   {
+      return Status;
+   }
+
+   for ( c = 0; eStdRollupCode( RollupPtr, c, &Code, &NumRecords ) == SYS_NOMINAL; c++ )
+   {
+      Status = eStdRollupSeries( RollupPtr, Code, Level, &PointsPtr,
+                                 &NumPoints, &Resolution );
+      if ( Status != SYS_NOMINAL )
+      {
+         break;
+      }
+
+      for ( p = 0; p < NumPoints; p++ )
+      {
+         Time = (time_t) PointsPtr[ p ].Time;
+         strftime( TimeText, sizeof( TimeText ), M_RUP_SHOW_FORMAT,
+                   localtime( &Time ) );
+         printf( "0x%08lx %s %lu %ld %ld %.3f\n", (unsigned long) Code, TimeText,
+                 (unsigned long) PointsPtr[ p ].Count,
+                 (long) PointsPtr[ p ].Min, (long) PointsPtr[ p ].Max,
+                 PointsPtr[ p ].Sum / PointsPtr[ p ].Count );
+      }
+   }
+
+   eStdRollupClose( RollupPtr );
+
+   return Status;
+}
+
+/* EOF */